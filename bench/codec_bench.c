@@ -0,0 +1,349 @@
+/**
+ * @file codec_bench.c
+ * @brief Microbenchmark of the capture container codec
+ * @version 0.1
+ * @date 2026-10-14
+ *
+ * @copyright Copyright (c) 2026
+ *
+ * Codes synthetic ADC frames of the default cascade configuration (64
+ * loops x 12 chirps, 256 complex samples, 4 RX) with each codec, with
+ * 16-bit values and with the 12-bit TDA data packing, after checking that
+ * every block decodes to the recorded values. The frames hold a few beat
+ * tones over a thermal noise floor, 12 bits of ADC range being used.
+ * A capture is then packed into a container from a temporary directory
+ * and read back through cap_frame_read, and the RX channel views are
+ * checked on the interleaved and non-interleaved layouts.
+ *
+ * Build and run with `make bench-codec`.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+#include <unistd.h>
+#include "../cap/cap.h"
+
+#define NUM_FRAMES  16
+#define NUM_SAMPLES 256
+#define NUM_RX      4
+#define NUM_CHIRPS  (64 * 12)
+
+static const char *codec_name[] = { "none", "delta", "rice" };
+
+
+static double now(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+
+/**
+ * @brief Gaussian noise (Box-Muller)
+ */
+static double noise(void) {
+  double u = (rand() + 1.0) / (RAND_MAX + 2.0), v = (rand() + 1.0) / (RAND_MAX + 2.0);
+  return sqrt(-2.0 * log(u)) * cos(2.0 * M_PI * v);
+}
+
+
+/**
+ * @brief Synthetic interleaved complex frame: [chirp][sample][rx][I/Q]
+ */
+static void synth_frame(int16_t *frame, uint32_t seed) {
+  const double tones[3][2] = { { 0.031, 900.0 }, { 0.117, 300.0 }, { 0.245, 80.0 } };
+
+  srand(seed);
+  for (uint32_t c = 0; c < NUM_CHIRPS; c++) {
+    for (uint32_t s = 0; s < NUM_SAMPLES; s++) {
+      for (uint32_t rx = 0; rx < NUM_RX; rx++) {
+        double re = 0, im = 0;
+        for (uint32_t t = 0; t < 3; t++) {
+          double phase = 2.0 * M_PI * tones[t][0] * s + 0.7 * rx + 0.01 * c * (t + 1);
+          re += tones[t][1] * cos(phase);
+          im += tones[t][1] * sin(phase);
+        }
+        int16_t *v = frame + ((size_t)c * NUM_SAMPLES + s) * NUM_RX * 2 + rx * 2;
+        v[0] = (int16_t)lrint(re + 12.0 * noise());
+        v[1] = (int16_t)lrint(im + 12.0 * noise());
+      }
+    }
+  }
+}
+
+
+/**
+ * @brief Pack 16-bit values into 12-bit pairs (see cap_unpack12)
+ */
+static void pack12(const int16_t *in, uint8_t *out, size_t count) {
+  for (size_t i = 0; i < count; i += 2, out += 3) {
+    uint16_t v0 = (uint16_t)in[i] & 0xFFF, v1 = (uint16_t)in[i + 1] & 0xFFF;
+    out[0] = v0 & 0xFF;
+    out[1] = (v0 >> 8) | ((v1 & 0xF) << 4);
+    out[2] = v1 >> 4;
+  }
+}
+
+
+static int bench(uint8_t codec, uint8_t packed12, int16_t *const frames[NUM_FRAMES]) {
+  capCodecLayout_t layout = {
+    .codec = codec, .packed12 = packed12, .chInterleave = 0,
+    .width = NUM_SAMPLES * NUM_RX * 2, .height = NUM_CHIRPS,
+    .numAdcSamples = NUM_SAMPLES, .numRx = NUM_RX, .valsPerSample = 2,
+  };
+  const size_t numValues = (size_t)layout.width * layout.height;
+  const size_t blockSize = packed12 ? numValues * 3 / 2 : numValues * 2;
+  size_t bound = cap_codec_bound(&layout), total = 0;
+  uint8_t *raw = malloc(blockSize * NUM_FRAMES);
+  uint8_t *coded = malloc(bound * NUM_FRAMES);
+  size_t lengths[NUM_FRAMES];
+  int16_t *scratch = malloc(numValues * sizeof(int16_t));
+  int16_t *decoded = malloc(numValues * sizeof(int16_t));
+  double t0, encode, decode, mb = (double)blockSize * NUM_FRAMES / 1e6;
+
+  for (uint32_t f = 0; f < NUM_FRAMES; f++) {
+    if (packed12) {
+      pack12(frames[f], raw + f * blockSize, numValues);
+    } else {
+      memcpy(raw + f * blockSize, frames[f], blockSize);
+    }
+  }
+
+  t0 = now();
+  for (uint32_t f = 0; f < NUM_FRAMES; f++) {
+    lengths[f] = cap_encode(&layout, raw + f * blockSize, coded + f * bound, scratch);
+    total += lengths[f];
+  }
+  encode = now() - t0;
+
+  t0 = now();
+  for (uint32_t f = 0; f < NUM_FRAMES; f++) {
+    if (cap_decode(&layout, coded + f * bound, lengths[f], decoded) != 0) {
+      printf("DECODE FAILED (%s, frame %u)\n", codec_name[codec], f);
+      return 1;
+    }
+  }
+  decode = now() - t0;
+
+  // Check of every frame, out of the timing
+  for (uint32_t f = 0; f < NUM_FRAMES; f++) {
+    const int16_t *expected = frames[f];
+    cap_decode(&layout, coded + f * bound, lengths[f], decoded);
+    if (packed12) {
+      cap_unpack12(raw + f * blockSize, scratch, numValues);
+      expected = scratch;
+    }
+    if (memcmp(decoded, expected, numValues * sizeof(int16_t)) != 0) {
+      printf("MISMATCH (%s, frame %u)\n", codec_name[codec], f);
+      return 1;
+    }
+  }
+
+  printf("  %-6s %-7s %8.1f MB -> %8.1f MB  %5.2fx  encode %7.1f MB/s  decode %7.1f MB/s\n",
+    codec_name[codec], packed12 ? "12-bit" : "16-bit", mb, total / 1e6, mb * 1e6 / total,
+    mb / encode, mb / decode);
+  free(raw);
+  free(coded);
+  free(scratch);
+  free(decoded);
+  return 0;
+}
+
+
+/**
+ * @brief Pack a capture of two devices with a codec and read it back
+ */
+static int bench_container(int16_t *const frames[NUM_FRAMES]) {
+  char dir[] = "/tmp/codec_bench_XXXXXX", path[256], capPath[256];
+  const size_t blockSize = (size_t)NUM_SAMPLES * NUM_RX * 2 * NUM_CHIRPS * sizeof(int16_t);
+  int16_t *block = malloc(blockSize);
+  capHeader_t header;
+  capReader_t reader;
+  double t0, dt;
+  int status = 1;
+
+  if (mkdtemp(dir) == NULL) return 1;
+  for (uint8_t d = 0; d < 2; d++) {
+    FILE *fp;
+    snprintf(path, sizeof(path), "%s/%s_0000_data.bin", dir, d ? "slave1" : "master");
+    fp = fopen(path, "wb");
+    for (uint32_t f = 0; f < NUM_FRAMES; f++) fwrite(frames[(f + d) % NUM_FRAMES], blockSize, 1, fp);
+    fclose(fp);
+  }
+
+  memset(&header, 0, sizeof(header));
+  header.deviceMap = 0x3;
+  header.width = NUM_SAMPLES * NUM_RX * 2;
+  header.height = NUM_CHIRPS;
+  header.blockSize = blockSize;
+  header.numRx = NUM_RX;
+  header.valsPerSample = 2;
+  header.numAdcSamples = NUM_SAMPLES;
+  header.framePeriodicity = 20000000;
+  header.codec = CAP_CODEC_RICE;
+  snprintf(capPath, sizeof(capPath), "%s.mmwcap", dir);
+
+  t0 = now();
+  if (cap_pack(dir, capPath, &header, 0) != 0) {
+    printf("PACK FAILED\n");
+    goto done;
+  }
+  dt = now() - t0;
+  if (cap_open(&reader, capPath) != 0) {
+    printf("OPEN FAILED\n");
+    goto done;
+  }
+  for (uint32_t f = 0; f < NUM_FRAMES; f++) {
+    for (uint8_t d = 0; d < 2; d++) {
+      if ((cap_frame_read(&reader, f, d, block) != 0) ||
+          (memcmp(block, frames[(f + d) % NUM_FRAMES], blockSize) != 0)) {
+        printf("CONTAINER MISMATCH (frame %u, device %u)\n", f, d);
+        cap_close(&reader);
+        goto done;
+      }
+    }
+  }
+  printf("  container: %u frames x %u devices, %.1f MB -> %.1f MB in %.3f s (%.1f MB/s)\n",
+    reader.header->numFrames, reader.header->numDevices, 2.0 * NUM_FRAMES * blockSize / 1e6,
+    reader.size / 1e6, dt, 2.0 * NUM_FRAMES * blockSize / 1e6 / dt);
+  cap_close(&reader);
+  status = 0;
+
+done:
+  for (uint8_t d = 0; d < 2; d++) {
+    snprintf(path, sizeof(path), "%s/%s_0000_data.bin", dir, d ? "slave1" : "master");
+    unlink(path);
+  }
+  rmdir(dir);
+  unlink(capPath);
+  free(block);
+  return status;
+}
+
+
+/**
+ * @brief Check cap_rx_view on interleaved and non-interleaved RX channels,
+ *    and its refusal of 12-bit packed blocks
+ */
+static int check_rx_view(void) {
+  enum { S = 8, RX = 4, VPS = 2, CHIRPS = 3, FRAMES = 2 };
+  const size_t numValues = (size_t)S * RX * VPS * CHIRPS;
+  char dir[] = "/tmp/codec_bench_XXXXXX", path[256], capPath[256];
+  int16_t block[S * RX * VPS * CHIRPS], decoded[S * RX * VPS * CHIRPS];
+  uint8_t packed[S * RX * VPS * CHIRPS * 3 / 2];
+  int status = 0;
+
+  if (mkdtemp(dir) == NULL) return 1;
+  snprintf(path, sizeof(path), "%s/master_0000_data.bin", dir);
+  snprintf(capPath, sizeof(capPath), "%s.mmwcap", dir);
+
+  for (uint8_t mode = 0; (mode < 3) && (status == 0); mode++) {
+    // 0: interleaved, 1: non-interleaved, 2: interleaved, 12-bit packed
+    const uint8_t chInterleave = (mode == 1), packing = (mode == 2);
+    capHeader_t header;
+    capReader_t reader;
+    capRxView_t view;
+    FILE *fp = fopen(path, "wb");
+
+    for (uint32_t f = 0; f < FRAMES; f++) {
+      for (uint32_t c = 0; c < CHIRPS; c++) {
+        for (uint32_t rx = 0; rx < RX; rx++) {
+          for (uint32_t n = 0; n < S; n++) {
+            for (uint32_t v = 0; v < VPS; v++) {
+              size_t i = chInterleave ? (((size_t)c * RX + rx) * S + n) * VPS + v :
+                (((size_t)c * S + n) * RX + rx) * VPS + v;
+              block[i] = (int16_t)(f * 700 + c * 200 + rx * 40 + n * 2 + v - 900);
+            }
+          }
+        }
+      }
+      if (packing) {
+        pack12(block, packed, numValues);
+        fwrite(packed, sizeof(packed), 1, fp);
+      } else {
+        fwrite(block, sizeof(block), 1, fp);
+      }
+    }
+    fclose(fp);
+
+    memset(&header, 0, sizeof(header));
+    header.deviceMap = 0x1;
+    header.width = S * RX * VPS;
+    header.height = CHIRPS;
+    header.blockSize = packing ? sizeof(packed) : sizeof(block);
+    header.numRx = RX;
+    header.valsPerSample = VPS;
+    header.numAdcSamples = S;
+    header.framePeriodicity = 20000000;
+    header.chInterleave = chInterleave;
+    header.packing = packing;
+    if ((cap_pack(dir, capPath, &header, 1) != 0) || (cap_open(&reader, capPath) != 0)) {
+      printf("RX VIEW: PACK FAILED (mode %u)\n", mode);
+      status = 1;
+      break;
+    }
+    for (uint32_t f = 0; (f < FRAMES) && (status == 0); f++) {
+      if (packing) {
+        if ((cap_rx_view(&reader, f, 0, 0, &view) == 0) ||
+            (cap_frame_read(&reader, f, 0, decoded) != 0) ||
+            (decoded[(S * RX + 3) * VPS + 1] != (int16_t)(f * 700 + 200 + 3 * 40 + 1 - 900))) {
+          printf("RX VIEW: 12-BIT PACKED BLOCK MISREAD (frame %u)\n", f);
+          status = 1;
+        }
+        continue;
+      }
+      for (uint8_t rx = 0; (rx < RX) && (status == 0); rx++) {
+        if (cap_rx_view(&reader, f, 0, rx, &view) != 0) {
+          status = 1;
+          break;
+        }
+        for (uint32_t c = 0; c < CHIRPS; c++) {
+          for (uint32_t n = 0; n < S; n++) {
+            for (uint32_t v = 0; v < VPS; v++) {
+              if (view.base[c * view.chirpStride + n * view.sampleStride + v] !=
+                  (int16_t)(f * 700 + c * 200 + rx * 40 + n * 2 + v - 900)) {
+                status = 1;
+              }
+            }
+          }
+        }
+      }
+      if (status != 0) printf("RX VIEW MISMATCH (chInterleave %u, frame %u)\n", chInterleave, f);
+    }
+    cap_close(&reader);
+    unlink(capPath);
+  }
+  if (status == 0) printf("  rx view: interleaved and non-interleaved channels OK, 12-bit packed refused\n");
+
+  unlink(path);
+  rmdir(dir);
+  return status;
+}
+
+
+int main(void) {
+  int16_t *frames[NUM_FRAMES];
+  const size_t numValues = (size_t)NUM_SAMPLES * NUM_RX * 2 * NUM_CHIRPS;
+  int status = 0;
+
+  for (uint32_t f = 0; f < NUM_FRAMES; f++) {
+    frames[f] = malloc(numValues * sizeof(int16_t));
+    synth_frame(frames[f], f + 1);
+  }
+  printf("%u frames of %u chirps x %u samples x %u RX (complex)\n",
+    NUM_FRAMES, NUM_CHIRPS, NUM_SAMPLES, NUM_RX);
+
+  for (uint8_t packed12 = 0; (packed12 <= 1) && (status == 0); packed12++) {
+    for (uint8_t codec = CAP_CODEC_DELTA; (codec <= CAP_CODEC_RICE) && (status == 0); codec++) {
+      status = bench(codec, packed12, frames);
+    }
+  }
+  if (status == 0) status = bench_container(frames);
+  if (status == 0) status = check_rx_view();
+
+  for (uint32_t f = 0; f < NUM_FRAMES; f++) free(frames[f]);
+  return status;
+}
@@ -0,0 +1,338 @@
+/**
+ * @file control_bench.c
+ * @brief Benchmark of the control path against the loopback TDA emulator
+ * @version 0.1
+ * @date 2026-10-14
+ *
+ * @copyright Copyright (c) 2026
+ *
+ * Times the full `configure()` sequence, the firmware download and
+ * arm/start/stop/de-arm cycles of the 4 devices through the real
+ * mmWaveLink driver and Ethernet port layer, with the TDA board replaced by
+ * the emulator of tda_sim.c running in the same process. The emulator
+ * answers immediately, unless a latency and jitter are given, so the
+ * results are the cost of the host stack. The start and stop of framing
+ * also report the dispatch skew between the devices, and the time spent
+ * waiting for each async event and TDA ACK is listed.
+ *
+ * mimo.c is compiled into the benchmark (its main() renamed) to run the
+ * same configuration sequence as the CLI. The firmware cache and the
+ * configuration state written in /tmp are restored / removed at exit.
+ *
+ * Build and run with `make bench-control`, options in BENCH_ARGS.
+ */
+
+#define main mimo_main
+#include "../mimo.c"
+#undef main
+#include "tda_sim.h"
+
+/* Measurements of a phase, in s */
+typedef struct benchStat {
+  const char *name;
+  uint32_t count;
+  double sum;
+  double min;
+  double max;
+} benchStat_t;
+
+static uint8_t *g_fw_cache = NULL;
+static long g_fw_cache_size = -1;
+
+
+static double now(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+
+static void bench_add(benchStat_t *stat, double dt) {
+  if ((stat->count == 0U) || (dt < stat->min)) stat->min = dt;
+  if ((stat->count == 0U) || (dt > stat->max)) stat->max = dt;
+  stat->sum += dt;
+  stat->count++;
+}
+
+
+static void bench_record(benchStat_t *stat, double start) {
+  bench_add(stat, now() - start);
+}
+
+
+static void bench_print(const benchStat_t *stat) {
+  if (stat->count == 0U) return;
+  printf("  %-20s %4u  %10.2f  %10.2f  %10.2f\n", stat->name, stat->count,
+    stat->min * 1e3, stat->sum / stat->count * 1e3, stat->max * 1e3);
+}
+
+
+/**
+ * @brief Keep a copy of the firmware cache of the real boards
+ *
+ * The emulated devices report a null patch version: each download is a
+ * full one, and the cache written after it must not replace the real one.
+ */
+static void bench_save_fw_cache(void) {
+  FILE *fp = fopen(MMWL_FW_CACHE_FILE, "rb");
+
+  if (fp == NULL) return;
+  fseek(fp, 0, SEEK_END);
+  g_fw_cache_size = ftell(fp);
+  fseek(fp, 0, SEEK_SET);
+  g_fw_cache = (uint8_t *)malloc(g_fw_cache_size > 0 ? g_fw_cache_size : 1);
+  if ((g_fw_cache == NULL) ||
+      (fread(g_fw_cache, 1, g_fw_cache_size, fp) != (size_t)g_fw_cache_size)) {
+    g_fw_cache_size = -1;
+  }
+  fclose(fp);
+}
+
+
+/**
+ * @brief Restore the firmware cache and drop the configuration state
+ */
+static void bench_cleanup(void) {
+  MMWL_cfgStateClear(g_ip_addr);
+  if (g_fw_cache_size < 0) {
+    remove(MMWL_FW_CACHE_FILE);
+  } else {
+    FILE *fp = fopen(MMWL_FW_CACHE_FILE, "wb");
+    if (fp != NULL) {
+      fwrite(g_fw_cache, 1, g_fw_cache_size, fp);
+      fclose(fp);
+    }
+  }
+  free(g_fw_cache);
+  if (g_profile_path[0] != '\0') {
+    TDAProfEnable(FALSE);
+    if (json_export_profile(g_profile_path) == 0) {
+      printf("Profile written to %s\n", g_profile_path);
+    }
+  }
+}
+
+
+int main(int argc, char *argv[]) {
+  parser_t parser = init_parser("control_bench",
+    "Benchmark of configure(), firmware download and arm/start/stop cycles");
+  benchStat_t statConfigure = { "configure()" };
+  benchStat_t statFirmware = { "firmware download" };
+  benchStat_t statArm = { "arm" };
+  benchStat_t statStart = { "start frame" };
+  benchStat_t statStop = { "stop frame" };
+  benchStat_t statDearm = { "de-arm" };
+  benchStat_t statCycle = { "arm..de-arm cycle" };
+  benchStat_t statStartSkew = { "start slave skew" };
+  benchStat_t statStartMaster = { "start master delay" };
+  benchStat_t statStopSkew = { "stop slave skew" };
+  mmwlFrameSync_t frameSync = { 0 };
+  tdaSimCfg_t simCfg;
+  tdaSimStats_t simStats;
+  devConfig_t config;
+  int default_port = NETWORK_TDA_SERVER_PORT;
+  int default_configure = 2, default_firmware = 3, default_cycles = 10;
+  int default_zero = 0, default_seed = 1;
+  uint8_t irq_mode = TDA_IRQ_MODE_EVENT;
+  int status = 0;
+  double start;
+
+  option_t opt_port = {
+    .args = "-p",
+    .argl = "--port",
+    .help = "Port of the emulator (127.0.0.1)",
+    .type = OPT_INT,
+    .default_value = &default_port,
+  };
+  add_arg(&parser, &opt_port);
+
+  option_t opt_cycles = {
+    .args = "-c",
+    .argl = "--cycles",
+    .help = "Number of arm/start/stop/de-arm cycles",
+    .type = OPT_INT,
+    .default_value = &default_cycles,
+  };
+  add_arg(&parser, &opt_cycles);
+
+  option_t opt_configure = {
+    .args = "-n",
+    .argl = "--configure",
+    .help = "Number of full configurations",
+    .type = OPT_INT,
+    .default_value = &default_configure,
+  };
+  add_arg(&parser, &opt_configure);
+
+  option_t opt_firmware = {
+    .args = "-f",
+    .argl = "--firmware",
+    .help = "Number of firmware downloads",
+    .type = OPT_INT,
+    .default_value = &default_firmware,
+  };
+  add_arg(&parser, &opt_firmware);
+
+  option_t opt_latency = {
+    .args = "-l",
+    .argl = "--latency",
+    .help = "Delay added by the emulator to every packet sent to the host, in us",
+    .type = OPT_INT,
+    .default_value = &default_zero,
+  };
+  add_arg(&parser, &opt_latency);
+
+  option_t opt_jitter = {
+    .args = "-j",
+    .argl = "--jitter",
+    .help = "Maximum random delay added on top of the latency, in us",
+    .type = OPT_INT,
+    .default_value = &default_zero,
+  };
+  add_arg(&parser, &opt_jitter);
+
+  option_t opt_seed = {
+    .args = "-s",
+    .argl = "--seed",
+    .help = "Seed of the jitter",
+    .type = OPT_INT,
+    .default_value = &default_seed,
+  };
+  add_arg(&parser, &opt_seed);
+
+  option_t opt_irq_polling = {
+    .args = "-q",
+    .argl = "--irq-polling",
+    .help = "Poll the host IRQ of the devices every 1 ms instead of waiting for it",
+    .type = OPT_BOOL,
+  };
+  add_arg(&parser, &opt_irq_polling);
+
+  option_t opt_profile = {
+    .args = "-g",
+    .argl = "--profile",
+    .help = "Profile the runs and write a Chrome trace with the latency histograms to this file",
+    .type = OPT_STR,
+    .default_value = NULL,
+  };
+  add_arg(&parser, &opt_profile);
+
+  parse(&parser, argc, argv);
+  if (get_option(&parser, "help") != NULL) {
+    print_help(&parser);
+    free_parser(&parser);
+    return 0;
+  }
+
+  int nConfigure = *(int *)get_option(&parser, "configure");
+  int nFirmware = *(int *)get_option(&parser, "firmware");
+  int nCycles = *(int *)get_option(&parser, "cycles");
+  simCfg.port = (uint16_t)*(int *)get_option(&parser, "port");
+  simCfg.latencyUs = (uint32_t)*(int *)get_option(&parser, "latency");
+  simCfg.jitterUs = (uint32_t)*(int *)get_option(&parser, "jitter");
+  simCfg.seed = (uint32_t)*(int *)get_option(&parser, "seed");
+  if (get_option(&parser, "irq-polling") != NULL) irq_mode = TDA_IRQ_MODE_POLLING;
+  if (get_option(&parser, "profile") != NULL) {
+    snprintf(g_profile_path, sizeof(g_profile_path), "%s", (char *)get_option(&parser, "profile"));
+    TDAProfEnable(TRUE);
+  }
+  free_parser(&parser);
+
+  if (tda_sim_start(&simCfg) != 0) {
+    fprintf(stderr, "Cannot start the TDA emulator on 127.0.0.1:%u\n", simCfg.port);
+    return 1;
+  }
+  snprintf(g_ip_addr, sizeof(g_ip_addr), "127.0.0.1");
+  bench_save_fw_cache();
+  atexit(bench_cleanup);
+
+  if (load_config(&config, NULL) != 0) return 1;
+  rlTdaArmCfg_t tdaCfg = {
+    .captureDirectory = "/mnt/ssd/",
+    .framePeriodicity = (frameCfgArgs.framePeriodicity * 5)/(1000*1000),
+    .numberOfFilesToAllocate = 0,
+    .numberOfFramesToCapture = 0,
+    .dataPacking = 0,
+  };
+
+  status = MMWL_TDAInit(g_ip_addr, simCfg.port, config.deviceMap, irq_mode);
+  check(status, "[BENCH] TDA emulator connected!",
+    "[BENCH] Couldn't connect to the TDA emulator!", 32, TRUE);
+  g_profile_stage = TDA_PROF_START();
+
+  for (int i = 0; i < nConfigure; i++) {
+    start = now();
+    status = configure(config, TRUE);
+    check(status, "[BENCH] configure()", "[BENCH] configure() failed!", config.deviceMap, TRUE);
+    bench_record(&statConfigure, start);
+  }
+
+  for (int i = 0; i < nFirmware; i++) {
+    start = now();
+    status = MMWL_firmwareDownload(config.deviceMap);
+    check(status, "[BENCH] Firmware download",
+      "[BENCH] Firmware download failed!", config.deviceMap, TRUE);
+    bench_record(&statFirmware, start);
+  }
+
+  for (int i = 0; i < nCycles; i++) {
+    double cycle = now();
+
+    start = now();
+    status = MMWL_ArmingTDA(tdaCfg);
+    check(status, "[BENCH] Arm", "[BENCH] Arming failed!", 32, TRUE);
+    bench_record(&statArm, start);
+
+    start = now();
+    status = MMWL_StartFrameSync(config.deviceMap, &frameSync);
+    check(status, "[BENCH] Start frame", "[BENCH] Start frame failed!", config.deviceMap, TRUE);
+    bench_record(&statStart, start);
+    bench_add(&statStartSkew, frameSync.slaveSkew * 1e-9);
+    bench_add(&statStartMaster, frameSync.masterDelay * 1e-9);
+
+    start = now();
+    status = MMWL_StopFrameSync(config.deviceMap, &frameSync);
+    check(status, "[BENCH] Stop frame", "[BENCH] Stop frame failed!", config.deviceMap, TRUE);
+    bench_record(&statStop, start);
+    bench_add(&statStopSkew, frameSync.slaveSkew * 1e-9);
+
+    start = now();
+    status = MMWL_DeArmingTDA();
+    check(status, "[BENCH] De-arm", "[BENCH] De-arming failed!", 32, TRUE);
+    bench_record(&statDearm, start);
+    bench_record(&statCycle, cycle);
+  }
+
+  tda_sim_stats(&simStats);
+  printf("\nControl path (%s IRQ, latency %u us, jitter %u us)\n",
+    (irq_mode == TDA_IRQ_MODE_POLLING) ? "polled" : "event", simCfg.latencyUs, simCfg.jitterUs);
+  printf("  %-20s %4s  %10s  %10s  %10s\n", "phase", "runs", "min (ms)", "mean (ms)", "max (ms)");
+  bench_print(&statConfigure);
+  bench_print(&statFirmware);
+  bench_print(&statArm);
+  bench_print(&statStart);
+  bench_print(&statStartSkew);
+  bench_print(&statStartMaster);
+  bench_print(&statStop);
+  bench_print(&statStopSkew);
+  bench_print(&statDearm);
+  bench_print(&statCycle);
+  printf("Emulator: %llu packets received (%llu dropped), %llu sent, %llu commands, "
+    "%llu NACKs, %llu async events, %llu host IRQs\n",
+    (unsigned long long)simStats.packetsRx, (unsigned long long)simStats.badPackets,
+    (unsigned long long)simStats.packetsTx, (unsigned long long)simStats.commands,
+    (unsigned long long)simStats.nacks, (unsigned long long)simStats.asyncEvents,
+    (unsigned long long)simStats.hostIrqs);
+
+  printf("\nWaits for the async events and TDA ACKs\n");
+  printf("  %-22s %5s  %8s  %10s  %10s\n", "event", "waits", "timeouts", "mean (ms)", "max (ms)");
+  for (unsigned int evt = 0; evt < MMWL_EVT_COUNT; evt++) {
+    mmwlEventStat_t eventStat;
+    if ((MMWL_eventStats(evt, &eventStat) != 0) || (eventStat.count == 0U)) continue;
+    printf("  %-22s %5u  %8u  %10.2f  %10.2f\n", eventStat.name, eventStat.count,
+      eventStat.timeouts, eventStat.totalNs * 1e-6 / eventStat.count, eventStat.maxNs * 1e-6);
+  }
+
+  status = (simStats.badPackets != 0U) || (simStats.nacks != 0U);
+  exit(status);
+}
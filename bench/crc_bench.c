@@ -0,0 +1,120 @@
+/**
+ * @file crc_bench.c
+ * @brief Microbenchmark of the CRC implementations
+ * @version 0.1
+ * @date 2026-10-14
+ *
+ * @copyright Copyright (c) 2026
+ *
+ * Compares the fast CRC engine (mmwl_crc.c) against the bit-by-bit
+ * `computeCRC()` used by mmWaveLink and the byte-wise CRC16 LUT of the
+ * Ethernet port, after checking that all of them agree.
+ *
+ * Build and run with `make bench-crc`.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "../ti/ethernet/src/mmwl_crc.h"
+
+uint64_t computeCRC(uint8_t *p, uint32_t len, uint8_t width);
+
+/* Packet sizes: Ethernet frame, mmWaveLink message, firmware chunk */
+static const uint32_t sizes[] = { 64, 256, 2048 };
+static uint16_t lut16[256];
+
+
+/**
+ * @brief Byte-wise LUT CRC16, as previously done by Bsp_ar12xxComputeCrc
+ */
+static uint16_t crc16Bytewise(const uint8_t *data, uint32_t len) {
+  uint16_t crc = 0xFFFF;
+  while (len--) crc = lut16[*data++ ^ (crc >> 8)] ^ (uint16_t)(crc << 8);
+  return crc;
+}
+
+
+static double now(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+
+/**
+ * @brief Print the throughput of a CRC over `size` bytes messages
+ */
+#define BENCH(name, size, expr) do {                                      \
+    uint32_t iter = (64U * 1024 * 1024) / (size) / slow;                  \
+    volatile uint64_t sink = 0;                                           \
+    double t0 = now();                                                    \
+    for (uint32_t i = 0; i < iter; i++) sink ^= (expr);                   \
+    double dt = now() - t0;                                               \
+    printf("  %-24s %6u B  %10.1f MB/s  %8.1f ns/msg\n", name, size,      \
+      (double)iter * (size) / dt / 1e6, dt * 1e9 / iter);                 \
+  } while (0)
+
+
+int main(void) {
+  uint8_t *buf = malloc(4096);
+  int status = 0;
+
+  for (unsigned int b = 0; b < 256; b++) {
+    uint16_t c = (uint16_t)(b << 8);
+    for (int bit = 0; bit < 8; bit++) c = (c & 0x8000) ? (c << 1) ^ 0x1021 : (c << 1);
+    lut16[b] = c;
+  }
+  srand(1);
+  for (int i = 0; i < 4096; i++) buf[i] = (uint8_t)rand();
+
+  /* Check every length and every engine against the references */
+  for (uint8_t engine = 0; engine < 3; engine++) {
+    if (MMWL_crcSetEngine(engine) != engine) continue;
+    for (uint32_t len = 1; len <= 1024; len++) {
+      const uint8_t *p = buf + (len & 7);
+      if ((MMWL_crc16(p, len) != (uint16_t)computeCRC((uint8_t*)p, len, 16)) ||
+          (MMWL_crc16(p, len) != crc16Bytewise(p, len)) ||
+          (MMWL_crc32(p, len) != (uint32_t)computeCRC((uint8_t*)p, len, 32)) ||
+          (MMWL_crc64(p, len) != computeCRC((uint8_t*)p, len, 64))) {
+        printf("MISMATCH: engine %s, length %u\n", MMWL_crcEngineName(engine), len);
+        status = 1;
+        break;
+      }
+    }
+  }
+  if (status) return status;
+  printf("All CRC implementations agree\n");
+
+  for (unsigned int s = 0; s < sizeof(sizes) / sizeof(sizes[0]); s++) {
+    uint32_t size = sizes[s];
+    uint32_t slow = 1;
+
+    printf("CRC16-CCITT\n");
+    BENCH("fast (slice-by-8)", size, MMWL_crc16(buf, size));
+    BENCH("ethernet byte-wise LUT", size, crc16Bytewise(buf, size));
+    slow = 32;
+    BENCH("computeCRC bit-by-bit", size, computeCRC(buf, size, 16));
+    slow = 1;
+
+    printf("CRC32\n");
+    for (uint8_t engine = 0; engine < 3; engine++) {
+      if (MMWL_crcSetEngine(engine) != engine) continue;
+      char name[32];
+      snprintf(name, sizeof(name), "fast (%s)", MMWL_crcEngineName(engine));
+      BENCH(name, size, MMWL_crc32(buf, size));
+    }
+    slow = 32;
+    BENCH("computeCRC bit-by-bit", size, computeCRC(buf, size, 32));
+    slow = 1;
+
+    printf("CRC64\n");
+    BENCH("fast (slice-by-8)", size, MMWL_crc64(buf, size));
+    slow = 32;
+    BENCH("computeCRC bit-by-bit", size, computeCRC(buf, size, 64));
+  }
+
+  free(buf);
+  return status;
+}
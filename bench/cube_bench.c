@@ -0,0 +1,270 @@
+/**
+ * @file cube_bench.c
+ * @brief Microbenchmark of the ADC reorder kernel
+ * @version 0.1
+ * @date 2026-10-14
+ *
+ * @copyright Copyright (c) 2026
+ *
+ * Reorders synthetic frames of the default cascade configuration (4
+ * devices, 12 TX, 16 RX) with a naive scalar loop and with the
+ * vectorized kernel (dsp/cube.c), after checking that both agree, on
+ * cache resident frames and on a capture streamed from memory, 16-bit and
+ * 12-bit packed. The kernels are first checked on the other layouts
+ * (non-interleaved RX channels, IQ swap, real samples, 1 and 2 RX).
+ *
+ * Build and run with `make bench-cube`.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "../dsp/cube.h"
+
+#define NUM_FRAMES  64
+
+/* TX transmitting each chirp, per device (see buildMimoChirpTable) */
+static const uint8_t chirpTxTable[4][3] = {
+  {11, 10, 9}, {8, 7, 6}, {5, 4, 3}, {2, 1, 0},
+};
+
+
+static double now(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+
+/**
+ * @brief Naive reorder of interleaved 16-bit complex frames, one value at a time
+ */
+static void reorder_naive(const dspLayout_t *layout, const uint8_t *const raw[4],
+                          size_t stride, uint32_t numFrames, float *cube) {
+  const uint32_t ns = layout->numSamples, nrx = layout->numRx;
+  const uint32_t nrt = layout->numDevices * nrx;
+
+  for (uint32_t f = 0; f < numFrames; f++) {
+    for (uint32_t l = 0; l < layout->numLoops; l++) {
+      for (uint32_t c = 0; c < layout->numChirps; c++) {
+        for (uint32_t d = 0; d < 4; d++) {
+          const int16_t *in = (const int16_t *)(raw[d] + f * stride +
+            ((size_t)l * layout->numChirps + c) * layout->chirpBytes);
+          for (uint32_t rx = 0; rx < nrx; rx++) {
+            for (uint32_t s = 0; s < ns; s++) {
+              float *out = cube + f * layout->cubeSize +
+                ((((size_t)l * layout->numTx + layout->txSlot[c]) * nrt + d * nrx + rx) * ns + s) * 2;
+              out[0] = in[(s * nrx + rx) * 2];
+              out[1] = in[(s * nrx + rx) * 2 + 1];
+            }
+          }
+        }
+      }
+    }
+  }
+}
+
+
+/**
+ * @brief Raw value of a chirp, one value at a time
+ */
+static int16_t raw_value(const uint8_t *chirp, size_t i, uint8_t packed) {
+  if (!packed) return ((const int16_t *)chirp)[i];
+  const uint8_t *b = chirp + i / 2 * 3;
+  uint16_t v = (i % 2 == 0) ? (b[0] | ((b[1] & 0x0F) << 8)) : ((b[1] >> 4) | (b[2] << 4));
+  return (int16_t)(v << 4) >> 4;
+}
+
+
+/**
+ * @brief Naive reorder of any layout, one value at a time
+ */
+static void reorder_reference(const dspLayout_t *layout, const uint8_t *const raw[4],
+                              size_t stride, uint32_t numFrames, float *cube) {
+  const uint32_t ns = layout->numSamples, nrx = layout->numRx;
+  const uint32_t nrt = layout->numDevices * nrx, vals = layout->complex ? 2 : 1;
+  const uint32_t re = (layout->complex && layout->iqSwap) ? 1 : 0;
+
+  for (uint32_t f = 0; f < numFrames; f++) {
+    for (uint32_t l = 0; l < layout->numLoops; l++) {
+      for (uint32_t c = 0; c < layout->numChirps; c++) {
+        for (uint32_t d = 0; d < 4; d++) {
+          if ((layout->deviceMap & (1U << d)) == 0) continue;
+          const uint8_t *in = raw[d] + f * stride + ((size_t)l * layout->numChirps + c) * layout->chirpBytes;
+          for (uint32_t rx = 0; rx < nrx; rx++) {
+            for (uint32_t s = 0; s < ns; s++) {
+              size_t i = (layout->chInterleave ? (size_t)rx * ns + s : (size_t)s * nrx + rx) * vals;
+              float *out = cube + f * layout->cubeSize +
+                ((((size_t)l * layout->numTx + layout->txSlot[c]) * nrt +
+                  layout->devSlot[d] * nrx + rx) * ns + s) * 2;
+              out[0] = raw_value(in, i + re, layout->packed12);
+              out[1] = (vals == 2) ? raw_value(in, i + 1 - re, layout->packed12) : 0.0f;
+            }
+          }
+        }
+      }
+    }
+  }
+}
+
+
+/**
+ * @brief Default cascade layout: 4 devices, 12 TX, 16 RX
+ */
+static void default_layout(dspLayout_t *layout, uint16_t numLoops) {
+  memset(layout, 0, sizeof(dspLayout_t));
+  layout->deviceMap = 0xF;
+  layout->rxChannelEn = 0xF;
+  layout->numSamples = 256;
+  layout->numLoops = numLoops;
+  layout->numChirps = 12;
+  layout->complex = 1;
+  for (uint8_t d = 0; d < 4; d++) {
+    for (uint8_t t = 0; t < 3; t++) layout->chirpTx[d][chirpTxTable[d][t]] = 1U << t;
+  }
+}
+
+
+/**
+ * @brief Check the vectorized reorder against the reference on the layouts
+ *    the benchmark does not time
+ */
+static int check_layouts(void) {
+  // chInterleave, iqSwap, complex, packed12, rxChannelEn, numSamples
+  static const uint8_t variants[][6] = {
+    {1, 0, 1, 0, 0xF, 200}, {1, 1, 1, 1, 0xF, 200}, {0, 1, 1, 1, 0xF, 250},
+    {0, 0, 1, 1, 0x1, 99}, {0, 0, 0, 0, 0x3, 100}, {1, 0, 0, 1, 0x5, 130},
+    {0, 1, 1, 1, 0x7, 67}, {0, 0, 0, 1, 0x3, 33},
+  };
+  const uint32_t numFrames = 3;
+  int status = 0;
+
+  for (size_t v = 0; (v < sizeof(variants) / sizeof(variants[0])) && (status == 0); v++) {
+    dspLayout_t layout;
+    const uint8_t *raw[4] = { NULL };
+    uint8_t *buffers[4];
+    float *ref, *cube;
+    size_t size;
+
+    default_layout(&layout, 3);
+    layout.chInterleave = variants[v][0];
+    layout.iqSwap = variants[v][1];
+    layout.complex = variants[v][2];
+    layout.packed12 = variants[v][3];
+    layout.rxChannelEn = variants[v][4];
+    layout.numSamples = variants[v][5];
+    if (dsp_layout_init(&layout) != 0) {
+      printf("Invalid layout %zu\n", v);
+      return 1;
+    }
+
+    for (uint8_t d = 0; d < 4; d++) {
+      buffers[d] = malloc((size_t)layout.frameBytes * numFrames);
+      for (size_t i = 0; i < (size_t)layout.frameBytes * numFrames; i++) buffers[d][i] = rand();
+      if (layout.deviceMap & (1U << d)) raw[d] = buffers[d];
+    }
+    size = layout.cubeSize * numFrames * sizeof(float);
+    ref = malloc(size);
+    cube = malloc(size);
+    reorder_reference(&layout, raw, layout.frameBytes, numFrames, ref);
+    dsp_cube_frames(&layout, raw, layout.frameBytes, numFrames, cube, 2);
+    if (memcmp(ref, cube, size) != 0) {
+      printf("MISMATCH on layout %zu (chInterleave %u, iqSwap %u, complex %u, packed12 %u, %u RX, %u samples)\n",
+        v, layout.chInterleave, layout.iqSwap, layout.complex, layout.packed12, layout.numRx,
+        layout.numSamples);
+      status = 1;
+    }
+    for (uint8_t d = 0; d < 4; d++) free(buffers[d]);
+    free(ref);
+    free(cube);
+  }
+  if (status == 0) printf("Other layouts: vectorized and reference reorders agree\n");
+  return status;
+}
+
+
+/**
+ * @brief Compare the naive and vectorized reorders over `numFrames` frames
+ *
+ * The reorder is repeated `repeat` times, to measure it on cache resident
+ * data when the frames are small.
+ */
+static int bench(uint16_t numLoops, uint32_t numFrames, uint32_t repeat, uint8_t packed) {
+  dspLayout_t layout;
+  const uint8_t *raw[4];
+  uint8_t *buffers[4];
+  float *ref, *cube;
+  double t0, dt, mb;
+
+  default_layout(&layout, numLoops);
+  layout.packed12 = packed;
+  if (dsp_layout_init(&layout) != 0) {
+    printf("Invalid layout\n");
+    return 1;
+  }
+
+  for (uint8_t d = 0; d < 4; d++) {
+    buffers[d] = malloc((size_t)layout.frameBytes * numFrames);
+    for (size_t i = 0; i < (size_t)layout.frameBytes * numFrames; i++) buffers[d][i] = rand();
+    raw[d] = buffers[d];
+  }
+  ref = malloc(layout.cubeSize * numFrames * sizeof(float));
+  // Aligned to store the cubes bypassing the caches (see cube.h)
+  cube = aligned_alloc(64, layout.cubeSize * numFrames * sizeof(float));
+  mb = 4.0 * layout.frameBytes * numFrames / 1e6;
+
+  printf("%u frames of %u loops x %u TX x %u RX x %u samples (%.1f MB raw, %s), kernel: %s\n",
+    numFrames, layout.numLoops, layout.numTx, layout.numDevices * layout.numRx,
+    layout.numSamples, mb, packed ? "12-bit packed" : "16-bit", dsp_cube_kernel(&layout));
+
+  // Page in the output buffers before timing
+  if (packed) {
+    reorder_reference(&layout, raw, layout.frameBytes, numFrames, ref);
+  } else {
+    reorder_naive(&layout, raw, layout.frameBytes, numFrames, ref);
+  }
+  dsp_cube_frames(&layout, raw, layout.frameBytes, numFrames, cube, 1);
+  if (memcmp(ref, cube, layout.cubeSize * numFrames * sizeof(float)) != 0) {
+    printf("MISMATCH between the naive and vectorized reorders\n");
+    return 1;
+  }
+
+  t0 = now();
+  for (uint32_t i = 0; i < repeat; i++) {
+    if (packed) {
+      reorder_reference(&layout, raw, layout.frameBytes, numFrames, ref);
+    } else {
+      reorder_naive(&layout, raw, layout.frameBytes, numFrames, ref);
+    }
+  }
+  dt = (now() - t0) / repeat;
+  printf("  %-24s %8.1f MB/s  %8.3f ms/frame\n", "naive", mb / dt, dt * 1e3 / numFrames);
+
+  for (uint8_t threads = 1; threads <= 8; threads *= 2) {
+    char name[32];
+    snprintf(name, sizeof(name), "vectorized, %u thread%s", threads, (threads > 1) ? "s" : "");
+    t0 = now();
+    for (uint32_t i = 0; i < repeat; i++) {
+      dsp_cube_frames(&layout, raw, layout.frameBytes, numFrames, cube, threads);
+    }
+    dt = (now() - t0) / repeat;
+    printf("  %-24s %8.1f MB/s  %8.3f ms/frame\n", name, mb / dt, dt * 1e3 / numFrames);
+  }
+
+  for (uint8_t d = 0; d < 4; d++) free(buffers[d]);
+  free(ref);
+  free(cube);
+  return 0;
+}
+
+
+int main(void) {
+  if (check_layouts() != 0) return 1;
+  // Cache resident frames, then a capture streamed from memory
+  for (uint8_t packed = 0; packed <= 1; packed++) {
+    if (bench(2, 8, 100, packed) != 0) return 1;
+    if (bench(64, NUM_FRAMES, 1, packed) != 0) return 1;
+  }
+  return 0;
+}
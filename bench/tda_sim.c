@@ -0,0 +1,779 @@
+/**
+ * @file tda_sim.c
+ * @brief Loopback emulator of the TDA capture card and its AWR2243 devices
+ * @version 0.1
+ * @date 2026-10-14
+ *
+ * @copyright Copyright (c) 2026
+ *
+ * One host connection is served at a time. All the packets are processed
+ * by the connection thread, which owns the state of the devices. When a
+ * latency or jitter is configured, the packets to the host are handed over
+ * to a sender thread which writes each of them once its delay has elapsed.
+ *
+ * Built in the control path benchmark (`make bench-control`), or as a
+ * standalone emulator (`make tda-sim`) to run `./mmwave -i 127.0.0.1`
+ * against.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stddef.h>
+#include <string.h>
+#include <errno.h>
+#include <time.h>
+#include <signal.h>
+#include <pthread.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <arpa/inet.h>
+#include "../ti/mmwavelink/mmwavelink.h"
+#include "../ti/mmwavelink/include/rl_driver.h"
+#include "../ti/ethernet/src/mmwl_port_ethernet.h"
+#include "tda_sim.h"
+
+/* First word of the SPI writes */
+#define TDA_SIM_H2D_SYNC                (0x43211234U)
+#define TDA_SIM_CNYS_SYNC               (0x87655678U)
+
+/* Sync pattern of the messages to the host */
+#define TDA_SIM_D2H_SYNC_1              (0xDCBAU)
+#define TDA_SIM_D2H_SYNC_2              (0xABCDU)
+
+/* Zero filled data of the async event sub-blocks */
+#define TDA_SIM_ASYNC_DATA_LEN          (24U)
+
+/* Bytes of SPI data per packet (the CRC16 takes the end of the data) */
+#define TDA_SIM_SPI_DATA_MAX            (MAX_DATA_LENGTH - 2U)
+
+#define TDA_SIM_VERSION                 "TDA-SIM 0.1"
+
+/* The GET messages have odd IDs, the SET messages and commands even IDs */
+#define TDA_SIM_IS_GET_MSG(msgId)       (((msgId) & 1U) != 0U)
+
+typedef struct tdaSimMsg {
+  rlRhcpMsg_t msg;
+  /**
+   * @brief Sync pattern, header, payload and CRC
+   */
+  uint16_t length;
+} tdaSimMsg_t;
+
+typedef struct tdaSimDevice {
+  tdaSimMsg_t queue[TDA_SIM_QUEUE_DEPTH];
+  uint32_t head;
+  uint32_t count;
+  /**
+   * @brief Message being read by the host (length 0 when done)
+   */
+  tdaSimMsg_t current;
+  uint16_t readPos;
+  uint8_t irqHigh;
+  /**
+   * @brief CRC type of the last command, used by the async events
+   */
+  uint8_t crcType;
+  uint32_t sopMode;
+} tdaSimDevice_t;
+
+typedef struct tdaSimFrame {
+  uint64_t due;
+  uint32_t length;
+  uint8_t data[sizeof(NetworkTDA_CmdHeader) + sizeof(Radar_EthDataPacketPrms)];
+} tdaSimFrame_t;
+
+typedef struct tdaSim {
+  tdaSimCfg_t cfg;
+  int listenFd;
+  int clientFd;
+  volatile uint8_t running;
+  uint8_t delayed;
+  pthread_t serverThread;
+  pthread_t senderThread;
+  /**
+   * @brief Packets waiting for their delay, in the order of their due time
+   */
+  pthread_mutex_t lock;
+  pthread_cond_t cond;
+  tdaSimFrame_t frames[TDA_SIM_DELAY_DEPTH];
+  uint32_t head;
+  uint32_t count;
+  uint64_t lastDue;
+  unsigned int rng;
+  tdaSimDevice_t devices[TDA_SIM_NUM_DEVICES];
+  tdaSimStats_t stats;
+} tdaSim_t;
+
+static tdaSim_t gSim;
+
+
+static uint64_t sim_now(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+
+/**
+ * @brief Write a whole buffer to the host
+ */
+static void sim_write(const uint8_t *data, uint32_t length) {
+  while (length > 0U) {
+    ssize_t sent = send(gSim.clientFd, data, length, MSG_NOSIGNAL);
+
+    if (sent < 0) {
+      if (errno == EINTR) continue;
+      return;
+    }
+    data += sent;
+    length -= (uint32_t)sent;
+  }
+}
+
+
+/**
+ * @brief Read exactly `length` bytes from the host
+ *
+ * @return int 0 on success, -1 if the connection is closed
+ */
+static int sim_read(uint8_t *data, uint32_t length) {
+  while (length > 0U) {
+    ssize_t received = recv(gSim.clientFd, data, length, 0);
+
+    if (received < 0) {
+      if (errno == EINTR) continue;
+      return -1;
+    }
+    if (received == 0) return -1;
+    data += received;
+    length -= (uint32_t)received;
+  }
+  return 0;
+}
+
+
+/**
+ * @brief Send a packet to the host, after its delay when one is configured
+ *
+ * @param opcode Response code
+ * @param ackCode Acknowledged command
+ * @param devSelection Device selection echoed to the host
+ * @param ackType ACK type echoed to the host
+ * @param data Payload (can be NULL when length is 0)
+ * @param length Payload length
+ */
+static void sim_send(uint16_t opcode, uint16_t ackCode, uint8_t devSelection,
+                     uint8_t ackType, const void *data, uint16_t length) {
+  tdaSimFrame_t frame;
+  NetworkTDA_CmdHeader *header = (NetworkTDA_CmdHeader *)frame.data;
+  Radar_EthDataPacketPrms *packet =
+    (Radar_EthDataPacketPrms *)(frame.data + sizeof(NetworkTDA_CmdHeader));
+  uint16_t dataLength = DATA_HEADER_LENGTH + length;
+  uint16_t crc;
+
+  packet->syncByte = RX_SYNC_BYTE;
+  packet->opcode = opcode;
+  packet->ackCode = ackCode;
+  packet->dataLength = dataLength;
+  packet->devSelection = devSelection;
+  packet->ackType = ackType;
+  memset(packet->reserved, 0, sizeof(packet->reserved));
+  if (length > 0U) memcpy(packet->data, data, length);
+  crc = MMWL_crc16((uint8_t *)packet + 2, dataLength);
+  memcpy(packet->data + length, &crc, sizeof(crc));
+  header->prmSize = dataLength + HEADER_AND_CRC_LENGTH;
+  frame.length = sizeof(NetworkTDA_CmdHeader) + header->prmSize;
+  gSim.stats.packetsTx++;
+
+  if (!gSim.delayed) {
+    sim_write(frame.data, frame.length);
+    return;
+  }
+
+  // The due times never decrease, the packets stay in order
+  frame.due = sim_now() + (uint64_t)gSim.cfg.latencyUs * 1000U;
+  if (gSim.cfg.jitterUs > 0U) {
+    frame.due += (uint64_t)(rand_r(&gSim.rng) % (gSim.cfg.jitterUs + 1U)) * 1000U;
+  }
+  pthread_mutex_lock(&gSim.lock);
+  while ((gSim.count == TDA_SIM_DELAY_DEPTH) && gSim.running) {
+    pthread_cond_wait(&gSim.cond, &gSim.lock);
+  }
+  if (frame.due < gSim.lastDue) frame.due = gSim.lastDue;
+  gSim.lastDue = frame.due;
+  memcpy(&gSim.frames[(gSim.head + gSim.count) % TDA_SIM_DELAY_DEPTH], &frame,
+    offsetof(tdaSimFrame_t, data) + frame.length);
+  gSim.count++;
+  pthread_cond_broadcast(&gSim.cond);
+  pthread_mutex_unlock(&gSim.lock);
+}
+
+
+/**
+ * @brief Write the delayed packets to the host once they are due
+ */
+static void *sim_sender(void *arg) {
+  tdaSimFrame_t frame;
+
+  pthread_mutex_lock(&gSim.lock);
+  while (gSim.running) {
+    if (gSim.count == 0U) {
+      pthread_cond_wait(&gSim.cond, &gSim.lock);
+      continue;
+    }
+    uint64_t now = sim_now();
+    uint64_t due = gSim.frames[gSim.head].due;
+    if (due > now) {
+      struct timespec ts = { (time_t)(due / 1000000000ULL), (long)(due % 1000000000ULL) };
+      pthread_cond_timedwait(&gSim.cond, &gSim.lock, &ts);
+      continue;
+    }
+    memcpy(&frame, &gSim.frames[gSim.head], sizeof(frame));
+    gSim.head = (gSim.head + 1U) % TDA_SIM_DELAY_DEPTH;
+    gSim.count--;
+    pthread_cond_broadcast(&gSim.cond);
+    pthread_mutex_unlock(&gSim.lock);
+    sim_write(frame.data, frame.length);
+    pthread_mutex_lock(&gSim.lock);
+  }
+  pthread_mutex_unlock(&gSim.lock);
+  return NULL;
+}
+
+
+/**
+ * @brief Signal a pending message with the host IRQ
+ */
+static void sim_raise_irq(uint8_t devId) {
+  tdaSimDevice_t *dev = &gSim.devices[devId];
+
+  if (dev->irqHigh || (dev->current.length != 0U) || (dev->count == 0U)) return;
+  dev->irqHigh = 1U;
+  gSim.stats.hostIrqs++;
+  sim_send(CAPTURE_RESPONSE_HOST_IRQ, 0U, (uint8_t)(1U << devId), ACK_NOT_REQUIRED, NULL, 0U);
+}
+
+
+/**
+ * @brief Header checksum, as computed by rlDriverCalChkSum
+ */
+static uint16_t sim_checksum(const rlProtHeader_t *hdr) {
+  const uint16_t *words = (const uint16_t *)hdr;
+  uint32_t sum = 0U;
+
+  for (uint32_t i = 0; i < (RHCP_HEADER_LEN - 2U) / 2U; i++) sum += words[i];
+  while ((sum >> 16U) != 0U) sum = (sum & 0xFFFFU) + (sum >> 16U);
+  return (uint16_t)~sum;
+}
+
+
+/**
+ * @brief Queue a message from the device to the host
+ *
+ * @param devId Device index
+ * @param msgClass RL_API_CLASS_RSP, RL_API_CLASS_NACK or RL_API_CLASS_ASYNC
+ * @param dir Direction of the message (to the host)
+ * @param msgId Message ID
+ * @param seqNum Sequence number of the command
+ * @param crcType CRC type, RL_CRC_TYPE_NO_CRC for a message without CRC
+ * @param nsbc Number of sub-blocks
+ * @param payload Sub-blocks
+ * @param payloadLen Length of the sub-blocks
+ */
+static void sim_queue(uint8_t devId, uint8_t msgClass, uint8_t dir, uint16_t msgId,
+                      uint8_t seqNum, uint8_t crcType, uint16_t nsbc,
+                      const void *payload, uint16_t payloadLen) {
+  tdaSimDevice_t *dev = &gSim.devices[devId];
+  tdaSimMsg_t *msg;
+  rlProtHeader_t *hdr;
+  uint16_t crcLen = (crcType == RL_CRC_TYPE_NO_CRC) ? 0U : (2U << (crcType & 0x3U));
+
+  if (dev->count == TDA_SIM_QUEUE_DEPTH) {
+    fprintf(stderr, "[TDA-SIM] Device %u: message queue full, message 0x%03X dropped\n",
+      devId, msgId);
+    return;
+  }
+  msg = &dev->queue[(dev->head + dev->count) % TDA_SIM_QUEUE_DEPTH];
+  memset(&msg->msg.hdr, 0, sizeof(msg->msg.hdr));
+  hdr = &msg->msg.hdr;
+  msg->msg.syncPattern.sync1 = TDA_SIM_D2H_SYNC_1;
+  msg->msg.syncPattern.sync2 = TDA_SIM_D2H_SYNC_2;
+  hdr->opcode.b4Direction = dir;
+  hdr->opcode.b2MsgType = msgClass;
+  hdr->opcode.b10MsgId = msgId;
+  hdr->len = RHCP_HEADER_LEN + payloadLen + crcLen;
+  hdr->flags.b2Crc = (crcLen == 0U) ? RL_HDR_FLAG_NO_CRC : RL_HDR_FLAG_CRC;
+  hdr->flags.b2CrcLen = (crcLen == 0U) ? 0U : crcType;
+  hdr->flags.b4SeqNum = seqNum;
+  hdr->nsbc = nsbc;
+  hdr->chksum = sim_checksum(hdr);
+  if (payloadLen > 0U) memcpy(msg->msg.payload, payload, payloadLen);
+  if (crcLen > 0U) {
+    uint64_t crc = MMWL_crcCompute(crcType, (uint8_t *)hdr, RHCP_HEADER_LEN + payloadLen);
+    memcpy(&msg->msg.payload[payloadLen], &crc, crcLen);
+  }
+  msg->length = SYNC_PATTERN_LEN + hdr->len;
+  dev->count++;
+  sim_raise_irq(devId);
+}
+
+
+/**
+ * @brief Queue an async event with a zero filled sub-block
+ */
+static void sim_queue_async(uint8_t devId, uint8_t dir, uint16_t msgId, uint16_t sb) {
+  uint16_t payload[2U + TDA_SIM_ASYNC_DATA_LEN / 2U] = { 0 };
+
+  payload[0] = RL_GET_UNIQUE_SBID(msgId, sb);
+  payload[1] = 4U + TDA_SIM_ASYNC_DATA_LEN;
+  gSim.stats.asyncEvents++;
+  sim_queue(devId, RL_API_CLASS_ASYNC, dir, msgId, 0U, gSim.devices[devId].crcType, 1U,
+    payload, sizeof(payload));
+}
+
+
+/**
+ * @brief Answer an RHCP command written over SPI
+ *
+ * The SET messages and commands get an empty response, the GET messages a
+ * single sub-block without data (the host then keeps a zeroed structure).
+ * A command with a wrong checksum or CRC is rejected with a NACK.
+ */
+static void sim_command(uint8_t devId, const uint8_t *data, uint16_t length) {
+  tdaSimDevice_t *dev = &gSim.devices[devId];
+  rlProtHeader_t hdr;
+  const uint8_t *payload = data + SYNC_PATTERN_LEN + RHCP_HEADER_LEN;
+  uint16_t msgId, sbId = 0U, crcLen = 0U;
+  uint8_t crcType = RL_CRC_TYPE_NO_CRC;
+  uint8_t dir;
+
+  memcpy(&hdr, data + SYNC_PATTERN_LEN, sizeof(hdr));
+  msgId = hdr.opcode.b10MsgId;
+  dir = hdr.opcode.b4Direction + 1U;
+  if (hdr.flags.b2Crc == RL_HDR_FLAG_CRC) {
+    crcType = hdr.flags.b2CrcLen;
+    crcLen = 2U << (crcType & 0x3U);
+  }
+
+  if ((hdr.chksum != sim_checksum(&hdr)) || (hdr.len < RHCP_HEADER_LEN + crcLen) ||
+      (hdr.len > length - SYNC_PATTERN_LEN)) {
+    gSim.stats.nacks++;
+    sim_queue(devId, RL_API_CLASS_NACK, dir, msgId, hdr.flags.b4SeqNum, crcType, 0U, NULL, 0U);
+    return;
+  }
+  if (crcLen > 0U) {
+    uint64_t crc = MMWL_crcCompute(crcType, data + SYNC_PATTERN_LEN, hdr.len - crcLen);
+    if (memcmp(&crc, data + SYNC_PATTERN_LEN + hdr.len - crcLen, crcLen) != 0) {
+      gSim.stats.nacks++;
+      sim_queue(devId, RL_API_CLASS_NACK, dir, msgId, hdr.flags.b4SeqNum, crcType, 0U, NULL, 0U);
+      return;
+    }
+    dev->crcType = crcType;
+  }
+  if (hdr.nsbc > 0U) memcpy(&sbId, payload, sizeof(sbId));
+  gSim.stats.commands++;
+
+  if (TDA_SIM_IS_GET_MSG(msgId)) {
+    uint16_t sb[2] = { sbId, 4U };
+    sim_queue(devId, RL_API_CLASS_RSP, dir, msgId, hdr.flags.b4SeqNum, crcType, 1U, sb, sizeof(sb));
+  } else {
+    sim_queue(devId, RL_API_CLASS_RSP, dir, msgId, hdr.flags.b4SeqNum, crcType, 0U, NULL, 0U);
+  }
+
+  // Async events completing the command
+  switch (msgId) {
+    case RL_RF_INIT_MSG:
+      sim_queue_async(devId, RL_API_DIR_BSS_TO_HOST, RL_RF_ASYNC_EVENT_MSG,
+        RL_RF_AE_INITCALIBSTATUS_SB);
+      break;
+    case RL_DEV_POWERUP_MSG:
+      if (sbId == RL_GET_UNIQUE_SBID(RL_DEV_POWERUP_MSG, RL_SYS_RF_POWERUP_SB)) {
+        sim_queue_async(devId, RL_API_DIR_MSS_TO_HOST, RL_DEV_ASYNC_EVENT_MSG,
+          RL_DEV_AE_RFPOWERUPDONE_SB);
+      }
+      break;
+    case RL_RF_FRAME_TRIG_MSG: {
+      uint16_t startStop = 0U;
+      if (hdr.nsbc > 0U) memcpy(&startStop, payload + 4U, sizeof(startStop));
+      sim_queue_async(devId, RL_API_DIR_BSS_TO_HOST, RL_RF_ASYNC_EVENT_MSG,
+        (startStop != 0U) ? RL_RF_AE_FRAME_TRIGGER_RDY_SB : RL_RF_AE_FRAME_END_SB);
+      break;
+    }
+    default:
+      break;
+  }
+}
+
+
+/**
+ * @brief SPI write: RHCP command, or CNYS pattern to read the next message
+ */
+static void sim_spi_write(uint8_t devId, const Radar_EthDataPacketPrms *packet) {
+  tdaSimDevice_t *dev = &gSim.devices[devId];
+  uint16_t length = packet->dataLength - DATA_HEADER_LENGTH;
+  uint32_t sync;
+
+  if (length < SYNC_PATTERN_LEN + RHCP_HEADER_LEN) return;
+  memcpy(&sync, packet->data, sizeof(sync));
+
+  if (sync == TDA_SIM_CNYS_SYNC) {
+    // The host IRQ goes low once the device has moved the message out
+    if (dev->count > 0U) {
+      memcpy(&dev->current, &dev->queue[dev->head], sizeof(tdaSimMsg_t));
+      dev->head = (dev->head + 1U) % TDA_SIM_QUEUE_DEPTH;
+      dev->count--;
+    }
+    dev->readPos = 0U;
+    dev->irqHigh = 0U;
+    sim_send(CAPTURE_RESPONSE_ACK, SENSOR_CONFIG_SPI_WRITE, packet->devSelection,
+      ACK_ON_PROCESS, NULL, 0U);
+  } else if (sync == TDA_SIM_H2D_SYNC) {
+    if (packet->ackType == ACK_ON_RECEIVE) {
+      sim_send(CAPTURE_RESPONSE_ACK, SENSOR_CONFIG_SPI_WRITE, packet->devSelection,
+        ACK_ON_RECEIVE, NULL, 0U);
+    }
+    sim_command(devId, packet->data, length);
+  }
+}
+
+
+/**
+ * @brief SPI read: the next bytes of the message being read
+ *
+ * The bytes past the end of the message read as zeros. The next queued
+ * message is signaled once the current one is completely read.
+ */
+static void sim_spi_read(uint8_t devId, const Radar_EthDataPacketPrms *packet) {
+  tdaSimDevice_t *dev = &gSim.devices[devId];
+  uint8_t data[TDA_SIM_SPI_DATA_MAX] = { 0 };
+  uint16_t count = 0U, available;
+
+  memcpy(&count, packet->data, sizeof(count));
+  if (count > TDA_SIM_SPI_DATA_MAX) count = TDA_SIM_SPI_DATA_MAX;
+  available = (dev->current.length > dev->readPos) ? dev->current.length - dev->readPos : 0U;
+  if (available > count) available = count;
+  memcpy(data, (uint8_t *)&dev->current.msg + dev->readPos, available);
+  dev->readPos += available;
+  gSim.stats.spiReads++;
+  sim_send(SENSOR_RESPONSE_SPI_DATA, 0U, packet->devSelection, packet->ackType, data, count);
+
+  if ((dev->current.length != 0U) && (dev->readPos >= dev->current.length)) {
+    dev->current.length = 0U;
+    sim_raise_irq(devId);
+  }
+}
+
+
+/**
+ * @brief Reset a device: its MSS boots and reports the power up
+ */
+static void sim_reset(uint8_t devId) {
+  tdaSimDevice_t *dev = &gSim.devices[devId];
+  uint8_t crcType = dev->crcType;
+  uint32_t sopMode = dev->sopMode;
+
+  memset(dev, 0, sizeof(*dev));
+  dev->crcType = crcType;
+  dev->sopMode = sopMode;
+  sim_queue_async(devId, RL_API_DIR_MSS_TO_HOST, RL_DEV_ASYNC_EVENT_MSG,
+    RL_DEV_AE_MSSPOWERUPDONE_SB);
+}
+
+
+/**
+ * @brief Process a packet of the host
+ */
+static void sim_process(const Radar_EthDataPacketPrms *packet) {
+  uint8_t devSelection = packet->devSelection;
+  int devId = -1;
+  uint8_t ack = (packet->ackType != ACK_NOT_REQUIRED);
+
+  for (uint8_t i = 0; i < TDA_SIM_NUM_DEVICES; i++) {
+    if (devSelection == (1U << i)) devId = i;
+  }
+
+  switch (packet->opcode) {
+    case SENSOR_CONFIG_SPI_WRITE:
+      if (devId >= 0) sim_spi_write((uint8_t)devId, packet);
+      return;
+
+    case SENSOR_CONFIG_SPI_READ:
+      if (devId >= 0) sim_spi_read((uint8_t)devId, packet);
+      return;
+
+    case CAPTURE_CONFIG_VERSION_GET: {
+      char version[32] = TDA_SIM_VERSION;
+      sim_send(CAPTURE_RESPONSE_VERSION_INFO, 0U, devSelection, packet->ackType,
+        version, sizeof(version));
+      return;
+    }
+
+    case CAPTURE_CONFIG_CONFIG_GET: {
+      uint8_t config[8] = { 0 };
+      sim_send(CAPTURE_RESPONSE_CONFIG_INFO, 0U, devSelection, packet->ackType,
+        config, sizeof(config));
+      return;
+    }
+
+    case SENSOR_CONFIG_GET_SOP: {
+      uint32_t sopMode = (devId >= 0) ? gSim.devices[devId].sopMode : 0U;
+      sim_send(SENSOR_RESPONSE_SOP_INFO, 0U, devSelection, packet->ackType,
+        &sopMode, sizeof(sopMode));
+      return;
+    }
+
+    case SENSOR_CONFIG_SET_SOP:
+      if (devId >= 0) memcpy(&gSim.devices[devId].sopMode, packet->data, sizeof(uint32_t));
+      break;
+
+    case SENSOR_CONFIG_DEVICE_RESET:
+      if (devId >= 0) sim_reset((uint8_t)devId);
+      break;
+
+    case CAPTURE_CONFIG_CONNECT:
+    case CAPTURE_CONFIG_DISCONNECT:
+    case CAPTURE_CONFIG_PING:
+    case CAPTURE_CONFIG_CONFIG_SET:
+    case CAPTURE_CONFIG_TRACE_START:
+    case CAPTURE_CONFIG_TRACE_RETREIVE:
+    case CAPTURE_CONFIG_CREATE_APPLICATION:
+    case CAPTURE_CONFIG_START_LOGGING_STATS:
+    case CAPTURE_CONFIG_DEVICE_MAP:
+    case SENSOR_CONFIG_GPIO_CONFIG:
+    case SENSOR_CONFIG_GPIO_SET:
+    case SENSOR_CONFIG_GPIO_GET:
+    case CAPTURE_DATA_START_RECORD:
+    case CAPTURE_DATA_STOP_RECORD:
+    case CAPTURE_DATA_FRAME_PERIODICITY:
+    case CAPTURE_DATA_NUM_ALLOCATED_FILES:
+    case CAPTURE_DATA_ENABLE_DATA_PACKAGING:
+    case CAPTURE_DATA_SESSION_DIRECTORY:
+    case CAPTURE_DATA_NUM_FRAMES:
+      break;
+
+    default:
+      sim_send(CAPTURE_RESPONSE_NACK, packet->opcode, devSelection, packet->ackType, NULL, 0U);
+      return;
+  }
+  if (ack) sim_send(CAPTURE_RESPONSE_ACK, packet->opcode, devSelection, packet->ackType, NULL, 0U);
+}
+
+
+/**
+ * @brief Accept the host connections and serve their packets
+ */
+static void *sim_server(void *arg) {
+  uint8_t buffer[sizeof(Radar_EthDataPacketPrms) + HEADER_AND_CRC_LENGTH];
+  Radar_EthDataPacketPrms *packet = (Radar_EthDataPacketPrms *)buffer;
+
+  while (gSim.running) {
+    int fd = accept(gSim.listenFd, NULL, NULL);
+    int one = 1;
+
+    if (fd < 0) {
+      if (errno == EINTR) continue;
+      break;
+    }
+    setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+    gSim.clientFd = fd;
+    for (uint8_t i = 0; i < TDA_SIM_NUM_DEVICES; i++) {
+      memset(&gSim.devices[i], 0, sizeof(tdaSimDevice_t));
+      gSim.devices[i].crcType = RL_CRC_TYPE_32BIT;
+    }
+
+    while (gSim.running) {
+      NetworkTDA_CmdHeader header;
+      uint16_t crc;
+
+      if (sim_read((uint8_t *)&header, sizeof(header)) != 0) break;
+      if ((header.prmSize < DATA_HEADER_LENGTH + HEADER_AND_CRC_LENGTH) ||
+          (header.prmSize > sizeof(buffer))) {
+        fprintf(stderr, "[TDA-SIM] Invalid packet size %u, connection closed\n", header.prmSize);
+        break;
+      }
+      if (sim_read(buffer, header.prmSize) != 0) break;
+      gSim.stats.packetsRx++;
+
+      memcpy(&crc, buffer + header.prmSize - 2U, sizeof(crc));
+      if ((packet->syncByte != TX_SYNC_BYTE) ||
+          (packet->dataLength != header.prmSize - HEADER_AND_CRC_LENGTH) ||
+          (MMWL_crc16(buffer + 2U, packet->dataLength) != crc)) {
+        gSim.stats.badPackets++;
+        continue;
+      }
+      sim_process(packet);
+    }
+    shutdown(fd, SHUT_RDWR);
+    close(fd);
+    gSim.clientFd = -1;
+  }
+  return NULL;
+}
+
+
+/**
+ * @brief Start the emulator on 127.0.0.1
+ *
+ * @param cfg Port, latency and jitter of the emulator
+ * @return int32_t 0 on success, -1 if the port cannot be bound
+ */
+int32_t tda_sim_start(const tdaSimCfg_t *cfg) {
+  struct sockaddr_in addr;
+  pthread_condattr_t attr;
+  int one = 1;
+
+  memset(&gSim, 0, sizeof(gSim));
+  gSim.cfg = *cfg;
+  gSim.clientFd = -1;
+  gSim.rng = cfg->seed;
+  gSim.delayed = (cfg->latencyUs > 0U) || (cfg->jitterUs > 0U);
+  MMWL_crcInit();
+
+  gSim.listenFd = socket(AF_INET, SOCK_STREAM, 0);
+  if (gSim.listenFd < 0) return -1;
+  setsockopt(gSim.listenFd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+  memset(&addr, 0, sizeof(addr));
+  addr.sin_family = AF_INET;
+  addr.sin_port = htons(cfg->port);
+  addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+  if ((bind(gSim.listenFd, (struct sockaddr *)&addr, sizeof(addr)) != 0) ||
+      (listen(gSim.listenFd, 1) != 0)) {
+    close(gSim.listenFd);
+    return -1;
+  }
+
+  pthread_mutex_init(&gSim.lock, NULL);
+  pthread_condattr_init(&attr);
+  pthread_condattr_setclock(&attr, CLOCK_MONOTONIC);
+  pthread_cond_init(&gSim.cond, &attr);
+  pthread_condattr_destroy(&attr);
+
+  gSim.running = 1U;
+  if (gSim.delayed) pthread_create(&gSim.senderThread, NULL, sim_sender, NULL);
+  pthread_create(&gSim.serverThread, NULL, sim_server, NULL);
+  return 0;
+}
+
+
+/**
+ * @brief Close the connection and stop the emulator
+ */
+void tda_sim_stop(void) {
+  if (!gSim.running) return;
+
+  gSim.running = 0U;
+  shutdown(gSim.listenFd, SHUT_RDWR);
+  if (gSim.clientFd >= 0) shutdown(gSim.clientFd, SHUT_RDWR);
+  pthread_join(gSim.serverThread, NULL);
+  close(gSim.listenFd);
+
+  if (gSim.delayed) {
+    pthread_mutex_lock(&gSim.lock);
+    pthread_cond_broadcast(&gSim.cond);
+    pthread_mutex_unlock(&gSim.lock);
+    pthread_join(gSim.senderThread, NULL);
+  }
+  pthread_cond_destroy(&gSim.cond);
+  pthread_mutex_destroy(&gSim.lock);
+}
+
+
+/**
+ * @brief Counters of the emulator since its start
+ */
+void tda_sim_stats(tdaSimStats_t *stats) {
+  memcpy(stats, &gSim.stats, sizeof(*stats));
+}
+
+
+#ifdef TDA_SIM_MAIN
+#include "../opt/opt.h"
+
+static volatile sig_atomic_t gSimStop = 0;
+
+static void sim_signal_handler(int signum) {
+  gSimStop = 1;
+}
+
+
+int main(int argc, char *argv[]) {
+  parser_t parser = init_parser("tda_sim", "Loopback emulator of the TDA capture card");
+  tdaSimCfg_t cfg;
+  tdaSimStats_t stats;
+  int default_port = NETWORK_TDA_SERVER_PORT;
+  int default_zero = 0;
+  int default_seed = 1;
+
+  option_t opt_port = {
+    .args = "-p",
+    .argl = "--port",
+    .help = "Port to listen on (127.0.0.1)",
+    .type = OPT_INT,
+    .default_value = &default_port,
+  };
+  add_arg(&parser, &opt_port);
+
+  option_t opt_latency = {
+    .args = "-l",
+    .argl = "--latency",
+    .help = "Delay added to every packet sent to the host, in us",
+    .type = OPT_INT,
+    .default_value = &default_zero,
+  };
+  add_arg(&parser, &opt_latency);
+
+  option_t opt_jitter = {
+    .args = "-j",
+    .argl = "--jitter",
+    .help = "Maximum random delay added on top of the latency, in us",
+    .type = OPT_INT,
+    .default_value = &default_zero,
+  };
+  add_arg(&parser, &opt_jitter);
+
+  option_t opt_seed = {
+    .args = "-s",
+    .argl = "--seed",
+    .help = "Seed of the jitter",
+    .type = OPT_INT,
+    .default_value = &default_seed,
+  };
+  add_arg(&parser, &opt_seed);
+
+  parse(&parser, argc, argv);
+  if (get_option(&parser, "help") != NULL) {
+    print_help(&parser);
+    free_parser(&parser);
+    return 0;
+  }
+
+  cfg.port = (uint16_t)*(int *)get_option(&parser, "port");
+  cfg.latencyUs = (uint32_t)*(int *)get_option(&parser, "latency");
+  cfg.jitterUs = (uint32_t)*(int *)get_option(&parser, "jitter");
+  cfg.seed = (uint32_t)*(int *)get_option(&parser, "seed");
+  free_parser(&parser);
+
+  if (tda_sim_start(&cfg) != 0) {
+    fprintf(stderr, "[TDA-SIM] Cannot listen on 127.0.0.1:%u\n", cfg.port);
+    return 1;
+  }
+  printf("[TDA-SIM] Listening on 127.0.0.1:%u (latency %u us, jitter %u us)\n",
+    cfg.port, cfg.latencyUs, cfg.jitterUs);
+
+  signal(SIGINT, sim_signal_handler);
+  signal(SIGTERM, sim_signal_handler);
+  while (!gSimStop) pause();
+  tda_sim_stop();
+
+  tda_sim_stats(&stats);
+  printf("[TDA-SIM] %llu packets received (%llu dropped), %llu sent, %llu commands, "
+    "%llu NACKs, %llu async events, %llu host IRQs\n",
+    (unsigned long long)stats.packetsRx, (unsigned long long)stats.badPackets,
+    (unsigned long long)stats.packetsTx, (unsigned long long)stats.commands,
+    (unsigned long long)stats.nacks, (unsigned long long)stats.asyncEvents,
+    (unsigned long long)stats.hostIrqs);
+  return 0;
+}
+#endif
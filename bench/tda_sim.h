@@ -0,0 +1,79 @@
+/**
+ * @file tda_sim.h
+ * @brief Loopback emulator of the TDA capture card and its AWR2243 devices
+ * @version 0.1
+ * @date 2026-10-14
+ *
+ * @copyright Copyright (c) 2026
+ *
+ * The emulator listens on a local TCP port and speaks the framing of the
+ * Ethernet port layer (NetworkTDA_CmdHeader + Radar_EthDataPacketPrms with
+ * its CRC16). The board commands are acknowledged as the TDA does. Behind
+ * the SPI writes and reads, each device answers the mmWaveLink (RHCP)
+ * commands with a canned response: an empty response for the SET
+ * messages, a zero filled sub-block for the GET messages. The async events
+ * the bring-up waits for (power up, RF init, frame start/end) are queued
+ * after the commands which trigger them and signaled with
+ * CAPTURE_RESPONSE_HOST_IRQ.
+ *
+ * Every packet sent to the host can be delayed by a fixed latency plus a
+ * uniformly distributed jitter. The packets keep their order, as on TCP.
+ */
+
+#ifndef TDA_SIM_H
+#define TDA_SIM_H
+
+#include <stdint.h>
+
+/* Devices behind the emulated TDA */
+#define TDA_SIM_NUM_DEVICES             (4U)
+
+/* Pending RHCP messages per device (response and async events) */
+#define TDA_SIM_QUEUE_DEPTH             (32U)
+
+/* Packets waiting for their delay to elapse */
+#define TDA_SIM_DELAY_DEPTH             (256U)
+
+typedef struct tdaSimCfg {
+  /**
+   * @brief Port to listen on (127.0.0.1)
+   */
+  uint16_t port;
+  /**
+   * @brief Delay added to every packet sent to the host, in us
+   */
+  uint32_t latencyUs;
+  /**
+   * @brief Maximum random delay added on top of the latency, in us
+   */
+  uint32_t jitterUs;
+  /**
+   * @brief Seed of the jitter
+   */
+  uint32_t seed;
+} tdaSimCfg_t;
+
+typedef struct tdaSimStats {
+  uint64_t packetsRx;
+  uint64_t packetsTx;
+  /**
+   * @brief Packets dropped on a wrong sync byte or CRC
+   */
+  uint64_t badPackets;
+  /**
+   * @brief RHCP commands answered / rejected with a NACK
+   */
+  uint64_t commands;
+  uint64_t nacks;
+  uint64_t asyncEvents;
+  uint64_t hostIrqs;
+  uint64_t spiReads;
+} tdaSimStats_t;
+
+int32_t tda_sim_start(const tdaSimCfg_t *cfg);
+
+void tda_sim_stop(void);
+
+void tda_sim_stats(tdaSimStats_t *stats);
+
+#endif
@@ -0,0 +1,280 @@
+/**
+ * @file align.c
+ * @brief Cross-board alignment index of the captures
+ * @version 0.1
+ * @date 2026-10-14
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include "align.h"
+
+
+/**
+ * @brief Create the parent directories of a path
+ *
+ * @param path File path
+ * @return int32_t 0 on success, -1 on failure
+ */
+static int32_t cap_align_mkdir_parents(const char *path) {
+  char dir[512];
+  char *p;
+
+  snprintf(dir, sizeof(dir), "%s", path);
+  for (p = dir + 1; *p != '\0'; p++) {
+    if (*p != '/') continue;
+    *p = '\0';
+    if ((mkdir(dir, 0755) != 0) && (errno != EEXIST)) return -1;
+    *p = '/';
+  }
+  return 0;
+}
+
+
+/**
+ * @brief Write the record of a board
+ *
+ * Only the header and the record of the board are written: the other
+ * boards of the session write theirs in the same file at the same time.
+ *
+ * @param path Path of the alignment index
+ * @param captureDir Name of the capture directory
+ * @param numBoards Number of boards of the session
+ * @param board Record of the board (at board->boardIndex)
+ * @return int32_t 0 on success, -1 on failure
+ */
+int32_t cap_align_write(const char *path, const char *captureDir, uint8_t numBoards,
+                        const capAlignBoard_t *board) {
+  capAlignHeader_t header;
+  off_t offset;
+  int32_t status = 0;
+  int fd;
+
+  if ((numBoards == 0) || (numBoards > CAP_ALIGN_MAX_BOARDS) ||
+      (board->boardIndex >= numBoards)) {
+    return -1;
+  }
+  memset(&header, 0, sizeof(header));
+  header.magic = CAP_ALIGN_MAGIC;
+  header.version = CAP_ALIGN_VERSION;
+  header.headerSize = sizeof(capAlignHeader_t);
+  header.boardSize = sizeof(capAlignBoard_t);
+  header.numBoards = numBoards;
+  snprintf(header.captureDir, sizeof(header.captureDir), "%s", captureDir);
+
+  if (cap_align_mkdir_parents(path) != 0) return -1;
+  fd = open(path, O_WRONLY | O_CREAT | O_CLOEXEC, 0644);
+  if (fd < 0) return -1;
+  // Same header from all the boards of the session
+  offset = sizeof(capAlignHeader_t) + (off_t)board->boardIndex * sizeof(capAlignBoard_t);
+  if ((pwrite(fd, &header, sizeof(header), 0) != sizeof(header)) ||
+      (pwrite(fd, board, sizeof(capAlignBoard_t), offset) != sizeof(capAlignBoard_t))) {
+    status = -1;
+  }
+  if (close(fd) != 0) status = -1;
+  return status;
+}
+
+
+/**
+ * @brief Read an alignment index
+ *
+ * The boards of the latest session found in the file, with a start record,
+ * are set in align->boardMap.
+ *
+ * @param align Alignment index
+ * @param path Path of the alignment index
+ * @return int32_t 0 on success, -1 on failure or without any started board
+ */
+int32_t cap_align_load(capAlign_t *align, const char *path) {
+  uint64_t sessionTime = 0;
+  ssize_t n;
+  int fd;
+
+  memset(align, 0, sizeof(capAlign_t));
+  fd = open(path, O_RDONLY | O_CLOEXEC);
+  if (fd < 0) return -1;
+  n = pread(fd, &align->header, sizeof(capAlignHeader_t), 0);
+  if ((n != sizeof(capAlignHeader_t)) || (align->header.magic != CAP_ALIGN_MAGIC) ||
+      (align->header.version != CAP_ALIGN_VERSION) ||
+      (align->header.headerSize != sizeof(capAlignHeader_t)) ||
+      (align->header.boardSize != sizeof(capAlignBoard_t)) ||
+      (align->header.numBoards == 0) || (align->header.numBoards > CAP_ALIGN_MAX_BOARDS)) {
+    close(fd);
+    return -1;
+  }
+  // Records not written yet (board failed) read as not started
+  n = pread(fd, align->boards, align->header.numBoards * sizeof(capAlignBoard_t),
+    sizeof(capAlignHeader_t));
+  close(fd);
+  if (n < 0) return -1;
+  if ((size_t)n < align->header.numBoards * sizeof(capAlignBoard_t)) {
+    memset((uint8_t *)align->boards + n, 0, align->header.numBoards * sizeof(capAlignBoard_t) - n);
+  }
+
+  for (uint8_t b = 0; b < align->header.numBoards; b++) {
+    const capAlignBoard_t *board = &align->boards[b];
+    if ((board->flags & CAP_ALIGN_STARTED) && (board->framePeriod > 0) &&
+        (board->boardIndex == b) && (board->sessionTime > sessionTime)) {
+      sessionTime = board->sessionTime;
+    }
+  }
+  for (uint8_t b = 0; b < align->header.numBoards; b++) {
+    const capAlignBoard_t *board = &align->boards[b];
+    if ((board->flags & CAP_ALIGN_STARTED) && (board->framePeriod > 0) &&
+        (board->boardIndex == b) && (board->sessionTime == sessionTime)) {
+      align->boardMap |= (1U << b);
+    }
+  }
+  return (align->boardMap != 0) ? 0 : -1;
+}
+
+
+/**
+ * @brief Device generating the frames of a board: the master, or the
+ *    first device of the board without it
+ */
+static uint8_t cap_align_reference(const capAlignBoard_t *board) {
+  for (uint8_t devId = 0; devId < CAP_MAX_DEVICES; devId++) {
+    if ((board->deviceMap & (1U << devId)) && (board->startTime[devId] != 0)) return devId;
+  }
+  return 0;
+}
+
+
+/**
+ * @brief Number of frames triggered on a board
+ *
+ * The frames triggered before the stop dispatch, up to the number of frames
+ * of the frame config. Without stop record (recording interrupted), the
+ * number of frames of the frame config, 0 when framing until stopped.
+ *
+ * @param align Alignment index
+ * @param board Board index
+ * @return uint32_t Number of frames
+ */
+uint32_t cap_align_num_frames(const capAlign_t *align, uint8_t board) {
+  const capAlignBoard_t *rec;
+  uint64_t start, stop, frames;
+  uint8_t ref;
+
+  if ((board >= CAP_ALIGN_MAX_BOARDS) || !(align->boardMap & (1U << board))) return 0;
+  rec = &align->boards[board];
+  if (!(rec->flags & CAP_ALIGN_STOPPED)) return rec->numFrames;
+
+  ref = cap_align_reference(rec);
+  start = rec->startTime[ref];
+  stop = rec->stopTime[ref];
+  frames = (stop > start) ? (stop - start + rec->framePeriod - 1) / rec->framePeriod : 0;
+  if ((rec->numFrames > 0) && (frames > rec->numFrames)) frames = rec->numFrames;
+  return (uint32_t)frames;
+}
+
+
+/**
+ * @brief Trigger time of a frame of a board
+ *
+ * @param align Alignment index
+ * @param board Board index
+ * @param frame Frame number
+ * @return uint64_t CLOCK_REALTIME time (ns), 0 if the board did not start
+ */
+uint64_t cap_align_frame_time(const capAlign_t *align, uint8_t board, uint32_t frame) {
+  const capAlignBoard_t *rec;
+
+  if ((board >= CAP_ALIGN_MAX_BOARDS) || !(align->boardMap & (1U << board))) return 0;
+  rec = &align->boards[board];
+  return rec->startTime[cap_align_reference(rec)] + (uint64_t)frame * rec->framePeriod;
+}
+
+
+/**
+ * @brief Frame of a board triggered closest to a time
+ *
+ * @param align Alignment index
+ * @param board Board index
+ * @param time CLOCK_REALTIME time (ns)
+ * @param skew Trigger time of the frame minus time (ns, can be NULL)
+ * @return int64_t Frame number, -1 if the time is more than half a frame
+ *    period before the first frame or after the last one of the board
+ */
+int64_t cap_align_frame_at(const capAlign_t *align, uint8_t board, uint64_t time,
+                           int64_t *skew) {
+  const capAlignBoard_t *rec;
+  uint64_t start, half;
+  uint32_t numFrames;
+  int64_t frame;
+
+  if ((board >= CAP_ALIGN_MAX_BOARDS) || !(align->boardMap & (1U << board))) return -1;
+  rec = &align->boards[board];
+  start = rec->startTime[cap_align_reference(rec)];
+  half = rec->framePeriod / 2;
+  if (time + half < start) return -1;
+
+  frame = (time + half - start) / rec->framePeriod;
+  numFrames = cap_align_num_frames(align, board);
+  if (((numFrames > 0) || (rec->flags & CAP_ALIGN_STOPPED)) && (frame >= numFrames)) return -1;
+  if (skew != NULL) *skew = (int64_t)(start + (uint64_t)frame * rec->framePeriod - time);
+  return frame;
+}
+
+
+/**
+ * @brief Frames of two boards triggered at the same time
+ *
+ * Each frame of board A, from firstFrame, is paired with the frame of board
+ * B triggered closest to it, when they are at most tolerance apart. With
+ * different frame periods, a frame of the slower board may be paired more
+ * than once.
+ *
+ * @param align Alignment index
+ * @param boardA Board index of the first frames
+ * @param boardB Board index of the second frames
+ * @param tolerance Maximum trigger time difference (ns, 0: half the shorter
+ *    frame period)
+ * @param firstFrame First frame of board A
+ * @param pairs Pairs of frames
+ * @param maxPairs Maximum number of pairs
+ * @return uint32_t Number of pairs
+ */
+uint32_t cap_align_pairs(const capAlign_t *align, uint8_t boardA, uint8_t boardB,
+                         uint64_t tolerance, uint32_t firstFrame,
+                         capAlignPair_t *pairs, uint32_t maxPairs) {
+  uint32_t numFrames, count = 0;
+  uint64_t periodA, periodB, firstB;
+  int64_t frame, skew;
+
+  if ((boardA >= CAP_ALIGN_MAX_BOARDS) || (boardB >= CAP_ALIGN_MAX_BOARDS) ||
+      !(align->boardMap & (1U << boardA)) || !(align->boardMap & (1U << boardB))) {
+    return 0;
+  }
+  periodA = align->boards[boardA].framePeriod;
+  periodB = align->boards[boardB].framePeriod;
+  if (tolerance == 0) tolerance = ((periodA < periodB) ? periodA : periodB) / 2;
+  numFrames = cap_align_num_frames(align, boardA);
+  firstB = cap_align_frame_time(align, boardB, 0);
+
+  for (uint32_t i = firstFrame; (count < maxPairs) && ((numFrames == 0) || (i < numFrames)); i++) {
+    uint64_t time = cap_align_frame_time(align, boardA, i);
+
+    frame = cap_align_frame_at(align, boardB, time, &skew);
+    if (frame < 0) {
+      // Board B stopped: no more pairs
+      if (time > firstB) break;
+      continue;
+    }
+    if ((uint64_t)llabs(skew) > tolerance) continue;
+    pairs[count].frameA = i;
+    pairs[count].frameB = (uint32_t)frame;
+    pairs[count].skew = skew;
+    count++;
+  }
+  return count;
+}
@@ -0,0 +1,179 @@
+/**
+ * @file align.h
+ * @brief Cross-board alignment index of the captures
+ * @version 0.1
+ * @date 2026-10-14
+ *
+ * @copyright Copyright (c) 2026
+ *
+ * The boards of a multi-cascade session record independently, each one on
+ * its own DSP board. The host processes driving them record the dispatch of
+ * the frame start and stop triggers of each device, in CLOCK_REALTIME and
+ * CLOCK_MONOTONIC time (common to the processes of the host), into an
+ * alignment index shared by the boards of the session, "<capture>.mmwalign"
+ * next to the local copies of the capture:
+ *
+ *    | header (256 B) | board 0 (320 B) | board 1 | ... |
+ *
+ * Each board process writes its own record only, at the offset of its board
+ * index, so no locking is needed between the processes.
+ *
+ * The master of a cascade generates the frames: frame n of a board is
+ * triggered framePeriod * n after the start dispatch of its master. The
+ * frame start event of the master bounds the latency of the trigger. Frames
+ * of two boards are paired from these times only, in O(1) per frame,
+ * without reading the captures; the frame numbers are the ones of the raw
+ * binaries and of the containers (cap.h) of each board.
+ *
+ * The boards started at the same barrier share its release time (session
+ * time): the records of an older session found in the file are ignored.
+ *
+ * All the fields are little endian.
+ */
+#ifndef MMWAVE_CAP_ALIGN_H
+#define MMWAVE_CAP_ALIGN_H
+
+#include <stdint.h>
+#include "cap.h"
+
+/* Alignment index identification ("MMWA") */
+#define CAP_ALIGN_MAGIC         (0x41574D4DU)
+
+/* Alignment index format version */
+#define CAP_ALIGN_VERSION       (1U)
+
+/* Maximum number of boards of a session */
+#define CAP_ALIGN_MAX_BOARDS    (8U)
+
+/* Extension of the alignment index files */
+#define CAP_ALIGN_EXTENSION     ".mmwalign"
+
+/* Board record flags */
+#define CAP_ALIGN_STARTED       (0x1U)
+#define CAP_ALIGN_STOPPED       (0x2U)
+
+
+/** Alignment index header */
+typedef struct capAlignHeader {
+
+  // CAP_ALIGN_MAGIC
+  uint32_t magic;
+
+  // CAP_ALIGN_VERSION
+  uint16_t version;
+
+  // Size of this structure and of a board record
+  uint16_t headerSize;
+  uint16_t boardSize;
+
+  // Number of boards of the session
+  uint8_t numBoards;
+
+  uint8_t reserved0;
+
+  // Name of the capture directory
+  char captureDir[64];
+
+  uint8_t reserved[180];
+
+} capAlignHeader_t;
+
+_Static_assert(sizeof(capAlignHeader_t) == 256, "capAlignHeader_t must stay 256 bytes");
+
+
+/** Frame triggers of a board */
+typedef struct capAlignBoard {
+
+  // IP address of the DSP board
+  char ipAddr[32];
+
+  // Release of the start barrier between the boards (CLOCK_REALTIME, ns)
+  uint64_t sessionTime;
+
+  // Frame period (ns)
+  uint64_t framePeriod;
+
+  // Number of frames of the frame config (0: until stopped)
+  uint32_t numFrames;
+
+  // Devices of the board (1: Master, 2: Slave1, 4: Slave2, 8: Slave3)
+  uint8_t deviceMap;
+
+  // Index of the board in the session
+  uint8_t boardIndex;
+
+  // CAP_ALIGN_STARTED, CAP_ALIGN_STOPPED
+  uint8_t flags;
+
+  uint8_t reserved0;
+
+  // Dispatch of the frame start trigger of each device (CLOCK_REALTIME and
+  // CLOCK_MONOTONIC, ns)
+  uint64_t startTime[CAP_MAX_DEVICES];
+  uint64_t startMono[CAP_MAX_DEVICES];
+
+  // Frame start event of each device (CLOCK_REALTIME, ns)
+  uint64_t startEvent[CAP_MAX_DEVICES];
+
+  // Dispatch of the frame stop trigger of each device (CLOCK_REALTIME and
+  // CLOCK_MONOTONIC, ns)
+  uint64_t stopTime[CAP_MAX_DEVICES];
+  uint64_t stopMono[CAP_MAX_DEVICES];
+
+  // Frame end event of each device (CLOCK_REALTIME, ns)
+  uint64_t stopEvent[CAP_MAX_DEVICES];
+
+  uint8_t reserved[72];
+
+} capAlignBoard_t;
+
+_Static_assert(sizeof(capAlignBoard_t) == 320, "capAlignBoard_t must stay 320 bytes");
+
+
+/** Alignment index of a session */
+typedef struct capAlign {
+
+  capAlignHeader_t header;
+  capAlignBoard_t boards[CAP_ALIGN_MAX_BOARDS];
+
+  // Boards of the session with a start record (bit n: board n)
+  uint8_t boardMap;
+
+} capAlign_t;
+
+
+/** Frames of two boards triggered at the same time */
+typedef struct capAlignPair {
+
+  uint32_t frameA;
+  uint32_t frameB;
+
+  // Trigger time of frameB minus the one of frameA (ns)
+  int64_t skew;
+
+} capAlignPair_t;
+
+
+/* Write the record of a board */
+int32_t cap_align_write(const char *path, const char *captureDir, uint8_t numBoards,
+                        const capAlignBoard_t *board);
+
+/* Read an alignment index */
+int32_t cap_align_load(capAlign_t *align, const char *path);
+
+/* Number of frames triggered on a board */
+uint32_t cap_align_num_frames(const capAlign_t *align, uint8_t board);
+
+/* Trigger time of a frame of a board (CLOCK_REALTIME, ns) */
+uint64_t cap_align_frame_time(const capAlign_t *align, uint8_t board, uint32_t frame);
+
+/* Frame of a board triggered closest to a time */
+int64_t cap_align_frame_at(const capAlign_t *align, uint8_t board, uint64_t time,
+                           int64_t *skew);
+
+/* Frames of two boards triggered at the same time */
+uint32_t cap_align_pairs(const capAlign_t *align, uint8_t boardA, uint8_t boardB,
+                         uint64_t tolerance, uint32_t firstFrame,
+                         capAlignPair_t *pairs, uint32_t maxPairs);
+
+#endif
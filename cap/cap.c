@@ -0,0 +1,615 @@
+/**
+ * @file cap.c
+ * @brief Indexed capture container
+ * @version 0.1
+ * @date 2026-10-14
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <pthread.h>
+#include <sys/stat.h>
+#include "cap.h"
+
+/* Name of the raw binaries of each device recorded by the TDA */
+static const char *cap_device_name[CAP_MAX_DEVICES] = {
+  "master", "slave1", "slave2", "slave3"
+};
+
+/* Number of frames coded at once */
+#define CAP_CODEC_BATCH         (32U)
+
+
+/** Raw data of a device, possibly split over several files */
+typedef struct capSource {
+
+  // Capture directory
+  const char *dir;
+
+  // Device ID
+  uint8_t devId;
+
+  // Current file
+  int fd;
+  uint32_t segment;
+
+  // Total size of the files
+  uint64_t size;
+
+} capSource_t;
+
+
+/**
+ * @brief Path of a raw binary
+ *
+ * @param buffer Buffer to store the path
+ * @param size Size of the buffer
+ * @param dir Capture directory
+ * @param devId Device ID
+ * @param segment File number
+ */
+void cap_segment_path(char *buffer, size_t size, const char *dir,
+                      uint8_t devId, uint32_t segment) {
+  snprintf(buffer, size, "%s/%s_%04u_data.bin", dir, cap_device_name[devId], segment);
+}
+
+
+/**
+ * @brief Open the raw data of a device
+ *
+ * @param src Source to open
+ * @param dir Capture directory
+ * @param devId Device ID
+ * @param mtime Updated with the latest modification time of the files (ns)
+ * @return int32_t 0 on success, -1 if the device has no data
+ */
+static int32_t cap_source_open(capSource_t *src, const char *dir, uint8_t devId, uint64_t *mtime) {
+  char path[512];
+  struct stat st;
+  uint64_t t;
+
+  memset(src, 0, sizeof(capSource_t));
+  src->dir = dir;
+  src->devId = devId;
+  for (uint32_t i = 0; i < CAP_MAX_SEGMENTS; i++) {
+    cap_segment_path(path, sizeof(path), dir, devId, i);
+    if (stat(path, &st) != 0) break;
+    src->size += st.st_size;
+    t = (uint64_t)st.st_mtim.tv_sec * 1000000000ULL + st.st_mtim.tv_nsec;
+    if (t > *mtime) *mtime = t;
+  }
+
+  cap_segment_path(path, sizeof(path), dir, devId, 0);
+  src->fd = open(path, O_RDONLY);
+  if (src->fd < 0) return -1;
+  posix_fadvise(src->fd, 0, 0, POSIX_FADV_SEQUENTIAL);
+  return 0;
+}
+
+
+/**
+ * @brief Read the next bytes of the raw data of a device
+ *
+ * @param src Source
+ * @param buffer Destination
+ * @param length Number of bytes
+ * @return int32_t 0 on success, -1 on failure
+ */
+static int32_t cap_source_read(capSource_t *src, uint8_t *buffer, uint32_t length) {
+  char path[512];
+  ssize_t n;
+
+  while (length > 0) {
+    n = read(src->fd, buffer, length);
+    if ((n < 0) && (errno == EINTR)) continue;
+    if (n < 0) return -1;
+    if (n == 0) {
+      // End of this file: continue with the next one
+      close(src->fd);
+      cap_segment_path(path, sizeof(path), src->dir, src->devId, ++src->segment);
+      src->fd = open(path, O_RDONLY);
+      if (src->fd < 0) return -1;
+      posix_fadvise(src->fd, 0, 0, POSIX_FADV_SEQUENTIAL);
+      continue;
+    }
+    buffer += n;
+    length -= n;
+  }
+  return 0;
+}
+
+
+/** Coding of a range of device blocks */
+typedef struct capEncodeJob {
+
+  const capCodecLayout_t *layout;
+
+  // Blocks as recorded, and coded blocks (of cap_codec_bound bytes each)
+  const uint8_t *raw;
+  size_t rawStride;
+  uint8_t *out;
+  size_t outStride;
+
+  // Size of each coded block
+  size_t *lengths;
+
+  // Blocks of the job
+  uint32_t first;
+  uint32_t count;
+
+  int32_t status;
+
+} capEncodeJob_t;
+
+
+/**
+ * @brief Codec geometry of the blocks of a container
+ *
+ * @param header Container header
+ * @param layout Geometry to fill
+ */
+static void cap_codec_layout(const capHeader_t *header, capCodecLayout_t *layout) {
+  memset(layout, 0, sizeof(capCodecLayout_t));
+  layout->codec = header->codec;
+  layout->packed12 = header->packing;
+  layout->chInterleave = header->chInterleave;
+  layout->width = header->width;
+  layout->height = header->height;
+  layout->numAdcSamples = header->numAdcSamples;
+  layout->numRx = header->numRx;
+  layout->valsPerSample = header->valsPerSample;
+}
+
+
+/**
+ * @brief Worker: code a range of device blocks
+ *
+ * @param arg Job
+ * @return void* NULL
+ */
+static void* cap_encode_worker(void *arg) {
+  capEncodeJob_t *job = (capEncodeJob_t *)arg;
+  int16_t *scratch = NULL;
+
+  if (job->layout->packed12) {
+    scratch = malloc((size_t)job->layout->width * job->layout->height * sizeof(int16_t));
+    if (scratch == NULL) return NULL;
+  }
+  for (uint32_t i = job->first; i < job->first + job->count; i++) {
+    job->lengths[i] = cap_encode(job->layout, job->raw + i * job->rawStride,
+      job->out + i * job->outStride, scratch);
+  }
+  free(scratch);
+  job->status = 0;
+  return NULL;
+}
+
+
+/**
+ * @brief Code device blocks over several threads
+ *
+ * @param job Template of the jobs (layout, buffers)
+ * @param numBlocks Number of blocks
+ * @param threads Number of threads
+ * @return int32_t 0 on success, -1 on failure
+ */
+static int32_t cap_encode_run(const capEncodeJob_t *job, uint32_t numBlocks, uint8_t threads) {
+  capEncodeJob_t jobs[CAP_MAX_THREADS];
+  pthread_t tids[CAP_MAX_THREADS];
+  uint32_t first = 0;
+  int32_t status = 0;
+  uint8_t started = 0;
+
+  if (threads > numBlocks) threads = (numBlocks > 0) ? numBlocks : 1;
+  for (uint8_t t = 0; t < threads; t++) {
+    jobs[t] = *job;
+    jobs[t].first = first;
+    jobs[t].count = numBlocks / threads + ((t < numBlocks % threads) ? 1 : 0);
+    jobs[t].status = -1;
+    first += jobs[t].count;
+  }
+
+  // The calling thread takes the first share
+  for (uint8_t t = 1; t < threads; t++) {
+    if (pthread_create(&tids[t], NULL, cap_encode_worker, &jobs[t]) != 0) break;
+    started = t;
+  }
+  cap_encode_worker(&jobs[0]);
+  for (uint8_t t = 1; t <= started; t++) pthread_join(tids[t], NULL);
+  // Shares of the threads that could not be started
+  for (uint8_t t = started + 1; t < threads; t++) cap_encode_worker(&jobs[t]);
+
+  for (uint8_t t = 0; t < threads; t++) {
+    if (jobs[t].status != 0) status = -1;
+  }
+  return status;
+}
+
+
+/**
+ * @brief Write a buffer at a given offset
+ *
+ * @param fd File descriptor
+ * @param buffer Data
+ * @param length Number of bytes
+ * @param offset Offset in the file
+ * @return int32_t 0 on success, -1 on failure
+ */
+static int32_t cap_pwrite(int fd, const void *buffer, size_t length, uint64_t offset) {
+  const uint8_t *p = (const uint8_t *)buffer;
+  ssize_t n;
+
+  while (length > 0) {
+    n = pwrite(fd, p, length, offset);
+    if ((n < 0) && (errno == EINTR)) continue;
+    if (n <= 0) return -1;
+    p += n;
+    length -= n;
+    offset += n;
+  }
+  return 0;
+}
+
+
+/**
+ * @brief Pack the raw binaries of a local capture directory into a container
+ *
+ * The container is written to "<outPath>.part" and renamed once complete.
+ * The caller fills the configuration fields of the header (device map,
+ * frame geometry, profile, codec...); the layout fields are filled here.
+ * The number of frames is the number of complete frames of the device that
+ * recorded the least. The raw binaries do not hold any timing information:
+ * the frame timestamps are derived from the frame periodicity. Coded
+ * blocks are coded by batches of frames spread over several threads.
+ *
+ * @param captureDir Local copy of the capture directory
+ * @param outPath Container file to create
+ * @param header Container header
+ * @param threads Number of threads coding the blocks (0: one per CPU)
+ * @return int32_t 0 on success, -1 on failure
+ */
+int32_t cap_pack(const char *captureDir, const char *outPath, capHeader_t *header,
+                 uint8_t threads) {
+  capSource_t sources[CAP_MAX_DEVICES];
+  capIndexEntry_t *index = NULL;
+  capCodecLayout_t layout;
+  capEncodeJob_t job;
+  uint8_t *block = NULL, *coded = NULL;
+  size_t *lengths = NULL;
+  char partPath[512];
+  uint64_t numFrames = UINT32_MAX;
+  uint64_t offset, period;
+  uint32_t numBlocks, batch, k;
+  int32_t status = -1;
+  int fd = -1;
+
+  if ((header->blockSize == 0) || ((header->deviceMap & 0xF) == 0) ||
+      (header->codec > CAP_CODEC_RICE)) {
+    return -1;
+  }
+  if (threads == 0) {
+    long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+    threads = (cpus > 0) ? (uint8_t)((cpus < CAP_MAX_THREADS) ? cpus : CAP_MAX_THREADS) : 1;
+  }
+  if (threads > CAP_MAX_THREADS) threads = CAP_MAX_THREADS;
+
+  for (uint8_t devId = 0; devId < CAP_MAX_DEVICES; devId++) sources[devId].fd = -1;
+  header->numDevices = 0;
+  header->recordedOn = 0;
+  for (uint8_t devId = 0; devId < CAP_MAX_DEVICES; devId++) {
+    if ((header->deviceMap & (1U << devId)) == 0) continue;
+    if (cap_source_open(&sources[devId], captureDir, devId, &header->recordedOn) != 0) {
+      fprintf(stderr, "[CAPTURE] %s: no data for the %s device\n", captureDir, cap_device_name[devId]);
+      goto done;
+    }
+    if (sources[devId].size / header->blockSize < numFrames) {
+      numFrames = sources[devId].size / header->blockSize;
+    }
+    header->numDevices++;
+  }
+  if (numFrames == 0) {
+    fprintf(stderr, "[CAPTURE] %s: no complete frame\n", captureDir);
+    goto done;
+  }
+
+  header->magic = 0;
+  header->version = CAP_VERSION;
+  header->headerSize = sizeof(capHeader_t);
+  header->numFrames = (uint32_t)numFrames;
+  header->dataOffset = CAP_BLOCK_ALIGN;
+  numBlocks = header->numFrames * header->numDevices;
+  if (header->codec == CAP_CODEC_NONE) {
+    header->blockStride = (header->blockSize + CAP_BLOCK_ALIGN - 1) & ~(CAP_BLOCK_ALIGN - 1);
+    header->indexOffset = header->dataOffset + (uint64_t)numBlocks * header->blockStride;
+    batch = 1;
+  } else {
+    // Block sizes, and so the index offset, known once coded
+    header->blockStride = 0;
+    batch = CAP_CODEC_BATCH;
+  }
+
+  index = calloc(numBlocks, sizeof(capIndexEntry_t));
+  block = calloc((size_t)batch * header->numDevices,
+    (header->codec == CAP_CODEC_NONE) ? header->blockStride : header->blockSize);
+  if ((index == NULL) || (block == NULL)) goto done;
+  if (header->codec != CAP_CODEC_NONE) {
+    cap_codec_layout(header, &layout);
+    memset(&job, 0, sizeof(job));
+    job.layout = &layout;
+    job.raw = block;
+    job.rawStride = header->blockSize;
+    job.outStride = cap_codec_bound(&layout);
+    coded = malloc((size_t)batch * header->numDevices * job.outStride);
+    lengths = calloc((size_t)batch * header->numDevices, sizeof(size_t));
+    if ((coded == NULL) || (lengths == NULL)) goto done;
+    job.out = coded;
+    job.lengths = lengths;
+  }
+
+  snprintf(partPath, sizeof(partPath), "%s.part", outPath);
+  fd = open(partPath, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+  if (fd < 0) {
+    fprintf(stderr, "[CAPTURE] Couldn't create %s: %s\n", partPath, strerror(errno));
+    goto done;
+  }
+  if ((header->codec == CAP_CODEC_NONE) &&
+      (ftruncate(fd, header->indexOffset + (uint64_t)numBlocks * sizeof(capIndexEntry_t)) != 0)) {
+    goto done;
+  }
+
+  period = (uint64_t)header->framePeriodicity * 5U;
+  offset = header->dataOffset;
+  k = 0;
+  for (uint32_t frame = 0; frame < header->numFrames; frame += batch) {
+    uint32_t n = ((header->numFrames - frame) < batch) ? header->numFrames - frame : batch;
+
+    if (header->codec == CAP_CODEC_NONE) {
+      for (uint8_t devId = 0; devId < CAP_MAX_DEVICES; devId++) {
+        if ((header->deviceMap & (1U << devId)) == 0) continue;
+        if (cap_source_read(&sources[devId], block, header->blockSize) != 0) goto done;
+        // The padding up to the block stride stays zero
+        if (cap_pwrite(fd, block, header->blockStride, offset) != 0) goto done;
+        index[k].offset = offset;
+        index[k].timestamp = frame * period;
+        index[k].sequence = frame;
+        index[k].deviceId = devId;
+        offset += header->blockStride;
+        k++;
+      }
+      continue;
+    }
+
+    // A batch of frames, read in the order of the container, then coded
+    for (uint32_t i = 0, b = 0; i < n; i++) {
+      for (uint8_t devId = 0; devId < CAP_MAX_DEVICES; devId++) {
+        if ((header->deviceMap & (1U << devId)) == 0) continue;
+        if (cap_source_read(&sources[devId], block + (size_t)b++ * header->blockSize,
+                            header->blockSize) != 0) {
+          goto done;
+        }
+      }
+    }
+    if (cap_encode_run(&job, n * header->numDevices, threads) != 0) goto done;
+    for (uint32_t i = 0, b = 0; i < n; i++) {
+      for (uint8_t devId = 0; devId < CAP_MAX_DEVICES; devId++) {
+        if ((header->deviceMap & (1U << devId)) == 0) continue;
+        if (cap_pwrite(fd, coded + (size_t)b * job.outStride, lengths[b], offset) != 0) goto done;
+        index[k].offset = offset;
+        index[k].timestamp = (uint64_t)(frame + i) * period;
+        index[k].sequence = frame + i;
+        index[k].deviceId = devId;
+        offset += lengths[b++];
+        k++;
+      }
+    }
+  }
+  if (header->codec != CAP_CODEC_NONE) header->indexOffset = offset;
+
+  if (cap_pwrite(fd, index, (size_t)numBlocks * sizeof(capIndexEntry_t), header->indexOffset) != 0) {
+    goto done;
+  }
+  // Header last, so that an incomplete container is never mistaken for a valid one
+  if (fdatasync(fd) != 0) goto done;
+  header->magic = CAP_MAGIC;
+  if (cap_pwrite(fd, header, sizeof(capHeader_t), 0) != 0) goto done;
+  if (fdatasync(fd) != 0) goto done;
+  if (rename(partPath, outPath) != 0) goto done;
+  status = 0;
+
+done:
+  if (fd >= 0) {
+    close(fd);
+    if (status != 0) unlink(partPath);
+  }
+  for (uint8_t devId = 0; devId < CAP_MAX_DEVICES; devId++) {
+    if (sources[devId].fd >= 0) close(sources[devId].fd);
+  }
+  free(index);
+  free(block);
+  free(coded);
+  free(lengths);
+  return status;
+}
+
+
+/**
+ * @brief Map a container
+ *
+ * @param reader Reader to initialize
+ * @param path Container file
+ * @return int32_t 0 on success, -1 on failure or if the file is not a
+ *    complete container
+ */
+int32_t cap_open(capReader_t *reader, const char *path) {
+  const capHeader_t *header;
+  struct stat st;
+  int8_t slot = 0;
+  int fd;
+
+  memset(reader, 0, sizeof(capReader_t));
+  fd = open(path, O_RDONLY);
+  if (fd < 0) return -1;
+  if ((fstat(fd, &st) != 0) || ((size_t)st.st_size < CAP_BLOCK_ALIGN)) {
+    close(fd);
+    return -1;
+  }
+  reader->size = st.st_size;
+  reader->map = mmap(NULL, reader->size, PROT_READ, MAP_SHARED, fd, 0);
+  close(fd);
+  if (reader->map == MAP_FAILED) {
+    reader->map = NULL;
+    return -1;
+  }
+
+  header = (const capHeader_t *)reader->map;
+  if ((header->magic != CAP_MAGIC) ||
+      ((header->version != CAP_VERSION) && (header->version != 1U)) ||
+      (header->headerSize != sizeof(capHeader_t)) || (header->codec > CAP_CODEC_RICE) ||
+      (header->indexOffset + (uint64_t)header->numFrames * header->numDevices *
+        sizeof(capIndexEntry_t) > reader->size)) {
+    cap_close(reader);
+    return -1;
+  }
+  reader->header = header;
+  reader->index = (const capIndexEntry_t *)(reader->map + header->indexOffset);
+  for (uint8_t devId = 0; devId < CAP_MAX_DEVICES; devId++) {
+    reader->devSlot[devId] = ((header->deviceMap & (1U << devId)) != 0) ? slot++ : -1;
+  }
+  return 0;
+}
+
+
+/**
+ * @brief Unmap a container
+ *
+ * @param reader Reader
+ */
+void cap_close(capReader_t *reader) {
+  if (reader->map != NULL) munmap(reader->map, reader->size);
+  memset(reader, 0, sizeof(capReader_t));
+}
+
+
+/**
+ * @brief Index entry of a device block
+ *
+ * @param reader Reader
+ * @param frame Frame number
+ * @param devId Device ID
+ * @return const capIndexEntry_t* Entry, NULL if out of the container
+ */
+const capIndexEntry_t* cap_entry(const capReader_t *reader, uint32_t frame, uint8_t devId) {
+  if ((frame >= reader->header->numFrames) || (devId >= CAP_MAX_DEVICES) ||
+      (reader->devSlot[devId] < 0)) {
+    return NULL;
+  }
+  return &reader->index[(size_t)frame * reader->header->numDevices + reader->devSlot[devId]];
+}
+
+
+/**
+ * @brief ADC data of a device block
+ *
+ * The data is not copied: it stays valid until the container is closed.
+ * The values are as recorded (12-bit packed with the TDA data packing).
+ *
+ * @param reader Reader
+ * @param frame Frame number
+ * @param devId Device ID
+ * @return const int16_t* height x width values, NULL if out of the container
+ *    or if the blocks are coded
+ */
+const int16_t* cap_frame(const capReader_t *reader, uint32_t frame, uint8_t devId) {
+  const capIndexEntry_t *entry = cap_entry(reader, frame, devId);
+
+  if ((entry == NULL) || (reader->header->codec != CAP_CODEC_NONE)) return NULL;
+  return (const int16_t *)(reader->map + entry->offset);
+}
+
+
+/**
+ * @brief Copy of the ADC values of a device block, decoded and unpacked
+ *
+ * @param reader Reader
+ * @param frame Frame number
+ * @param devId Device ID
+ * @param out height x width values
+ * @return int32_t 0 on success, -1 if out of the container or if the block
+ *    is corrupted
+ */
+int32_t cap_frame_read(const capReader_t *reader, uint32_t frame, uint8_t devId, int16_t *out) {
+  const capHeader_t *header = reader->header;
+  const capIndexEntry_t *entry = cap_entry(reader, frame, devId);
+  const size_t numValues = (size_t)header->width * header->height;
+  capCodecLayout_t layout;
+  uint64_t end;
+
+  if (entry == NULL) return -1;
+  if (header->codec == CAP_CODEC_NONE) {
+    if ((entry->offset + header->blockSize > reader->size) ||
+        (header->blockSize < (header->packing ? numValues * 3 / 2 : numValues * sizeof(int16_t)))) {
+      return -1;
+    }
+    if (header->packing) {
+      cap_unpack12(reader->map + entry->offset, out, numValues);
+    } else {
+      memcpy(out, reader->map + entry->offset, numValues * sizeof(int16_t));
+    }
+    return 0;
+  }
+
+  // A coded block ends where the next one (or the index) starts
+  end = (entry + 1 < reader->index + (size_t)header->numFrames * header->numDevices) ?
+    entry[1].offset : header->indexOffset;
+  if ((end < entry->offset) || (end > reader->size)) return -1;
+  cap_codec_layout(header, &layout);
+  return cap_decode(&layout, reader->map + entry->offset, end - entry->offset, out);
+}
+
+
+/**
+ * @brief View of one RX channel of a device block
+ *
+ * Value v of sample s of chirp c is base[c * chirpStride + s * sampleStride + v].
+ *
+ * @param reader Reader
+ * @param frame Frame number
+ * @param devId Device ID
+ * @param rx RX channel (0 to numRx - 1)
+ * @param view View to fill
+ * @return int32_t 0 on success, -1 if out of the container, if the chirps
+ *    do not hold ADC data only, or if the block is coded or 12-bit packed
+ *    (read it with cap_frame_read)
+ */
+int32_t cap_rx_view(const capReader_t *reader, uint32_t frame, uint8_t devId,
+                    uint8_t rx, capRxView_t *view) {
+  const capHeader_t *header = reader->header;
+  const int16_t *data = cap_frame(reader, frame, devId);
+
+  // 12-bit packed values are not addressable in place
+  if ((data == NULL) || (header->packing != 0) || (rx >= header->numRx)) return -1;
+  if (header->width != (uint32_t)header->numAdcSamples * header->numRx * header->valsPerSample) {
+    return -1;
+  }
+  if (header->chInterleave) {
+    // [chirp][rx][sample][value]
+    view->base = data + (uint32_t)rx * header->numAdcSamples * header->valsPerSample;
+    view->sampleStride = header->valsPerSample;
+  } else {
+    // [chirp][sample][rx][value]
+    view->base = data + (uint32_t)rx * header->valsPerSample;
+    view->sampleStride = (uint32_t)header->numRx * header->valsPerSample;
+  }
+  view->numChirps = header->height;
+  view->numSamples = header->numAdcSamples;
+  view->valsPerSample = header->valsPerSample;
+  view->chirpStride = header->width;
+  return 0;
+}
@@ -0,0 +1,230 @@
+/**
+ * @file cap.h
+ * @brief Indexed capture container
+ * @version 0.1
+ * @date 2026-10-14
+ *
+ * @copyright Copyright (c) 2026
+ *
+ * The raw per-device binaries recorded by the TDA ("<device>_<nnnn>_data.bin")
+ * are packed into a single container file, meant to be memory mapped:
+ *
+ *    | header (4 KiB) | frame 0: dev blocks | frame 1: dev blocks | ... | index |
+ *
+ * The header is derived from the device configuration. Each frame holds one
+ * block per device of the device map, in increasing device order, each
+ * block aligned on CAP_BLOCK_ALIGN. The index at the end of the file holds
+ * one entry per block (offset, timestamp, device, sequence number), so that
+ * any frame of any device is located in O(1). The header is written last:
+ * an incomplete container has no valid magic.
+ *
+ * A device block holds the ADC data of a frame as laid out by the TDA:
+ * `height` chirps of `width` 16-bit values. With ADC data only, a chirp is
+ * made of `numAdcSamples` samples of `numRx` channels of `valsPerSample`
+ * values (I, Q for complex data). With the 12-bit TDA data packing, the
+ * values are packed by pairs into 3 bytes (blockSize is then 3/4 of the
+ * 16-bit size).
+ *
+ * The device blocks can be compressed with a lossless codec (see
+ * cap/codec.h): each block is then stored coded, back to back without
+ * alignment, and its size is the distance to the next block in the file
+ * (the index for the last one). Such blocks are read with cap_frame_read.
+ *
+ * All the fields are little endian.
+ */
+#ifndef MMWAVE_CAP_H
+#define MMWAVE_CAP_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include "codec.h"
+
+/* Container identification ("MMWC") */
+#define CAP_MAGIC               (0x43574D4DU)
+
+/* Container format version (version 1 containers are read as uncompressed) */
+#define CAP_VERSION             (2U)
+
+/* Alignment of the header and of the device blocks */
+#define CAP_BLOCK_ALIGN         (4096U)
+
+/* Maximum number of devices in a container */
+#define CAP_MAX_DEVICES         (4U)
+
+/* Maximum number of raw binaries per device */
+#define CAP_MAX_SEGMENTS        (10000U)
+
+/* Maximum number of threads coding or checking the blocks */
+#define CAP_MAX_THREADS         (16U)
+
+/* Extension of the container files */
+#define CAP_FILE_EXTENSION      ".mmwcap"
+
+
+/** Container header */
+typedef struct capHeader {
+
+  // CAP_MAGIC
+  uint32_t magic;
+
+  // CAP_VERSION
+  uint16_t version;
+
+  // Size of this structure
+  uint16_t headerSize;
+
+  // Offset of the first device block
+  uint64_t dataOffset;
+
+  // Offset of the frame index
+  uint64_t indexOffset;
+
+  // Modification time of the raw data, i.e. end of the recording (ns)
+  uint64_t recordedOn;
+
+  // Number of frames
+  uint32_t numFrames;
+
+  // Number of bytes of ADC data of a device block, as recorded
+  uint32_t blockSize;
+
+  // Distance between two device blocks (0 for coded blocks)
+  uint32_t blockStride;
+
+  // Number of 16-bit values per chirp
+  uint32_t width;
+
+  // Number of chirps per frame
+  uint32_t height;
+
+  // Devices in the container (1: Master, 2: Slave1, 4: Slave2, 8: Slave3)
+  uint8_t deviceMap;
+  uint8_t numDevices;
+
+  // Number of RX channels per device
+  uint8_t numRx;
+
+  // 2: complex (I, Q) samples, 1: real samples
+  uint8_t valsPerSample;
+
+  // Profile/frame/channel configuration
+  uint16_t numAdcSamples;
+  uint16_t rxChannelEn;
+  uint16_t txChannelEn;
+  uint16_t numLoops;
+  uint16_t chirpStartIdx;
+  uint16_t chirpEndIdx;
+  uint32_t framePeriodicity;    // 1 LSB = 5 ns
+  uint32_t startFreqConst;      // 1 LSB = 53.644 Hz
+  int16_t freqSlopeConst;       // 1 LSB = 48.279 kHz/us
+  uint16_t digOutSampleRate;    // ksps
+  uint32_t idleTimeConst;       // 1 LSB = 10 ns
+  uint32_t adcStartTimeConst;   // 1 LSB = 10 ns
+  uint32_t rampEndTime;         // 1 LSB = 10 ns
+  uint8_t adcBits;
+  uint8_t adcFmt;
+  uint8_t rxGain;
+  uint8_t reserved0;
+
+  // Name of the capture directory
+  char captureDir[64];
+
+  // Codec of the device blocks (CAP_CODEC_*)
+  uint8_t codec;
+
+  // 1: 12-bit packed values (rlTdaArmCfg_t.dataPacking)
+  uint8_t packing;
+
+  // 1: non-interleaved RX channels (rlDevDataFmtCfg_t.chInterleave)
+  uint8_t chInterleave;
+
+  uint8_t reserved[93];
+
+} capHeader_t;
+
+_Static_assert(sizeof(capHeader_t) == 256, "capHeader_t must stay 256 bytes");
+
+
+/** Frame index entry (one per device block) */
+typedef struct capIndexEntry {
+
+  // Offset of the device block in the container
+  uint64_t offset;
+
+  // Time since the first frame (ns)
+  uint64_t timestamp;
+
+  // Frame sequence number
+  uint32_t sequence;
+
+  // Device the block belongs to (0: master, 1: slave1, 2: slave2, 3: slave3)
+  uint8_t deviceId;
+
+  uint8_t reserved[3];
+
+} capIndexEntry_t;
+
+_Static_assert(sizeof(capIndexEntry_t) == 24, "capIndexEntry_t must stay 24 bytes");
+
+
+/** Memory mapped container */
+typedef struct capReader {
+
+  // Mapping of the whole file
+  uint8_t *map;
+  size_t size;
+
+  const capHeader_t *header;
+  const capIndexEntry_t *index;
+
+  // Position of each device in a frame (-1: not in the container)
+  int8_t devSlot[CAP_MAX_DEVICES];
+
+} capReader_t;
+
+
+/** Zero-copy view of one RX channel of a device block */
+typedef struct capRxView {
+
+  // First value of the first sample of the first chirp
+  const int16_t *base;
+
+  uint32_t numChirps;
+  uint32_t numSamples;
+  uint8_t valsPerSample;
+
+  // Distances (in 16-bit values) between two samples and two chirps
+  uint32_t sampleStride;
+  uint32_t chirpStride;
+
+} capRxView_t;
+
+
+/* Path of a raw binary of a device */
+void cap_segment_path(char *buffer, size_t size, const char *dir,
+                      uint8_t devId, uint32_t segment);
+
+/* Pack the raw binaries of a local capture directory into a container */
+int32_t cap_pack(const char *captureDir, const char *outPath, capHeader_t *header,
+                 uint8_t threads);
+
+/* Map a container */
+int32_t cap_open(capReader_t *reader, const char *path);
+
+/* Unmap a container */
+void cap_close(capReader_t *reader);
+
+/* Index entry of a device block */
+const capIndexEntry_t* cap_entry(const capReader_t *reader, uint32_t frame, uint8_t devId);
+
+/* ADC data of a device block, as recorded (NULL for coded blocks) */
+const int16_t* cap_frame(const capReader_t *reader, uint32_t frame, uint8_t devId);
+
+/* Copy of the ADC values of a device block, decoded and unpacked */
+int32_t cap_frame_read(const capReader_t *reader, uint32_t frame, uint8_t devId, int16_t *out);
+
+/* View of one RX channel of an uncoded 16-bit device block */
+int32_t cap_rx_view(const capReader_t *reader, uint32_t frame, uint8_t devId,
+                    uint8_t rx, capRxView_t *view);
+
+#endif
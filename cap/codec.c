@@ -0,0 +1,375 @@
+/**
+ * @file codec.c
+ * @brief Lossless codec of the ADC blocks of a capture container
+ * @version 0.1
+ * @date 2026-10-14
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+#include <string.h>
+#include "codec.h"
+
+
+/** Stream of a block: the values base + chirp * width + sample * step */
+typedef struct capStream {
+  uint32_t base;
+  uint32_t step;
+  uint32_t numSamples;
+} capStream_t;
+
+
+/** Bit writer */
+typedef struct capBitWriter {
+  uint8_t *p;
+  uint64_t acc;
+  uint32_t bits;
+} capBitWriter_t;
+
+
+/** Bit reader of a byte aligned section */
+typedef struct capBitReader {
+  const uint8_t *p;
+  const uint8_t *end;
+  uint64_t acc;
+  uint32_t bits;
+} capBitReader_t;
+
+
+/**
+ * @brief Streams of a block
+ *
+ * @param layout Geometry of the blocks
+ * @param streams Streams to fill
+ * @return uint32_t Number of streams
+ */
+static uint32_t cap_streams(const capCodecLayout_t *layout, capStream_t *streams) {
+  const uint32_t ns = layout->numAdcSamples, nrx = layout->numRx, vps = layout->valsPerSample;
+  uint32_t count = 0;
+
+  if ((ns == 0) || (nrx * vps == 0) || (nrx * vps > CAP_CODEC_MAX_STREAMS) ||
+      (layout->width != ns * nrx * vps)) {
+    streams[0].base = 0;
+    streams[0].step = 1;
+    streams[0].numSamples = layout->width;
+    return 1;
+  }
+  for (uint32_t rx = 0; rx < nrx; rx++) {
+    for (uint32_t v = 0; v < vps; v++, count++) {
+      streams[count].base = (layout->chInterleave ? rx * ns * vps : rx * vps) + v;
+      streams[count].step = layout->chInterleave ? vps : nrx * vps;
+      streams[count].numSamples = ns;
+    }
+  }
+  return count;
+}
+
+
+static void cap_bits_put(capBitWriter_t *w, uint32_t value, uint32_t n) {
+  w->acc |= (uint64_t)value << w->bits;
+  w->bits += n;
+  while (w->bits >= 8) {
+    *w->p++ = (uint8_t)w->acc;
+    w->acc >>= 8;
+    w->bits -= 8;
+  }
+}
+
+
+static void cap_bits_flush(capBitWriter_t *w) {
+  if (w->bits > 0) *w->p++ = (uint8_t)w->acc;
+  w->acc = 0;
+  w->bits = 0;
+}
+
+
+static void cap_bits_refill(capBitReader_t *r) {
+  while ((r->bits <= 56) && (r->p < r->end)) {
+    r->acc |= (uint64_t)*r->p++ << r->bits;
+    r->bits += 8;
+  }
+}
+
+
+static int32_t cap_bits_get(capBitReader_t *r, uint32_t n, uint32_t *value) {
+  cap_bits_refill(r);
+  if (r->bits < n) return -1;
+  *value = (uint32_t)(r->acc & ((1ULL << n) - 1));
+  r->acc >>= n;
+  r->bits -= n;
+  return 0;
+}
+
+
+static int32_t cap_bits_unary(capBitReader_t *r, uint32_t *value) {
+  uint32_t count = 0;
+
+  for (;;) {
+    cap_bits_refill(r);
+    if (r->bits == 0) return -1;
+    if (r->acc != 0) {
+      uint32_t zeros = __builtin_ctzll(r->acc);
+      *value = count + zeros;
+      r->acc = (zeros == 63) ? 0 : r->acc >> (zeros + 1);
+      r->bits -= zeros + 1;
+      return 0;
+    }
+    count += r->bits;
+    r->bits = 0;
+  }
+}
+
+
+/**
+ * @brief Code a group of zigzag mapped differences
+ *
+ * @param codec CAP_CODEC_DELTA or CAP_CODEC_RICE
+ * @param z Values
+ * @param n Number of values (1 to CAP_CODEC_GROUP)
+ * @param p Output
+ * @return uint8_t* End of the coded group
+ */
+static uint8_t* cap_group_encode(uint8_t codec, const uint16_t *z, uint32_t n, uint8_t *p) {
+  capBitWriter_t w;
+  uint32_t all = 0, width, mean, k = 0, quotients = 0;
+  uint64_t sum = 0;
+  size_t packed, best;
+
+  for (uint32_t i = 0; i < n; i++) {
+    all |= z[i];
+    sum += z[i];
+  }
+  width = (all != 0) ? 32 - __builtin_clz(all) : 0;
+  packed = (n * width + 7) / 8;
+  best = packed;
+
+  if ((codec == CAP_CODEC_RICE) && (width > 1)) {
+    // Parameters around log2 of the mean value
+    mean = (uint32_t)(sum / n);
+    uint32_t k0 = (mean != 0) ? 31 - __builtin_clz(mean) : 0;
+    for (uint32_t c = (k0 > 0) ? k0 - 1 : 0; (c <= k0 + 1) && (c < 16); c++) {
+      uint32_t q = n;
+      size_t size;
+      for (uint32_t i = 0; i < n; i++) q += z[i] >> c;
+      size = 3 + (q + 7) / 8 + (n * c + 7) / 8;
+      if ((size < best) && ((q + 7) / 8 <= 0xFFFF)) {
+        best = size;
+        k = c;
+        quotients = q;
+      }
+    }
+  }
+
+  w.acc = 0;
+  w.bits = 0;
+  if (best < packed) {
+    uint16_t unaryBytes = (uint16_t)((quotients + 7) / 8);
+    *p++ = 0x80 | k;
+    memcpy(p, &unaryBytes, sizeof(unaryBytes));
+    w.p = p + sizeof(unaryBytes);
+    for (uint32_t i = 0; i < n; i++) {
+      uint32_t q = z[i] >> k;
+      for (; q >= 16; q -= 16) cap_bits_put(&w, 0, 16);
+      cap_bits_put(&w, 1U << q, q + 1);
+    }
+    cap_bits_flush(&w);
+    for (uint32_t i = 0; (i < n) && (k > 0); i++) cap_bits_put(&w, z[i] & ((1U << k) - 1), k);
+    cap_bits_flush(&w);
+    return w.p;
+  }
+
+  *p++ = (uint8_t)width;
+  w.p = p;
+  for (uint32_t i = 0; (i < n) && (width > 0); i++) cap_bits_put(&w, z[i], width);
+  cap_bits_flush(&w);
+  return w.p;
+}
+
+
+/**
+ * @brief Decode a group
+ *
+ * @param p Coded group
+ * @param end End of the coded block
+ * @param z Values
+ * @param n Number of values
+ * @return const uint8_t* End of the coded group, NULL if invalid
+ */
+static const uint8_t* cap_group_decode(const uint8_t *p, const uint8_t *end, uint16_t *z,
+                                       uint32_t n) {
+  capBitReader_t r = { NULL, NULL, 0, 0 };
+  uint32_t mode, value;
+  size_t size;
+
+  if (p >= end) return NULL;
+  mode = *p++;
+
+  if (mode & 0x80) {
+    uint32_t k = mode & 0x1F;
+    uint16_t unaryBytes;
+
+    if ((k >= 16) || (end - p < (ptrdiff_t)sizeof(unaryBytes))) return NULL;
+    memcpy(&unaryBytes, p, sizeof(unaryBytes));
+    p += sizeof(unaryBytes);
+    size = (n * k + 7) / 8;
+    if ((size_t)(end - p) < unaryBytes + size) return NULL;
+
+    r.p = p;
+    r.end = p + unaryBytes;
+    for (uint32_t i = 0; i < n; i++) {
+      if ((cap_bits_unary(&r, &value) != 0) || (((uint64_t)value << k) > 0xFFFF)) return NULL;
+      z[i] = (uint16_t)(value << k);
+    }
+    p += unaryBytes;
+    r.p = p;
+    r.end = p + size;
+    r.acc = 0;
+    r.bits = 0;
+    for (uint32_t i = 0; (i < n) && (k > 0); i++) {
+      if (cap_bits_get(&r, k, &value) != 0) return NULL;
+      z[i] |= value;
+    }
+    return p + size;
+  }
+
+  if (mode > 16) return NULL;
+  size = (n * mode + 7) / 8;
+  if ((size_t)(end - p) < size) return NULL;
+  r.p = p;
+  r.end = p + size;
+  for (uint32_t i = 0; i < n; i++) {
+    if (mode == 0) {
+      z[i] = 0;
+    } else {
+      if (cap_bits_get(&r, mode, &value) != 0) return NULL;
+      z[i] = (uint16_t)value;
+    }
+  }
+  return p + size;
+}
+
+
+/**
+ * @brief Unpack 12-bit values packed by pairs
+ *
+ * Each pair of values is packed into 3 bytes, low bits first:
+ * v0 = b0 | (b1 & 0xF) << 8, v1 = b1 >> 4 | b2 << 4.
+ *
+ * @param in Packed values
+ * @param out 16-bit values
+ * @param count Number of values (even)
+ */
+void cap_unpack12(const uint8_t *in, int16_t *out, size_t count) {
+  for (size_t i = 0; i + 1 < count; i += 2, in += 3) {
+    uint16_t v0 = in[0] | ((in[1] & 0x0F) << 8);
+    uint16_t v1 = (in[1] >> 4) | (in[2] << 4);
+    // Sign extension of the 12-bit values
+    out[i] = (int16_t)(v0 << 4) >> 4;
+    out[i + 1] = (int16_t)(v1 << 4) >> 4;
+  }
+}
+
+
+/**
+ * @brief Maximum size of a coded block
+ *
+ * @param layout Geometry of the blocks
+ * @return size_t Number of bytes
+ */
+size_t cap_codec_bound(const capCodecLayout_t *layout) {
+  capStream_t streams[CAP_CODEC_MAX_STREAMS];
+  uint32_t count = cap_streams(layout, streams);
+  size_t values = (size_t)streams[0].numSamples * layout->height;
+  size_t groups = count * ((values + CAP_CODEC_GROUP - 1) / CAP_CODEC_GROUP);
+
+  return groups * (1 + CAP_CODEC_GROUP * sizeof(int16_t));
+}
+
+
+/**
+ * @brief Code a block as recorded
+ *
+ * @param layout Geometry of the blocks
+ * @param raw Block (width x height values, packed if packed12 is set)
+ * @param out Coded block, of at least cap_codec_bound bytes
+ * @param scratch width x height values, used when packed12 is set
+ * @return size_t Size of the coded block
+ */
+size_t cap_encode(const capCodecLayout_t *layout, const uint8_t *raw, uint8_t *out,
+                  int16_t *scratch) {
+  capStream_t streams[CAP_CODEC_MAX_STREAMS];
+  uint32_t count = cap_streams(layout, streams);
+  const int16_t *values = (const int16_t *)raw;
+  uint16_t z[CAP_CODEC_GROUP];
+  uint8_t *p = out;
+
+  if (layout->packed12) {
+    cap_unpack12(raw, scratch, (size_t)layout->width * layout->height);
+    values = scratch;
+  }
+
+  for (uint32_t s = 0; s < count; s++) {
+    const capStream_t *stream = &streams[s];
+    uint16_t prev = 0;
+    uint32_t n = 0;
+
+    for (uint32_t c = 0; c < layout->height; c++) {
+      const int16_t *chirp = values + (size_t)c * layout->width + stream->base;
+      for (uint32_t i = 0; i < stream->numSamples; i++) {
+        uint16_t x = (uint16_t)chirp[i * stream->step];
+        uint16_t d = (uint16_t)(x - prev);
+        prev = x;
+        z[n++] = (uint16_t)(d << 1) ^ ((d & 0x8000) ? 0xFFFF : 0);
+        if (n == CAP_CODEC_GROUP) {
+          p = cap_group_encode(layout->codec, z, n, p);
+          n = 0;
+        }
+      }
+    }
+    if (n > 0) p = cap_group_encode(layout->codec, z, n, p);
+  }
+  return p - out;
+}
+
+
+/**
+ * @brief Decode a block
+ *
+ * @param layout Geometry of the blocks
+ * @param in Coded block
+ * @param length Size of the coded block
+ * @param out width x height values (12-bit packed values are unpacked)
+ * @return int32_t 0 on success, -1 if the block is not a valid coded block
+ */
+int32_t cap_decode(const capCodecLayout_t *layout, const uint8_t *in, size_t length,
+                   int16_t *out) {
+  capStream_t streams[CAP_CODEC_MAX_STREAMS];
+  uint32_t count = cap_streams(layout, streams);
+  const uint8_t *p = in, *end = in + length;
+  uint16_t z[CAP_CODEC_GROUP];
+
+  for (uint32_t s = 0; s < count; s++) {
+    const capStream_t *stream = &streams[s];
+    uint16_t prev = 0;
+    uint32_t n = 0, k = 0;
+    size_t remaining = (size_t)stream->numSamples * layout->height;
+
+    for (uint32_t c = 0; c < layout->height; c++) {
+      int16_t *chirp = out + (size_t)c * layout->width + stream->base;
+      for (uint32_t i = 0; i < stream->numSamples; i++) {
+        if (k == n) {
+          n = (remaining < CAP_CODEC_GROUP) ? (uint32_t)remaining : CAP_CODEC_GROUP;
+          p = cap_group_decode(p, end, z, n);
+          if (p == NULL) return -1;
+          remaining -= n;
+          k = 0;
+        }
+        uint16_t d = (z[k] >> 1) ^ ((z[k] & 1) ? 0xFFFF : 0);
+        k++;
+        prev = (uint16_t)(prev + d);
+        chirp[i * stream->step] = (int16_t)prev;
+      }
+    }
+  }
+  return (p == end) ? 0 : -1;
+}
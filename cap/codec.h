@@ -0,0 +1,87 @@
+/**
+ * @file codec.h
+ * @brief Lossless codec of the ADC blocks of a capture container
+ * @version 0.1
+ * @date 2026-10-14
+ *
+ * @copyright Copyright (c) 2026
+ *
+ * A device block is split into one stream per RX channel and per value of
+ * a sample (I, Q for complex data), each stream holding the values of all
+ * the chirps of the frame in order. With 12-bit TDA data packing, the
+ * values are unpacked (and sign extended) first. Each value of a stream
+ * is replaced by its difference with the previous one (modulo 2^16, the
+ * first one with 0), zigzag mapped to an unsigned value:
+ *
+ *    z = (d << 1) ^ (d >> 15)
+ *
+ * and the streams are coded one after the other by groups of
+ * CAP_CODEC_GROUP values (the last group of a stream may be shorter).
+ * Each group starts with a mode byte:
+ *
+ *    0x00 + w   bit packing: the group values on w bits (0 to 16)
+ *    0x80 + k   Rice coding (CAP_CODEC_RICE only): a 16-bit byte count,
+ *               then for each value z >> k in unary (as many 0 bits, then
+ *               a 1 bit), padded to a byte, then the k low bits of each
+ *               value, padded to a byte
+ *
+ * The bits are written least significant first. When the chirps do not
+ * hold ADC data only, the block is coded as a single stream.
+ */
+#ifndef MMWAVE_CAP_CODEC_H
+#define MMWAVE_CAP_CODEC_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+/* Codec of the device blocks (capHeader_t.codec) */
+#define CAP_CODEC_NONE          (0U)  // Blocks as recorded
+#define CAP_CODEC_DELTA         (1U)  // Delta and bit packing
+#define CAP_CODEC_RICE          (2U)  // Delta, bit packing or Rice coding
+
+/* Number of values of a group */
+#define CAP_CODEC_GROUP         (128U)
+
+/* Maximum number of streams of a block (RX channels x values per sample) */
+#define CAP_CODEC_MAX_STREAMS   (8U)
+
+
+/** Geometry of the blocks to code */
+typedef struct capCodecLayout {
+
+  // CAP_CODEC_*
+  uint8_t codec;
+
+  // 1: 12-bit values packed by pairs into 3 bytes (rlTdaArmCfg_t.dataPacking)
+  uint8_t packed12;
+
+  // 1: non-interleaved RX channels (rlDevDataFmtCfg_t.chInterleave)
+  uint8_t chInterleave;
+
+  // Number of values per chirp and of chirps per block
+  uint32_t width;
+  uint32_t height;
+
+  // Chirp content, ignored if width is not numAdcSamples x numRx x valsPerSample
+  uint16_t numAdcSamples;
+  uint8_t numRx;
+  uint8_t valsPerSample;
+
+} capCodecLayout_t;
+
+
+/* Maximum size of a coded block */
+size_t cap_codec_bound(const capCodecLayout_t *layout);
+
+/* Code a block as recorded, returns the size of the coded block */
+size_t cap_encode(const capCodecLayout_t *layout, const uint8_t *raw, uint8_t *out,
+                  int16_t *scratch);
+
+/* Decode a block into width x height values */
+int32_t cap_decode(const capCodecLayout_t *layout, const uint8_t *in, size_t length,
+                   int16_t *out);
+
+/* Unpack 12-bit values packed by pairs */
+void cap_unpack12(const uint8_t *in, int16_t *out, size_t count);
+
+#endif
@@ -0,0 +1,385 @@
+/**
+ * @file verify.c
+ * @brief Frame integrity and write throughput check of the recorded captures
+ * @version 0.1
+ * @date 2026-10-14
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <time.h>
+#include <pthread.h>
+#include <sys/stat.h>
+#include "verify.h"
+#include "../ti/ethernet/src/mmwl_crc.h"
+
+/* Name of the devices in the reports */
+static const char *cap_verify_name[CAP_MAX_DEVICES] = {
+  "master", "slave1", "slave2", "slave3"
+};
+
+
+/** Raw binaries of a device */
+typedef struct capVerifySource {
+
+  // One descriptor per file, and the end offset of each file in the data
+  int *fds;
+  uint64_t *ends;
+  uint32_t count;
+
+  // Modification times of the first and last files (ns)
+  uint64_t firstTime;
+  uint64_t lastTime;
+
+  // CRC32 of each complete frame
+  uint32_t *crcs;
+
+} capVerifySource_t;
+
+
+/** Check of a range of frames of a device */
+typedef struct capVerifyJob {
+
+  const capVerifySource_t *src;
+  uint64_t blockSize;
+
+  // Frames of the job
+  uint32_t first;
+  uint32_t count;
+
+  int32_t status;
+
+} capVerifyJob_t;
+
+
+static uint64_t cap_verify_now() {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+
+/**
+ * @brief Open the raw binaries of a device
+ *
+ * @param src Source to open
+ * @param dir Capture directory
+ * @param devId Device ID
+ * @return int32_t 0 on success, -1 if the device has no data
+ */
+static int32_t cap_verify_open(capVerifySource_t *src, const char *dir, uint8_t devId) {
+  char path[512];
+  struct stat st;
+  uint64_t size = 0;
+  uint32_t count = 0;
+
+  memset(src, 0, sizeof(capVerifySource_t));
+  while (count < CAP_MAX_SEGMENTS) {
+    cap_segment_path(path, sizeof(path), dir, devId, count);
+    if (stat(path, &st) != 0) break;
+    count++;
+  }
+  if (count == 0) return -1;
+  src->fds = malloc(count * sizeof(int));
+  src->ends = malloc(count * sizeof(uint64_t));
+  if ((src->fds == NULL) || (src->ends == NULL)) return -1;
+
+  for (uint32_t i = 0; i < count; i++) {
+    uint64_t t;
+    cap_segment_path(path, sizeof(path), dir, devId, i);
+    src->fds[i] = open(path, O_RDONLY);
+    if ((src->fds[i] < 0) || (fstat(src->fds[i], &st) != 0)) {
+      if (src->fds[i] >= 0) close(src->fds[i]);
+      return -1;
+    }
+    src->count++;
+    posix_fadvise(src->fds[i], 0, 0, POSIX_FADV_SEQUENTIAL);
+    size += st.st_size;
+    src->ends[i] = size;
+    t = (uint64_t)st.st_mtim.tv_sec * 1000000000ULL + st.st_mtim.tv_nsec;
+    if (i == 0) src->firstTime = t;
+    src->lastTime = t;
+  }
+  return 0;
+}
+
+
+/**
+ * @brief Close the raw binaries of a device
+ *
+ * @param src Source to close
+ */
+static void cap_verify_close(capVerifySource_t *src) {
+  for (uint32_t i = 0; i < src->count; i++) close(src->fds[i]);
+  free(src->fds);
+  free(src->ends);
+  free(src->crcs);
+  memset(src, 0, sizeof(capVerifySource_t));
+}
+
+
+/**
+ * @brief Read bytes of the data of a device, across its files
+ *
+ * @param src Source
+ * @param offset Offset in the data of the device
+ * @param buffer Destination
+ * @param length Number of bytes
+ * @return int32_t 0 on success, -1 on failure
+ */
+static int32_t cap_verify_read(const capVerifySource_t *src, uint64_t offset,
+                               uint8_t *buffer, uint64_t length) {
+  uint32_t i = 0;
+  ssize_t n;
+
+  while ((i < src->count) && (src->ends[i] <= offset)) i++;
+  while (length > 0) {
+    uint64_t start = (i > 0) ? src->ends[i - 1] : 0;
+    uint64_t chunk;
+
+    if (i >= src->count) return -1;
+    chunk = src->ends[i] - offset;
+    if (chunk > length) chunk = length;
+    n = pread(src->fds[i], buffer, chunk, offset - start);
+    if ((n < 0) && (errno == EINTR)) continue;
+    if (n <= 0) return -1;
+    buffer += n;
+    offset += n;
+    length -= n;
+    if (offset == src->ends[i]) i++;
+  }
+  return 0;
+}
+
+
+/**
+ * @brief CRC32 of the frames of a job
+ *
+ * @param arg Job
+ * @return void* NULL
+ */
+static void* cap_verify_worker(void *arg) {
+  capVerifyJob_t *job = (capVerifyJob_t *)arg;
+  uint8_t *block = malloc(job->blockSize);
+
+  if (block == NULL) return NULL;
+  for (uint32_t f = job->first; f < job->first + job->count; f++) {
+    if (cap_verify_read(job->src, f * job->blockSize, block, job->blockSize) != 0) {
+      free(block);
+      return NULL;
+    }
+    job->src->crcs[f] = MMWL_crc32(block, (uint32_t)job->blockSize);
+  }
+  free(block);
+  job->status = 0;
+  return NULL;
+}
+
+
+/**
+ * @brief Count the frames identical to the previous one
+ *
+ * Frames with the same CRC32 as the previous one are compared byte per byte.
+ *
+ * @param src Source
+ * @param blockSize Size of a frame
+ * @param dev Result of the device
+ * @return int32_t 0 on success, -1 on a read error
+ */
+static int32_t cap_verify_duplicates(const capVerifySource_t *src, uint64_t blockSize,
+                                     capVerifyDevice_t *dev) {
+  uint8_t *prev = NULL, *block = NULL;
+  int32_t status = 0;
+
+  for (uint32_t f = 1; (f < dev->frames) && (status == 0); f++) {
+    if (src->crcs[f] != src->crcs[f - 1]) continue;
+    if (block == NULL) {
+      prev = malloc(blockSize);
+      block = malloc(blockSize);
+      if ((prev == NULL) || (block == NULL)) status = -1;
+    }
+    if ((status != 0) || (cap_verify_read(src, (f - 1) * blockSize, prev, blockSize) != 0) ||
+        (cap_verify_read(src, f * blockSize, block, blockSize) != 0)) {
+      status = -1;
+    } else if (memcmp(prev, block, blockSize) == 0) {
+      if (dev->duplicates++ == 0) dev->firstDuplicate = f;
+    }
+  }
+  free(prev);
+  free(block);
+  return status;
+}
+
+
+/**
+ * @brief Check the raw binaries of a capture directory
+ *
+ * The frames of each device are split into ranges read by up to `threads`
+ * threads, the calling thread taking the first one. Without an expected
+ * frame count, the devices are checked against the one that recorded the
+ * most frames.
+ *
+ * @param captureDir Capture directory
+ * @param cfg Expected content of the capture
+ * @param report Result of the check
+ * @return int32_t 0 if all the checks passed, -1 otherwise
+ */
+int32_t cap_verify(const char *captureDir, const capVerifyCfg_t *cfg, capVerifyReport_t *report) {
+  capVerifySource_t sources[CAP_MAX_DEVICES];
+  capVerifyJob_t jobs[CAP_MAX_THREADS];
+  pthread_t tids[CAP_MAX_THREADS];
+  uint64_t start = cap_verify_now();
+  uint32_t numJobs = 0, slack = 0, maxFrames = 0;
+  uint8_t numDevices = 0, threads = cfg->threads, started = 0;
+
+  memset(report, 0, sizeof(capVerifyReport_t));
+  report->deviceMap = cfg->deviceMap & 0xF;
+  if ((cfg->blockSize == 0) || (report->deviceMap == 0)) return -1;
+  if (cfg->framePeriod > 0) report->requiredRate = cfg->blockSize * 1e3 / cfg->framePeriod;
+  if (threads == 0) {
+    long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+    threads = (cpus > 0) ? (uint8_t)((cpus < CAP_MAX_THREADS) ? cpus : CAP_MAX_THREADS) : 1;
+  }
+  if (threads > CAP_MAX_THREADS) threads = CAP_MAX_THREADS;
+  numDevices = __builtin_popcount(report->deviceMap);
+
+  // Geometry of the data of each device, and one job per range of frames
+  for (uint8_t devId = 0; devId < CAP_MAX_DEVICES; devId++) {
+    capVerifyDevice_t *dev = &report->devices[devId];
+    uint32_t shares = (threads > numDevices) ? threads / numDevices : 1, first = 0;
+
+    memset(&sources[devId], 0, sizeof(capVerifySource_t));
+    if ((report->deviceMap & (1U << devId)) == 0) continue;
+    if (cap_verify_open(&sources[devId], captureDir, devId) != 0) {
+      dev->errors = -1;
+      continue;
+    }
+    dev->segments = sources[devId].count;
+    dev->bytes = sources[devId].ends[dev->segments - 1];
+    dev->frames = (uint32_t)(dev->bytes / cfg->blockSize);
+    dev->partialBytes = (uint32_t)(dev->bytes % cfg->blockSize);
+    sources[devId].crcs = malloc(((dev->frames > 0) ? dev->frames : 1) * sizeof(uint32_t));
+    if (sources[devId].crcs == NULL) {
+      dev->errors = -1;
+      continue;
+    }
+    if (dev->frames > maxFrames) maxFrames = dev->frames;
+    if (shares > dev->frames) shares = (dev->frames > 0) ? dev->frames : 1;
+    for (uint32_t s = 0; (s < shares) && (numJobs < CAP_MAX_THREADS); s++, numJobs++) {
+      jobs[numJobs].src = &sources[devId];
+      jobs[numJobs].blockSize = cfg->blockSize;
+      jobs[numJobs].first = first;
+      jobs[numJobs].count = dev->frames / shares + ((s < dev->frames % shares) ? 1 : 0);
+      jobs[numJobs].status = -1;
+      first += jobs[numJobs].count;
+    }
+  }
+
+  // CRC32 of every frame
+  for (uint32_t j = 1; j < numJobs; j++) {
+    if (pthread_create(&tids[j], NULL, cap_verify_worker, &jobs[j]) != 0) break;
+    started = j;
+  }
+  if (numJobs > 0) cap_verify_worker(&jobs[0]);
+  for (uint32_t j = 1; j <= started; j++) pthread_join(tids[j], NULL);
+  // Shares of the threads that could not be started
+  for (uint32_t j = started + 1; j < numJobs; j++) cap_verify_worker(&jobs[j]);
+  for (uint32_t j = 0; j < numJobs; j++) {
+    if (jobs[j].status != 0) report->devices[jobs[j].src - sources].errors = -1;
+  }
+
+  // Expected number of frames: the frame config, or the recording duration
+  if ((cfg->numFrames > 0) && ((cfg->duration == 0) || (cfg->framePeriod == 0) ||
+      (cfg->duration >= (uint64_t)cfg->numFrames * cfg->framePeriod))) {
+    report->expectedFrames = cfg->numFrames;
+  } else if ((cfg->duration > 0) && (cfg->framePeriod > 0)) {
+    report->expectedFrames = (uint32_t)(cfg->duration / cfg->framePeriod);
+    slack = CAP_VERIFY_SLACK;
+  }
+
+  for (uint8_t devId = 0; devId < CAP_MAX_DEVICES; devId++) {
+    capVerifyDevice_t *dev = &report->devices[devId];
+    uint32_t expected = (report->expectedFrames > 0) ? report->expectedFrames : maxFrames;
+    uint64_t bytes = dev->bytes;
+
+    if ((report->deviceMap & (1U << devId)) == 0) continue;
+    if ((dev->errors == 0) && (cap_verify_duplicates(&sources[devId], cfg->blockSize, dev) != 0)) {
+      dev->errors = -1;
+    }
+    if (dev->errors < 0) {
+      report->errors++;
+      cap_verify_close(&sources[devId]);
+      continue;
+    }
+    report->bytes += dev->bytes;
+
+    if (dev->frames + slack < expected) dev->missing = expected - dev->frames;
+    if (dev->frames > expected + slack) dev->extra = dev->frames - expected;
+
+    // Write throughput over the recording, or between the ends of the first and last files
+    dev->duration = cfg->duration;
+    if ((dev->duration == 0) && cfg->fileTimes && (dev->segments >= 2)) {
+      dev->duration = sources[devId].lastTime - sources[devId].firstTime;
+      bytes -= sources[devId].ends[0];
+    }
+    if (dev->duration > 0) dev->writeRate = bytes * 1e3 / dev->duration;
+
+    dev->errors = (dev->frames == 0) + (dev->partialBytes > 0) + (dev->missing > 0) + (dev->extra > 0) +
+      (dev->duplicates > 0) + ((dev->duration > 0) && (report->requiredRate > 0) &&
+      (dev->writeRate < report->requiredRate * CAP_VERIFY_RATE_MARGIN));
+    report->errors += dev->errors;
+    cap_verify_close(&sources[devId]);
+  }
+  report->elapsed = cap_verify_now() - start;
+  return (report->errors == 0) ? 0 : -1;
+}
+
+
+/**
+ * @brief Print the result of a check
+ *
+ * One line per device, then a summary line.
+ *
+ * @param report Result of the check
+ * @param prefix Prefix of each line (e.g. "[CAPTURE #3]")
+ */
+void cap_verify_print(const capVerifyReport_t *report, const char *prefix) {
+  for (uint8_t devId = 0; devId < CAP_MAX_DEVICES; devId++) {
+    const capVerifyDevice_t *dev = &report->devices[devId];
+    char rate[64] = "";
+
+    if ((report->deviceMap & (1U << devId)) == 0) continue;
+    if (dev->errors < 0) {
+      printf("%s %s: no data or read error\n", prefix, cap_verify_name[devId]);
+      continue;
+    }
+    if (dev->duration > 0) {
+      snprintf(rate, sizeof(rate), ", %.1f MB/s written (%.1f MB/s required)",
+        dev->writeRate, report->requiredRate);
+    }
+    printf("%s %s: %u frames", prefix, cap_verify_name[devId], dev->frames);
+    if (report->expectedFrames > 0) printf(" (%u expected)", report->expectedFrames);
+    printf(" in %u files, %.1f MB%s", dev->segments, dev->bytes / 1e6, rate);
+    if (dev->frames == 0) printf(", no complete frame");
+    if (dev->partialBytes > 0) printf(", partial last frame of %u bytes", dev->partialBytes);
+    if (dev->missing > 0) printf(", %u missing", dev->missing);
+    if (dev->extra > 0) printf(", %u extra", dev->extra);
+    if (dev->duplicates > 0) {
+      printf(", %u duplicated (first: frame %u)", dev->duplicates, dev->firstDuplicate);
+    }
+    if ((dev->duration > 0) && (report->requiredRate > 0) &&
+        (dev->writeRate < report->requiredRate * CAP_VERIFY_RATE_MARGIN)) {
+      printf(", write throughput behind the frame period");
+    }
+    printf(": %s\n", (dev->errors == 0) ? "OK" : "FAILED");
+  }
+  printf("%s Checked %.1f MB in %.2f s (%.1f MB/s): %s\n", prefix, report->bytes / 1e6,
+    report->elapsed / 1e9, (report->elapsed > 0) ? report->bytes * 1e3 / report->elapsed : 0.0,
+    (report->errors == 0) ? "OK" : "FAILED");
+}
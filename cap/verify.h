@@ -0,0 +1,131 @@
+/**
+ * @file verify.h
+ * @brief Frame integrity and write throughput check of the recorded captures
+ * @version 0.1
+ * @date 2026-10-14
+ *
+ * @copyright Copyright (c) 2026
+ *
+ * The raw binaries of each device ("<device>_<nnnn>_data.bin") are read
+ * sequentially, split by frame ranges over several threads, and checked
+ * against the frame geometry sent to the TDA (setWidthAndHeight):
+ *  - each device holds a whole number of frames, a partial last frame
+ *    being a truncated write;
+ *  - the devices hold the same number of frames, the expected one when it
+ *    is known (numFrames of the frame config, or the recording duration
+ *    over the frame period, up to CAP_VERIFY_SLACK frames);
+ *  - no frame is a copy of the previous one (same CRC32, then same bytes),
+ *    i.e. the TDA did not write the same buffer twice.
+ *
+ * The raw binaries hold no frame counter: a dropped frame shows up in the
+ * frame count only, not at its position in the capture.
+ *
+ * The write throughput of a device is the size of its data over the
+ * recording duration, compared with the rate required by the frame period.
+ * Without a duration, it can be derived from the modification times of the
+ * raw binaries (at least 2 of them), on the files written by the TDA or on
+ * copies preserving their times only.
+ */
+#ifndef MMWAVE_CAP_VERIFY_H
+#define MMWAVE_CAP_VERIFY_H
+
+#include <stdint.h>
+#include "cap.h"
+
+/* Frames that may be lost at the start and stop of a timed recording */
+#define CAP_VERIFY_SLACK        (2U)
+
+/* Share of the required write throughput below which the TDA fell behind */
+#define CAP_VERIFY_RATE_MARGIN  (0.95)
+
+
+/** Expected content of a capture */
+typedef struct capVerifyCfg {
+
+  // Devices of the capture (1: Master, 2: Slave1, 4: Slave2, 8: Slave3)
+  uint8_t deviceMap;
+
+  // Size of a frame of a device as recorded (bytes)
+  uint64_t blockSize;
+
+  // Number of frames of the frame config (0: until stopped)
+  uint32_t numFrames;
+
+  // Frame period (ns)
+  uint64_t framePeriod;
+
+  // Duration of the recording (ns, 0: unknown)
+  uint64_t duration;
+
+  // 1: without a duration, use the modification times of the raw binaries
+  uint8_t fileTimes;
+
+  // Number of threads reading the files (0: one per CPU)
+  uint8_t threads;
+
+} capVerifyCfg_t;
+
+
+/** Check of the data of a device */
+typedef struct capVerifyDevice {
+
+  // Number of raw binaries and size of the data
+  uint32_t segments;
+  uint64_t bytes;
+
+  // Number of complete frames, and bytes of a partial last frame
+  uint32_t frames;
+  uint32_t partialBytes;
+
+  // Frames missing from, and beyond, the expected count
+  uint32_t missing;
+  uint32_t extra;
+
+  // Frames identical to the previous one, and the first of them
+  uint32_t duplicates;
+  uint32_t firstDuplicate;
+
+  // Duration the write throughput is computed on (ns, 0: unknown)
+  uint64_t duration;
+
+  // Sustained write throughput (MB/s)
+  double writeRate;
+
+  // Number of failed checks (-1: no data or read error)
+  int32_t errors;
+
+} capVerifyDevice_t;
+
+
+/** Check of a capture */
+typedef struct capVerifyReport {
+
+  // Devices of the capture
+  uint8_t deviceMap;
+
+  // Per device results, by device ID
+  capVerifyDevice_t devices[CAP_MAX_DEVICES];
+
+  // Expected number of frames per device (0: unknown)
+  uint32_t expectedFrames;
+
+  // Write throughput required by the frame period, per device (MB/s)
+  double requiredRate;
+
+  // Number of bytes read and duration of the check (ns)
+  uint64_t bytes;
+  uint64_t elapsed;
+
+  // Number of failed checks over all the devices
+  uint32_t errors;
+
+} capVerifyReport_t;
+
+
+/* Check the raw binaries of a capture directory */
+int32_t cap_verify(const char *captureDir, const capVerifyCfg_t *cfg, capVerifyReport_t *report);
+
+/* Print the result of a check */
+void cap_verify_print(const capVerifyReport_t *report, const char *prefix);
+
+#endif
@@ -0,0 +1,272 @@
+/**
+ * @file ctl.c
+ * @brief Local control socket of the mmwave daemon
+ * @version 0.1
+ * @date 2026-10-14
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdarg.h>
+#include <errno.h>
+#include <unistd.h>
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/time.h>
+#include <sys/un.h>
+#include "ctl.h"
+
+
+/**
+ * @brief Create the listening socket
+ *
+ * A stale socket file left by a daemon that did not exit cleanly is
+ * removed. The call fails if another daemon is still listening on it.
+ *
+ * @param path Path of the socket file
+ * @return int Socket descriptor, -1 on failure
+ */
+int ctl_open(const char *path) {
+  struct sockaddr_un addr;
+  int sfd;
+
+  if (strlen(path) >= sizeof(addr.sun_path)) return -1;
+
+  memset(&addr, 0, sizeof(addr));
+  addr.sun_family = AF_UNIX;
+  strcpy(addr.sun_path, path);
+
+  sfd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+  if (sfd < 0) return -1;
+
+  if (connect(sfd, (struct sockaddr *)&addr, sizeof(addr)) == 0) {
+    // Another daemon already serves this socket
+    close(sfd);
+    return -1;
+  }
+  close(sfd);
+  unlink(path);
+
+  sfd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+  if (sfd < 0) return -1;
+  if ((bind(sfd, (struct sockaddr *)&addr, sizeof(addr)) != 0) ||
+      (chmod(path, 0660) != 0) || (listen(sfd, 4) != 0)) {
+    close(sfd);
+    return -1;
+  }
+  return sfd;
+}
+
+
+/**
+ * @brief Wait for the next client
+ *
+ * @param sfd Listening socket
+ * @return int Client socket descriptor, -1 on failure
+ */
+int ctl_accept(int sfd) {
+  struct timeval timeout = { .tv_sec = CTL_CLIENT_TIMEOUT, .tv_usec = 0 };
+  int cfd;
+
+  do {
+    cfd = accept4(sfd, NULL, NULL, SOCK_CLOEXEC);
+  } while ((cfd < 0) && (errno == EINTR));
+  if (cfd < 0) return -1;
+
+  // A client that stops talking must not hold the daemon forever
+  setsockopt(cfd, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+  setsockopt(cfd, SOL_SOCKET, SO_SNDTIMEO, &timeout, sizeof(timeout));
+  return cfd;
+}
+
+
+/**
+ * @brief Parse a JSON string in place
+ *
+ * @param p Pointer to the opening quote, updated past the closing quote
+ * @return char* Unescaped NUL terminated string, NULL when malformed
+ */
+static char* ctl_parse_string(char **p) {
+  char *src = *p + 1;
+  char *dst = src;
+  char *str = src;
+
+  while (*src != '"') {
+    if (*src == '\0') return NULL;
+    if (*src == '\\') {
+      src++;
+      switch (*src) {
+        case '"': case '\\': case '/': *dst = *src; break;
+        case 'n': *dst = '\n'; break;
+        case 't': *dst = '\t'; break;
+        case 'r': *dst = '\r'; break;
+        default: return NULL;   // \u escapes are not supported
+      }
+      dst++;
+      src++;
+    } else {
+      *dst++ = *src++;
+    }
+  }
+  *p = src + 1;
+  *dst = '\0';
+  return str;
+}
+
+
+/**
+ * @brief Parse a flat JSON object in place
+ *
+ * @param line NUL terminated request line
+ * @param req Request to fill
+ * @return int 0 on success, -1 when malformed
+ */
+static int ctl_parse(char *line, ctlRequest_t *req) {
+  char *p = line;
+  char c;
+
+  req->nFields = 0;
+  while ((*p == ' ') || (*p == '\t')) p++;
+  if (*p++ != '{') return -1;
+
+  for (;;) {
+    while ((*p == ' ') || (*p == '\t')) p++;
+    if ((*p == '}') && (req->nFields == 0)) return 0;
+    if ((*p != '"') || (req->nFields >= CTL_MAX_FIELDS)) return -1;
+
+    req->key[req->nFields] = ctl_parse_string(&p);
+    if (req->key[req->nFields] == NULL) return -1;
+
+    while ((*p == ' ') || (*p == '\t')) p++;
+    if (*p++ != ':') return -1;
+    while ((*p == ' ') || (*p == '\t')) p++;
+
+    if (*p == '"') {
+      req->value[req->nFields] = ctl_parse_string(&p);
+      if (req->value[req->nFields] == NULL) return -1;
+      while ((*p == ' ') || (*p == '\t')) p++;
+      c = *p++;
+    } else {
+      // Number, true, false or null
+      req->value[req->nFields] = p;
+      while ((*p == '-') || (*p == '+') || (*p == '.') ||
+             ((*p >= '0') && (*p <= '9')) || ((*p >= 'a') && (*p <= 'z')) ||
+             ((*p >= 'A') && (*p <= 'Z'))) p++;
+      if (p == req->value[req->nFields]) return -1;
+      while ((*p == ' ') || (*p == '\t')) *p++ = '\0';
+      c = *p;
+      *p++ = '\0';
+    }
+    req->nFields++;
+
+    if (c == '}') return 0;
+    if (c != ',') return -1;
+  }
+}
+
+
+/**
+ * @brief Read and parse the next request of a client
+ *
+ * The keys and values of the request remain valid until the next call.
+ *
+ * @param cfd Client socket
+ * @param req Request buffer, zero initialized for a new client
+ * @return int 0 on success, 1 for a malformed request, -1 when the client
+ *    is gone, idle for too long or sent an oversized request
+ */
+int ctl_read(int cfd, ctlRequest_t *req) {
+  char *eol;
+  ssize_t n;
+
+  // Drop the request served last
+  if (req->consumed > 0) {
+    req->length -= req->consumed;
+    memmove(req->buffer, req->buffer + req->consumed, req->length);
+    req->consumed = 0;
+  }
+
+  for (;;) {
+    eol = memchr(req->buffer, '\n', req->length);
+    if (eol != NULL) break;
+    if (req->length >= CTL_MAX_REQUEST_SIZE) return -1;
+
+    n = recv(cfd, req->buffer + req->length, CTL_MAX_REQUEST_SIZE - req->length, 0);
+    if ((n < 0) && (errno == EINTR)) continue;
+    if (n <= 0) return -1;
+    req->length += n;
+  }
+
+  req->consumed = (eol - req->buffer) + 1;
+  *eol = '\0';
+  if ((eol > req->buffer) && (eol[-1] == '\r')) eol[-1] = '\0';
+  return (ctl_parse(req->buffer, req) == 0) ? 0 : 1;
+}
+
+
+/**
+ * @brief Value of a request field
+ *
+ * @param req Parsed request
+ * @param key Field name
+ * @return const char* Field value, NULL when absent
+ */
+const char* ctl_get(const ctlRequest_t *req, const char *key) {
+  for (uint8_t i = 0; i < req->nFields; i++) {
+    if (strcmp(req->key[i], key) == 0) return req->value[i];
+  }
+  return NULL;
+}
+
+
+/**
+ * @brief Send a JSON object to a client
+ *
+ * @param cfd Client socket
+ * @param fmt printf format of the object members (without the braces)
+ * @return int 0 on success, -1 on failure
+ */
+int ctl_reply(int cfd, const char *fmt, ...) {
+  char buffer[CTL_MAX_REQUEST_SIZE];
+  size_t length;
+  ssize_t n;
+  va_list args;
+  int size;
+
+  buffer[0] = '{';
+  va_start(args, fmt);
+  size = vsnprintf(buffer + 1, sizeof(buffer) - 3, fmt, args);
+  va_end(args);
+  if ((size < 0) || ((size_t)size >= sizeof(buffer) - 3)) return -1;
+
+  length = size + 1;
+  buffer[length++] = '}';
+  buffer[length++] = '\n';
+
+  for (size_t sent = 0; sent < length; sent += n) {
+    n = send(cfd, buffer + sent, length - sent, MSG_NOSIGNAL);
+    if ((n < 0) && (errno == EINTR)) {
+      n = 0;
+      continue;
+    }
+    if (n <= 0) return -1;
+  }
+  return 0;
+}
+
+
+/**
+ * @brief Close the listening socket and remove the socket file
+ *
+ * @param sfd Listening socket
+ * @param path Path of the socket file
+ */
+void ctl_close(int sfd, const char *path) {
+  if (sfd >= 0) close(sfd);
+  if (path != NULL) unlink(path);
+}
@@ -0,0 +1,76 @@
+/**
+ * @file ctl.h
+ * @brief Local control socket of the mmwave daemon
+ * @version 0.1
+ * @date 2026-10-14
+ *
+ * @copyright Copyright (c) 2026
+ *
+ * The daemon listens on a UNIX stream socket. Each request is a single line
+ * holding a flat JSON object (string, number or boolean values only) and is
+ * answered by a single line JSON object:
+ *
+ *    -> {"cmd": "arm", "capture_dir": "MMWL_Capture_1"}
+ *    <- {"status": 0, "state": "armed", ...}
+ *
+ * A client may send several requests on the same connection. Requests are
+ * served one at a time, in order.
+ */
+#ifndef MMWAVE_CTL_H
+#define MMWAVE_CTL_H
+
+#include <stdint.h>
+
+/* Default socket path, "%s" is replaced by the DSP board IP address */
+#define CTL_SOCKET_PATH_FMT     "/tmp/mmwave_%s.sock"
+
+/* Maximum size of a request line (including the new line) */
+#define CTL_MAX_REQUEST_SIZE    (4096U)
+
+/* Maximum number of key/value pairs in a request */
+#define CTL_MAX_FIELDS          (16U)
+
+/* A client idle for longer than this is disconnected (s) */
+#define CTL_CLIENT_TIMEOUT      (30U)
+
+
+/** Control request */
+typedef struct ctlRequest {
+
+  // Raw request, the keys and values point into it once parsed
+  char buffer[CTL_MAX_REQUEST_SIZE];
+
+  // Number of bytes received
+  uint32_t length;
+
+  // Number of bytes of the request being served (dropped on the next read)
+  uint32_t consumed;
+
+  // Number of key/value pairs
+  uint8_t nFields;
+
+  char *key[CTL_MAX_FIELDS];
+  char *value[CTL_MAX_FIELDS];
+
+} ctlRequest_t;
+
+
+/* Create the listening socket */
+int ctl_open(const char *path);
+
+/* Wait for the next client */
+int ctl_accept(int sfd);
+
+/* Read and parse the next request of a client */
+int ctl_read(int cfd, ctlRequest_t *req);
+
+/* Value of a request field (NULL when absent) */
+const char* ctl_get(const ctlRequest_t *req, const char *key);
+
+/* Send a JSON object (without the braces) to a client */
+int ctl_reply(int cfd, const char *fmt, ...);
+
+/* Close the listening socket and remove the socket file */
+void ctl_close(int sfd, const char *path);
+
+#endif
@@ -0,0 +1,738 @@
+/**
+ * @file cube.c
+ * @brief Reorder of the raw ADC data into MIMO virtual array cubes
+ * @version 0.1
+ * @date 2026-10-14
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+#include <string.h>
+#include <unistd.h>
+#include <pthread.h>
+#include "cube.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define DSP_X86 1
+#elif defined(__ARM_NEON)
+#include <arm_neon.h>
+#define DSP_NEON 1
+#endif
+
+
+/**
+ * Chirp kernel: reorder the values of a chirp of a device
+ *
+ * @param in Raw chirp (16-bit values)
+ * @param out Cube values of the first RX channel of the device
+ * @param rxStride Distance between two RX channels in the cube (floats)
+ * @param numSamples Number of samples per chirp
+ * @param swap Q first
+ * @param stream Store bypassing the caches (x86 only, see dsp_cube_stream)
+ */
+typedef void (*dspChirpFn_t)(const int16_t *in, float *out, size_t rxStride,
+                             uint16_t numSamples, uint8_t swap, uint8_t stream);
+
+
+/* Samples of a chirp unpacked at once from 12-bit packed values (multiple
+   of 8), converted while they are in L1 */
+#define DSP_CHUNK_SAMPLES       (64U)
+
+
+/**
+ * @brief Generic chirp kernel, interleaved RX channels, any number of RX
+ *    channels
+ *
+ * @param layout Layout of the raw frames
+ * @param in Raw values of the first sample
+ * @param out Cube values of the first sample of the first RX channel of the device
+ * @param numSamples Number of samples
+ */
+static void dsp_chirp_generic(const dspLayout_t *layout, const int16_t *in, float *out,
+                              uint16_t numSamples) {
+  const size_t rxStride = (size_t)layout->numSamples * 2;
+  const uint8_t vals = layout->complex ? 2 : 1;
+  const uint8_t re = (layout->complex && layout->iqSwap) ? 1 : 0;
+  const int16_t *src;
+  float *dst;
+
+  for (uint8_t rx = 0; rx < layout->numRx; rx++) {
+    dst = out + rx * rxStride;
+    for (uint16_t s = 0; s < numSamples; s++) {
+      src = in + ((size_t)s * layout->numRx + rx) * vals;
+      dst[2 * s] = src[re];
+      dst[2 * s + 1] = (vals == 2) ? src[1 - re] : 0.0f;
+    }
+  }
+}
+
+
+/**
+ * @brief Real values of a RX channel
+ *
+ * @param in Raw values
+ * @param out Cube values
+ * @param count Number of values
+ */
+static void dsp_convert_real(const int16_t *in, float *out, size_t count) {
+  for (size_t i = 0; i < count; i++) {
+    out[2 * i] = in[i];
+    out[2 * i + 1] = 0.0f;
+  }
+}
+
+
+/**
+ * @brief Interleaved complex chirp of 4 RX channels, scalar
+ */
+static void dsp_chirp_rx4_scalar(const int16_t *in, float *out, size_t rxStride,
+                                 uint16_t numSamples, uint8_t swap, uint8_t stream) {
+  for (uint16_t s = 0; s < numSamples; s++) {
+    for (uint8_t rx = 0; rx < 4; rx++) {
+      out[rx * rxStride + 2 * s] = in[(4 * s + rx) * 2 + swap];
+      out[rx * rxStride + 2 * s + 1] = in[(4 * s + rx) * 2 + 1 - swap];
+    }
+  }
+}
+
+
+/**
+ * @brief Contiguous complex values, scalar
+ *
+ * @param in Raw values
+ * @param out Cube values
+ * @param count Number of complex values
+ * @param swap Q first
+ * @param stream Store bypassing the caches (x86 only, see dsp_cube_stream)
+ */
+static void dsp_convert_scalar(const int16_t *in, float *out, size_t count, uint8_t swap,
+                               uint8_t stream) {
+  for (size_t i = 0; i < count; i++) {
+    out[2 * i] = in[2 * i + swap];
+    out[2 * i + 1] = in[2 * i + 1 - swap];
+  }
+}
+
+
+/**
+ * @brief Unpack 12-bit values, scalar
+ *
+ * Each pair of values is packed into 3 bytes, low bits first:
+ * v0 = b0 | (b1 & 0xF) << 8, v1 = b1 >> 4 | b2 << 4.
+ *
+ * @param in Packed values
+ * @param out 16-bit values
+ * @param count Number of values (even)
+ */
+static void dsp_unpack12_scalar(const uint8_t *in, int16_t *out, size_t count) {
+  for (size_t i = 0; i < count; i += 2, in += 3) {
+    uint16_t v0 = in[0] | ((in[1] & 0x0F) << 8);
+    uint16_t v1 = (in[1] >> 4) | (in[2] << 4);
+    // Sign extension of the 12-bit values
+    out[i] = (int16_t)(v0 << 4) >> 4;
+    out[i + 1] = (int16_t)(v1 << 4) >> 4;
+  }
+}
+
+
+#if defined(DSP_X86)
+
+/* Swap the 16-bit halves of each 32-bit lane */
+#define DSP_SWAP_IQ_128(x)    _mm_shufflehi_epi16(_mm_shufflelo_epi16((x), 0xB1), 0xB1)
+#define DSP_SWAP_IQ_256(x)    _mm256_shufflehi_epi16(_mm256_shufflelo_epi16((x), 0xB1), 0xB1)
+
+/**
+ * @brief Store 4 floats, bypassing the caches when streaming
+ */
+static inline void dsp_store_ps(float *out, __m128 x, uint8_t stream) {
+  if (stream) {
+    _mm_stream_ps(out, x);
+  } else {
+    _mm_storeu_ps(out, x);
+  }
+}
+
+/**
+ * @brief Store 4 complex 16-bit values as floats (SSE2)
+ */
+static inline void dsp_store4_sse2(float *out, __m128i x, uint8_t stream) {
+  // Sign extension of the 16-bit values
+  __m128i lo = _mm_srai_epi32(_mm_unpacklo_epi16(x, x), 16);
+  __m128i hi = _mm_srai_epi32(_mm_unpackhi_epi16(x, x), 16);
+  dsp_store_ps(out, _mm_cvtepi32_ps(lo), stream);
+  dsp_store_ps(out + 4, _mm_cvtepi32_ps(hi), stream);
+}
+
+/**
+ * @brief Interleaved complex chirp of 4 RX channels, SSE2
+ *
+ * 4 samples of the 4 RX channels (one 32-bit complex value each) are
+ * loaded, transposed and converted at once.
+ */
+static void dsp_chirp_rx4_sse2(const int16_t *in, float *out, size_t rxStride,
+                               uint16_t numSamples, uint8_t swap, uint8_t stream) {
+  uint16_t s = 0;
+
+  for (; s + 4 <= numSamples; s += 4) {
+    const __m128i *p = (const __m128i *)(in + 8 * s);
+    __m128i a0 = _mm_loadu_si128(p);
+    __m128i a1 = _mm_loadu_si128(p + 1);
+    __m128i a2 = _mm_loadu_si128(p + 2);
+    __m128i a3 = _mm_loadu_si128(p + 3);
+    __m128i t0 = _mm_unpacklo_epi32(a0, a1);
+    __m128i t1 = _mm_unpackhi_epi32(a0, a1);
+    __m128i t2 = _mm_unpacklo_epi32(a2, a3);
+    __m128i t3 = _mm_unpackhi_epi32(a2, a3);
+    __m128i r[4] = {
+      _mm_unpacklo_epi64(t0, t2), _mm_unpackhi_epi64(t0, t2),
+      _mm_unpacklo_epi64(t1, t3), _mm_unpackhi_epi64(t1, t3),
+    };
+    for (uint8_t rx = 0; rx < 4; rx++) {
+      if (swap) r[rx] = DSP_SWAP_IQ_128(r[rx]);
+      dsp_store4_sse2(out + rx * rxStride + 2 * s, r[rx], stream);
+    }
+  }
+  if (s < numSamples) {
+    dsp_chirp_rx4_scalar(in + 8 * s, out + 2 * s, rxStride, numSamples - s, swap, stream);
+  }
+}
+
+/**
+ * @brief Contiguous complex values, SSE2
+ */
+static void dsp_convert_sse2(const int16_t *in, float *out, size_t count, uint8_t swap,
+                             uint8_t stream) {
+  size_t i = 0;
+
+  for (; i + 4 <= count; i += 4) {
+    __m128i x = _mm_loadu_si128((const __m128i *)(in + 2 * i));
+    if (swap) x = DSP_SWAP_IQ_128(x);
+    dsp_store4_sse2(out + 2 * i, x, stream);
+  }
+  dsp_convert_scalar(in + 2 * i, out + 2 * i, count - i, swap, stream);
+}
+
+/**
+ * @brief Store 8 floats, bypassing the caches when streaming
+ */
+__attribute__((target("avx2")))
+static inline void dsp_store_ps256(float *out, __m256 x, uint8_t stream) {
+  if (stream) {
+    _mm_stream_ps(out, _mm256_castps256_ps128(x));
+    _mm_stream_ps(out + 4, _mm256_extractf128_ps(x, 1));
+  } else {
+    _mm256_storeu_ps(out, x);
+  }
+}
+
+/**
+ * @brief Store 8 complex 16-bit values as floats (AVX2)
+ */
+__attribute__((target("avx2")))
+static inline void dsp_store8_avx2(float *out, __m256i x, uint8_t stream) {
+  __m256i lo = _mm256_cvtepi16_epi32(_mm256_castsi256_si128(x));
+  __m256i hi = _mm256_cvtepi16_epi32(_mm256_extracti128_si256(x, 1));
+  dsp_store_ps256(out, _mm256_cvtepi32_ps(lo), stream);
+  dsp_store_ps256(out + 8, _mm256_cvtepi32_ps(hi), stream);
+}
+
+/**
+ * @brief Interleaved complex chirp of 4 RX channels, AVX2
+ *
+ * Samples s..s+3 go to the low lanes and samples s+4..s+7 to the high
+ * lanes, so that the in-lane 4x4 transpose leaves 8 consecutive samples of
+ * one RX channel in each register.
+ */
+__attribute__((target("avx2")))
+static void dsp_chirp_rx4_avx2(const int16_t *in, float *out, size_t rxStride,
+                               uint16_t numSamples, uint8_t swap, uint8_t stream) {
+  uint16_t s = 0;
+
+  for (; s + 8 <= numSamples; s += 8) {
+    const __m128i *p = (const __m128i *)(in + 8 * s);
+    __m256i a[4];
+    for (uint8_t j = 0; j < 4; j++) {
+      a[j] = _mm256_inserti128_si256(
+        _mm256_castsi128_si256(_mm_loadu_si128(p + j)), _mm_loadu_si128(p + 4 + j), 1);
+    }
+    __m256i t0 = _mm256_unpacklo_epi32(a[0], a[1]);
+    __m256i t1 = _mm256_unpackhi_epi32(a[0], a[1]);
+    __m256i t2 = _mm256_unpacklo_epi32(a[2], a[3]);
+    __m256i t3 = _mm256_unpackhi_epi32(a[2], a[3]);
+    __m256i r[4] = {
+      _mm256_unpacklo_epi64(t0, t2), _mm256_unpackhi_epi64(t0, t2),
+      _mm256_unpacklo_epi64(t1, t3), _mm256_unpackhi_epi64(t1, t3),
+    };
+    for (uint8_t rx = 0; rx < 4; rx++) {
+      if (swap) r[rx] = DSP_SWAP_IQ_256(r[rx]);
+      dsp_store8_avx2(out + rx * rxStride + 2 * s, r[rx], stream);
+    }
+  }
+  if (s < numSamples) {
+    dsp_chirp_rx4_sse2(in + 8 * s, out + 2 * s, rxStride, numSamples - s, swap, stream);
+  }
+}
+
+/**
+ * @brief Contiguous complex values, AVX2
+ */
+__attribute__((target("avx2")))
+static void dsp_convert_avx2(const int16_t *in, float *out, size_t count, uint8_t swap,
+                             uint8_t stream) {
+  size_t i = 0;
+
+  for (; i + 8 <= count; i += 8) {
+    __m256i x = _mm256_loadu_si256((const __m256i *)(in + 2 * i));
+    if (swap) x = DSP_SWAP_IQ_256(x);
+    dsp_store8_avx2(out + 2 * i, x, stream);
+  }
+  dsp_convert_sse2(in + 2 * i, out + 2 * i, count - i, swap, stream);
+}
+
+/**
+ * @brief Unpack 12-bit values, AVX2
+ *
+ * Each 128-bit lane gathers 8 values from 12 bytes: the even values are
+ * the low 12 bits of their 16-bit word and the odd values the high 12
+ * bits, sign extended by one arithmetic shift after moving the even ones
+ * up by 4 bits.
+ */
+__attribute__((target("avx2")))
+static void dsp_unpack12_avx2(const uint8_t *in, int16_t *out, size_t count) {
+  const __m256i gather = _mm256_setr_epi8(
+    0, 1, 1, 2, 3, 4, 4, 5, 6, 7, 7, 8, 9, 10, 10, 11,
+    0, 1, 1, 2, 3, 4, 4, 5, 6, 7, 7, 8, 9, 10, 10, 11);
+  const __m256i shift = _mm256_setr_epi16(16, 1, 16, 1, 16, 1, 16, 1, 16, 1, 16, 1, 16, 1, 16, 1);
+  size_t i = 0;
+
+  // 16-byte loads from 12-byte steps: stop 4 bytes before the end
+  for (; i + 20 <= count; i += 16, in += 24) {
+    __m256i x = _mm256_inserti128_si256(
+      _mm256_castsi128_si256(_mm_loadu_si128((const __m128i *)in)),
+      _mm_loadu_si128((const __m128i *)(in + 12)), 1);
+    x = _mm256_shuffle_epi8(x, gather);
+    x = _mm256_srai_epi16(_mm256_mullo_epi16(x, shift), 4);
+    _mm256_storeu_si256((__m256i *)(out + i), x);
+  }
+  dsp_unpack12_scalar(in, out + i, count - i);
+}
+
+#elif defined(DSP_NEON)
+
+/**
+ * @brief Store 4 complex 16-bit values as floats (NEON)
+ */
+static inline void dsp_store4_neon(float *out, int16x8_t x) {
+  vst1q_f32(out, vcvtq_f32_s32(vmovl_s16(vget_low_s16(x))));
+  vst1q_f32(out + 4, vcvtq_f32_s32(vmovl_s16(vget_high_s16(x))));
+}
+
+/**
+ * @brief Interleaved complex chirp of 4 RX channels, NEON
+ *
+ * The de-interleaving load splits 4 samples of the 4 RX channels (one
+ * 32-bit complex value each) by RX channel.
+ */
+static void dsp_chirp_rx4_neon(const int16_t *in, float *out, size_t rxStride,
+                               uint16_t numSamples, uint8_t swap, uint8_t stream) {
+  uint16_t s = 0;
+
+  for (; s + 4 <= numSamples; s += 4) {
+    int32x4x4_t v = vld4q_s32((const int32_t *)(in + 8 * s));
+    for (uint8_t rx = 0; rx < 4; rx++) {
+      int16x8_t x = vreinterpretq_s16_s32(v.val[rx]);
+      if (swap) x = vrev32q_s16(x);
+      dsp_store4_neon(out + rx * rxStride + 2 * s, x);
+    }
+  }
+  if (s < numSamples) {
+    dsp_chirp_rx4_scalar(in + 8 * s, out + 2 * s, rxStride, numSamples - s, swap, stream);
+  }
+}
+
+/**
+ * @brief Contiguous complex values, NEON
+ */
+static void dsp_convert_neon(const int16_t *in, float *out, size_t count, uint8_t swap,
+                             uint8_t stream) {
+  size_t i = 0;
+
+  for (; i + 4 <= count; i += 4) {
+    int16x8_t x = vld1q_s16(in + 2 * i);
+    if (swap) x = vrev32q_s16(x);
+    dsp_store4_neon(out + 2 * i, x);
+  }
+  dsp_convert_scalar(in + 2 * i, out + 2 * i, count - i, swap, stream);
+}
+
+/**
+ * @brief Unpack 12-bit values, NEON
+ *
+ * The de-interleaving load splits 16 values into the 3 bytes of their
+ * pairs.
+ */
+static void dsp_unpack12_neon(const uint8_t *in, int16_t *out, size_t count) {
+  size_t i = 0;
+
+  for (; i + 16 <= count; i += 16, in += 24) {
+    uint8x8x3_t b = vld3_u8(in);
+    uint16x8_t v0 = vorrq_u16(vmovl_u8(b.val[0]),
+                              vshlq_n_u16(vmovl_u8(vand_u8(b.val[1], vdup_n_u8(0x0F))), 8));
+    uint16x8_t v1 = vorrq_u16(vmovl_u8(vshr_n_u8(b.val[1], 4)), vshlq_n_u16(vmovl_u8(b.val[2]), 4));
+    int16x8x2_t x;
+    x.val[0] = vshrq_n_s16(vreinterpretq_s16_u16(vshlq_n_u16(v0, 4)), 4);
+    x.val[1] = vshrq_n_s16(vreinterpretq_s16_u16(vshlq_n_u16(v1, 4)), 4);
+    vst2q_s16(out + i, x);
+  }
+  dsp_unpack12_scalar(in, out + i, count - i);
+}
+
+#endif
+
+
+/** Kernels selected for the CPU */
+typedef struct dspKernels {
+  dspChirpFn_t rx4;
+  void (*convert)(const int16_t *in, float *out, size_t count, uint8_t swap, uint8_t stream);
+  void (*unpack12)(const uint8_t *in, int16_t *out, size_t count);
+  const char *name;
+} dspKernels_t;
+
+/**
+ * @brief Kernels for the CPU in use
+ *
+ * @return const dspKernels_t* Kernels
+ */
+static const dspKernels_t* dsp_kernels() {
+#if defined(DSP_X86)
+  static const dspKernels_t avx2 = { dsp_chirp_rx4_avx2, dsp_convert_avx2, dsp_unpack12_avx2, "avx2" };
+  static const dspKernels_t sse2 = { dsp_chirp_rx4_sse2, dsp_convert_sse2, dsp_unpack12_scalar, "sse2" };
+  return __builtin_cpu_supports("avx2") ? &avx2 : &sse2;
+#elif defined(DSP_NEON)
+  static const dspKernels_t neon = { dsp_chirp_rx4_neon, dsp_convert_neon, dsp_unpack12_neon, "neon" };
+  return &neon;
+#else
+  static const dspKernels_t scalar = { dsp_chirp_rx4_scalar, dsp_convert_scalar, dsp_unpack12_scalar, "scalar" };
+  return &scalar;
+#endif
+}
+
+
+/**
+ * @brief Check the layout and compute its derived fields
+ *
+ * Each chirp must be transmitted by a single TX of a single device, and
+ * each TX can transmit a single chirp per loop.
+ *
+ * @param layout Layout of the raw frames
+ * @return int32_t 0 on success, -1 on invalid layout
+ */
+int32_t dsp_layout_init(dspLayout_t *layout) {
+  int8_t chirpVtx[DSP_MAX_CHIRPS];
+  uint16_t usedTx = 0;
+  size_t valsPerChirp;
+
+  if ((layout->numSamples == 0) || (layout->numLoops == 0) ||
+      (layout->numChirps == 0) || (layout->numChirps > DSP_MAX_CHIRPS)) {
+    return -1;
+  }
+
+  layout->numDevices = 0;
+  for (uint8_t devId = 0; devId < DSP_MAX_DEVICES; devId++) {
+    layout->devSlot[devId] = layout->numDevices;
+    if (layout->deviceMap & (1U << devId)) layout->numDevices++;
+  }
+  layout->numRx = 0;
+  for (uint8_t rx = 0; rx < 8; rx++) {
+    if (layout->rxChannelEn & (1U << rx)) layout->numRx++;
+  }
+  if ((layout->numDevices == 0) || (layout->numRx == 0) || (layout->numRx > DSP_MAX_RX)) {
+    return -1;
+  }
+
+  // Virtual TX: device slot x 3 + TX of the device
+  for (uint16_t c = 0; c < layout->numChirps; c++) {
+    chirpVtx[c] = -1;
+    for (uint8_t devId = 0; devId < DSP_MAX_DEVICES; devId++) {
+      uint16_t tx = layout->chirpTx[devId][c];
+      if (((layout->deviceMap & (1U << devId)) == 0) || (tx == 0)) continue;
+      if ((chirpVtx[c] >= 0) || ((tx & (tx - 1)) != 0) || (tx >= (1U << DSP_NUM_TX))) {
+        return -1;  // Not a TDM chirp
+      }
+      chirpVtx[c] = layout->devSlot[devId] * DSP_NUM_TX + __builtin_ctz(tx);
+    }
+    if ((chirpVtx[c] < 0) || (usedTx & (1U << chirpVtx[c]))) return -1;
+    usedTx |= 1U << chirpVtx[c];
+  }
+  layout->numTx = layout->numChirps;
+  for (uint16_t c = 0; c < layout->numChirps; c++) {
+    layout->txSlot[c] = __builtin_popcount(usedTx & ((1U << chirpVtx[c]) - 1));
+  }
+
+  valsPerChirp = (size_t)layout->numSamples * layout->numRx * (layout->complex ? 2 : 1);
+  // The 12-bit pairs must not straddle two chirps, or two RX channels when
+  // not interleaved
+  if (layout->packed12 && ((valsPerChirp % 2 != 0) ||
+      (layout->chInterleave && !layout->complex && (layout->numSamples % 2 != 0)))) {
+    return -1;
+  }
+  layout->chirpBytes = layout->packed12 ? (valsPerChirp * 3) / 2 : valsPerChirp * 2;
+  layout->frameBytes = layout->chirpBytes * layout->numChirps * layout->numLoops;
+  layout->cubeSize = (size_t)layout->numLoops * layout->numTx *
+    layout->numDevices * layout->numRx * layout->numSamples * 2;
+  return 0;
+}
+
+
+/**
+ * @brief Reorder samples of a chirp of a device
+ *
+ * @param layout Layout of the raw frames
+ * @param kernels Kernels for the CPU in use
+ * @param in Raw values of the first sample (interleaved RX channels) or of
+ *    the first sample of a RX channel (non-interleaved)
+ * @param out Cube values of the first sample, of the first RX channel of the
+ *    device (interleaved) or of the RX channel (non-interleaved)
+ * @param numSamples Number of samples
+ * @param stream Store bypassing the caches
+ */
+static void dsp_chirp_samples(const dspLayout_t *layout, const dspKernels_t *kernels,
+                              const int16_t *in, float *out, uint16_t numSamples,
+                              uint8_t stream) {
+  if (layout->chInterleave) {
+    if (layout->complex) {
+      kernels->convert(in, out, numSamples, layout->iqSwap, stream);
+    } else {
+      dsp_convert_real(in, out, numSamples);
+    }
+  } else if (layout->complex && (layout->numRx == 4)) {
+    kernels->rx4(in, out, (size_t)layout->numSamples * 2, numSamples, layout->iqSwap, stream);
+  } else if (layout->complex && (layout->numRx == 1)) {
+    kernels->convert(in, out, numSamples, layout->iqSwap, stream);
+  } else {
+    dsp_chirp_generic(layout, in, out, numSamples);
+  }
+}
+
+
+/**
+ * @brief Reorder a chirp of a device
+ *
+ * The 12-bit packed values are unpacked by chunks of DSP_CHUNK_SAMPLES
+ * samples into a buffer in L1, and converted right away.
+ *
+ * @param layout Layout of the raw frames
+ * @param kernels Kernels for the CPU in use
+ * @param in Raw chirp
+ * @param out Cube values of the first RX channel of the device
+ * @param stream Store bypassing the caches
+ */
+static void dsp_chirp(const dspLayout_t *layout, const dspKernels_t *kernels,
+                      const uint8_t *in, float *out, uint8_t stream) {
+  const size_t rxStride = (size_t)layout->numSamples * 2;
+  const uint8_t vals = layout->complex ? 2 : 1;
+  // Segments of contiguous samples: the RX channels when not interleaved
+  const uint8_t numSegments = layout->chInterleave ? layout->numRx : 1;
+  const uint8_t segmentRx = layout->chInterleave ? 1 : layout->numRx;
+  int16_t chunk[DSP_CHUNK_SAMPLES * DSP_MAX_RX * 2];
+
+  for (uint8_t seg = 0; seg < numSegments; seg++) {
+    // Offset of the segment in values (even when packed, see dsp_layout_init)
+    size_t first = (size_t)seg * layout->numSamples * vals;
+
+    if (!layout->packed12) {
+      dsp_chirp_samples(layout, kernels, (const int16_t *)in + first, out + seg * rxStride,
+        layout->numSamples, stream);
+      continue;
+    }
+    for (uint32_t s = 0; s < layout->numSamples; s += DSP_CHUNK_SAMPLES) {
+      uint32_t left = layout->numSamples - s;
+      uint16_t n = (left < DSP_CHUNK_SAMPLES) ? left : DSP_CHUNK_SAMPLES;
+      size_t offset = first + (size_t)s * segmentRx * vals;
+
+      kernels->unpack12(in + offset / 2 * 3, chunk, (size_t)n * segmentRx * vals);
+      dsp_chirp_samples(layout, kernels, chunk, out + seg * rxStride + 2 * s, n, stream);
+    }
+  }
+}
+
+
+/**
+ * @brief Reorder one frame, storing the cube through the caches or not
+ *
+ * @param layout Layout of the raw frames
+ * @param raw Raw frame of each device of the device map (indexed by device ID)
+ * @param cube Cube of the frame (layout->cubeSize floats)
+ * @param stream Store bypassing the caches (see dsp_cube_stream)
+ */
+static void dsp_cube_frame_store(const dspLayout_t *layout, const uint8_t *const raw[DSP_MAX_DEVICES],
+                                 float *cube, uint8_t stream) {
+  const dspKernels_t *kernels = dsp_kernels();
+  const size_t rxStride = (size_t)layout->numSamples * 2;
+  const size_t numRxTotal = (size_t)layout->numDevices * layout->numRx;
+
+  for (uint16_t loop = 0; loop < layout->numLoops; loop++) {
+    for (uint16_t c = 0; c < layout->numChirps; c++) {
+      size_t chirp = (size_t)loop * layout->numChirps + c;
+      float *txOut = cube + ((size_t)loop * layout->numTx + layout->txSlot[c]) * numRxTotal * rxStride;
+
+      for (uint8_t devId = 0; devId < DSP_MAX_DEVICES; devId++) {
+        if ((layout->deviceMap & (1U << devId)) == 0) continue;
+        dsp_chirp(layout, kernels, raw[devId] + chirp * layout->chirpBytes,
+          txOut + (size_t)layout->devSlot[devId] * layout->numRx * rxStride, stream);
+      }
+    }
+  }
+#if defined(DSP_X86)
+  // Streaming stores are weakly ordered: visible before the cube is handed over
+  if (stream) _mm_sfence();
+#endif
+}
+
+
+/**
+ * @brief Whether the cubes can be stored bypassing the caches
+ *
+ * The cubes are larger than the raw frames and are usually not read back
+ * before they are evicted: streaming stores save reading their cache lines
+ * from memory before writing them. The rows of the cube must start on a
+ * cache line, or the partial lines at both ends of each row are written
+ * back to memory one store at a time.
+ *
+ * @param layout Layout of the raw frames
+ * @param cube First cube
+ * @return uint8_t 1 to stream
+ */
+static uint8_t dsp_cube_stream(const dspLayout_t *layout, const float *cube) {
+#if defined(DSP_X86)
+  return (((uintptr_t)cube % 64) == 0) && ((layout->numSamples % 8) == 0);
+#else
+  (void)layout;
+  (void)cube;
+  return 0;
+#endif
+}
+
+
+/**
+ * @brief Reorder one frame
+ *
+ * The cube is stored through the caches, to be processed right away.
+ *
+ * @param layout Layout of the raw frames (see dsp_layout_init)
+ * @param raw Raw frame of each device of the device map (indexed by device ID)
+ * @param cube Cube of the frame (layout->cubeSize floats)
+ * @return int32_t 0 on success, -1 on failure
+ */
+int32_t dsp_cube_frame(const dspLayout_t *layout, const uint8_t *const raw[DSP_MAX_DEVICES],
+                       float *cube) {
+  dsp_cube_frame_store(layout, raw, cube, 0);
+  return 0;
+}
+
+
+/** Frames reordered by a thread */
+typedef struct dspCubeJob {
+  const dspLayout_t *layout;
+  const uint8_t *const *raw;
+  size_t rawStride;
+  uint32_t first;
+  uint32_t count;
+  float *cube;
+  uint8_t stream;
+  int32_t status;
+} dspCubeJob_t;
+
+/**
+ * @brief Reorder thread
+ *
+ * @param arg Job
+ * @return void* NULL
+ */
+static void* dsp_cube_worker(void *arg) {
+  dspCubeJob_t *job = (dspCubeJob_t *)arg;
+  const dspLayout_t *layout = job->layout;
+  const uint8_t *raw[DSP_MAX_DEVICES] = { NULL };
+
+  for (uint32_t f = job->first; f < job->first + job->count; f++) {
+    for (uint8_t devId = 0; devId < DSP_MAX_DEVICES; devId++) {
+      if (job->raw[devId] != NULL) raw[devId] = job->raw[devId] + (size_t)f * job->rawStride;
+    }
+    dsp_cube_frame_store(layout, raw, job->cube + (size_t)f * layout->cubeSize, job->stream);
+  }
+  job->status = 0;
+  return NULL;
+}
+
+
+/**
+ * @brief Reorder several frames over several threads
+ *
+ * @param layout Layout of the raw frames (see dsp_layout_init)
+ * @param raw First raw frame of each device of the device map (indexed by device ID)
+ * @param rawStride Distance between two raw frames of a device (bytes)
+ * @param numFrames Number of frames
+ * @param cube Cubes (numFrames x layout->cubeSize floats)
+ * @param threads Number of threads (0: one per CPU)
+ * @return int32_t 0 on success, -1 on failure
+ */
+int32_t dsp_cube_frames(const dspLayout_t *layout, const uint8_t *const raw[DSP_MAX_DEVICES],
+                        size_t rawStride, uint32_t numFrames, float *cube, uint8_t threads) {
+  dspCubeJob_t jobs[DSP_MAX_THREADS];
+  pthread_t tids[DSP_MAX_THREADS];
+  uint32_t first = 0;
+  int32_t status = 0;
+  uint8_t started = 0;
+
+  for (uint8_t devId = 0; devId < DSP_MAX_DEVICES; devId++) {
+    if ((layout->deviceMap & (1U << devId)) && (raw[devId] == NULL)) return -1;
+  }
+  if (threads == 0) {
+    long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+    threads = (cpus > 0) ? (uint8_t)((cpus < DSP_MAX_THREADS) ? cpus : DSP_MAX_THREADS) : 1;
+  }
+  if (threads > DSP_MAX_THREADS) threads = DSP_MAX_THREADS;
+  if (threads > numFrames) threads = (numFrames > 0) ? numFrames : 1;
+
+  for (uint8_t t = 0; t < threads; t++) {
+    jobs[t].layout = layout;
+    jobs[t].raw = raw;
+    jobs[t].rawStride = rawStride;
+    jobs[t].first = first;
+    jobs[t].count = numFrames / threads + ((t < numFrames % threads) ? 1 : 0);
+    jobs[t].cube = cube;
+    jobs[t].stream = dsp_cube_stream(layout, cube);
+    jobs[t].status = -1;
+    first += jobs[t].count;
+  }
+
+  // The calling thread takes the first share
+  for (uint8_t t = 1; t < threads; t++) {
+    if (pthread_create(&tids[t], NULL, dsp_cube_worker, &jobs[t]) != 0) break;
+    started = t;
+  }
+  dsp_cube_worker(&jobs[0]);
+  for (uint8_t t = 1; t <= started; t++) pthread_join(tids[t], NULL);
+  // Shares of the threads that could not be started
+  for (uint8_t t = started + 1; t < threads; t++) dsp_cube_worker(&jobs[t]);
+
+  for (uint8_t t = 0; t < threads; t++) {
+    if (jobs[t].status != 0) status = -1;
+  }
+  return status;
+}
+
+
+/**
+ * @brief Name of the reorder kernel in use
+ *
+ * @param layout Layout of the raw frames
+ * @return const char* Kernel name
+ */
+const char* dsp_cube_kernel(const dspLayout_t *layout) {
+  if (!layout->complex || (!layout->chInterleave && (layout->numRx != 4) && (layout->numRx != 1))) {
+    return "generic";
+  }
+  return dsp_kernels()->name;
+}
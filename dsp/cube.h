@@ -0,0 +1,127 @@
+/**
+ * @file cube.h
+ * @brief Reorder of the raw ADC data into MIMO virtual array cubes
+ * @version 0.1
+ * @date 2026-10-14
+ *
+ * @copyright Copyright (c) 2026
+ *
+ * Each device of the cascade records every chirp of the frame on its RX
+ * channels, while a single TX of a single device transmits (TDM MIMO, see
+ * buildMimoChirpTable in mimo.c). The raw frame of a device is laid out as:
+ *
+ *    [loop][chirp][sample][rx][I/Q]   (chInterleave = 0, interleaved)
+ *    [loop][chirp][rx][sample][I/Q]   (chInterleave = 1, non-interleaved)
+ *
+ * with 16-bit values, or 12-bit values packed by pairs into 3 bytes when
+ * the TDA data packing is enabled. The frames are reordered into cubes of
+ * complex float values:
+ *
+ *    [frame][loop][tx][rx][sample][re/im]
+ *
+ * where tx is the virtual TX (ordered by device, then by TX of the
+ * device) and rx the RX channel of the cascade (ordered by device, then by
+ * RX of the device): 12 x 16 virtual antennas for 4 devices of 3 TX and
+ * 4 RX each.
+ *
+ * The reorder is vectorized (SSE2/AVX2 on x86-64, selected at run time,
+ * or NEON) and the frames are spread over several threads. The 12-bit
+ * values are unpacked by small chunks, converted while in L1.
+ *
+ * On x86-64, dsp_cube_frames stores the cubes bypassing the caches when
+ * they are 64-byte aligned and the number of samples is a multiple of 8:
+ * allocate them with aligned_alloc(64, ...) when they are not processed
+ * right away.
+ */
+#ifndef MMWAVE_DSP_CUBE_H
+#define MMWAVE_DSP_CUBE_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+/* Maximum number of devices of a cascade */
+#define DSP_MAX_DEVICES         (4U)
+
+/* Number of TX and maximum number of RX channels per device */
+#define DSP_NUM_TX              (3U)
+#define DSP_MAX_RX              (4U)
+
+/* Maximum number of chirps per loop */
+#define DSP_MAX_CHIRPS          (64U)
+
+/* Maximum number of reorder threads */
+#define DSP_MAX_THREADS         (16U)
+
+
+/** Layout of the raw frames */
+typedef struct dspLayout {
+
+  /* Filled by the caller (from the recorded configuration) */
+
+  // Devices of the frame (1: Master, 2: Slave1, 4: Slave2, 8: Slave3)
+  uint8_t deviceMap;
+
+  // RX channels enabled on each device
+  uint8_t rxChannelEn;
+
+  // Number of ADC samples per chirp
+  uint16_t numSamples;
+
+  // Number of loops per frame
+  uint16_t numLoops;
+
+  // Number of chirps per loop
+  uint16_t numChirps;
+
+  // TX enabled by each chirp of each device (rlChirpCfg_t.txEnable)
+  uint16_t chirpTx[DSP_MAX_DEVICES][DSP_MAX_CHIRPS];
+
+  // 1: Q first (rlDevDataFmtCfg_t.iqSwapSel)
+  uint8_t iqSwap;
+
+  // 1: non-interleaved RX channels (rlDevDataFmtCfg_t.chInterleave)
+  uint8_t chInterleave;
+
+  // 1: complex samples, 0: real samples
+  uint8_t complex;
+
+  // 1: 12-bit packed values (rlTdaArmCfg_t.dataPacking)
+  uint8_t packed12;
+
+  /* Computed by dsp_layout_init */
+
+  uint8_t numDevices;
+  uint8_t numRx;
+  uint8_t numTx;
+
+  // Virtual TX of each chirp
+  uint8_t txSlot[DSP_MAX_CHIRPS];
+
+  // Position of each device in the cascade (RX channel ordering)
+  uint8_t devSlot[DSP_MAX_DEVICES];
+
+  // Size of a raw chirp and of a raw frame of a device (bytes)
+  uint32_t chirpBytes;
+  uint32_t frameBytes;
+
+  // Number of float values of a cube (one frame)
+  size_t cubeSize;
+
+} dspLayout_t;
+
+
+/* Check the layout and compute its derived fields */
+int32_t dsp_layout_init(dspLayout_t *layout);
+
+/* Reorder one frame */
+int32_t dsp_cube_frame(const dspLayout_t *layout, const uint8_t *const raw[DSP_MAX_DEVICES],
+                       float *cube);
+
+/* Reorder several frames over several threads */
+int32_t dsp_cube_frames(const dspLayout_t *layout, const uint8_t *const raw[DSP_MAX_DEVICES],
+                        size_t rawStride, uint32_t numFrames, float *cube, uint8_t threads);
+
+/* Name of the reorder kernel in use */
+const char* dsp_cube_kernel(const dspLayout_t *layout);
+
+#endif
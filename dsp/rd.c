@@ -0,0 +1,390 @@
+/**
+ * @file rd.c
+ * @brief Range/Doppler processing of the MIMO virtual array cubes
+ * @version 0.1
+ * @date 2026-10-14
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <math.h>
+#include "rd.h"
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+
+/**
+ * @brief Next power of two
+ *
+ * @param n Value
+ * @return uint32_t Smallest power of two greater or equal to n
+ */
+static uint32_t dsp_next_pow2(uint32_t n) {
+  uint32_t p = 1;
+  while (p < n) p <<= 1;
+  return p;
+}
+
+
+/**
+ * @brief Allocate the tables of an FFT size
+ *
+ * @param n FFT size (power of two)
+ * @param count Number of input values (window length)
+ * @param window Hann window of count values
+ * @param twiddles exp(-2.i.pi.k/n), k < n/2
+ * @param rev Bit reversal table of n values
+ * @return int32_t 0 on success, -1 on allocation failure
+ */
+static int32_t dsp_fft_tables(uint16_t n, uint16_t count, float **window,
+                              float **twiddles, uint16_t **rev) {
+  uint8_t bits = __builtin_ctz(n);
+
+  *window = malloc(count * sizeof(float));
+  *twiddles = malloc((n / 2 + 1) * 2 * sizeof(float));
+  *rev = malloc(n * sizeof(uint16_t));
+  if ((*window == NULL) || (*twiddles == NULL) || (*rev == NULL)) return -1;
+
+  for (uint16_t i = 0; i < count; i++) {
+    (*window)[i] = (count > 1) ? 0.5f * (1.0f - cosf(2.0f * M_PI * i / (count - 1))) : 1.0f;
+  }
+  for (uint16_t k = 0; k < n / 2; k++) {
+    (*twiddles)[2 * k] = cos(-2.0 * M_PI * k / n);
+    (*twiddles)[2 * k + 1] = sin(-2.0 * M_PI * k / n);
+  }
+  for (uint32_t i = 0; i < n; i++) {
+    uint32_t r = 0;
+    for (uint8_t b = 0; b < bits; b++) r |= ((i >> b) & 1U) << (bits - 1 - b);
+    (*rev)[i] = r;
+  }
+  return 0;
+}
+
+
+/**
+ * @brief Load windowed complex values into an FFT buffer, in bit reversed order
+ *
+ * @param dst FFT buffer (n complex values, zero padded)
+ * @param src First input value
+ * @param stride Distance between two input values (floats)
+ * @param count Number of input values
+ * @param window Window (count values)
+ * @param rev Bit reversal table
+ * @param n FFT size
+ */
+static void dsp_fft_load(float *dst, const float *src, size_t stride, uint16_t count,
+                         const float *window, const uint16_t *rev, uint16_t n) {
+  memset(dst, 0, (size_t)n * 2 * sizeof(float));
+  for (uint16_t i = 0; i < count; i++) {
+    const float *v = src + i * stride;
+    dst[2 * rev[i]] = v[0] * window[i];
+    dst[2 * rev[i] + 1] = v[1] * window[i];
+  }
+}
+
+
+/**
+ * @brief In place radix-2 FFT of bit reversed complex values
+ *
+ * @param x FFT buffer (n interleaved complex values)
+ * @param n FFT size (power of two)
+ * @param twiddles Twiddles of the size
+ */
+static void dsp_fft(float *x, uint16_t n, const float *twiddles) {
+  for (uint32_t half = 1; half < n; half <<= 1) {
+    const uint32_t step = n / (2 * half);
+    for (uint32_t k = 0; k < n; k += 2 * half) {
+      float *a = x + 2 * k;
+      float *b = a + 2 * half;
+      for (uint32_t j = 0; j < half; j++) {
+        const float wr = twiddles[2 * j * step];
+        const float wi = twiddles[2 * j * step + 1];
+        const float tr = b[2 * j] * wr - b[2 * j + 1] * wi;
+        const float ti = b[2 * j] * wi + b[2 * j + 1] * wr;
+        b[2 * j] = a[2 * j] - tr;
+        b[2 * j + 1] = a[2 * j + 1] - ti;
+        a[2 * j] += tr;
+        a[2 * j + 1] += ti;
+      }
+    }
+  }
+}
+
+
+/**
+ * @brief Allocate the plan of a layout
+ *
+ * @param plan Plan to initialize
+ * @param layout Layout of the raw frames (see dsp_layout_init)
+ * @param scale DSP_RD_LINEAR or DSP_RD_DB
+ * @return int32_t 0 on success, -1 on failure
+ */
+int32_t dsp_rd_plan_init(dspRdPlan_t *plan, const dspLayout_t *layout, uint8_t scale) {
+  memset(plan, 0, sizeof(*plan));
+  if ((layout->cubeSize == 0) || (layout->numSamples > DSP_RD_MAX_FFT) ||
+      (layout->numLoops > DSP_RD_MAX_FFT)) {
+    return -1;
+  }
+  plan->layout = *layout;
+  plan->rangeFft = dsp_next_pow2(layout->numSamples);
+  plan->dopplerFft = dsp_next_pow2(layout->numLoops);
+  plan->numRange = layout->complex ? plan->rangeFft : (plan->rangeFft + 1) / 2;
+  plan->scale = scale;
+  plan->mapSize = (size_t)plan->dopplerFft * plan->numRange;
+
+  if ((dsp_fft_tables(plan->rangeFft, layout->numSamples, &plan->rangeWindow,
+         &plan->rangeTwiddles, &plan->rangeRev) != 0) ||
+      (dsp_fft_tables(plan->dopplerFft, layout->numLoops, &plan->dopplerWindow,
+         &plan->dopplerTwiddles, &plan->dopplerRev) != 0)) {
+    dsp_rd_plan_free(plan);
+    return -1;
+  }
+  return 0;
+}
+
+
+/**
+ * @brief Release a plan
+ *
+ * @param plan Plan initialized by dsp_rd_plan_init
+ */
+void dsp_rd_plan_free(dspRdPlan_t *plan) {
+  free(plan->rangeWindow);
+  free(plan->dopplerWindow);
+  free(plan->rangeTwiddles);
+  free(plan->dopplerTwiddles);
+  free(plan->rangeRev);
+  free(plan->dopplerRev);
+  plan->rangeWindow = plan->dopplerWindow = NULL;
+  plan->rangeTwiddles = plan->dopplerTwiddles = NULL;
+  plan->rangeRev = plan->dopplerRev = NULL;
+}
+
+
+/** Working buffers of a thread */
+typedef struct dspRdScratch {
+  // Range spectra of a channel ([loop][rangeFft] complex values)
+  float *spectra;
+  // Doppler FFTs of a tile of range bins ([DSP_RD_TILE][dopplerFft] complex values)
+  float *tile;
+  // Cube of a frame (raw frames only)
+  float *cube;
+} dspRdScratch_t;
+
+/**
+ * @brief Heatmap of one cube
+ *
+ * @param plan Plan
+ * @param cube Cube of the frame
+ * @param map Heatmap of the frame (plan->mapSize floats)
+ * @param scratch Working buffers
+ */
+static void dsp_rd_frame(const dspRdPlan_t *plan, const float *cube, float *map,
+                         dspRdScratch_t *scratch) {
+  const dspLayout_t *layout = &plan->layout;
+  const uint16_t nr = plan->rangeFft, nd = plan->dopplerFft;
+  const size_t numRxTotal = (size_t)layout->numDevices * layout->numRx;
+  const size_t rxStride = (size_t)layout->numSamples * 2;
+  const size_t loopStride = layout->numTx * numRxTotal * rxStride;
+
+  memset(map, 0, plan->mapSize * sizeof(float));
+  for (uint16_t tx = 0; tx < layout->numTx; tx++) {
+    for (size_t rx = 0; rx < numRxTotal; rx++) {
+      const float *channel = cube + (tx * numRxTotal + rx) * rxStride;
+
+      // Range FFT of each loop
+      for (uint16_t loop = 0; loop < layout->numLoops; loop++) {
+        float *spectrum = scratch->spectra + (size_t)loop * nr * 2;
+        dsp_fft_load(spectrum, channel + loop * loopStride, 2, layout->numSamples,
+          plan->rangeWindow, plan->rangeRev, nr);
+        dsp_fft(spectrum, nr, plan->rangeTwiddles);
+      }
+
+      // Doppler FFT of each range bin, a tile of range bins at a time
+      for (uint16_t r0 = 0; r0 < plan->numRange; r0 += DSP_RD_TILE) {
+        const uint16_t left = plan->numRange - r0;
+        const uint16_t width = (left < DSP_RD_TILE) ? left : DSP_RD_TILE;
+
+        memset(scratch->tile, 0, (size_t)DSP_RD_TILE * nd * 2 * sizeof(float));
+        for (uint16_t loop = 0; loop < layout->numLoops; loop++) {
+          const float *bins = scratch->spectra + ((size_t)loop * nr + r0) * 2;
+          const float w = plan->dopplerWindow[loop];
+          const uint16_t pos = plan->dopplerRev[loop];
+          for (uint16_t j = 0; j < width; j++) {
+            scratch->tile[((size_t)j * nd + pos) * 2] = bins[2 * j] * w;
+            scratch->tile[((size_t)j * nd + pos) * 2 + 1] = bins[2 * j + 1] * w;
+          }
+        }
+        for (uint16_t j = 0; j < width; j++) {
+          float *column = scratch->tile + (size_t)j * nd * 2;
+          dsp_fft(column, nd, plan->dopplerTwiddles);
+          for (uint16_t d = 0; d < nd; d++) {
+            const uint16_t row = (d + nd / 2) % nd;  // Zero velocity in the middle
+            map[(size_t)row * plan->numRange + r0 + j] +=
+              column[2 * d] * column[2 * d] + column[2 * d + 1] * column[2 * d + 1];
+          }
+        }
+      }
+    }
+  }
+
+  if (plan->scale == DSP_RD_DB) {
+    for (size_t i = 0; i < plan->mapSize; i++) map[i] = 10.0f * log10f(map[i] + 1e-12f);
+  }
+}
+
+
+/** Frames processed by a thread */
+typedef struct dspRdJob {
+  const dspRdPlan_t *plan;
+  const float *cubes;
+  const uint8_t *const *raw;
+  size_t rawStride;
+  uint32_t first;
+  uint32_t count;
+  float *maps;
+  int32_t status;
+} dspRdJob_t;
+
+/**
+ * @brief Range/Doppler thread
+ *
+ * @param arg Job
+ * @return void* NULL
+ */
+static void* dsp_rd_worker(void *arg) {
+  dspRdJob_t *job = (dspRdJob_t *)arg;
+  const dspRdPlan_t *plan = job->plan;
+  const dspLayout_t *layout = &plan->layout;
+  const uint8_t *raw[DSP_MAX_DEVICES] = { NULL };
+  dspRdScratch_t scratch;
+  const float *cube;
+
+  job->status = -1;
+  scratch.spectra = malloc((size_t)layout->numLoops * plan->rangeFft * 2 * sizeof(float));
+  scratch.tile = malloc((size_t)DSP_RD_TILE * plan->dopplerFft * 2 * sizeof(float));
+  scratch.cube = (job->raw != NULL) ? malloc(layout->cubeSize * sizeof(float)) : NULL;
+  if ((scratch.spectra == NULL) || (scratch.tile == NULL) ||
+      ((job->raw != NULL) && (scratch.cube == NULL))) {
+    goto done;
+  }
+
+  for (uint32_t f = job->first; f < job->first + job->count; f++) {
+    if (job->raw != NULL) {
+      for (uint8_t devId = 0; devId < DSP_MAX_DEVICES; devId++) {
+        if (job->raw[devId] != NULL) raw[devId] = job->raw[devId] + (size_t)f * job->rawStride;
+      }
+      if (dsp_cube_frame(layout, raw, scratch.cube) != 0) goto done;
+      cube = scratch.cube;
+    } else {
+      cube = job->cubes + (size_t)f * layout->cubeSize;
+    }
+    dsp_rd_frame(plan, cube, job->maps + (size_t)f * plan->mapSize, &scratch);
+  }
+  job->status = 0;
+
+done:
+  free(scratch.spectra);
+  free(scratch.tile);
+  free(scratch.cube);
+  return NULL;
+}
+
+
+/**
+ * @brief Spread frames over several threads
+ *
+ * @param job Template of the jobs (plan, input, maps)
+ * @param numFrames Number of frames
+ * @param threads Number of threads (0: one per CPU)
+ * @return int32_t 0 on success, -1 on failure
+ */
+static int32_t dsp_rd_run(const dspRdJob_t *job, uint32_t numFrames, uint8_t threads) {
+  dspRdJob_t jobs[DSP_MAX_THREADS];
+  pthread_t tids[DSP_MAX_THREADS];
+  uint32_t first = 0;
+  int32_t status = 0;
+  uint8_t started = 0;
+
+  if (threads == 0) {
+    long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+    threads = (cpus > 0) ? (uint8_t)((cpus < DSP_MAX_THREADS) ? cpus : DSP_MAX_THREADS) : 1;
+  }
+  if (threads > DSP_MAX_THREADS) threads = DSP_MAX_THREADS;
+  if (threads > numFrames) threads = (numFrames > 0) ? numFrames : 1;
+
+  for (uint8_t t = 0; t < threads; t++) {
+    jobs[t] = *job;
+    jobs[t].first = first;
+    jobs[t].count = numFrames / threads + ((t < numFrames % threads) ? 1 : 0);
+    jobs[t].status = -1;
+    first += jobs[t].count;
+  }
+
+  // The calling thread takes the first share
+  for (uint8_t t = 1; t < threads; t++) {
+    if (pthread_create(&tids[t], NULL, dsp_rd_worker, &jobs[t]) != 0) break;
+    started = t;
+  }
+  dsp_rd_worker(&jobs[0]);
+  for (uint8_t t = 1; t <= started; t++) pthread_join(tids[t], NULL);
+  // Shares of the threads that could not be started
+  for (uint8_t t = started + 1; t < threads; t++) dsp_rd_worker(&jobs[t]);
+
+  for (uint8_t t = 0; t < threads; t++) {
+    if (jobs[t].status != 0) status = -1;
+  }
+  return status;
+}
+
+
+/**
+ * @brief Heatmaps of several cubes over several threads
+ *
+ * @param plan Plan (see dsp_rd_plan_init)
+ * @param cubes Cubes (numFrames x plan->layout.cubeSize floats)
+ * @param numFrames Number of frames
+ * @param maps Heatmaps (numFrames x plan->mapSize floats)
+ * @param threads Number of threads (0: one per CPU)
+ * @return int32_t 0 on success, -1 on failure
+ */
+int32_t dsp_rd_frames(const dspRdPlan_t *plan, const float *cubes, uint32_t numFrames,
+                      float *maps, uint8_t threads) {
+  dspRdJob_t job = { .plan = plan, .cubes = cubes, .raw = NULL, .maps = maps };
+
+  if (plan->rangeTwiddles == NULL) return -1;
+  return dsp_rd_run(&job, numFrames, threads);
+}
+
+
+/**
+ * @brief Heatmaps of several raw frames
+ *
+ * Each thread reorders its frames into a cube (see dsp_cube_frame) before
+ * their range/Doppler processing, so that the cubes of the whole batch are
+ * never held in memory.
+ *
+ * @param plan Plan (see dsp_rd_plan_init)
+ * @param raw First raw frame of each device of the device map (indexed by device ID)
+ * @param rawStride Distance between two raw frames of a device (bytes)
+ * @param numFrames Number of frames
+ * @param maps Heatmaps (numFrames x plan->mapSize floats)
+ * @param threads Number of threads (0: one per CPU)
+ * @return int32_t 0 on success, -1 on failure
+ */
+int32_t dsp_rd_raw_frames(const dspRdPlan_t *plan, const uint8_t *const raw[DSP_MAX_DEVICES],
+                          size_t rawStride, uint32_t numFrames, float *maps, uint8_t threads) {
+  dspRdJob_t job = { .plan = plan, .raw = raw, .rawStride = rawStride, .maps = maps };
+
+  if (plan->rangeTwiddles == NULL) return -1;
+  for (uint8_t devId = 0; devId < DSP_MAX_DEVICES; devId++) {
+    if ((plan->layout.deviceMap & (1U << devId)) && (raw[devId] == NULL)) return -1;
+  }
+  return dsp_rd_run(&job, numFrames, threads);
+}
@@ -0,0 +1,128 @@
+/**
+ * @file rd.h
+ * @brief Range/Doppler processing of the MIMO virtual array cubes
+ * @version 0.1
+ * @date 2026-10-14
+ *
+ * @copyright Copyright (c) 2026
+ *
+ * Each virtual channel (tx, rx) of a cube (see cube.h) goes through a
+ * windowed range FFT over its ADC samples, then a windowed Doppler FFT over
+ * its loops. The power of the channels is summed into a range-Doppler
+ * heatmap per frame:
+ *
+ *    [frame][doppler][range]
+ *
+ * with the zero velocity bin in the middle of the Doppler axis
+ * (dopplerFft / 2) and `numRange` range bins (the whole spectrum for
+ * complex samples, its first half for real samples).
+ *
+ * The FFT sizes are the next powers of two of the number of samples and of
+ * loops (zero padding). The twiddles, bit reversal tables and windows are
+ * computed once per plan. The Doppler FFTs are run on tiles of range bins
+ * gathered from the range spectra of a channel, so that every cache line
+ * read is fully used. The frames are spread over several threads.
+ */
+#ifndef MMWAVE_DSP_RD_H
+#define MMWAVE_DSP_RD_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include "cube.h"
+
+/* Largest FFT size */
+#define DSP_RD_MAX_FFT          (4096U)
+
+/* Number of range bins per Doppler tile */
+#define DSP_RD_TILE             (8U)
+
+/* Heatmap scale */
+#define DSP_RD_LINEAR           (0U)    // Power
+#define DSP_RD_DB               (1U)    // 10.log10(power)
+
+/* RD map files, written next to the capture containers */
+#define DSP_RD_MAGIC            (0x52574D4DU)   // "MMWR"
+#define DSP_RD_VERSION          (1U)
+#define DSP_RD_FILE_EXTENSION   ".mmwrd"
+
+
+/** Range/Doppler FFT plan */
+typedef struct dspRdPlan {
+
+  // Layout of the raw frames the cubes come from
+  dspLayout_t layout;
+
+  // FFT sizes
+  uint16_t rangeFft;
+  uint16_t dopplerFft;
+
+  // Number of range bins of a heatmap
+  uint16_t numRange;
+
+  // DSP_RD_LINEAR or DSP_RD_DB
+  uint8_t scale;
+
+  // Number of float values of a heatmap (one frame)
+  size_t mapSize;
+
+  // Hann windows (numSamples and numLoops values)
+  float *rangeWindow;
+  float *dopplerWindow;
+
+  // Twiddles (size / 2 complex values) and bit reversal tables
+  float *rangeTwiddles;
+  float *dopplerTwiddles;
+  uint16_t *rangeRev;
+  uint16_t *dopplerRev;
+
+} dspRdPlan_t;
+
+
+/** Header of the RD map files, followed by numFrames float32 heatmaps */
+typedef struct dspRdFileHeader {
+
+  // DSP_RD_MAGIC, DSP_RD_VERSION
+  uint32_t magic;
+  uint16_t version;
+
+  // Size of this structure (offset of the first heatmap)
+  uint16_t headerSize;
+
+  uint32_t numFrames;
+  uint16_t numDoppler;
+  uint16_t numRange;
+
+  // DSP_RD_LINEAR or DSP_RD_DB
+  uint8_t scale;
+
+  // Number of virtual TX and RX channels summed
+  uint8_t numTx;
+  uint8_t numRx;
+  uint8_t reserved0;
+
+  // Range and velocity resolutions (m, m/s)
+  float rangeRes;
+  float dopplerRes;
+
+  uint8_t reserved[36];
+
+} dspRdFileHeader_t;
+
+_Static_assert(sizeof(dspRdFileHeader_t) == 64, "dspRdFileHeader_t must stay 64 bytes");
+
+
+/* Allocate the plan of a layout (see dsp_layout_init) */
+int32_t dsp_rd_plan_init(dspRdPlan_t *plan, const dspLayout_t *layout, uint8_t scale);
+
+/* Release a plan */
+void dsp_rd_plan_free(dspRdPlan_t *plan);
+
+/* Heatmaps of several cubes over several threads */
+int32_t dsp_rd_frames(const dspRdPlan_t *plan, const float *cubes, uint32_t numFrames,
+                      float *maps, uint8_t threads);
+
+/* Heatmaps of several raw frames (reordered into cubes on the fly) */
+int32_t dsp_rd_raw_frames(const dspRdPlan_t *plan, const uint8_t *const raw[DSP_MAX_DEVICES],
+                          size_t rawStride, uint32_t numFrames, float *maps, uint8_t threads);
+
+#endif
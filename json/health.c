@@ -0,0 +1,109 @@
+/**
+ * @file health.c
+ * @brief RF health of a capture (.health.json)
+ * @version 0.1
+ * @date 2026-10-14
+ *
+ * @copyright Copyright (c) 2026
+ *
+ * Written next to the .mmwave.json of each capture from the monitoring
+ * reports aggregated while it was recorded: for each device and monitor,
+ * the number of reports, the failed threshold checks and the last, minimum
+ * and maximum values in the unit of the monitor.
+ */
+
+#include "json.h"
+
+/* Presentation of each aggregate (MMWL_HEALTH_*) */
+static const struct {
+  const char *unit;
+  uint8_t decimals;
+  double scale;
+} health_units[MMWL_HEALTH_COUNT] = {
+  { "C", 0, 1.0 },        /* RX0-3, TX0-2, PM, DIG1, DIG2 */
+  { "dB", 1, 0.1 },       /* RX0-3 at RF1, RF2, RF3 */
+  { "dBm", 1, 0.1 },      /* RF1, RF2, RF3 */
+  { "dBm", 1, 0.1 },
+  { "dBm", 1, 0.1 },
+  { "kHz", 0, 1.0 },      /* Maximum error, failed chirps */
+};
+
+/**
+ * @brief Append an array of values of an aggregate
+ *
+ * @param buf Buffer
+ * @param monitor MMWL_HEALTH_*
+ * @param values Values
+ * @param count Number of values
+ */
+static void health_values(jsonBuf_t *buf, unsigned int monitor, const int32_t *values,
+                          uint8_t count) {
+  json_puts(buf, "[");
+  for (uint8_t i = 0; i < count; i++) {
+    if (i > 0) json_puts(buf, ", ");
+    json_fixed(buf, values[i] * health_units[monitor].scale, health_units[monitor].decimals);
+  }
+  json_puts(buf, "]");
+}
+
+/**
+ * @brief Write the RF health of a capture
+ *
+ * @param filename Output filename
+ * @param snap Reports aggregated over the capture
+ * @param num_devices Number of cascade devices (1-4)
+ * @return int 0 on success, -1 on failure
+ */
+int json_export_health(const char *filename, const mmwlHealthSnapshot_t *snap, int num_devices) {
+  jsonBuf_t buf = { NULL, 0, 0, 0 };
+  int status;
+
+  if ((num_devices < 1) || (num_devices > JSON_MAX_DEVICES)) return -1;
+  json_puts(&buf, "{\n\"devices\": [");
+  for (int dev = 0; dev < num_devices; dev++) {
+    uint8_t first = 1;
+
+    json_puts(&buf, dev ? ",\n" : "\n");
+    json_puts(&buf, "{\"device\": ");
+    json_int(&buf, dev);
+    json_puts(&buf, ", \"dropped\": ");
+    json_int(&buf, snap->dropped[dev]);
+    json_puts(&buf, ", \"monitors\": [");
+    for (unsigned int monitor = 0; monitor < MMWL_HEALTH_COUNT; monitor++) {
+      const mmwlHealthStat_t *stat = &snap->stat[dev][monitor];
+
+      if (stat->reports == 0U) continue;
+      json_puts(&buf, first ? "\n" : ",\n");
+      first = 0;
+      json_puts(&buf, "  {\"name\": ");
+      json_string(&buf, MMWL_healthName(monitor));
+      json_puts(&buf, ", \"unit\": ");
+      json_string(&buf, health_units[monitor].unit);
+      json_puts(&buf, ", \"reports\": ");
+      json_int(&buf, stat->reports);
+      json_puts(&buf, ", \"errors\": ");
+      json_int(&buf, stat->errors);
+      json_puts(&buf, ", \"lastError\": ");
+      json_hex(&buf, stat->lastError);
+      json_puts(&buf, ", \"status\": ");
+      json_hex(&buf, stat->status);
+      json_puts(&buf, ", \"firstTimeStamp\": ");
+      json_int(&buf, stat->firstTimeStamp);
+      json_puts(&buf, ", \"lastTimeStamp\": ");
+      json_int(&buf, stat->lastTimeStamp);
+      json_puts(&buf, ",\n   \"last\": ");
+      health_values(&buf, monitor, stat->last, stat->numValues);
+      json_puts(&buf, ",\n   \"min\": ");
+      health_values(&buf, monitor, stat->min, stat->numValues);
+      json_puts(&buf, ",\n   \"max\": ");
+      health_values(&buf, monitor, stat->max, stat->numValues);
+      json_puts(&buf, "}");
+    }
+    json_puts(&buf, first ? "]}" : "\n]}");
+  }
+  json_puts(&buf, "\n]\n}\n");
+
+  status = buf.failed ? -1 : json_write_file(filename, buf.data, buf.length);
+  json_buf_free(&buf);
+  return status;
+}
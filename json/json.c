@@ -0,0 +1,718 @@
+/**
+ * @file json.c
+ * @brief Serializer of the mmWave Studio configuration (.mmwave.json)
+ * @version 0.1
+ * @date 2026-10-14
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <pthread.h>
+#include "json.h"
+
+/* MIMO chirps of each device (see buildMimoChirpTable in mimo.c) */
+#define JSON_NUM_CHIRPS 12
+
+static const uint8_t chirpTxTable[JSON_MAX_DEVICES][3] = {
+  {11, 10, 9},   // Dev0 - Master
+  {8, 7, 6},     // Dev1
+  {5, 4, 3},     // Dev2
+  {2, 1, 0},     // Dev3
+};
+
+/* Document before and after the creation time */
+static const char json_head[] =
+  "{\n"
+  "  \"configGenerator\": {\n"
+  "    \"createdBy\": \"mmwave-cli\",\n"
+  "    \"createdOn\": \"";
+
+/* Part of the document formatted for the last configuration */
+static jsonBuf_t g_tail = { NULL, 0, 0, 0 };
+static jsonDevConfig_t g_tail_config;
+static int g_tail_devices = 0;
+// Whole document
+static jsonBuf_t g_doc = { NULL, 0, 0, 0 };
+static pthread_mutex_t g_json_lock = PTHREAD_MUTEX_INITIALIZER;
+
+
+/**
+ * @brief Make room for `extra` more bytes
+ *
+ * @param buf Buffer
+ * @param extra Number of bytes to append
+ * @return int 0 on success, -1 on allocation failure
+ */
+static int json_reserve(jsonBuf_t *buf, size_t extra) {
+  size_t size;
+  char *data;
+
+  if (buf->failed) return -1;
+  if (buf->length + extra <= buf->size) return 0;
+  size = (buf->size > 0) ? buf->size : JSON_BUFFER_SIZE;
+  while (size < buf->length + extra) size *= 2;
+  data = realloc(buf->data, size);
+  if (data == NULL) {
+    buf->failed = 1;
+    return -1;
+  }
+  buf->data = data;
+  buf->size = size;
+  return 0;
+}
+
+/**
+ * @brief Append bytes
+ *
+ * @param buf Buffer
+ * @param data Bytes
+ * @param length Number of bytes
+ */
+static void json_write(jsonBuf_t *buf, const char *data, size_t length) {
+  if (json_reserve(buf, length) != 0) return;
+  memcpy(buf->data + buf->length, data, length);
+  buf->length += length;
+}
+
+/**
+ * @brief Append a string
+ *
+ * @param buf Buffer
+ * @param str String
+ */
+void json_puts(jsonBuf_t *buf, const char *str) {
+  json_write(buf, str, strlen(str));
+}
+
+/**
+ * @brief Append a quoted string value, escaping the quotes, backslashes and
+ * control characters
+ *
+ * @param buf Buffer
+ * @param str String
+ */
+void json_string(jsonBuf_t *buf, const char *str) {
+  static const char hex[] = "0123456789ABCDEF";
+  const char *run = str;
+
+  json_write(buf, "\"", 1);
+  for (; *str != '\0'; str++) {
+    unsigned char ch = (unsigned char)*str;
+    if ((ch >= 0x20) && (ch != '"') && (ch != '\\')) continue;
+    json_write(buf, run, str - run);
+    if (ch < 0x20) {
+      char escape[6] = { '\\', 'u', '0', '0', hex[ch >> 4], hex[ch & 0xF] };
+      json_write(buf, escape, sizeof(escape));
+    } else {
+      char escape[2] = { '\\', (char)ch };
+      json_write(buf, escape, sizeof(escape));
+    }
+    run = str + 1;
+  }
+  json_write(buf, run, str - run);
+  json_write(buf, "\"", 1);
+}
+
+/**
+ * @brief Append a decimal integer
+ *
+ * @param buf Buffer
+ * @param value Value
+ */
+void json_int(jsonBuf_t *buf, int64_t value) {
+  char digits[24];
+  char *p = digits + sizeof(digits);
+  uint64_t v = (value < 0) ? -(uint64_t)value : (uint64_t)value;
+
+  do {
+    *--p = '0' + (v % 10);
+    v /= 10;
+  } while (v != 0);
+  if (value < 0) *--p = '-';
+  json_write(buf, p, digits + sizeof(digits) - p);
+}
+
+/**
+ * @brief Append an unsigned integer as a "0x%X" string value
+ *
+ * @param buf Buffer
+ * @param value Value
+ */
+void json_hex(jsonBuf_t *buf, uint32_t value) {
+  static const char hex[] = "0123456789ABCDEF";
+  char digits[12];
+  char *p = digits + sizeof(digits);
+
+  *--p = '"';
+  do {
+    *--p = hex[value & 0xF];
+    value >>= 4;
+  } while (value != 0);
+  *--p = 'x';
+  *--p = '0';
+  *--p = '"';
+  json_write(buf, p, digits + sizeof(digits) - p);
+}
+
+/**
+ * @brief Append a number with a fixed number of decimals
+ *
+ * Same output as printf("%.*f"). Values that are a whole number of
+ * decimal steps (the usual case: 0.5, 100.0...) are formatted from an
+ * integer, the others through snprintf.
+ *
+ * @param buf Buffer
+ * @param value Value
+ * @param decimals Number of decimals
+ */
+void json_fixed(jsonBuf_t *buf, double value, uint8_t decimals) {
+  char text[64];
+  double scale = 1.0;
+  double scaled;
+  int64_t steps;
+  int length;
+
+  for (uint8_t i = 0; i < decimals; i++) scale *= 10.0;
+  scaled = value * scale;
+  if ((decimals <= 3) && !signbit(value) && (scaled < 1e15) &&
+      (fabs(scaled - llround(scaled)) < 1e-6)) {
+    steps = llround(scaled);
+    json_int(buf, steps / (int64_t)scale);
+    if (decimals > 0) {
+      int64_t frac = steps % (int64_t)scale;
+      char digits[4];
+      for (int8_t i = decimals - 1; i >= 0; i--) {
+        digits[i] = '0' + (frac % 10);
+        frac /= 10;
+      }
+      json_write(buf, ".", 1);
+      json_write(buf, digits, decimals);
+    }
+    return;
+  }
+  length = snprintf(text, sizeof(text), "%.*f", decimals, value);
+  if (length > 0) json_write(buf, text, ((size_t)length < sizeof(text)) ? (size_t)length : sizeof(text) - 1);
+}
+
+/**
+ * @brief Release a buffer
+ *
+ * @param buf Buffer
+ */
+void json_buf_free(jsonBuf_t *buf) {
+  free(buf->data);
+  memset(buf, 0, sizeof(*buf));
+}
+
+
+/**
+ * @brief Append a "key": value line
+ */
+static void json_key_int(jsonBuf_t *b, const char *key, int64_t value, const char *end) {
+  json_puts(b, key);
+  json_int(b, value);
+  json_puts(b, end);
+}
+
+static void json_key_hex(jsonBuf_t *b, const char *key, uint32_t value, const char *end) {
+  json_puts(b, key);
+  json_hex(b, value);
+  json_puts(b, end);
+}
+
+static void json_key_fixed(jsonBuf_t *b, const char *key, double value, uint8_t decimals,
+                           const char *end) {
+  json_puts(b, key);
+  json_fixed(b, value, decimals);
+  json_puts(b, end);
+}
+
+/**
+ * @brief Append a profile of the rlProfiles array
+ *
+ * @param b Buffer
+ * @param profile Profile
+ * @param last Last profile of the array
+ */
+static void json_profile(jsonBuf_t *b, const rlProfileCfg_t *profile, uint8_t last) {
+  // Derived values, in single precision as mmWave Studio exports them
+  float startFreq_GHz = (profile->startFreqConst * 53.6441803) / (1000.0 * 1000.0 * 1000.0);
+  float freqSlope_MHz_usec = (profile->freqSlopeConst * 48.2797623) / 1000.0;
+  float idleTime_usec = profile->idleTimeConst * 0.01; // 1 LSB = 10ns
+  float adcStartTime_usec = profile->adcStartTimeConst * 0.01;
+  float rampEndTime_usec = profile->rampEndTime * 0.01;
+  float txStartTime_usec = profile->txStartTime * 0.01;
+
+  json_puts(b,
+    "          {\n"
+    "            \"rlProfileCfg_t\": {\n");
+  json_key_int(b, "              \"profileId\": ", profile->profileId, ",\n");
+  json_key_hex(b, "              \"pfVcoSelect\": ", profile->pfVcoSelect, ",\n");
+  json_puts(b, "              \"pfCalLutUpdate\": \"0x0\",\n");
+  json_key_fixed(b, "              \"startFreqConst_GHz\": ", startFreq_GHz, 16, ",\n");
+  json_key_fixed(b, "              \"idleTimeConst_usec\": ", idleTime_usec, 1, ",\n");
+  json_key_fixed(b, "              \"adcStartTimeConst_usec\": ", adcStartTime_usec, 16, ",\n");
+  json_key_fixed(b, "              \"rampEndTime_usec\": ", rampEndTime_usec, 15, ",\n");
+  json_key_hex(b, "              \"txOutPowerBackoffCode\": ", profile->txOutPowerBackoffCode, ",\n");
+  json_key_hex(b, "              \"txPhaseShifter\": ", profile->txPhaseShifter, ",\n");
+  json_key_fixed(b, "              \"freqSlopeConst_MHz_usec\": ", freqSlope_MHz_usec, 15, ",\n");
+  json_key_fixed(b, "              \"txStartTime_usec\": ", txStartTime_usec, 1, ",\n");
+  json_key_int(b, "              \"numAdcSamples\": ", profile->numAdcSamples, ",\n");
+  json_key_fixed(b, "              \"digOutSampleRate\": ", (float)profile->digOutSampleRate, 1, ",\n");
+  json_key_int(b, "              \"hpfCornerFreq1\": ", profile->hpfCornerFreq1, ",\n");
+  json_key_int(b, "              \"hpfCornerFreq2\": ", profile->hpfCornerFreq2, ",\n");
+  json_key_hex(b, "              \"rxGain_dB\": ", profile->rxGain, "\n");
+  json_puts(b, "            }\n");
+  json_puts(b, last ? "          }\n" : "          },\n");
+}
+
+/**
+ * @brief Format the RF and raw data configuration of a device
+ *
+ * @param b Buffer
+ * @param config Configuration
+ * @param devId Device
+ * @param last Last device of the document
+ */
+static void json_device(jsonBuf_t *b, const jsonDevConfig_t *config, int devId, uint8_t last) {
+  const rlAdvFrameCfg_t *adv = &config->advFrameCfg;
+  uint8_t numSubFrames = adv->frameSeq.numOfSubFrames;
+  float framePeriodicity_msec = (config->frameCfg.framePeriodicity * 5.0) / (1000.0 * 1000.0);
+
+  json_puts(b, "    {\n");
+  json_key_int(b, "      \"mmWaveDeviceId\": ", devId, ",\n");
+  json_puts(b,
+    "      \"rfConfig\": {\n"
+    "        \"waveformType\": \"");
+  json_puts(b, (numSubFrames > 0) ? "advancedFrameChirp" : "legacyFrameChirp");
+  json_puts(b, "\",\n"
+    "        \"MIMOScheme\": \"TDM\",\n"
+    "        \"rlCalibrationDataFile\": \"\",\n");
+
+  // Channel Config
+  json_puts(b, "        \"rlChanCfg_t\": {\n");
+  json_key_hex(b, "          \"rxChannelEn\": ", config->channelCfg.rxChannelEn, ",\n");
+  json_key_hex(b, "          \"txChannelEn\": ", config->channelCfg.txChannelEn, ",\n");
+  json_key_int(b, "          \"cascading\": ", devId == 0 ? 1 : 2, ",\n"); // Master=1, Slave=2
+  json_puts(b,
+    "          \"cascadingPinoutCfg\": \"0x0\"\n"
+    "        },\n");
+
+  // ADC Out Config
+  json_puts(b,
+    "        \"rlAdcOutCfg_t\": {\n"
+    "          \"fmt\": {\n");
+  json_key_int(b, "            \"b2AdcBits\": ", config->adcOutCfg.fmt.b2AdcBits, ",\n");
+  json_key_int(b, "            \"b8FullScaleReducFctr\": ", config->adcOutCfg.fmt.b8FullScaleReducFctr, ",\n");
+  json_key_int(b, "            \"b2AdcOutFmt\": ", config->adcOutCfg.fmt.b2AdcOutFmt, "\n");
+  json_puts(b,
+    "          }\n"
+    "        },\n");
+
+  // Low Power Mode Config
+  json_puts(b, "        \"rlLowPowerModeCfg_t\": {\n");
+  json_key_int(b, "          \"lpAdcMode\": ", config->lpmCfg.lpAdcMode, "\n");
+  json_puts(b, "        },\n");
+
+  // Profile Config, one per sub-frame with an advanced frame
+  json_puts(b, "        \"rlProfiles\": [\n");
+  if (numSubFrames == 0) json_profile(b, &config->profileCfg, 1);
+  for (uint8_t sub = 0; sub < numSubFrames; sub++) {
+    json_profile(b, &config->subProfileCfg[sub], sub == numSubFrames - 1);
+  }
+  json_puts(b, "        ],\n");
+
+  // Chirp Config - 12 chirps for MIMO, from index 12 * n for sub-frame n
+  json_puts(b, "        \"rlChirps\": [\n");
+  for (uint8_t sub = 0; sub < ((numSubFrames > 0) ? numSubFrames : 1); sub++) {
+    for (int chirpIdx = 0; chirpIdx < JSON_NUM_CHIRPS; chirpIdx++) {
+      uint8_t txEnable = 0x0;
+      uint8_t last = (chirpIdx == JSON_NUM_CHIRPS - 1) && (sub + 1 >= numSubFrames);
+      for (int tx = 0; tx < 3; tx++) {
+        if (chirpTxTable[devId][tx] == chirpIdx) {
+          txEnable = (1 << tx);
+          break;
+        }
+      }
+      json_puts(b,
+        "          {\n"
+        "            \"rlChirpCfg_t\": {\n");
+      json_key_int(b, "              \"chirpStartIdx\": ", sub * JSON_NUM_CHIRPS + chirpIdx, ",\n");
+      json_key_int(b, "              \"chirpEndIdx\": ", sub * JSON_NUM_CHIRPS + chirpIdx, ",\n");
+      json_key_int(b, "              \"profileId\": ", sub, ",\n");
+      json_puts(b,
+        "              \"startFreqVar_MHz\": 0.0,\n"
+        "              \"freqSlopeVar_KHz_usec\": 0.0,\n"
+        "              \"idleTimeVar_usec\": 0.0,\n"
+        "              \"adcStartTimeVar_usec\": 0.0,\n");
+      json_key_hex(b, "              \"txEnable\": ", txEnable, "\n");
+      json_puts(b, "            }\n");
+      json_puts(b, last ? "          }\n" : "          },\n");
+    }
+  }
+  json_puts(b, "        ],\n");
+
+  // RF Init Calib Config
+  json_puts(b,
+    "        \"rlRfInitCalConf_t\": {\n"
+    "          \"calibEnMask\": \"0x1FF0\"\n"
+    "        },\n");
+
+  // Frame Config
+  json_puts(b, "        \"rlFrameCfg_t\": {\n");
+  json_key_int(b, "          \"chirpEndIdx\": ", config->frameCfg.chirpEndIdx, ",\n");
+  json_key_int(b, "          \"chirpStartIdx\": ", config->frameCfg.chirpStartIdx, ",\n");
+  json_key_int(b, "          \"numLoops\": ", config->frameCfg.numLoops, ",\n");
+  json_key_int(b, "          \"numFrames\": ", config->frameCfg.numFrames, ",\n");
+  json_key_fixed(b, "          \"framePeriodicity_msec\": ", framePeriodicity_msec, 1, ",\n");
+  json_key_int(b, "          \"triggerSelect\": ", devId == 0 ? 1 : 2, ",\n"); // SW trigger for master, HW for slaves
+  json_puts(b,
+    "          \"frameTriggerDelay\": 0.0\n"
+    "        },\n");
+
+  // Advanced Frame Config
+  if (numSubFrames > 0) {
+    json_puts(b,
+      "        \"rlAdvFrameCfg_t\": {\n"
+      "          \"frameSeq\": {\n");
+    json_key_int(b, "            \"forceProfile\": ", adv->frameSeq.forceProfile, ",\n");
+    json_key_int(b, "            \"numFrames\": ", adv->frameSeq.numFrames, ",\n");
+    json_key_int(b, "            \"triggerSelect\": ", devId == 0 ? 1 : 2, ",\n");
+    json_puts(b,
+      "            \"frameTrigDelay_usec\": 0.0,\n"
+      "            \"subFrameCfgs\": [\n");
+    for (uint8_t sub = 0; sub < numSubFrames; sub++) {
+      const rlSubFrameCfg_t *sf = &adv->frameSeq.subFrameCfg[sub];
+      json_puts(b,
+        "              {\n"
+        "                \"rlSubFrameCfg_t\": {\n");
+      json_key_int(b, "                  \"forceProfileIdx\": ", sf->forceProfileIdx, ",\n");
+      json_key_int(b, "                  \"chirpStartIdx\": ", sf->chirpStartIdx, ",\n");
+      json_key_int(b, "                  \"numOfChirps\": ", sf->numOfChirps, ",\n");
+      json_key_int(b, "                  \"numLoops\": ", sf->numLoops, ",\n");
+      json_key_fixed(b, "                  \"burstPeriodicity_msec\": ",
+        (float)((sf->burstPeriodicity * 5.0) / (1000.0 * 1000.0)), 3, ",\n");
+      json_key_int(b, "                  \"chirpStartIdxOffset\": ", sf->chirpStartIdxOffset, ",\n");
+      json_key_int(b, "                  \"numOfBurst\": ", sf->numOfBurst, ",\n");
+      json_key_int(b, "                  \"numOfBurstLoops\": ", sf->numOfBurstLoops, ",\n");
+      json_key_fixed(b, "                  \"subFramePeriodicity_msec\": ",
+        (float)((sf->subFramePeriodicity * 5.0) / (1000.0 * 1000.0)), 3, "\n");
+      json_puts(b, "                }\n");
+      json_puts(b, (sub == numSubFrames - 1) ? "              }\n" : "              },\n");
+    }
+    json_puts(b,
+      "            ],\n"
+      "            \"loopBackCfg\": 0,\n"
+      "            \"subFrameTrigger\": 0\n"
+      "          },\n"
+      "          \"frameData\": {\n");
+    json_key_int(b, "            \"numSubFrames\": ", adv->frameData.numSubFrames, ",\n");
+    json_puts(b, "            \"subframeDataCfg\": [\n");
+    for (uint8_t sub = 0; sub < numSubFrames; sub++) {
+      const rlSubFrameDataCfg_t *sd = &adv->frameData.subframeDataCfg[sub];
+      json_puts(b,
+        "              {\n"
+        "                \"rlSubFrameDataCfg_t\": {\n");
+      json_key_int(b, "                  \"totalChirps\": ", sd->totalChirps, ",\n");
+      json_key_int(b, "                  \"numAdcSamples\": ", sd->numAdcSamples, ",\n");
+      json_key_int(b, "                  \"numChirpsInDataPacket\": ", sd->numChirpsInDataPacket, "\n");
+      json_puts(b, "                }\n");
+      json_puts(b, (sub == numSubFrames - 1) ? "              }\n" : "              },\n");
+    }
+    json_puts(b,
+      "            ]\n"
+      "          }\n"
+      "        },\n");
+  }
+
+  json_puts(b, "        \"rlBpmChirps\": [],\n");
+
+  // Misc Config
+  json_puts(b, "        \"rlRfMiscConf_t\": {\n");
+  json_puts(b, "          \"miscCtl\": \"");
+  json_int(b, (int32_t)config->miscCfg.miscCtl);  // signed, as it has always been exported
+  json_puts(b, "\"\n");
+  json_puts(b,
+    "        },\n"
+    "        \"rlRfPhaseShiftCfgs\": [],\n"
+    "        \"rlRfProgFiltConfs\": [],\n");
+
+  // Test Source (empty template)
+  json_puts(b,
+    "        \"rlTestSource_t\": {\n"
+    "          \"rlTestSourceObjects\": [\n"
+    "            {\n"
+    "              \"rlTestSourceObject_t\": {\n");
+  json_key_fixed(b, "                \"posX_m\": ", 4.0 + devId * 3.0, 1, ",\n");
+  json_key_fixed(b, "                \"posY_m\": ", 3.0 + devId * 2.0, 1, ",\n");
+  json_puts(b,
+    "                \"posZ_m\": 0.0,\n"
+    "                \"velX_m_sec\": 0.0,\n"
+    "                \"velY_m_sec\": 0.0,\n"
+    "                \"velZ_m_sec\": 0.0,\n"
+    "                \"sigLvl_dBFS\": -2.5,\n"
+    "                \"posXMin_m\": -327.0,\n"
+    "                \"posYMin_m\": 0.0,\n"
+    "                \"posZMin_m\": -327.0,\n"
+    "                \"posXMax_m\": 327.0,\n"
+    "                \"posYMax_m\": 327.0,\n"
+    "                \"posZMax_m\": 327.0\n"
+    "              }\n"
+    "            },\n"
+    "            {\n"
+    "              \"rlTestSourceObject_t\": {\n"
+    "                \"posX_m\": 327.0,\n"
+    "                \"posY_m\": 327.0,\n"
+    "                \"posZ_m\": 0.0,\n"
+    "                \"velX_m_sec\": 0.0,\n"
+    "                \"velY_m_sec\": 0.0,\n"
+    "                \"velZ_m_sec\": 0.0,\n"
+    "                \"sigLvl_dBFS\": -95.0,\n"
+    "                \"posXMin_m\": -327.0,\n"
+    "                \"posYMin_m\": 0.0,\n"
+    "                \"posZMin_m\": -327.0,\n"
+    "                \"posXMax_m\": 327.0,\n"
+    "                \"posYMax_m\": 327.0,\n"
+    "                \"posZMax_m\": 327.0\n"
+    "              }\n"
+    "            }\n"
+    "          ],\n"
+    "          \"rlTestSourceRxAntPos\": [\n");
+  for (int rx = 0; rx < 4; rx++) {
+    json_puts(b,
+      "            {\n"
+      "              \"rlTestSourceAntPos_t\": {\n");
+    json_key_fixed(b, "                \"antPosX\": ", rx * 0.5, 1, ",\n");
+    json_puts(b,
+      "                \"antPosZ\": 0.0\n"
+      "              }\n");
+    json_puts(b, (rx < 3) ? "            },\n" : "            }\n");
+  }
+  json_puts(b,
+    "          ],\n"
+    "          \"rlTestSourceTxAntPos\": [\n");
+  for (int tx = 0; tx < 3; tx++) {
+    json_puts(b,
+      "            {\n"
+      "              \"rlTestSourceAntPos_t\": {\n"
+      "                \"antPosX\": 0.0,\n"
+      "                \"antPosZ\": 0.0\n"
+      "              }\n");
+    json_puts(b, (tx < 2) ? "            },\n" : "            }\n");
+  }
+  json_puts(b,
+    "          ],\n"
+    "          \"miscFunCtrl\": 0\n"
+    "        },\n");
+
+  // LDO Bypass Config
+  json_puts(b, "        \"rlRfLdoBypassCfg_t\": {\n");
+  json_key_int(b, "          \"ldoBypassEnable\": ", config->ldoCfg.ldoBypassEnable, ",\n");
+  json_key_int(b, "          \"supplyMonIrDrop\": ", config->ldoCfg.supplyMonIrDrop, ",\n");
+  json_key_int(b, "          \"ioSupplyIndicator\": ", config->ldoCfg.ioSupplyIndicator, "\n");
+  json_puts(b,
+    "        },\n"
+    "        \"rlLoopbackBursts\": [],\n"
+    "        \"rlDynChirpCfgs\": [],\n"
+    "        \"rlDynPerChirpPhShftCfgs\": []\n"
+    "      },\n");
+
+  // Raw Data Capture Config
+  json_puts(b,
+    "      \"rawDataCaptureConfig\": {\n"
+    "        \"rlDevDataFmtCfg_t\": {\n");
+  json_key_int(b, "          \"iqSwapSel\": ", config->dataFmtCfg.iqSwapSel, ",\n");
+  json_key_int(b, "          \"chInterleave\": ", config->dataFmtCfg.chInterleave, "\n");
+  json_puts(b,
+    "        },\n"
+    "        \"rlDevDataPathCfg_t\": {\n");
+  json_key_int(b, "          \"intfSel\": ", config->datapathCfg.intfSel, ",\n");
+  json_key_hex(b, "          \"transferFmtPkt0\": ", config->datapathCfg.transferFmtPkt0, ",\n");
+  json_key_hex(b, "          \"transferFmtPkt1\": ", config->datapathCfg.transferFmtPkt1, ",\n");
+  json_puts(b,
+    "          \"cqConfig\": 0,\n"
+    "          \"cq0TransSize\": 0,\n"
+    "          \"cq1TransSize\": 0,\n"
+    "          \"cq2TransSize\": 0\n"
+    "        },\n"
+    "        \"rlDevDataPathClkCfg_t\": {\n");
+  json_key_int(b, "          \"laneClkCfg\": ", config->datapathClkCfg.laneClkCfg, ",\n");
+  json_key_int(b, "          \"dataRate_Mbps\": ", config->datapathClkCfg.dataRate == 1 ? 600 : 450, "\n");
+  json_puts(b,
+    "        },\n"
+    "        \"rlDevCsi2Cfg_t\": {\n");
+  json_key_hex(b, "          \"lanePosPolSel\": ", config->csi2LaneCfg.lanePosPolSel, ",\n");
+  json_key_int(b, "          \"lineStartEndDis\": ", config->csi2LaneCfg.lineStartEndDis, "\n");
+  json_puts(b,
+    "        }\n"
+    "      },\n"
+    "      \"monitoringConfig\": {\n"
+    "      }\n");
+  json_puts(b, last ? "    }\n" : "    },\n");
+}
+
+/**
+ * @brief Format the document after the creation time
+ *
+ * @param b Buffer (reset)
+ * @param config Configuration
+ * @param num_devices Number of devices
+ */
+static void json_tail(jsonBuf_t *b, const jsonDevConfig_t *config, int num_devices) {
+  b->length = 0;
+  b->failed = 0;
+  json_puts(b,
+    "+09:00\",\n"
+    "    \"isConfigIntermediate\": 1\n"
+    "  },\n"
+    "  \"currentVersion\": {\n"
+    "    \"jsonCfgVersion\": {\n"
+    "      \"major\": 0,\n"
+    "      \"minor\": 4,\n"
+    "      \"patch\": 0\n"
+    "    },\n"
+    "    \"DFPVersion\": {\n"
+    "      \"major\": 2,\n"
+    "      \"minor\": 2,\n"
+    "      \"patch\": 0\n"
+    "    },\n"
+    "    \"SDKVersion\": {\n"
+    "      \"major\": 3,\n"
+    "      \"minor\": 3,\n"
+    "      \"patch\": 0\n"
+    "    },\n"
+    "    \"mmwavelinkVersion\": {\n"
+    "      \"major\": 2,\n"
+    "      \"minor\": 2,\n"
+    "      \"patch\": 0\n"
+    "    }\n"
+    "  },\n"
+    "  \"lastBackwardCompatibleVersion\": {\n"
+    "    \"DFPVersion\": {\n"
+    "      \"major\": 2,\n"
+    "      \"minor\": 1,\n"
+    "      \"patch\": 0\n"
+    "    },\n"
+    "    \"SDKVersion\": {\n"
+    "      \"major\": 3,\n"
+    "      \"minor\": 0,\n"
+    "      \"patch\": 0\n"
+    "    },\n"
+    "    \"mmwavelinkVersion\": {\n"
+    "      \"major\": 2,\n"
+    "      \"minor\": 1,\n"
+    "      \"patch\": 0\n"
+    "    }\n"
+    "  },\n"
+    "  \"regulatoryRestrictions\": {\n"
+    "    \"frequencyRangeBegin_GHz\": 77,\n"
+    "    \"frequencyRangeEnd_GHz\": 81,\n"
+    "    \"maxBandwidthAllowed_MHz\": 4000,\n"
+    "    \"maxTransmitPowerAllowed_dBm\": 12\n"
+    "  },\n"
+    "  \"systemConfig\": {\n"
+    "    \"summary\": \"Configuration exported from mmwave-cli\",\n"
+    "    \"sceneParameters\": {\n"
+    "      \"ambientTemperature_degC\": 20,\n"
+    "      \"maxDetectableRange_m\": 10,\n"
+    "      \"rangeResolution_cm\": 5,\n"
+    "      \"maxVelocity_kmph\": 26,\n"
+    "      \"velocityResolution_kmph\": 2,\n"
+    "      \"measurementRate\": 10,\n"
+    "      \"typicalDetectedObjectRCS\": 1.0\n"
+    "    }\n"
+    "  },\n"
+    "  \"mmWaveDevices\": [\n");
+
+  for (int devId = 0; devId < num_devices; devId++) {
+    json_device(b, config, devId, devId == num_devices - 1);
+  }
+
+  json_puts(b,
+    "  ],\n"
+    "  \"processingChainConfig\": {\n"
+    "    \"detectionChain\": {\n"
+    "      \"name\": \"TI_GenericChain\",\n"
+    "      \"detectionLoss\": 1,\n"
+    "      \"systemLoss\": 1,\n"
+    "      \"implementationMargin\": 2,\n"
+    "      \"detectionSNR\": 12,\n"
+    "      \"theoreticalRxAntennaGain\": 9,\n"
+    "      \"theoreticalTxAntennaGain\": 9\n"
+    "    }\n"
+    "  }\n"
+    "}\n");
+}
+
+/**
+ * @brief Write a buffer into a file atomically
+ *
+ * @param filename Destination
+ * @param data Content
+ * @param length Number of bytes
+ * @return int 0 on success, -1 on failure
+ */
+int json_write_file(const char *filename, const char *data, size_t length) {
+  char tmp_path[512];
+  size_t done = 0;
+  int fd;
+
+  snprintf(tmp_path, sizeof(tmp_path), "%s.tmp", filename);
+  fd = open(tmp_path, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+  if (fd < 0) return -1;
+  while (done < length) {
+    ssize_t n = write(fd, data + done, length - done);
+    if (n <= 0) break;
+    done += n;
+  }
+  if ((close(fd) != 0) || (done != length) || (rename(tmp_path, filename) != 0)) {
+    unlink(tmp_path);
+    return -1;
+  }
+  return 0;
+}
+
+/**
+ * @brief Write the configuration document of num_devices devices
+ *
+ * @param filename Output JSON filename
+ * @param config Configuration (zero the padding: it is compared with memcmp)
+ * @param num_devices Number of cascade devices (1-4)
+ * @return int 0 on success, -1 on failure
+ */
+int json_export_config(const char *filename, const jsonDevConfig_t *config, int num_devices) {
+  char timestamp[64];
+  time_t now = time(NULL);
+  struct tm tm_info;
+  int status = 0;
+
+  if ((num_devices < 1) || (num_devices > JSON_MAX_DEVICES)) return -1;
+  localtime_r(&now, &tm_info);
+  strftime(timestamp, sizeof(timestamp), "%Y-%m-%dT%H:%M:%S", &tm_info);
+
+  pthread_mutex_lock(&g_json_lock);
+  if ((g_tail_devices != num_devices) || (memcmp(&g_tail_config, config, sizeof(*config)) != 0)) {
+    json_tail(&g_tail, config, num_devices);
+    g_tail_config = *config;
+    g_tail_devices = g_tail.failed ? 0 : num_devices;
+  }
+
+  g_doc.length = 0;
+  g_doc.failed = 0;
+  json_write(&g_doc, json_head, sizeof(json_head) - 1);
+  json_puts(&g_doc, timestamp);
+  json_write(&g_doc, g_tail.data, g_tail.length);
+  if (g_tail.failed || g_doc.failed ||
+      (json_write_file(filename, g_doc.data, g_doc.length) != 0)) {
+    status = -1;
+  }
+  pthread_mutex_unlock(&g_json_lock);
+  return status;
+}
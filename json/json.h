@@ -0,0 +1,94 @@
+/**
+ * @file json.h
+ * @brief Serializer of the mmWave Studio configuration (.mmwave.json)
+ * @version 0.1
+ * @date 2026-10-14
+ *
+ * @copyright Copyright (c) 2026
+ *
+ * The document is formatted into a preallocated buffer and written with a
+ * single write() into a temporary file renamed over the destination, so a
+ * reader never sees a partial document. Only the creation time changes
+ * from one capture to the next: the rest of the document is formatted once
+ * per configuration and reused as long as the configuration is unchanged.
+ *
+ * The serializer is shared by the CLI (export_config_to_json in mimo.c)
+ * and the Python module (mmw_export_json in mmwcas.pyx), which fill a
+ * jsonDevConfig_t from their device configuration.
+ */
+#ifndef MMWAVE_JSON_H
+#define MMWAVE_JSON_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include "../ti/mmwavelink/mmwavelink.h"
+#include "../ti/mmwave/mmwl_health.h"
+
+/* Initial size of the document buffer */
+#define JSON_BUFFER_SIZE        (64 * 1024)
+
+/* Maximum number of devices of a document */
+#define JSON_MAX_DEVICES        (4)
+
+
+/** Configuration blocks exported into the document */
+typedef struct jsonDevConfig {
+  rlProfileCfg_t profileCfg;
+  rlFrameCfg_t frameCfg;
+  rlChanCfg_t channelCfg;
+  rlAdcOutCfg_t adcOutCfg;
+  rlLowPowerModeCfg_t lpmCfg;
+  rlRfMiscConf_t miscCfg;
+  rlRfLdoBypassCfg_t ldoCfg;
+  rlDevDataFmtCfg_t dataFmtCfg;
+  rlDevDataPathCfg_t datapathCfg;
+  rlDevDataPathClkCfg_t datapathClkCfg;
+  rlDevCsi2Cfg_t csi2LaneCfg;
+  // Advanced frame (frameSeq.numOfSubFrames 0: legacy frame) and the
+  // profile of each sub-frame
+  rlAdvFrameCfg_t advFrameCfg;
+  rlProfileCfg_t subProfileCfg[RL_MAX_SUBFRAMES];
+} jsonDevConfig_t;
+
+
+/** Growable output buffer */
+typedef struct jsonBuf {
+  char *data;
+  size_t size;
+  size_t length;
+  // Set when an allocation failed (the content is then incomplete)
+  uint8_t failed;
+} jsonBuf_t;
+
+
+/* Append a string */
+void json_puts(jsonBuf_t *buf, const char *str);
+
+/* Append a quoted, escaped string value */
+void json_string(jsonBuf_t *buf, const char *str);
+
+/* Append a decimal integer */
+void json_int(jsonBuf_t *buf, int64_t value);
+
+/* Append an unsigned integer as a "0x%X" string value */
+void json_hex(jsonBuf_t *buf, uint32_t value);
+
+/* Append a number with a fixed number of decimals (printf "%.*f") */
+void json_fixed(jsonBuf_t *buf, double value, uint8_t decimals);
+
+/* Release a buffer */
+void json_buf_free(jsonBuf_t *buf);
+
+/* Write a document into a temporary file renamed over filename */
+int json_write_file(const char *filename, const char *data, size_t length);
+
+/* Write the configuration document of num_devices devices */
+int json_export_config(const char *filename, const jsonDevConfig_t *config, int num_devices);
+
+/* Write the spans and histograms of the profiler as a Chrome trace */
+int json_export_profile(const char *filename);
+
+/* Write the RF health aggregated over a capture */
+int json_export_health(const char *filename, const mmwlHealthSnapshot_t *snap, int num_devices);
+
+#endif
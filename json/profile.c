@@ -0,0 +1,166 @@
+/**
+ * @file profile.c
+ * @brief Chrome trace of the bring-up profiler
+ * @version 0.1
+ * @date 2026-10-14
+ *
+ * @copyright Copyright (c) 2026
+ *
+ * The document loads in chrome://tracing or Perfetto: each device is a
+ * thread of the timeline, the host stages and API calls are on thread 0.
+ * The latency histograms are summarized in the "histograms" array.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include "json.h"
+#include "../ti/ethernet/src/mmwl_prof.h"
+
+/* Thread of the host spans in the timeline */
+#define PROFILE_HOST_TID        (0)
+
+/**
+ * @brief Append a duration in ns as a number of microseconds
+ *
+ * @param buf Buffer
+ * @param ns Duration in ns
+ */
+static void profile_us(jsonBuf_t *buf, uint64_t ns) {
+  char frac[5] = { '.', 0, 0, 0, '\0' };
+
+  json_int(buf, (int64_t)(ns / 1000U));
+  frac[1] = '0' + (ns / 100U) % 10U;
+  frac[2] = '0' + (ns / 10U) % 10U;
+  frac[3] = '0' + ns % 10U;
+  json_puts(buf, frac);
+}
+
+/**
+ * @brief Append the name of a span or histogram
+ *
+ * @param buf Buffer
+ * @param kind Kind of the span
+ * @param key Key of the span
+ * @param name Name of the stage, NULL for the other kinds
+ */
+static void profile_name(jsonBuf_t *buf, uint8_t kind, uint32_t key, const char *name) {
+  char text[48];
+
+  if (name != NULL) {
+    json_string(buf, name);
+    return;
+  }
+  switch (kind) {
+    case TDA_PROF_API:
+    case TDA_PROF_TASK:
+      snprintf(text, sizeof(text), "%s 0x%08X", TDAProfKindName(kind), key);
+      break;
+    case TDA_PROF_MSG:
+    case TDA_PROF_SPI_WRITE:
+    case TDA_PROF_IRQ_WAIT:
+      snprintf(text, sizeof(text), "%s 0x%03X", TDAProfKindName(kind), key);
+      break;
+    default:
+      snprintf(text, sizeof(text), "%s", TDAProfKindName(kind));
+      break;
+  }
+  json_string(buf, text);
+}
+
+/**
+ * @brief Thread of a device in the timeline
+ */
+static int profile_tid(uint8_t device) {
+  return (device == TDA_PROF_HOST) ? PROFILE_HOST_TID : device + 1;
+}
+
+/**
+ * @brief Write the spans and histograms of the profiler as a Chrome trace
+ *
+ * Call once the devices are idle: the spans still being recorded are
+ * skipped.
+ *
+ * @param filename Output filename
+ * @return int 0 on success, -1 on failure
+ */
+int json_export_profile(const char *filename) {
+  jsonBuf_t buf = { NULL, 0, 0, 0 };
+  const TDAProfEvent_t *events;
+  unsigned int dropped;
+  unsigned int count = TDAProfEvents(&events, &dropped);
+  uint64_t origin = UINT64_MAX;
+  uint8_t first = 1;
+  int status;
+
+  for (unsigned int i = 0; i < count; i++) {
+    if (events[i].valid && (events[i].start < origin)) origin = events[i].start;
+  }
+  if (origin == UINT64_MAX) origin = 0;
+
+  json_puts(&buf, "{\n\"displayTimeUnit\": \"ms\",\n\"traceEvents\": [\n");
+  json_puts(&buf, "{\"name\": \"thread_name\", \"ph\": \"M\", \"pid\": 1, \"tid\": 0, "
+                  "\"args\": {\"name\": \"host\"}}");
+  for (int dev = 0; dev < JSON_MAX_DEVICES; dev++) {
+    json_puts(&buf, ",\n{\"name\": \"thread_name\", \"ph\": \"M\", \"pid\": 1, \"tid\": ");
+    json_int(&buf, dev + 1);
+    json_puts(&buf, ", \"args\": {\"name\": \"device ");
+    json_int(&buf, dev);
+    json_puts(&buf, "\"}}");
+  }
+  for (unsigned int i = 0; i < count; i++) {
+    const TDAProfEvent_t *event = &events[i];
+
+    if (!__atomic_load_n(&event->valid, __ATOMIC_ACQUIRE)) continue;
+    json_puts(&buf, ",\n{\"name\": ");
+    profile_name(&buf, event->kind, event->key, event->name);
+    json_puts(&buf, ", \"cat\": \"");
+    json_puts(&buf, TDAProfKindName(event->kind));
+    json_puts(&buf, "\", \"ph\": \"X\", \"ts\": ");
+    profile_us(&buf, event->start - origin);
+    json_puts(&buf, ", \"dur\": ");
+    profile_us(&buf, event->end - event->start);
+    json_puts(&buf, ", \"pid\": 1, \"tid\": ");
+    json_int(&buf, profile_tid(event->device));
+    json_puts(&buf, "}");
+  }
+  json_puts(&buf, "\n],\n\"droppedEvents\": ");
+  json_int(&buf, dropped);
+  json_puts(&buf, ",\n\"histograms\": [");
+
+  // Durations in microseconds
+  for (unsigned int i = 0; i < TDA_PROF_MAX_HISTOGRAMS; i++) {
+    const TDAProfHist_t *hist = TDAProfHistogram(i);
+
+    if (hist == NULL) continue;
+    json_puts(&buf, first ? "\n" : ",\n");
+    first = 0;
+    json_puts(&buf, "{\"kind\": \"");
+    json_puts(&buf, TDAProfKindName(hist->kind));
+    json_puts(&buf, "\", \"name\": ");
+    profile_name(&buf, hist->kind, hist->key, hist->name);
+    json_puts(&buf, ", \"device\": ");
+    json_int(&buf, (hist->device == TDA_PROF_HOST) ? -1 : hist->device);
+    json_puts(&buf, ", \"count\": ");
+    json_int(&buf, (int64_t)hist->count);
+    json_puts(&buf, ", \"total\": ");
+    profile_us(&buf, hist->sum);
+    json_puts(&buf, ", \"mean\": ");
+    profile_us(&buf, hist->sum / hist->count);
+    json_puts(&buf, ", \"min\": ");
+    profile_us(&buf, hist->min);
+    json_puts(&buf, ", \"p50\": ");
+    profile_us(&buf, TDAProfQuantile(hist, 0.50));
+    json_puts(&buf, ", \"p90\": ");
+    profile_us(&buf, TDAProfQuantile(hist, 0.90));
+    json_puts(&buf, ", \"p99\": ");
+    profile_us(&buf, TDAProfQuantile(hist, 0.99));
+    json_puts(&buf, ", \"max\": ");
+    profile_us(&buf, hist->max);
+    json_puts(&buf, "}");
+  }
+  json_puts(&buf, "\n]\n}\n");
+
+  status = buf.failed ? -1 : json_write_file(filename, buf.data, buf.length);
+  json_buf_free(&buf);
+  return status;
+}
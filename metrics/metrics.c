@@ -0,0 +1,556 @@
+/**
+ * @file metrics.c
+ * @brief Prometheus metrics of the long running capture sessions
+ * @version 0.1
+ * @date 2026-10-14
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <netdb.h>
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/time.h>
+#include <sys/un.h>
+#include "metrics.h"
+#include "../ti/ethernet/src/mmwl_prof.h"
+
+/* Name and help of the counters */
+static const char *metrics_counter_name[METRICS_NUM_COUNTERS][2] = {
+  { "mmwave_arm_attempts_total", "TDA arming sequences sent" },
+  { "mmwave_arm_failures_total", "TDA arming sequences failed" },
+  { "mmwave_transfer_bytes_total", "Bytes copied from the DSP board" },
+  { "mmwave_transfer_seconds_total", "Time spent copying the captures" },
+  { "mmwave_transfer_failures_total", "Copies of a capture that failed" },
+  { "mmwave_verify_failures_total", "Copies of a capture that failed the frame check" },
+  { "mmwave_frames_missing_total", "Frames missing from the checked copies" },
+};
+
+/* Upper bounds of the latency histogram buckets (s) */
+static const double metrics_bounds[] = {
+  0.0001, 0.00025, 0.0005, 0.001, 0.0025, 0.005, 0.01, 0.025, 0.05,
+  0.1, 0.25, 0.5, 1.0, 2.5, 5.0, 10.0
+};
+#define METRICS_NUM_BOUNDS      (sizeof(metrics_bounds) / sizeof(metrics_bounds[0]))
+
+/* Devices of the per-device histograms */
+#define METRICS_MAX_DEVICES     (4U)
+
+
+/** Counters of a thread */
+typedef struct metricsSlot {
+
+  // Written by the owner thread only
+  _Atomic uint64_t value[METRICS_NUM_COUNTERS];
+
+  // 1 while a thread owns the slot
+  atomic_uint owned;
+
+} __attribute__((aligned(64))) metricsSlot_t;
+
+
+/** Latency histogram in the exported buckets */
+typedef struct metricsHist {
+  uint64_t buckets[METRICS_NUM_BOUNDS];
+  uint64_t count;
+  uint64_t sum;
+} metricsHist_t;
+
+
+static metricsSlot_t gMetricsSlots[METRICS_MAX_THREADS];
+// Threads without a slot, updated with atomic adds
+static metricsSlot_t gMetricsShared;
+static __thread metricsSlot_t *tMetricsSlot = NULL;
+static pthread_key_t gMetricsKey;
+static pthread_once_t gMetricsOnce = PTHREAD_ONCE_INIT;
+
+static pthread_mutex_t gMetricsLock = PTHREAD_MUTEX_INITIALIZER;
+static struct {
+  metricsCollectFn_t fn;
+  void *arg;
+} gMetricsCollectors[METRICS_MAX_COLLECTORS];
+
+static int gMetricsFd = -1;
+static char gMetricsPath[108] = { 0 };
+
+
+/**
+ * @brief Release the slot of an exiting thread, its counts included
+ */
+static void metrics_release(void *slot) {
+  atomic_store_explicit(&((metricsSlot_t *)slot)->owned, 0, memory_order_release);
+}
+
+
+static void metrics_init_key(void) {
+  pthread_key_create(&gMetricsKey, metrics_release);
+}
+
+
+/**
+ * @brief Slot of the calling thread, claimed on its first count
+ */
+static metricsSlot_t* metrics_slot(void) {
+  if (tMetricsSlot != NULL) return tMetricsSlot;
+
+  pthread_once(&gMetricsOnce, metrics_init_key);
+  for (uint32_t i = 0; i < METRICS_MAX_THREADS; i++) {
+    unsigned int expected = 0;
+    if (atomic_compare_exchange_strong_explicit(&gMetricsSlots[i].owned, &expected, 1,
+          memory_order_acquire, memory_order_relaxed)) {
+      tMetricsSlot = &gMetricsSlots[i];
+      pthread_setspecific(gMetricsKey, tMetricsSlot);
+      return tMetricsSlot;
+    }
+  }
+  tMetricsSlot = &gMetricsShared;
+  return tMetricsSlot;
+}
+
+
+/**
+ * @brief Add to a counter of the calling thread
+ *
+ * @param counter METRICS_*
+ * @param value Increment
+ */
+void metrics_add(uint8_t counter, uint64_t value) {
+  metricsSlot_t *slot;
+
+  if (counter >= METRICS_NUM_COUNTERS) return;
+  slot = metrics_slot();
+  if (slot == &gMetricsShared) {
+    atomic_fetch_add_explicit(&slot->value[counter], value, memory_order_relaxed);
+    return;
+  }
+  // Single writer: no locked read-modify-write
+  atomic_store_explicit(&slot->value[counter],
+    atomic_load_explicit(&slot->value[counter], memory_order_relaxed) + value,
+    memory_order_relaxed);
+}
+
+
+/**
+ * @brief Sum of a counter over all the threads
+ *
+ * @param counter METRICS_*
+ * @return uint64_t Value of the counter
+ */
+uint64_t metrics_get(uint8_t counter) {
+  uint64_t sum;
+
+  if (counter >= METRICS_NUM_COUNTERS) return 0;
+  sum = atomic_load_explicit(&gMetricsShared.value[counter], memory_order_relaxed);
+  for (uint32_t i = 0; i < METRICS_MAX_THREADS; i++) {
+    sum += atomic_load_explicit(&gMetricsSlots[i].value[counter], memory_order_relaxed);
+  }
+  return sum;
+}
+
+
+/**
+ * @brief Register a collector called on each scrape
+ *
+ * @param fn Collector
+ * @param arg Argument of the collector
+ * @return int32_t 0 on success, -1 if all the collectors are in use
+ */
+int32_t metrics_register(metricsCollectFn_t fn, void *arg) {
+  int32_t status = -1;
+
+  pthread_mutex_lock(&gMetricsLock);
+  for (uint32_t i = 0; (i < METRICS_MAX_COLLECTORS) && (status != 0); i++) {
+    if (gMetricsCollectors[i].fn == NULL) {
+      gMetricsCollectors[i].fn = fn;
+      gMetricsCollectors[i].arg = arg;
+      status = 0;
+    }
+  }
+  pthread_mutex_unlock(&gMetricsLock);
+  return status;
+}
+
+
+/**
+ * @brief Remove a collector
+ *
+ * Returns once no scrape uses it anymore.
+ *
+ * @param fn Collector
+ * @param arg Argument it was registered with
+ */
+void metrics_unregister(metricsCollectFn_t fn, void *arg) {
+  pthread_mutex_lock(&gMetricsLock);
+  for (uint32_t i = 0; i < METRICS_MAX_COLLECTORS; i++) {
+    if ((gMetricsCollectors[i].fn == fn) && (gMetricsCollectors[i].arg == arg)) {
+      gMetricsCollectors[i].fn = NULL;
+      gMetricsCollectors[i].arg = NULL;
+    }
+  }
+  pthread_mutex_unlock(&gMetricsLock);
+}
+
+
+/**
+ * @brief Write a label value, escaped
+ *
+ * @param out Output
+ * @param value Label value
+ */
+static void metrics_label(FILE *out, const char *value) {
+  for (const char *p = value; *p != '\0'; p++) {
+    if ((*p == '"') || (*p == '\\')) {
+      fputc('\\', out);
+      fputc(*p, out);
+    } else if (*p == '\n') {
+      fputs("\\n", out);
+    } else {
+      fputc(*p, out);
+    }
+  }
+}
+
+
+/**
+ * @brief Add a profiler histogram to an exported histogram
+ *
+ * @param hist Exported histogram
+ * @param prof Profiler histogram
+ */
+static void metrics_hist_add(metricsHist_t *hist, const TDAProfHist_t *prof) {
+  uint64_t total = 0;
+
+  for (unsigned int i = 0; i < TDA_PROF_HIST_BUCKETS; i++) {
+    total += __atomic_load_n(&prof->buckets[i], __ATOMIC_RELAXED);
+  }
+  // Spans recorded during the scrape must not break the cumulative counts
+  for (uint32_t b = 0; b < METRICS_NUM_BOUNDS; b++) {
+    uint64_t below = TDAProfCountBelow(prof, (uint64_t)(metrics_bounds[b] * 1e9));
+    hist->buckets[b] += (below < total) ? below : total;
+  }
+  hist->count += total;
+  hist->sum += __atomic_load_n(&prof->sum, __ATOMIC_RELAXED);
+}
+
+
+/**
+ * @brief Write the series of a histogram
+ *
+ * @param out Output
+ * @param name Name of the metric
+ * @param labels Labels of the series (without the braces)
+ * @param hist Histogram
+ */
+static void metrics_hist_write(FILE *out, const char *name, const char *labels,
+                               const metricsHist_t *hist) {
+  for (uint32_t b = 0; b < METRICS_NUM_BOUNDS; b++) {
+    fprintf(out, "%s_bucket{%s,le=\"%g\"} %llu\n", name, labels, metrics_bounds[b],
+      (unsigned long long)hist->buckets[b]);
+  }
+  fprintf(out, "%s_bucket{%s,le=\"+Inf\"} %llu\n", name, labels, (unsigned long long)hist->count);
+  fprintf(out, "%s_sum{%s} %.9f\n", name, labels, hist->sum / 1e9);
+  fprintf(out, "%s_count{%s} %llu\n", name, labels, (unsigned long long)hist->count);
+}
+
+
+/**
+ * @brief Write the latency histograms of the profiler
+ *
+ * The stages are exported one by one; the commands and IRQ waits of a
+ * device are summed over the message IDs.
+ *
+ * @param out Output
+ */
+static void metrics_write_latencies(FILE *out) {
+  static const struct {
+    uint8_t kind;
+    const char *name;
+    const char *help;
+  } perDevice[] = {
+    { TDA_PROF_MSG, "mmwave_command_latency_seconds", "Time from a command to its response" },
+    { TDA_PROF_IRQ_WAIT, "mmwave_irq_wait_seconds", "Time from a command to the response IRQ" },
+  };
+  const char *name = "mmwave_stage_duration_seconds";
+  char labels[256];
+
+  fprintf(out, "# HELP %s Duration of the configuration and capture stages\n", name);
+  fprintf(out, "# TYPE %s histogram\n", name);
+  for (unsigned int i = 0; i < TDA_PROF_MAX_HISTOGRAMS; i++) {
+    const TDAProfHist_t *prof = TDAProfHistogram(i);
+    metricsHist_t hist;
+    char *label = NULL;
+    size_t size = 0;
+    FILE *stream;
+
+    if ((prof == NULL) || (prof->kind != TDA_PROF_STAGE) || (prof->name == NULL)) continue;
+    stream = open_memstream(&label, &size);
+    if (stream == NULL) continue;
+    fputs("stage=\"", stream);
+    metrics_label(stream, prof->name);
+    fputc('"', stream);
+    fclose(stream);
+    memset(&hist, 0, sizeof(hist));
+    metrics_hist_add(&hist, prof);
+    metrics_hist_write(out, name, label, &hist);
+    free(label);
+  }
+
+  for (uint32_t k = 0; k < sizeof(perDevice) / sizeof(perDevice[0]); k++) {
+    metricsHist_t hist[METRICS_MAX_DEVICES];
+
+    memset(hist, 0, sizeof(hist));
+    for (unsigned int i = 0; i < TDA_PROF_MAX_HISTOGRAMS; i++) {
+      const TDAProfHist_t *prof = TDAProfHistogram(i);
+      if ((prof == NULL) || (prof->kind != perDevice[k].kind) ||
+          (prof->device >= METRICS_MAX_DEVICES)) {
+        continue;
+      }
+      metrics_hist_add(&hist[prof->device], prof);
+    }
+    fprintf(out, "# HELP %s %s\n", perDevice[k].name, perDevice[k].help);
+    fprintf(out, "# TYPE %s histogram\n", perDevice[k].name);
+    for (uint8_t d = 0; d < METRICS_MAX_DEVICES; d++) {
+      if (hist[d].count == 0) continue;
+      snprintf(labels, sizeof(labels), "device=\"%u\"", d);
+      metrics_hist_write(out, perDevice[k].name, labels, &hist[d]);
+    }
+  }
+}
+
+
+/**
+ * @brief Write all the metrics in the Prometheus text format
+ *
+ * @param out Output
+ */
+void metrics_write(FILE *out) {
+  for (uint8_t c = 0; c < METRICS_NUM_COUNTERS; c++) {
+    uint64_t value = metrics_get(c);
+    const char *name = metrics_counter_name[c][0];
+
+    fprintf(out, "# HELP %s %s\n# TYPE %s counter\n", name, metrics_counter_name[c][1], name);
+    if (c == METRICS_TRANSFER_TIME) {
+      fprintf(out, "%s %.9f\n", name, value / 1e9);
+    } else {
+      fprintf(out, "%s %llu\n", name, (unsigned long long)value);
+    }
+  }
+  if (gTDAProfEnabled) metrics_write_latencies(out);
+
+  pthread_mutex_lock(&gMetricsLock);
+  for (uint32_t i = 0; i < METRICS_MAX_COLLECTORS; i++) {
+    if (gMetricsCollectors[i].fn != NULL) {
+      gMetricsCollectors[i].fn(out, gMetricsCollectors[i].arg);
+    }
+  }
+  pthread_mutex_unlock(&gMetricsLock);
+}
+
+
+/**
+ * @brief Send a buffer to a client
+ *
+ * @param cfd Client socket
+ * @param data Data
+ * @param length Number of bytes
+ * @return int32_t 0 on success, -1 if the client is gone
+ */
+static int32_t metrics_send(int cfd, const char *data, size_t length) {
+  ssize_t n;
+
+  while (length > 0) {
+    n = send(cfd, data, length, MSG_NOSIGNAL);
+    if ((n < 0) && (errno == EINTR)) continue;
+    if (n <= 0) return -1;
+    data += n;
+    length -= n;
+  }
+  return 0;
+}
+
+
+/**
+ * @brief Answer the HTTP request of a client
+ *
+ * @param cfd Client socket
+ */
+static void metrics_serve(int cfd) {
+  char request[METRICS_MAX_REQUEST_SIZE];
+  char header[160];
+  const char *status = "200 OK";
+  char *body = NULL;
+  size_t length = 0, size = 0;
+  FILE *stream;
+  ssize_t n;
+
+  // Request line and headers
+  while (size < sizeof(request) - 1) {
+    n = recv(cfd, request + size, sizeof(request) - 1 - size, 0);
+    if ((n < 0) && (errno == EINTR)) continue;
+    if (n <= 0) break;
+    size += n;
+    request[size] = '\0';
+    if ((strstr(request, "\r\n\r\n") != NULL) || (strstr(request, "\n\n") != NULL)) break;
+  }
+  request[size] = '\0';
+
+  stream = open_memstream(&body, &length);
+  if (stream == NULL) return;
+  if (strncmp(request, "GET ", 4) != 0) {
+    status = "405 Method Not Allowed";
+    fputs("GET /metrics only\n", stream);
+  } else if ((strncmp(request + 4, "/metrics", 8) == 0) &&
+             ((request[12] == ' ') || (request[12] == '?'))) {
+    metrics_write(stream);
+  } else if (strncmp(request + 4, "/ ", 2) == 0) {
+    metrics_write(stream);
+  } else {
+    status = "404 Not Found";
+    fputs("GET /metrics only\n", stream);
+  }
+  fclose(stream);
+
+  snprintf(header, sizeof(header), "HTTP/1.0 %s\r\n"
+    "Content-Type: text/plain; version=0.0.4\r\n"
+    "Content-Length: %zu\r\nConnection: close\r\n\r\n", status, length);
+  if (metrics_send(cfd, header, strlen(header)) == 0) metrics_send(cfd, body, length);
+  free(body);
+}
+
+
+/**
+ * @brief Server thread, one client at a time
+ *
+ * @param arg Listening socket
+ * @return void* NULL
+ */
+static void* metrics_server(void *arg) {
+  struct timeval timeout = { .tv_sec = METRICS_CLIENT_TIMEOUT, .tv_usec = 0 };
+  int sfd = (int)(intptr_t)arg;
+  int cfd;
+
+  for (;;) {
+    cfd = accept4(sfd, NULL, NULL, SOCK_CLOEXEC);
+    if (cfd < 0) {
+      if ((errno == EINTR) || (errno == ECONNABORTED)) continue;
+      return NULL;
+    }
+    // A client that stops talking must not hold the scrapes
+    setsockopt(cfd, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+    setsockopt(cfd, SOL_SOCKET, SO_SNDTIMEO, &timeout, sizeof(timeout));
+    metrics_serve(cfd);
+    close(cfd);
+  }
+}
+
+
+/**
+ * @brief Create the listening socket of an address
+ *
+ * @param listen "[host:]port", or "unix:<path>"
+ * @return int Socket descriptor, -1 on failure
+ */
+static int metrics_listen(const char *address) {
+  int sfd = -1, one = 1;
+
+  if (strncmp(address, "unix:", 5) == 0) {
+    struct sockaddr_un addr;
+    const char *path = address + 5;
+
+    if ((path[0] == '\0') || (strlen(path) >= sizeof(addr.sun_path))) return -1;
+    memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    strcpy(addr.sun_path, path);
+    // Stale socket file of a process that did not exit cleanly
+    unlink(path);
+    sfd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (sfd < 0) return -1;
+    if ((bind(sfd, (struct sockaddr *)&addr, sizeof(addr)) != 0) || (listen(sfd, 4) != 0)) {
+      close(sfd);
+      return -1;
+    }
+    snprintf(gMetricsPath, sizeof(gMetricsPath), "%s", path);
+  } else {
+    struct addrinfo hints, *res = NULL;
+    char host[64] = "";
+    const char *port = strrchr(address, ':');
+
+    if (port != NULL) {
+      size_t len = port - address;
+      if (len >= sizeof(host)) return -1;
+      memcpy(host, address, len);
+      host[len] = '\0';
+      port++;
+    } else {
+      port = address;
+    }
+    memset(&hints, 0, sizeof(hints));
+    hints.ai_family = AF_INET;
+    hints.ai_socktype = SOCK_STREAM;
+    hints.ai_flags = AI_PASSIVE;
+    if (getaddrinfo((host[0] != '\0') ? host : NULL, port, &hints, &res) != 0) return -1;
+    sfd = socket(res->ai_family, res->ai_socktype | SOCK_CLOEXEC, 0);
+    if (sfd >= 0) {
+      setsockopt(sfd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+      if ((bind(sfd, res->ai_addr, res->ai_addrlen) != 0) || (listen(sfd, 4) != 0)) {
+        close(sfd);
+        sfd = -1;
+      }
+    }
+    freeaddrinfo(res);
+  }
+  return sfd;
+}
+
+
+/**
+ * @brief Serve the metrics on a background thread
+ *
+ * A bare port listens on all the interfaces.
+ *
+ * @param listen "[host:]port", or "unix:<path>"
+ * @return int32_t 0 on success, -1 on failure
+ */
+int32_t metrics_start(const char *listen) {
+  pthread_attr_t attr;
+  pthread_t thread;
+  int32_t status = 0;
+
+  if (gMetricsFd >= 0) return -1;
+  gMetricsFd = metrics_listen(listen);
+  if (gMetricsFd < 0) return -1;
+
+  pthread_attr_init(&attr);
+  pthread_attr_setdetachstate(&attr, PTHREAD_CREATE_DETACHED);
+  if (pthread_create(&thread, &attr, metrics_server, (void *)(intptr_t)gMetricsFd) != 0) {
+    metrics_stop();
+    status = -1;
+  }
+  pthread_attr_destroy(&attr);
+  return status;
+}
+
+
+/**
+ * @brief Close the socket (and remove the UNIX socket file)
+ */
+void metrics_stop(void) {
+  if (gMetricsFd >= 0) {
+    shutdown(gMetricsFd, SHUT_RDWR);
+    close(gMetricsFd);
+    gMetricsFd = -1;
+  }
+  if (gMetricsPath[0] != '\0') {
+    unlink(gMetricsPath);
+    gMetricsPath[0] = '\0';
+  }
+}
@@ -0,0 +1,78 @@
+/**
+ * @file metrics.h
+ * @brief Prometheus metrics of the long running capture sessions
+ * @version 0.1
+ * @date 2026-10-14
+ *
+ * @copyright Copyright (c) 2026
+ *
+ * The metrics are served in the Prometheus text format over HTTP, on a TCP
+ * port or on a UNIX socket ("unix:<path>", e.g. for `curl --unix-socket`):
+ *
+ *    GET /metrics
+ *
+ * Counters are incremented by the thread owning them, each thread on its
+ * own slot of relaxed atomics (no lock, no shared cache line between
+ * threads), and summed over the slots on scrape only. A thread that exits
+ * leaves its slot to the next thread, the counts included.
+ *
+ * The latency histograms (stages of check(), command to response time and
+ * IRQ wait of each device) are the ones of the bring-up profiler
+ * (mmwl_prof.h), which is enabled along the metrics. The other metrics,
+ * e.g. the transfer queue of the scheduler, are appended on scrape by the
+ * registered collectors.
+ */
+#ifndef MMWAVE_METRICS_H
+#define MMWAVE_METRICS_H
+
+#include <stdio.h>
+#include <stdint.h>
+
+/* Counters */
+#define METRICS_ARM_ATTEMPTS        (0U)  // TDA arming sequences sent
+#define METRICS_ARM_FAILURES        (1U)  // TDA arming sequences failed (retried by --monitor)
+#define METRICS_TRANSFER_BYTES      (2U)  // Bytes copied from the DSP board
+#define METRICS_TRANSFER_TIME       (3U)  // Time spent copying the captures (ns)
+#define METRICS_TRANSFER_FAILURES   (4U)  // Copies that failed
+#define METRICS_VERIFY_FAILURES     (5U)  // Copies that failed the frame check
+#define METRICS_FRAMES_MISSING      (6U)  // Frames missing from the checked copies
+#define METRICS_NUM_COUNTERS        (7U)
+
+/* Number of counter slots, the threads beyond share an atomic slot */
+#define METRICS_MAX_THREADS         (32U)
+
+/* Maximum number of collectors */
+#define METRICS_MAX_COLLECTORS      (4U)
+
+/* Maximum size of a request (the body is ignored) */
+#define METRICS_MAX_REQUEST_SIZE    (4096U)
+
+/* A client idle for longer than this is disconnected (s) */
+#define METRICS_CLIENT_TIMEOUT      (5U)
+
+/* Appends metrics in the Prometheus text format */
+typedef void (*metricsCollectFn_t)(FILE *out, void *arg);
+
+
+/* Add to a counter of the calling thread */
+void metrics_add(uint8_t counter, uint64_t value);
+
+/* Sum of a counter over all the threads */
+uint64_t metrics_get(uint8_t counter);
+
+/* Register a collector called on each scrape */
+int32_t metrics_register(metricsCollectFn_t fn, void *arg);
+
+/* Remove a collector */
+void metrics_unregister(metricsCollectFn_t fn, void *arg);
+
+/* Write all the metrics in the Prometheus text format */
+void metrics_write(FILE *out);
+
+/* Serve the metrics on "[host:]port" or "unix:<path>" */
+int32_t metrics_start(const char *listen);
+
+/* Close the socket (and remove the UNIX socket file) */
+void metrics_stop(void);
+
+#endif
@@ -22,16 +22,63 @@
  */
 #include "mimo.h"
 #include "toml/config.h"
+#include "ctl/ctl.h"
+#include "sched/sched.h"
+#include "xfer/xfer.h"
+#include "cap/cap.h"
+#include "cap/verify.h"
+#include "cap/align.h"
+#include "dsp/rd.h"
+#include "json/json.h"
+#include "metrics/metrics.h"
+#include <errno.h>
 #include <time.h>
 #include <sys/time.h>
 #include <pthread.h>
 #include <semaphore.h>
+#include <sys/mman.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#include <dirent.h>
+#include <sys/stat.h>
 
 /******************************
  *      CONFIGURATIONS
  ******************************/
 // Global variable to store IP address for logging
 static unsigned char g_ip_addr[32] = {0};
+// Chrome trace written at exit when profiling (--profile), start of the stage
+static char g_profile_path[256] = {0};
+static uint64_t g_profile_stage = 0;
+// Start-frame barrier shared by the board processes (NULL for a single board)
+static boardSync_t *g_board_sync = NULL;
+// Board driven by this process, and number of boards of the session
+static uint8_t g_board_index = 0;
+static uint8_t g_num_boards = 1;
+// Frame triggers of the current capture, written to its alignment index
+static capAlignBoard_t g_align_board;
+static char g_align_path[320] = {0};
+static char g_align_capture[128] = {0};
+// RF health reported by the devices since the last frame start
+static mmwlHealthSnapshot_t g_health;
+// Copy of the captures to the host
+static xferCfg_t g_xfer_cfg = { .host = (const char *)g_ip_addr, .streams = 4 };
+static uint8_t g_xfer_checksum = 0;
+// Configuration the copied captures are checked against (NULL: not checked)
+static const devConfig_t *g_verify_config = NULL;
+// Configuration recorded in the capture containers (NULL: captures not packed)
+static const devConfig_t *g_pack_config = NULL;
+// Range-Doppler maps computed from the capture containers
+static uint8_t g_rdmap = 0;
+/* Codec of the containers (CAP_CODEC_*) and TDA data packing of the captures */
+static uint8_t g_pack_codec = CAP_CODEC_NONE;
+static uint8_t g_pack_packing = 0;
+/* Run the full RF calibration even with valid cached calibration data */
+static uint8_t g_recalibrate = 0;
+// Control socket file of the daemon (removed at exit)
+static char g_daemon_socket[108] = {0};
+// A failed required stage exits the process (cleared while serving the daemon)
+static uint8_t g_check_fatal = TRUE;
 /** Profile config */
 const rlProfileCfg_t profileCfgArgs = {
   .profileId = 0,
@@ -140,6 +187,19 @@ rlDevCsi2Cfg_t csi2LaneCfgArgs = {
   .lanePosPolSel = 0x35421,   // 0b 0011 0101 0100 0010 0001,
 };
 
+/** RF health monitoring config */
+mmwlMonCfg_t monCfgArgs = {
+  .enable = 0,                // Monitors disabled
+  .reportMode = 2,            // Every period, with the threshold check
+  .period = 100,              // Device default (frames)
+  .tempMin = -40,             // C
+  .tempMax = 125,
+  .tempDiff = 20,
+  .rxGainErr = 30,            // 3 dB
+  .txPowerErr = 30,           // 3 dB
+  .synthFreqErr = 400,        // 4 MHz
+};
+
 
 
 /*
@@ -162,54 +222,519 @@ rlDevCsi2Cfg_t csi2LaneCfgArgs = {
 |-------|-------|-------|-------|-------|-------|-------|-------|-------|-------|-------|-------|-------|
 */
 
-typedef struct {
-    char src_path[256];
-    char dst_path[256];
-    int capture_id;
-} transfer_task_t;
+/**
+ * @brief Local copy of a capture directory
+ *
+ * @param buffer Buffer to store the path
+ * @param size Size of the buffer
+ * @param capture_dir Capture directory name
+ */
+void local_capture_path(char *buffer, size_t size, const char *capture_dir) {
+  const char *home = getenv("HOME");
+  snprintf(buffer, size, "%s/mmwave-cli/PostProc/%s",
+    (home != NULL) ? home : ".", capture_dir);
+}
 
-// Thread for SCP transfer
-void* scp_transfer_thread(void* arg) {
-    transfer_task_t* task = (transfer_task_t*)arg;
-    
-    char cmd[512];
-    snprintf(cmd, sizeof(cmd),
-        "scp -O -oHostKeyAlgorithms=+ssh-rsa "
-        "-oPubkeyAcceptedAlgorithms=+ssh-rsa "
-        "-r root@192.168.33.180:%s %s &",
-        task->src_path, task->dst_path);
-    
-    printf("[TRANSFER %d] Starting: %s\n", task->capture_id, cmd);
-    int ret = system(cmd);
-    printf("[TRANSFER %d] Completed with status: %d\n", task->capture_id, ret);
-    
-    free(task);
-    return NULL;
+/**
+ * @brief Copy a capture from the DSP board SSD to the host
+ *
+ * @param task Capture to copy
+ * @return int32_t 0 on success, -1 on failure
+ */
+int32_t transfer_capture(schedTask_t *task) {
+  char src_path[256];
+  char dst_path[256];
+  xferStats_t stats;
+  int32_t status;
+
+  snprintf(src_path, sizeof(src_path), "/mnt/ssd/%s", task->captureDir);
+  local_capture_path(dst_path, sizeof(dst_path), task->captureDir);
+  printf("[TRANSFER #%u] Starting: %s:%s -> %s\n", task->captureId,
+    g_xfer_cfg.host, src_path, dst_path);
+
+  status = xfer_directory(&g_xfer_cfg, src_path, dst_path, &stats);
+  task->bytes = stats.totalBytes;
+  metrics_add(METRICS_TRANSFER_BYTES, stats.bytes);
+  metrics_add(METRICS_TRANSFER_TIME, stats.elapsed);
+  if (status != 0) metrics_add(METRICS_TRANSFER_FAILURES, 1);
+  printf("[TRANSFER #%u] %u files (%u resumed, %u failed) | %.1f MB in %.1f s (%.1f MB/s)\n",
+    task->captureId, stats.files, stats.resumed, stats.failed, stats.bytes / 1e6,
+    stats.elapsed / 1e9, (stats.elapsed > 0) ? stats.bytes * 1e3 / stats.elapsed : 0.0);
+  return status;
 }
 
-// Non-blocking transfer
-int start_async_transfer(const char* capture_dir, int capture_id) {
-    transfer_task_t* task = malloc(sizeof(transfer_task_t));
-    if (!task) return -1;
-    
-    snprintf(task->src_path, sizeof(task->src_path), 
-             "/mnt/ssd/%s", capture_dir);
-    snprintf(task->dst_path, sizeof(task->dst_path),
-             "~/mmwave-cli/PostProc/%s", capture_dir);
-    task->capture_id = capture_id;
-    
-    pthread_t thread;
-    pthread_attr_t attr;
-    pthread_attr_init(&attr);
-    pthread_attr_setdetachstate(&attr, PTHREAD_CREATE_DETACHED);
-    
-    if (pthread_create(&thread, &attr, scp_transfer_thread, task) != 0) {
-        free(task);
+/**
+ * @brief Size of a directory tree
+ *
+ * @param path Directory path
+ * @return int64_t Number of bytes of the regular files, -1 on failure
+ */
+int64_t directory_size(const char *path) {
+  char entry_path[512];
+  struct dirent *entry;
+  struct stat st;
+  int64_t size = 0;
+  DIR *dir = opendir(path);
+
+  if (dir == NULL) return -1;
+  while ((entry = readdir(dir)) != NULL) {
+    if ((strcmp(entry->d_name, ".") == 0) || (strcmp(entry->d_name, "..") == 0)) continue;
+    snprintf(entry_path, sizeof(entry_path), "%s/%s", path, entry->d_name);
+    if (lstat(entry_path, &st) != 0) continue;
+    if (S_ISDIR(st.st_mode)) {
+      int64_t sub = directory_size(entry_path);
+      if (sub > 0) size += sub;
+    } else if (S_ISREG(st.st_mode)) {
+      size += st.st_size;
+    }
+  }
+  closedir(dir);
+  return size;
+}
+
+/**
+ * @brief Frame period of a configuration
+ *
+ * @param config Device configuration
+ * @param numFrames Number of frames of the frame config (0: until stopped)
+ * @return uint64_t Frame period (ns), sum of the sub-frame periods with
+ *    advanced frames
+ */
+uint64_t frame_period(const devConfig_t *config, uint32_t *numFrames) {
+  const rlAdvFrameCfg_t *adv = &config->advFrameCfg;
+  uint64_t period = 0;
+
+  if (adv->frameSeq.numOfSubFrames > 0) {
+    for (uint8_t i = 0; i < adv->frameSeq.numOfSubFrames; i++) {
+      period += adv->frameSeq.subFrameCfg[i].subFramePeriodicity * 5ULL;
+    }
+    *numFrames = adv->frameSeq.numFrames;
+  } else {
+    period = config->frameCfg.framePeriodicity * 5ULL;  // 1 LSB = 5 ns
+    *numFrames = config->frameCfg.numFrames;
+  }
+  return period;
+}
+
+/**
+ * @brief Frame period the TDA is armed with
+ *
+ * @param config Device configuration
+ * @return uint32_t Frame period (ms), see frame_period()
+ */
+uint32_t tda_frame_period(const devConfig_t *config) {
+  uint32_t numFrames;
+
+  return (uint32_t)(frame_period(config, &numFrames) / (1000 * 1000));
+}
+
+/**
+ * @brief Check the frames of a capture against the configuration
+ *
+ * The frame geometry is the one sent to the TDA for the configuration
+ * (setWidthAndHeight), see cap/verify.h for the checks.
+ *
+ * @param dir Capture directory
+ * @param config Device configuration of the capture
+ * @param duration Duration of the recording (ns, 0: unknown)
+ * @param fileTimes 1: without a duration, use the modification times of the files
+ * @param prefix Prefix of the report lines
+ * @return int32_t 0 if all the checks passed, -1 otherwise
+ */
+int32_t verify_frames(const char *dir, const devConfig_t *config, uint64_t duration,
+                      uint8_t fileTimes, const char *prefix) {
+  const rlAdvFrameCfg_t *adv = &config->advFrameCfg;
+  const rlProfileCfg_t *profile = &config->profileCfg;
+  unsigned int numChirps, width = 0, height = 0;
+  capVerifyCfg_t cfg;
+  capVerifyReport_t report;
+  int32_t status;
+
+  memset(&cfg, 0, sizeof(cfg));
+  cfg.framePeriod = frame_period(config, &cfg.numFrames);
+  if (adv->frameSeq.numOfSubFrames > 0) {
+    numChirps = 0;
+    for (uint8_t i = 0; i < adv->frameSeq.numOfSubFrames; i++) {
+      numChirps += adv->frameData.subframeDataCfg[i].totalChirps;
+    }
+    profile = &config->subProfileCfg[0];
+  } else {
+    numChirps = config->frameCfg.numLoops *
+      (config->frameCfg.chirpEndIdx - config->frameCfg.chirpStartIdx + 1);
+  }
+  MMWL_frameGeometry(numChirps, config->channelCfg, config->adcOutCfg, config->datapathCfg,
+    *profile, &width, &height);
+
+  cfg.deviceMap = config->deviceMap;
+  cfg.blockSize = g_pack_packing ? ((uint64_t)width * height * 3) / 2 :
+    (uint64_t)width * height * sizeof(int16_t);
+  cfg.duration = duration;
+  cfg.fileTimes = fileTimes;
+  status = cap_verify(dir, &cfg, &report);
+  cap_verify_print(&report, prefix);
+  for (uint8_t d = 0; d < CAP_MAX_DEVICES; d++) {
+    if (report.deviceMap & (1U << d)) metrics_add(METRICS_FRAMES_MISSING, report.devices[d].missing);
+  }
+  return status;
+}
+
+/**
+ * @brief Pack the local copy of a capture into an indexed container
+ *
+ * The container "<local copy>.mmwcap" is written next to the local copy of
+ * the capture directory. The frame geometry is the one computed when the
+ * devices were configured.
+ *
+ * The header holds one chirp range and one profile: an advanced frame is
+ * only packed when all its sub-frames run the same number of chirps (their
+ * copies of the MIMO chirp table, see configureMimoChirp) with the same
+ * profile. The chirp range is the one of the first sub-frame, the loops of
+ * the sub-frames add up and the period is the sum of the sub-frame periods.
+ *
+ * @param task Copied capture
+ * @param config Device configuration of the capture
+ * @return int32_t 0 on success, -1 on failure
+ */
+int32_t pack_capture(schedTask_t *task, const devConfig_t *config) {
+  char dir_path[256];
+  char cap_path[272];
+  const rlAdvFrameCfg_t *adv = &config->advFrameCfg;
+  const rlProfileCfg_t *profile = &config->profileCfg;
+  capHeader_t header;
+  unsigned int width = 0, height = 0;
+  uint32_t numFrames, numChirps = 0;
+  uint8_t rx = config->channelCfg.rxChannelEn;
+
+  MMWL_getFrameDims(0, &width, &height);
+  if ((width == 0) || (height == 0)) {
+    printf("[CAPTURE #%u] Frame not configured in this session, capture not packed\n",
+      task->captureId);
+    return -1;
+  }
+
+  memset(&header, 0, sizeof(header));
+  header.framePeriodicity = (uint32_t)(frame_period(config, &numFrames) / 5);  // 1 LSB = 5 ns
+  if (adv->frameSeq.numOfSubFrames > 0) {
+    const rlSubFrameCfg_t *first = &adv->frameSeq.subFrameCfg[0];
+
+    profile = &config->subProfileCfg[0];
+    for (uint8_t i = 0; i < adv->frameSeq.numOfSubFrames; i++) {
+      const rlSubFrameCfg_t *sub = &adv->frameSeq.subFrameCfg[i];
+      const rlProfileCfg_t *subProfile = &config->subProfileCfg[i];
+
+      if ((sub->numOfChirps != first->numOfChirps) ||
+          (subProfile->numAdcSamples != profile->numAdcSamples) ||
+          (subProfile->startFreqConst != profile->startFreqConst) ||
+          (subProfile->freqSlopeConst != profile->freqSlopeConst) ||
+          (subProfile->digOutSampleRate != profile->digOutSampleRate) ||
+          (subProfile->idleTimeConst != profile->idleTimeConst) ||
+          (subProfile->adcStartTimeConst != profile->adcStartTimeConst) ||
+          (subProfile->rampEndTime != profile->rampEndTime) ||
+          (subProfile->rxGain != profile->rxGain)) {
+        printf("[CAPTURE #%u] Sub-frames with different chirps or profiles, capture not packed\n",
+          task->captureId);
         return -1;
+      }
+      numChirps += adv->frameData.subframeDataCfg[i].totalChirps;
     }
-    
-    pthread_attr_destroy(&attr);
+    if ((first->numOfChirps == 0) || (numChirps % first->numOfChirps != 0)) {
+      printf("[CAPTURE #%u] Sub-frame chirps not a whole number of loops, capture not packed\n",
+        task->captureId);
+      return -1;
+    }
+    header.numLoops = numChirps / first->numOfChirps;
+    header.chirpStartIdx = first->chirpStartIdx;
+    header.chirpEndIdx = first->chirpStartIdx + first->numOfChirps - 1;
+  } else {
+    header.numLoops = config->frameCfg.numLoops;
+    header.chirpStartIdx = config->frameCfg.chirpStartIdx;
+    header.chirpEndIdx = config->frameCfg.chirpEndIdx;
+  }
+  header.deviceMap = config->deviceMap;
+  header.width = width;
+  header.height = height;
+  header.packing = g_pack_packing;
+  header.blockSize = header.packing ? (width * height * 3) / 2 : width * height * sizeof(int16_t);
+  header.codec = g_pack_codec;
+  header.chInterleave = config->dataFmtCfg.chInterleave;
+  while (rx != 0) {
+    header.numRx += rx & 0x1;
+    rx >>= 1;
+  }
+  header.valsPerSample = ((config->adcOutCfg.fmt.b2AdcOutFmt == 1) ||
+    (config->adcOutCfg.fmt.b2AdcOutFmt == 2)) ? 2 : 1;
+  header.numAdcSamples = profile->numAdcSamples;
+  header.rxChannelEn = config->channelCfg.rxChannelEn;
+  header.txChannelEn = config->channelCfg.txChannelEn;
+  header.startFreqConst = profile->startFreqConst;
+  header.freqSlopeConst = profile->freqSlopeConst;
+  header.digOutSampleRate = profile->digOutSampleRate;
+  header.idleTimeConst = profile->idleTimeConst;
+  header.adcStartTimeConst = profile->adcStartTimeConst;
+  header.rampEndTime = profile->rampEndTime;
+  header.adcBits = config->adcOutCfg.fmt.b2AdcBits;
+  header.adcFmt = config->adcOutCfg.fmt.b2AdcOutFmt;
+  header.rxGain = profile->rxGain;
+  strncpy(header.captureDir, task->captureDir, sizeof(header.captureDir) - 1);
+
+  local_capture_path(dir_path, sizeof(dir_path), task->captureDir);
+  snprintf(cap_path, sizeof(cap_path), "%s%s", dir_path, CAP_FILE_EXTENSION);
+  if (cap_pack(dir_path, cap_path, &header, 0) != 0) {
+    printf("[CAPTURE #%u] Couldn't pack %s\n", task->captureId, dir_path);
+    return -1;
+  }
+  if (header.codec != CAP_CODEC_NONE) {
+    uint64_t raw = (uint64_t)header.numFrames * header.numDevices * header.blockSize;
+    uint64_t coded = header.indexOffset - header.dataOffset;
+    printf("[CAPTURE #%u] Packed %u frames x %u devices into %s (%.1f MB coded into %.1f MB, %.2fx)\n",
+      task->captureId, header.numFrames, header.numDevices, cap_path, raw / 1e6, coded / 1e6,
+      (coded > 0) ? (double)raw / coded : 0.0);
     return 0;
+  }
+  printf("[CAPTURE #%u] Packed %u frames x %u devices into %s\n", task->captureId,
+    header.numFrames, header.numDevices, cap_path);
+  return 0;
+}
+
+// MIMO chirp table of a device (see the MIMO configuration below)
+uint16_t buildMimoChirpTable(uint8_t devId, rlChirpCfg_t chirpCfg, rlChirpCfg_t *table);
+
+/**
+ * @brief Compute the range-Doppler heatmaps of a packed capture
+ *
+ * The heatmaps (in dB) of all the frames of the container are written into
+ * "<local copy>.mmwrd", see dsp/rd.h for the format. The frames are
+ * processed by batches spread over all the CPUs.
+ *
+ * @param task Packed capture
+ * @param config Device configuration of the capture
+ * @return int32_t 0 on success, -1 on failure
+ */
+int32_t rdmap_capture(schedTask_t *task, const devConfig_t *config) {
+  const uint32_t batch = 16;
+  const double c = 299792458.0;
+  char dir_path[256];
+  char cap_path[272];
+  char rd_path[272];
+  char part_path[280];
+  rlChirpCfg_t table[NUM_CHIRPS];
+  const uint8_t *raw[DSP_MAX_DEVICES] = { NULL };
+  const uint8_t *batchRaw[DSP_MAX_DEVICES] = { NULL };
+  const capHeader_t *h;
+  capReader_t reader;
+  dspLayout_t layout;
+  dspRdPlan_t plan;
+  dspRdFileHeader_t header;
+  double slope, lambda, loopTime;
+  size_t rawStride, blockValues;
+  int16_t *decoded = NULL;
+  float *maps = NULL;
+  FILE *out = NULL;
+  uint8_t coded;
+  int32_t status = -1;
+
+  local_capture_path(dir_path, sizeof(dir_path), task->captureDir);
+  snprintf(cap_path, sizeof(cap_path), "%s%s", dir_path, CAP_FILE_EXTENSION);
+  snprintf(rd_path, sizeof(rd_path), "%s%s", dir_path, DSP_RD_FILE_EXTENSION);
+  snprintf(part_path, sizeof(part_path), "%s.part", rd_path);
+  memset(&plan, 0, sizeof(plan));
+  if (config->advFrameCfg.frameSeq.numOfSubFrames > 0) {
+    // The heatmaps of a sub-frame would need a plan per profile
+    printf("[CAPTURE #%u] Advanced frame capture, no range-Doppler maps\n", task->captureId);
+    return -1;
+  }
+  if (cap_open(&reader, cap_path) != 0) {
+    printf("[CAPTURE #%u] Couldn't open %s\n", task->captureId, cap_path);
+    return -1;
+  }
+  h = reader.header;
+  // Coded blocks are decoded batch by batch into 16-bit values
+  coded = (h->codec != CAP_CODEC_NONE);
+  blockValues = (size_t)h->width * h->height;
+
+  // Layout of the raw frames, from the MIMO chirp table of each device
+  memset(&layout, 0, sizeof(layout));
+  layout.deviceMap = h->deviceMap;
+  layout.rxChannelEn = h->rxChannelEn;
+  layout.numSamples = h->numAdcSamples;
+  layout.numLoops = h->numLoops;
+  layout.numChirps = h->chirpEndIdx - h->chirpStartIdx + 1;
+  layout.iqSwap = config->dataFmtCfg.iqSwapSel;
+  layout.chInterleave = config->dataFmtCfg.chInterleave;
+  layout.complex = (h->valsPerSample == 2);
+  layout.packed12 = coded ? 0 : h->packing;
+  for (uint8_t devId = 0; devId < DSP_MAX_DEVICES; devId++) {
+    if ((h->deviceMap & (1U << devId)) == 0) continue;
+    uint16_t count = buildMimoChirpTable(devId, config->chirpCfg, table);
+    for (uint16_t i = 0; i < count; i++) {
+      for (uint16_t idx = table[i].chirpStartIdx; idx <= table[i].chirpEndIdx; idx++) {
+        if ((idx < h->chirpStartIdx) || ((uint16_t)(idx - h->chirpStartIdx) >= DSP_MAX_CHIRPS)) continue;
+        layout.chirpTx[devId][idx - h->chirpStartIdx] = table[i].txEnable;
+      }
+    }
+  }
+  if ((h->numFrames == 0) || (dsp_layout_init(&layout) != 0) ||
+      (layout.frameBytes != (coded ? blockValues * sizeof(int16_t) : h->blockSize)) ||
+      (dsp_rd_plan_init(&plan, &layout, DSP_RD_DB) != 0)) {
+    printf("[CAPTURE #%u] Not a TDM MIMO capture of ADC data, no range-Doppler maps\n",
+      task->captureId);
+    goto done;
+  }
+
+  memset(&header, 0, sizeof(header));
+  header.magic = DSP_RD_MAGIC;
+  header.version = DSP_RD_VERSION;
+  header.headerSize = sizeof(header);
+  header.numFrames = h->numFrames;
+  header.numDoppler = plan.dopplerFft;
+  header.numRange = plan.numRange;
+  header.scale = DSP_RD_DB;
+  header.numTx = layout.numTx;
+  header.numRx = layout.numDevices * layout.numRx;
+  slope = h->freqSlopeConst * 48.279e9;                   // Hz/s
+  lambda = c / (h->startFreqConst * 53.644);              // m
+  loopTime = layout.numChirps * (h->idleTimeConst + h->rampEndTime) * 10e-9;  // s
+  if (slope != 0) header.rangeRes = c * h->digOutSampleRate * 1e3 / (2 * slope * plan.rangeFft);
+  if (loopTime > 0) header.dopplerRes = lambda / (2 * loopTime * plan.dopplerFft);
+
+  maps = malloc(batch * plan.mapSize * sizeof(float));
+  if (coded) decoded = malloc(batch * h->numDevices * blockValues * sizeof(int16_t));
+  out = fopen(part_path, "wb");
+  if ((maps == NULL) || (out == NULL) || (coded && (decoded == NULL))) {
+    printf("[CAPTURE #%u] Couldn't write %s\n", task->captureId, part_path);
+    goto done;
+  }
+
+  // Header written last: an incomplete file has no valid magic
+  header.magic = 0;
+  if (fwrite(&header, sizeof(header), 1, out) != 1) goto done;
+  header.magic = DSP_RD_MAGIC;
+
+  rawStride = (size_t)h->numDevices * (coded ? blockValues * sizeof(int16_t) : h->blockStride);
+  for (uint8_t devId = 0; devId < DSP_MAX_DEVICES; devId++) {
+    if ((h->deviceMap & (1U << devId)) == 0) continue;
+    raw[devId] = coded ? (const uint8_t *)(decoded + reader.devSlot[devId] * blockValues) :
+      (const uint8_t *)cap_frame(&reader, 0, devId);
+  }
+  for (uint32_t f = 0; f < h->numFrames; f += batch) {
+    uint32_t n = ((h->numFrames - f) < batch) ? h->numFrames - f : batch;
+    for (uint8_t devId = 0; devId < DSP_MAX_DEVICES; devId++) {
+      for (uint32_t i = 0; coded && (raw[devId] != NULL) && (i < n); i++) {
+        int16_t *block = decoded + ((size_t)i * h->numDevices + reader.devSlot[devId]) * blockValues;
+        if (cap_frame_read(&reader, f + i, devId, block) != 0) {
+          printf("[CAPTURE #%u] Corrupted block in frame %u\n", task->captureId, f + i);
+          goto done;
+        }
+      }
+      batchRaw[devId] = (raw[devId] == NULL) ? NULL :
+        raw[devId] + (coded ? 0 : (size_t)f * rawStride);
+    }
+    if ((dsp_rd_raw_frames(&plan, batchRaw, rawStride, n, maps, 0) != 0) ||
+        (fwrite(maps, sizeof(float), n * plan.mapSize, out) != n * plan.mapSize)) {
+      printf("[CAPTURE #%u] Couldn't compute the range-Doppler maps\n", task->captureId);
+      goto done;
+    }
+  }
+  if ((fseek(out, 0, SEEK_SET) != 0) || (fwrite(&header, sizeof(header), 1, out) != 1)) goto done;
+  if (fclose(out) != 0) {
+    out = NULL;
+    goto done;
+  }
+  out = NULL;
+  if (rename(part_path, rd_path) != 0) goto done;
+
+  printf("[CAPTURE #%u] Wrote %u range-Doppler maps of %u x %u bins into %s\n", task->captureId,
+    header.numFrames, header.numDoppler, header.numRange, rd_path);
+  status = 0;
+
+done:
+  if (out != NULL) fclose(out);
+  if (status != 0) unlink(part_path);
+  free(maps);
+  free(decoded);
+  dsp_rd_plan_free(&plan);
+  cap_close(&reader);
+  return status;
+}
+
+/**
+ * @brief Check that a capture has been copied to the host
+ *
+ * The size of each file is already checked by the transfer. With
+ * --checksum, the CRC of each file is compared with the one computed on
+ * the DSP board. The frames of the copy are then checked against the
+ * configuration (count, duplicates and write throughput over the
+ * recording). With --pack, the copy is then packed into a container, and
+ * with --rdmap, its range-Doppler heatmaps are computed.
+ *
+ * @param task Copied capture
+ * @return int32_t 0 if the local copy holds some data, -1 otherwise
+ */
+int32_t verify_capture(schedTask_t *task) {
+  char src_path[256];
+  char dst_path[256];
+  char prefix[32];
+  xferStats_t stats;
+  int64_t size;
+
+  local_capture_path(dst_path, sizeof(dst_path), task->captureDir);
+  if (g_xfer_checksum) {
+    memset(&stats, 0, sizeof(stats));
+    snprintf(src_path, sizeof(src_path), "/mnt/ssd/%s", task->captureDir);
+    if (xfer_verify(&g_xfer_cfg, src_path, dst_path, &stats) != 0) {
+      metrics_add(METRICS_VERIFY_FAILURES, 1);
+      return -1;
+    }
+  }
+  size = directory_size(dst_path);
+  task->bytes = (size > 0) ? size : 0;
+  if ((size > 0) && (g_verify_config != NULL)) {
+    // The copies do not keep the modification times of the TDA
+    snprintf(prefix, sizeof(prefix), "[CAPTURE #%u]", task->captureId);
+    if (verify_frames(dst_path, g_verify_config, task->recordTime, 0, prefix) != 0) {
+      metrics_add(METRICS_VERIFY_FAILURES, 1);
+      return -1;
+    }
+  }
+  if ((size > 0) && (g_pack_config != NULL)) {
+    if (pack_capture(task, g_pack_config) != 0) return -1;
+    return g_rdmap ? rdmap_capture(task, g_pack_config) : 0;
+  }
+  return (size > 0) ? 0 : -1;
+}
+
+// Thread for a single background transfer
+void* transfer_thread(void* arg) {
+  schedTask_t* task = (schedTask_t*)arg;
+
+  task->status = transfer_capture(task);
+  if (task->status == 0) task->status = verify_capture(task);
+  printf("[TRANSFER #%u] %s: %s (%llu bytes)\n", task->captureId, task->captureDir,
+    (task->status == 0) ? "verified" : "FAILED", (unsigned long long)task->bytes);
+  free(task);
+  return NULL;
+}
+
+// Non-blocking transfer
+int start_async_transfer(const char* capture_dir, int capture_id) {
+  schedTask_t* task = calloc(1, sizeof(schedTask_t));
+  if (!task) return -1;
+
+  strncpy(task->captureDir, capture_dir, sizeof(task->captureDir) - 1);
+  task->captureId = capture_id;
+
+  pthread_t thread;
+  pthread_attr_t attr;
+  pthread_attr_init(&attr);
+  pthread_attr_setdetachstate(&attr, PTHREAD_CREATE_DETACHED);
+
+  if (pthread_create(&thread, &attr, transfer_thread, task) != 0) {
+    free(task);
+    return -1;
+  }
+
+  pthread_attr_destroy(&attr);
+  return 0;
 }
 
 /**
@@ -230,6 +755,27 @@ void get_timestamp(char *buffer, size_t size) {
   sprintf(buffer + strlen(buffer), ".%03ld", tv.tv_usec / 1000);
 }
 
+
+/**
+ * @brief Get the time elapsed since the last call in millisecond
+ *
+ * Used to report the duration of each configuration stage.
+ *
+ * @param reset Restart the stage timer without reporting
+ * @return double Elapsed time in millisecond
+ */
+double get_stage_time(uint8_t reset) {
+  static struct timespec last = { 0 };
+  struct timespec now;
+  double elapsed;
+
+  clock_gettime(CLOCK_MONOTONIC, &now);
+  elapsed = (now.tv_sec - last.tv_sec) * 1e3 + (now.tv_nsec - last.tv_nsec) / 1e6;
+  if ((reset != 0) || (last.tv_sec == 0 && last.tv_nsec == 0)) elapsed = 0.0;
+  last = now;
+  return elapsed;
+}
+
 /**
  * @brief Check if a value is in the table provided in argument
  *
@@ -248,37 +794,102 @@ int8_t is_in_table(uint8_t value, uint8_t *table, uint8_t size) {
 
 
 /**
- * @brief MIMO Chirp configuration
+ * @brief Build the MIMO chirp table of a device
+ *
+ * Consecutive chirps sharing the same TX mask are merged into a single
+ * entry spanning chirpStartIdx..chirpEndIdx.
  *
  * @param devId Device ID (0: master, 1: slave1, 2: slave2, 3: slave3)
  * @param chirpCfg Initital chirp configuration
- * @return uint32_t Configuration status
+ * @param table Output chirp table (at least NUM_CHIRPS entries)
+ * @return uint16_t Number of entries in the table
  */
-uint32_t configureMimoChirp(uint8_t devId, rlChirpCfg_t chirpCfg) {
+uint16_t buildMimoChirpTable(uint8_t devId, rlChirpCfg_t chirpCfg, rlChirpCfg_t *table) {
   const uint8_t chripTxTable [4][3] = {
     {11, 10, 9},   // Dev1 - Master
     {8, 7, 6},     // Dev2
     {5, 4, 3},     // Dev3
     {2, 1, 0},     // Dev4
   };
-  int status = 0;
+  uint16_t count = 0;
 
   for (uint8_t i = 0; i < NUM_CHIRPS; i++) {
     int8_t txIdx = is_in_table(i, chripTxTable[devId], 3);
+    uint16_t txEnable = (txIdx < 0) ? 0x00 : (1 << txIdx);
 
-    // Update chirp config
-    chirpCfg.chirpStartIdx = i;
-    chirpCfg.chirpEndIdx = i;
-    if (txIdx < 0) chirpCfg.txEnable = 0x00;
-    else chirpCfg.txEnable = (1 << txIdx);
-    status += MMWL_chirpConfig(createDevMapFromDevId(devId), chirpCfg);
-    DEBUG_PRINT("[CHIRP CONFIG] dev %u, chirp idx %u, status: %d\n", devId, i, status);
-    if (status != 0) {
-      DEBUG_PRINT("Configuration of chirp %d failed!\n", i);
-      break;
+    if ((count > 0) && (table[count - 1].txEnable == txEnable)) {
+      table[count - 1].chirpEndIdx = i;
+      continue;
     }
+    table[count] = chirpCfg;
+    table[count].chirpStartIdx = i;
+    table[count].chirpEndIdx = i;
+    table[count].txEnable = txEnable;
+    count++;
   }
-  return status;
+  return count;
+}
+
+
+/**
+ * @brief MIMO Chirp configuration
+ *
+ * The chirp table of each device is sent in as few messages as possible,
+ * and all the devices of the device map are programmed concurrently.
+ *
+ * With an advanced frame, sub-frame `n` uses its own copy of the MIMO
+ * chirps, from index n * NUM_CHIRPS, with profile `n`: the tables of all
+ * the sub-frames are downloaded together.
+ *
+ * @param deviceMap Devices to configure
+ * @param chirpCfg Initital chirp configuration
+ * @param numSubFrames Number of sub-frames (0: legacy frame)
+ * @return uint32_t Configuration status
+ */
+uint32_t configureMimoChirp(uint8_t deviceMap, rlChirpCfg_t chirpCfg, uint8_t numSubFrames) {
+  rlChirpCfg_t tables[4][NUM_CHIRPS * RL_MAX_SUBFRAMES];
+  rlChirpCfg_t *pTables[4] = { NULL };
+  unsigned short counts[4] = { 0 };
+
+  if (numSubFrames > RL_MAX_SUBFRAMES) return RL_RET_CODE_INVALID_INPUT;
+  for (uint8_t devId = 0; devId < 4; devId++) {
+    if ((deviceMap & (1 << devId)) == 0) continue;
+    for (uint8_t sub = 0; sub < ((numSubFrames > 0) ? numSubFrames : 1); sub++) {
+      rlChirpCfg_t *table = &tables[devId][counts[devId]];
+      uint16_t count;
+
+      if (numSubFrames > 0) chirpCfg.profileId = sub;
+      count = buildMimoChirpTable(devId, chirpCfg, table);
+      for (uint16_t i = 0; i < count; i++) {
+        table[i].chirpStartIdx += sub * NUM_CHIRPS;
+        table[i].chirpEndIdx += sub * NUM_CHIRPS;
+      }
+      counts[devId] += count;
+    }
+    pTables[devId] = tables[devId];
+    for (uint16_t i = 0; i < counts[devId]; i++) {
+      DEBUG_PRINT("[CHIRP CONFIG] dev %u, chirp idx %u..%u, tx: %u\n", devId,
+        tables[devId][i].chirpStartIdx, tables[devId][i].chirpEndIdx,
+        tables[devId][i].txEnable);
+    }
+  }
+  return MMWL_chirpTableConfig(deviceMap, pTables, counts);
+}
+
+/**
+ * @brief Frame configuration, legacy or advanced
+ *
+ * @param config Device configuration
+ * @param deviceMap Devices to configure (the master or the slaves)
+ * @return int32_t Configuration status
+ */
+int32_t configureFrame(const devConfig_t *config, uint8_t deviceMap) {
+  if (config->advFrameCfg.frameSeq.numOfSubFrames > 0) {
+    return MMWL_advFrameConfig(deviceMap, config->advFrameCfg, config->channelCfg,
+      config->adcOutCfg, config->datapathCfg, config->subProfileCfg[0]);
+  }
+  return MMWL_frameConfig(deviceMap, config->frameCfg, config->channelCfg,
+    config->adcOutCfg, config->datapathCfg, config->profileCfg);
 }
 
 /**
@@ -292,15 +903,24 @@ uint32_t configureMimoChirp(uint8_t devId, rlChirpCfg_t chirpCfg) {
  *                    the program exits in case of failure.
  * @return uint32_t Configuration status
  *
+ * @note: The time elapsed since the previous check is printed as the
+ * duration of the stage.
+ *
  * @note: Status is considered successful when the status integer is 0.
  * Any other value is considered a failure.
  */
 void check(int status, const char *success_msg, const char *error_msg,
       unsigned char deviceMap, uint8_t is_required) {
+  uint64_t stage_end = TDA_PROF_START();
+  if (stage_end != 0U) {
+    TDAProfStage(success_msg, g_profile_stage, stage_end);
+    g_profile_stage = stage_end;
+  }
 #if DEV_ENV
   char timestamp[32];
   get_timestamp(timestamp, sizeof(timestamp));
-  printf("[%s] [IP: %s] STATUS %4d | DEV MAP: %2u | ", timestamp, g_ip_addr, status, deviceMap);
+  printf("[%s] [IP: %s] STATUS %4d | DEV MAP: %2u | %8.1f ms | ",
+    timestamp, g_ip_addr, status, deviceMap, get_stage_time(FALSE));
 #endif
   if (status == RL_RET_CODE_OK) {
 #if DEV_ENV
@@ -317,28 +937,55 @@ void check(int status, const char *success_msg, const char *error_msg,
     printf(CRESET);
     printf("\n");
 #endif
-    if (is_required != 0) exit(status);
+    if ((is_required != 0) && g_check_fatal) exit(status);
   }
 }
 
 
-int32_t initMaster(rlChanCfg_t channelCfg, rlAdcOutCfg_t adcOutCfg) {
-  const unsigned int masterId = 0;
-  const unsigned int masterMap = 1 << masterId;
+/**
+ * @brief Power up all the devices and download the firmware
+ *
+ * The master is powered up first as it initializes mmWaveLink, then the
+ * slaves. The firmware is then downloaded to all the devices in a single
+ * concurrent phase, and skipped for the devices already running it.
+ *
+ * @param masterMap Master device map
+ * @param slavesMap Slave devices map
+ * @return int32_t Boot status
+ */
+int32_t bootDevices(uint8_t masterMap, uint8_t slavesMap) {
   int status = 0;
 
-  // master chip
-  channelCfg.cascading = 1;
-
   status += MMWL_DevicePowerUp(masterMap, 1000, 1000);
   check(status,
     "[MASTER] Power up successful!",
     "[MASTER] Error: Failed to power up device!", masterMap, TRUE);
 
-  status += MMWL_firmwareDownload(masterMap);
+  for (uint8_t slaveId = 1; slaveId < 4; slaveId++) {
+    unsigned int slaveMap = 1 << slaveId;
+
+    if ((slavesMap & slaveMap) == 0) continue;
+    status += MMWL_DevicePowerUp(slaveMap, 1000, 1000);
+    check(status,
+      "[SLAVE] Power up successful!",
+      "[SLAVE] Error: Failed to power up device!", slaveMap, TRUE);
+  }
+
+  status += MMWL_firmwareDownload(masterMap | slavesMap);
   check(status,
-    "[MASTER] Firmware successfully uploaded!",
-    "[MASTER] Error: Firmware upload failed!", masterMap, TRUE);
+    "[ALL] Firmware successfully uploaded!",
+    "[ALL] Error: Firmware upload failed!", masterMap | slavesMap, TRUE);
+  return status;
+}
+
+
+int32_t initMaster(rlChanCfg_t channelCfg, rlAdcOutCfg_t adcOutCfg) {
+  const unsigned int masterId = 0;
+  const unsigned int masterMap = 1 << masterId;
+  int status = 0;
+
+  // master chip
+  channelCfg.cascading = 1;
 
   status += MMWL_setDeviceCrcType(masterMap);
   check(status,
@@ -374,21 +1021,7 @@ int32_t initSlaves(rlChanCfg_t channelCfg, rlAdcOutCfg_t adcOutCfg) {
   // slave chip
   channelCfg.cascading = 2;
 
-  for (uint8_t slaveId = 1; slaveId < 4; slaveId++) {
-    unsigned int slaveMap = 1 << slaveId;
-
-    status += MMWL_DevicePowerUp(slaveMap, 1000, 1000);
-    check(status,
-      "[SLAVE] Power up successful!",
-      "[SLAVE] Error: Failed to power up device!", slaveMap, TRUE);
-  }
-
   //Config of all slaves together
-  status += MMWL_firmwareDownload(slavesMap);
-  check(status,
-    "[SLAVE] Firmware successfully uploaded!",
-    "[SLAVE] Error: Firmware upload failed!", slavesMap, TRUE);
-
   status += MMWL_setDeviceCrcType(slavesMap);
   check(status,
     "[SLAVE] CRC type has been set!",
@@ -416,493 +1049,1262 @@ int32_t initSlaves(rlChanCfg_t channelCfg, rlAdcOutCfg_t adcOutCfg) {
 }
 
 
-uint32_t configure (devConfig_t config) {
+/**
+ * @brief Hash each configuration block of a device configuration
+ *
+ * @param config Device configuration
+ * @param state Configuration state to fill
+ */
+void hash_config(devConfig_t *config, mmwlCfgState_t *state) {
+  uint64_t hash = 0;
+
+  memset(state, 0, sizeof(mmwlCfgState_t));
+  state->deviceMap = config->deviceMap;
+
+  hash = MMWL_cfgHash(hash, &config->channelCfg, sizeof(config->channelCfg));
+  hash = MMWL_cfgHash(hash, &config->adcOutCfg, sizeof(config->adcOutCfg));
+  hash = MMWL_cfgHash(hash, &config->dataFmtCfg, sizeof(config->dataFmtCfg));
+  hash = MMWL_cfgHash(hash, &config->ldoCfg, sizeof(config->ldoCfg));
+  hash = MMWL_cfgHash(hash, &config->lpmCfg, sizeof(config->lpmCfg));
+  hash = MMWL_cfgHash(hash, &config->miscCfg, sizeof(config->miscCfg));
+  hash = MMWL_cfgHash(hash, &config->datapathCfg, sizeof(config->datapathCfg));
+  hash = MMWL_cfgHash(hash, &config->datapathClkCfg, sizeof(config->datapathClkCfg));
+  hash = MMWL_cfgHash(hash, &config->hsClkCfg, sizeof(config->hsClkCfg));
+  hash = MMWL_cfgHash(hash, &config->csi2LaneCfg, sizeof(config->csi2LaneCfg));
+  hash = MMWL_cfgHash(hash, &config->monCfg, sizeof(config->monCfg));
+  state->blockHash[MMWL_CFG_BLOCK_DEVICE] = hash;
+
+  // The sub-frames select the profiles and the chirp tables downloaded
+  hash = MMWL_cfgHash(0, &config->profileCfg, sizeof(config->profileCfg));
+  hash = MMWL_cfgHash(hash, config->subProfileCfg, sizeof(config->subProfileCfg));
+  state->blockHash[MMWL_CFG_BLOCK_PROFILE] = hash;
+  hash = MMWL_cfgHash(0, &config->chirpCfg, sizeof(config->chirpCfg));
+  hash = MMWL_cfgHash(hash, &config->advFrameCfg.frameSeq.numOfSubFrames,
+    sizeof(config->advFrameCfg.frameSeq.numOfSubFrames));
+  state->blockHash[MMWL_CFG_BLOCK_CHIRP] = hash;
+  hash = MMWL_cfgHash(0, &config->frameCfg, sizeof(config->frameCfg));
+  hash = MMWL_cfgHash(hash, &config->advFrameCfg, sizeof(config->advFrameCfg));
+  state->blockHash[MMWL_CFG_BLOCK_FRAME] = hash;
+}
+
+
+/**
+ * @brief Re-issue only the configuration blocks that changed
+ *
+ * The devices must still be up and configured from the previous session.
+ * A profile or chirp change also re-issues the frame configuration, and a
+ * profile change the RF health monitors programmed from the profile.
+ *
+ * @param config Device configuration
+ * @param changed Bit map of the changed blocks (1 << MMWL_CFG_BLOCK_*)
+ * @return int32_t Status, non zero when a full configuration is required
+ */
+int32_t reconfigure(devConfig_t config, unsigned int changed) {
   int status = 0;
-  status += initMaster(config.channelCfg, config.adcOutCfg);
-  status += initSlaves(config.channelCfg, config.adcOutCfg);
 
-  status += MMWL_RFDeviceConfig(config.deviceMap);
+  uint8_t numSubFrames = config.advFrameCfg.frameSeq.numOfSubFrames;
+
+  status = MMWL_DeviceAttach(config.deviceMap, 1000);
   check(status,
+    "[ALL] Attached to the configured devices!",
+    "[ALL] Devices not configured anymore!", config.deviceMap, FALSE);
+  if (status != 0) return status;
+
+  if (changed & (1U << MMWL_CFG_BLOCK_PROFILE)) {
+    if (numSubFrames > 0) {
+      status += MMWL_profileTableConfig(config.deviceMap, config.subProfileCfg, numSubFrames);
+    } else {
+      status += MMWL_profileConfig(config.deviceMap, config.profileCfg);
+    }
+    check(status,
+      "[ALL] Profile configuration successful!",
+      "[ALL] Profile configuration failed!", config.deviceMap, FALSE);
+    changed |= (1U << MMWL_CFG_BLOCK_FRAME);
+  }
+
+  if ((status == 0) && (changed & (1U << MMWL_CFG_BLOCK_CHIRP))) {
+    status += configureMimoChirp(config.deviceMap, config.chirpCfg, numSubFrames);
+    check(status,
+      "[ALL] Chirp configuration successful!",
+      "[ALL] Chirp configuration failed!", config.deviceMap, FALSE);
+    changed |= (1U << MMWL_CFG_BLOCK_FRAME);
+  }
+
+  if ((status == 0) && (changed & (1U << MMWL_CFG_BLOCK_FRAME))) {
+    status += configureFrame(&config, config.masterMap);
+    status += configureFrame(&config, config.slavesMap);
+    check(status,
+      "[ALL] Frame configuration completed!",
+      "[ALL] Frame configuration failed!", config.deviceMap, FALSE);
+  }
+
+  if ((status == 0) && (changed & (1U << MMWL_CFG_BLOCK_PROFILE)) && (config.monCfg.enable != 0)) {
+    status += MMWL_monitorConfig(config.deviceMap, config.monCfg,
+      config.channelCfg, config.profileCfg);
+    check(status,
+      "[ALL] RF health monitors enabled!",
+      "[ALL] RF health monitor configuration failed!", config.deviceMap, FALSE);
+  }
+  return status;
+}
+
+
+/**
+ * @brief Configure the devices
+ *
+ * The configuration applied to the board is recorded at the end. On the
+ * next session, only the blocks that changed are re-issued unless `full`
+ * is set or the device level configuration changed.
+ *
+ * @param config Device configuration
+ * @param full Force the full configuration sequence
+ * @return uint32_t Configuration status
+ */
+uint32_t configure (devConfig_t config, uint8_t full) {
+  struct timespec start, end;
+  mmwlCfgState_t previous, current;
+  mmwlBatch_t batch;
+  mmwlTxn_t txn;
+  int rfDevice, ldo, dataFmt, lowPower, datapath, profile;
+  int status = 0;
+
+  clock_gettime(CLOCK_MONOTONIC, &start);
+  get_stage_time(TRUE);
+  g_profile_stage = TDA_PROF_START();
+  hash_config(&config, &current);
+
+  if (!full && (MMWL_cfgStateLoad(g_ip_addr, &previous) == 0)) {
+    unsigned int changed = MMWL_cfgStateDiff(&previous, &current);
+
+    if ((changed & (1U << MMWL_CFG_BLOCK_DEVICE)) == 0) {
+      if (reconfigure(config, changed) == 0) {
+        MMWL_cfgStateSave(g_ip_addr, &current);
+        clock_gettime(CLOCK_MONOTONIC, &end);
+#if DEV_ENV
+        printf("[MIMO] Incremental configuration time: %.3f s\n",
+          (end.tv_sec - start.tv_sec) + (end.tv_nsec - start.tv_nsec) / 1e9);
+#endif
+        return 0;
+      }
+#if DEV_ENV
+      printf("[MIMO] Incremental configuration failed, running the full sequence\n");
+#endif
+    }
+  }
+
+  // The previous state is no longer valid once the devices are reset
+  MMWL_cfgStateClear(g_ip_addr);
+  status += bootDevices(config.masterMap, config.slavesMap);
+  status += initMaster(config.channelCfg, config.adcOutCfg);
+  status += initSlaves(config.channelCfg, config.adcOutCfg);
+  if (status != 0) return status;
+
+  // Device and static configuration (packed into as few messages as
+  // possible), queued back to back without waiting between the devices
+  MMWL_batchInit(&batch);
+  rfDevice = MMWL_batchRFDeviceConfig(&batch, config.deviceMap);
+  MMWL_txnInit(&txn, config.deviceMap);
+  ldo = MMWL_txnLdoBypass(&txn, config.ldoCfg);
+  dataFmt = MMWL_txnDataFmt(&txn, config.dataFmtCfg);
+  lowPower = MMWL_txnLowPower(&txn, config.lpmCfg);
+  MMWL_txnApllSynthBw(&txn);
+  MMWL_txnMisc(&txn, config.miscCfg);
+  MMWL_batchTxn(&batch, &txn);
+  status += MMWL_batchWait(&batch);
+  check(MMWL_batchStatus(&batch, rfDevice),
     "[ALL] RF deivce configured!",
     "[ALL] RF device configuration failed!", config.deviceMap, TRUE);
-
-  status += MMWL_ldoBypassConfig(config.deviceMap, config.ldoCfg);
-  check(status,
+  check(MMWL_txnStatus(&txn, ldo),
     "[ALL] LDO Bypass configuration successful!",
     "[ALL] LDO Bypass configuration failed!", config.deviceMap, TRUE);
+  check(MMWL_txnStatus(&txn, dataFmt),
+    "[ALL] Data format configuration successful!",
+    "[ALL] Data format configuration failed!", config.deviceMap, TRUE);
+  check(MMWL_txnStatus(&txn, lowPower),
+    "[ALL] Low Power Mode configuration successful!",
+    "[ALL] Low Power Mode configuration failed!", config.deviceMap, TRUE);
+
+  status += MMWL_rfInitCached(config.deviceMap, (const char *)g_ip_addr, !g_recalibrate);
+  check(status,
+    "[ALL] RF successfully initialized!",
+    "[ALL] RF init failed!", config.deviceMap, TRUE);
+  if (status != 0) return status;
+
+  MMWL_batchInit(&batch);
+  MMWL_txnInit(&txn, config.deviceMap);
+  MMWL_txnDataPath(&txn, config.datapathCfg);
+  MMWL_txnHsiClock(&txn, config.datapathClkCfg, config.hsClkCfg);
+  MMWL_txnCSI2Lane(&txn, config.csi2LaneCfg);
+  datapath = MMWL_batchTxn(&batch, &txn);
+  if (config.advFrameCfg.frameSeq.numOfSubFrames > 0) {
+    // The profiles of all the sub-frames in one message
+    profile = MMWL_batchProfileTable(&batch, config.deviceMap, config.subProfileCfg,
+      config.advFrameCfg.frameSeq.numOfSubFrames);
+  } else {
+    profile = MMWL_batchProfileConfig(&batch, config.deviceMap, config.profileCfg);
+  }
+  status += MMWL_batchWait(&batch);
+  check(MMWL_batchStatus(&batch, datapath),
+    "[ALL] Datapath configuration successful!",
+    "[ALL] Datapath configuration failed!", config.deviceMap, TRUE);
+  check(MMWL_batchStatus(&batch, profile),
+    "[ALL] Profile configuration successful!",
+    "[ALL] Profile configuration failed!", config.deviceMap, TRUE);
+
+  // MIMO Chirp configuration
+  status += configureMimoChirp(config.deviceMap, config.chirpCfg,
+    config.advFrameCfg.frameSeq.numOfSubFrames);
+  check(status,
+    "[ALL] Chirp configuration successful!",
+    "[ALL] Chirp configuration failed!", config.deviceMap, TRUE);
+
+  // Master frame config.
+  status += configureFrame(&config, config.masterMap);
+  check(status,
+    "[MASTER] Frame configuration completed!",
+    "[MASTER] Frame configuration failed!", config.masterMap, TRUE);
+
+  // Slaves frame config
+  status += configureFrame(&config, config.slavesMap);
+  check(status,
+    "[SLAVE] Frame configuration completed!",
+    "[SLAVE] Frame configuration failed!", config.slavesMap, TRUE);
+
+  // RF health monitors, reported asynchronously while framing
+  if (config.monCfg.enable != 0) {
+    status += MMWL_monitorConfig(config.deviceMap, config.monCfg,
+      config.channelCfg, config.profileCfg);
+    check(status,
+      "[ALL] RF health monitors enabled!",
+      "[ALL] RF health monitor configuration failed!", config.deviceMap, TRUE);
+  }
+
+  check(status,
+    "[MIMO] Configuration completed!\n",
+    "[MIMO] Configuration completed with error!", config.deviceMap, TRUE);
+  if (status == 0) MMWL_cfgStateSave(g_ip_addr, &current);
+
+  clock_gettime(CLOCK_MONOTONIC, &end);
+#if DEV_ENV
+  printf("[MIMO] Total configuration time: %.3f s\n",
+    (end.tv_sec - start.tv_sec) + (end.tv_nsec - start.tv_nsec) / 1e9);
+#endif
+  return status;
+}
+
+
+/**
+ * @brief Build the device configuration
+ *
+ * Start from the default configuration and overwrite it with the
+ * parameters of the TOML configuration file (or compiled blob) when
+ * provided. The timing and bandwidth of the result are then checked.
+ *
+ * @param config Device configuration to fill
+ * @param filename TOML configuration file or blob (NULL for the default config)
+ * @return int 0 on success, -1 if the configuration is invalid or infeasible
+ */
+int load_config(devConfig_t *config, unsigned char *filename) {
+  int status = 0;
+
+  /*  Device map:  master | slave 1  | slave 2  | slave 3 */
+  config->deviceMap =  1   | (1 << 1) | (1 << 2) | (1 << 3);
+  MMWL_AssignDeviceMap(config->deviceMap, &config->masterMap, &config->slavesMap);
+
+  config->frameCfg = frameCfgArgs;
+  config->profileCfg = profileCfgArgs;
+  config->chirpCfg = chirpCfgArgs;
+  config->adcOutCfg = adcOutCfgArgs;
+  config->dataFmtCfg = dataFmtCfgArgs;
+  config->channelCfg = channelCfgArgs;
+  config->csi2LaneCfg = csi2LaneCfgArgs;
+  config->datapathCfg = datapathCfgArgs;
+  config->datapathClkCfg = datapathClkCfgArgs;
+  config->hsClkCfg = hsClkCfgArgs;
+  config->ldoCfg = ldoCfgArgs;
+  config->lpmCfg = lpmCfgArgs;
+  config->miscCfg = miscCfgArgs;
+  config->monCfg = monCfgArgs;
+  // Legacy frame unless sub-frames are configured
+  memset(&config->advFrameCfg, 0, sizeof(config->advFrameCfg));
+  memset(config->subProfileCfg, 0, sizeof(config->subProfileCfg));
+
+  if (filename != NULL) {
+    // Read parameters from config file
+    status = read_config(filename, config);
+  }
+
+  /**
+   * @note: The adcOutCfg is used to overwrite the dataFmtCfg
+   *
+   * In a unified config file, it'll make for sense to have a single
+   * source of truth for the ADC data format. And therefore use the
+   * same data for setting both.
+   */
+  config->dataFmtCfg.rxChannelEn = channelCfgArgs.rxChannelEn;
+  config->dataFmtCfg.adcBits = adcOutCfgArgs.fmt.b2AdcBits;
+  config->dataFmtCfg.adcFmt = adcOutCfgArgs.fmt.b2AdcOutFmt;
+
+  // Reject infeasible configurations before any traffic with the devices
+  if ((status == 0) && (validate_config(config, NULL) != 0)) {
+    status = -1;
+  }
+  return status;
+}
+
+
+/**
+ * @brief Routine to close trace file
+ * 
+ */
+FILE* rls_traceF = NULL;
+void CloseTraceFile() {
+  if (rls_traceF != NULL) {
+    fclose(rls_traceF);
+    rls_traceF = NULL;
+  }
+}
+
+// Pointer to the CLI option parser
+parser_t *g_parser = NULL;
+
+/**
+ * Print program version
+ */
+void print_version() {
+  printf(PROG_NAME " version " PROG_VERSION ", " PROG_COPYRIGHT "\n");
+  exit(0);
+}
+
+/**
+ * @brief Print CLI options help and exit
+ */
+void help() {
+  print_help(g_parser);
+  exit(0);
+}
+
+/**
+ * @brief Free the parser to cleanup any dynamically allocated memory
+ */
+void cleanup() {
+  metrics_stop();
+  if (g_profile_path[0] != '\0') {
+    TDAProfEnable(FALSE);
+    if (json_export_profile(g_profile_path) == 0) {
+      printf("[MMWCAS] Profile written to %s\n", g_profile_path);
+    } else {
+      printf("[MMWCAS] Cannot write the profile %s\n", g_profile_path);
+    }
+  }
+  free_parser(g_parser);
+}
+
+/**
+ * @brief Called when the user presses CTRL+C
+ *
+ * This aim to explicitly call the exit function so that
+ * dynamically allocated memory could be freed
+ */
+void signal_handler () {
+  exit(1);
+}
+
+/**
+ * @brief Parse a comma separated list of DSP board IP addresses
+ *
+ * @param list List of IP addresses (e.g. "192.168.33.180,192.168.33.181")
+ * @param boards Board contexts to fill
+ * @return uint8_t Number of boards
+ */
+uint8_t parse_boards(const char *list, boardCtx_t *boards) {
+  uint8_t nBoards = 0;
+  const char *start = list;
+
+  while ((*start != '\0') && (nBoards < MAX_BOARDS)) {
+    const char *end = strchr(start, ',');
+    size_t len = (end != NULL) ? (size_t)(end - start) : strlen(start);
+
+    if ((len > 0) && (len < sizeof(boards[0].ipAddr))) {
+      memset(&boards[nBoards], 0, sizeof(boardCtx_t));
+      memcpy(boards[nBoards].ipAddr, start, len);
+      nBoards++;
+    }
+    if (end == NULL) break;
+    start = end + 1;
+  }
+  return nBoards;
+}
+
+/**
+ * @brief Parse a comma separated list of RF health monitors
+ *
+ * @param list Monitor names ("temp", "rx-gain", "tx-power", "synth", "all")
+ *  or "none"
+ * @param enable MMWL_MON_* mask to fill
+ * @return int32_t 0 on success, -1 on an unknown monitor
+ */
+int32_t parse_monitors(const char *list, uint8_t *enable) {
+  char buffer[128];
+  char *saveptr = NULL;
+
+  *enable = 0;
+  if (strcmp(list, "none") == 0) return 0;
+  strncpy(buffer, list, sizeof(buffer) - 1);
+  buffer[sizeof(buffer) - 1] = '\0';
+  for (char *name = strtok_r(buffer, ",", &saveptr); name != NULL;
+       name = strtok_r(NULL, ",", &saveptr)) {
+    uint8_t mask = MMWL_monitorByName(name);
+    if (mask == 0) {
+      printf("%s[ERROR] Unknown RF health monitor '%s'%s\n", CRED, name, CRESET);
+      return -1;
+    }
+    *enable |= mask;
+  }
+  return 0;
+}
+
+/**
+ * @brief Wait until every board is ready to start framing
+ *
+ * Returns immediately when a single board is driven. The barrier is
+ * reusable, e.g. once per capture in monitoring mode.
+ *
+ * @return int32_t 0 when all the boards arrived, -1 when a board failed
+ */
+int32_t board_sync_start() {
+  struct timespec ts;
+  uint32_t generation;
+  int32_t status;
+
+  if (g_board_sync == NULL) return 0;
+
+  pthread_mutex_lock(&g_board_sync->lock);
+  generation = g_board_sync->generation;
+  if (++g_board_sync->arrived == g_board_sync->expected) {
+    clock_gettime(CLOCK_REALTIME, &ts);
+    g_board_sync->releaseTime = (uint64_t)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+    g_board_sync->arrived = 0;
+    g_board_sync->generation++;
+    pthread_cond_broadcast(&g_board_sync->cond);
+  }
+  while ((generation == g_board_sync->generation) && !g_board_sync->aborted) {
+    pthread_cond_wait(&g_board_sync->cond, &g_board_sync->lock);
+  }
+  status = g_board_sync->aborted ? -1 : 0;
+  pthread_mutex_unlock(&g_board_sync->lock);
+  return status;
+}
+
+/**
+ * @brief Release the boards waiting at the start-frame barrier
+ *
+ * Called when a board will not reach the barrier anymore. The following
+ * board_sync_start() calls fail on all the boards.
+ */
+void board_sync_abort() {
+  if (g_board_sync == NULL) return;
+
+  pthread_mutex_lock(&g_board_sync->lock);
+  g_board_sync->aborted = 1;
+  pthread_cond_broadcast(&g_board_sync->cond);
+  pthread_mutex_unlock(&g_board_sync->lock);
+}
+
+static int32_t board_rendezvous(void *arg) {
+  return board_sync_start();
+}
+
+/**
+ * @brief Print the dispatch skew of a frame start/stop
+ *
+ * With several boards, the dispatch of the master is given relative to the
+ * release of the barrier between the boards (common to all the boards).
+ *
+ * @param name Name of the trigger
+ * @param sync Dispatch times
+ */
+void print_frame_skew(const char *name, const mmwlFrameSync_t *sync) {
+#if DEV_ENV
+  printf("[MMWCAS-RF] %s skew: slaves %.1f us, master +%.1f us", name,
+    sync->slaveSkew * 1e-3, sync->masterDelay * 1e-3);
+  if ((g_board_sync != NULL) && (sync->dispatchTime[0] != 0U)) {
+    printf(", board +%.1f us",
+      (double)(int64_t)(sync->dispatchTime[0] - g_board_sync->releaseTime) * 1e-3);
+  }
+  printf("\n");
+#endif
+}
+
+/**
+ * @brief Set the capture the next frame triggers are recorded for
+ *
+ * The triggers are written into "<local copy>.mmwalign", shared by the
+ * boards recording the same capture directory (see cap/align.h).
+ *
+ * @param capture_dir Name of the capture directory
+ * @param config Device configuration of the capture
+ */
+void align_begin(const char *capture_dir, const devConfig_t *config) {
+  char dir_path[256];
+
+  memset(&g_align_board, 0, sizeof(g_align_board));
+  snprintf(g_align_board.ipAddr, sizeof(g_align_board.ipAddr), "%s", g_ip_addr);
+  g_align_board.framePeriod = frame_period(config, &g_align_board.numFrames);
+  g_align_board.deviceMap = config->deviceMap;
+  g_align_board.boardIndex = g_board_index;
+  snprintf(g_align_capture, sizeof(g_align_capture), "%s", capture_dir);
+  local_capture_path(dir_path, sizeof(dir_path), capture_dir);
+  snprintf(g_align_path, sizeof(g_align_path), "%s%s", dir_path, CAP_ALIGN_EXTENSION);
+}
+
+/**
+ * @brief Record a frame start or stop into the alignment index
+ *
+ * @param flag CAP_ALIGN_STARTED or CAP_ALIGN_STOPPED
+ * @param sync Dispatch times of the trigger
+ */
+void align_record(uint8_t flag, const mmwlFrameSync_t *sync) {
+  capAlignBoard_t *board = &g_align_board;
+
+  if (g_align_path[0] == '\0') return;
+  for (uint8_t devId = 0; devId < CAP_MAX_DEVICES; devId++) {
+    if (flag == CAP_ALIGN_STARTED) {
+      board->startTime[devId] = sync->dispatchTime[devId];
+      board->startMono[devId] = sync->dispatchMono[devId];
+      board->startEvent[devId] = sync->eventTime[devId];
+    } else {
+      board->stopTime[devId] = sync->dispatchTime[devId];
+      board->stopMono[devId] = sync->dispatchMono[devId];
+      board->stopEvent[devId] = sync->eventTime[devId];
+    }
+  }
+  if (flag == CAP_ALIGN_STARTED) {
+    // Common to the boards released by the same barrier
+    board->sessionTime = (g_board_sync != NULL) ? g_board_sync->releaseTime : sync->releaseTime;
+    board->flags = CAP_ALIGN_STARTED;
+  } else {
+    board->flags |= CAP_ALIGN_STOPPED;
+  }
+  if (cap_align_write(g_align_path, g_align_capture, g_num_boards, board) != 0) {
+    printf("[MMWCAS] Cannot write the alignment index %s\n", g_align_path);
+  }
+}
+
+/**
+ * @brief Start framing on all the devices, at the same time on all the boards
+ *
+ * The frame trigger of the slaves is staged before the barrier between the
+ * boards and released right after it, the master follows as soon as the
+ * slaves are ready.
+ *
+ * @param deviceMap Devices to start
+ * @param aborted Set when a board failed before reaching the barrier
+ *  (can be NULL)
+ * @return int32_t Status
+ */
+int32_t start_frame(unsigned char deviceMap, uint8_t *aborted) {
+  mmwlFrameSync_t sync = { .rendezvous = board_rendezvous };
+  int32_t status;
+
+  // The health of the capture starts with its first frame
+  MMWL_healthReset(&g_health);
+  status = MMWL_StartFrameSync(deviceMap, &sync);
+
+  if (aborted != NULL) *aborted = sync.aborted;
+  if (status == 0) {
+    print_frame_skew("Start", &sync);
+    align_record(CAP_ALIGN_STARTED, &sync);
+  }
+  return status;
+}
+
+/**
+ * @brief Arm the TDA, counting the attempts and failures of the metrics
+ *
+ * @param tdaCfg TDA arming configuration
+ * @return int32_t Status of MMWL_ArmingTDA
+ */
+int32_t arm_tda(rlTdaArmCfg_t tdaCfg) {
+  int32_t status = MMWL_ArmingTDA(tdaCfg);
+
+  metrics_add(METRICS_ARM_ATTEMPTS, 1);
+  if (status != 0) metrics_add(METRICS_ARM_FAILURES, 1);
+  return status;
+}
+
+/**
+ * @brief Stop framing on all the devices
+ *
+ * Same staging as start_frame(), without barrier between the boards: each
+ * board stops at the end of its own recording time.
+ *
+ * @param deviceMap Devices to stop
+ * @return int32_t Status
+ */
+int32_t stop_frame(unsigned char deviceMap) {
+  mmwlFrameSync_t sync = { 0 };
+  int32_t status = MMWL_StopFrameSync(deviceMap, &sync);
+
+  if (status == 0) print_frame_skew("Stop", &sync);
+  if ((status == 0) && (g_align_board.flags & CAP_ALIGN_STARTED)) {
+    align_record(CAP_ALIGN_STOPPED, &sync);
+  }
+  MMWL_healthCollect(&g_health);
+  return status;
+}
+
+/**
+ * @brief Record until a deadline
+ *
+ * The monitoring reports are aggregated every MONITOR_HEALTH_POLL seconds
+ * meanwhile, so the ring of each device never fills up.
+ *
+ * @param deadline End of the recording (CLOCK_MONOTONIC)
+ * @param stop Set to end the recording early (can be NULL)
+ */
+void record_until(const struct timespec *deadline, volatile sig_atomic_t *stop) {
+  struct timespec wakeup;
+
+  while ((stop == NULL) || !*stop) {
+    clock_gettime(CLOCK_MONOTONIC, &wakeup);
+    if ((wakeup.tv_sec > deadline->tv_sec) ||
+        ((wakeup.tv_sec == deadline->tv_sec) && (wakeup.tv_nsec >= deadline->tv_nsec))) {
+      break;
+    }
+    wakeup.tv_sec += MONITOR_HEALTH_POLL;
+    if ((wakeup.tv_sec > deadline->tv_sec) ||
+        ((wakeup.tv_sec == deadline->tv_sec) && (wakeup.tv_nsec > deadline->tv_nsec))) {
+      wakeup = *deadline;
+    }
+    clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &wakeup, NULL);
+    MMWL_healthCollect(&g_health);
+  }
+}
+
+/**
+ * @brief Drive several DSP boards from one invocation
+ *
+ * mmWaveLink and the TDA Ethernet port keep their state per process (one
+ * cascade of 4 devices per instance), so each board is configured and
+ * controlled by its own child process. The boards are configured
+ * concurrently and meet at a shared barrier before framing starts.
+ *
+ * @param boards Board contexts
+ * @param nBoards Number of boards
+ * @return int Index of the board to drive in a child process. The parent
+ *  process exits once all the boards are done.
+ */
+int run_boards(boardCtx_t *boards, uint8_t nBoards) {
+  pthread_mutexattr_t mutexAttr;
+  pthread_condattr_t condAttr;
+  int failed = 0;
+
+  g_board_sync = mmap(NULL, sizeof(boardSync_t), PROT_READ | PROT_WRITE,
+    MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+  if (g_board_sync == MAP_FAILED) {
+    perror("[MMWCAS] Board barrier allocation failed");
+    exit(1);
+  }
+  memset(g_board_sync, 0, sizeof(boardSync_t));
+  g_board_sync->expected = nBoards;
+
+  pthread_mutexattr_init(&mutexAttr);
+  pthread_mutexattr_setpshared(&mutexAttr, PTHREAD_PROCESS_SHARED);
+  pthread_mutex_init(&g_board_sync->lock, &mutexAttr);
+  pthread_condattr_init(&condAttr);
+  pthread_condattr_setpshared(&condAttr, PTHREAD_PROCESS_SHARED);
+  pthread_cond_init(&g_board_sync->cond, &condAttr);
+
+  fflush(stdout);
+  for (uint8_t i = 0; i < nBoards; i++) {
+    pid_t pid = fork();
+    if (pid == 0) return i;
+    if (pid < 0) {
+      perror("[MMWCAS] fork failed");
+      boards[i].status = -1;
+      failed++;
+      // The boards already started must not wait for this one at the barrier
+      board_sync_abort();
+      continue;
+    }
+    boards[i].pid = pid;
+  }
+
+  for (uint8_t done = 0; done < nBoards - failed; done++) {
+    int wstatus = 0;
+    pid_t pid = wait(&wstatus);
+    if (pid < 0) break;
+
+    for (uint8_t i = 0; i < nBoards; i++) {
+      if (boards[i].pid != pid) continue;
+      boards[i].status = WIFEXITED(wstatus) ? WEXITSTATUS(wstatus) : -1;
+    }
+    /* Release the boards waiting for one that will never come */
+    if (!WIFEXITED(wstatus) || WEXITSTATUS(wstatus)) {
+      board_sync_abort();
+    }
+  }
+
+  failed = 0;
+  for (uint8_t i = 0; i < nBoards; i++) {
+    printf("[MMWCAS] Board %s: %s\n", boards[i].ipAddr,
+      boards[i].status ? CRED "FAILED" CRESET : CGREEN "OK" CRESET);
+    if (boards[i].status) failed++;
+  }
+  exit(failed ? 1 : 0);
+}
+
+/**
+ * @brief Helper function to convert hex string to integer
+ */
+static unsigned int hex_string_to_int(const char* hex_str) {
+    unsigned int value = 0;
+    sscanf(hex_str, "0x%x", &value);
+    return value;
+}
+
+/**
+ * @brief Export device configuration to mmwave.json format
+ * 
+ * @param config Device configuration structure
+ * @param filename Output JSON filename
+ * @param num_devices Number of cascade devices (1-4)
+ * @return int 0 on success, -1 on failure
+ */
+int export_config_to_json(devConfig_t config, const char* filename, int num_devices) {
+    jsonDevConfig_t json_config;
+
+    // Zeroed first: the serializer compares configurations with memcmp
+    memset(&json_config, 0, sizeof(json_config));
+    json_config.profileCfg = config.profileCfg;
+    json_config.frameCfg = config.frameCfg;
+    json_config.channelCfg = config.channelCfg;
+    json_config.adcOutCfg = config.adcOutCfg;
+    json_config.lpmCfg = config.lpmCfg;
+    json_config.miscCfg = config.miscCfg;
+    json_config.ldoCfg = config.ldoCfg;
+    json_config.dataFmtCfg = config.dataFmtCfg;
+    json_config.datapathCfg = config.datapathCfg;
+    json_config.datapathClkCfg = config.datapathClkCfg;
+    json_config.csi2LaneCfg = config.csi2LaneCfg;
+    json_config.advFrameCfg = config.advFrameCfg;
+    memcpy(json_config.subProfileCfg, config.subProfileCfg, sizeof(json_config.subProfileCfg));
+
+    if (json_export_config(filename, &json_config, num_devices) != 0) {
+        printf("Error: Cannot create file %s\n", filename);
+        return -1;
+    }
+    printf("Successfully exported configuration to %s\n", filename);
+    return 0;
+}
+
+
+/**
+ * @brief Export the RF health of the last capture next to its configuration
+ *
+ * `<capture>.health.json` is written from the reports aggregated since the
+ * capture started, only when RF health monitors are enabled.
+ *
+ * @param config Device configuration structure
+ * @param filename Configuration JSON filename (`<capture>.mmwave.json`)
+ * @param num_devices Number of cascade devices (1-4)
+ * @return int 0 on success, -1 on failure
+ */
+int export_health_to_json(devConfig_t config, const char* filename, int num_devices) {
+    const char suffix[] = ".mmwave.json";
+    size_t length = strlen(filename);
+    char health_filename[256];
+
+    if (config.monCfg.enable == 0) return 0;
+    if ((length >= sizeof(suffix) - 1) &&
+        (strcmp(filename + length - (sizeof(suffix) - 1), suffix) == 0)) {
+        length -= sizeof(suffix) - 1;
+    }
+    snprintf(health_filename, sizeof(health_filename), "%.*s.health.json", (int)length, filename);
+
+    MMWL_healthCollect(&g_health);
+    if (json_export_health(health_filename, &g_health, num_devices) != 0) {
+        printf("Error: Cannot create file %s\n", health_filename);
+        return -1;
+    }
+    printf("Successfully exported RF health to %s\n", health_filename);
+    return 0;
+}
+
+
+/**
+ * @brief Name of a daemon state
+ *
+ * @param state DAEMON_STATE_*
+ * @return const char* State name
+ */
+const char* daemon_state_name(uint8_t state) {
+  switch (state) {
+    case DAEMON_STATE_CONFIGURED: return "configured";
+    case DAEMON_STATE_ARMED: return "armed";
+    case DAEMON_STATE_FRAMING: return "framing";
+    default: return "unknown";
+  }
+}
+
+/**
+ * @brief Answer a control request with a status and a message
+ *
+ * @param ctx Daemon context
+ * @param cfd Client socket
+ * @param status Status of the request (0 on success)
+ * @param message Message (must not need JSON escaping)
+ * @return int 0 on success, -1 if the client is gone
+ */
+int daemon_reply(daemonCtx_t *ctx, int cfd, int status, const char *message) {
+  return ctl_reply(cfd, "\"status\": %d, \"state\": \"%s\", \"message\": \"%s\"",
+    status, daemon_state_name(ctx->state), message);
+}
+
+/**
+ * @brief Check that a capture directory name is a single, plain path element
+ *
+ * @param name Capture directory name
+ * @return uint8_t TRUE if valid
+ */
+uint8_t is_valid_capture_dir(const char *name) {
+  size_t length = strlen(name);
+
+  if ((length == 0) || (length >= 128) || (name[0] == '.')) return FALSE;
+  for (size_t i = 0; i < length; i++) {
+    char c = name[i];
+    if (((c < 'a') || (c > 'z')) && ((c < 'A') || (c > 'Z')) &&
+        ((c < '0') || (c > '9')) && (c != '_') && (c != '-') && (c != '.')) {
+      return FALSE;
+    }
+  }
+  return TRUE;
+}
+
+/**
+ * @brief Value of a boolean request field
+ *
+ * @param req Control request
+ * @param key Field name
+ * @return uint8_t TRUE if the field is set to true or a non zero number
+ */
+uint8_t ctl_get_bool(ctlRequest_t *req, const char *key) {
+  const char *value = ctl_get(req, key);
+
+  if (value == NULL) return FALSE;
+  if (strcmp(value, "true") == 0) return TRUE;
+  return atoi(value) != 0;
+}
+
+/**
+ * @brief Stop framing on all the devices
+ *
+ * @param ctx Daemon context
+ * @return int32_t Status
+ */
+int32_t daemon_stop_frame(daemonCtx_t *ctx) {
+  int32_t status = stop_frame(ctx->config.deviceMap);
 
-  status += MMWL_dataFmtConfig(config.deviceMap, config.dataFmtCfg);
   check(status,
-    "[ALL] Data format configuration successful!",
-    "[ALL] Data format configuration failed!", config.deviceMap, TRUE);
+    "[MMWCAS-RF] Framing stopped",
+    "[MMWCAS-RF] Failed to stop framing!", ctx->config.deviceMap, FALSE);
+  if (status == 0) ctx->state = DAEMON_STATE_ARMED;
+  return status;
+}
 
-  status += MMWL_lowPowerConfig(config.deviceMap, config.lpmCfg);
-  check(status,
-    "[ALL] Low Power Mode configuration successful!",
-    "[ALL] Low Power Mode configuration failed!", config.deviceMap, TRUE);
+/**
+ * @brief De-arm the TDA and export the configuration of the capture
+ *
+ * @param ctx Daemon context
+ * @param transfer Copy the capture to the host in background
+ * @return int32_t Status
+ */
+int32_t daemon_dearm(daemonCtx_t *ctx, uint8_t transfer) {
+  char json_filename[256];
+  int32_t status = 0;
 
-  status += MMWL_ApllSynthBwConfig(config.deviceMap);
-  status += MMWL_setMiscConfig(config.deviceMap, config.miscCfg);
-  status += MMWL_rfInit(config.deviceMap);
+  status = MMWL_DeArmingTDA();
   check(status,
-    "[ALL] RF successfully initialized!",
-    "[ALL] RF init failed!", config.deviceMap, TRUE);
+    "[MMWCAS-DSP] TDA de-armed",
+    "[MMWCAS-DSP] Failed to de-arm TDA board!", 32, FALSE);
+  if (status != 0) return status;
+
+  ctx->state = DAEMON_STATE_CONFIGURED;
+  ctx->captures++;
+  sprintf(json_filename, "%s.mmwave.json", ctx->captureDir);
+  export_config_to_json(ctx->config, json_filename, 4);
+  export_health_to_json(ctx->config, json_filename, 4);
+  if (transfer) {
+    start_async_transfer(ctx->captureDir, ctx->captures);
+  }
+  return status;
+}
 
-  status += MMWL_dataPathConfig(config.deviceMap, config.datapathCfg);
-  status += MMWL_hsiClockConfig(config.deviceMap, config.datapathClkCfg, config.hsClkCfg);
-  status += MMWL_CSI2LaneConfig(config.deviceMap, config.csi2LaneCfg);
-  check(status,
-    "[ALL] Datapath configuration successful!",
-    "[ALL] Datapath configuration failed!", config.deviceMap, TRUE);
+/**
+ * @brief Serve a control request
+ *
+ * Requests (field "cmd"):
+ *  - status: Report the state of the daemon
+ *  - arm: Arm the TDA. Optional "capture_dir"
+ *  - start: Start framing on all the devices
+ *  - stop: Stop framing
+ *  - dearm: De-arm the TDA. Optional "transfer" to copy the capture
+ *  - reconfigure: Apply a new configuration. Optional "cfg" (TOML file)
+ *    and "full"
+ *  - shutdown: Stop any capture in progress and exit
+ *
+ * @param ctx Daemon context
+ * @param cfd Client socket
+ * @param req Control request
+ * @return int 0 on success, -1 if the client is gone
+ */
+int daemon_handle(daemonCtx_t *ctx, int cfd, ctlRequest_t *req) {
+  const char *cmd = ctl_get(req, "cmd");
+  int32_t status = 0;
 
-  status += MMWL_profileConfig(config.deviceMap, config.profileCfg);
-  check(status,
-    "[ALL] Profile configuration successful!",
-    "[ALL] Profile configuration failed!", config.deviceMap, TRUE);
+  if (cmd == NULL) {
+    return daemon_reply(ctx, cfd, RL_RET_CODE_INVALID_INPUT, "missing cmd");
+  }
 
-  // MIMO Chirp configuration
-  for (uint8_t devId = 0; devId < 4; devId++) {
-    status += configureMimoChirp(devId, config.chirpCfg);
+  if (strcmp(cmd, "status") == 0) {
+    return ctl_reply(cfd,
+      "\"status\": 0, \"state\": \"%s\", \"ip\": \"%s\", \"capture_dir\": \"%s\", "
+      "\"captures\": %u, \"uptime\": %ld",
+      daemon_state_name(ctx->state), g_ip_addr, ctx->captureDir,
+      ctx->captures, (long)(time(NULL) - ctx->startTime));
   }
-  check(status,
-    "[ALL] Chirp configuration successful!",
-    "[ALL] Chirp configuration failed!", config.deviceMap, TRUE);
 
-  // Master frame config.
-  status += MMWL_frameConfig(
-    config.masterMap,
-    config.frameCfg,
-    config.channelCfg,
-    config.adcOutCfg,
-    config.datapathCfg,
-    config.profileCfg
-  );
-  check(status,
-    "[MASTER] Frame configuration completed!",
-    "[MASTER] Frame configuration failed!", config.masterMap, TRUE);
+  if (strcmp(cmd, "arm") == 0) {
+    const char *dir = ctl_get(req, "capture_dir");
+    char default_dir[64];
 
-  // Slaves frame config
-  status += MMWL_frameConfig(
-    config.slavesMap,
-    config.frameCfg,
-    config.channelCfg,
-    config.adcOutCfg,
-    config.datapathCfg,
-    config.profileCfg
-  );
-  check(status,
-    "[SLAVE] Frame configuration completed!",
-    "[SLAVE] Frame configuration failed!", config.slavesMap, TRUE);
+    if (ctx->state != DAEMON_STATE_CONFIGURED) {
+      return daemon_reply(ctx, cfd, RL_RET_CODE_INVALID_INPUT, "TDA already armed");
+    }
+    if (dir == NULL) {
+      sprintf(default_dir, "MMWL_Capture_%lu", (unsigned long)time(NULL));
+      dir = default_dir;
+    }
+    if (!is_valid_capture_dir(dir)) {
+      return daemon_reply(ctx, cfd, RL_RET_CODE_INVALID_INPUT, "invalid capture_dir");
+    }
+    strcpy(ctx->captureDir, dir);
+    sprintf(ctx->fullCapturePath, "%s%s", ctx->capturePath, ctx->captureDir);
+    ctx->tdaCfg.captureDirectory = ctx->fullCapturePath;
 
-  check(status,
-    "[MIMO] Configuration completed!\n",
-    "[MIMO] Configuration completed with error!", config.deviceMap, TRUE);
-}
+    status = arm_tda(ctx->tdaCfg);
+    check(status,
+      "[MMWCAS-DSP] Arming TDA",
+      "[MMWCAS-DSP] TDA Arming failed!", 32, FALSE);
+    if (status == 0) ctx->state = DAEMON_STATE_ARMED;
+    return daemon_reply(ctx, cfd, status, (status == 0) ? "armed" : "arming failed");
+  }
 
+  if (strcmp(cmd, "start") == 0) {
+    if (ctx->state != DAEMON_STATE_ARMED) {
+      return daemon_reply(ctx, cfd, RL_RET_CODE_INVALID_INPUT, "TDA not armed or already framing");
+    }
+    // Start framing (at the same time on all the boards)
+    align_begin(ctx->captureDir, &ctx->config);
+    status = start_frame(ctx->config.deviceMap, NULL);
+    check(status,
+      "[MMWCAS-RF] Framing ...",
+      "[MMWCAS-RF] Failed to initiate framing!", ctx->config.deviceMap, FALSE);
+    if (status == 0) ctx->state = DAEMON_STATE_FRAMING;
+    return daemon_reply(ctx, cfd, status, (status == 0) ? "framing" : "start failed");
+  }
 
-/**
- * @brief Routine to close trace file
- * 
- */
-FILE* rls_traceF = NULL;
-void CloseTraceFile() {
-  if (rls_traceF != NULL) {
-    fclose(rls_traceF);
-    rls_traceF = NULL;
+  if (strcmp(cmd, "stop") == 0) {
+    if (ctx->state != DAEMON_STATE_FRAMING) {
+      return daemon_reply(ctx, cfd, RL_RET_CODE_INVALID_INPUT, "not framing");
+    }
+    status = daemon_stop_frame(ctx);
+    return daemon_reply(ctx, cfd, status, (status == 0) ? "stopped" : "stop failed");
   }
-}
 
-// Pointer to the CLI option parser
-parser_t *g_parser = NULL;
+  if (strcmp(cmd, "dearm") == 0) {
+    if (ctx->state != DAEMON_STATE_ARMED) {
+      return daemon_reply(ctx, cfd, RL_RET_CODE_INVALID_INPUT, "TDA not armed or still framing");
+    }
+    status = daemon_dearm(ctx, ctl_get_bool(req, "transfer"));
+    return daemon_reply(ctx, cfd, status, (status == 0) ? "de-armed" : "de-arming failed");
+  }
 
-/**
- * Print program version
- */
-void print_version() {
-  printf(PROG_NAME " version " PROG_VERSION ", " PROG_COPYRIGHT "\n");
-  exit(0);
+  if (strcmp(cmd, "reconfigure") == 0) {
+    const char *filename = ctl_get(req, "cfg");
+    devConfig_t config;
+
+    if (ctx->state != DAEMON_STATE_CONFIGURED) {
+      return daemon_reply(ctx, cfd, RL_RET_CODE_INVALID_INPUT, "de-arm the TDA first");
+    }
+    if ((filename != NULL) && (access(filename, R_OK) != 0)) {
+      return daemon_reply(ctx, cfd, RL_RET_CODE_INVALID_INPUT, "cannot read cfg");
+    }
+    if (load_config(&config, (unsigned char *)filename) != 0) {
+      return daemon_reply(ctx, cfd, RL_RET_CODE_INVALID_INPUT, "invalid cfg");
+    }
+    // A failed stage is reported to the client instead of exiting
+    g_check_fatal = FALSE;
+    status = (int32_t)configure(config, ctl_get_bool(req, "full"));
+    g_check_fatal = TRUE;
+    if (status != 0) {
+      return daemon_reply(ctx, cfd, status, "configuration failed");
+    }
+    ctx->config = config;
+    ctx->tdaCfg.framePeriodicity = tda_frame_period(&config);
+    return daemon_reply(ctx, cfd, 0, "configured");
+  }
+
+  if (strcmp(cmd, "shutdown") == 0) {
+    if (ctx->state == DAEMON_STATE_FRAMING) daemon_stop_frame(ctx);
+    if (ctx->state == DAEMON_STATE_ARMED) daemon_dearm(ctx, FALSE);
+    ctx->running = FALSE;
+    return daemon_reply(ctx, cfd, 0, "shutting down");
+  }
+
+  return daemon_reply(ctx, cfd, RL_RET_CODE_INVALID_INPUT, "unknown cmd");
 }
 
 /**
- * @brief Print CLI options help and exit
+ * @brief Remove the control socket file at exit
  */
-void help() {
-  print_help(g_parser);
-  exit(0);
+void daemon_cleanup() {
+  if (g_daemon_socket[0] != '\0') {
+    unlink(g_daemon_socket);
+  }
 }
 
 /**
- * @brief Free the parser to cleanup any dynamically allocated memory
+ * @brief Keep the devices configured and serve control requests
+ *
+ * The TDA connection and the RF configuration are kept across captures, so
+ * a new capture only costs an arm/start/stop/de-arm sequence. Clients are
+ * served one at a time over a local UNIX socket (see ctl/ctl.h).
+ *
+ * @note: A failure during a reconfiguration is replied to the client and
+ * the daemon keeps serving. The configuration state file is cleared before
+ * a full sequence and only saved on success, so the next reconfiguration
+ * runs the full sequence.
+ *
+ * @param config Configuration applied to the devices
+ * @param tdaCfg TDA arming config
+ * @param capture_path Root capture path on the DSP board
+ * @param socket_path Path of the control socket
+ * @return int Exit status
  */
-void cleanup() {
-  free_parser(g_parser);
+int run_daemon(devConfig_t config, rlTdaArmCfg_t tdaCfg,
+               const char *capture_path, const char *socket_path) {
+  daemonCtx_t ctx;
+  ctlRequest_t req;
+  int sfd, cfd;
+  int status;
+
+  memset(&ctx, 0, sizeof(ctx));
+  ctx.config = config;
+  ctx.tdaCfg = tdaCfg;
+  strncpy(ctx.capturePath, capture_path, sizeof(ctx.capturePath) - 1);
+  ctx.state = DAEMON_STATE_CONFIGURED;
+  ctx.startTime = time(NULL);
+  ctx.running = TRUE;
+
+  sfd = ctl_open(socket_path);
+  check((sfd < 0) ? -1 : 0,
+    "[DAEMON] Control socket open",
+    "[DAEMON] Couldn't open the control socket!", 32, TRUE);
+  strncpy(g_daemon_socket, socket_path, sizeof(g_daemon_socket) - 1);
+  atexit(daemon_cleanup);
+  signal(SIGTERM, signal_handler);
+#if DEV_ENV
+  printf("[DAEMON] Listening on %s\n", socket_path);
+#endif
+
+  while (ctx.running) {
+    cfd = ctl_accept(sfd);
+    if (cfd < 0) continue;
+
+    req.length = 0;
+    req.consumed = 0;
+    while (ctx.running) {
+      status = ctl_read(cfd, &req);
+      if (status < 0) break;
+      if (status > 0) {
+        status = daemon_reply(&ctx, cfd, RL_RET_CODE_INVALID_INPUT, "malformed request");
+      } else {
+        status = daemon_handle(&ctx, cfd, &req);
+      }
+      if (status != 0) break;
+    }
+    close(cfd);
+  }
+
+  ctl_close(sfd, socket_path);
+  g_daemon_socket[0] = '\0';
+  return 0;
 }
 
+
+// Set by CTRL+C to end the continuous monitoring after the current capture
+static volatile sig_atomic_t g_monitor_stop = 0;
+
 /**
- * @brief Called when the user presses CTRL+C
+ * @brief Called when the user presses CTRL+C in monitoring mode
  *
- * This aim to explicitly call the exit function so that
- * dynamically allocated memory could be freed
+ * The first CTRL+C lets the current capture and the queued transfers
+ * complete. The second one exits right away.
  */
-void signal_handler () {
-  exit(1);
+void monitor_signal_handler() {
+  if (g_monitor_stop) exit(1);
+  g_monitor_stop = 1;
 }
 
 /**
- * @brief Helper function to convert hex string to integer
+ * @brief Wait before retrying a failed capture
+ *
+ * The delay doubles on each consecutive failure, from MONITOR_RETRY_MIN_MS
+ * up to MONITOR_RETRY_MAX_MS. CTRL+C ends the wait.
+ *
+ * @param delay_ms Delay to wait, updated for the next failure
  */
-static unsigned int hex_string_to_int(const char* hex_str) {
-    unsigned int value = 0;
-    sscanf(hex_str, "0x%x", &value);
-    return value;
+void monitor_backoff(uint32_t *delay_ms) {
+  struct timespec deadline;
+
+  clock_gettime(CLOCK_MONOTONIC, &deadline);
+  deadline.tv_sec += *delay_ms / 1000;
+  deadline.tv_nsec += (long)(*delay_ms % 1000) * 1000000L;
+  if (deadline.tv_nsec >= 1000000000L) {
+    deadline.tv_sec++;
+    deadline.tv_nsec -= 1000000000L;
+  }
+  // Interrupted by the signals, checked again after each one
+  while (!g_monitor_stop &&
+         (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &deadline, NULL) == EINTR));
+  *delay_ms = (*delay_ms * 2 > MONITOR_RETRY_MAX_MS) ? MONITOR_RETRY_MAX_MS : *delay_ms * 2;
 }
 
 /**
- * @brief Export device configuration to mmwave.json format
- * 
- * @param config Device configuration structure
- * @param filename Output JSON filename
- * @param num_devices Number of cascade devices (1-4)
- * @return int 0 on success, -1 on failure
+ * @brief Continuous monitoring: back to back captures of `interval` seconds
+ *
+ * Each capture is armed, recorded and finalized on this thread, each stage
+ * starting as soon as the previous one completed. The finalized captures
+ * are copied to the host and verified by up to `jobs` transfer workers
+ * while the next capture is recorded. At most `backlog` captures wait for
+ * a transfer; the next capture is held back when the queue is full.
+ *
+ * @param config Configuration applied to the devices
+ * @param tdaCfg TDA arming config
+ * @param capture_path Root capture path on the DSP board
+ * @param interval Duration of each capture (s)
+ * @param backlog Maximum number of captures waiting for a transfer
+ * @param jobs Maximum number of concurrent transfers
+ * @return int Exit status
  */
-int export_config_to_json(devConfig_t config, const char* filename, int num_devices) {
-    FILE* fp = fopen(filename, "w");
-    if (fp == NULL) {
-        printf("Error: Cannot create file %s\n", filename);
-        return -1;
+int run_monitor(devConfig_t config, rlTdaArmCfg_t tdaCfg, const char *capture_path,
+                int interval, uint32_t backlog, uint8_t jobs) {
+  char full_capture_path[256];
+  char json_filename[256];
+  struct timespec deadline;
+  schedTask_t task;
+  sched_t sched;
+  uint32_t capture_count = 0;
+  uint32_t retry_ms = MONITOR_RETRY_MIN_MS;
+  uint8_t aborted = 0;
+  uint64_t start;
+  int32_t status;
+
+  status = sched_init(&sched, backlog, jobs, transfer_capture, verify_capture);
+  check(status,
+    "[MONITOR] Transfer workers started",
+    "[MONITOR] Couldn't start the transfer workers!", 32, TRUE);
+  metrics_register(sched_write_metrics, &sched);
+  signal(SIGINT, monitor_signal_handler);
+  signal(SIGTERM, monitor_signal_handler);
+
+  printf("[MONITOR] Starting continuous monitoring mode\n");
+  printf("[MONITOR] Interval: %d seconds | transfers in flight: %u | backlog: %u\n",
+    interval, jobs, backlog);
+
+  while (!g_monitor_stop) {
+    memset(&task, 0, sizeof(task));
+    task.captureId = capture_count + 1;
+    sprintf(task.captureDir, "MMWL_Capture_%lu", (unsigned long)time(NULL));
+    sprintf(full_capture_path, "%s%s", capture_path, task.captureDir);
+    tdaCfg.captureDirectory = full_capture_path;
+    printf("\n[MONITOR #%u] Starting capture: %s\n", task.captureId, task.captureDir);
+
+    // Arm: done once the TDA acknowledged the whole arming sequence
+    start = sched_now();
+    status = arm_tda(tdaCfg);
+    check(status,
+      "[MMWCAS-DSP] Arming TDA",
+      "[MMWCAS-DSP] TDA Arming failed!", 32, FALSE);
+    sched_stage_done(&sched, SCHED_STAGE_ARM, start);
+    if (status != 0) {
+      printf("[MONITOR] Warning: TDA arming failed, retrying in %u ms...\n", retry_ms);
+      monitor_backoff(&retry_ms);
+      continue;
     }
 
-    // Get current timestamp
-    time_t now = time(NULL);
-    struct tm* tm_info = localtime(&now);
-    char timestamp[64];
-    strftime(timestamp, sizeof(timestamp), "%Y-%m-%dT%H:%M:%S", tm_info);
-
-    // Start JSON
-    fprintf(fp, "{\n");
-    
-    // Config Generator
-    fprintf(fp, "  \"configGenerator\": {\n");
-    fprintf(fp, "    \"createdBy\": \"mmwave-cli\",\n");
-    fprintf(fp, "    \"createdOn\": \"%s+09:00\",\n", timestamp);
-    fprintf(fp, "    \"isConfigIntermediate\": 1\n");
-    fprintf(fp, "  },\n");
-
-    // Versions
-    fprintf(fp, "  \"currentVersion\": {\n");
-    fprintf(fp, "    \"jsonCfgVersion\": {\n");
-    fprintf(fp, "      \"major\": 0,\n");
-    fprintf(fp, "      \"minor\": 4,\n");
-    fprintf(fp, "      \"patch\": 0\n");
-    fprintf(fp, "    },\n");
-    fprintf(fp, "    \"DFPVersion\": {\n");
-    fprintf(fp, "      \"major\": 2,\n");
-    fprintf(fp, "      \"minor\": 2,\n");
-    fprintf(fp, "      \"patch\": 0\n");
-    fprintf(fp, "    },\n");
-    fprintf(fp, "    \"SDKVersion\": {\n");
-    fprintf(fp, "      \"major\": 3,\n");
-    fprintf(fp, "      \"minor\": 3,\n");
-    fprintf(fp, "      \"patch\": 0\n");
-    fprintf(fp, "    },\n");
-    fprintf(fp, "    \"mmwavelinkVersion\": {\n");
-    fprintf(fp, "      \"major\": 2,\n");
-    fprintf(fp, "      \"minor\": 2,\n");
-    fprintf(fp, "      \"patch\": 0\n");
-    fprintf(fp, "    }\n");
-    fprintf(fp, "  },\n");
-
-    // Last Backward Compatible Version
-    fprintf(fp, "  \"lastBackwardCompatibleVersion\": {\n");
-    fprintf(fp, "    \"DFPVersion\": {\n");
-    fprintf(fp, "      \"major\": 2,\n");
-    fprintf(fp, "      \"minor\": 1,\n");
-    fprintf(fp, "      \"patch\": 0\n");
-    fprintf(fp, "    },\n");
-    fprintf(fp, "    \"SDKVersion\": {\n");
-    fprintf(fp, "      \"major\": 3,\n");
-    fprintf(fp, "      \"minor\": 0,\n");
-    fprintf(fp, "      \"patch\": 0\n");
-    fprintf(fp, "    },\n");
-    fprintf(fp, "    \"mmwavelinkVersion\": {\n");
-    fprintf(fp, "      \"major\": 2,\n");
-    fprintf(fp, "      \"minor\": 1,\n");
-    fprintf(fp, "      \"patch\": 0\n");
-    fprintf(fp, "    }\n");
-    fprintf(fp, "  },\n");
-
-    // Regulatory Restrictions
-    fprintf(fp, "  \"regulatoryRestrictions\": {\n");
-    fprintf(fp, "    \"frequencyRangeBegin_GHz\": 77,\n");
-    fprintf(fp, "    \"frequencyRangeEnd_GHz\": 81,\n");
-    fprintf(fp, "    \"maxBandwidthAllowed_MHz\": 4000,\n");
-    fprintf(fp, "    \"maxTransmitPowerAllowed_dBm\": 12\n");
-    fprintf(fp, "  },\n");
-
-    // System Config
-    fprintf(fp, "  \"systemConfig\": {\n");
-    fprintf(fp, "    \"summary\": \"Configuration exported from mmwave-cli\",\n");
-    fprintf(fp, "    \"sceneParameters\": {\n");
-    fprintf(fp, "      \"ambientTemperature_degC\": 20,\n");
-    fprintf(fp, "      \"maxDetectableRange_m\": 10,\n");
-    fprintf(fp, "      \"rangeResolution_cm\": 5,\n");
-    fprintf(fp, "      \"maxVelocity_kmph\": 26,\n");
-    fprintf(fp, "      \"velocityResolution_kmph\": 2,\n");
-    fprintf(fp, "      \"measurementRate\": 10,\n");
-    fprintf(fp, "      \"typicalDetectedObjectRCS\": 1.0\n");
-    fprintf(fp, "    }\n");
-    fprintf(fp, "  },\n");
-
-    // mmWave Devices Array
-    fprintf(fp, "  \"mmWaveDevices\": [\n");
-
-    // Calculate start frequency in GHz
-    float startFreq_GHz = (config.profileCfg.startFreqConst * 53.6441803) / (1000.0 * 1000.0 * 1000.0);
-    float freqSlope_MHz_usec = (config.profileCfg.freqSlopeConst * 48.2797623) / 1000.0;
-    float idleTime_usec = config.profileCfg.idleTimeConst * 0.01; // 1 LSB = 10ns
-    float adcStartTime_usec = config.profileCfg.adcStartTimeConst * 0.01;
-    float rampEndTime_usec = config.profileCfg.rampEndTime * 0.01;
-    float txStartTime_usec = config.profileCfg.txStartTime * 0.01;
-    float framePeriodicity_msec = (config.frameCfg.framePeriodicity * 5.0) / (1000.0 * 1000.0);
-
-    // Loop through devices
-    for (int devId = 0; devId < num_devices; devId++) {
-        fprintf(fp, "    {\n");
-        fprintf(fp, "      \"mmWaveDeviceId\": %d,\n", devId);
-        fprintf(fp, "      \"rfConfig\": {\n");
-        fprintf(fp, "        \"waveformType\": \"legacyFrameChirp\",\n");
-        fprintf(fp, "        \"MIMOScheme\": \"TDM\",\n");
-        fprintf(fp, "        \"rlCalibrationDataFile\": \"\",\n");
-
-        // Channel Config
-        fprintf(fp, "        \"rlChanCfg_t\": {\n");
-        fprintf(fp, "          \"rxChannelEn\": \"0x%X\",\n", config.channelCfg.rxChannelEn);
-        fprintf(fp, "          \"txChannelEn\": \"0x%X\",\n", config.channelCfg.txChannelEn);
-        fprintf(fp, "          \"cascading\": %d,\n", devId == 0 ? 1 : 2); // Master=1, Slave=2
-        fprintf(fp, "          \"cascadingPinoutCfg\": \"0x0\"\n");
-        fprintf(fp, "        },\n");
-
-        // ADC Out Config
-        fprintf(fp, "        \"rlAdcOutCfg_t\": {\n");
-        fprintf(fp, "          \"fmt\": {\n");
-        fprintf(fp, "            \"b2AdcBits\": %d,\n", config.adcOutCfg.fmt.b2AdcBits);
-        fprintf(fp, "            \"b8FullScaleReducFctr\": %d,\n", config.adcOutCfg.fmt.b8FullScaleReducFctr);
-        fprintf(fp, "            \"b2AdcOutFmt\": %d\n", config.adcOutCfg.fmt.b2AdcOutFmt);
-        fprintf(fp, "          }\n");
-        fprintf(fp, "        },\n");
-
-        // Low Power Mode Config
-        fprintf(fp, "        \"rlLowPowerModeCfg_t\": {\n");
-        fprintf(fp, "          \"lpAdcMode\": %d\n", config.lpmCfg.lpAdcMode);
-        fprintf(fp, "        },\n");
-
-        // Profile Config
-        fprintf(fp, "        \"rlProfiles\": [\n");
-        fprintf(fp, "          {\n");
-        fprintf(fp, "            \"rlProfileCfg_t\": {\n");
-        fprintf(fp, "              \"profileId\": %d,\n", config.profileCfg.profileId);
-        fprintf(fp, "              \"pfVcoSelect\": \"0x%X\",\n", config.profileCfg.pfVcoSelect);
-        fprintf(fp, "              \"pfCalLutUpdate\": \"0x0\",\n");
-        fprintf(fp, "              \"startFreqConst_GHz\": %.16f,\n", startFreq_GHz);
-        fprintf(fp, "              \"idleTimeConst_usec\": %.1f,\n", idleTime_usec);
-        fprintf(fp, "              \"adcStartTimeConst_usec\": %.16f,\n", adcStartTime_usec);
-        fprintf(fp, "              \"rampEndTime_usec\": %.15f,\n", rampEndTime_usec);
-        fprintf(fp, "              \"txOutPowerBackoffCode\": \"0x%X\",\n", config.profileCfg.txOutPowerBackoffCode);
-        fprintf(fp, "              \"txPhaseShifter\": \"0x%X\",\n", config.profileCfg.txPhaseShifter);
-        fprintf(fp, "              \"freqSlopeConst_MHz_usec\": %.15f,\n", freqSlope_MHz_usec);
-        fprintf(fp, "              \"txStartTime_usec\": %.1f,\n", txStartTime_usec);
-        fprintf(fp, "              \"numAdcSamples\": %d,\n", config.profileCfg.numAdcSamples);
-        fprintf(fp, "              \"digOutSampleRate\": %.1f,\n", (float)config.profileCfg.digOutSampleRate);
-        fprintf(fp, "              \"hpfCornerFreq1\": %d,\n", config.profileCfg.hpfCornerFreq1);
-        fprintf(fp, "              \"hpfCornerFreq2\": %d,\n", config.profileCfg.hpfCornerFreq2);
-        fprintf(fp, "              \"rxGain_dB\": \"0x%X\"\n", config.profileCfg.rxGain);
-        fprintf(fp, "            }\n");
-        fprintf(fp, "          }\n");
-        fprintf(fp, "        ],\n");
-
-        // Chirp Config - 12 chirps for MIMO
-        fprintf(fp, "        \"rlChirps\": [\n");
-        for (int chirpIdx = 0; chirpIdx < NUM_CHIRPS; chirpIdx++) {
-            // Determine TX enable based on device and chirp index
-            const uint8_t chirpTxTable[4][3] = {
-                {11, 10, 9},   // Dev0 - Master
-                {8, 7, 6},     // Dev1
-                {5, 4, 3},     // Dev2
-                {2, 1, 0},     // Dev3
-            };
-            
-            uint8_t txEnable = 0x0;
-            for (int tx = 0; tx < 3; tx++) {
-                if (chirpTxTable[devId][tx] == chirpIdx) {
-                    txEnable = (1 << tx);
-                    break;
-                }
-            }
-
-            fprintf(fp, "          {\n");
-            fprintf(fp, "            \"rlChirpCfg_t\": {\n");
-            fprintf(fp, "              \"chirpStartIdx\": %d,\n", chirpIdx);
-            fprintf(fp, "              \"chirpEndIdx\": %d,\n", chirpIdx);
-            fprintf(fp, "              \"profileId\": 0,\n");
-            fprintf(fp, "              \"startFreqVar_MHz\": 0.0,\n");
-            fprintf(fp, "              \"freqSlopeVar_KHz_usec\": 0.0,\n");
-            fprintf(fp, "              \"idleTimeVar_usec\": 0.0,\n");
-            fprintf(fp, "              \"adcStartTimeVar_usec\": 0.0,\n");
-            fprintf(fp, "              \"txEnable\": \"0x%X\"\n", txEnable);
-            fprintf(fp, "            }\n");
-            fprintf(fp, "          }%s\n", (chirpIdx < NUM_CHIRPS - 1) ? "," : "");
-        }
-        fprintf(fp, "        ],\n");
-
-        // RF Init Calib Config
-        fprintf(fp, "        \"rlRfInitCalConf_t\": {\n");
-        fprintf(fp, "          \"calibEnMask\": \"0x1FF0\"\n");
-        fprintf(fp, "        },\n");
-
-        // Frame Config
-        fprintf(fp, "        \"rlFrameCfg_t\": {\n");
-        fprintf(fp, "          \"chirpEndIdx\": %d,\n", config.frameCfg.chirpEndIdx);
-        fprintf(fp, "          \"chirpStartIdx\": %d,\n", config.frameCfg.chirpStartIdx);
-        fprintf(fp, "          \"numLoops\": %d,\n", config.frameCfg.numLoops);
-        fprintf(fp, "          \"numFrames\": %d,\n", config.frameCfg.numFrames);
-        fprintf(fp, "          \"framePeriodicity_msec\": %.1f,\n", framePeriodicity_msec);
-        fprintf(fp, "          \"triggerSelect\": %d,\n", devId == 0 ? 1 : 2); // SW trigger for master, HW for slaves
-        fprintf(fp, "          \"frameTriggerDelay\": 0.0\n");
-        fprintf(fp, "        },\n");
-
-        // Empty arrays
-        fprintf(fp, "        \"rlBpmChirps\": [],\n");
-        
-        // Misc Config
-        fprintf(fp, "        \"rlRfMiscConf_t\": {\n");
-        fprintf(fp, "          \"miscCtl\": \"%d\"\n", config.miscCfg.miscCtl);
-        fprintf(fp, "        },\n");
-
-        fprintf(fp, "        \"rlRfPhaseShiftCfgs\": [],\n");
-        fprintf(fp, "        \"rlRfProgFiltConfs\": [],\n");
-
-        // Test Source (empty template)
-        fprintf(fp, "        \"rlTestSource_t\": {\n");
-        fprintf(fp, "          \"rlTestSourceObjects\": [\n");
-        fprintf(fp, "            {\n");
-        fprintf(fp, "              \"rlTestSourceObject_t\": {\n");
-        fprintf(fp, "                \"posX_m\": %.1f,\n", 4.0 + devId * 3.0);
-        fprintf(fp, "                \"posY_m\": %.1f,\n", 3.0 + devId * 2.0);
-        fprintf(fp, "                \"posZ_m\": 0.0,\n");
-        fprintf(fp, "                \"velX_m_sec\": 0.0,\n");
-        fprintf(fp, "                \"velY_m_sec\": 0.0,\n");
-        fprintf(fp, "                \"velZ_m_sec\": 0.0,\n");
-        fprintf(fp, "                \"sigLvl_dBFS\": -2.5,\n");
-        fprintf(fp, "                \"posXMin_m\": -327.0,\n");
-        fprintf(fp, "                \"posYMin_m\": 0.0,\n");
-        fprintf(fp, "                \"posZMin_m\": -327.0,\n");
-        fprintf(fp, "                \"posXMax_m\": 327.0,\n");
-        fprintf(fp, "                \"posYMax_m\": 327.0,\n");
-        fprintf(fp, "                \"posZMax_m\": 327.0\n");
-        fprintf(fp, "              }\n");
-        fprintf(fp, "            },\n");
-        fprintf(fp, "            {\n");
-        fprintf(fp, "              \"rlTestSourceObject_t\": {\n");
-        fprintf(fp, "                \"posX_m\": 327.0,\n");
-        fprintf(fp, "                \"posY_m\": 327.0,\n");
-        fprintf(fp, "                \"posZ_m\": 0.0,\n");
-        fprintf(fp, "                \"velX_m_sec\": 0.0,\n");
-        fprintf(fp, "                \"velY_m_sec\": 0.0,\n");
-        fprintf(fp, "                \"velZ_m_sec\": 0.0,\n");
-        fprintf(fp, "                \"sigLvl_dBFS\": -95.0,\n");
-        fprintf(fp, "                \"posXMin_m\": -327.0,\n");
-        fprintf(fp, "                \"posYMin_m\": 0.0,\n");
-        fprintf(fp, "                \"posZMin_m\": -327.0,\n");
-        fprintf(fp, "                \"posXMax_m\": 327.0,\n");
-        fprintf(fp, "                \"posYMax_m\": 327.0,\n");
-        fprintf(fp, "                \"posZMax_m\": 327.0\n");
-        fprintf(fp, "              }\n");
-        fprintf(fp, "            }\n");
-        fprintf(fp, "          ],\n");
-        fprintf(fp, "          \"rlTestSourceRxAntPos\": [\n");
-        for (int rx = 0; rx < 4; rx++) {
-            fprintf(fp, "            {\n");
-            fprintf(fp, "              \"rlTestSourceAntPos_t\": {\n");
-            fprintf(fp, "                \"antPosX\": %.1f,\n", rx * 0.5);
-            fprintf(fp, "                \"antPosZ\": 0.0\n");
-            fprintf(fp, "              }\n");
-            fprintf(fp, "            }%s\n", (rx < 3) ? "," : "");
-        }
-        fprintf(fp, "          ],\n");
-        fprintf(fp, "          \"rlTestSourceTxAntPos\": [\n");
-        for (int tx = 0; tx < 3; tx++) {
-            fprintf(fp, "            {\n");
-            fprintf(fp, "              \"rlTestSourceAntPos_t\": {\n");
-            fprintf(fp, "                \"antPosX\": 0.0,\n");
-            fprintf(fp, "                \"antPosZ\": 0.0\n");
-            fprintf(fp, "              }\n");
-            fprintf(fp, "            }%s\n", (tx < 2) ? "," : "");
-        }
-        fprintf(fp, "          ],\n");
-        fprintf(fp, "          \"miscFunCtrl\": 0\n");
-        fprintf(fp, "        },\n");
-
-        // LDO Bypass Config
-        fprintf(fp, "        \"rlRfLdoBypassCfg_t\": {\n");
-        fprintf(fp, "          \"ldoBypassEnable\": %d,\n", config.ldoCfg.ldoBypassEnable);
-        fprintf(fp, "          \"supplyMonIrDrop\": %d,\n", config.ldoCfg.supplyMonIrDrop);
-        fprintf(fp, "          \"ioSupplyIndicator\": %d\n", config.ldoCfg.ioSupplyIndicator);
-        fprintf(fp, "        },\n");
-
-        fprintf(fp, "        \"rlLoopbackBursts\": [],\n");
-        fprintf(fp, "        \"rlDynChirpCfgs\": [],\n");
-        fprintf(fp, "        \"rlDynPerChirpPhShftCfgs\": []\n");
-        fprintf(fp, "      },\n");
-
-        // Raw Data Capture Config
-        fprintf(fp, "      \"rawDataCaptureConfig\": {\n");
-        fprintf(fp, "        \"rlDevDataFmtCfg_t\": {\n");
-        fprintf(fp, "          \"iqSwapSel\": %d,\n", config.dataFmtCfg.iqSwapSel);
-        fprintf(fp, "          \"chInterleave\": %d\n", config.dataFmtCfg.chInterleave);
-        fprintf(fp, "        },\n");
-        fprintf(fp, "        \"rlDevDataPathCfg_t\": {\n");
-        fprintf(fp, "          \"intfSel\": %d,\n", config.datapathCfg.intfSel);
-        fprintf(fp, "          \"transferFmtPkt0\": \"0x%X\",\n", config.datapathCfg.transferFmtPkt0);
-        fprintf(fp, "          \"transferFmtPkt1\": \"0x%X\",\n", config.datapathCfg.transferFmtPkt1);
-        fprintf(fp, "          \"cqConfig\": 0,\n");
-        fprintf(fp, "          \"cq0TransSize\": 0,\n");
-        fprintf(fp, "          \"cq1TransSize\": 0,\n");
-        fprintf(fp, "          \"cq2TransSize\": 0\n");
-        fprintf(fp, "        },\n");
-        fprintf(fp, "        \"rlDevDataPathClkCfg_t\": {\n");
-        fprintf(fp, "          \"laneClkCfg\": %d,\n", config.datapathClkCfg.laneClkCfg);
-        fprintf(fp, "          \"dataRate_Mbps\": %d\n", config.datapathClkCfg.dataRate == 1 ? 600 : 450);
-        fprintf(fp, "        },\n");
-        fprintf(fp, "        \"rlDevCsi2Cfg_t\": {\n");
-        fprintf(fp, "          \"lanePosPolSel\": \"0x%X\",\n", config.csi2LaneCfg.lanePosPolSel);
-        fprintf(fp, "          \"lineStartEndDis\": %d\n", config.csi2LaneCfg.lineStartEndDis);
-        fprintf(fp, "        }\n");
-        fprintf(fp, "      },\n");
-        fprintf(fp, "      \"monitoringConfig\": {\n");
-        fprintf(fp, "      }\n");
-        fprintf(fp, "    }%s\n", (devId < num_devices - 1) ? "," : "");
+    // Record: start framing (at the same time on all the boards)
+    align_begin(task.captureDir, &config);
+    status = start_frame(config.deviceMap, &aborted);
+    if (aborted) {
+      // Another board stopped monitoring
+      MMWL_DeArmingTDA();
+      break;
+    }
+    check(status,
+      "[MMWCAS-RF] Framing ...",
+      "[MMWCAS-RF] Failed to initiate framing!", config.deviceMap, FALSE);
+    if (status != 0) {
+      // Nothing recorded: stop the devices that started and drop the capture
+      stop_frame(config.deviceMap);
+      MMWL_DeArmingTDA();
+      printf("[MONITOR] Warning: framing failed, retrying in %u ms...\n", retry_ms);
+      monitor_backoff(&retry_ms);
+      continue;
     }
+    retry_ms = MONITOR_RETRY_MIN_MS;
+    start = sched_now();
+
+    clock_gettime(CLOCK_MONOTONIC, &deadline);
+    deadline.tv_sec += interval;
+    record_until(&deadline, &g_monitor_stop);
+
+    status += stop_frame(config.deviceMap);
+    task.recordTime = sched_now() - start;
+    sched_stage_done(&sched, SCHED_STAGE_RECORD, start);
+    capture_count++;
 
-    fprintf(fp, "  ],\n");
+    // Finalize: done once the TDA acknowledged the end of the recording
+    start = sched_now();
+    status += MMWL_DeArmingTDA();
+    check(status,
+      "[MMWCAS-RF] Stop recording",
+      "[MMWCAS-RF] Failed to de-arm TDA board!", 32, FALSE);
+    if (g_board_sync != NULL) {
+      sprintf(json_filename, "%s_%s.mmwave.json", task.captureDir, g_ip_addr);
+    } else {
+      sprintf(json_filename, "%s.mmwave.json", task.captureDir);
+    }
+    export_config_to_json(config, json_filename, 4);
+    export_health_to_json(config, json_filename, 4);
+    sched_stage_done(&sched, SCHED_STAGE_FINALIZE, start);
 
-    // Processing Chain Config
-    fprintf(fp, "  \"processingChainConfig\": {\n");
-    fprintf(fp, "    \"detectionChain\": {\n");
-    fprintf(fp, "      \"name\": \"TI_GenericChain\",\n");
-    fprintf(fp, "      \"detectionLoss\": 1,\n");
-    fprintf(fp, "      \"systemLoss\": 1,\n");
-    fprintf(fp, "      \"implementationMargin\": 2,\n");
-    fprintf(fp, "      \"detectionSNR\": 12,\n");
-    fprintf(fp, "      \"theoreticalRxAntennaGain\": 9,\n");
-    fprintf(fp, "      \"theoreticalTxAntennaGain\": 9\n");
-    fprintf(fp, "    }\n");
-    fprintf(fp, "  }\n");
+    // Transfer and verify on the workers (blocks while the backlog is full)
+    sched_submit(&sched, &task);
+    printf("[MONITOR #%u] Capture complete, queued for transfer | duty cycle: %.1f%%\n",
+      task.captureId, 100.0 * sched_duty_cycle(&sched));
+  }
 
-    fprintf(fp, "}\n");
+  // Release the boards waiting for this one at the start-frame barrier
+  board_sync_abort();
 
-    fclose(fp);
-    printf("Successfully exported configuration to %s\n", filename);
-    return 0;
+  printf("[MONITOR] Stopping, waiting for the queued transfers\n");
+  metrics_unregister(sched_write_metrics, &sched);
+  sched_close(&sched);
+  sched_print_stats(&sched, "[MONITOR]");
+  return 0;
 }
 
 
@@ -954,7 +2356,7 @@ int main (int argc, char *argv[]) {
   option_t opt_ipaddr = {
     .args = "-i",
     .argl = "--ip-addr",
-    .help = "IP Address of the MMWCAS DSP evaluation module",
+    .help = "IP Address(es) of the MMWCAS DSP evaluation module(s), comma separated",
     .type = OPT_STR,
     .default_value = default_ip_addr,
   };
@@ -988,12 +2390,157 @@ int main (int argc, char *argv[]) {
   option_t opt_config_file = {
     .args = "-f",
     .argl = "--cfg",
-    .help = "TOML Configuration file. Overwrite the default config when provided",
+    .help = "TOML Configuration file, or blob compiled with --compile. Overwrite the default config when provided",
     .type = OPT_STR,
     .default_value = NULL,
   };
   add_arg(&parser, &opt_config_file);
 
+  option_t opt_compile = {
+    .args = "-o",
+    .argl = "--compile",
+    .help = "Check the configuration (--cfg), compile it into the given blob file and exit",
+    .type = OPT_STR,
+    .default_value = NULL,
+  };
+  add_arg(&parser, &opt_compile);
+
+  option_t opt_full = {
+    .args = "-a",
+    .argl = "--full",
+    .help = "Run the full configuration even if only some parameters changed",
+    .type = OPT_BOOL,
+  };
+  add_arg(&parser, &opt_full);
+
+  option_t opt_recalibrate = {
+    .args = "-K",
+    .argl = "--recalibrate",
+    .help = "Run the full RF calibration instead of restoring the cached calibration data",
+    .type = OPT_BOOL,
+  };
+  add_arg(&parser, &opt_recalibrate);
+
+  option_t opt_daemon = {
+    .args = "-D",
+    .argl = "--daemon",
+    .help = "Configure the board and keep it ready, controlled through a local socket",
+    .type = OPT_BOOL,
+  };
+  add_arg(&parser, &opt_daemon);
+
+  option_t opt_socket = {
+    .args = "-s",
+    .argl = "--socket",
+    .help = "Control socket of the daemon. Default: /tmp/mmwave_<ip-addr>.sock",
+    .type = OPT_STR,
+    .default_value = NULL,
+  };
+  add_arg(&parser, &opt_socket);
+
+  option_t opt_streams = {
+    .args = "-S",
+    .argl = "--streams",
+    .help = "Number of parallel streams used to copy a capture to the host. Default: 4",
+    .type = OPT_INT,
+    .default_value = &((int){4}),
+  };
+  add_arg(&parser, &opt_streams);
+
+  option_t opt_rate_limit = {
+    .args = "-R",
+    .argl = "--rate-limit",
+    .help = "Maximum rate to copy the captures to the host in MB/s. Default: 0 (unlimited)",
+    .type = OPT_FLOAT,
+    .default_value = &((float){0.0}),
+  };
+  add_arg(&parser, &opt_rate_limit);
+
+  option_t opt_checksum = {
+    .args = "-C",
+    .argl = "--checksum",
+    .help = "Compare the CRC of each copied file with the one computed on the DSP board",
+    .type = OPT_BOOL,
+  };
+  add_arg(&parser, &opt_checksum);
+
+  option_t opt_pack = {
+    .args = "-P",
+    .argl = "--pack",
+    .help = "Pack each copied capture into an indexed container (<capture>.mmwcap)",
+    .type = OPT_BOOL,
+  };
+  add_arg(&parser, &opt_pack);
+
+  option_t opt_rdmap = {
+    .args = "-H",
+    .argl = "--rdmap",
+    .help = "Compute the range-Doppler heatmaps of each packed capture (<capture>.mmwrd). Implies --pack",
+    .type = OPT_BOOL,
+  };
+  add_arg(&parser, &opt_rdmap);
+
+  option_t opt_compress = {
+    .args = "-Z",
+    .argl = "--compress",
+    .help = "Compress the copies (ssh) and the ADC blocks of the containers with this codec (delta or rice). Implies --pack",
+    .type = OPT_STR,
+    .default_value = NULL,
+  };
+  add_arg(&parser, &opt_compress);
+
+  option_t opt_verify = {
+    .args = "-V",
+    .argl = "--verify",
+    .help = "Check the frames and the write throughput of a recorded capture (name in ~/mmwave-cli/PostProc, or path) against --cfg and exit",
+    .type = OPT_STR,
+    .default_value = NULL,
+  };
+  add_arg(&parser, &opt_verify);
+
+  option_t opt_irq_polling = {
+    .args = "-q",
+    .argl = "--irq-polling",
+    .help = "Poll the host IRQ every 1 ms instead of waiting for IRQ events",
+    .type = OPT_BOOL,
+  };
+  add_arg(&parser, &opt_irq_polling);
+
+  option_t opt_trace = {
+    .args = "-l",
+    .argl = "--trace",
+    .help = "Print every packet exchanged with the DSP board to stderr",
+    .type = OPT_BOOL,
+  };
+  add_arg(&parser, &opt_trace);
+
+  option_t opt_profile = {
+    .args = "-g",
+    .argl = "--profile",
+    .help = "Profile the bring-up and write a Chrome trace with the latency histograms to this file at exit",
+    .type = OPT_STR,
+    .default_value = NULL,
+  };
+  add_arg(&parser, &opt_profile);
+
+  option_t opt_metrics = {
+    .args = "-M",
+    .argl = "--metrics",
+    .help = "Serve Prometheus metrics over HTTP on [host:]port or unix:<path> (one port or path per board)",
+    .type = OPT_STR,
+    .default_value = NULL,
+  };
+  add_arg(&parser, &opt_metrics);
+
+  option_t opt_health = {
+    .args = "-e",
+    .argl = "--health",
+    .help = "RF health monitors to enable (temp,rx-gain,tx-power,synth or all, none to disable). Overwrite [mimo.monitor]",
+    .type = OPT_STR,
+    .default_value = NULL,
+  };
+  add_arg(&parser, &opt_health);
+
   option_t opt_help = {
     .args = "-h",
     .argl = "--help",
@@ -1030,6 +2577,24 @@ int main (int argc, char *argv[]) {
         .default_value = &((int){10}),
     };
     add_arg(&parser, &opt_interval);
+
+    option_t opt_jobs = {
+        .args = "-j",
+        .argl = "--jobs",
+        .help = "Monitoring: maximum number of transfers in flight (default: 2)",
+        .type = OPT_INT,
+        .default_value = &((int){2}),
+    };
+    add_arg(&parser, &opt_jobs);
+
+    option_t opt_backlog = {
+        .args = "-b",
+        .argl = "--backlog",
+        .help = "Monitoring: maximum number of captures waiting for a transfer (default: 4)",
+        .type = OPT_INT,
+        .default_value = &((int){4}),
+    };
+    add_arg(&parser, &opt_backlog);
     
     parse(&parser, argc, argv);
 
@@ -1039,11 +2604,34 @@ int main (int argc, char *argv[]) {
     exit(0);
   }
 
+  // Compile the configuration, without any traffic with the boards
+  unsigned char *compile_path = (unsigned char*)get_option(&parser, "compile");
+  if (compile_path != NULL) {
+    devConfig_t config;
+    configBudget_t budget;
+    if (load_config(&config, (unsigned char*)get_option(&parser, "cfg")) != 0) exit(1);
+    validate_config(&config, &budget);
+    print_config_budget(&budget);
+    if (write_config_blob(compile_path, &config) != 0) exit(1);
+    printf(" Configuration compiled into '%s'\n", compile_path);
+    exit(0);
+  }
+
   unsigned char *monitor_mode = (unsigned char*)get_option(&parser, "monitor");
   int monitor_interval = *(int*)get_option(&parser, "interval");
 
   unsigned char *ip_addr = (unsigned char*)get_option(&parser, "ip-addr");
   unsigned int port = *(unsigned int*)get_option(&parser, "port");
+  // Several boards: each one is driven by its own process from here on
+  boardCtx_t boards[MAX_BOARDS];
+  uint8_t num_boards = parse_boards(ip_addr, boards);
+  uint8_t board_index = 0;
+  if (num_boards > 1) {
+    board_index = run_boards(boards, num_boards);
+    ip_addr = boards[board_index].ipAddr;
+  }
+  g_board_index = board_index;
+  g_num_boards = (num_boards > 0) ? num_boards : 1;
   // Store IP address in global variable for logging
   strncpy(g_ip_addr, ip_addr, sizeof(g_ip_addr) - 1);
   g_ip_addr[sizeof(g_ip_addr) - 1] = '\0';
@@ -1051,7 +2639,11 @@ int main (int argc, char *argv[]) {
   sprintf(capture_path, "/mnt/ssd/");
   // Construct JSON filename with same name as capture directory
   char json_filename[256];
-  sprintf(json_filename, "%s.mmwave.json", capture_directory);
+  if (num_boards > 1) {
+    sprintf(json_filename, "%s_%s.mmwave.json", capture_directory, ip_addr);
+  } else {
+    sprintf(json_filename, "%s.mmwave.json", capture_directory);
+  }
   /* Record CLI option possible values are:
    *  - start: To start a recording and exit
    *  - stop: Stop a recording and exit
@@ -1063,173 +2655,176 @@ int main (int argc, char *argv[]) {
 
   unsigned char *config_filename = (unsigned char*)get_option(&parser, "cfg");
 
-  // Configuration
-  devConfig_t config;
+  g_xfer_cfg.streams = *(int*)get_option(&parser, "streams");
+  g_xfer_cfg.rateLimit = (uint64_t)(*(float*)get_option(&parser, "rate-limit") * 1e6);
+  g_xfer_checksum = (unsigned char *)get_option(&parser, "checksum") != NULL;
 
-  /*  Device map:  master | slave 1  | slave 2  | slave 3 */
-  config.deviceMap =  1   | (1 << 1) | (1 << 2) | (1 << 3);
-  MMWL_AssignDeviceMap(config.deviceMap, &config.masterMap, &config.slavesMap);
-
-  config.frameCfg = frameCfgArgs;
-  config.profileCfg = profileCfgArgs;
-  config.chirpCfg = chirpCfgArgs;
-  config.adcOutCfg = adcOutCfgArgs;
-  config.dataFmtCfg = dataFmtCfgArgs;
-  config.channelCfg = channelCfgArgs;
-  config.csi2LaneCfg = csi2LaneCfgArgs;
-  config.datapathCfg = datapathCfgArgs;
-  config.datapathClkCfg = datapathClkCfgArgs;
-  config.hsClkCfg = hsClkCfgArgs;
-  config.ldoCfg = ldoCfgArgs;
-  config.lpmCfg = lpmCfgArgs;
-  config.miscCfg = miscCfgArgs;
-
-  if (config_filename != NULL) {
-    // Read parameters from config file
-    read_config(config_filename, &config);
+  if ((unsigned char *)get_option(&parser, "trace") != NULL) {
+    TDATraceSetLive(TRUE);
   }
 
-  /**
-   * @note: The adcOutCfg is used to overwrite the dataFmtCfg
-   *
-   * In a unified config file, it'll make for sense to have a single
-   * source of truth for the ADC data format. And therefore use the
-   * same data for setting both.
-   */
-  config.dataFmtCfg.rxChannelEn = channelCfgArgs.rxChannelEn;
-  config.dataFmtCfg.adcBits = adcOutCfgArgs.fmt.b2AdcBits;
-  config.dataFmtCfg.adcFmt = adcOutCfgArgs.fmt.b2AdcOutFmt;
+  unsigned char *profile_path = (unsigned char *)get_option(&parser, "profile");
+  if (profile_path != NULL) {
+    if (num_boards > 1) {
+      // One profile per board process
+      snprintf(g_profile_path, sizeof(g_profile_path), "%s.%s", profile_path, ip_addr);
+    } else {
+      snprintf(g_profile_path, sizeof(g_profile_path), "%s", profile_path);
+    }
+    TDAProfEnable(TRUE);
+    g_profile_stage = TDAProfNow();
+  }
+
+  char *metrics_listen = (char *)get_option(&parser, "metrics");
+  if (metrics_listen != NULL) {
+    char listen_addr[160];
+    char *port_sep = strrchr(metrics_listen, ':');
+    if (num_boards <= 1) {
+      snprintf(listen_addr, sizeof(listen_addr), "%s", metrics_listen);
+    } else if (strncmp(metrics_listen, "unix:", 5) == 0) {
+      // One socket per board process
+      snprintf(listen_addr, sizeof(listen_addr), "%s.%s", metrics_listen, ip_addr);
+    } else {
+      // One port per board process, from the given one
+      const char *port_str = (port_sep != NULL) ? port_sep + 1 : metrics_listen;
+      int host_len = (port_sep != NULL) ? (int)(port_sep - metrics_listen + 1) : 0;
+      snprintf(listen_addr, sizeof(listen_addr), "%.*s%d", host_len, metrics_listen,
+        atoi(port_str) + board_index);
+    }
+    // The latency histograms are the ones of the profiler
+    if (!gTDAProfEnabled) {
+      TDAProfEnable(TRUE);
+      g_profile_stage = TDAProfNow();
+    }
+    if (metrics_start(listen_addr) != 0) {
+      fprintf(stderr, "[MMWCAS] Cannot serve the metrics on %s\n", listen_addr);
+      exit(1);
+    }
+    printf("[MMWCAS] Metrics served on %s\n", listen_addr);
+  }
+
+  // Configuration
+  devConfig_t config;
+  if (load_config(&config, config_filename) != 0) {
+    exit(1);
+  }
+  unsigned char *health = (unsigned char *)get_option(&parser, "health");
+  if ((health != NULL) && (parse_monitors(health, &config.monCfg.enable) != 0)) {
+    exit(1);
+  }
+  g_recalibrate = (unsigned char *)get_option(&parser, "recalibrate") != NULL;
+  g_rdmap = (unsigned char *)get_option(&parser, "rdmap") != NULL;
+  char *compress = (char *)get_option(&parser, "compress");
+  if (compress != NULL) {
+    if (strcmp(compress, "delta") == 0) {
+      g_pack_codec = CAP_CODEC_DELTA;
+    } else if (strcmp(compress, "rice") == 0) {
+      g_pack_codec = CAP_CODEC_RICE;
+    } else {
+      fprintf(stderr, "Unknown codec '%s' (delta or rice)\n", compress);
+      exit(1);
+    }
+    g_xfer_cfg.compress = 1;
+  }
+  if (((unsigned char *)get_option(&parser, "pack") != NULL) || g_rdmap || (compress != NULL)) {
+    g_pack_config = &config;
+  }
 
   // config to ARM the TDA
   rlTdaArmCfg_t tdaCfg = {
     .captureDirectory = capture_path,
-    .framePeriodicity = (frameCfgArgs.framePeriodicity * 5)/(1000*1000),
+    .framePeriodicity = tda_frame_period(&config),
     .numberOfFilesToAllocate = 0,
     .numberOfFramesToCapture = 0, // config.frameCfg.numFrames,
     .dataPacking = 0, // 0: 16-bit | 1: 12-bit
   };
+  // The containers follow the packing of the recorded data
+  g_pack_packing = (uint8_t)tdaCfg.dataPacking;
+  g_verify_config = &config;
+
+  // Check of a recorded capture, without any traffic with the boards
+  char *verify_capture_dir = (char *)get_option(&parser, "verify");
+  if (verify_capture_dir != NULL) {
+    char verify_path[256];
+    if (strchr(verify_capture_dir, '/') != NULL) {
+      snprintf(verify_path, sizeof(verify_path), "%s", verify_capture_dir);
+    } else {
+      local_capture_path(verify_path, sizeof(verify_path), verify_capture_dir);
+    }
+    exit((verify_frames(verify_path, &config, 0, 1, "[VERIFY]") == 0) ? 0 : 1);
+  }
+
+  unsigned char *daemon_mode = (unsigned char *)get_option(&parser, "daemon");
 
-  if ((unsigned char *)get_option(&parser, "configure") != NULL) {
+  if (((unsigned char *)get_option(&parser, "configure") != NULL) || (daemon_mode != NULL)) {
     // Connect to TDA
-    status = MMWL_TDAInit(ip_addr, port, config.deviceMap);
+    uint8_t irq_mode = TDA_IRQ_MODE_EVENT;
+    if ((unsigned char *)get_option(&parser, "irq-polling") != NULL) {
+      irq_mode = TDA_IRQ_MODE_POLLING;
+    }
+    status = MMWL_TDAInit(ip_addr, port, config.deviceMap, irq_mode);
     check(status,
       "[MMWCAS-DSP] TDA Connected!",
       "[MMWCAS-DSP] Couldn't connect to TDA board!\n", 32, TRUE);
 
     // Start configuration
-    configure(config);
+    configure(config, (unsigned char *)get_option(&parser, "full") != NULL);
     // Export to JSON
     export_config_to_json(config, json_filename, 4);
-    msleep(2000);
+  }
+
+  if (daemon_mode != NULL) {
+    char socket_path[108];
+    unsigned char *socket_opt = (unsigned char *)get_option(&parser, "socket");
+    if (socket_opt == NULL) {
+      snprintf(socket_path, sizeof(socket_path), CTL_SOCKET_PATH_FMT, ip_addr);
+    } else if (num_boards > 1) {
+      // One socket per board process
+      snprintf(socket_path, sizeof(socket_path), "%s.%s", socket_opt, ip_addr);
+    } else {
+      snprintf(socket_path, sizeof(socket_path), "%s", socket_opt);
+    }
+    return run_daemon(config, tdaCfg, capture_path, socket_path);
   }
 
   if ((unsigned char *)get_option(&parser, "record") != NULL) {
-    // CONTINUOUS MONITORING LOOP
-        if (monitor_mode != NULL) {
-            printf("[MONITOR] Starting continuous monitoring mode\n");
-            printf("[MONITOR] Interval: %d seconds\n", monitor_interval);
-            
-            int capture_count = 0;
-            
-            while (1) { // Infinite loop - use Ctrl+C to stop
-                capture_count++;
-                time_t now = time(NULL);
-                
-                // Generate unique capture directory
-                char capture_dir[128];
-                sprintf(capture_dir, "MMWL_Capture_%lu", (unsigned long)now);
-                
-                // Update capture path
-                char full_capture_path[256];
-                sprintf(full_capture_path, "%s%s", capture_path, capture_dir);
-                tdaCfg.captureDirectory = full_capture_path;
-                
-                printf("\n[MONITOR #%d] Starting capture: %s\n", 
-                       capture_count, capture_dir);
-                
-                // Arm TDA
-                status = MMWL_ArmingTDA(tdaCfg);
-                check(status, 
-                      "[MMWCAS-DSP] Arming TDA",
-                      "[MMWCAS-DSP] TDA Arming failed!", 32, FALSE);
-                
-                if (status != 0) {
-                    printf("[MONITOR] Warning: TDA arming failed, retrying...\n");
-                    msleep(2000);
-                    continue;
-                }
-                
-                msleep(2000);
-                
-                // Start framing
-                for (int i = 3; i >= 0; i--) {
-                    status += MMWL_StartFrame(1U << i);
-                }
-                check(status,
-                      "[MMWCAS-RF] Framing ...",
-                      "[MMWCAS-RF] Failed to initiate framing!", 
-                      config.deviceMap, FALSE);
-                
-                // Wait for capture duration
-                msleep((unsigned long int)monitor_interval * 1000);
-                
-                // Stop framing
-                for (int i = 3; i >= 0; i--) {
-                    status += MMWL_StopFrame(1U << i);
-                }
-                
-                status += MMWL_DeArmingTDA();
-                check(status,
-                      "[MMWCAS-RF] Stop recording",
-                      "[MMWCAS-RF] Failed to de-arm TDA board!", 32, FALSE);
-                
-                printf("[MONITOR #%d] Capture complete\n", capture_count);
-                
-                // Export JSON configuration
-                char json_filename[256];
-                sprintf(json_filename, "%s.mmwave.json", capture_dir);
-                export_config_to_json(config, json_filename, 4);
-                
-                // Start async transfer (non-blocking)
-                start_async_transfer(capture_dir, capture_count);
-                printf("[MONITOR #%d] Transfer started in background\n", 
-                       capture_count);
-                
-                // Small delay before next capture to ensure clean state
-                msleep(1000);
-                
-                printf("[MONITOR] Ready for next capture...\n");
-            }
-        } else {
-          // Arm TDA
-          status = MMWL_ArmingTDA(tdaCfg);
-          check(status,
-            "[MMWCAS-DSP] Arming TDA",
-            "[MMWCAS-DSP] TDA Arming failed!\n", 32, TRUE);
-
-          msleep(2000);
-
-          // Start framing
-          for (int i = 3; i >=0; i--) {
-            status += MMWL_StartFrame(1U << i);
-          }
-          check(status,
-            "[MMWCAS-RF] Framing ...",
-            "[MMWCAS-RF] Failed to initiate framing!\n", config.deviceMap, TRUE);
-
-          msleep((unsigned long int)record_duration);
-
-          // Stop framing
-          for (int i = 3; i >= 0; i--) {
-            status += MMWL_StopFrame(1U << i);
-          }
-
-          status += MMWL_DeArmingTDA();
-          check(status,
-            "[MMWCAS-RF] Stop recording",
-            "[MMWCAS-RF] Failed to de-arm TDA board!\n", 32, TRUE);
-          msleep(1000);
-        }
+    if (monitor_mode != NULL) {
+      return run_monitor(config, tdaCfg, capture_path, monitor_interval,
+        *(unsigned int*)get_option(&parser, "backlog"),
+        *(unsigned int*)get_option(&parser, "jobs"));
+    } else {
+      // Arm TDA
+      status = arm_tda(tdaCfg);
+      check(status,
+        "[MMWCAS-DSP] Arming TDA",
+        "[MMWCAS-DSP] TDA Arming failed!\n", 32, TRUE);
+
+      // Start framing (at the same time on all the boards)
+      align_begin((const char *)capture_directory, &config);
+      status = start_frame(config.deviceMap, NULL);
+      check(status,
+        "[MMWCAS-RF] Framing ...",
+        "[MMWCAS-RF] Failed to initiate framing!\n", config.deviceMap, TRUE);
+
+      struct timespec deadline;
+      clock_gettime(CLOCK_MONOTONIC, &deadline);
+      deadline.tv_sec += (time_t)(record_duration / 1000);
+      deadline.tv_nsec += (long)fmod(record_duration, 1000.0) * 1000000L;
+      if (deadline.tv_nsec >= 1000000000L) {
+        deadline.tv_sec++;
+        deadline.tv_nsec -= 1000000000L;
+      }
+      record_until(&deadline, NULL);
+
+      // Stop framing
+      status += stop_frame(config.deviceMap);
+
+      status += MMWL_DeArmingTDA();
+      check(status,
+        "[MMWCAS-RF] Stop recording",
+        "[MMWCAS-RF] Failed to de-arm TDA board!\n", 32, TRUE);
+      export_health_to_json(config, json_filename, 4);
+    }
   }
   return 0;
 }
\ No newline at end of file
@@ -13,6 +13,7 @@
 
 #include <string.h>
 #include <signal.h>
+#include <time.h>
 #include "ti/mmwave/mmwave.h"
 #include "opt/opt.h"
 
@@ -29,6 +30,17 @@
 
 #define NUM_CHIRPS 12
 
+#define MAX_BOARDS 8       // Maximum number of DSP boards driven at once
+
+#define MONITOR_HEALTH_POLL 1   // Period of the RF health aggregation while recording (s)
+#define MONITOR_RETRY_MIN_MS 100    // First delay before retrying a failed capture (ms)
+#define MONITOR_RETRY_MAX_MS 5000   // Delay doubled on each failure up to this (ms)
+
+/* Daemon states */
+#define DAEMON_STATE_CONFIGURED   0   // Devices configured, TDA not armed
+#define DAEMON_STATE_ARMED        1   // TDA armed, not framing
+#define DAEMON_STATE_FRAMING      2   // Devices framing
+
 #define CRED      "\e[0;31m"    // Terminal code for regular red text
 #define CGREEN    "\e[0;32m"    // Terminal code for regular greed text
 #define CRESET    "\e[0m"       // Clear reset terminal color
@@ -52,6 +64,12 @@ typedef struct devConfig {
   // Profile config
   rlProfileCfg_t profileCfg;
 
+  // Advanced frame config (frameSeq.numOfSubFrames 0: legacy frame)
+  rlAdvFrameCfg_t advFrameCfg;
+
+  // Profile of each sub-frame of the advanced frame (profileId: sub-frame index)
+  rlProfileCfg_t subProfileCfg[RL_MAX_SUBFRAMES];
+
   // Chirp config
   rlChirpCfg_t chirpCfg;
 
@@ -85,6 +103,80 @@ typedef struct devConfig {
   // CSI2 config
   rlDevCsi2Cfg_t csi2LaneCfg;
 
+  // RF health monitoring config
+  mmwlMonCfg_t monCfg;
+
 } devConfig_t;
 
+
+/** DSP board context (one per IP address) */
+typedef struct boardCtx {
+
+  // IP address of the DSP board
+  char ipAddr[32];
+
+  // Process configuring and controlling the board
+  pid_t pid;
+
+  // Exit status of the board process
+  int32_t status;
+
+} boardCtx_t;
+
+
+/** Start-frame barrier shared by the board processes */
+typedef struct boardSync {
+
+  pthread_mutex_t lock;
+  pthread_cond_t cond;
+
+  // Number of boards expected at the barrier
+  uint8_t expected;
+
+  // Number of boards arrived at the barrier
+  uint8_t arrived;
+
+  // Incremented each time the barrier is released
+  uint32_t generation;
+
+  // Set when a board failed before reaching the barrier
+  uint8_t aborted;
+
+  // CLOCK_REALTIME time at which the last board arrived (ns)
+  uint64_t releaseTime;
+
+} boardSync_t;
+
+/** Daemon context */
+typedef struct daemonCtx {
+
+  // Configuration applied to the devices
+  devConfig_t config;
+
+  // TDA arming config
+  rlTdaArmCfg_t tdaCfg;
+
+  // Root capture path on the DSP board
+  char capturePath[128];
+
+  // Current capture directory (relative to the root capture path)
+  char captureDir[128];
+
+  // Full path of the current capture directory
+  char fullCapturePath[256];
+
+  // DAEMON_STATE_*
+  uint8_t state;
+
+  // Number of completed captures
+  uint32_t captures;
+
+  // Time the daemon started
+  time_t startTime;
+
+  // Cleared to stop the daemon
+  uint8_t running;
+
+} daemonCtx_t;
+
 #endif
@@ -1,39 +1,32 @@
-import time
+import asyncio
 import mmwcas
 
-config_dict ={}
+config = mmwcas.MmwConfig({})
 record_duration = 1*60
-status = mmwcas.mmw_set_config(config_dict)
-if status!=0:
-    print(status)
-    raise ValueError(f"{status}")
 
-status = mmwcas.mmw_init()
-assert status==0,ValueError
-time.sleep(2)
-status = mmwcas.mmw_arming_tda("outdoor0")
-assert status==0,ValueError
-time.sleep(2)
-status = mmwcas.mmw_start_frame()
-assert status==0,ValueError
+async def record(capture_path):
+    # Each call completes once the devices and the TDA have acknowledged
+    status = await mmwcas.mmw_arming_tda_async(capture_path)
+    assert status==0,ValueError
+    status = await mmwcas.mmw_start_frame_async()
+    assert status==0,ValueError
 
-time.sleep(record_duration)
+    await asyncio.sleep(record_duration)
 
-status=mmwcas.mmw_stop_frame()
-assert status==0,ValueError
-status=mmwcas.mmw_dearming_tda()
-assert status==0,ValueError
-time.sleep(2)
+    status = await mmwcas.mmw_stop_frame_async()
+    assert status==0,ValueError
+    status = await mmwcas.mmw_dearming_tda_async()
+    assert status==0,ValueError
 
-status = mmwcas.mmw_arming_tda("outdoor1")
-assert status==0,ValueError
-time.sleep(2)
-status = mmwcas.mmw_start_frame()
-assert status==0,ValueError
+async def main():
+    status = mmwcas.mmw_set_config(config)
+    if status!=0:
+        print(status)
+        raise ValueError(f"{status}")
 
-time.sleep(record_duration)
+    status = await mmwcas.mmw_init_async()
+    assert status==0,ValueError
+    for capture_path in ("outdoor0", "outdoor1"):
+        await record(capture_path)
 
-status=mmwcas.mmw_stop_frame()
-assert status==0,ValueError
-status=mmwcas.mmw_dearming_tda()
-assert status==0,ValueError
\ No newline at end of file
+asyncio.run(main())
@@ -0,0 +1,374 @@
+#!/usr/bin/env python3
+"""
+Read an indexed capture container (.mmwcap) written by the mmwave CLI
+
+The container is memory mapped: the frames are returned as zero-copy views
+(memoryview, or numpy arrays when numpy is available). The format is
+described in cap/cap.h. The blocks of a compressed container (--compress)
+are decoded on access (see cap/codec.h), which requires numpy. The range-Doppler maps (.mmwrd) computed from a
+container with --rdmap are read with load_rdmaps (see dsp/rd.h). The
+frames of the boards of a multi-cascade session are paired with the
+alignment index of the capture (.mmwalign, see cap/align.h).
+
+Usage: mmwcap.py <capture.mmwcap> [frame]
+       mmwcap.py <capture.mmwalign> [pairs]
+"""
+
+import mmap
+import struct
+import sys
+
+try:
+    import numpy as np
+except ImportError:  # Raw memoryviews only
+    np = None
+
+HEADER = struct.Struct("<IHHQQQIIIIIBBBBHHHHHHIIhHIIIBBBB64sBBB93s")
+INDEX = struct.Struct("<QQIB3x")
+MAGIC = 0x43574D4D
+VERSION = 2
+VERSIONS = (1, 2)
+CODECS = ("none", "delta", "rice")
+GROUP = 128
+DEVICES = ("master", "slave1", "slave2", "slave3")
+RD_HEADER = struct.Struct("<IHHIHHBBBBff36s")
+RD_MAGIC = 0x52574D4D
+RD_VERSION = 1
+RD_FIELDS = (
+    "magic", "version", "headerSize", "numFrames", "numDoppler", "numRange",
+    "scale", "numTx", "numRx", "reserved0", "rangeRes", "dopplerRes", "reserved",
+)
+ALIGN_HEADER = struct.Struct("<IHHHBx64s180x")
+ALIGN_BOARD = struct.Struct("<32sQQIBBBx4Q4Q4Q4Q4Q4Q72x")
+ALIGN_MAGIC = 0x41574D4D
+ALIGN_VERSION = 1
+ALIGN_STARTED = 0x1
+ALIGN_STOPPED = 0x2
+
+HEADER_FIELDS = (
+    "magic", "version", "headerSize", "dataOffset", "indexOffset",
+    "recordedOn", "numFrames", "blockSize", "blockStride", "width", "height",
+    "deviceMap", "numDevices", "numRx", "valsPerSample", "numAdcSamples",
+    "rxChannelEn", "txChannelEn", "numLoops", "chirpStartIdx", "chirpEndIdx",
+    "framePeriodicity", "startFreqConst", "freqSlopeConst",
+    "digOutSampleRate", "idleTimeConst", "adcStartTimeConst", "rampEndTime",
+    "adcBits", "adcFmt", "rxGain", "reserved0", "captureDir", "codec",
+    "packing", "chInterleave", "reserved",
+)
+
+
+def _bits(data, pos: int, count: int, width: int):
+    """count values of width bits, least significant bit first"""
+    size = (count * width + 7) // 8
+    if width == 0:
+        return np.zeros(count, dtype=np.uint32), pos
+    bits = np.unpackbits(np.frombuffer(data, np.uint8, size, pos), bitorder="little")
+    weights = np.left_shift(1, np.arange(width, dtype=np.uint32))
+    values = bits[:count * width].reshape(count, width).astype(np.uint32) @ weights
+    return values, pos + size
+
+
+def _decode_stream(data, pos: int, count: int):
+    """Zigzag mapped differences of a stream, group by group"""
+    z = np.empty(count, dtype=np.uint32)
+    for first in range(0, count, GROUP):
+        n = min(GROUP, count - first)
+        mode = data[pos]
+        pos += 1
+        if mode & 0x80:
+            k = mode & 0x1F
+            unary = int.from_bytes(data[pos:pos + 2], "little")
+            bits = np.unpackbits(np.frombuffer(data, np.uint8, unary, pos + 2), bitorder="little")
+            ends = np.flatnonzero(bits)[:n]
+            if len(ends) != n:
+                raise ValueError("corrupted block")
+            q = np.diff(ends, prepend=-1) - 1
+            r, pos = _bits(data, pos + 2 + unary, n, k)
+            z[first:first + n] = (q.astype(np.uint32) << k) | r
+        else:
+            z[first:first + n], pos = _bits(data, pos, n, mode)
+    return z, pos
+
+
+def decode_block(data, h: dict):
+    """Decode a coded device block into height x width int16 values"""
+    out = np.empty(h["height"] * h["width"], dtype=np.int16)
+    ns, nrx, vps = h["numAdcSamples"], h["numRx"], h["valsPerSample"]
+    pos = 0
+    if ns == 0 or nrx * vps == 0 or nrx * vps > 8 or h["width"] != ns * nrx * vps:
+        streams = [out]
+    elif h["chInterleave"]:
+        view = out.reshape(h["height"], nrx, ns, vps)
+        streams = [view[:, rx, :, v] for rx in range(nrx) for v in range(vps)]
+    else:
+        view = out.reshape(h["height"], ns, nrx, vps)
+        streams = [view[:, :, rx, v] for rx in range(nrx) for v in range(vps)]
+    for stream in streams:
+        z, pos = _decode_stream(data, pos, stream.size)
+        d = (z >> 1) ^ (0 - (z & 1))
+        stream[...] = (np.cumsum(d, dtype=np.uint64) & 0xFFFF).astype(np.uint16).view(np.int16) \
+            .reshape(stream.shape)
+    if pos != len(data):
+        raise ValueError("corrupted block")
+    return out
+
+
+def unpack12(data):
+    """Unpack 12-bit values packed by pairs into int16 values"""
+    b = np.frombuffer(data, dtype=np.uint8).reshape(-1, 3).astype(np.uint16)
+    out = np.empty((len(b), 2), dtype=np.uint16)
+    out[:, 0] = b[:, 0] | ((b[:, 1] & 0x0F) << 8)
+    out[:, 1] = (b[:, 1] >> 4) | (b[:, 2] << 4)
+    return (out.view(np.int16) << 4 >> 4).reshape(-1)
+
+
+class CaptureFile:
+    """Memory mapped capture container"""
+
+    def __init__(self, path: str):
+        self._file = open(path, "rb")
+        self._map = mmap.mmap(self._file.fileno(), 0, access=mmap.ACCESS_READ)
+        self._view = memoryview(self._map)
+        values = HEADER.unpack_from(self._map, 0)
+        self.header = dict(zip(HEADER_FIELDS, values))
+        self.header["captureDir"] = values[HEADER_FIELDS.index("captureDir")].split(b"\0", 1)[0].decode()
+        del self.header["reserved"], self.header["reserved0"]
+        h = self.header
+        end = h["indexOffset"] + h["numFrames"] * h["numDevices"] * INDEX.size
+        if (h["magic"] != MAGIC or h["version"] not in VERSIONS or h["codec"] >= len(CODECS)
+                or h["headerSize"] != HEADER.size or end > len(self._map)):
+            self.close()
+            raise ValueError(f"{path}: not a complete version {VERSION} capture container")
+        self.devices = [d for d in range(len(DEVICES)) if h["deviceMap"] & (1 << d)]
+        self._slot = {d: i for i, d in enumerate(self.devices)}
+
+    def __enter__(self):
+        return self
+
+    def __exit__(self, *args):
+        self.close()
+
+    def __len__(self) -> int:
+        return self.header["numFrames"]
+
+    def close(self):
+        """Release the mapping (the views returned must be released first)"""
+        if self._map is not None:
+            self._view.release()
+            self._map.close()
+            self._file.close()
+            self._map = None
+
+    def entry(self, frame: int, device: int = 0) -> dict:
+        """Index entry of a device block: offset, timestamp (ns), sequence, device"""
+        h = self.header
+        if not 0 <= frame < h["numFrames"] or device not in self._slot:
+            raise IndexError(f"no frame {frame} for device {device}")
+        offset = h["indexOffset"] + (frame * h["numDevices"] + self._slot[device]) * INDEX.size
+        fields = INDEX.unpack_from(self._map, offset)
+        return dict(zip(("offset", "timestamp", "sequence", "device"), fields))
+
+    def raw(self, frame: int, device: int = 0) -> memoryview:
+        """Device block as stored (zero-copy): little endian int16 values as
+        recorded (12-bit packed with the TDA data packing), or the coded block"""
+        h = self.header
+        offset = self.entry(frame, device)["offset"]
+        if h["codec"] == 0:
+            return self._view[offset:offset + h["blockSize"]]
+        # A coded block ends where the next one starts (or at the index)
+        k = frame * h["numDevices"] + self._slot[device] + 1
+        end = (INDEX.unpack_from(self._map, h["indexOffset"] + k * INDEX.size)[0]
+               if k < h["numFrames"] * h["numDevices"] else h["indexOffset"])
+        return self._view[offset:end]
+
+    def values(self, frame: int, device: int = 0):
+        """ADC values of a device block as a flat int16 array, decoded and unpacked"""
+        if np is None:
+            raise RuntimeError("numpy is required to decode the blocks, use raw()")
+        h = self.header
+        if h["codec"] != 0:
+            return decode_block(self.raw(frame, device), h)
+        if h["packing"]:
+            return unpack12(self.raw(frame, device)[:h["width"] * h["height"] * 3 // 2])
+        return np.frombuffer(self.raw(frame, device), dtype="<i2")
+
+    def frame(self, frame: int, device: int = 0):
+        """ADC data of a device block as a (chirps, samples, rx, values) int16 array
+
+        A zero-copy view for 16-bit uncompressed containers. Requires numpy and
+        chirps holding interleaved ADC data only.
+        """
+        h = self.header
+        if h["width"] != h["numAdcSamples"] * h["numRx"] * h["valsPerSample"]:
+            raise ValueError("the chirps do not hold ADC data only, use values()")
+        if h["chInterleave"]:
+            raise ValueError("the RX channels are not interleaved, use values()")
+        data = self.values(frame, device)
+        return data.reshape(h["height"], h["numAdcSamples"], h["numRx"], h["valsPerSample"])
+
+    def rx(self, frame: int, device: int = 0, rx: int = 0):
+        """One RX channel of a device block as a (chirps, samples, values) view
+
+        Interleaved or not RX channels, as cap_rx_view.
+        """
+        h = self.header
+        if not h["chInterleave"]:
+            return self.frame(frame, device)[:, :, rx, :]
+        if h["width"] != h["numAdcSamples"] * h["numRx"] * h["valsPerSample"]:
+            raise ValueError("the chirps do not hold ADC data only, use values()")
+        data = self.values(frame, device)
+        return data.reshape(h["height"], h["numRx"], h["numAdcSamples"], h["valsPerSample"])[:, rx]
+
+
+def load_rdmaps(path: str):
+    """Header and heatmaps of a range-Doppler map file
+
+    The heatmaps are a (frames, doppler, range) float32 array, or a memoryview
+    of float values without numpy. The zero velocity bin is numDoppler // 2.
+    """
+    with open(path, "rb") as f:
+        data = f.read()
+    header = dict(zip(RD_FIELDS, RD_HEADER.unpack_from(data, 0)))
+    del header["reserved"], header["reserved0"]
+    size = header["numFrames"] * header["numDoppler"] * header["numRange"] * 4
+    if (header["magic"] != RD_MAGIC or header["version"] != RD_VERSION
+            or header["headerSize"] != RD_HEADER.size or RD_HEADER.size + size > len(data)):
+        raise ValueError(f"{path}: not a complete version {RD_VERSION} range-Doppler map file")
+    maps = data[RD_HEADER.size:RD_HEADER.size + size]
+    if np is None:
+        return header, memoryview(maps).cast("f")
+    shape = (header["numFrames"], header["numDoppler"], header["numRange"])
+    return header, np.frombuffer(maps, dtype="<f4").reshape(shape)
+
+
+class AlignmentIndex:
+    """Frame triggers of the boards of a session (.mmwalign)
+
+    Frame n of a board is triggered framePeriod * n after the start dispatch
+    of its master (CLOCK_REALTIME, ns); frames are paired from these times,
+    without reading the captures.
+    """
+
+    def __init__(self, path: str):
+        with open(path, "rb") as f:
+            data = f.read()
+        if len(data) < ALIGN_HEADER.size:
+            raise ValueError(f"{path}: not a version {ALIGN_VERSION} alignment index")
+        magic, version, header_size, board_size, num_boards, capture_dir = \
+            ALIGN_HEADER.unpack_from(data, 0)
+        if (magic != ALIGN_MAGIC or version != ALIGN_VERSION or header_size != ALIGN_HEADER.size
+                or board_size != ALIGN_BOARD.size or not 0 < num_boards <= 8):
+            raise ValueError(f"{path}: not a version {ALIGN_VERSION} alignment index")
+        self.captureDir = capture_dir.split(b"\0", 1)[0].decode()
+        self.numBoards = num_boards
+        records = []
+        for b in range(num_boards):
+            offset = ALIGN_HEADER.size + b * ALIGN_BOARD.size
+            if offset + ALIGN_BOARD.size > len(data):
+                break  # Board failed before its first record
+            v = ALIGN_BOARD.unpack_from(data, offset)
+            records.append({
+                "ipAddr": v[0].split(b"\0", 1)[0].decode(), "sessionTime": v[1],
+                "framePeriod": v[2], "numFrames": v[3], "deviceMap": v[4], "boardIndex": v[5],
+                "flags": v[6], "startTime": v[7:11], "startMono": v[11:15],
+                "startEvent": v[15:19], "stopTime": v[19:23], "stopMono": v[23:27],
+                "stopEvent": v[27:31],
+            })
+        started = [r for b, r in enumerate(records) if r["flags"] & ALIGN_STARTED
+                   and r["framePeriod"] > 0 and r["boardIndex"] == b]
+        if not started:
+            raise ValueError(f"{path}: no board started")
+        # Records of an older session are ignored
+        session = max(r["sessionTime"] for r in started)
+        self.boards = {r["boardIndex"]: r for r in started if r["sessionTime"] == session}
+
+    def start_time(self, board: int) -> int:
+        """Start dispatch of the master of a board (CLOCK_REALTIME, ns)"""
+        r = self.boards[board]
+        for d in range(len(DEVICES)):
+            if r["deviceMap"] & (1 << d) and r["startTime"][d]:
+                return r["startTime"][d]
+        return r["startTime"][0]
+
+    def num_frames(self, board: int) -> int:
+        """Frames triggered before the stop (0: unknown, framing until stopped)"""
+        r = self.boards[board]
+        if not r["flags"] & ALIGN_STOPPED:
+            return r["numFrames"]
+        start = self.start_time(board)
+        ref = r["startTime"].index(start)
+        stop = r["stopTime"][ref]
+        frames = -(-(stop - start) // r["framePeriod"]) if stop > start else 0
+        return min(frames, r["numFrames"]) if r["numFrames"] else frames
+
+    def frame_time(self, board: int, frame: int) -> int:
+        """Trigger time of a frame of a board (CLOCK_REALTIME, ns)"""
+        return self.start_time(board) + frame * self.boards[board]["framePeriod"]
+
+    def frame_at(self, board: int, time: int):
+        """Frame of a board triggered closest to a time and its skew (ns), or None"""
+        r = self.boards[board]
+        start, half = self.start_time(board), r["framePeriod"] // 2
+        if time + half < start:
+            return None
+        frame = (time + half - start) // r["framePeriod"]
+        n = self.num_frames(board)
+        if (n or r["flags"] & ALIGN_STOPPED) and frame >= n:
+            return None
+        return frame, start + frame * r["framePeriod"] - time
+
+    def pairs(self, a: int, b: int, tolerance: int = 0, first: int = 0):
+        """(frame of a, frame of b, skew in ns) triggered at most tolerance apart
+
+        The tolerance defaults to half the shorter frame period.
+        """
+        if not tolerance:
+            tolerance = min(self.boards[a]["framePeriod"], self.boards[b]["framePeriod"]) // 2
+        n = self.num_frames(a)
+        first_b = self.frame_time(b, 0)
+        i = first
+        while not n or i < n:
+            t = self.frame_time(a, i)
+            found = self.frame_at(b, t)
+            if found is None:
+                if t > first_b:
+                    return
+            elif abs(found[1]) <= tolerance:
+                yield i, found[0], found[1]
+            i += 1
+
+
+if __name__ == "__main__":
+    if len(sys.argv) in (2, 3) and sys.argv[1].endswith(".mmwalign"):
+        index = AlignmentIndex(sys.argv[1])
+        ref, *others = sorted(index.boards)
+        print(f"captureDir: {index.captureDir} | boards: {index.numBoards}")
+        for b, r in sorted(index.boards.items()):
+            offset = (index.start_time(b) - index.start_time(ref)) / 1e3
+            print(f"board {b} {r['ipAddr']}: {index.num_frames(b)} frames of "
+                  f"{r['framePeriod'] / 1e6:.3f} ms, start {offset:+.1f} us")
+        count = int(sys.argv[2]) if len(sys.argv) == 3 else 10
+        for b in others:
+            for n, (fa, fb, skew) in enumerate(index.pairs(ref, b)):
+                if n >= count:
+                    break
+                print(f"board {ref} frame {fa} <-> board {b} frame {fb} ({skew / 1e3:+.1f} us)")
+        sys.exit(0)
+    if len(sys.argv) not in (2, 3):
+        print(__doc__)
+        sys.exit(1)
+    with CaptureFile(sys.argv[1]) as cap:
+        for key, value in cap.header.items():
+            print(f"{key}: {value}")
+        print(f"devices: {', '.join(DEVICES[d] for d in cap.devices)}")
+        if len(sys.argv) == 3:
+            n = int(sys.argv[2])
+            for d in cap.devices:
+                e = cap.entry(n, d)
+                if cap.header["codec"] == 0 and not cap.header["packing"]:
+                    with cap.raw(n, d) as raw, raw.cast("h") as data:
+                        first = list(data[:8])
+                else:
+                    first = cap.values(n, d)[:8].tolist()
+                print(f"frame {n} {DEVICES[d]}: offset {e['offset']} "
+                      f"t {e['timestamp'] / 1e6:.3f} ms first values {first}")
@@ -1,6 +1,34 @@
-def mmw_set_config(configdict: dict) -> int: ...
-def mmw_init(ip_addr: str="192.168.33.180", port: int=5001) -> int: ...
+class MmwConfig:
+    num_frames: int
+    def __init__(self, configdict: dict | None=None) -> None: ...
+    @property
+    def frame_periodicity(self) -> float: ...
+    @property
+    def num_adc_samples(self) -> int: ...
+    @property
+    def num_sub_frames(self) -> int: ...
+
+def mmw_set_config(configdict: dict | MmwConfig) -> int: ...
+def mmw_init(ip_addr: str="192.168.33.180", port: int=5001, irq_mode: int=1, full: int=0, recalibrate: int=0) -> int: ...
 def mmw_arming_tda(capture_path: str) -> int: ...
 def mmw_start_frame() -> int: ...
 def mmw_stop_frame() -> int: ...
 def mmw_dearming_tda() -> int: ...
+def mmw_export_json(filename: str, num_devices: int=4) -> int: ...
+def mmw_export_health(filename: str, num_devices: int=4) -> int: ...
+def mmw_profile(enable: bool=True) -> int: ...
+def mmw_export_profile(filename: str) -> int: ...
+def mmw_stream_open(ip_addr: str="192.168.33.180", port: int=5002, slots: int=64) -> int: ...
+def mmw_stream_read(timeout_ms: int=1000) -> tuple[int, int, bytes] | None: ...
+def mmw_stream_stats() -> dict: ...
+def mmw_stream_close() -> int: ...
+def mmw_cube_layout(json_path: str, data_packing: int=0) -> tuple[int, int, int, int, int]: ...
+def mmw_cube_reorder(raw: list, threads: int=0) -> bytearray: ...
+def mmw_rd_plan(db: int=1) -> tuple[int, int]: ...
+def mmw_rd_process(cubes: bytes | bytearray, threads: int=0) -> bytearray: ...
+async def mmw_init_async(ip_addr: str="192.168.33.180", port: int=5001, irq_mode: int=1, full: int=0, recalibrate: int=0) -> int: ...
+async def mmw_arming_tda_async(capture_path: str) -> int: ...
+async def mmw_start_frame_async() -> int: ...
+async def mmw_stop_frame_async() -> int: ...
+async def mmw_dearming_tda_async() -> int: ...
+async def mmw_stream_read_async(timeout_ms: int=1000) -> tuple[int, int, bytes] | None: ...
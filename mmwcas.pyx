@@ -1,9 +1,38 @@
 #from libc.stdio cimport printf as DEBUG_PRINT
 from libc.stdio cimport printf
-from libc.stdint cimport uint8_t, int8_t,int16_t,uint16_t, int32_t, uint32_t
+from libc.stdint cimport uint8_t, int8_t,int16_t,uint16_t, int32_t, uint32_t, uint64_t
+from libc.string cimport memset, memcpy
 from libc.math cimport ceil
 
-cdef extern from "ti/mmwave/mmwave.h":
+cdef extern from "ti/mmwave/mmwl_health.h" nogil:
+    # Aggregates of the monitoring reports of each device
+    ctypedef struct mmwlMonCfg_t:
+        uint8_t enable
+        uint8_t reportMode
+        uint16_t period
+        int16_t tempMin
+        int16_t tempMax
+        uint16_t tempDiff
+        uint16_t rxGainErr
+        uint16_t txPowerErr
+        uint16_t synthFreqErr
+    ctypedef struct mmwlHealthStat_t:
+        unsigned int reports
+        unsigned int errors
+        uint16_t lastError
+        uint16_t status
+        uint8_t numValues
+        int32_t last[12]
+    ctypedef struct mmwlHealthSnapshot_t:
+        unsigned int dropped[4]
+        mmwlHealthStat_t stat[4][6]
+    uint8_t MMWL_monitorByName(const char* name)
+    const char* MMWL_healthName(unsigned int monitor)
+    void MMWL_healthReset(mmwlHealthSnapshot_t* snap)
+    void MMWL_healthCollect(mmwlHealthSnapshot_t* snap)
+
+# The hardware calls (and the exports, which write files) run without the GIL
+cdef extern from "ti/mmwave/mmwave.h" nogil:
     '''
     FILE* rls_traceF = NULL;
     void CloseTraceFile() {
@@ -45,6 +74,48 @@ cdef extern from "ti/mmwave/mmwave.h":
         uint16_t reserved1
         uint32_t frameTriggerDelay
 
+    ctypedef struct rlSubFrameCfg_t:
+        uint16_t forceProfileIdx
+        uint16_t chirpStartIdx
+        uint16_t numOfChirps
+        uint16_t numLoops
+        uint32_t burstPeriodicity
+        uint16_t chirpStartIdxOffset
+        uint16_t numOfBurst
+        uint16_t numOfBurstLoops
+        uint16_t reserved0
+        uint32_t subFramePeriodicity
+        uint32_t reserved1
+        uint32_t reserved2
+
+    ctypedef struct rlAdvFrameSeqCfg_t:
+        uint8_t numOfSubFrames
+        uint8_t forceProfile
+        uint8_t loopBackCfg
+        uint8_t subFrameTrigger
+        rlSubFrameCfg_t subFrameCfg[4]
+        uint16_t numFrames
+        uint16_t triggerSelect
+        uint32_t frameTrigDelay
+        uint32_t reserved0
+        uint32_t reserved1
+
+    ctypedef struct rlSubFrameDataCfg_t:
+        uint32_t totalChirps
+        uint16_t numAdcSamples
+        uint8_t numChirpsInDataPacket
+        uint8_t reserved
+
+    ctypedef struct rlAdvFrameDataCfg_t:
+        uint8_t numSubFrames
+        uint8_t reserved0
+        uint16_t reserved1
+        rlSubFrameDataCfg_t subframeDataCfg[4]
+
+    ctypedef struct rlAdvFrameCfg_t:
+        rlAdvFrameSeqCfg_t frameSeq
+        rlAdvFrameDataCfg_t frameData
+
     ctypedef struct rlChirpCfg_t:
         uint16_t chirpStartIdx
         uint16_t chirpEndIdx
@@ -127,6 +198,7 @@ cdef extern from "ti/mmwave/mmwave.h":
         unsigned int numberOfFramesToCapture
 
     int MMWL_chirpConfig(unsigned char deviceMap, rlChirpCfg_t chirpCfgArgs)
+    int MMWL_chirpTableConfig(unsigned char deviceMap, rlChirpCfg_t **chirpTables, unsigned short *chirpCounts)
     unsigned int createDevMapFromDevId(unsigned char devId)
     int MMWL_DevicePowerUp(unsigned char deviceMap, uint32_t rlClientCbsTimeout, uint32_t sopTimeout)
     int MMWL_firmwareDownload(unsigned char deviceMap)
@@ -141,17 +213,173 @@ cdef extern from "ti/mmwave/mmwave.h":
     int MMWL_ApllSynthBwConfig(unsigned char deviceMap)
     int MMWL_setMiscConfig(unsigned char deviceMap, rlRfMiscConf_t miscCfg)
     int MMWL_rfInit(unsigned char deviceMap)
+    int MMWL_rfInitCached(unsigned char deviceMap, const char* ipAddr, unsigned char restore)
     int MMWL_dataPathConfig(unsigned char deviceMap, rlDevDataPathCfg_t datapathCfgArgs)
     int MMWL_hsiClockConfig(unsigned char deviceMap, rlDevDataPathClkCfg_t datapathClkCfgArgs, rlDevHsiClk_t hisClkgs)
     int MMWL_CSI2LaneConfig(unsigned char deviceMap, rlDevCsi2Cfg_t CSI2LaneCfgArgs)
     int MMWL_profileConfig(unsigned char deviceMap, rlProfileCfg_t profileCfgArgs)
+    int MMWL_profileTableConfig(unsigned char deviceMap, rlProfileCfg_t* profileCfgArgs, unsigned short count)
     int MMWL_frameConfig(unsigned char deviceMap, rlFrameCfg_t frameCfgArgs, rlChanCfg_t channelCfgArgs, rlAdcOutCfg_t adcOutCfgArgs, rlDevDataPathCfg_t datapathCfgArgs, rlProfileCfg_t profileCfgArgs)
+    int MMWL_advFrameConfig(unsigned char deviceMap, rlAdvFrameCfg_t advFrameCfgArgs, rlChanCfg_t channelCfgArgs, rlAdcOutCfg_t adcOutCfgArgs, rlDevDataPathCfg_t datapathCfgArgs, rlProfileCfg_t profileCfgArgs)
     int MMWL_AssignDeviceMap(unsigned char deviceMap,uint8_t* masterMap,uint8_t* slavesMap)
     int MMWL_ArmingTDA(rlTdaArmCfg_t tdaArmCfgArgs)
     int MMWL_StartFrame(unsigned char deviceMap)
     int MMWL_StopFrame(unsigned char deviceMap)
+
+    # Frame start/stop with the slaves released at once, then the master
+    ctypedef struct mmwlFrameSync_t:
+        unsigned char aborted
+        uint64_t releaseTime
+        uint64_t slaveSkew
+        uint64_t masterDelay
+    int MMWL_StartFrameSync(unsigned char deviceMap, mmwlFrameSync_t* sync)
+    int MMWL_StopFrameSync(unsigned char deviceMap, mmwlFrameSync_t* sync)
     int MMWL_DeArmingTDA()
-    int MMWL_TDAInit(unsigned char *ipAddr , unsigned int port,uint8_t deviceMap)
+    int MMWL_TDAInit(unsigned char *ipAddr , unsigned int port,uint8_t deviceMap, uint8_t irqMode)
+
+    # Configuration state recorded between sessions
+    int MMWL_CFG_BLOCK_DEVICE
+    int MMWL_CFG_BLOCK_PROFILE
+    int MMWL_CFG_BLOCK_CHIRP
+    int MMWL_CFG_BLOCK_FRAME
+    ctypedef struct mmwlCfgState_t:
+        uint32_t magic
+        uint32_t version
+        uint32_t deviceMap
+        uint32_t imageHash
+        uint64_t blockHash[4]
+    uint64_t MMWL_cfgHash(uint64_t hash, const void* data, size_t length)
+    int MMWL_cfgStateLoad(const char* ipAddr, mmwlCfgState_t* state)
+    int MMWL_cfgStateSave(const char* ipAddr, const mmwlCfgState_t* state)
+    int MMWL_cfgStateClear(const char* ipAddr)
+    unsigned int MMWL_cfgStateDiff(const mmwlCfgState_t* previous, const mmwlCfgState_t* current)
+    int MMWL_DeviceAttach(unsigned char deviceMap, uint32_t timeout)
+    unsigned int MMWL_getFrameSize(unsigned char deviceMap)
+
+    # Set-config transactions (sub-blocks packed into as few messages as possible)
+    ctypedef struct mmwlTxn_t:
+        unsigned char deviceMap
+        unsigned int numEntries
+        unsigned int numMessages
+    void MMWL_txnInit(mmwlTxn_t* txn, unsigned char deviceMap)
+    int MMWL_txnLdoBypass(mmwlTxn_t* txn, rlRfLdoBypassCfg_t rfLdoBypassCfgArgs)
+    int MMWL_txnDataFmt(mmwlTxn_t* txn, rlDevDataFmtCfg_t dataFmtCfgArgs)
+    int MMWL_txnLowPower(mmwlTxn_t* txn, rlLowPowerModeCfg_t rfLpModeCfgArgs)
+    int MMWL_txnApllSynthBw(mmwlTxn_t* txn)
+    int MMWL_txnMisc(mmwlTxn_t* txn, rlRfMiscConf_t miscCfg)
+    int MMWL_txnDataPath(mmwlTxn_t* txn, rlDevDataPathCfg_t dataPathCfgArgs)
+    int MMWL_txnHsiClock(mmwlTxn_t* txn, rlDevDataPathClkCfg_t dataPathClkCfgArgs, rlDevHsiClk_t hsiClkgs)
+    int MMWL_txnCSI2Lane(mmwlTxn_t* txn, rlDevCsi2Cfg_t CSI2LaneCfgArgs)
+    int MMWL_txnCommit(mmwlTxn_t* txn)
+    int MMWL_txnStatus(const mmwlTxn_t* txn, int entry)
+
+    # Batches of API calls, queued on the device workers without barrier
+    ctypedef struct mmwlBatch_t:
+        unsigned int numCalls
+    void MMWL_batchInit(mmwlBatch_t* batch)
+    int MMWL_batchTxn(mmwlBatch_t* batch, mmwlTxn_t* txn)
+    int MMWL_batchRFDeviceConfig(mmwlBatch_t* batch, unsigned char deviceMap)
+    int MMWL_batchProfileConfig(mmwlBatch_t* batch, unsigned char deviceMap, rlProfileCfg_t profileCfgArgs)
+    int MMWL_batchProfileTable(mmwlBatch_t* batch, unsigned char deviceMap, rlProfileCfg_t* profileCfgArgs, unsigned short count)
+    int MMWL_batchWait(mmwlBatch_t* batch)
+    int MMWL_batchStatus(const mmwlBatch_t* batch, int call)
+
+    # RF health monitors, reported asynchronously while framing
+    int MMWL_monitorConfig(unsigned char deviceMap, mmwlMonCfg_t monCfgArgs, rlChanCfg_t rfChanCfgArgs, rlProfileCfg_t profileCfgArgs)
+
+cdef extern from "dsp/cube.h":
+    # Reorder of the raw ADC data into MIMO virtual array cubes
+    int DSP_MAX_DEVICES
+    int DSP_MAX_CHIRPS
+    ctypedef struct dspLayout_t:
+        uint8_t deviceMap
+        uint8_t rxChannelEn
+        uint16_t numSamples
+        uint16_t numLoops
+        uint16_t numChirps
+        uint16_t chirpTx[4][64]
+        uint8_t iqSwap
+        uint8_t chInterleave
+        uint8_t complex
+        uint8_t packed12
+        uint8_t numDevices
+        uint8_t numRx
+        uint8_t numTx
+        uint32_t chirpBytes
+        uint32_t frameBytes
+        size_t cubeSize
+    int32_t dsp_layout_init(dspLayout_t* layout)
+    int32_t dsp_cube_frames(dspLayout_t* layout, const uint8_t** raw, size_t rawStride, uint32_t numFrames, float* cube, uint8_t threads) nogil
+    const char* dsp_cube_kernel(dspLayout_t* layout)
+
+cdef extern from "dsp/rd.h":
+    # Range/Doppler processing of the cubes
+    int DSP_RD_LINEAR
+    int DSP_RD_DB
+    ctypedef struct dspRdPlan_t:
+        uint16_t rangeFft
+        uint16_t dopplerFft
+        uint16_t numRange
+        size_t mapSize
+        float* rangeTwiddles
+    int32_t dsp_rd_plan_init(dspRdPlan_t* plan, dspLayout_t* layout, uint8_t scale)
+    void dsp_rd_plan_free(dspRdPlan_t* plan)
+    int32_t dsp_rd_frames(dspRdPlan_t* plan, const float* cubes, uint32_t numFrames, float* maps, uint8_t threads) nogil
+
+cdef extern from "json/json.h" nogil:
+    # Serializer of the mmWave Studio configuration, shared with the CLI
+    ctypedef struct jsonDevConfig_t:
+        rlProfileCfg_t profileCfg
+        rlFrameCfg_t frameCfg
+        rlChanCfg_t channelCfg
+        rlAdcOutCfg_t adcOutCfg
+        rlLowPowerModeCfg_t lpmCfg
+        rlRfMiscConf_t miscCfg
+        rlRfLdoBypassCfg_t ldoCfg
+        rlDevDataFmtCfg_t dataFmtCfg
+        rlDevDataPathCfg_t datapathCfg
+        rlDevDataPathClkCfg_t datapathClkCfg
+        rlDevCsi2Cfg_t csi2LaneCfg
+        rlAdvFrameCfg_t advFrameCfg
+        rlProfileCfg_t subProfileCfg[4]
+    int json_export_config(const char* filename, const jsonDevConfig_t* config, int num_devices)
+    int json_export_profile(const char* filename)
+    int json_export_health(const char* filename, const mmwlHealthSnapshot_t* snap, int num_devices)
+
+cdef extern from "ti/ethernet/src/mmwl_prof.h" nogil:
+    # Latency profiler of the bring-up, written by json_export_profile
+    void TDAProfEnable(uint8_t enable)
+    uint64_t TDAProfNow()
+    void TDAProfStage(const char* name, uint64_t start, uint64_t end)
+    uint64_t TDA_PROF_START()
+
+cdef extern from "ti/mmwave/mmwl_stream.h" nogil:
+    # Live ADC stream receiver
+    ctypedef struct mmwlStreamSlot_t:
+        uint32_t sequence
+        uint32_t length
+        uint32_t deviceMap
+        uint64_t timestamp
+        uint8_t* data
+    ctypedef struct mmwlStreamStats_t:
+        uint64_t frames
+        uint64_t bytes
+        uint64_t oversized
+        uint64_t lost
+        uint32_t connections
+    ctypedef struct mmwlStream_t:
+        uint32_t numSlots
+        uint32_t slotSize
+        uint8_t hugePages
+        uint8_t connected
+        mmwlStreamStats_t stats
+    ctypedef struct mmwlStreamReader_t:
+        uint64_t missed
+    int MMWL_streamOpen(mmwlStream_t* stream, const char* ipAddr, uint16_t port, uint32_t frameSize, uint32_t numSlots)
+    void MMWL_streamClose(mmwlStream_t* stream)
+    void MMWL_streamReaderInit(mmwlStream_t* stream, mmwlStreamReader_t* reader)
+    const mmwlStreamSlot_t* MMWL_streamNext(mmwlStreamReader_t* reader, uint32_t timeoutMs) nogil
+    int MMWL_streamRelease(mmwlStreamReader_t* reader)
 
 
 
@@ -163,6 +391,7 @@ cdef char* PROG_COPYRIGHT = b"Copyright (C) 2024"
 #DEBUG_PRINT = printf             # Debug print function
 
 cdef int RL_RET_CODE_OK = 0               # Return code for success
+cdef int RL_RET_CODE_INVALID_INPUT = -2   # Return code for an invalid input
 
 # 开发环境标志和其他常量
 cdef int DEV_ENV = 1
@@ -173,6 +402,7 @@ cdef char* CGREEN=b"\e[0;32m"    # Terminal code for regular greed text
 cdef char* CRESET=b"\e[0m"       # Clear reset terminal color
 
 cdef int TRUE = 1
+cdef int FALSE = 0
 
 
 # 设备配置结构体
@@ -186,6 +416,11 @@ ctypedef struct devConfig_t:
     # Profile configuration
     rlProfileCfg_t profileCfg
 
+    # Advanced frame (frameSeq.numOfSubFrames 0: legacy frame) and the
+    # profile of each sub-frame
+    rlAdvFrameCfg_t advFrameCfg
+    rlProfileCfg_t subProfileCfg[4]
+
     # Chirp configuration
     rlChirpCfg_t chirpCfg
 
@@ -219,6 +454,9 @@ ctypedef struct devConfig_t:
     # CSI2 configuration
     rlDevCsi2Cfg_t csi2LaneCfg
 
+    # RF health monitoring configuration
+    mmwlMonCfg_t monCfg
+
 """! \brief
 * Profile config API parameters. A profile contains coarse parameters of FMCW chirp such as
 * start frequency, chirp slope, ramp time, idle time etc. Fine dithering values need
@@ -364,6 +602,21 @@ cdef rlDevCsi2Cfg_t csi2LaneCfgArgs = rlDevCsi2Cfg_t(
     lanePosPolSel = 0x35421,   # 0b 0011 0101 0100 0010 0001,
 )
 
+"""! \brief
+* RF health monitoring configuration
+"""
+cdef mmwlMonCfg_t monCfgArgs = mmwlMonCfg_t(
+    enable = 0,                # Monitors disabled
+    reportMode = 2,            # Every period, with the threshold check
+    period = 100,              # Device default (frames)
+    tempMin = -40,             # C
+    tempMax = 125,
+    tempDiff = 20,
+    rxGainErr = 30,            # 3 dB
+    txPowerErr = 30,           # 3 dB
+    synthFreqErr = 400,        # 4 MHz
+)
+
 """
 |-------|-------|-------|-------|-------|-------|-------|-------|-------|-------|-------|-------|-------|
 |       | Dev 1 | Dev 1 | Dev 1 | Dev 2 | Dev 2 | Dev 2 | Dev 3 | Dev 3 | Dev 3 | Dev 4 | Dev 4 | Dev 4 |
@@ -385,7 +638,7 @@ cdef rlDevCsi2Cfg_t csi2LaneCfgArgs = rlDevCsi2Cfg_t(
 """
 
 
-cdef int8_t is_in_table(uint8_t value, uint8_t[:] table, uint8_t size):
+cdef int8_t is_in_table(uint8_t value, const uint8_t* table, uint8_t size) nogil:
     '''@brief Check if a value is in the table provided in argument
     #* @param value Value to look for in the table
     #* @param table Table defining the search context
@@ -400,44 +653,90 @@ cdef int8_t is_in_table(uint8_t value, uint8_t[:] table, uint8_t size):
     return -1
 
 
-cpdef uint32_t configureMimoChirp(uint8_t devId, rlChirpCfg_t chirpCfg):
-    """@brief MIMO Chirp configuration
+# Chirp index of the 3 TX of each device in the MIMO sequence
+cdef uint8_t[4][3] chripTxTable=[[11,10,9],[8,7,6],[5,4,3],[2,1,0]]
+
+cdef uint16_t buildMimoChirpTable(uint8_t devId, rlChirpCfg_t chirpCfg, rlChirpCfg_t* table) nogil:
+    """@brief Build the MIMO chirp table of a device
+    #* Consecutive chirps sharing the same TX mask are merged into one entry
     #* @param devId Device ID (0: master, 1: slave1, 2: slave2, 3: slave3)
     #* @param chirpCfg Initital chirp configuration
-    #* @return uint32_t Configuration status
+    #* @param table Output chirp table (at least NUM_CHIRPS entries)
+    #* @return uint16_t Number of entries in the table
     """
-    # 定义设备的 Tx 表
-    cdef uint8_t[4][3] chripTxTable=[[11,10,9],[8,7,6],[5,4,3],[2,1,0]]
-    
-    # 定义状态变量
-    cdef int status = 0
+    cdef uint16_t count = 0
+    cdef uint16_t txEnable
     cdef uint8_t i
     cdef int8_t txIdx
-    
+
     for i in range(NUM_CHIRPS):
         txIdx = is_in_table(i, chripTxTable[devId], 3)
+        txEnable = 0x00 if txIdx < 0 else (1 << txIdx)
 
-        # 更新 chirp 配置
-        chirpCfg.chirpStartIdx = i
-        chirpCfg.chirpEndIdx = i
-        if txIdx < 0:
-            chirpCfg.txEnable = 0x00
-        else:
-            chirpCfg.txEnable = (1 << txIdx)
+        if count > 0 and table[count - 1].txEnable == txEnable:
+            table[count - 1].chirpEndIdx = i
+            continue
+        table[count] = chirpCfg
+        table[count].chirpStartIdx = i
+        table[count].chirpEndIdx = i
+        table[count].txEnable = txEnable
+        count += 1
+    return count
 
-        # 配置 chirp 并更新状态
-        status += MMWL_chirpConfig(createDevMapFromDevId(devId), chirpCfg)
 
-        # 打印调试信息
-        printf(b"[CHIRP CONFIG] dev %u, chirp idx %u, status: %d\n", devId, i, status)
-        if status != 0:
-            printf(b"Configuration of chirp %d failed!\n", i)
-            break
+cpdef uint32_t configureMimoChirp(uint8_t deviceMap, rlChirpCfg_t chirpCfg, uint8_t numSubFrames=0) nogil:
+    """@brief MIMO Chirp configuration
+    #* The chirp table of each device is sent in as few messages as possible
+    #* and all the devices of the device map are programmed concurrently.
+    #* With an advanced frame, sub-frame n uses its own copy of the MIMO
+    #* chirps, from index n * NUM_CHIRPS, with profile n.
+    #* @param deviceMap Devices to configure
+    #* @param chirpCfg Initital chirp configuration
+    #* @param numSubFrames Number of sub-frames (0: legacy frame)
+    #* @return uint32_t Configuration status
+    """
+    cdef rlChirpCfg_t tables[4][48]
+    cdef rlChirpCfg_t* pTables[4]
+    cdef unsigned short counts[4]
+    cdef uint8_t devId, sub
+    cdef uint16_t i, count
+
+    if numSubFrames > 4:
+        return RL_RET_CODE_INVALID_INPUT
+    for devId in range(4):
+        pTables[devId] = NULL
+        counts[devId] = 0
+        if (deviceMap & (1 << devId)) == 0:
+            continue
+        for sub in range(numSubFrames if numSubFrames > 0 else 1):
+            if numSubFrames > 0:
+                chirpCfg.profileId = sub
+            count = buildMimoChirpTable(devId, chirpCfg, &tables[devId][counts[devId]])
+            for i in range(counts[devId], counts[devId] + count):
+                tables[devId][i].chirpStartIdx += sub * NUM_CHIRPS
+                tables[devId][i].chirpEndIdx += sub * NUM_CHIRPS
+            counts[devId] += count
+        pTables[devId] = tables[devId]
+
+    return MMWL_chirpTableConfig(deviceMap, pTables, counts)
+
+cdef int32_t configureFrame(devConfig_t* config, uint8_t deviceMap) nogil:
+    """@brief Frame configuration, legacy or advanced
+    #* @param config Device configuration
+    #* @param deviceMap Devices to configure (the master or the slaves)
+    #* @return int32_t Configuration status
+    """
+    if config.advFrameCfg.frameSeq.numOfSubFrames > 0:
+        return MMWL_advFrameConfig(deviceMap, config.advFrameCfg, config.channelCfg,
+            config.adcOutCfg, config.datapathCfg, config.subProfileCfg[0])
+    return MMWL_frameConfig(deviceMap, config.frameCfg, config.channelCfg,
+        config.adcOutCfg, config.datapathCfg, config.profileCfg)
 
-    return status
+# Start of the current stage when profiling (mmw_profile)
+cdef uint64_t profile_stage = 0
 
 cdef void check(int status, char* success_msg, char* error_msg,
-                unsigned char deviceMap, uint8_t is_required):
+                unsigned char deviceMap, uint8_t is_required) nogil:
     """@brief Check status and print error or success message
     @param status Status value returned by a function
     @param success_msg Success message to print when status is 0
@@ -449,6 +748,12 @@ cdef void check(int status, char* success_msg, char* error_msg,
     @note: Status is considered successful when the status integer is 0.
     Any other value is considered a failure.
     """
+    global profile_stage
+    cdef uint64_t stage_end = TDA_PROF_START()
+    if stage_end != 0:
+        TDAProfStage(success_msg, profile_stage, stage_end)
+        profile_stage = stage_end
+
     # 模拟 DEV_ENV 环境下的调试信息
     if DEV_ENV:
         printf(b"STATUS %4d | DEV MAP: %2u | ", status, deviceMap)
@@ -470,24 +775,48 @@ cdef void check(int status, char* success_msg, char* error_msg,
         
         # 如果 is_required 为非零，则退出程序
         if is_required != 0:
-            exit(status)
+            with gil:
+                exit(status)
 
 
-cdef int32_t initMaster(rlChanCfg_t channelCfg,rlAdcOutCfg_t adcOutCfg):
-    cdef unsigned int masterId = 0
-    cdef unsigned int masterMap = 1U << masterId
+cdef int32_t bootDevices(uint8_t masterMap, uint8_t slavesMap) nogil:
+    """@brief Power up all the devices and download the firmware
+    #* The master is powered up first, then the slaves. The firmware is then
+    #* downloaded to all the devices in a single concurrent phase.
+    #* @param masterMap Master device map
+    #* @param slavesMap Slave devices map
+    #* @return int32_t Boot status
+    """
     cdef int status = 0
-    channelCfg.cascading = 1
+    cdef unsigned int slaveMap
+    cdef uint8_t slaveId
+
     status += MMWL_DevicePowerUp(masterMap, 1000, 1000)
     check(status,
         b"[MASTER] Power up successful!",
         b"[MASTER] Error: Failed to power up device!", masterMap, TRUE)
 
-    status += MMWL_firmwareDownload(masterMap)
+    for slaveId in range(1,4):
+        slaveMap = 1 << slaveId
+        if (slavesMap & slaveMap) == 0:
+            continue
+
+        status += MMWL_DevicePowerUp(slaveMap, 1000, 1000)
+        check(status,
+            b"[SLAVE] Power up successful!",
+            b"[SLAVE] Error: Failed to power up device!", slaveMap, TRUE)
+
+    status += MMWL_firmwareDownload(masterMap | slavesMap)
     check(status,
-        b"[MASTER] Firmware successfully uploaded!",
-        b"[MASTER] Error: Firmware upload failed!", masterMap, TRUE)
+        b"[ALL] Firmware successfully uploaded!",
+        b"[ALL] Error: Firmware upload failed!", masterMap | slavesMap, TRUE)
+    return status
 
+cdef int32_t initMaster(rlChanCfg_t channelCfg,rlAdcOutCfg_t adcOutCfg) nogil:
+    cdef unsigned int masterId = 0
+    cdef unsigned int masterMap = 1U << masterId
+    cdef int status = 0
+    channelCfg.cascading = 1
     status += MMWL_setDeviceCrcType(masterMap)
     check(status,
         b"[MASTER] CRC type has been set!",
@@ -513,7 +842,7 @@ cdef int32_t initMaster(rlChanCfg_t channelCfg,rlAdcOutCfg_t adcOutCfg):
         b"[MASTER] Init completed with error", masterMap, TRUE)
     return status
 
-cdef int32_t initSlaves(rlChanCfg_t channelCfg, rlAdcOutCfg_t adcOutCfg):
+cdef int32_t initSlaves(rlChanCfg_t channelCfg, rlAdcOutCfg_t adcOutCfg) nogil:
     cdef int status = 0
     cdef uint8_t slavesMap = (1 << 1) | (1 << 2) | (1 << 3)
     cdef unsigned int slaveMap
@@ -521,20 +850,7 @@ cdef int32_t initSlaves(rlChanCfg_t channelCfg, rlAdcOutCfg_t adcOutCfg):
     # slave chip
     channelCfg.cascading = 2
 
-    for slaveId in range(1,4):
-        slaveMap = 1 << slaveId
-
-        status += MMWL_DevicePowerUp(slaveMap, 1000, 1000)
-        check(status,
-            b"[SLAVE] Power up successful!",
-            b"[SLAVE] Error: Failed to power up device!", slaveMap, TRUE)
-
     #Config of all slaves together
-    status += MMWL_firmwareDownload(slavesMap)
-    check(status,
-        b"[SLAVE] Firmware successfully uploaded!",
-        b"[SLAVE] Error: Firmware upload failed!", slavesMap, TRUE)
-
     status += MMWL_setDeviceCrcType(slavesMap)
     check(status,
         b"[SLAVE] CRC type has been set!",
@@ -560,171 +876,440 @@ cdef int32_t initSlaves(rlChanCfg_t channelCfg, rlAdcOutCfg_t adcOutCfg):
         b"[SLAVE] Init completed with error", slavesMap, TRUE)
     return status
 
-cdef uint32_t configure (devConfig_t config):
+cdef void hash_config(devConfig_t* config, mmwlCfgState_t* state) nogil:
+    """@brief Hash each configuration block so it can be compared to the previous session
+    @param config Device configuration
+    @param state Configuration state to fill
+    """
+    cdef uint64_t hash = 0
+
+    memset(state, 0, sizeof(mmwlCfgState_t))
+    state.deviceMap = config.deviceMap
+
+    hash = MMWL_cfgHash(hash, &config.channelCfg, sizeof(config.channelCfg))
+    hash = MMWL_cfgHash(hash, &config.adcOutCfg, sizeof(config.adcOutCfg))
+    hash = MMWL_cfgHash(hash, &config.dataFmtCfg, sizeof(config.dataFmtCfg))
+    hash = MMWL_cfgHash(hash, &config.ldoCfg, sizeof(config.ldoCfg))
+    hash = MMWL_cfgHash(hash, &config.lpmCfg, sizeof(config.lpmCfg))
+    hash = MMWL_cfgHash(hash, &config.miscCfg, sizeof(config.miscCfg))
+    hash = MMWL_cfgHash(hash, &config.datapathCfg, sizeof(config.datapathCfg))
+    hash = MMWL_cfgHash(hash, &config.datapathClkCfg, sizeof(config.datapathClkCfg))
+    hash = MMWL_cfgHash(hash, &config.hsClkCfg, sizeof(config.hsClkCfg))
+    hash = MMWL_cfgHash(hash, &config.csi2LaneCfg, sizeof(config.csi2LaneCfg))
+    hash = MMWL_cfgHash(hash, &config.monCfg, sizeof(config.monCfg))
+    state.blockHash[MMWL_CFG_BLOCK_DEVICE] = hash
+
+    # The sub-frames select the profiles and the chirp tables downloaded
+    hash = MMWL_cfgHash(0, &config.profileCfg, sizeof(config.profileCfg))
+    hash = MMWL_cfgHash(hash, config.subProfileCfg, sizeof(config.subProfileCfg))
+    state.blockHash[MMWL_CFG_BLOCK_PROFILE] = hash
+    hash = MMWL_cfgHash(0, &config.chirpCfg, sizeof(config.chirpCfg))
+    hash = MMWL_cfgHash(hash, &config.advFrameCfg.frameSeq.numOfSubFrames,
+        sizeof(config.advFrameCfg.frameSeq.numOfSubFrames))
+    state.blockHash[MMWL_CFG_BLOCK_CHIRP] = hash
+    hash = MMWL_cfgHash(0, &config.frameCfg, sizeof(config.frameCfg))
+    hash = MMWL_cfgHash(hash, &config.advFrameCfg, sizeof(config.advFrameCfg))
+    state.blockHash[MMWL_CFG_BLOCK_FRAME] = hash
+
+
+cdef int32_t reconfigure(devConfig_t config, unsigned int changed) nogil:
+    """@brief Re-issue only the configuration blocks that changed
+    @param config Device configuration
+    @param changed Bit map of the changed blocks (1 << MMWL_CFG_BLOCK_*)
+    @return int32_t Status, non zero when a full configuration is required
+
+    @note: A profile or chirp change also re-issues the frame configuration, and a
+    profile change the RF health monitors programmed from the profile.
+    """
+    cdef int status = 0
+    cdef uint8_t numSubFrames = config.advFrameCfg.frameSeq.numOfSubFrames
+
+    status = MMWL_DeviceAttach(config.deviceMap, 1000)
+    check(status,
+        b"[ALL] Attached to the configured devices!",
+        b"[ALL] Devices not configured anymore!", config.deviceMap, FALSE)
+    if status != 0:
+        return status
+
+    if changed & (1 << MMWL_CFG_BLOCK_PROFILE):
+        if numSubFrames > 0:
+            status += MMWL_profileTableConfig(config.deviceMap, config.subProfileCfg, numSubFrames)
+        else:
+            status += MMWL_profileConfig(config.deviceMap, config.profileCfg)
+        check(status,
+            b"[ALL] Profile configuration successful!",
+            b"[ALL] Profile configuration failed!", config.deviceMap, FALSE)
+        changed |= (1 << MMWL_CFG_BLOCK_FRAME)
+
+    if status == 0 and (changed & (1 << MMWL_CFG_BLOCK_CHIRP)):
+        status += configureMimoChirp(config.deviceMap, config.chirpCfg, numSubFrames)
+        check(status,
+            b"[ALL] Chirp configuration successful!",
+            b"[ALL] Chirp configuration failed!", config.deviceMap, FALSE)
+        changed |= (1 << MMWL_CFG_BLOCK_FRAME)
+
+    if status == 0 and (changed & (1 << MMWL_CFG_BLOCK_FRAME)):
+        status += configureFrame(&config, config.masterMap)
+        status += configureFrame(&config, config.slavesMap)
+        check(status,
+            b"[ALL] Frame configuration completed!",
+            b"[ALL] Frame configuration failed!", config.deviceMap, FALSE)
+
+    if status == 0 and (changed & (1 << MMWL_CFG_BLOCK_PROFILE)) and config.monCfg.enable != 0:
+        status += MMWL_monitorConfig(config.deviceMap, config.monCfg,
+            config.channelCfg, config.profileCfg)
+        check(status,
+            b"[ALL] RF health monitors enabled!",
+            b"[ALL] RF health monitor configuration failed!", config.deviceMap, FALSE)
+    return status
+
+
+cdef uint32_t configure (devConfig_t config, char* ip_addr, uint8_t full, uint8_t recalibrate) nogil:
     cdef int status = 0
+    cdef mmwlBatch_t batch
+    cdef mmwlTxn_t txn
+    cdef int rfDevice, ldo, dataFmt, lowPower, datapath, profile
     cdef int devId = 0
+    cdef mmwlCfgState_t previous, current
+    cdef unsigned int changed = 0
+
+    hash_config(&config, &current)
+    if not full and MMWL_cfgStateLoad(ip_addr, &previous) == 0:
+        changed = MMWL_cfgStateDiff(&previous, &current)
+        if (changed & (1 << MMWL_CFG_BLOCK_DEVICE)) == 0:
+            if reconfigure(config, changed) == 0:
+                MMWL_cfgStateSave(ip_addr, &current)
+                return 0
+            if DEV_ENV:
+                printf(b"[MIMO] Incremental configuration failed, running the full sequence\n")
+
+    # The previous state is no longer valid once the devices are reset
+    MMWL_cfgStateClear(ip_addr)
+    status += bootDevices(config.masterMap, config.slavesMap)
     status += initMaster(config.channelCfg, config.adcOutCfg)
     status += initSlaves(config.channelCfg, config.adcOutCfg)
 
-    status += MMWL_RFDeviceConfig(config.deviceMap)
-    check(status,
+    # Device and static configuration (packed into as few messages as
+    # possible), queued back to back without waiting between the devices
+    MMWL_batchInit(&batch)
+    rfDevice = MMWL_batchRFDeviceConfig(&batch, config.deviceMap)
+    MMWL_txnInit(&txn, config.deviceMap)
+    ldo = MMWL_txnLdoBypass(&txn, config.ldoCfg)
+    dataFmt = MMWL_txnDataFmt(&txn, config.dataFmtCfg)
+    lowPower = MMWL_txnLowPower(&txn, config.lpmCfg)
+    MMWL_txnApllSynthBw(&txn)
+    MMWL_txnMisc(&txn, config.miscCfg)
+    MMWL_batchTxn(&batch, &txn)
+    status += MMWL_batchWait(&batch)
+    check(MMWL_batchStatus(&batch, rfDevice),
         b"[ALL] RF deivce configured!",
         b"[ALL] RF device configuration failed!", config.deviceMap, TRUE)
-
-    status += MMWL_ldoBypassConfig(config.deviceMap, config.ldoCfg)
-    check(status,
+    check(MMWL_txnStatus(&txn, ldo),
         b"[ALL] LDO Bypass configuration successful!",
         b"[ALL] LDO Bypass configuration failed!", config.deviceMap, TRUE)
-
-    status += MMWL_dataFmtConfig(config.deviceMap, config.dataFmtCfg)
-    check(status,
+    check(MMWL_txnStatus(&txn, dataFmt),
         b"[ALL] Data format configuration successful!",
         b"[ALL] Data format configuration failed!", config.deviceMap, TRUE)
-
-    status += MMWL_lowPowerConfig(config.deviceMap, config.lpmCfg)
-    check(status,
+    check(MMWL_txnStatus(&txn, lowPower),
         b"[ALL] Low Power Mode configuration successful!",
         b"[ALL] Low Power Mode configuration failed!", config.deviceMap, TRUE)
 
-    status += MMWL_ApllSynthBwConfig(config.deviceMap)
-    status += MMWL_setMiscConfig(config.deviceMap, config.miscCfg)
-    status += MMWL_rfInit(config.deviceMap)
+    status += MMWL_rfInitCached(config.deviceMap, ip_addr, not recalibrate)
     check(status,
         b"[ALL] RF successfully initialized!",
         b"[ALL] RF init failed!", config.deviceMap, TRUE)
 
-    status += MMWL_dataPathConfig(config.deviceMap, config.datapathCfg)
-    status += MMWL_hsiClockConfig(config.deviceMap, config.datapathClkCfg, config.hsClkCfg)
-    status += MMWL_CSI2LaneConfig(config.deviceMap, config.csi2LaneCfg)
-    check(status,
+    MMWL_batchInit(&batch)
+    MMWL_txnInit(&txn, config.deviceMap)
+    MMWL_txnDataPath(&txn, config.datapathCfg)
+    MMWL_txnHsiClock(&txn, config.datapathClkCfg, config.hsClkCfg)
+    MMWL_txnCSI2Lane(&txn, config.csi2LaneCfg)
+    datapath = MMWL_batchTxn(&batch, &txn)
+    if config.advFrameCfg.frameSeq.numOfSubFrames > 0:
+        # One profile per sub-frame
+        profile = MMWL_batchProfileTable(&batch, config.deviceMap, config.subProfileCfg,
+            config.advFrameCfg.frameSeq.numOfSubFrames)
+    else:
+        profile = MMWL_batchProfileConfig(&batch, config.deviceMap, config.profileCfg)
+    status += MMWL_batchWait(&batch)
+    check(MMWL_batchStatus(&batch, datapath),
         b"[ALL] Datapath configuration successful!",
         b"[ALL] Datapath configuration failed!", config.deviceMap, TRUE)
-
-    status += MMWL_profileConfig(config.deviceMap, config.profileCfg)
-    check(status,
+    check(MMWL_batchStatus(&batch, profile),
         b"[ALL] Profile configuration successful!",
         b"[ALL] Profile configuration failed!", config.deviceMap, TRUE)
 
     # MIMO Chirp configuration
-    for devId in range(4):
-        status += configureMimoChirp(devId, config.chirpCfg)
+    status += configureMimoChirp(config.deviceMap, config.chirpCfg,
+        config.advFrameCfg.frameSeq.numOfSubFrames)
 
     check(status,
         b"[ALL] Chirp configuration successful!",
         b"[ALL] Chirp configuration failed!", config.deviceMap, TRUE)
 
     #Master frame config.
-    status += MMWL_frameConfig(
-        config.masterMap,
-        config.frameCfg,
-        config.channelCfg,
-        config.adcOutCfg,
-        config.datapathCfg,
-        config.profileCfg
-    )
+    status += configureFrame(&config, config.masterMap)
     check(status,
         b"[MASTER] Frame configuration completed!",
         b"[MASTER] Frame configuration failed!", config.masterMap, TRUE)
 
     #Slaves frame config
-    status += MMWL_frameConfig(
-        config.slavesMap,
-        config.frameCfg,
-        config.channelCfg,
-        config.adcOutCfg,  
-        config.datapathCfg,
-        config.profileCfg
-    )
+    status += configureFrame(&config, config.slavesMap)
     check(status,
         b"[SLAVE] Frame configuration completed!",
         b"[SLAVE] Frame configuration failed!", config.slavesMap, TRUE)
 
+    # RF health monitors, reported asynchronously while framing
+    if config.monCfg.enable != 0:
+        status += MMWL_monitorConfig(config.deviceMap, config.monCfg,
+            config.channelCfg, config.profileCfg)
+        check(status,
+            b"[ALL] RF health monitors enabled!",
+            b"[ALL] RF health monitor configuration failed!", config.deviceMap, TRUE)
+
+    MMWL_cfgStateSave(ip_addr, &current)
     return status
 
+cdef void read_profile(dict profile, rlProfileCfg_t* profileCfg):
+    """@brief Read a [PROFILE CONFIGURATION] table
+    @param profile Profile table
+    @param profileCfg Profile configuration to update
+    """
+    if "id" in profile:
+        profileCfg.profileId = <uint16_t>(profile["id"])
+    if "startFrequency" in profile: # Chirp start frequency in GHz
+        profileCfg.startFreqConst = <uint32_t>(ceil(profile["startFrequency"]*1e9/53.644)) # 1LSB = 53.644 Hz
+    if "frequencySlope" in profile: # Frequency slope in MHz/us
+        profileCfg.freqSlopeConst = <int16_t>(ceil(profile["frequencySlope"]*1e3/48.279)) # 1LSB = 48.279 kHz/us
+    if "idleTime" in profile:# Chrip Idle time in us
+        profileCfg.idleTimeConst = <uint32_t>(ceil(profile["idleTime"]*1e2)) # 1LSB = 10ns
+    if "adcStartTime" in profile:# ADC start time in us
+        profileCfg.adcStartTimeConst = <uint32_t>(ceil(profile["adcStartTime"]*1e2)) # 1LSB = 10ns
+    if "rampEndTime" in profile:# Chirp ramp end time in us
+        profileCfg.rampEndTime = <uint32_t>(ceil(profile["rampEndTime"]*1e2)) # 1LSB = 10ns
+    if "txStartTIme" in profile:# TX starttime in us
+        profileCfg.txStartTime = <uint16_t>(ceil(profile["txStartTIme"]*1e2)) # 1LSB = 10ns
+    if "numAdcSamples" in profile:# Number of ADC samples per chirp
+        profileCfg.numAdcSamples = <uint16_t>(profile["numAdcSamples"])
+    if "adcSamplingFrequency" in profile:# ADC sampling frequency in ksps
+        profileCfg.digOutSampleRate = <uint16_t>(profile["adcSamplingFrequency"])
+    if "rxGain" in profile:# rxGain in dB
+        profileCfg.rxGain = <uint16_t>(profile["rxGain"])
+    if "hpfCornerFreq1" in profile: # hpfCornerFreq1
+        profileCfg.hpfCornerFreq1 = <uint8_t>(profile["hpfCornerFreq1"])
+    if "hpfCornerFreq2" in profile: # hpfCornerFreq2
+        profileCfg.hpfCornerFreq2 = <uint8_t>(profile["hpfCornerFreq2"])
+
+cdef void read_subframes(list subframes, devConfig_t* config):
+    """@brief Read the sub-frames of an advanced frame ([[mimo.subframe]])
+    Sub-frame n is a single burst of the MIMO chirps from index n * NUM_CHIRPS,
+    with profile n: [mimo.profile] updated with the keys of its own profile table.
+    @param subframes Sub-frame tables
+    @param config Device configuration
+    """
+    cdef rlSubFrameCfg_t* sf
+    cdef uint32_t gap = 450 * 200 # Blank time left at the end of each sub-frame, 1LSB = 5ns
+    cdef uint32_t period = 0
+    cdef uint8_t i
+    cdef uint8_t count = <uint8_t>(min(len(subframes), 4))
+
+    memset(&config.advFrameCfg, 0, sizeof(config.advFrameCfg))
+    memset(config.subProfileCfg, 0, sizeof(config.subProfileCfg))
+    for i in range(count):
+        subframe = subframes[i]
+        sf = &config.advFrameCfg.frameSeq.subFrameCfg[i]
+        config.subProfileCfg[i] = config.profileCfg
+        if "profile" in subframe:
+            read_profile(subframe["profile"], &config.subProfileCfg[i])
+        config.subProfileCfg[i].profileId = i
+        sf.numLoops = <uint16_t>(subframe.get("numLoops", config.frameCfg.numLoops))
+        if "periodicity" in subframe: # Sub-frame periodicity in ms
+            sf.subFramePeriodicity = <uint32_t>(ceil(subframe["periodicity"]*2e5)) # 1LSB = 5ns
+        sf.forceProfileIdx = i
+        sf.chirpStartIdx = i * NUM_CHIRPS
+        sf.numOfChirps = NUM_CHIRPS
+        sf.numOfBurst = 1
+        sf.numOfBurstLoops = 1
+        sf.burstPeriodicity = sf.subFramePeriodicity - gap if sf.subFramePeriodicity > gap else 0
+        period += sf.subFramePeriodicity
+        config.advFrameCfg.frameData.subframeDataCfg[i].totalChirps = NUM_CHIRPS * sf.numLoops
+        config.advFrameCfg.frameData.subframeDataCfg[i].numAdcSamples = 2 * config.subProfileCfg[i].numAdcSamples
+        config.advFrameCfg.frameData.subframeDataCfg[i].numChirpsInDataPacket = 1
+
+    config.advFrameCfg.frameSeq.numOfSubFrames = count
+    config.advFrameCfg.frameSeq.forceProfile = 1
+    config.advFrameCfg.frameSeq.numFrames = config.frameCfg.numFrames
+    config.advFrameCfg.frameData.numSubFrames = count
+    # The TDA and the monitors see a frame of all the sub-frames
+    if count > 0:
+        config.frameCfg.framePeriodicity = period
+
 cdef devConfig_t config
 
-cpdef mmw_set_config(dict configdict):
-    global config
-    config.deviceMap = 1|(1<<1)|(1<<2)|(1<<3)
-    MMWL_AssignDeviceMap(config.deviceMap, &config.masterMap, &config.slavesMap)
-    config.frameCfg = frameCfgArgs
-    config.profileCfg = profileCfgArgs
-    config.chirpCfg = chirpCfgArgs
-    config.channelCfg = channelCfgArgs
-    config.csi2LaneCfg = csi2LaneCfgArgs
-    config.datapathCfg = datapathCfgArgs
-    config.datapathClkCfg=datapathClkCfgArgs
-    config.hsClkCfg = hsClkCfgArgs
-    config.ldoCfg = ldoCfgArgs
-    config.lpmCfg = lpmCfgArgs
-    config.miscCfg = miscCfgArgs
-
-    cdef dict mimo,profile,frame,channel
+cdef int parse_config(dict configdict, devConfig_t* cfg) except -1:
+    """@brief Device configuration from the defaults updated with a config dictionary
+    @param configdict Same sections as the TOML config file ({} for the defaults)
+    @param cfg Device configuration to fill
+    """
+    cfg.deviceMap = 1|(1<<1)|(1<<2)|(1<<3)
+    MMWL_AssignDeviceMap(cfg.deviceMap, &cfg.masterMap, &cfg.slavesMap)
+    cfg.frameCfg = frameCfgArgs
+    cfg.profileCfg = profileCfgArgs
+    cfg.chirpCfg = chirpCfgArgs
+    cfg.channelCfg = channelCfgArgs
+    cfg.csi2LaneCfg = csi2LaneCfgArgs
+    cfg.datapathCfg = datapathCfgArgs
+    cfg.datapathClkCfg=datapathClkCfgArgs
+    cfg.hsClkCfg = hsClkCfgArgs
+    cfg.ldoCfg = ldoCfgArgs
+    cfg.lpmCfg = lpmCfgArgs
+    cfg.miscCfg = miscCfgArgs
+    cfg.monCfg = monCfgArgs
+    memset(&cfg.advFrameCfg, 0, sizeof(cfg.advFrameCfg))
+    memset(cfg.subProfileCfg, 0, sizeof(cfg.subProfileCfg))
+
+    cdef dict mimo,profile,frame,channel,monitor
     if "mimo" in configdict:
         mimo = configdict["mimo"]
         if "profile" in mimo: # [PROFILE CONFIGURATION]
-            profile = mimo["profile"]
-            if "id" in profile:
-                config.profileCfg.profileId = <uint16_t>(profile["id"])
-            if "startFrequency" in profile: # Chirp start frequency in GHz
-                config.profileCfg.startFreqConst = <uint32_t>(ceil(profile["startFrequency"]*1e9/53.644)) # 1LSB = 53.644 Hz
-            if "frequencySlope" in profile: # Frequency slope in MHz/us
-                config.profileCfg.freqSlopeConst = <int16_t>(ceil(profile["frequencySlope"]*1e3/48.279)) # 1LSB = 48.279 kHz/us
-            if "idleTime" in profile:# Chrip Idle time in us
-                config.profileCfg.idleTimeConst = <uint32_t>(ceil(profile["idleTime"]*1e2)) # 1LSB = 10ns
-            if "adcStartTime" in profile:# ADC start time in us
-                config.profileCfg.adcStartTimeConst = <uint32_t>(ceil(profile["adcStartTime"]*1e2)) # 1LSB = 10ns
-            if "rampEndTime" in profile:# Chirp ramp end time in us
-                config.profileCfg.rampEndTime = <uint32_t>(ceil(profile["rampEndTime"]*1e2)) # 1LSB = 10ns
-            if "txStartTIme" in profile:# TX starttime in us
-                config.profileCfg.txStartTime = <uint16_t>(ceil(profile["txStartTIme"]*1e2)) # 1LSB = 10ns
-            if "numAdcSamples" in profile:# Number of ADC samples per chirp
-                config.profileCfg.numAdcSamples = <uint16_t>(profile["numAdcSamples"])
-            if "adcSamplingFrequency" in profile:# ADC sampling frequency in ksps
-                config.profileCfg.digOutSampleRate = <uint16_t>(profile["adcSamplingFrequency"])
-            if "rxGain" in profile:# rxGain in dB
-                config.profileCfg.rxGain = <uint16_t>(profile["rxGain"])
-            if "hpfCornerFreq1" in profile: # hpfCornerFreq1
-                config.profileCfg.hpfCornerFreq1 = <uint8_t>(profile["hpfCornerFreq1"])
-            if "hpfCornerFreq2" in profile: # hpfCornerFreq2
-                config.profileCfg.hpfCornerFreq2 = <uint8_t>(profile["hpfCornerFreq2"])
-            
+            read_profile(mimo["profile"], &cfg.profileCfg)
         if "frame" in mimo: # [FRAME CONFIGURATION]
             frame = mimo["frame"]
             if "numFrames" in frame: # Number of frames to record
-                config.frameCfg.numFrames = <uint16_t>(frame["numFrames"])
+                cfg.frameCfg.numFrames = <uint16_t>(frame["numFrames"])
             if "numLoops" in frame: # Number of chirp loop per frame
-                config.frameCfg.numLoops = <uint16_t>(frame["numLoops"])
+                cfg.frameCfg.numLoops = <uint16_t>(frame["numLoops"])
             if "framePeriodicity" in frame: # Frame periodicity in ms
-                config.frameCfg.framePeriodicity = <uint32_t>(ceil(frame["framePeriodicity"]*2e5)) # 1LSB = 5ns
+                cfg.frameCfg.framePeriodicity = <uint32_t>(ceil(frame["framePeriodicity"]*2e5)) # 1LSB = 5ns
         if "channel" in mimo:# [CHANNEL CONFIGURATION]
             channel = mimo["channel"]
             if "rxChannelEn" in channel: # RX Channel configuration
-                config.channelCfg.rxChannelEn = <uint16_t>(channel["rxChannelEn"])
+                cfg.channelCfg.rxChannelEn = <uint16_t>(channel["rxChannelEn"])
             if "txChannelEn" in channel: # TX Channel configuration
-                config.channelCfg.txChannelEn = <uint16_t>(channel["txChannelEn"])
-        config.frameCfg.numAdcSamples = 2 * config.profileCfg.numAdcSamples
-        config.dataFmtCfg.rxChannelEn = config.channelCfg.rxChannelEn
+                cfg.channelCfg.txChannelEn = <uint16_t>(channel["txChannelEn"])
+        if "subframe" in mimo: # [ADVANCED FRAME] sub-frames cycled by the devices in each frame
+            read_subframes(mimo["subframe"], cfg)
+        if "monitor" in mimo: # [RF HEALTH MONITORING]
+            monitor = mimo["monitor"]
+            if "enable" in monitor: # Monitors: "temp", "rx-gain", "tx-power", "synth" or "all"
+                cfg.monCfg.enable = 0
+                for name in monitor["enable"]:
+                    if MMWL_monitorByName(name.encode('utf-8')) == 0:
+                        raise ValueError(f"unknown RF health monitor '{name}'")
+                    cfg.monCfg.enable |= MMWL_monitorByName(name.encode('utf-8'))
+            if "reportMode" in monitor:
+                cfg.monCfg.reportMode = <uint8_t>(monitor["reportMode"])
+            if "period" in monitor and cfg.frameCfg.framePeriodicity != 0: # Period in ms
+                cfg.monCfg.period = <uint16_t>(ceil(monitor["period"]*1e-3/(cfg.frameCfg.framePeriodicity*5e-9))) # In frames
+            if "tempMin" in monitor: # Temperature range and spread in C
+                cfg.monCfg.tempMin = <int16_t>(monitor["tempMin"])
+            if "tempMax" in monitor:
+                cfg.monCfg.tempMax = <int16_t>(monitor["tempMax"])
+            if "tempDiff" in monitor:
+                cfg.monCfg.tempDiff = <uint16_t>(monitor["tempDiff"])
+            if "rxGainErr" in monitor: # Maximum RX gain error in dB
+                cfg.monCfg.rxGainErr = <uint16_t>(ceil(monitor["rxGainErr"]*10)) # 1LSB = 0.1dB
+            if "txPowerErr" in monitor: # Maximum TX power error in dB
+                cfg.monCfg.txPowerErr = <uint16_t>(ceil(monitor["txPowerErr"]*10)) # 1LSB = 0.1dB
+            if "synthFreqErr" in monitor: # Maximum synthesizer frequency error in MHz
+                cfg.monCfg.synthFreqErr = <uint16_t>(ceil(monitor["synthFreqErr"]*100)) # 1LSB = 10kHz
+        cfg.frameCfg.numAdcSamples = 2 * cfg.profileCfg.numAdcSamples
+        cfg.dataFmtCfg.rxChannelEn = cfg.channelCfg.rxChannelEn
         
-    config.dataFmtCfg.rxChannelEn = channelCfgArgs.rxChannelEn
-    config.dataFmtCfg.adcBits = adcOutCfgArgs.fmt.b2AdcBits
-    config.dataFmtCfg.adcFmt = adcOutCfgArgs.fmt.b2AdcOutFmt
+    cfg.dataFmtCfg.rxChannelEn = channelCfgArgs.rxChannelEn
+    cfg.dataFmtCfg.adcBits = adcOutCfgArgs.fmt.b2AdcBits
+    cfg.dataFmtCfg.adcFmt = adcOutCfgArgs.fmt.b2AdcOutFmt
+    return 0
+
+
+cdef class MmwConfig:
+    """@brief Configuration parsed once, passed to mmw_set_config as a typed struct
+    * Switching between prepared configurations then only copies the struct.
+    * @configdict Same sections as the TOML config file ({} for the defaults)
+    """
+    cdef devConfig_t cfg
+
+    def __init__(self, dict configdict=None):
+        parse_config(configdict if configdict is not None else {}, &self.cfg)
+
+    @property
+    def num_frames(self):
+        """Number of frames to record (0: until mmw_stop_frame)"""
+        return self.cfg.frameCfg.numFrames
+
+    @num_frames.setter
+    def num_frames(self, uint16_t value):
+        self.cfg.frameCfg.numFrames = value
+        self.cfg.advFrameCfg.frameSeq.numFrames = value
+
+    @property
+    def frame_periodicity(self):
+        """Frame periodicity in ms (sum of the sub-frames of an advanced frame)"""
+        return self.cfg.frameCfg.framePeriodicity * 5e-6
+
+    @property
+    def num_adc_samples(self):
+        """ADC samples per chirp"""
+        return self.cfg.profileCfg.numAdcSamples
+
+    @property
+    def num_sub_frames(self):
+        """Sub-frames of an advanced frame (0: legacy frame)"""
+        return self.cfg.advFrameCfg.frameSeq.numOfSubFrames
+
+cpdef mmw_set_config(object configdict):
+    """@brief Set the configuration used by mmw_init and the exports
+    * @configdict Config dictionary, parsed on each call, or a MmwConfig
+    * @return int
+    """
+    global config
+    if isinstance(configdict, MmwConfig):
+        config = (<MmwConfig>configdict).cfg
+    else:
+        parse_config(configdict, &config)
     return 0
 
 cpdef int mmw_init(
     str ip_addr="192.168.33.180",
     int port = 5001,
+    int irq_mode = 1,
+    int full = 0,
+    int recalibrate = 0,
     ):
+    """@brief Connect to the TDA board and configure the radar devices
+    * @ip_addr IP Address of the MMWCAS DSP evaluation module
+    * @port Port number the DSP board server app is listening on
+    * @irq_mode Host IRQ dispatch mode (0: 1 ms polling, 1: event driven)
+    * @full Force the full configuration instead of re-issuing the changed blocks only
+    * @recalibrate Run the full RF calibration instead of restoring the cached calibration data
+    * @return int
+    """
     cdef int status = 0
     cdef bytes ip_addr_bytes = ip_addr.encode('utf-8')
-    status = MMWL_TDAInit(ip_addr_bytes,port,config.deviceMap)
-    check(status,
-        b"[MMWCAS-DSP] TDA Connected!",
-        b"[MMWCAS-DSP] Couldn't connect to TDA board!", 32, TRUE)
+    cdef char* ip = ip_addr_bytes
+    with nogil:
+        status = MMWL_TDAInit(<unsigned char*>ip,port,config.deviceMap,irq_mode)
+        check(status,
+            b"[MMWCAS-DSP] TDA Connected!",
+            b"[MMWCAS-DSP] Couldn't connect to TDA board!", 32, TRUE)
 
-    configure(config) 
+        configure(config, ip, full, recalibrate)
     return status
 
+cdef uint32_t tda_frame_period(devConfig_t* cfg) nogil:
+    """@brief Frame period the TDA is armed with
+    @param cfg Device configuration
+    @return Frame period in ms, sum of the sub-frame periods with advanced frames
+    """
+    cdef uint64_t period = 0
+    cdef uint8_t i
+    if cfg.advFrameCfg.frameSeq.numOfSubFrames > 0:
+        for i in range(cfg.advFrameCfg.frameSeq.numOfSubFrames):
+            period += <uint64_t>cfg.advFrameCfg.frameSeq.subFrameCfg[i].subFramePeriodicity * 5 # 1LSB = 5ns
+    else:
+        period = <uint64_t>cfg.frameCfg.framePeriodicity * 5
+    return <uint32_t>(period // (1000 * 1000))
+
 cpdef int mmw_arming_tda(str capture_path):
     """@brief Prepare the TDA board and notify TDA about the start of recording
     * @capture_path capture path setup to arm the TDA for recording 
@@ -734,37 +1319,370 @@ cpdef int mmw_arming_tda(str capture_path):
     cdef bytes capture_path_bytes = f"/mnt/ssd/{capture_path}".encode('utf-8')
     cdef rlTdaArmCfg_t tdaCfg = rlTdaArmCfg_t(
         captureDirectory = capture_path_bytes,
-        framePeriodicity = (frameCfgArgs.framePeriodicity * 5)//(1000 * 1000),
+        framePeriodicity = tda_frame_period(&config),
         numberOfFilesToAllocate = 0,
         numberOfFramesToCapture = 0, # config.frameCfg.numFrames,
         dataPacking = 0, # 0: 16-bit | 1: 12-bit
     )
-    status = MMWL_ArmingTDA(tdaCfg)
-    check(status,
-        b"[MMWCAS-DSP] Arming TDA",
-        b"[MMWCAS-DSP] TDA Arming failed!", 32, TRUE)
+    with nogil:
+        status = MMWL_ArmingTDA(tdaCfg)
+        check(status,
+            b"[MMWCAS-DSP] Arming TDA",
+            b"[MMWCAS-DSP] TDA Arming failed!", 32, TRUE)
     return status
 
+cdef mmwlHealthSnapshot_t health
+
 cpdef int mmw_start_frame():
     cdef int status = 0
-    status += MMWL_StartFrame(config.deviceMap)
-    check(status,
-        b"[MMWCAS-RF] Framing ...",
-        b"[MMWCAS-RF] Failed to initiate framing!", config.deviceMap, TRUE)
+    # The health of the capture starts with its first frame
+    MMWL_healthReset(&health)
+    with nogil:
+        status += MMWL_StartFrameSync(config.deviceMap, NULL)
+        check(status,
+            b"[MMWCAS-RF] Framing ...",
+            b"[MMWCAS-RF] Failed to initiate framing!", config.deviceMap, TRUE)
     return status
 
 cpdef int mmw_stop_frame():
     cdef int status = 0
-    status += MMWL_StopFrame(config.deviceMap)
-    check(status,
-        b"[MMWCAS-RF] Stoped Frame ...",
-        b"[MMWCAS-RF] Failed to stoped frame!", config.deviceMap, TRUE)
+    with nogil:
+        status += MMWL_StopFrameSync(config.deviceMap, NULL)
+        check(status,
+            b"[MMWCAS-RF] Stoped Frame ...",
+            b"[MMWCAS-RF] Failed to stoped frame!", config.deviceMap, TRUE)
+    MMWL_healthCollect(&health)
     return status
 
 cpdef int mmw_dearming_tda():
     cdef int status = 0
-    status = MMWL_DeArmingTDA()
+    with nogil:
+        status = MMWL_DeArmingTDA()
+        check(status,
+            b"[MMWCAS-RF] Stop recording",
+            b"[MMWCAS-RF] Failed to de-arm TDA board!", 32, TRUE)
+    return status
+
+cpdef int mmw_export_json(str filename, int num_devices=4):
+    """@brief Export the configuration in the mmWave Studio format (.mmwave.json)
+    * Same document as the one written by the CLI next to each capture.
+    * @filename Output JSON filename
+    * @num_devices Number of cascade devices (1-4)
+    * @return int
+    """
+    cdef jsonDevConfig_t json_config
+    cdef bytes filename_bytes = filename.encode('utf-8')
+    cdef char* path = filename_bytes
+    cdef int status = 0
+    # Zeroed first: the serializer compares configurations with memcmp
+    memset(&json_config, 0, sizeof(json_config))
+    json_config.profileCfg = config.profileCfg
+    json_config.frameCfg = config.frameCfg
+    json_config.channelCfg = config.channelCfg
+    json_config.adcOutCfg = config.adcOutCfg
+    json_config.lpmCfg = config.lpmCfg
+    json_config.miscCfg = config.miscCfg
+    json_config.ldoCfg = config.ldoCfg
+    json_config.dataFmtCfg = config.dataFmtCfg
+    json_config.datapathCfg = config.datapathCfg
+    json_config.datapathClkCfg = config.datapathClkCfg
+    json_config.csi2LaneCfg = config.csi2LaneCfg
+    json_config.advFrameCfg = config.advFrameCfg
+    memcpy(json_config.subProfileCfg, config.subProfileCfg, sizeof(json_config.subProfileCfg))
+    with nogil:
+        status = json_export_config(path, &json_config, num_devices)
     check(status,
-        b"[MMWCAS-RF] Stop recording",
-        b"[MMWCAS-RF] Failed to de-arm TDA board!", 32, TRUE)
-    return status
\ No newline at end of file
+        b"[MMWCAS] Configuration exported",
+        b"[MMWCAS] Failed to export the configuration!", 32, FALSE)
+    return status
+
+cpdef int mmw_export_health(str filename, int num_devices=4):
+    """@brief Export the RF health of the last capture (.health.json)
+    * Same document as the one written by the CLI next to each capture, from
+    * the monitoring reports received since mmw_start_frame.
+    * @filename Output JSON filename
+    * @num_devices Number of cascade devices (1-4)
+    * @return int
+    """
+    cdef bytes filename_bytes = filename.encode('utf-8')
+    cdef int status = 0
+    cdef char* path = filename_bytes
+    MMWL_healthCollect(&health)
+    with nogil:
+        status = json_export_health(path, &health, num_devices)
+    check(status,
+        b"[MMWCAS] RF health exported",
+        b"[MMWCAS] Failed to export the RF health!", 32, FALSE)
+    return status
+
+cpdef int mmw_profile(bint enable=True):
+    """@brief Record the duration of the configuration stages, API calls,
+    * commands and SPI transfers (see mmw_export_profile)
+    * @enable Start or stop the recording
+    * @return int
+    """
+    global profile_stage
+    TDAProfEnable(enable)
+    if enable:
+        profile_stage = TDAProfNow()
+    return 0
+
+cpdef int mmw_export_profile(str filename):
+    """@brief Write the recorded spans and latency histograms as a Chrome trace
+    * Same document as the one written by the CLI with --profile.
+    * @filename Output JSON filename
+    * @return int
+    """
+    cdef bytes filename_bytes = filename.encode('utf-8')
+    cdef char* path = filename_bytes
+    cdef int status
+    with nogil:
+        status = json_export_profile(path)
+    check(status,
+        b"[MMWCAS] Profile exported",
+        b"[MMWCAS] Failed to export the profile!", 32, FALSE)
+    return status
+
+cdef mmwlStream_t stream
+cdef mmwlStreamReader_t reader
+cdef uint8_t stream_opened = 0
+
+cpdef int mmw_stream_open(str ip_addr="192.168.33.180", int port=5002, int slots=64):
+    """@brief Receive the frames streamed live by the DSP board
+    * Must be called once the frame is configured (mmw_init).
+    * @ip_addr IP Address of the MMWCAS DSP evaluation module
+    * @port Port number of the data socket of the DSP board
+    * @slots Number of frames kept in the ring
+    * @return int
+    """
+    global stream_opened
+    cdef int status = 0
+    cdef bytes ip_addr_bytes = ip_addr.encode('utf-8')
+    cdef char* ip = ip_addr_bytes
+    if stream_opened:
+        return status
+    with nogil:
+        status = MMWL_streamOpen(&stream, ip, port,
+            MMWL_getFrameSize(config.deviceMap), slots)
+    check(status,
+        b"[MMWCAS-DSP] Live stream opened",
+        b"[MMWCAS-DSP] Couldn't open the live stream!", 32, FALSE)
+    if status == RL_RET_CODE_OK:
+        MMWL_streamReaderInit(&stream, &reader)
+        stream_opened = 1
+    return status
+
+cpdef object mmw_stream_read(int timeout_ms=1000):
+    """@brief Next frame of the live stream
+    * The frame is copied out of the ring; a frame overwritten while being
+    * copied is skipped.
+    * @timeout_ms Maximum wait for a new frame
+    * @return tuple (sequence, timestamp in ns, raw ADC data) or None on timeout
+    """
+    cdef const mmwlStreamSlot_t* slot
+    cdef uint32_t sequence
+    cdef uint64_t timestamp
+    cdef bytes data
+    if not stream_opened:
+        return None
+    while True:
+        with nogil:
+            slot = MMWL_streamNext(&reader, timeout_ms)
+        if slot == NULL:
+            return None
+        sequence = slot.sequence
+        timestamp = slot.timestamp
+        data = (<char*>slot.data)[:slot.length]
+        if MMWL_streamRelease(&reader) == 0:
+            return (sequence, timestamp, data)
+
+cpdef dict mmw_stream_stats():
+    """@brief Statistics of the live stream
+    * @return dict
+    """
+    if not stream_opened:
+        return {}
+    return {
+        "frames": stream.stats.frames,
+        "bytes": stream.stats.bytes,
+        "oversized": stream.stats.oversized,
+        "lost": stream.stats.lost,
+        "missed": reader.missed,
+        "connections": stream.stats.connections,
+        "connected": stream.connected,
+        "hugePages": stream.hugePages,
+    }
+
+cpdef int mmw_stream_close():
+    global stream_opened
+    if stream_opened:
+        MMWL_streamClose(&stream)
+        stream_opened = 0
+    return 0
+
+cdef dspLayout_t cube_layout
+cdef uint8_t cube_layout_ready = 0
+cdef dspRdPlan_t rd_plan
+
+cpdef tuple mmw_cube_layout(str json_path, int data_packing=0):
+    """@brief Load the layout of the raw frames from a recorded configuration
+    * @json_path Configuration exported next to the capture (<capture>.mmwave.json)
+    * @data_packing TDA data packing of the capture (0: 16-bit | 1: 12-bit)
+    * @return tuple Shape of the cube of a frame: (loops, tx, rx, samples, 2)
+    """
+    global cube_layout_ready
+    import json
+    dsp_rd_plan_free(&rd_plan)
+    cdef int devId, start, end, idx
+    with open(json_path) as f:
+        cfg = json.load(f)
+    memset(&cube_layout, 0, sizeof(dspLayout_t))
+    cube_layout_ready = 0
+    for dev in cfg["mmWaveDevices"]:
+        devId = dev["mmWaveDeviceId"]
+        rf = dev["rfConfig"]
+        frame = rf["rlFrameCfg_t"]
+        start = frame["chirpStartIdx"]
+        end = frame["chirpEndIdx"]
+        if devId >= DSP_MAX_DEVICES or end < start or end - start >= DSP_MAX_CHIRPS:
+            raise ValueError(f"{json_path}: unsupported device {devId} or chirps {start}..{end}")
+        cube_layout.deviceMap |= 1 << devId
+        cube_layout.rxChannelEn = int(rf["rlChanCfg_t"]["rxChannelEn"], 16)
+        cube_layout.complex = 1 if rf["rlAdcOutCfg_t"]["fmt"]["b2AdcOutFmt"] in (1, 2) else 0
+        cube_layout.numSamples = rf["rlProfiles"][0]["rlProfileCfg_t"]["numAdcSamples"]
+        cube_layout.numLoops = frame["numLoops"]
+        cube_layout.numChirps = end - start + 1
+        for chirp in rf["rlChirps"]:
+            c = chirp["rlChirpCfg_t"]
+            for idx in range(max(c["chirpStartIdx"], start), min(c["chirpEndIdx"], end) + 1):
+                cube_layout.chirpTx[devId][idx - start] = int(c["txEnable"], 16)
+        data_fmt = dev["rawDataCaptureConfig"]["rlDevDataFmtCfg_t"]
+        cube_layout.iqSwap = data_fmt["iqSwapSel"]
+        cube_layout.chInterleave = data_fmt["chInterleave"]
+    cube_layout.packed12 = data_packing
+    if dsp_layout_init(&cube_layout) != 0:
+        raise ValueError(f"{json_path}: not a TDM MIMO frame configuration")
+    cube_layout_ready = 1
+    return (cube_layout.numLoops, cube_layout.numTx,
+        cube_layout.numDevices * cube_layout.numRx, cube_layout.numSamples, 2)
+
+cpdef bytearray mmw_cube_reorder(list raw, int threads=0):
+    """@brief Reorder raw frames into MIMO virtual array cubes
+    * Uses the layout loaded with mmw_cube_layout.
+    * @raw Raw frames of each device of the device map, in device order
+    *      (bytes-like objects, e.g. the content of <device>_0000_data.bin)
+    * @threads Number of threads (0: one per CPU)
+    * @return bytearray float32 cubes, of shape (frames, loops, tx, rx, samples, 2)
+    """
+    cdef const uint8_t* ptrs[4]
+    cdef const uint8_t[::1] view
+    cdef unsigned char[::1] out
+    cdef uint32_t num_frames = 0xFFFFFFFF
+    cdef int devId, k = 0, status
+    cdef bytearray cube
+    if not cube_layout_ready:
+        raise RuntimeError("no layout loaded, call mmw_cube_layout first")
+    if len(raw) != cube_layout.numDevices:
+        raise ValueError(f"expected the raw frames of {cube_layout.numDevices} devices")
+    for devId in range(DSP_MAX_DEVICES):
+        ptrs[devId] = NULL
+        if cube_layout.deviceMap & (1 << devId):
+            view = raw[k]
+            k += 1
+            num_frames = min(num_frames, view.shape[0] // cube_layout.frameBytes)
+            ptrs[devId] = &view[0] if view.shape[0] > 0 else NULL
+    if num_frames == 0:
+        return bytearray()
+    cube = bytearray(num_frames * cube_layout.cubeSize * sizeof(float))
+    out = cube
+    with nogil:
+        status = dsp_cube_frames(&cube_layout, ptrs, cube_layout.frameBytes, num_frames,
+            <float*>&out[0], threads)
+    if status != 0:
+        raise RuntimeError("ADC reorder failed")
+    return cube
+
+cpdef tuple mmw_rd_plan(int db=1):
+    """@brief Prepare the range/Doppler processing of the cubes
+    * Uses the layout loaded with mmw_cube_layout. The FFT sizes are the next
+    * powers of two of the number of samples and of loops.
+    * @db 1: heatmaps in dB | 0: linear power
+    * @return tuple Shape of the heatmap of a frame: (doppler, range)
+    """
+    if not cube_layout_ready:
+        raise RuntimeError("no layout loaded, call mmw_cube_layout first")
+    dsp_rd_plan_free(&rd_plan)
+    if dsp_rd_plan_init(&rd_plan, &cube_layout, DSP_RD_DB if db else DSP_RD_LINEAR) != 0:
+        raise ValueError("FFT sizes not supported")
+    return (rd_plan.dopplerFft, rd_plan.numRange)
+
+cpdef bytearray mmw_rd_process(object cubes, int threads=0):
+    """@brief Range-Doppler heatmaps of MIMO virtual array cubes
+    * The power of all the virtual channels is summed, the zero velocity bin is
+    * in the middle of the Doppler axis.
+    * @cubes Cubes returned by mmw_cube_reorder
+    * @threads Number of threads (0: one per CPU)
+    * @return bytearray float32 heatmaps, of shape (frames, doppler, range)
+    """
+    cdef const unsigned char[::1] view = cubes
+    cdef unsigned char[::1] out
+    cdef uint32_t num_frames
+    cdef int status
+    cdef bytearray maps
+    if rd_plan.rangeTwiddles == NULL:
+        raise RuntimeError("no plan, call mmw_rd_plan first")
+    num_frames = view.shape[0] // (cube_layout.cubeSize * sizeof(float))
+    if num_frames == 0:
+        return bytearray()
+    maps = bytearray(num_frames * rd_plan.mapSize * sizeof(float))
+    out = maps
+    with nogil:
+        status = dsp_rd_frames(&rd_plan, <const float*>&view[0], num_frames, <float*>&out[0], threads)
+    if status != 0:
+        raise RuntimeError("range/Doppler processing failed")
+    return maps
+
+# asyncio interface. The hardware calls run one at a time on a dedicated
+# thread, without the GIL: their futures complete once the devices and the
+# TDA have acknowledged (async events and TDA ACKs waited by the driver), and
+# the event loop keeps running the transfers and the processing meanwhile.
+import asyncio
+from concurrent.futures import ThreadPoolExecutor
+
+hw_executor = None
+
+def hw_submit(func, *args):
+    """@brief Run a hardware call on the hardware thread
+    * @func Blocking mmw_* function
+    * @return asyncio.Future Result of the call
+    """
+    global hw_executor
+    if hw_executor is None:
+        hw_executor = ThreadPoolExecutor(max_workers=1, thread_name_prefix="mmwcas")
+    return asyncio.get_running_loop().run_in_executor(hw_executor, func, *args)
+
+async def mmw_init_async(ip_addr="192.168.33.180", port=5001, irq_mode=1, full=0, recalibrate=0):
+    """@brief mmw_init, completed when the devices are configured"""
+    return await hw_submit(mmw_init, ip_addr, port, irq_mode, full, recalibrate)
+
+async def mmw_arming_tda_async(capture_path):
+    """@brief mmw_arming_tda, completed on the TDA ACKs"""
+    return await hw_submit(mmw_arming_tda, capture_path)
+
+async def mmw_start_frame_async():
+    """@brief mmw_start_frame, completed on the frame start events"""
+    return await hw_submit(mmw_start_frame)
+
+async def mmw_stop_frame_async():
+    """@brief mmw_stop_frame, completed on the frame end events"""
+    return await hw_submit(mmw_stop_frame)
+
+async def mmw_dearming_tda_async():
+    """@brief mmw_dearming_tda, completed on the TDA ACK"""
+    return await hw_submit(mmw_dearming_tda)
+
+async def mmw_stream_read_async(timeout_ms=1000):
+    """@brief mmw_stream_read, on the default executor so that the frames are
+    * read while a hardware call is pending
+    """
+    return await asyncio.get_running_loop().run_in_executor(None, mmw_stream_read, timeout_ms)
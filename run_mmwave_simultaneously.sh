@@ -15,25 +15,12 @@ TIME_DURATION="0.17"
 echo "Memulai eksekusi mmwave secara simultan dengan NAME=$NAME"
 echo "--------------------------------------------------------"
 
-# --- Perintah 1 (Jalankan di Background) ---
-echo "Memulai Perintah 1 (IP 192.168.33.180)..."
-./mmwave -d "$NAME" -i 192.168.33.180 -f "$CONFIG_FILE" --configure --record --time "$TIME_DURATION" &
-
-# Simpan PID dari proses pertama
-PID1=$!
-
-# --- Perintah 2 (Jalankan di Background) ---
-echo "Memulai Perintah 2 (IP 192.168.33.181)..."
-./mmwave -d "$NAME" -i 192.168.33.181 -f "$CONFIG_FILE" --configure --record --time "$TIME_DURATION" &
-
-# Simpan PID dari proses kedua
-PID2=$!
-
-# --- Tunggu Kedua Perintah Selesai ---
-echo ""
-echo "⏳ Menunggu kedua proses mmwave (PID $PID1 dan $PID2) selesai..."
-wait $PID1
-wait $PID2
+# --- Satu proses untuk kedua board ---
+# Kedua board dikonfigurasi secara paralel dan framing dimulai bersamaan
+echo "Memulai mmwave untuk IP 192.168.33.180 dan 192.168.33.181..."
+./mmwave -d "$NAME" -i 192.168.33.180,192.168.33.181 -f "$CONFIG_FILE" --configure --record --time "$TIME_DURATION"
+STATUS=$?
 
 echo ""
-echo "Kedua perintah mmwave telah selesai dieksekusi."
+echo "Kedua board telah selesai dieksekusi (status $STATUS)."
+exit $STATUS
@@ -0,0 +1,299 @@
+/**
+ * @file sched.c
+ * @brief Continuous capture scheduler
+ * @version 0.1
+ * @date 2026-10-14
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "sched.h"
+
+static const char *sched_stage_name[SCHED_NUM_STAGES] = {
+  "arm", "record", "finalize", "transfer", "verify"
+};
+
+
+/**
+ * @brief Monotonic time
+ *
+ * @return uint64_t CLOCK_MONOTONIC time (ns)
+ */
+uint64_t sched_now() {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+
+/**
+ * @brief Account the time spent in a stage
+ *
+ * @param sched Scheduler
+ * @param stage SCHED_STAGE_*
+ * @param start Time the stage started (ns)
+ */
+void sched_stage_done(sched_t *sched, uint8_t stage, uint64_t start) {
+  uint64_t elapsed = sched_now() - start;
+
+  pthread_mutex_lock(&sched->lock);
+  sched->stats.stageTime[stage] += elapsed;
+  if (stage == SCHED_STAGE_RECORD) sched->stats.captures++;
+  pthread_mutex_unlock(&sched->lock);
+}
+
+
+/**
+ * @brief Transfer worker
+ *
+ * Pops the queued captures, copies and verifies them until the scheduler
+ * is closed and the queue drained.
+ *
+ * @param arg Scheduler
+ * @return void* NULL
+ */
+static void* sched_worker(void *arg) {
+  sched_t *sched = (sched_t *)arg;
+  schedTask_t task;
+  uint32_t pending;
+  uint64_t start;
+
+  for (;;) {
+    pthread_mutex_lock(&sched->lock);
+    while ((sched->count == 0) && !sched->closing) {
+      pthread_cond_wait(&sched->notEmpty, &sched->lock);
+    }
+    if (sched->count == 0) {
+      pthread_mutex_unlock(&sched->lock);
+      return NULL;
+    }
+    task = sched->queue[sched->head];
+    sched->head = (sched->head + 1) % sched->capacity;
+    sched->count--;
+    sched->inFlight++;
+    pthread_cond_signal(&sched->notFull);
+    pthread_mutex_unlock(&sched->lock);
+
+    start = sched_now();
+    task.status = sched->transfer(&task);
+    sched_stage_done(sched, SCHED_STAGE_TRANSFER, start);
+
+    if ((task.status == 0) && (sched->verify != NULL)) {
+      start = sched_now();
+      task.status = sched->verify(&task);
+      sched_stage_done(sched, SCHED_STAGE_VERIFY, start);
+    }
+
+    pthread_mutex_lock(&sched->lock);
+    if (task.status == 0) {
+      sched->stats.transferred++;
+      sched->stats.bytes += task.bytes;
+    } else {
+      sched->stats.failed++;
+    }
+    sched->inFlight--;
+    pending = sched->count;
+    pthread_mutex_unlock(&sched->lock);
+
+    printf("[TRANSFER #%u] %s: %s (%llu bytes) | queue depth: %u\n", task.captureId,
+      task.captureDir, (task.status == 0) ? "verified" : "FAILED",
+      (unsigned long long)task.bytes, pending);
+  }
+}
+
+
+/**
+ * @brief Create the transfer queue and start the workers
+ *
+ * @param sched Scheduler
+ * @param capacity Maximum number of captures waiting for a transfer
+ * @param maxInFlight Maximum number of concurrent transfers
+ * @param transfer Routine copying a capture
+ * @param verify Routine checking a copied capture (optional)
+ * @return int32_t 0 on success, -1 on failure
+ */
+int32_t sched_init(sched_t *sched, uint32_t capacity, uint8_t maxInFlight,
+                   schedTransferFn_t transfer, schedVerifyFn_t verify) {
+  if ((capacity == 0) || (maxInFlight == 0) || (transfer == NULL)) return -1;
+  if (maxInFlight > SCHED_MAX_WORKERS) maxInFlight = SCHED_MAX_WORKERS;
+
+  memset(sched, 0, sizeof(sched_t));
+  sched->queue = calloc(capacity, sizeof(schedTask_t));
+  if (sched->queue == NULL) return -1;
+  sched->capacity = capacity;
+  sched->transfer = transfer;
+  sched->verify = verify;
+  sched->stats.startTime = sched_now();
+
+  pthread_mutex_init(&sched->lock, NULL);
+  pthread_cond_init(&sched->notEmpty, NULL);
+  pthread_cond_init(&sched->notFull, NULL);
+
+  for (uint8_t i = 0; i < maxInFlight; i++) {
+    if (pthread_create(&sched->workers[i], NULL, sched_worker, sched) != 0) break;
+    sched->nWorkers++;
+  }
+  if (sched->nWorkers == 0) {
+    free(sched->queue);
+    sched->queue = NULL;
+    return -1;
+  }
+  return 0;
+}
+
+
+/**
+ * @brief Queue a finalized capture for transfer
+ *
+ * Blocks while the queue is full, so that the captures can not outrun the
+ * transfers.
+ *
+ * @param sched Scheduler
+ * @param task Capture to transfer
+ * @return int32_t 0 on success, -1 if the scheduler is closed
+ */
+int32_t sched_submit(sched_t *sched, const schedTask_t *task) {
+  uint64_t start = sched_now();
+
+  pthread_mutex_lock(&sched->lock);
+  while ((sched->count == sched->capacity) && !sched->closing) {
+    pthread_cond_wait(&sched->notFull, &sched->lock);
+  }
+  sched->stats.backpressureTime += sched_now() - start;
+  if (sched->closing) {
+    pthread_mutex_unlock(&sched->lock);
+    return -1;
+  }
+  sched->queue[(sched->head + sched->count) % sched->capacity] = *task;
+  sched->count++;
+  pthread_cond_signal(&sched->notEmpty);
+  pthread_mutex_unlock(&sched->lock);
+  return 0;
+}
+
+
+/**
+ * @brief Duty cycle of the captures
+ *
+ * @param sched Scheduler
+ * @return double Recorded time over wall clock time since the scheduler
+ *    started (0 to 1)
+ */
+double sched_duty_cycle(sched_t *sched) {
+  uint64_t recorded, wall;
+
+  pthread_mutex_lock(&sched->lock);
+  recorded = sched->stats.stageTime[SCHED_STAGE_RECORD];
+  wall = sched_now() - sched->stats.startTime;
+  pthread_mutex_unlock(&sched->lock);
+  return (wall > 0) ? (double)recorded / wall : 0.0;
+}
+
+
+/**
+ * @brief Print the statistics
+ *
+ * The duty cycle is the recorded time over the wall clock time since the
+ * scheduler started.
+ *
+ * @param sched Scheduler
+ * @param prefix Prefix of the printed lines
+ */
+void sched_print_stats(sched_t *sched, const char *prefix) {
+  schedStats_t stats;
+  uint64_t wall;
+  uint32_t pending;
+
+  pthread_mutex_lock(&sched->lock);
+  stats = sched->stats;
+  pending = sched->count;
+  pthread_mutex_unlock(&sched->lock);
+
+  wall = sched_now() - stats.startTime;
+  printf("%s Captures: %u | transferred: %u | failed: %u | queued: %u | %.1f MB\n",
+    prefix, stats.captures, stats.transferred, stats.failed, pending, stats.bytes / 1e6);
+  printf("%s Duty cycle: %.1f%% (%.1f s recorded / %.1f s)\n", prefix,
+    (wall > 0) ? 100.0 * stats.stageTime[SCHED_STAGE_RECORD] / wall : 0.0,
+    stats.stageTime[SCHED_STAGE_RECORD] / 1e9, wall / 1e9);
+  printf("%s Stage time:", prefix);
+  for (uint8_t i = 0; i < SCHED_NUM_STAGES; i++) {
+    printf(" %s %.2f s |", sched_stage_name[i], stats.stageTime[i] / 1e9);
+  }
+  printf(" backpressure %.2f s\n", stats.backpressureTime / 1e9);
+  if (stats.stageTime[SCHED_STAGE_TRANSFER] > 0) {
+    printf("%s Transfer throughput: %.1f MB/s per worker\n", prefix,
+      stats.bytes * 1e3 / stats.stageTime[SCHED_STAGE_TRANSFER]);
+  }
+}
+
+
+/**
+ * @brief Write the statistics in the Prometheus text format
+ *
+ * Matches metricsCollectFn_t, the scheduler being the argument.
+ *
+ * @param out Output
+ * @param arg Scheduler
+ */
+void sched_write_metrics(FILE *out, void *arg) {
+  sched_t *sched = (sched_t *)arg;
+  schedStats_t stats;
+  uint32_t pending, inFlight;
+  uint64_t wall;
+
+  pthread_mutex_lock(&sched->lock);
+  stats = sched->stats;
+  pending = sched->count;
+  inFlight = sched->inFlight;
+  pthread_mutex_unlock(&sched->lock);
+
+  wall = sched_now() - stats.startTime;
+  fprintf(out, "# HELP mmwave_captures_total Captures recorded\n"
+    "# TYPE mmwave_captures_total counter\nmmwave_captures_total %u\n", stats.captures);
+  fprintf(out, "# HELP mmwave_captures_transferred_total Captures transferred and verified\n"
+    "# TYPE mmwave_captures_transferred_total counter\n"
+    "mmwave_captures_transferred_total %u\n", stats.transferred);
+  fprintf(out, "# HELP mmwave_captures_failed_total Captures whose transfer or verification failed\n"
+    "# TYPE mmwave_captures_failed_total counter\nmmwave_captures_failed_total %u\n", stats.failed);
+  fprintf(out, "# HELP mmwave_transfer_queue_depth Captures waiting for a transfer worker\n"
+    "# TYPE mmwave_transfer_queue_depth gauge\nmmwave_transfer_queue_depth %u\n", pending);
+  fprintf(out, "# HELP mmwave_transfer_in_flight Captures being transferred or verified\n"
+    "# TYPE mmwave_transfer_in_flight gauge\nmmwave_transfer_in_flight %u\n", inFlight);
+  fprintf(out, "# HELP mmwave_duty_cycle Recorded time over wall clock time\n"
+    "# TYPE mmwave_duty_cycle gauge\nmmwave_duty_cycle %.6f\n",
+    (wall > 0) ? (double)stats.stageTime[SCHED_STAGE_RECORD] / wall : 0.0);
+  fprintf(out, "# HELP mmwave_stage_seconds_total Time spent in each capture stage\n"
+    "# TYPE mmwave_stage_seconds_total counter\n");
+  for (uint8_t i = 0; i < SCHED_NUM_STAGES; i++) {
+    fprintf(out, "mmwave_stage_seconds_total{stage=\"%s\"} %.9f\n", sched_stage_name[i],
+      stats.stageTime[i] / 1e9);
+  }
+  fprintf(out, "# HELP mmwave_backpressure_seconds_total Time spent waiting for the transfer queue\n"
+    "# TYPE mmwave_backpressure_seconds_total counter\n"
+    "mmwave_backpressure_seconds_total %.9f\n", stats.backpressureTime / 1e9);
+}
+
+
+/**
+ * @brief Wait for the queued transfers and stop the workers
+ *
+ * @param sched Scheduler
+ */
+void sched_close(sched_t *sched) {
+  pthread_mutex_lock(&sched->lock);
+  sched->closing = 1;
+  pthread_cond_broadcast(&sched->notEmpty);
+  pthread_cond_broadcast(&sched->notFull);
+  pthread_mutex_unlock(&sched->lock);
+
+  for (uint8_t i = 0; i < sched->nWorkers; i++) {
+    pthread_join(sched->workers[i], NULL);
+  }
+  sched->nWorkers = 0;
+  free(sched->queue);
+  sched->queue = NULL;
+}
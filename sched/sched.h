@@ -0,0 +1,150 @@
+/**
+ * @file sched.h
+ * @brief Continuous capture scheduler
+ * @version 0.1
+ * @date 2026-10-14
+ *
+ * @copyright Copyright (c) 2026
+ *
+ * A capture goes through five stages:
+ *
+ *    arm -> record -> finalize -> transfer -> verify
+ *
+ * The first three stages drive the TDA and the radar devices and run one
+ * after the other on the caller thread; each stage starts as soon as the
+ * previous one completed. The last two stages run on a pool of transfer
+ * workers fed by a bounded queue, so the next capture is armed while the
+ * previous ones are still being copied. When the queue is full, queuing a
+ * new capture blocks until a worker picks one up (backpressure).
+ */
+#ifndef MMWAVE_SCHED_H
+#define MMWAVE_SCHED_H
+
+#include <stdio.h>
+#include <stdint.h>
+#include <pthread.h>
+
+/* Maximum number of transfer in flight */
+#define SCHED_MAX_WORKERS       (8U)
+
+/* Capture stages */
+#define SCHED_STAGE_ARM         0
+#define SCHED_STAGE_RECORD      1
+#define SCHED_STAGE_FINALIZE    2
+#define SCHED_STAGE_TRANSFER    3
+#define SCHED_STAGE_VERIFY      4
+#define SCHED_NUM_STAGES        5
+
+
+/** Capture handed over to the transfer workers */
+typedef struct schedTask {
+
+  // Capture directory (relative to the root capture path)
+  char captureDir[128];
+
+  // Capture sequence number
+  uint32_t captureId;
+
+  // Transfer, then verify, status
+  int32_t status;
+
+  // Number of bytes copied
+  uint64_t bytes;
+
+  // Duration of the recording (ns, 0: unknown)
+  uint64_t recordTime;
+
+} schedTask_t;
+
+/* Copy a capture, 0 on success */
+typedef int32_t (*schedTransferFn_t)(schedTask_t *task);
+
+/* Check a copied capture (and fill task->bytes), 0 on success */
+typedef int32_t (*schedVerifyFn_t)(schedTask_t *task);
+
+
+/** Scheduler statistics */
+typedef struct schedStats {
+
+  // Number of captures recorded
+  uint32_t captures;
+
+  // Number of captures transferred and verified
+  uint32_t transferred;
+
+  // Number of captures whose transfer or verification failed
+  uint32_t failed;
+
+  // Number of bytes transferred
+  uint64_t bytes;
+
+  // Time spent in each stage (ns). Transfer and verify are summed over
+  // the workers and overlap the other stages.
+  uint64_t stageTime[SCHED_NUM_STAGES];
+
+  // Time spent waiting for a free slot in the transfer queue (ns)
+  uint64_t backpressureTime;
+
+  // Time the scheduler started (CLOCK_MONOTONIC, ns)
+  uint64_t startTime;
+
+} schedStats_t;
+
+
+/** Scheduler */
+typedef struct sched {
+
+  pthread_mutex_t lock;
+  pthread_cond_t notEmpty;
+  pthread_cond_t notFull;
+
+  // Transfer queue (ring)
+  schedTask_t *queue;
+  uint32_t capacity;
+  uint32_t head;
+  uint32_t count;
+
+  // Transfer workers
+  pthread_t workers[SCHED_MAX_WORKERS];
+  uint8_t nWorkers;
+
+  // Number of captures being transferred or verified
+  uint8_t inFlight;
+
+  // Set to let the workers exit once the queue is drained
+  uint8_t closing;
+
+  schedTransferFn_t transfer;
+  schedVerifyFn_t verify;
+
+  schedStats_t stats;
+
+} sched_t;
+
+
+/* Monotonic time (ns) */
+uint64_t sched_now();
+
+/* Create the transfer queue and start the workers */
+int32_t sched_init(sched_t *sched, uint32_t capacity, uint8_t maxInFlight,
+                   schedTransferFn_t transfer, schedVerifyFn_t verify);
+
+/* Account the time spent in one of the caller's stages */
+void sched_stage_done(sched_t *sched, uint8_t stage, uint64_t start);
+
+/* Queue a finalized capture for transfer (blocks while the queue is full) */
+int32_t sched_submit(sched_t *sched, const schedTask_t *task);
+
+/* Recorded time over wall clock time since the scheduler started */
+double sched_duty_cycle(sched_t *sched);
+
+/* Write the statistics in the Prometheus text format (metrics collector) */
+void sched_write_metrics(FILE *out, void *sched);
+
+/* Print the statistics, duty cycle included */
+void sched_print_stats(sched_t *sched, const char *prefix);
+
+/* Wait for the queued transfers and stop the workers */
+void sched_close(sched_t *sched);
+
+#endif
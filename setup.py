@@ -1,3 +1,4 @@
+import os
 from setuptools import setup, Extension
 from Cython.Build import cythonize
 
@@ -9,6 +10,14 @@ MMWLINK_IDIR = f"{ROOT_DIR}/mmwavelink/src"
 MMWLINK_H_IDIR = f"{ROOT_DIR}/mmwavelink/include"
 MMWETH_IDIR = f"{ROOT_DIR}/ethernet/src"
 MMWAVE_IDIR = f"{ROOT_DIR}/mmwave"
+# OS interface of mmWaveLink, as `make OSI=linux`: MMWL_OSI=linux
+define_macros = []
+if os.environ.get("MMWL_OSI", "posix") == "linux":
+    define_macros = [
+        ("MMWL_OSI_LINUX", None),
+        ("MMWL_OSI_CPUS", os.environ.get("MMWL_OSI_CPUS", "0")),
+        ("MMWL_OSI_PRIORITY", os.environ.get("MMWL_OSI_PRIORITY", "0")),
+    ]
 #CLI_OPT_IDIR = "opt"
 #TOML_CONFIG_IDIR = "toml"
 
@@ -22,9 +31,19 @@ sources = [
     f"{MMWLINK_IDIR}/rl_sensor.c",
     f"{MMWETH_IDIR}/mmwl_port_ethernet.c",
     f"{MMWETH_IDIR}/mtime.c",
+    f"{MMWETH_IDIR}/mmwl_trace.c",
+    f"{MMWETH_IDIR}/mmwl_prof.c",
+    f"{MMWETH_IDIR}/mmwl_crc.c",
     f"{MMWAVE_IDIR}/crc_compute.c",
     f"{MMWAVE_IDIR}/mmwave.c",
     f"{MMWAVE_IDIR}/rls_osi.c",
+    f"{MMWAVE_IDIR}/rls_osi_linux.c",
+    f"{MMWAVE_IDIR}/mmwl_stream.c",
+    "dsp/cube.c",
+    "dsp/rd.c",
+    "json/json.c",
+    "json/profile.c",
+    "json/health.c",
 #    f"{CLI_OPT_IDIR}/*.c",
 #    f"{TOML_CONFIG_IDIR}/*.c"
 ]
@@ -42,6 +61,7 @@ extensions = Extension(
 #            CLI_OPT_IDIR,       # cliopt 目录
 #            TOML_CONFIG_IDIR    # tomlconfig 目录
         ],
+        define_macros=define_macros,
         extra_compile_args=["-w"],  # 添加编译选项（如禁用警告）
         libraries=["pthread", "m"]  # 链接 pthread 和数学库
     )
@@ -0,0 +1,382 @@
+/**
+ * @file mmwl_crc.c
+ * @brief Fast CRC engine used for packet framing and mmWaveLink messages
+ * @version 0.1
+ * @date 2026-10-14
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#include <string.h>
+#include <pthread.h>
+#include "mmwl_crc.h"
+
+#if defined(__x86_64__)
+#include <immintrin.h>
+#elif defined(__aarch64__)
+#include <arm_acle.h>
+#include <sys/auxv.h>
+#include <asm/hwcap.h>
+#endif
+
+/* Polynomials, initial and final values of the AWR2243 CRCs */
+#define CRC16_POLY                                  (0x1021U)
+#define CRC16_INIT                                  (0xFFFFU)
+#define CRC32_POLY_REFLECTED                        (0xEDB88320U)
+#define CRC32_INIT                                  (0xFFFFFFFFU)
+#define CRC64_POLY                                  (0x1BULL)
+
+static uint16_t crc16Table[8][256];
+static uint32_t crc32Table[8][256];
+static uint64_t crc64Table[8][256];
+
+static pthread_once_t crcOnce = PTHREAD_ONCE_INIT;
+static uint8_t crcEngine = MMWL_CRC_ENGINE_SLICE8;
+static uint8_t crcEngineAvailable = (1 << MMWL_CRC_ENGINE_SLICE8);
+
+
+/**
+ * @brief Build the slice-by-8 tables and detect the CRC instructions
+ */
+static void crcSetup(void) {
+  for (unsigned int b = 0; b < 256; b++) {
+    uint16_t c16 = (uint16_t)(b << 8);
+    uint32_t c32 = b;
+    uint64_t c64 = (uint64_t)b << 56;
+
+    for (int bit = 0; bit < 8; bit++) {
+      c16 = (c16 & 0x8000U) ? (uint16_t)((c16 << 1) ^ CRC16_POLY) : (uint16_t)(c16 << 1);
+      c32 = (c32 & 1U) ? ((c32 >> 1) ^ CRC32_POLY_REFLECTED) : (c32 >> 1);
+      c64 = (c64 & (1ULL << 63)) ? ((c64 << 1) ^ CRC64_POLY) : (c64 << 1);
+    }
+    crc16Table[0][b] = c16;
+    crc32Table[0][b] = c32;
+    crc64Table[0][b] = c64;
+  }
+
+  for (unsigned int b = 0; b < 256; b++) {
+    for (int k = 1; k < 8; k++) {
+      uint16_t c16 = crc16Table[k - 1][b];
+      uint32_t c32 = crc32Table[k - 1][b];
+      uint64_t c64 = crc64Table[k - 1][b];
+
+      crc16Table[k][b] = (uint16_t)(c16 << 8) ^ crc16Table[0][c16 >> 8];
+      crc32Table[k][b] = (c32 >> 8) ^ crc32Table[0][c32 & 0xFF];
+      crc64Table[k][b] = (c64 << 8) ^ crc64Table[0][c64 >> 56];
+    }
+  }
+
+#if defined(__x86_64__)
+  __builtin_cpu_init();
+  if (__builtin_cpu_supports("pclmul") && __builtin_cpu_supports("sse4.1")) {
+    crcEngineAvailable |= (1 << MMWL_CRC_ENGINE_PCLMUL);
+    crcEngine = MMWL_CRC_ENGINE_PCLMUL;
+  }
+#elif defined(__aarch64__)
+  if (getauxval(AT_HWCAP) & HWCAP_CRC32) {
+    crcEngineAvailable |= (1 << MMWL_CRC_ENGINE_ARMV8);
+    crcEngine = MMWL_CRC_ENGINE_ARMV8;
+  }
+#endif
+}
+
+
+/**
+ * @brief Initialize the CRC engine. Called implicitly by the CRC functions
+ */
+void MMWL_crcInit(void) {
+  pthread_once(&crcOnce, crcSetup);
+}
+
+
+/**
+ * @brief Select the CRC32 engine
+ *
+ * @param engine MMWL_CRC_ENGINE_*
+ * @return uint8_t The engine in use, i.e. the previous one when the
+ *  requested engine is not supported by the host CPU
+ */
+uint8_t MMWL_crcSetEngine(uint8_t engine) {
+  MMWL_crcInit();
+  if ((engine < 8) && (crcEngineAvailable & (1 << engine))) {
+    crcEngine = engine;
+  }
+  return crcEngine;
+}
+
+
+/**
+ * @brief Return the CRC32 engine in use
+ */
+uint8_t MMWL_crcGetEngine(void) {
+  MMWL_crcInit();
+  return crcEngine;
+}
+
+
+/**
+ * @brief Return the name of a CRC32 engine
+ */
+const char* MMWL_crcEngineName(uint8_t engine) {
+  switch (engine) {
+    case MMWL_CRC_ENGINE_ARMV8: return "armv8-crc";
+    case MMWL_CRC_ENGINE_PCLMUL: return "pclmul";
+    default: return "slice-by-8";
+  }
+}
+
+
+static inline uint64_t load64(const uint8_t *p) {
+  uint64_t v;
+  memcpy(&v, p, sizeof(v));
+  return v;
+}
+
+
+static inline uint32_t load32(const uint8_t *p) {
+  uint32_t v;
+  memcpy(&v, p, sizeof(v));
+  return v;
+}
+
+
+/**
+ * @brief CRC16-CCITT (MSB first, init 0xFFFF, no final XOR)
+ *
+ * @param data Message
+ * @param len Length of the message in bytes
+ * @return uint16_t CRC
+ */
+uint16_t MMWL_crc16(const uint8_t *data, uint32_t len) {
+  uint16_t crc = CRC16_INIT;
+
+  MMWL_crcInit();
+  while (len >= 8) {
+    crc = crc16Table[7][data[0] ^ (crc >> 8)] ^
+          crc16Table[6][data[1] ^ (crc & 0xFF)] ^
+          crc16Table[5][data[2]] ^ crc16Table[4][data[3]] ^
+          crc16Table[3][data[4]] ^ crc16Table[2][data[5]] ^
+          crc16Table[1][data[6]] ^ crc16Table[0][data[7]];
+    data += 8;
+    len -= 8;
+  }
+  while (len--) {
+    crc = (uint16_t)(crc << 8) ^ crc16Table[0][(crc >> 8) ^ *data++];
+  }
+  return crc;
+}
+
+
+/**
+ * @brief Slice-by-8 update of a CRC32 state (reflected, not inverted)
+ */
+static uint32_t crc32Slice8(uint32_t crc, const uint8_t *data, uint32_t len) {
+  while (len >= 8) {
+    uint32_t one = load32(data) ^ crc;
+    uint32_t two = load32(data + 4);
+
+    crc = crc32Table[7][one & 0xFF] ^ crc32Table[6][(one >> 8) & 0xFF] ^
+          crc32Table[5][(one >> 16) & 0xFF] ^ crc32Table[4][one >> 24] ^
+          crc32Table[3][two & 0xFF] ^ crc32Table[2][(two >> 8) & 0xFF] ^
+          crc32Table[1][(two >> 16) & 0xFF] ^ crc32Table[0][two >> 24];
+    data += 8;
+    len -= 8;
+  }
+  while (len--) {
+    crc = (crc >> 8) ^ crc32Table[0][(crc ^ *data++) & 0xFF];
+  }
+  return crc;
+}
+
+
+#if defined(__aarch64__)
+/**
+ * @brief CRC32 update with the ARMv8 CRC32 instructions
+ */
+__attribute__((target("+crc")))
+static uint32_t crc32Armv8(uint32_t crc, const uint8_t *data, uint32_t len) {
+  while (len >= 8) {
+    crc = __crc32d(crc, load64(data));
+    data += 8;
+    len -= 8;
+  }
+  while (len--) {
+    crc = __crc32b(crc, *data++);
+  }
+  return crc;
+}
+#endif
+
+
+#if defined(__x86_64__)
+/**
+ * @brief CRC32 update with carry-less multiplication folding
+ *
+ * Folds four 128-bit lanes over the message, then reduces them to 32 bits
+ * with a Barrett reduction. Requires len >= 64 and a multiple of 16.
+ */
+__attribute__((target("pclmul,sse4.1")))
+static uint32_t crc32Pclmul(uint32_t crc, const uint8_t *data, uint32_t len) {
+  static const uint64_t k1k2[2] = { 0x0154442bd4ULL, 0x01c6e41596ULL };
+  static const uint64_t k3k4[2] = { 0x01751997d0ULL, 0x00ccaa009eULL };
+  static const uint64_t k5k0[2] = { 0x0163cd6124ULL, 0x0000000000ULL };
+  static const uint64_t poly[2] = { 0x01db710641ULL, 0x01f7011641ULL };
+  __m128i x0, x1, x2, x3, x4, x5, x6, x7, x8, y5, y6, y7, y8;
+
+  x0 = _mm_cvtsi32_si128((int)crc);
+  x1 = _mm_loadu_si128((const __m128i *)(data + 0x00));
+  x2 = _mm_loadu_si128((const __m128i *)(data + 0x10));
+  x3 = _mm_loadu_si128((const __m128i *)(data + 0x20));
+  x4 = _mm_loadu_si128((const __m128i *)(data + 0x30));
+  x1 = _mm_xor_si128(x1, x0);
+  x0 = _mm_loadu_si128((const __m128i *)k1k2);
+  data += 64;
+  len -= 64;
+
+  /* Parallel fold of 64 bytes blocks */
+  while (len >= 64) {
+    x5 = _mm_clmulepi64_si128(x1, x0, 0x00);
+    x6 = _mm_clmulepi64_si128(x2, x0, 0x00);
+    x7 = _mm_clmulepi64_si128(x3, x0, 0x00);
+    x8 = _mm_clmulepi64_si128(x4, x0, 0x00);
+    x1 = _mm_clmulepi64_si128(x1, x0, 0x11);
+    x2 = _mm_clmulepi64_si128(x2, x0, 0x11);
+    x3 = _mm_clmulepi64_si128(x3, x0, 0x11);
+    x4 = _mm_clmulepi64_si128(x4, x0, 0x11);
+    y5 = _mm_loadu_si128((const __m128i *)(data + 0x00));
+    y6 = _mm_loadu_si128((const __m128i *)(data + 0x10));
+    y7 = _mm_loadu_si128((const __m128i *)(data + 0x20));
+    y8 = _mm_loadu_si128((const __m128i *)(data + 0x30));
+    x1 = _mm_xor_si128(_mm_xor_si128(x1, x5), y5);
+    x2 = _mm_xor_si128(_mm_xor_si128(x2, x6), y6);
+    x3 = _mm_xor_si128(_mm_xor_si128(x3, x7), y7);
+    x4 = _mm_xor_si128(_mm_xor_si128(x4, x8), y8);
+    data += 64;
+    len -= 64;
+  }
+
+  /* Fold the four lanes into 128 bits */
+  x0 = _mm_loadu_si128((const __m128i *)k3k4);
+  x5 = _mm_clmulepi64_si128(x1, x0, 0x00);
+  x1 = _mm_clmulepi64_si128(x1, x0, 0x11);
+  x1 = _mm_xor_si128(_mm_xor_si128(x1, x2), x5);
+  x5 = _mm_clmulepi64_si128(x1, x0, 0x00);
+  x1 = _mm_clmulepi64_si128(x1, x0, 0x11);
+  x1 = _mm_xor_si128(_mm_xor_si128(x1, x3), x5);
+  x5 = _mm_clmulepi64_si128(x1, x0, 0x00);
+  x1 = _mm_clmulepi64_si128(x1, x0, 0x11);
+  x1 = _mm_xor_si128(_mm_xor_si128(x1, x4), x5);
+
+  /* Single fold of the remaining 16 bytes blocks */
+  while (len >= 16) {
+    x2 = _mm_loadu_si128((const __m128i *)data);
+    x5 = _mm_clmulepi64_si128(x1, x0, 0x00);
+    x1 = _mm_clmulepi64_si128(x1, x0, 0x11);
+    x1 = _mm_xor_si128(_mm_xor_si128(x1, x2), x5);
+    data += 16;
+    len -= 16;
+  }
+
+  /* Fold 128 bits to 64 bits */
+  x2 = _mm_clmulepi64_si128(x1, x0, 0x10);
+  x3 = _mm_setr_epi32(~0, 0, ~0, 0);
+  x1 = _mm_srli_si128(x1, 8);
+  x1 = _mm_xor_si128(x1, x2);
+  x0 = _mm_loadl_epi64((const __m128i *)k5k0);
+  x2 = _mm_srli_si128(x1, 4);
+  x1 = _mm_and_si128(x1, x3);
+  x1 = _mm_clmulepi64_si128(x1, x0, 0x00);
+  x1 = _mm_xor_si128(x1, x2);
+
+  /* Barrett reduction to 32 bits */
+  x0 = _mm_loadu_si128((const __m128i *)poly);
+  x2 = _mm_and_si128(x1, x3);
+  x2 = _mm_clmulepi64_si128(x2, x0, 0x10);
+  x2 = _mm_and_si128(x2, x3);
+  x2 = _mm_clmulepi64_si128(x2, x0, 0x00);
+  x1 = _mm_xor_si128(x1, x2);
+  return (uint32_t)_mm_extract_epi32(x1, 1);
+}
+#endif
+
+
+/**
+ * @brief CRC32 (ISO 3309 / Ethernet)
+ *
+ * @param data Message
+ * @param len Length of the message in bytes
+ * @return uint32_t CRC
+ */
+uint32_t MMWL_crc32(const uint8_t *data, uint32_t len) {
+  uint32_t crc = CRC32_INIT;
+
+  MMWL_crcInit();
+  switch (crcEngine) {
+#if defined(__x86_64__)
+    case MMWL_CRC_ENGINE_PCLMUL: {
+      if (len >= 64) {
+        uint32_t blocks = len & ~15U;
+        crc = crc32Pclmul(crc, data, blocks);
+        data += blocks;
+        len -= blocks;
+      }
+      crc = crc32Slice8(crc, data, len);
+      break;
+    }
+#elif defined(__aarch64__)
+    case MMWL_CRC_ENGINE_ARMV8:
+      crc = crc32Armv8(crc, data, len);
+      break;
+#endif
+    default:
+      crc = crc32Slice8(crc, data, len);
+      break;
+  }
+  return crc ^ CRC32_INIT;
+}
+
+
+/**
+ * @brief 64-bit ISO CRC (MSB first, init 0, no final XOR)
+ *
+ * @param data Message
+ * @param len Length of the message in bytes
+ * @return uint64_t CRC
+ */
+uint64_t MMWL_crc64(const uint8_t *data, uint32_t len) {
+  uint64_t crc = 0;
+
+  MMWL_crcInit();
+  while (len >= 8) {
+    uint64_t w = __builtin_bswap64(load64(data)) ^ crc;
+
+    crc = crc64Table[7][w >> 56] ^ crc64Table[6][(w >> 48) & 0xFF] ^
+          crc64Table[5][(w >> 40) & 0xFF] ^ crc64Table[4][(w >> 32) & 0xFF] ^
+          crc64Table[3][(w >> 24) & 0xFF] ^ crc64Table[2][(w >> 16) & 0xFF] ^
+          crc64Table[1][(w >> 8) & 0xFF] ^ crc64Table[0][w & 0xFF];
+    data += 8;
+    len -= 8;
+  }
+  while (len--) {
+    crc = (crc << 8) ^ crc64Table[0][(crc >> 56) ^ *data++];
+  }
+  return crc;
+}
+
+
+/**
+ * @brief Compute a CRC of the given type
+ *
+ * @param crcType MMWL_CRC_TYPE_*
+ * @param data Message
+ * @param len Length of the message in bytes
+ * @return uint64_t CRC
+ */
+uint64_t MMWL_crcCompute(uint8_t crcType, const uint8_t *data, uint32_t len) {
+  switch (crcType) {
+    case MMWL_CRC_TYPE_16BIT: return MMWL_crc16(data, len);
+    case MMWL_CRC_TYPE_32BIT: return MMWL_crc32(data, len);
+    default: return MMWL_crc64(data, len);
+  }
+}
@@ -0,0 +1,49 @@
+/**
+ * @file mmwl_crc.h
+ * @brief Fast CRC engine used for packet framing and mmWaveLink messages
+ * @version 0.1
+ * @date 2026-10-14
+ *
+ * @copyright Copyright (c) 2026
+ *
+ * Slice-by-8 table driven implementation of the three CRC types supported
+ * by the AWR2243 (CRC16-CCITT, CRC32 IEEE and the 64-bit ISO polynomial).
+ * The CRC32 uses the ARMv8 CRC32 instructions or PCLMULQDQ folding when the
+ * host CPU supports them; the engine is selected once at runtime.
+ *
+ * The results are bit exact with `computeCRC()` of crc_compute.c and with
+ * the byte-wise LUT previously used by `Bsp_ar12xxComputeCrc()`.
+ */
+
+#ifndef MMWL_CRC_H
+#define MMWL_CRC_H
+
+#include <stdint.h>
+
+/* CRC types, same values as RL_CRC_TYPE_* of mmWaveLink */
+#define MMWL_CRC_TYPE_16BIT                         (0U)
+#define MMWL_CRC_TYPE_32BIT                         (1U)
+#define MMWL_CRC_TYPE_64BIT                         (2U)
+
+/* CRC32 engines */
+#define MMWL_CRC_ENGINE_SLICE8                      (0U)
+#define MMWL_CRC_ENGINE_ARMV8                       (1U)
+#define MMWL_CRC_ENGINE_PCLMUL                      (2U)
+
+void MMWL_crcInit(void);
+
+uint16_t MMWL_crc16(const uint8_t *data, uint32_t len);
+
+uint32_t MMWL_crc32(const uint8_t *data, uint32_t len);
+
+uint64_t MMWL_crc64(const uint8_t *data, uint32_t len);
+
+uint64_t MMWL_crcCompute(uint8_t crcType, const uint8_t *data, uint32_t len);
+
+uint8_t MMWL_crcSetEngine(uint8_t engine);
+
+uint8_t MMWL_crcGetEngine(void);
+
+const char* MMWL_crcEngineName(uint8_t engine);
+
+#endif
@@ -66,9 +66,7 @@ Radar_EthDataPacketPrms pDataPacket[TDA_NUM_CONNECTED_DEVICES_MAX + 1];
 DevComm_NetworkCtrlReqPrms pDevCtrlPrms[TDA_NUM_CONNECTED_DEVICES_MAX + 1];
 
 TDADevCtx_t gTDA_devCtx[TDA_NUM_CONNECTED_DEVICES_MAX] = { 0 };
-volatile uint32_t gSpiRxSignal[TDA_NUM_CONNECTED_DEVICES_MAX] = { 0 };
-uint32_t gSpiRxLength[TDA_NUM_CONNECTED_DEVICES_MAX] = { 0 };
-uint8_t gSpiRxData[TDA_NUM_CONNECTED_DEVICES_MAX][512];
+TDASpiRxCompletion_t gSpiRxCompletion[TDA_NUM_CONNECTED_DEVICES_MAX];
 TDA_EVENT_HANDLER gTDACARD_Callback;
 HANDLE gThreadHdl;
 captureConfig_t gCaptureConfigParams;
@@ -76,6 +74,7 @@ NetworkRadarDeviceMap_param		gDeviceMapParams;
 NetworkTDA_Obj gNetworkTDA_obj;
 Network_SockObj gNetwork_SockObj;
 pthread_mutex_t gNetwork_Write_cs;
+int gNetwork_RxWakeFd = -1;
   
 uint32_t TDA_HostIntrThreadLoop[TDA_NUM_CONNECTED_DEVICES_MAX];
 uint32_t TDA_HostIntrExitThread = 0;
@@ -85,6 +84,11 @@ uint32_t TDA_StartTraceACK = 0;
 uint32_t TDA_GetVersionACK = 0;
 uint32_t magicWord = 0;
 
+/* Host IRQ dispatch mode and the event shared by all the devices */
+uint8_t gTDA_IrqMode = TDA_IRQ_MODE_POLLING;
+sem_t gTDA_HostIrqEvent;
+uint8_t gTDA_HostIrqEventInit = 0;
+
 /******************************************************************************
  * FUNCTION DEFINITIONS
  ******************************************************************************
@@ -93,44 +97,131 @@ uint32_t magicWord = 0;
 extern void CloseTraceFile();
 
 
+/** @fn void* Network_waitConnect(void* lpParam)
+*
+*   @brief Rx thread: receive and dispatch the responses of the TDA
+*   @param[in] lpParam - network socket object
+*
+*   The thread blocks in epoll until the socket is readable, reads as much
+*   as possible in one recv() call into a large receive buffer and then
+*   processes every complete framed response (4 bytes header + payload)
+*   found in the buffer. Partial frames are kept for the next read and the
+*   buffer grows when a single frame does not fit in it. A header announcing
+*   more than NETWORK_RX_MAX_PRM_SIZE bytes is reported as a network error.
+*/
 void* Network_waitConnect(void* lpParam) {
-  uint32_t *pMem;
-  uint32_t prmSize = 0;
-  pMem = malloc(512);
-
-  if (pMem == NULL) {
-    DEBUG_PRINT("# ERROR: Unable to allocate memory for response parameters\n");
+  Network_SockObj* pObj = (Network_SockObj*)lpParam;
+  struct epoll_event ev = { 0 };
+  struct epoll_event events[2];
+  uint32_t bufSize = NETWORK_RX_BUFFER_SIZE;
+  uint32_t head = 0;    /* write position */
+  uint32_t tail = 0;    /* parse position */
+  uint8_t* pBuf = malloc(bufSize);
+  int epollFd = epoll_create1(0);
+
+  if ((pBuf == NULL) || (epollFd < 0)) {
+    DEBUG_PRINT("# ERROR: Unable to set up the network Rx engine\n");
+    free(pBuf);
+    if (epollFd >= 0) close(epollFd);
     return NULL; //  RLS_RET_CODE_EFAIL
   }
 
-  /* Initialize the Rx thread */
+  ev.events = EPOLLIN;
+  ev.data.fd = pObj->clientSocketId;
+  epoll_ctl(epollFd, EPOLL_CTL_ADD, pObj->clientSocketId, &ev);
+  ev.data.fd = gNetwork_RxWakeFd;
+  epoll_ctl(epollFd, EPOLL_CTL_ADD, gNetwork_RxWakeFd, &ev);
+
+  /* Initialize the Rx thread, discarding any stale wake up request */
+  uint64_t wake;
+  while (read(gNetwork_RxWakeFd, &wake, sizeof(wake)) > 0);
   TDA_NetworkThreadRunning = 1;
 
   while (TDA_NetworkThreadRunning) {
-    /* Check if any information is available on the socket */
-    int32_t status = Network_waitRead(&gNetwork_SockObj);
-
-    /* If information is available */
-    if (status == 1) {
-      /* Read header response */
-      int32_t response = RecvResponse(&prmSize);
-      if (response != SYSTEM_LINK_STATUS_SOK) {
-        /* Notify mmWaveStudio about network error */
-        gTDACARD_Callback(1, CAPTURE_RESPONSE_NETWORK_ERROR, 0, response, NULL);
+    int nEvents = epoll_wait(epollFd, events, 2, -1);
+    int readable = 0;
+    int malformed = 0;
+
+    if (nEvents < 0) {
+      if (errno == EINTR) continue;
+      DEBUG_PRINT("# ERROR: NETWORK: epoll_wait failed\n");
+      gTDACARD_Callback(1, CAPTURE_RESPONSE_NETWORK_ERROR, 0, RLS_RET_CODE_EFAIL, NULL);
+      break;
+    }
+    for (int i = 0; i < nEvents; i++) {
+      if (events[i].data.fd == pObj->clientSocketId) readable = 1;
+      else read(gNetwork_RxWakeFd, &wake, sizeof(wake));
+    }
+    if (!readable) continue;  /* Wake up request */
+
+    ssize_t received = recv(pObj->clientSocketId, pBuf + head, bufSize - head, 0);
+    if (received <= 0) {
+      if ((received < 0) && ((errno == EINTR) || (errno == EAGAIN))) continue;
+      /* Notify mmWaveStudio about network error */
+      DEBUG_PRINT("ERROR: recv failed in Network_waitConnect!\n");
+      TDATraceDump();
+      gTDACARD_Callback(1, CAPTURE_RESPONSE_NETWORK_ERROR, 0, RLS_RET_CODE_EFAIL, NULL);
+      break;
+    }
+    head += received;
+
+    /* Process all the complete frames available */
+    while ((head - tail) >= sizeof(NetworkTDA_CmdHeader)) {
+      uint32_t prmSize = ((NetworkTDA_CmdHeader*)(pBuf + tail))->prmSize;
+      size_t frameSize = sizeof(NetworkTDA_CmdHeader) + (size_t)prmSize;
+
+      if (prmSize > NETWORK_RX_MAX_PRM_SIZE) {
+        malformed = 1;
         break;
       }
+      if ((head - tail) < frameSize) break;
+      if (prmSize >= (DATA_HEADER_LENGTH + HEADER_AND_CRC_LENGTH)) {
+        Radar_processData(
+          (Radar_EthDataPacketPrms *)(pBuf + tail + sizeof(NetworkTDA_CmdHeader)),
+          prmSize
+        );
+      } else if (prmSize != 0) {
+        DEBUG_PRINT("# ERROR: NETWORK: Dropping truncated response (%u bytes)\n", prmSize);
+      }
+      tail += frameSize;
+    }
+    if (malformed) {
+      /* The stream has no frame marker to resync on: drop the connection */
+      DEBUG_PRINT("# ERROR: NETWORK: Malformed response header (%u bytes)\n",
+        ((NetworkTDA_CmdHeader*)(pBuf + tail))->prmSize);
+      TDATraceDump();
+      gTDACARD_Callback(1, CAPTURE_RESPONSE_NETWORK_ERROR, 0, RLS_RET_CODE_EFAIL, NULL);
+      break;
+    }
 
-      /* If there are bytes to read */
-      if (prmSize) {
-        /* Read data */
-        RecvResponseParams((uint8_t*)pMem, prmSize);
-        /* Process the data */
-        Radar_processData((Radar_EthDataPacketPrms *)pMem, prmSize);
+    /* Keep the pending partial frame at the (aligned) start of the buffer */
+    if (tail == head) {
+      head = tail = 0;
+    } else if ((tail != 0) && ((bufSize - head) < NETWORK_RX_MIN_READ_SIZE || (tail & 0x3))) {
+      memmove(pBuf, pBuf + tail, head - tail);
+      head -= tail;
+      tail = 0;
+    }
+
+    /* Grow the buffer if the pending frame (checked above) does not fit in it */
+    if ((head - tail) >= sizeof(NetworkTDA_CmdHeader)) {
+      size_t frameSize = sizeof(NetworkTDA_CmdHeader) +
+        (size_t)((NetworkTDA_CmdHeader*)(pBuf + tail))->prmSize;
+      if (frameSize > (bufSize - tail)) {
+        uint8_t* pNewBuf = realloc(pBuf, tail + frameSize);
+        if (pNewBuf == NULL) {
+          DEBUG_PRINT("# ERROR: Unable to allocate memory for a %zu bytes response\n", frameSize);
+          gTDACARD_Callback(1, CAPTURE_RESPONSE_NETWORK_ERROR, 0, RLS_RET_CODE_EFAIL, NULL);
+          break;
+        }
+        pBuf = pNewBuf;
+        bufSize = tail + frameSize;
       }
     }
   }
   DEBUG_PRINT("# INFO: Rx thread about to die\r\n");
-  free(pMem);
+  close(epollFd);
+  free(pBuf);
   return NULL; // RLS_RET_CODE_OK
 }
 
@@ -152,23 +243,24 @@ STATUS Radar_formEthDataPacket(Radar_EthDataPacketPrms *pDataPacket,
     uint16_t responseCode, uint16_t dataLength, uint8_t* data) {
 
   int32_t status = SYSTEM_LINK_STATUS_SOK;
-  Radar_EthDataPacketPrms dataPacket = { 0 };
+  /* The packet is framed in place in the request buffer of the device */
+  Radar_EthDataPacketPrms* pPacket = (Radar_EthDataPacketPrms*)pDevCtrlPrms->respParam;
   uint16_t crc = 0;
-  uint8_t* pDataBuf = (uint8_t*)pDevCtrlPrms->respParam;
 
-  dataPacket.syncByte = TX_SYNC_BYTE;
-  dataPacket.opcode = responseCode;
-  dataPacket.ackCode = 0;
-  dataPacket.dataLength = dataLength;
-  dataPacket.devSelection = pDataPacket->devSelection;
-  dataPacket.ackType = pDataPacket->ackType;
+  pPacket->syncByte = TX_SYNC_BYTE;
+  pPacket->opcode = responseCode;
+  pPacket->ackCode = 0;
+  pPacket->dataLength = dataLength;
+  pPacket->devSelection = pDataPacket->devSelection;
+  pPacket->ackType = pDataPacket->ackType;
+  memset(pPacket->reserved, 0, sizeof(pPacket->reserved));
 
   if (data != NULL) {
-    memcpy(dataPacket.data, data, dataLength - DATA_HEADER_LENGTH);
+    memcpy(pPacket->data, data, dataLength - DATA_HEADER_LENGTH);
   }
 
   status = Bsp_ar12xxComputeCrc(\
-    (uint8_t *)((uint8_t *)&dataPacket + 2), \
+    (uint8_t *)((uint8_t *)pPacket + 2), \
     dataLength, RL_CRC_TYPE_16BIT_CCITT, (uint8_t *)&crc \
   );
 
@@ -177,8 +269,7 @@ STATUS Radar_formEthDataPacket(Radar_EthDataPacketPrms *pDataPacket,
     return RLS_RET_CODE_EFAIL;
   }
 
-  *(uint16_t*)(dataPacket.data + dataLength - DATA_HEADER_LENGTH) = crc;
-  memcpy(pDevCtrlPrms->respParam, &dataPacket, (dataLength + HEADER_AND_CRC_LENGTH));
+  memcpy(pPacket->data + dataLength - DATA_HEADER_LENGTH, &crc, sizeof(crc));
   pDevCtrlPrms->respParamSize = dataLength + HEADER_AND_CRC_LENGTH;
 
   return status;
@@ -218,6 +309,10 @@ STATUS Radar_processData(Radar_EthDataPacketPrms *pDataPacket_ptr, uint32_t prmS
     return SYSTEM_LINK_STATUS_EFAIL;
   }
 
+  TDATraceRecord(TDA_TRACE_DIR_RX, pDataPacket_ptr->devSelection,
+    pDataPacket_ptr->opcode, pDataPacket_ptr->ackCode, pDataPacket_ptr->data,
+    prmSize - DATA_HEADER_LENGTH - HEADER_AND_CRC_LENGTH);
+
   switch (pDataPacket_ptr->opcode) {
     case CAPTURE_RESPONSE_ACK: {
       /* Received ACK Response from the TDA */
@@ -328,17 +423,30 @@ STATUS Radar_processData(Radar_EthDataPacketPrms *pDataPacket_ptr, uint32_t prmS
       DEBUG_PRINT("# INFO: Received HOST_IRQ_HIGH command from device %d\n", \
         dev_id);
       TDADevCtx_t*   pDevCtx = (TDADevCtx_t *)TDAGetDeviceCtx(dev_id);
-      sem_post(&pDevCtx->hostIntrThread.eventHandle);
       pDevCtx->hostIrqRxHigh = 1;
+      sem_post(&pDevCtx->hostIntrThread.eventHandle);
+      if (gTDA_IrqMode == TDA_IRQ_MODE_EVENT) sem_post(&gTDA_HostIrqEvent);
       break;
     }
 
     case SENSOR_RESPONSE_SPI_DATA: {
       /* Received SPI data from the AWR device */
       int dev_id = getDevIdFromDevMap(pDataPacket_ptr->devSelection);
-      gSpiRxLength[dev_id] = pDataPacket_ptr->dataLength - DATA_HEADER_LENGTH;
-      memcpy(gSpiRxData[dev_id], pDataPacket_ptr->data, gSpiRxLength[dev_id]);
-      gSpiRxSignal[dev_id] = 1;
+      TDASpiRxCompletion_t* pRx = &gSpiRxCompletion[dev_id];
+      uint32_t length = pDataPacket_ptr->dataLength - DATA_HEADER_LENGTH;
+
+      /* Hand the payload over straight from the Rx buffer to the reader */
+      pthread_mutex_lock(&pRx->lock);
+      if ((pRx->dest != NULL) && (pRx->done == 0)) {
+        if (length > pRx->destSize) length = pRx->destSize;
+        memcpy(pRx->dest, pDataPacket_ptr->data, length);
+        pRx->length = length;
+        pRx->done = 1;
+        pthread_cond_signal(&pRx->cond);
+      } else {
+        DEBUG_PRINT("# ERROR: Unexpected SPI data received from device %d\n", dev_id);
+      }
+      pthread_mutex_unlock(&pRx->lock);
 
       break;
     }
@@ -404,9 +512,21 @@ STATUS ethernetConnect(unsigned char *ipAddr, uint32_t configPort, uint32_t devi
 
   // Initialize mutex
   pthread_mutex_init(&gNetwork_Write_cs, NULL);
+  for (uint32_t devId = 0; devId < TDA_NUM_CONNECTED_DEVICES_MAX; devId++) {
+    pthread_mutex_init(&gSpiRxCompletion[devId].lock, NULL);
+    pthread_cond_init(&gSpiRxCompletion[devId].cond, NULL);
+    gSpiRxCompletion[devId].dest = NULL;
+  }
 
   //Create Rx thread
   /****** Thread handler **/
+  TDATraceInit();
+  if (gNetwork_RxWakeFd < 0) gNetwork_RxWakeFd = eventfd(0, EFD_NONBLOCK);
+  /* Host IRQ event of the event dispatch thread, kept across reconnections */
+  if (!gTDA_HostIrqEventInit) {
+    sem_init(&gTDA_HostIrqEvent, 0, 0);
+    gTDA_HostIrqEventInit = 1;
+  }
   pthread_create(&gThreadHdl, NULL, Network_waitConnect, &gNetwork_SockObj);
 
   /* wait for the thread to start */
@@ -423,6 +543,8 @@ STATUS ethernetConnect(unsigned char *ipAddr, uint32_t configPort, uint32_t devi
   char traceBuff[100];
   // Generate unique trace name
   sprintf(traceBuff, "Trace_TDA_[%lu].txt", (unsigned long int)time(NULL));
+  // Cleared before sending: the ACK can be received before startTrace returns
+  TDA_StartTraceACK = 0;
   status = startTrace(traceBuff);
   if (status != SYSTEM_LINK_STATUS_SOK) {
     DEBUG_PRINT("# ERROR: TRACE command failed\n");
@@ -431,7 +553,6 @@ STATUS ethernetConnect(unsigned char *ipAddr, uint32_t configPort, uint32_t devi
 
   // wait for the ACK to be received for Trace command
   int cmdCount = 0;
-  TDA_StartTraceACK = 0;
   while (TDA_StartTraceACK == 0) {
     Sleep(1);
     cmdCount++;
@@ -443,6 +564,7 @@ STATUS ethernetConnect(unsigned char *ipAddr, uint32_t configPort, uint32_t devi
   }
 
   //Send TDA version command
+  TDA_GetVersionACK = 0;
   status = readDLLVersion();
   if (status != SYSTEM_LINK_STATUS_SOK) {
     DEBUG_PRINT("# ERROR: TDA version command failed\n");
@@ -451,7 +573,6 @@ STATUS ethernetConnect(unsigned char *ipAddr, uint32_t configPort, uint32_t devi
 
   /* wait for the ACK to be received for TDA version command */
   cmdCount = 0;
-  TDA_GetVersionACK = 0;
   while (TDA_GetVersionACK == 0) {
     Sleep(1);
     cmdCount++;
@@ -482,17 +603,6 @@ STATUS ethernetConnect(unsigned char *ipAddr, uint32_t configPort, uint32_t devi
     return SYSTEM_LINK_STATUS_EFAIL;
   }
 
-  /* Create data buffer and print it into file */
-  char tempBuff[2048] = { 0 };
-  int offset = 0;
-  for (unsigned int i = 0; i < pDevCtrlPrms[4].respParamSize; i++) {
-    int j = 0;
-    j = sprintf(&tempBuff[offset], "0x%02X ", pDevCtrlPrms[4].respParam[i]);
-    offset = offset + j;
-  }
-  sprintf(&tempBuff[offset], "\r\n");
-  DEBUG_PRINT("[GN]%s", tempBuff);
-
   handleDevCtrl((uint8_t*)&pDevCtrlPrms[4].respParam, pDevCtrlPrms[4].respParamSize);
   return status;
 }
@@ -518,17 +628,6 @@ STATUS ethernetDisconnect() {
     return SYSTEM_LINK_STATUS_EFAIL;
   }
 
-  /* Create data buffer and print it into file */
-  char tempBuff[2048] = { 0 };
-  int offset = 0;
-  for (unsigned int i = 0; i < pDevCtrlPrms[4].respParamSize; i++) {
-    int j = 0;
-    j = sprintf(&tempBuff[offset], "0x%02X ", pDevCtrlPrms[4].respParam[i]);
-    offset = offset + j;
-  }
-  sprintf(&tempBuff[offset], "\r\n");
-  DEBUG_PRINT("[GN]%s", tempBuff);
-
   handleDevCtrl((uint8_t*)&pDevCtrlPrms[4].respParam, pDevCtrlPrms[4].respParamSize);
 
   // Send the stop trace command to close the trace file
@@ -542,6 +641,10 @@ STATUS ethernetDisconnect() {
 
   // Disable the Rx thread
   TDA_NetworkThreadRunning = 0;
+  if (gNetwork_RxWakeFd >= 0) {
+    uint64_t wake = 1;
+    write(gNetwork_RxWakeFd, &wake, sizeof(wake));
+  }
 
   Sleep(1000);
 
@@ -581,17 +684,6 @@ STATUS IsConnected() {
     return SYSTEM_LINK_STATUS_EFAIL;
   }
 
-  /* Create data buffer and print it into file */
-  char tempBuff[2048] = { 0 };
-  int offset = 0;
-  for (unsigned int i = 0; i < pDevCtrlPrms[4].respParamSize; i++) {
-    int j = 0;
-    j = sprintf(&tempBuff[offset], "0x%02X ", pDevCtrlPrms[4].respParam[i]);
-    offset = offset + j;
-  }
-  sprintf(&tempBuff[offset], "\r\n");
-  DEBUG_PRINT("[GN]%s", tempBuff);
-
   handleDevCtrl((uint8_t*)&pDevCtrlPrms[4].respParam, pDevCtrlPrms[4].respParamSize);
   return status;
 }
@@ -643,17 +735,6 @@ STATUS ConfigureDeviceMap(uint32_t deviceMap) {
     return SYSTEM_LINK_STATUS_EFAIL;
   }
 
-  /* Create data buffer and print it into file */
-  char tempBuff[2048] = { 0 };
-  int offset = 0;
-  for (unsigned int i = 0; i < pDevCtrlPrms[4].respParamSize; i++) {
-    int j = 0;
-    j = sprintf(&tempBuff[offset], "0x%02X ", pDevCtrlPrms[4].respParam[i]);
-    offset = offset + j;
-  }
-  sprintf(&tempBuff[offset], "\r\n");
-  DEBUG_PRINT("[GN]%s", tempBuff);
-
   handleDevCtrl((uint8_t*)&pDevCtrlPrms[4].respParam, pDevCtrlPrms[4].respParamSize);
   return status;
 }
@@ -677,17 +758,6 @@ STATUS TDACreateApplication() {
     return SYSTEM_LINK_STATUS_EFAIL;
   }
 
-  /* Create data buffer and print it into file */
-  char tempBuff[2048] = { 0 };
-  int offset = 0;
-  for (unsigned int i = 0; i < pDevCtrlPrms[4].respParamSize; i++) {
-    int j = 0;
-    j = sprintf(&tempBuff[offset], "0x%02X ", pDevCtrlPrms[4].respParam[i]);
-    offset = offset + j;
-  }
-  sprintf(&tempBuff[offset], "\r\n");
-  DEBUG_PRINT("[GN]%s", tempBuff);
-
   handleDevCtrl((uint8_t*)&pDevCtrlPrms[4].respParam, pDevCtrlPrms[4].respParamSize);
   return status;
 }
@@ -714,17 +784,6 @@ STATUS readHWVersion() {
     return SYSTEM_LINK_STATUS_EFAIL;
   }
 
-  /* Create data buffer and print it into file */
-  char tempBuff[2048] = { 0 };
-  int offset = 0;
-  for (unsigned int i = 0; i < pDevCtrlPrms[4].respParamSize; i++) {
-    int j = 0;
-    j = sprintf(&tempBuff[offset], "0x%02X ", pDevCtrlPrms[4].respParam[i]);
-    offset = offset + j;
-  }
-  sprintf(&tempBuff[offset], "\r\n");
-  DEBUG_PRINT("[GN]%s", tempBuff);
-
   handleDevCtrl((uint8_t*)&pDevCtrlPrms[4].respParam, pDevCtrlPrms[4].respParamSize);
   return status;
 }
@@ -753,17 +812,6 @@ STATUS readDLLVersion() {
     return SYSTEM_LINK_STATUS_EFAIL;
   }
 
-  /* Create data buffer and print it into file */
-  char tempBuff[2048] = { 0 };
-  int offset = 0;
-  for (unsigned int i = 0; i < pDevCtrlPrms[4].respParamSize; i++) {
-    int j = 0;
-    j = sprintf(&tempBuff[offset], "0x%02X ", pDevCtrlPrms[4].respParam[i]);
-    offset = offset + j;
-  }
-  sprintf(&tempBuff[offset], "\r\n");
-  DEBUG_PRINT("[GN]%s", tempBuff);
-
   handleDevCtrl((uint8_t*)&pDevCtrlPrms[4].respParam, pDevCtrlPrms[4].respParamSize);
   return status;
 }
@@ -795,17 +843,6 @@ STATUS setWidthAndHeight(uint8_t devSelection, uint32_t width, uint32_t height)
     return SYSTEM_LINK_STATUS_EFAIL;
   }
 
-  /* Create data buffer and print it into file */
-  char tempBuff[2048] = { 0 };
-  int offset = 0;
-  for (unsigned int i = 0; i < pDevCtrlPrms[devId].respParamSize; i++) {
-    int j = 0;
-    j = sprintf(&tempBuff[offset], "0x%02X ", pDevCtrlPrms[devId].respParam[i]);
-    offset = offset + j;
-  }
-  sprintf(&tempBuff[offset], "\r\n");
-  DEBUG_PRINT("[GN]%s", tempBuff);
-
   handleDevCtrl((uint8_t*)&pDevCtrlPrms[devId].respParam, pDevCtrlPrms[devId].respParamSize);
   return status;
 }
@@ -832,17 +869,6 @@ STATUS getWidthAndHeight(uint8_t devSelection) {
     return SYSTEM_LINK_STATUS_EFAIL;
   }
 
-  /* Create data buffer and print it into file */
-  char tempBuff[2048] = { 0 };
-  int offset = 0;
-  for (unsigned int i = 0; i < pDevCtrlPrms[devId].respParamSize; i++) {
-    int j = 0;
-    j = sprintf(&tempBuff[offset], "0x%02X ", pDevCtrlPrms[devId].respParam[i]);
-    offset = offset + j;
-  }
-  sprintf(&tempBuff[offset], "\r\n");
-  DEBUG_PRINT("[GN]%s", tempBuff);
-
   handleDevCtrl((uint8_t*)&pDevCtrlPrms[devId].respParam, pDevCtrlPrms[devId].respParamSize);
   return status;
 }
@@ -924,17 +950,6 @@ STATUS startTrace(unsigned char *filename) {
     return SYSTEM_LINK_STATUS_EFAIL;
   }
 
-  /* Create data buffer and print it into file */
-  char tempBuff[2048] = { 0 };
-  int offset = 0;
-  for (unsigned int i = 0; i < pDevCtrlPrms[4].respParamSize; i++) {
-    int j = 0;
-    j = sprintf(&tempBuff[offset], "0x%02X ", pDevCtrlPrms[4].respParam[i]);
-    offset = offset + j;
-  }
-  sprintf(&tempBuff[offset], "\r\n");
-  DEBUG_PRINT("[GN]%s", tempBuff);
-
   handleDevCtrl((uint8_t*)&pDevCtrlPrms[4].respParam, pDevCtrlPrms[4].respParamSize);
   return status;
 }
@@ -958,17 +973,6 @@ STATUS stopTrace() {
     return SYSTEM_LINK_STATUS_EFAIL;
   }
 
-  /* Create data buffer and print it into file */
-  char tempBuff[2048] = { 0 };
-  int offset = 0;
-  for (unsigned int i = 0; i < pDevCtrlPrms[4].respParamSize; i++) {
-    int j = 0;
-    j = sprintf(&tempBuff[offset], "0x%02X ", pDevCtrlPrms[4].respParam[i]);
-    offset = offset + j;
-  }
-  sprintf(&tempBuff[offset], "\r\n");
-  DEBUG_PRINT("[GN]%s", tempBuff);
-
   handleDevCtrl((uint8_t*)&pDevCtrlPrms[4].respParam, pDevCtrlPrms[4].respParamSize);
   return status;
 }
@@ -993,17 +997,6 @@ STATUS showCPUStats() {
     return SYSTEM_LINK_STATUS_EFAIL;
   }
 
-  /* Create data buffer and print it into file */
-  char tempBuff[2048] = { 0 };
-  int offset = 0;
-  for (unsigned int i = 0; i < pDevCtrlPrms[4].respParamSize; i++) {
-    int j = 0;
-    j = sprintf(&tempBuff[offset], "0x%02X ", pDevCtrlPrms[4].respParam[i]);
-    offset = offset + j;
-  }
-  sprintf(&tempBuff[offset], "\r\n");
-  DEBUG_PRINT("[GN]%s", tempBuff);
-
   handleDevCtrl((uint8_t*)&pDevCtrlPrms[4].respParam, pDevCtrlPrms[4].respParamSize);
   return status;
 }
@@ -1032,17 +1025,6 @@ STATUS sendFramePeriodicitySync(unsigned int framePeriodicity) {
     return SYSTEM_LINK_STATUS_EFAIL;
   }
 
-  /* Create data buffer and print it into file */
-  char tempBuff[2048] = { 0 };
-  int offset = 0;
-  for (unsigned int i = 0; i < pDevCtrlPrms[4].respParamSize; i++) {
-    int j = 0;
-    j = sprintf(&tempBuff[offset], "0x%02X ", pDevCtrlPrms[4].respParam[i]);
-    offset = offset + j;
-  }
-  sprintf(&tempBuff[offset], "\r\n");
-  DEBUG_PRINT("[GN]%s", tempBuff);
-
   handleDevCtrl((uint8_t*)&pDevCtrlPrms[4].respParam, pDevCtrlPrms[4].respParamSize);
   return status;
 }
@@ -1067,17 +1049,6 @@ STATUS sendNumAllocatedFiles(unsigned int numAllocatedFiles) {
     return SYSTEM_LINK_STATUS_EFAIL;
   }
 
-  /* Create data buffer and print it into file */
-  char tempBuff[2048] = { 0 };
-  int offset = 0;
-  for (unsigned int i = 0; i < pDevCtrlPrms[4].respParamSize; i++) {
-    int j = 0;
-    j = sprintf(&tempBuff[offset], "0x%02X ", pDevCtrlPrms[4].respParam[i]);
-    offset = offset + j;
-  }
-  sprintf(&tempBuff[offset], "\r\n");
-  DEBUG_PRINT("[GN]%s", tempBuff);
-
   handleDevCtrl((uint8_t*)&pDevCtrlPrms[4].respParam, pDevCtrlPrms[4].respParamSize);
   return status;
 }
@@ -1102,17 +1073,6 @@ STATUS enableDataPackaging(unsigned int enablePackaging) {
     return SYSTEM_LINK_STATUS_EFAIL;
   }
 
-  /* Create data buffer and print it into file */
-  char tempBuff[2048] = { 0 };
-  int offset = 0;
-  for (unsigned int i = 0; i < pDevCtrlPrms[4].respParamSize; i++) {
-    int j = 0;
-    j = sprintf(&tempBuff[offset], "0x%02X ", pDevCtrlPrms[4].respParam[i]);
-    offset = offset + j;
-  }
-  sprintf(&tempBuff[offset], "\r\n");
-  DEBUG_PRINT("[GN]%s", tempBuff);
-
   handleDevCtrl((uint8_t*)&pDevCtrlPrms[4].respParam, pDevCtrlPrms[4].respParamSize);
   return status;
 }
@@ -1143,17 +1103,6 @@ STATUS setSessionDirectory(unsigned char *sessionDirectory) {
     return SYSTEM_LINK_STATUS_EFAIL;
   }
 
-  /* Create data buffer and print it into file */
-  char tempBuff[2048] = { 0 };
-  int offset = 0;
-  for (unsigned int i = 0; i < pDevCtrlPrms[4].respParamSize; i++) {
-    int j = 0;
-    j = sprintf(&tempBuff[offset], "0x%02X ", pDevCtrlPrms[4].respParam[i]);
-    offset = offset + j;
-  }
-  sprintf(&tempBuff[offset], "\r\n");
-  DEBUG_PRINT("[GN]%s", tempBuff);
-
   handleDevCtrl((uint8_t*)&pDevCtrlPrms[4].respParam, pDevCtrlPrms[4].respParamSize);
   return status;
 }
@@ -1183,18 +1132,6 @@ STATUS NumFramesToCapture(unsigned int numFrames) {
     return SYSTEM_LINK_STATUS_EFAIL;
   }
 
-  /* Create data buffer and print it into file */
-  char tempBuff[2048] = { 0 };
-  int offset = 0;
-  for (unsigned int i = 0; i < pDevCtrlPrms[4].respParamSize; i++)
-  {
-    int j = 0;
-    j = sprintf(&tempBuff[offset], "0x%02X ", pDevCtrlPrms[4].respParam[i]);
-    offset = offset + j;
-  }
-  sprintf(&tempBuff[offset], "\r\n");
-  DEBUG_PRINT("[GN]%s", tempBuff);
-
   handleDevCtrl((uint8_t*)&pDevCtrlPrms[4].respParam, pDevCtrlPrms[4].respParamSize);
   return status;
 }
@@ -1212,6 +1149,7 @@ STATUS NumFramesToCapture(unsigned int numFrames) {
 */
 STATUS spiWriteToDevice(TDADevHandle_t hdl, unsigned char *data, unsigned short ByteCount) {
   TDADevCtx_t*    pDevCtx = (TDADevCtx_t*)hdl;
+  uint64_t profStart = TDA_PROF_START();
   TDALockDevice(pDevCtx);
   uint8_t devSelection = createDevMapFromDevId(pDevCtx->deviceIndex);
   int32_t status = SYSTEM_LINK_STATUS_SOK;
@@ -1241,19 +1179,9 @@ STATUS spiWriteToDevice(TDADevHandle_t hdl, unsigned char *data, unsigned short
             pDevCtrlPrms[pDevCtx->deviceIndex].respParamSize);	
 
   TDAUnlockDevice(pDevCtx);
-
-  /* Create data buffer and print it into file */
-  char tempBuff[2048] = { 0 };
-  int offset = 0;
-  for (unsigned int i = 0; i < pDevCtrlPrms[pDevCtx->deviceIndex].respParamSize; i = i + 2) {
-    int j = 0;
-    j = sprintf(&tempBuff[offset], "0x%02X%02X ", \
-          pDevCtrlPrms[pDevCtx->deviceIndex].respParam[i + 1], \
-          pDevCtrlPrms[pDevCtx->deviceIndex].respParam[i]);
-    offset = offset + j;
+  if (profStart != 0U) {
+    TDAProfMsgWrite(pDevCtx->deviceIndex, data, ByteCount, profStart, TDAProfNow());
   }
-  sprintf(&tempBuff[offset], "\r\n");
-  DEBUG_PRINT("Device [%d] [WR]%s", pDevCtx->deviceIndex, tempBuff);
 
   return ByteCount;
 }
@@ -1271,9 +1199,22 @@ STATUS spiWriteToDevice(TDADevHandle_t hdl, unsigned char *data, unsigned short
 */
 STATUS spiReadFromDevice(TDADevHandle_t hdl, unsigned char *data, unsigned short ByteCount) {
   TDADevCtx_t*    pDevCtx = (TDADevCtx_t*)hdl;
+  uint64_t profStart = TDA_PROF_START();
   TDALockDevice(pDevCtx);
   uint8_t devSelection = createDevMapFromDevId(pDevCtx->deviceIndex);
   int32_t status = SYSTEM_LINK_STATUS_SOK;
+  TDASpiRxCompletion_t* pRx = &gSpiRxCompletion[pDevCtx->deviceIndex];
+  int32_t rxLength;
+  struct timespec ts;
+
+  /* Register the destination before the request so that the Rx thread
+    can copy the answer directly into the caller's buffer */
+  pthread_mutex_lock(&pRx->lock);
+  pRx->dest = data;
+  pRx->destSize = ByteCount;
+  pRx->length = 0;
+  pRx->done = 0;
+  pthread_mutex_unlock(&pRx->lock);
 
   pDataPacket[pDevCtx->deviceIndex].devSelection = devSelection;
   pDataPacket[pDevCtx->deviceIndex].ackType = ACK_ON_PROCESS;
@@ -1283,36 +1224,44 @@ STATUS spiReadFromDevice(TDADevHandle_t hdl, unsigned char *data, unsigned short
     (uint8_t*)&ByteCount);
   if (status != SYSTEM_LINK_STATUS_SOK) {
     DEBUG_PRINT("# ERROR: Ethernet packet formation failed\n");
+    pthread_mutex_lock(&pRx->lock);
+    pRx->dest = NULL;
+    pthread_mutex_unlock(&pRx->lock);
+    TDAUnlockDevice(pDevCtx);
     return SYSTEM_LINK_STATUS_EFAIL;
   }
   handleDevCtrl((uint8_t*)&pDevCtrlPrms[pDevCtx->deviceIndex].respParam, \
             pDevCtrlPrms[pDevCtx->deviceIndex].respParamSize);	
 
   //Wait till data is read by TDA
-  while (gSpiRxSignal[pDevCtx->deviceIndex] == 0) { Sleep(1); }
+  clock_gettime(CLOCK_REALTIME, &ts);
+  ts.tv_sec += TDA_SPI_READ_TIMEOUT_MS / 1000;
+  ts.tv_nsec += (TDA_SPI_READ_TIMEOUT_MS % 1000) * 1000000L;
+  if (ts.tv_nsec >= 1000000000L) {
+    ts.tv_sec++;
+    ts.tv_nsec -= 1000000000L;
+  }
 
-  if (gSpiRxSignal[pDevCtx->deviceIndex] == 1) {
-    (void)memcpy(data, gSpiRxData[pDevCtx->deviceIndex], \
-   gSpiRxLength[pDevCtx->deviceIndex]);
-    gSpiRxSignal[pDevCtx->deviceIndex] = 0;
+  pthread_mutex_lock(&pRx->lock);
+  while (pRx->done == 0) {
+    if (pthread_cond_timedwait(&pRx->cond, &pRx->lock, &ts) == ETIMEDOUT) break;
   }
+  rxLength = (pRx->done != 0) ? (int32_t)pRx->length : SYSTEM_LINK_STATUS_EFAIL;
+  pRx->dest = NULL;
+  pthread_mutex_unlock(&pRx->lock);
 
   TDAUnlockDevice(pDevCtx);
 
-  /* Create data buffer and print it into file */
-  char tempBuff[2048] = { 0 };
-  int offset = 0;
-  for (unsigned int i = 0; i < gSpiRxLength[pDevCtx->deviceIndex]; i = i + 2) {
-    int j = 0;
-    j = sprintf(&tempBuff[offset], "0x%02X%02X ", \
-          *(gSpiRxData[pDevCtx->deviceIndex] + i + 1), \
-          *(gSpiRxData[pDevCtx->deviceIndex] + i));
-    offset = offset + j;
+  if (rxLength < 0) {
+    DEBUG_PRINT("# ERROR: SPI read timed out on device %d\n", pDevCtx->deviceIndex);
+    TDATraceDump();
+    return SYSTEM_LINK_STATUS_EFAIL;
+  }
+  if (profStart != 0U) {
+    TDAProfMsgRead(pDevCtx->deviceIndex, profStart, TDAProfNow());
   }
-  sprintf(&tempBuff[offset], "\r\n");
-  DEBUG_PRINT("Device [%d] [RD]%s", pDevCtx->deviceIndex, tempBuff);
 
-  return gSpiRxLength[pDevCtx->deviceIndex];
+  return rxLength;
 }
 
 
@@ -1341,18 +1290,6 @@ STATUS resetDevice(TDADevHandle_t hdl) {
     return SYSTEM_LINK_STATUS_EFAIL;
   }
 
-  /* Create data buffer and print it into file */
-  char tempBuff[2048] = { 0 };
-  int offset = 0;
-  for (unsigned int i = 0; i < pDevCtrlPrms[pDevCtx->deviceIndex].respParamSize; i++) {
-    int j = 0;
-    j = sprintf(&tempBuff[offset], "0x%02X ", \
-          pDevCtrlPrms[pDevCtx->deviceIndex].respParam[i]);
-    offset = offset + j;
-  }
-  sprintf(&tempBuff[offset], "\r\n");
-  DEBUG_PRINT("Device [%d] [GN]%s", pDevCtx->deviceIndex, tempBuff);
-
   handleDevCtrl(
     (uint8_t*)&pDevCtrlPrms[pDevCtx->deviceIndex].respParam,
     pDevCtrlPrms[pDevCtx->deviceIndex].respParamSize
@@ -1384,18 +1321,6 @@ STATUS setSOPMode(TDADevHandle_t hdl, uint32_t SOPmode) {
     return SYSTEM_LINK_STATUS_EFAIL;
   }
 
-  /* Create data buffer and print it into file */
-  char tempBuff[2048] = { 0 };
-  int offset = 0;
-  for (unsigned int i = 0; i < pDevCtrlPrms[pDevCtx->deviceIndex].respParamSize; i++) {
-    int j = 0;
-    j = sprintf(&tempBuff[offset], "0x%02X ", \
-          pDevCtrlPrms[pDevCtx->deviceIndex].respParam[i]);
-    offset = offset + j;
-  }
-  sprintf(&tempBuff[offset], "\r\n");
-  DEBUG_PRINT("Device [%d] [GN]%s", pDevCtx->deviceIndex, tempBuff);
-
   handleDevCtrl((uint8_t*)&pDevCtrlPrms[pDevCtx->deviceIndex].respParam, \
             pDevCtrlPrms[pDevCtx->deviceIndex].respParamSize);
   return status;
@@ -1424,18 +1349,6 @@ STATUS getSOPMode(TDADevHandle_t hdl) {
     return SYSTEM_LINK_STATUS_EFAIL;
   }
 
-  /* Create data buffer and print it into file */
-  char tempBuff[2048] = { 0 };
-  int offset = 0;
-  for (unsigned int i = 0; i < pDevCtrlPrms[pDevCtx->deviceIndex].respParamSize; i++) {
-    int j = 0;
-    j = sprintf(&tempBuff[offset], "0x%02X ", \
-          pDevCtrlPrms[pDevCtx->deviceIndex].respParam[i]);
-    offset = offset + j;
-  }
-  sprintf(&tempBuff[offset], "\r\n");
-  DEBUG_PRINT("Device [%d] [GN]%s", pDevCtx->deviceIndex, tempBuff);
-
   handleDevCtrl((uint8_t*)&pDevCtrlPrms[pDevCtx->deviceIndex].respParam, \
             pDevCtrlPrms[pDevCtx->deviceIndex].respParamSize);
   return status;
@@ -1474,18 +1387,6 @@ STATUS gpioGetValue(unsigned int DeviceMap, unsigned int gpioBase, unsigned int
     return SYSTEM_LINK_STATUS_EFAIL;
   }
 
-  /* Create data buffer and print it into file */
-  char tempBuff[2048] = { 0 };
-  int offset = 0;
-  for (unsigned int i = 0; i < pDevCtrlPrms[pDevCtx->deviceIndex].respParamSize; i++) {
-    int j = 0;
-    j = sprintf(&tempBuff[offset], "0x%02X ", \
-          pDevCtrlPrms[pDevCtx->deviceIndex].respParam[i]);
-    offset = offset + j;
-  }
-  sprintf(&tempBuff[offset], "\r\n");
-  DEBUG_PRINT("Device [%d] [GN]%s", pDevCtx->deviceIndex, tempBuff);
-
   handleDevCtrl((uint8_t*)&pDevCtrlPrms[pDevCtx->deviceIndex].respParam, \
             pDevCtrlPrms[pDevCtx->deviceIndex].respParamSize);
   return status;
@@ -1530,18 +1431,6 @@ STATUS gpioSetValue(unsigned int DeviceMap, unsigned int gpioBase, unsigned int
     return SYSTEM_LINK_STATUS_EFAIL;
   }
 
-  /* Create data buffer and print it into file */
-  char tempBuff[2048] = { 0 };
-  int offset = 0;
-  for (unsigned int i = 0; i < pDevCtrlPrms[pDevCtx->deviceIndex].respParamSize; i++) {
-    int j = 0;
-    j = sprintf(&tempBuff[offset], "0x%02X ", \
-          pDevCtrlPrms[pDevCtx->deviceIndex].respParam[i]);
-    offset = offset + j;
-  }
-  sprintf(&tempBuff[offset], "\r\n");
-  DEBUG_PRINT("Device [%d] [GN]%s", pDevCtx->deviceIndex, tempBuff);
-
   handleDevCtrl((uint8_t*)&pDevCtrlPrms[pDevCtx->deviceIndex].respParam, \
             pDevCtrlPrms[pDevCtx->deviceIndex].respParamSize);
   return status;
@@ -1566,17 +1455,6 @@ STATUS startRecord() {
     return SYSTEM_LINK_STATUS_EFAIL;
   }
 
-  /* Create data buffer and print it into file */
-  char tempBuff[2048] = { 0 };
-  int offset = 0;
-  for (unsigned int i = 0; i < pDevCtrlPrms[4].respParamSize; i++) {
-    int j = 0;
-    j = sprintf(&tempBuff[offset], "0x%02X ", pDevCtrlPrms[4].respParam[i]);
-    offset = offset + j;
-  }
-  sprintf(&tempBuff[offset], "\r\n");
-  DEBUG_PRINT("[GN]%s", tempBuff);
-
   handleDevCtrl((uint8_t*)&pDevCtrlPrms[4].respParam, pDevCtrlPrms[4].respParamSize);
   return status;
 }
@@ -1604,17 +1482,6 @@ STATUS stopRecord() {
     return SYSTEM_LINK_STATUS_EFAIL;
   }
 
-  /* Create data buffer and print it into file */
-  char tempBuff[2048] = { 0 };
-  int offset = 0;
-  for (unsigned int i = 0; i < pDevCtrlPrms[4].respParamSize; i++) {
-    int j = 0;
-    j = sprintf(&tempBuff[offset], "0x%02X ", pDevCtrlPrms[4].respParam[i]);
-    offset = offset + j;
-  }
-  sprintf(&tempBuff[offset], "\r\n");
-  DEBUG_PRINT("[GN]%s", tempBuff);
-
   handleDevCtrl((uint8_t*)&pDevCtrlPrms[4].respParam, pDevCtrlPrms[4].respParamSize);
   return status;
 }
@@ -1842,6 +1709,11 @@ void TDACommIRQUnMask(TDADevHandle_t hdl) {
   TDALockDevice(pDevCtx);
   pDevCtx->irqMasked = FALSE;
   TDAUnlockDevice(pDevCtx);
+
+  /* The host IRQ is level triggered: re-signal a line still high */
+  if ((gTDA_IrqMode == TDA_IRQ_MODE_EVENT) && (pDevCtx->hostIrqRxHigh == 1)) {
+    sem_post(&gTDA_HostIrqEvent);
+  }
 }
 
 
@@ -1850,6 +1722,11 @@ int TDADeviceWaitIrqStatus(TDADevHandle_t hdl, unsigned char level) {
   int loopCount = 0;
   int maxLoopCounts = 0xFFFF;
 
+  /* No need to wait when the line is already low */
+  if ((gTDA_IrqMode == TDA_IRQ_MODE_EVENT) && (pDevCtx->hostIrqRxHigh == 0)) {
+    return RLS_RET_CODE_OK;
+  }
+
   do {
     Sleep(1);
     loopCount++;
@@ -1922,6 +1799,68 @@ void* TDAPollingThreadEntrySpi(void* pParam) {
 }
 
 
+/** @fn void* TDAEventThreadEntrySpi(void* pParam)
+*
+*   @brief Host IRQ dispatch thread in event mode
+*   @param[in] pParam - device context of the master device
+*
+*   Block on the host IRQ event posted by the Rx thread and call the
+*   handler of every enabled device having its IRQ line high. The wait
+*   times out periodically to rescan the lines and check for exit. Only one
+*   dispatch thread runs: the line of a device is cleared atomically before
+*   its handler is called, so that each host IRQ is dispatched once.
+*/
+void* TDAEventThreadEntrySpi(void* pParam) {
+  TDADevCtx_t* pDevCtx = (TDADevCtx_t*)pParam;
+  struct timespec ts;
+
+  TDA_HostIntrThreadLoop[pDevCtx->deviceIndex] = 1;
+  TDA_NumOfRunningSPIThreads++;
+
+  while (TDA_HostIntrThreadLoop[0]) {
+    clock_gettime(CLOCK_REALTIME, &ts);
+    ts.tv_nsec += TDA_IRQ_EVENT_RESCAN_MS * 1000000L;
+    if (ts.tv_nsec >= 1000000000L) {
+      ts.tv_sec++;
+      ts.tv_nsec -= 1000000000L;
+    }
+    sem_timedwait(&gTDA_HostIrqEvent, &ts);
+
+    for (unsigned int devId = 0; devId < TDA_NUM_CONNECTED_DEVICES_MAX; devId++) {
+      pDevCtx = &gTDA_devCtx[devId];
+      if ((!pDevCtx->deviceEnabled) || (NULL == pDevCtx->hostIntrThread.handler) || \
+        (pDevCtx->irqMasked)) {
+        continue;
+      }
+      /* Consume the IRQ, set again by the next HOST_IRQ_HIGH response */
+      if (0 == __atomic_exchange_n(&pDevCtx->hostIrqRxHigh, 0, __ATOMIC_ACQ_REL)) {
+        continue;
+      }
+      pDevCtx->hostIntrThread.handler(pDevCtx->deviceIndex, (TDADevHandle_t)pDevCtx);
+    }
+  }
+  TDA_NumOfRunningSPIThreads--;
+  return NULL; // RLS_RET_CODE_OK
+}
+
+
+/** @fn void TDASetIrqMode(uint8_t mode)
+*
+*   @brief Select how host IRQs are dispatched to mmWaveLink
+*   @param[in] mode - TDA_IRQ_MODE_POLLING or TDA_IRQ_MODE_EVENT
+*
+*   Must be called before the devices are enabled.
+*/
+void TDASetIrqMode(uint8_t mode) {
+  gTDA_IrqMode = (mode == TDA_IRQ_MODE_EVENT) ? TDA_IRQ_MODE_EVENT : TDA_IRQ_MODE_POLLING;
+}
+
+
+uint8_t TDAGetIrqMode(void) {
+  return gTDA_IrqMode;
+}
+
+
 int TDAStartIrqPollingThread(TDADevCtx_t* pDevCtx) {
   int             error = RLS_RET_CODE_OK;
   pthread_t currThread = pthread_self();
@@ -1936,13 +1875,22 @@ int TDAStartIrqPollingThread(TDADevCtx_t* pDevCtx) {
     }
   }
 
+  /* A single event dispatch thread serves all the devices: keep it running */
+  if ((gTDA_IrqMode == TDA_IRQ_MODE_EVENT) && (0 != pDevCtx->hostIntrThread.threadHdl)) {
+    return RLS_RET_CODE_OK;
+  }
+
   TDA_HostIntrThreadLoop[pDevCtx->deviceIndex] = 0;
 
-  /* Host IRQ Polling Thread for SPI */
+  /* Host IRQ Polling Thread for SPI (the event is initialized at connection) */
+  void* (*threadEntry)(void*) = TDAPollingThreadEntrySpi;
+  if (gTDA_IrqMode == TDA_IRQ_MODE_EVENT) {
+    threadEntry = TDAEventThreadEntrySpi;
+  }
 
   if (0 == pDevCtx->hostIntrThread.threadHdl) {
     /* Create Host IRQ Polling Thread */
-    pthread_create(&pDevCtx->hostIntrThread.threadHdl, NULL, TDAPollingThreadEntrySpi, pDevCtx);
+    pthread_create(&pDevCtx->hostIntrThread.threadHdl, NULL, threadEntry, pDevCtx);
   }
   else {
     TDALockDevice(pDevCtx);
@@ -1951,7 +1899,7 @@ int TDAStartIrqPollingThread(TDADevCtx_t* pDevCtx) {
       Sleep(200);
     }
 
-    pthread_create(&pDevCtx->hostIntrThread.threadHdl, NULL, TDAPollingThreadEntrySpi, pDevCtx);
+    pthread_create(&pDevCtx->hostIntrThread.threadHdl, NULL, threadEntry, pDevCtx);
     TDAUnlockDevice(pDevCtx);
   }
 
@@ -1972,6 +1920,8 @@ int TDAStopIrqPollingThread(TDADevCtx_t* pDevCtx) {
   }
 
   TDA_HostIntrThreadLoop[pDevCtx->deviceIndex] = 0;
+  /* Wake up the event dispatch thread so that it sees the exit request */
+  if (gTDA_IrqMode == TDA_IRQ_MODE_EVENT) sem_post(&gTDA_HostIrqEvent);
 
   if (pDevCtx->hostIntrThread.threadHdl && !pthread_equal(pDevCtx->hostIntrThread.threadHdl, currThread)) {
     /* Wait for polling thread to terminate */
@@ -2061,12 +2011,18 @@ int Network_connect(Network_SockObj *pObj, char *ipAddr, uint32_t port) {
 
   socklen_t optlen = sizeof(flags);
 
-  int status = setsockopt(pObj->clientSocketId, IPPROTO_TCP, SO_KEEPALIVE, &flags, optlen);
+  int status = setsockopt(pObj->clientSocketId, SOL_SOCKET, SO_KEEPALIVE, &flags, optlen);
   flags = keepaliveIntervalSec;
-  status &= setsockopt(pObj->clientSocketId, IPPROTO_TCP, TCP_KEEPIDLE, &flags, optlen);
-  status &= setsockopt(pObj->clientSocketId, IPPROTO_TCP, TCP_KEEPINTVL, &flags, optlen);
+  status |= setsockopt(pObj->clientSocketId, IPPROTO_TCP, TCP_KEEPIDLE, &flags, optlen);
+  status |= setsockopt(pObj->clientSocketId, IPPROTO_TCP, TCP_KEEPINTVL, &flags, optlen);
   flags = keepaliveProbeCount;
-  status &= setsockopt(pObj->clientSocketId, IPPROTO_TCP, TCP_KEEPCNT, &flags, optlen);
+  status |= setsockopt(pObj->clientSocketId, IPPROTO_TCP, TCP_KEEPCNT, &flags, optlen);
+
+  /* Commands are small and latency bound: send them without Nagle delay */
+  flags = 1;
+  status |= setsockopt(pObj->clientSocketId, IPPROTO_TCP, TCP_NODELAY, &flags, optlen);
+  flags = NETWORK_TX_SOCKET_BUFFER_SIZE;
+  status |= setsockopt(pObj->clientSocketId, SOL_SOCKET, SO_SNDBUF, &flags, optlen);
 
   if (status) {
     DEBUG_PRINT("# ERROR: setsocketopt(), TCP_NODELAY");
@@ -2159,6 +2115,68 @@ int Network_write(Network_SockObj *pObj, uint8_t *dataBuf, uint32_t dataSize) {
 }
 
 
+/** @fn int Network_writev(Network_SockObj *pObj, struct iovec *iov, int iovCnt)
+*
+*   @brief Write a set of buffers to the socket with a single system call
+*   @param[in] pObj - network socket object
+*   @param[in] iov - buffers to send, consumed on partial writes
+*   @param[in] iovCnt - number of buffers
+*
+*   @return int Success - 0, Failure - Error Code
+*/
+int Network_writev(Network_SockObj *pObj, struct iovec *iov, int iovCnt) {
+  struct msghdr msg = { 0 };
+
+  msg.msg_iov = iov;
+  msg.msg_iovlen = iovCnt;
+
+  while (msg.msg_iovlen > 0) {
+    ssize_t actDataSize = sendmsg(pObj->clientSocketId, &msg, MSG_NOSIGNAL);
+
+    if (actDataSize < 0 && errno == EINTR)
+      continue;
+    if (actDataSize <= 0) {
+      DEBUG_PRINT("ERROR: send failed in Network_writev!\n");
+      return RLS_RET_CODE_EFAIL;
+    }
+    /* Skip what has been sent, a partial write resumes inside a buffer */
+    while (msg.msg_iovlen > 0 && (size_t)actDataSize >= msg.msg_iov->iov_len) {
+      actDataSize -= msg.msg_iov->iov_len;
+      msg.msg_iov++;
+      msg.msg_iovlen--;
+    }
+    if (msg.msg_iovlen > 0) {
+      msg.msg_iov->iov_base = (uint8_t*)msg.msg_iov->iov_base + actDataSize;
+      msg.msg_iov->iov_len -= actDataSize;
+    }
+  }
+  return 0;
+}
+
+
+/** @fn int Network_cork(Network_SockObj *pObj, uint8_t enable)
+*
+*   @brief Hold back (enable) or flush (disable) the outgoing segments
+*   @param[in] pObj - network socket object
+*   @param[in] enable - 1 to accumulate the following writes, 0 to flush them
+*
+*   Used to coalesce a burst of commands addressed to different devices
+*   into as few segments as possible. The kernel flushes a corked socket
+*   after 200 ms, so a burst must be closed before waiting for a response.
+*
+*   @return int Success - 0, Failure - Error Code
+*/
+int Network_cork(Network_SockObj *pObj, uint8_t enable) {
+  int flags = enable ? 1 : 0;
+
+  if (setsockopt(pObj->clientSocketId, IPPROTO_TCP, TCP_CORK, &flags, sizeof(flags))) {
+    DEBUG_PRINT("# ERROR: setsocketopt(), TCP_CORK");
+    return RLS_RET_CODE_EFAIL;
+  }
+  return 0;
+}
+
+
 int32_t Network_waitRead(Network_SockObj *pObj) {
   int             status;
   fd_set          master_set;
@@ -2212,6 +2230,7 @@ int CloseConnection() {
 
 int SendCommand(void *params, int prmSize) {
   NetworkTDA_CmdHeader cmdHeader;
+  struct iovec iov[2];
   int status;
 
   memset(&cmdHeader, 0, sizeof(cmdHeader));
@@ -2222,13 +2241,13 @@ int SendCommand(void *params, int prmSize) {
     return -1;
   }
 
-  status = Network_write(&gNetwork_SockObj, (uint8_t*)&cmdHeader, sizeof(cmdHeader));
-  if (status < 0) {
-    DEBUG_PRINT("# ERROR: Could not write header\n");
-    return status;
-  }
+  /* Header and params leave in the same segment */
+  iov[0].iov_base = &cmdHeader;
+  iov[0].iov_len = sizeof(cmdHeader);
+  iov[1].iov_base = params;
+  iov[1].iov_len = prmSize;
 
-  status = Network_write(&gNetwork_SockObj, (uint8_t*)params, prmSize);
+  status = Network_writev(&gNetwork_SockObj, iov, 2);
 
   if (status < 0) {
     DEBUG_PRINT("# ERROR: Could not send data \n");
@@ -2239,6 +2258,23 @@ int SendCommand(void *params, int prmSize) {
 }
 
 
+/** @fn int TDACorkCommands(uint8_t enable)
+*
+*   @brief Start (1) or close (0) a burst of commands sent as one segment
+*   @param[in] enable - 1 to start the burst, 0 to flush it
+*
+*   @return int Success - 0, Failure - Error Code
+*/
+int TDACorkCommands(uint8_t enable) {
+  int status;
+
+  pthread_mutex_lock(&gNetwork_Write_cs);
+  status = Network_cork(&gNetwork_SockObj, enable);
+  pthread_mutex_unlock(&gNetwork_Write_cs);
+  return status;
+}
+
+
 int RecvResponseParams(uint8_t *pPrm, uint32_t prmSize) {
   int status;
 
@@ -2277,6 +2313,12 @@ int RecvResponse(uint32_t *prmSize) {
 
 
 void handleDevCtrl(uint8_t *pDataBuf, uint32_t size) {
+  Radar_EthDataPacketPrms* pPacket = (Radar_EthDataPacketPrms*)pDataBuf;
+
+  TDATraceRecord(TDA_TRACE_DIR_TX, pPacket->devSelection, pPacket->opcode, 0,
+    pPacket->data, (pPacket->dataLength > DATA_HEADER_LENGTH) ?
+      (pPacket->dataLength - DATA_HEADER_LENGTH) : 0);
+
   pthread_mutex_lock(&gNetwork_Write_cs);
   SendCommand(pDataBuf, size);
   pthread_mutex_unlock(&gNetwork_Write_cs);
@@ -2285,272 +2327,11 @@ void handleDevCtrl(uint8_t *pDataBuf, uint32_t size) {
 
 /********************** Computation of CRC *********************/
 
-const uint16_t  hCrc16Table[BSPDRV_AR12XX_CRC_M_CRC_TABLE_SIZE] = { \
-  0x0000U,     \
-  0x1021U,     \
-  0x2042U,     \
-  0x3063U,     \
-  0x4084U,     \
-  0x50A5U,     \
-  0x60C6U,     \
-  0x70E7U,     \
-  0x8108U,     \
-  0x9129U,     \
-  0xA14AU,     \
-  0xB16BU,     \
-  0xC18CU,     \
-  0xD1ADU,     \
-  0xE1CEU,     \
-  0xF1EFU,     \
-  0x1231U,     \
-  0x0210U,     \
-  0x3273U,     \
-  0x2252U,     \
-  0x52B5U,     \
-  0x4294U,     \
-  0x72F7U,     \
-  0x62D6U,     \
-  0x9339U,     \
-  0x8318U,     \
-  0xB37BU,     \
-  0xA35AU,     \
-  0xD3BDU,     \
-  0xC39CU,     \
-  0xF3FFU,     \
-  0xE3DEU,     \
-  0x2462U,     \
-  0x3443U,     \
-  0x0420U,     \
-  0x1401U,     \
-  0x64E6U,     \
-  0x74C7U,     \
-  0x44A4U,     \
-  0x5485U,     \
-  0xA56AU,     \
-  0xB54BU,     \
-  0x8528U,     \
-  0x9509U,     \
-  0xE5EEU,     \
-  0xF5CFU,     \
-  0xC5ACU,     \
-  0xD58DU,     \
-  0x3653U,     \
-  0x2672U,     \
-  0x1611U,     \
-  0x0630U,     \
-  0x76D7U,     \
-  0x66F6U,     \
-  0x5695U,     \
-  0x46B4U,     \
-  0xB75BU,     \
-  0xA77AU,     \
-  0x9719U,     \
-  0x8738U,     \
-  0xF7DFU,     \
-  0xE7FEU,     \
-  0xD79DU,     \
-  0xC7BCU,     \
-  0x48C4U,     \
-  0x58E5U,     \
-  0x6886U,     \
-  0x78A7U,     \
-  0x0840U,     \
-  0x1861U,     \
-  0x2802U,     \
-  0x3823U,     \
-  0xC9CCU,     \
-  0xD9EDU,     \
-  0xE98EU,     \
-  0xF9AFU,     \
-  0x8948U,     \
-  0x9969U,     \
-  0xA90AU,     \
-  0xB92BU,     \
-  0x5AF5U,     \
-  0x4AD4U,     \
-  0x7AB7U,     \
-  0x6A96U,     \
-  0x1A71U,     \
-  0x0A50U,     \
-  0x3A33U,     \
-  0x2A12U,     \
-  0xDBFDU,     \
-  0xCBDCU,     \
-  0xFBBFU,     \
-  0xEB9EU,     \
-  0x9B79U,     \
-  0x8B58U,     \
-  0xBB3BU,     \
-  0xAB1AU,     \
-  0x6CA6U,     \
-  0x7C87U,     \
-  0x4CE4U,     \
-  0x5CC5U,     \
-  0x2C22U,     \
-  0x3C03U,     \
-  0x0C60U,     \
-  0x1C41U,     \
-  0xEDAEU,     \
-  0xFD8FU,     \
-  0xCDECU,     \
-  0xDDCDU,     \
-  0xAD2AU,     \
-  0xBD0BU,     \
-  0x8D68U,     \
-  0x9D49U,     \
-  0x7E97U,     \
-  0x6EB6U,     \
-  0x5ED5U,     \
-  0x4EF4U,     \
-  0x3E13U,     \
-  0x2E32U,     \
-  0x1E51U,     \
-  0x0E70U,     \
-  0xFF9FU,     \
-  0xEFBEU,     \
-  0xDFDDU,     \
-  0xCFFCU,     \
-  0xBF1BU,     \
-  0xAF3AU,     \
-  0x9F59U,     \
-  0x8F78U,     \
-  0x9188U,     \
-  0x81A9U,     \
-  0xB1CAU,     \
-  0xA1EBU,     \
-  0xD10CU,     \
-  0xC12DU,     \
-  0xF14EU,     \
-  0xE16FU,     \
-  0x1080U,     \
-  0x00A1U,     \
-  0x30C2U,     \
-  0x20E3U,     \
-  0x5004U,     \
-  0x4025U,     \
-  0x7046U,     \
-  0x6067U,     \
-  0x83B9U,     \
-  0x9398U,     \
-  0xA3FBU,     \
-  0xB3DAU,     \
-  0xC33DU,     \
-  0xD31CU,     \
-  0xE37FU,     \
-  0xF35EU,     \
-  0x02B1U,     \
-  0x1290U,     \
-  0x22F3U,     \
-  0x32D2U,     \
-  0x4235U,     \
-  0x5214U,     \
-  0x6277U,     \
-  0x7256U,     \
-  0xB5EAU,     \
-  0xA5CBU,     \
-  0x95A8U,     \
-  0x8589U,     \
-  0xF56EU,     \
-  0xE54FU,     \
-  0xD52CU,     \
-  0xC50DU,     \
-  0x34E2U,     \
-  0x24C3U,     \
-  0x14A0U,     \
-  0x0481U,     \
-  0x7466U,     \
-  0x6447U,     \
-  0x5424U,     \
-  0x4405U,     \
-  0xA7DBU,     \
-  0xB7FAU,     \
-  0x8799U,     \
-  0x97B8U,     \
-  0xE75FU,     \
-  0xF77EU,     \
-  0xC71DU,     \
-  0xD73CU,     \
-  0x26D3U,     \
-  0x36F2U,     \
-  0x0691U,     \
-  0x16B0U,     \
-  0x6657U,     \
-  0x7676U,     \
-  0x4615U,     \
-  0x5634U,     \
-  0xD94CU,     \
-  0xC96DU,     \
-  0xF90EU,     \
-  0xE92FU,     \
-  0x99C8U,     \
-  0x89E9U,     \
-  0xB98AU,     \
-  0xA9ABU,     \
-  0x5844U,     \
-  0x4865U,     \
-  0x7806U,     \
-  0x6827U,     \
-  0x18C0U,     \
-  0x08E1U,     \
-  0x3882U,     \
-  0x28A3U,     \
-  0xCB7DU,     \
-  0xDB5CU,     \
-  0xEB3FU,     \
-  0xFB1EU,     \
-  0x8BF9U,     \
-  0x9BD8U,     \
-  0xABBBU,     \
-  0xBB9AU,     \
-  0x4A75U,     \
-  0x5A54U,     \
-  0x6A37U,     \
-  0x7A16U,     \
-  0x0AF1U,     \
-  0x1AD0U,     \
-  0x2AB3U,     \
-  0x3A92U,     \
-  0xFD2EU,     \
-  0xED0FU,     \
-  0xDD6CU,     \
-  0xCD4DU,     \
-  0xBDAAU,     \
-  0xAD8BU,     \
-  0x9DE8U,     \
-  0x8DC9U,     \
-  0x7C26U,     \
-  0x6C07U,     \
-  0x5C64U,     \
-  0x4C45U,     \
-  0x3CA2U,     \
-  0x2C83U,     \
-  0x1CE0U,     \
-  0x0CC1U,     \
-  0xEF1FU,     \
-  0xFF3EU,     \
-  0xCF5DU,     \
-  0xDF7CU,     \
-  0xAF9BU,     \
-  0xBFBAU,     \
-  0x8FD9U,     \
-  0x9FF8U,     \
-  0x6E17U,     \
-  0x7E36U,     \
-  0x4E55U,     \
-  0x5E74U,     \
-  0x2E93U,     \
-  0x3EB2U,     \
-  0x0ED1U,     \
-  0x1EF0U      \
-};
-
 /** @fn int32_t Bsp_ar12xxComputeCrc(uint8_t* wMbDataBaseAdd, uint32_t hNBytes,
 *  		 uint8_t crcLen, uint8_t* outCrc);
 *
-*   @brief Computes CRC16-CCITT computation. \n
-*		   The mailbox data is is read 64bits (8 bytes) at one shot using LDMA
-*		   instruction to reduce the access time, each bytes of the message is 
-*		   passed to LUT based CRC algorithm. \n
+*   @brief Computes CRC16-CCITT computation with the slice-by-8 CRC
+*          engine (mmwl_crc.c). \n
 *   @param[in] wMbDataBaseAdd - The message data source base address
 *   @param[in] hNBytes - Num of bytes to read for CRC computation
 *   @param[in] crcLen - Length/Type of CRC
@@ -2563,101 +2344,24 @@ int32_t Bsp_ar12xxComputeCrc(uint8_t* wMbDataBaseAdd,
   uint8_t  crcLen,
   uint8_t* outCrc)
 {
-  uint16_t      hRemainder = (uint16_t)BSPDRV_AR12XX_CRC_INITIAL_REMAINDER;
-  uint64_t      lDData;
-  uint32_t      lDData_temp;
-
-  uint16_t      hIndex;
-  uint16_t      hNDoubleWords;
-  uint8_t       cNRemainderBytes;
-  uint8_t       cData;
-  uint8_t       cByte;
-  int32_t       retVal = BSP_SOK;
+  uint16_t      hRemainder;
 
   /* The length can not be zero */
   if (BSPDRV_AR12XX_CRC_M_ZERO == hNBytes)
   {
-    retVal = BSP_EBADARGS;
+    return BSP_EBADARGS;
   }
-  if (retVal == BSP_SOK)
-  {
-    /* To reduce MB access time perform 32 bit bus access at a time */
-    /* Num of double words -  8 bytes */
-    hNDoubleWords = (uint16_t)(hNBytes >> BSPDRV_AR12XX_CRC_M_TWO);
-    /* Num of bytes less than 4 bytes */
-    cNRemainderBytes = (uint8_t)(hNBytes & BSPDRV_AR12XX_CRC_M_THREE);
-
-    /* Read 8 bytes at a time and perform CRC calculation */
-    for (hIndex = BSPDRV_AR12XX_CRC_M_ZERO; hIndex < hNDoubleWords; hIndex++)
-    {
-      /*
-        * Read 64 bit data from MB in little-endian mode
-        * - the first byte of the message is in LSB
-        */
-      lDData_temp = BSPDRV_AR12XX_CRC_M_REG_READ32(wMbDataBaseAdd);
-      lDData = (uint64_t)lDData_temp;
-      wMbDataBaseAdd += (uint32_t)BSPDRV_AR12XX_CRC_M_FOUR;
-
-      /*
-        * Divide the message by the polynomial, a byte at a time.
-        */
-      for (cByte = BSPDRV_AR12XX_CRC_M_ZERO;
-        cByte < BSPDRV_AR12XX_CRC_M_FOUR; cByte++)
-      {
-        /* Reminder upper byte xor with incoming data before dividing
-          * with polynomial */
-        cData = (uint8_t)((uint64_t)lDData & (uint64_t)0x000000FF) ^ \
-          (uint8_t)(hRemainder >> (BSPDRV_AR12XX_CRC_M_EIGHT));
-        /*
-          * Perform poly divide on incoming data - the result from the
-          * LUT, xor upper byte of result with lower byte of previous
-          * reminder - this is to xor previous reminder
-          * lower byte with next incoming data
-          */
-        hRemainder = hCrc16Table[cData] ^
-          ((uint16_t)(hRemainder << BSPDRV_AR12XX_CRC_M_EIGHT));
-        /* Get next byte in LSB - that is the next byte of message */
-        lDData = lDData >> BSPDRV_AR12XX_CRC_M_EIGHT;
-      }
-    }
 
-    /*
-      * Read each bytes one at a time and perform CRC calculation if number
-      * of bytes less than 4 bytes
-      */
-    for (hIndex = BSPDRV_AR12XX_CRC_M_ZERO;
-      hIndex < cNRemainderBytes; hIndex++)
-    {
-      /* Read 1 byte data from MB */
-      cData = BSPDRV_AR12XX_CRC_M_REG_READ8(wMbDataBaseAdd);
-      wMbDataBaseAdd += (uint32_t)BSPDRV_AR12XX_CRC_M_ONE;
-
-      /*
-        * Divide the message by the polynomial, a byte at a time.
-        */
-
-        /* Reminder upper byte xor with incoming data before
-        * dividing with polynomial */
-      cData = cData ^ (uint8_t)(hRemainder >> BSPDRV_AR12XX_CRC_M_EIGHT);
-      /*
-        * Perform poly divide on incoming data - the result from the LUT,
-        * xor upper byte of result with lower byte of previous reminder -
-        * this is to xor previous reminder lower byte with next incoming
-        * data
-        */
-      hRemainder = hCrc16Table[cData] ^
-        ((uint16_t)(hRemainder << BSPDRV_AR12XX_CRC_M_EIGHT));
-    }
+  hRemainder = MMWL_crc16(wMbDataBaseAdd, hNBytes);
 
-    /*
-      * The final remainder is the CRC.
-      */
-    if (outCrc != NULL)
-    {
-      *((uint16_t*)outCrc) = hRemainder;
-    }
+  /*
+    * The final remainder is the CRC.
+    */
+  if (outCrc != NULL)
+  {
+    memcpy(outCrc, &hRemainder, sizeof(hRemainder));
   }
-  return retVal;
+  return BSP_SOK;
 }
 
 /*
@@ -87,6 +87,9 @@ extern "C" {
 #include <sys/types.h>
 #include <netdb.h>
 #include <ifaddrs.h>
+#include <sys/epoll.h>
+#include <sys/uio.h>
+#include <sys/eventfd.h>
 #include <sys/ioctl.h>
 #include <net/if.h>
 #include <netinet/tcp.h>
@@ -94,6 +97,9 @@ extern "C" {
 #include <semaphore.h>
 #include <string.h>
 #include "mtime.h"
+#include "mmwl_trace.h"
+#include "mmwl_prof.h"
+#include "mmwl_crc.h"
 
 #define getError() (errno)
 #define INVALID_SOCKET (-1)
@@ -211,6 +217,27 @@ typedef uint8_t BOOLEAN;
 #define ACK_NOT_REQUIRED                            (0x11U)
 
 
+/*! \brief
+* Host IRQ dispatch modes
+*/
+
+#define TDA_IRQ_MODE_POLLING                        (0U)  /* 1 ms polling loop */
+#define TDA_IRQ_MODE_EVENT                          (1U)  /* Wake up on host IRQ */
+#define TDA_IRQ_EVENT_RESCAN_MS                     (10U)
+
+/* Receive buffer of the network Rx thread */
+#define NETWORK_RX_BUFFER_SIZE                      (64U * 1024U)
+#define NETWORK_RX_MIN_READ_SIZE                    (4U * 1024U)
+/* Largest response payload of the TDA: sync byte, header, data and CRC */
+#define NETWORK_RX_MAX_PRM_SIZE                     (MAX_DATA_LENGTH + DATA_HEADER_LENGTH + HEADER_AND_CRC_LENGTH)
+
+/* Kernel send buffer of the command socket */
+#define NETWORK_TX_SOCKET_BUFFER_SIZE               (256 * 1024)
+
+/* Maximum time to wait for the answer to an SPI read */
+#define TDA_SPI_READ_TIMEOUT_MS                     (1000U)
+
+
 /*! \brief
 * Status Codes
 */
@@ -571,6 +598,38 @@ typedef struct TDAhostIntrThread {
 } TDAThreadParam_t;
 
 
+/*! \brief
+ *  SPI read completion (one per device)
+ */
+typedef struct TDASpiRxCompletion {
+  /**
+   * @brief  protects the fields below
+   */
+  pthread_mutex_t lock;
+  /**
+   * @brief  signaled by the Rx thread when the data is available
+   */
+  pthread_cond_t cond;
+  /**
+   * @brief  destination buffer of the pending read (NULL if none)
+   */
+  uint8_t* dest;
+  /**
+   * @brief  size of the destination buffer
+   */
+  uint16_t destSize;
+  /**
+   * @brief  number of bytes received
+   */
+  uint32_t length;
+  /**
+   * @brief  read completed
+   */
+  uint8_t done;
+
+} TDASpiRxCompletion_t;
+
+
 /*! \brief
  *  Device Context Structure
  */
@@ -782,6 +841,12 @@ EXPORT int TDAStartIrqPollingThread(TDADevCtx_t* pDevCtx);
 
 EXPORT int TDAStopIrqPollingThread(TDADevCtx_t* pDevCtx);
 
+EXPORT void* TDAEventThreadEntrySpi(void* pParam);
+
+EXPORT void TDASetIrqMode(uint8_t mode);
+
+EXPORT uint8_t TDAGetIrqMode(void);
+
 EXPORT unsigned int getDevIdFromDevMap(unsigned int deviceMap);
 
 EXPORT unsigned int createDevMapFromDevId(unsigned int deviceId);
@@ -810,6 +875,13 @@ EXPORT int Network_write(Network_SockObj *pObj,
                     uint8_t *dataBuf,
                     uint32_t dataSize);
 
+EXPORT int Network_writev(Network_SockObj *pObj,
+                     struct iovec *iov,
+                     int iovCnt);
+
+EXPORT int Network_cork(Network_SockObj *pObj,
+                   uint8_t enable);
+
 EXPORT int32_t Network_waitRead(Network_SockObj *pObj);
 
 EXPORT int ConnectToServer();
@@ -819,6 +891,8 @@ EXPORT int CloseConnection();
 EXPORT int SendCommand(void *params,
                     int prmSize);
 
+EXPORT int TDACorkCommands(uint8_t enable);
+
 EXPORT int RecvResponseParams(uint8_t *pPrm,
                        uint32_t prmSize);
 
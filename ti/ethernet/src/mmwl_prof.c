@@ -0,0 +1,345 @@
+/**
+ * @file mmwl_prof.c
+ * @brief Latency profiler of the device bring-up
+ * @version 0.1
+ * @date 2026-10-14
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#include <string.h>
+#include <time.h>
+#include <stdatomic.h>
+#include "mmwl_prof.h"
+
+/* Host to device sync pattern, the other writes are CNYS handshakes */
+#define PROF_SYNC_PATTERN                           (0x43211234U)
+
+/* Offset of the opcode in a message (after the sync pattern) */
+#define PROF_OPCODE_OFFSET                          (4U)
+
+/* Number of devices followed by the message spans */
+#define PROF_MAX_DEVICES                            (4U)
+
+uint8_t gTDAProfEnabled = 0;
+
+static TDAProfEvent_t gProfEvents[TDA_PROF_MAX_EVENTS];
+static atomic_uint gProfEventHead;
+static TDAProfHist_t gProfHist[TDA_PROF_MAX_HISTOGRAMS];
+
+/* Command in flight on each device (RHCP is stop-and-wait per device) */
+static struct {
+  uint64_t start;
+  uint64_t written;
+  uint16_t msgId;
+  uint8_t pending;
+} gProfMsg[PROF_MAX_DEVICES];
+
+
+/**
+ * @brief Enable or disable the recording of the spans
+ */
+void TDAProfEnable(uint8_t enable) {
+  for (unsigned int i = 0; i < TDA_PROF_MAX_HISTOGRAMS; i++) {
+    if (__atomic_load_n(&gProfHist[i].id, __ATOMIC_ACQUIRE) == 0U) {
+      gProfHist[i].min = UINT64_MAX;
+    }
+  }
+  gTDAProfEnabled = enable;
+}
+
+
+/**
+ * @brief CLOCK_MONOTONIC time in ns
+ */
+uint64_t TDAProfNow(void) {
+  struct timespec ts;
+
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+
+/**
+ * @brief Bucket of a duration
+ *
+ * Durations below TDA_PROF_HIST_SUB_COUNT ns have their own bucket, the
+ * others are split in TDA_PROF_HIST_SUB_COUNT buckets per power of 2.
+ */
+static unsigned int profBucket(uint64_t value) {
+  unsigned int exponent;
+  unsigned int bucket;
+
+  if (value < TDA_PROF_HIST_SUB_COUNT) return (unsigned int)value;
+  exponent = 63U - __builtin_clzll(value);
+  bucket = (exponent - TDA_PROF_HIST_SUB_BITS + 1U) * TDA_PROF_HIST_SUB_COUNT +
+    (unsigned int)((value >> (exponent - TDA_PROF_HIST_SUB_BITS)) & (TDA_PROF_HIST_SUB_COUNT - 1U));
+  return (bucket < TDA_PROF_HIST_BUCKETS) ? bucket : (TDA_PROF_HIST_BUCKETS - 1U);
+}
+
+
+/**
+ * @brief Middle of the values of a bucket
+ */
+static uint64_t profBucketValue(unsigned int bucket) {
+  unsigned int exponent;
+  uint64_t low;
+
+  if (bucket < TDA_PROF_HIST_SUB_COUNT) return bucket;
+  exponent = bucket / TDA_PROF_HIST_SUB_COUNT + TDA_PROF_HIST_SUB_BITS - 1U;
+  low = (uint64_t)(TDA_PROF_HIST_SUB_COUNT + bucket % TDA_PROF_HIST_SUB_COUNT) <<
+    (exponent - TDA_PROF_HIST_SUB_BITS);
+  return low + ((1ULL << (exponent - TDA_PROF_HIST_SUB_BITS)) >> 1);
+}
+
+
+/**
+ * @brief Find or claim the histogram of a kind, device and key
+ *
+ * Open addressing on a fixed table: a free slot is claimed with a CAS on its
+ * identifier, so that concurrent recorders never lock. The minimum of the
+ * free slots is initialized by TDAProfEnable.
+ *
+ * @return TDAProfHist_t* Histogram, NULL when the table is full
+ */
+static TDAProfHist_t *profHistogram(uint8_t kind, uint8_t device, uint32_t key,
+                                    const char *name) {
+  uint64_t id = (((uint64_t)kind << 40) | ((uint64_t)device << 32) | key) + 1U;
+  unsigned int slot = (unsigned int)((id * 0x9E3779B97F4A7C15ULL) >> 32);
+
+  for (unsigned int probe = 0; probe < TDA_PROF_MAX_HISTOGRAMS; probe++) {
+    TDAProfHist_t *hist = &gProfHist[(slot + probe) & (TDA_PROF_MAX_HISTOGRAMS - 1U)];
+    uint64_t current = __atomic_load_n(&hist->id, __ATOMIC_ACQUIRE);
+
+    if ((current == 0U) &&
+        __atomic_compare_exchange_n(&hist->id, &current, id, 0,
+                                    __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE)) {
+      hist->kind = kind;
+      hist->device = device;
+      hist->key = key;
+      hist->name = name;
+      return hist;
+    }
+    if (current == id) return hist;
+  }
+  return NULL;
+}
+
+
+/**
+ * @brief Record a span
+ *
+ * @param kind TDA_PROF_* kind of the span
+ * @param device Device index, TDA_PROF_HOST for the host spans
+ * @param key Key of the span within its kind (API info, message ID, ...)
+ * @param name Name of the span (static string) or NULL
+ * @param start Start time (TDAProfNow)
+ * @param end End time (TDAProfNow)
+ */
+void TDAProfSpan(uint8_t kind, uint8_t device, uint32_t key, const char *name,
+                 uint64_t start, uint64_t end) {
+  unsigned int index;
+  TDAProfHist_t *hist;
+  uint64_t duration;
+  uint64_t bound;
+
+  if (!gTDAProfEnabled || (start == 0U) || (end < start)) return;
+  duration = end - start;
+
+  index = atomic_fetch_add_explicit(&gProfEventHead, 1, memory_order_relaxed);
+  if (index < TDA_PROF_MAX_EVENTS) {
+    TDAProfEvent_t *event = &gProfEvents[index];
+    event->start = start;
+    event->end = end;
+    event->name = name;
+    event->key = key;
+    event->kind = kind;
+    event->device = device;
+    __atomic_store_n(&event->valid, 1, __ATOMIC_RELEASE);
+  }
+
+  hist = profHistogram(kind, device, key, name);
+  if (hist == NULL) return;
+  __atomic_fetch_add(&hist->buckets[profBucket(duration)], 1, __ATOMIC_RELAXED);
+  __atomic_fetch_add(&hist->sum, duration, __ATOMIC_RELAXED);
+  bound = __atomic_load_n(&hist->min, __ATOMIC_RELAXED);
+  while ((duration < bound) && !__atomic_compare_exchange_n(&hist->min, &bound, duration,
+           1, __ATOMIC_RELAXED, __ATOMIC_RELAXED));
+  bound = __atomic_load_n(&hist->max, __ATOMIC_RELAXED);
+  while ((duration > bound) && !__atomic_compare_exchange_n(&hist->max, &bound, duration,
+           1, __ATOMIC_RELAXED, __ATOMIC_RELAXED));
+  __atomic_fetch_add(&hist->count, 1, __ATOMIC_RELEASE);
+}
+
+
+/**
+ * @brief Record a host stage
+ *
+ * @param name Name of the stage (static string), also its key
+ * @param start Start time (TDAProfNow)
+ * @param end End time (TDAProfNow)
+ */
+void TDAProfStage(const char *name, uint64_t start, uint64_t end) {
+  uint32_t hash = 2166136261U;  /* FNV-1a */
+
+  if (!gTDAProfEnabled) return;
+  for (const char *p = name; *p != '\0'; p++) {
+    hash = (hash ^ (uint8_t)*p) * 16777619U;
+  }
+  TDAProfSpan(TDA_PROF_STAGE, TDA_PROF_HOST, hash, name, start, end);
+}
+
+
+/**
+ * @brief Record a write to a device
+ *
+ * A command (sync pattern) opens the message span of the device, which is
+ * closed by the first read of the response.
+ *
+ * @param device Device index
+ * @param data Data written (sync pattern followed by the RHCP header)
+ * @param length Number of bytes written
+ * @param start Start of the write
+ * @param end End of the write
+ */
+void TDAProfMsgWrite(uint8_t device, const uint8_t *data, uint16_t length,
+                     uint64_t start, uint64_t end) {
+  uint32_t sync;
+  uint16_t msgId = 0;
+
+  if (!gTDAProfEnabled || (device >= PROF_MAX_DEVICES)) return;
+  if (length >= PROF_OPCODE_OFFSET + sizeof(uint16_t)) {
+    memcpy(&sync, data, sizeof(sync));
+    if (sync == PROF_SYNC_PATTERN) {
+      /* Bits 6-15 of the opcode */
+      msgId = (uint16_t)((data[PROF_OPCODE_OFFSET] | (data[PROF_OPCODE_OFFSET + 1] << 8)) >> 6);
+      gProfMsg[device].start = start;
+      gProfMsg[device].written = end;
+      gProfMsg[device].msgId = msgId;
+      gProfMsg[device].pending = 1;
+    }
+  }
+  TDAProfSpan(TDA_PROF_SPI_WRITE, device, msgId, NULL, start, end);
+}
+
+
+/**
+ * @brief Record a read from a device
+ *
+ * @param device Device index
+ * @param start Start of the read
+ * @param end End of the read
+ */
+void TDAProfMsgRead(uint8_t device, uint64_t start, uint64_t end) {
+  if (!gTDAProfEnabled || (device >= PROF_MAX_DEVICES)) return;
+  TDAProfSpan(TDA_PROF_SPI_READ, device, 0, NULL, start, end);
+  if (gProfMsg[device].pending) {
+    gProfMsg[device].pending = 0;
+    TDAProfSpan(TDA_PROF_IRQ_WAIT, device, gProfMsg[device].msgId, NULL,
+                gProfMsg[device].written, start);
+    TDAProfSpan(TDA_PROF_MSG, device, gProfMsg[device].msgId, NULL,
+                gProfMsg[device].start, end);
+  }
+}
+
+
+/**
+ * @brief Spans recorded so far
+ *
+ * @param events Set to the first span, check the valid flag of each span
+ * @param dropped Set to the number of spans which did not fit (optional)
+ * @return unsigned int Number of spans
+ */
+unsigned int TDAProfEvents(const TDAProfEvent_t **events, unsigned int *dropped) {
+  unsigned int head = atomic_load(&gProfEventHead);
+  unsigned int count = (head < TDA_PROF_MAX_EVENTS) ? head : TDA_PROF_MAX_EVENTS;
+
+  *events = gProfEvents;
+  if (dropped != NULL) *dropped = head - count;
+  return count;
+}
+
+
+/**
+ * @brief Histogram of a slot of the table
+ *
+ * @param index Slot, from 0 to TDA_PROF_MAX_HISTOGRAMS - 1
+ * @return const TDAProfHist_t* Histogram, NULL for a free or empty slot
+ */
+const TDAProfHist_t *TDAProfHistogram(unsigned int index) {
+  const TDAProfHist_t *hist;
+
+  if (index >= TDA_PROF_MAX_HISTOGRAMS) return NULL;
+  hist = &gProfHist[index];
+  if ((__atomic_load_n(&hist->id, __ATOMIC_ACQUIRE) == 0U) ||
+      (__atomic_load_n(&hist->count, __ATOMIC_ACQUIRE) == 0U)) {
+    return NULL;
+  }
+  return hist;
+}
+
+
+/**
+ * @brief Value of a quantile of a histogram
+ *
+ * @param hist Histogram
+ * @param quantile Quantile, from 0 to 1
+ * @return uint64_t Duration in ns, within the precision of the buckets
+ */
+uint64_t TDAProfQuantile(const TDAProfHist_t *hist, double quantile) {
+  uint64_t total = 0;
+  uint64_t rank;
+  uint64_t seen = 0;
+
+  for (unsigned int i = 0; i < TDA_PROF_HIST_BUCKETS; i++) total += hist->buckets[i];
+  if (total == 0U) return 0;
+  rank = (uint64_t)(quantile * (double)total + 0.5);
+  if (rank < 1U) rank = 1U;
+  if (rank > total) rank = total;
+  for (unsigned int i = 0; i < TDA_PROF_HIST_BUCKETS; i++) {
+    seen += hist->buckets[i];
+    if (seen >= rank) {
+      uint64_t value = profBucketValue(i);
+      if (value < hist->min) value = hist->min;
+      if (value > hist->max) value = hist->max;
+      return value;
+    }
+  }
+  return hist->max;
+}
+
+
+/**
+ * @brief Number of spans of a histogram up to a duration
+ *
+ * The spans of the bucket holding the duration are not counted, unless it
+ * is the upper bound of the bucket.
+ *
+ * @param hist Histogram
+ * @param value Duration in ns
+ * @return uint64_t Number of spans
+ */
+uint64_t TDAProfCountBelow(const TDAProfHist_t *hist, uint64_t value) {
+  unsigned int last = (value < UINT64_MAX) ? profBucket(value + 1U) : TDA_PROF_HIST_BUCKETS;
+  uint64_t count = 0;
+
+  if ((value >= hist->max) || (last >= TDA_PROF_HIST_BUCKETS)) last = TDA_PROF_HIST_BUCKETS;
+  for (unsigned int i = 0; i < last; i++) {
+    count += __atomic_load_n(&hist->buckets[i], __ATOMIC_RELAXED);
+  }
+  return count;
+}
+
+
+/**
+ * @brief Name of a span kind
+ */
+const char *TDAProfKindName(uint8_t kind) {
+  static const char *names[TDA_PROF_KIND_COUNT] = {
+    "stage", "api", "task", "msg", "spi_write", "spi_read", "irq_wait",
+    "event"
+  };
+
+  return (kind < TDA_PROF_KIND_COUNT) ? names[kind] : "unknown";
+}
@@ -0,0 +1,117 @@
+/**
+ * @file mmwl_prof.h
+ * @brief Latency profiler of the device bring-up
+ * @version 0.1
+ * @date 2026-10-14
+ *
+ * @copyright Copyright (c) 2026
+ *
+ * Spans (start and end on CLOCK_MONOTONIC) are recorded by the host stages,
+ * the API calls, the per-device worker tasks and the transport. Each span
+ * is appended to a fixed size event buffer for the timeline and accumulated
+ * into a log-linear (HDR style) histogram keyed by kind, device and key.
+ * Recording is lock-free and costs a single test when the profiler is
+ * disabled. The result is written as a Chrome trace by json_export_profile.
+ */
+
+#ifndef MMWL_PROF_H
+#define MMWL_PROF_H
+
+#include <stdint.h>
+
+/* Number of spans kept for the timeline, the following ones are dropped */
+#define TDA_PROF_MAX_EVENTS                         (65536U)
+
+/* Number of histograms (power of 2) */
+#define TDA_PROF_MAX_HISTOGRAMS                     (512U)
+
+/* Sub-buckets per power of 2: 8, i.e. a relative error below 12.5 % */
+#define TDA_PROF_HIST_SUB_BITS                      (3U)
+#define TDA_PROF_HIST_SUB_COUNT                     (1U << TDA_PROF_HIST_SUB_BITS)
+
+/* Covers up to 2^43 ns (more than 2 hours) */
+#define TDA_PROF_HIST_BUCKETS                       (41U * TDA_PROF_HIST_SUB_COUNT)
+
+/* Device of the spans which are not bound to a device */
+#define TDA_PROF_HOST                               (0xFFU)
+
+/* Span kinds */
+#define TDA_PROF_STAGE                              (0U)  /* check() stage, key: hash of the name */
+#define TDA_PROF_API                                (1U)  /* callThreadApi, key: API info */
+#define TDA_PROF_TASK                               (2U)  /* Worker task, key: API info */
+#define TDA_PROF_MSG                                (3U)  /* Command to response, key: message ID */
+#define TDA_PROF_SPI_WRITE                          (4U)  /* spiWriteToDevice, key: message ID */
+#define TDA_PROF_SPI_READ                           (5U)  /* spiReadFromDevice */
+#define TDA_PROF_IRQ_WAIT                           (6U)  /* Command written to response IRQ */
+#define TDA_PROF_EVENT                              (7U)  /* Wait for an async event / ACK, key: event */
+#define TDA_PROF_KIND_COUNT                         (8U)
+
+/*! \brief
+ * Span of the timeline
+ */
+typedef struct {
+  uint64_t start;
+  uint64_t end;
+  /**
+   * @brief  Name of the stage (static string), NULL for the other kinds
+   */
+  const char *name;
+  uint32_t key;
+  uint8_t kind;
+  uint8_t device;
+  /**
+   * @brief  Set once the span is completely written
+   */
+  uint8_t valid;
+  uint8_t reserved;
+} TDAProfEvent_t;
+
+/*! \brief
+ * Latency histogram
+ */
+typedef struct {
+  /**
+   * @brief  Identifier of the histogram + 1, 0 while the slot is free
+   */
+  uint64_t id;
+  const char *name;
+  uint32_t key;
+  uint8_t kind;
+  uint8_t device;
+  uint64_t count;
+  uint64_t sum;
+  uint64_t min;
+  uint64_t max;
+  uint32_t buckets[TDA_PROF_HIST_BUCKETS];
+} TDAProfHist_t;
+
+extern uint8_t gTDAProfEnabled;
+
+void TDAProfEnable(uint8_t enable);
+
+uint64_t TDAProfNow(void);
+
+void TDAProfSpan(uint8_t kind, uint8_t device, uint32_t key, const char *name,
+                 uint64_t start, uint64_t end);
+
+void TDAProfStage(const char *name, uint64_t start, uint64_t end);
+
+void TDAProfMsgWrite(uint8_t device, const uint8_t *data, uint16_t length,
+                     uint64_t start, uint64_t end);
+
+void TDAProfMsgRead(uint8_t device, uint64_t start, uint64_t end);
+
+unsigned int TDAProfEvents(const TDAProfEvent_t **events, unsigned int *dropped);
+
+const TDAProfHist_t *TDAProfHistogram(unsigned int index);
+
+uint64_t TDAProfQuantile(const TDAProfHist_t *hist, double quantile);
+
+uint64_t TDAProfCountBelow(const TDAProfHist_t *hist, uint64_t value);
+
+const char *TDAProfKindName(uint8_t kind);
+
+/* Current time when the profiler is enabled, 0 otherwise */
+#define TDA_PROF_START()    (gTDAProfEnabled ? TDAProfNow() : 0U)
+
+#endif
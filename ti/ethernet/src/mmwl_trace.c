@@ -0,0 +1,159 @@
+/**
+ * @file mmwl_trace.c
+ * @brief Binary trace of the packets exchanged with the TDA
+ * @version 0.1
+ * @date 2026-10-14
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#include <fcntl.h>
+#include <signal.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <stdatomic.h>
+#include <pthread.h>
+#include "mmwl_trace.h"
+
+static TDATraceRecord_t gTraceRing[TDA_TRACE_RING_SIZE];
+static atomic_uint gTraceHead;
+static uint8_t gTraceLive = 0;
+static char gTraceDumpFile[64];
+static pthread_once_t gTraceOnce = PTHREAD_ONCE_INIT;
+
+
+/**
+ * @brief SIGUSR1 handler, dump the trace ring
+ */
+static void traceSignalHandler(int signum) {
+  (void)signum;
+  TDATraceDump();
+}
+
+
+static void traceSetup(void) {
+  struct sigaction action;
+
+  snprintf(gTraceDumpFile, sizeof(gTraceDumpFile), TDA_TRACE_DUMP_FILE_FMT, getpid());
+
+  memset(&action, 0, sizeof(action));
+  action.sa_handler = traceSignalHandler;
+  action.sa_flags = SA_RESTART;
+  sigemptyset(&action.sa_mask);
+  sigaction(SIGUSR1, &action, NULL);
+}
+
+
+/**
+ * @brief Set up the trace dump file and the SIGUSR1 handler
+ */
+void TDATraceInit(void) {
+  pthread_once(&gTraceOnce, traceSetup);
+}
+
+
+/**
+ * @brief Enable or disable the live text dump of the records to stderr
+ *
+ * @param enable 1 to print each record as it is recorded
+ */
+void TDATraceSetLive(uint8_t enable) {
+  gTraceLive = enable;
+}
+
+
+/**
+ * @brief Print a record as text
+ */
+static void tracePrint(FILE *out, const TDATraceRecord_t *record) {
+  fprintf(out, "[%llu.%09llu] %s dev 0x%02X op 0x%04X ack 0x%04X len %u:",
+    (unsigned long long)(record->timestamp / 1000000000ULL),
+    (unsigned long long)(record->timestamp % 1000000000ULL),
+    (record->direction == TDA_TRACE_DIR_TX) ? "TX" : "RX",
+    record->device, record->opcode, record->ackCode, record->length);
+  for (unsigned int i = 0; i < record->captured; i++) {
+    fprintf(out, " %02X", record->payload[i]);
+  }
+  fprintf(out, (record->captured < record->length) ? " ...\n" : "\n");
+}
+
+
+/**
+ * @brief Record a packet into the trace ring
+ *
+ * Safe to call concurrently from several threads: each caller reserves its
+ * own slot and publishes it by writing the sequence number last.
+ *
+ * @param direction TDA_TRACE_DIR_TX or TDA_TRACE_DIR_RX
+ * @param device Device selection map of the packet
+ * @param opcode Opcode of the packet
+ * @param ackCode ACK code of the packet
+ * @param payload Packet payload
+ * @param length Length of the payload in bytes
+ */
+void TDATraceRecord(uint8_t direction, uint8_t device, uint16_t opcode,
+                    uint16_t ackCode, const uint8_t *payload, uint16_t length) {
+  unsigned int index = atomic_fetch_add_explicit(&gTraceHead, 1, memory_order_relaxed);
+  TDATraceRecord_t *record = &gTraceRing[index & (TDA_TRACE_RING_SIZE - 1)];
+  struct timespec ts;
+
+  __atomic_store_n(&record->sequence, 0, __ATOMIC_RELAXED);
+  __atomic_thread_fence(__ATOMIC_RELEASE);
+
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  record->timestamp = (uint64_t)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+  record->opcode = opcode;
+  record->ackCode = ackCode;
+  record->length = length;
+  record->device = device;
+  record->direction = direction;
+  record->captured = (length < TDA_TRACE_PAYLOAD_SIZE) ? length : TDA_TRACE_PAYLOAD_SIZE;
+  if (payload != NULL) {
+    memcpy(record->payload, payload, record->captured);
+  } else {
+    record->captured = 0;
+  }
+
+  __atomic_store_n(&record->sequence, index + 1, __ATOMIC_RELEASE);
+
+  if (gTraceLive) tracePrint(stderr, record);
+}
+
+
+/**
+ * @brief Dump the trace ring into the dump file, oldest record first
+ *
+ * Only async-signal-safe calls are used so that the dump can run from the
+ * SIGUSR1 handler. Records being written at the time of the dump have a
+ * null sequence number and are skipped by the decoder.
+ *
+ * @return int 0 on success, -1 on failure
+ */
+int TDATraceDump(void) {
+  TDATraceFileHeader_t header;
+  unsigned int head = atomic_load(&gTraceHead);
+  unsigned int count = (head < TDA_TRACE_RING_SIZE) ? head : TDA_TRACE_RING_SIZE;
+  unsigned int start = (head - count) & (TDA_TRACE_RING_SIZE - 1);
+  unsigned int first = TDA_TRACE_RING_SIZE - start;
+  int fd;
+
+  if (gTraceDumpFile[0] == '\0') return -1;
+  fd = open(gTraceDumpFile, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+  if (fd < 0) return -1;
+
+  memcpy(header.magic, TDA_TRACE_MAGIC, sizeof(header.magic));
+  header.version = TDA_TRACE_VERSION;
+  header.recordSize = sizeof(TDATraceRecord_t);
+  header.recordCount = count;
+  header.reserved = 0;
+  write(fd, &header, sizeof(header));
+
+  if (first > count) first = count;
+  write(fd, &gTraceRing[start], first * sizeof(TDATraceRecord_t));
+  write(fd, &gTraceRing[0], (count - first) * sizeof(TDATraceRecord_t));
+
+  close(fd);
+  return 0;
+}
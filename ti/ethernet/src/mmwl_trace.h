@@ -0,0 +1,105 @@
+/**
+ * @file mmwl_trace.h
+ * @brief Binary trace of the packets exchanged with the TDA
+ * @version 0.1
+ * @date 2026-10-14
+ *
+ * @copyright Copyright (c) 2026
+ *
+ * Each packet sent to or received from the TDA is recorded into a fixed
+ * size, lock-free ring in memory. Nothing is formatted on the hot path:
+ * the ring is dumped to a binary file on demand (SIGUSR1) or on error and
+ * decoded offline with `trace_decode.py`. A live text dump to stderr can
+ * be enabled for interactive debugging.
+ */
+
+#ifndef MMWL_TRACE_H
+#define MMWL_TRACE_H
+
+#include <stdio.h>
+#include <stdint.h>
+
+/* Number of records in the ring (power of 2) */
+#define TDA_TRACE_RING_SIZE                         (4096U)
+
+/* Number of payload bytes kept per record */
+#define TDA_TRACE_PAYLOAD_SIZE                      (42U)
+
+/* Dump file, "%d" is replaced by the process ID */
+#define TDA_TRACE_DUMP_FILE_FMT                     "/tmp/mmwave_trace_%d.bin"
+
+/* Dump file identification */
+#define TDA_TRACE_MAGIC                             "MMWTRACE"
+#define TDA_TRACE_VERSION                           (1U)
+
+/* Packet direction */
+#define TDA_TRACE_DIR_TX                            (0U)
+#define TDA_TRACE_DIR_RX                            (1U)
+
+/*! \brief
+ * Trace record (64 bytes)
+ */
+typedef struct {
+  /**
+   * @brief  CLOCK_MONOTONIC timestamp in ns
+   */
+  uint64_t timestamp;
+  /**
+   * @brief  Index of the record + 1, 0 while the record is being written
+   */
+  uint32_t sequence;
+  /**
+   * @brief  Opcode of the ethernet packet
+   */
+  uint16_t opcode;
+  /**
+   * @brief  Length of the packet payload in bytes
+   */
+  uint16_t length;
+  /**
+   * @brief  ACK code of the packet (opcode acknowledged by a response)
+   */
+  uint16_t ackCode;
+  /**
+   * @brief  Device selection map of the packet
+   */
+  uint8_t device;
+  /**
+   * @brief  TDA_TRACE_DIR_TX or TDA_TRACE_DIR_RX
+   */
+  uint8_t direction;
+  /**
+   * @brief  Number of payload bytes kept in the record
+   */
+  uint8_t captured;
+  /**
+   * @brief  Reserved for future use
+   */
+  uint8_t reserved;
+  /**
+   * @brief  First bytes of the packet payload
+   */
+  uint8_t payload[TDA_TRACE_PAYLOAD_SIZE];
+} TDATraceRecord_t;
+
+/*! \brief
+ * Header of the dump file, followed by the records from the oldest
+ */
+typedef struct {
+  char magic[8];
+  uint32_t version;
+  uint32_t recordSize;
+  uint32_t recordCount;
+  uint32_t reserved;
+} TDATraceFileHeader_t;
+
+void TDATraceInit(void);
+
+void TDATraceSetLive(uint8_t enable);
+
+void TDATraceRecord(uint8_t direction, uint8_t device, uint16_t opcode,
+                    uint16_t ackCode, const uint8_t *payload, uint16_t length);
+
+int TDATraceDump(void);
+
+#endif
@@ -13,6 +13,7 @@ static unsigned char mmwl_bInitComp = 0U;
 static unsigned char mmwl_bMssBootErrStatus = 0U;
 static unsigned char mmwl_bStartComp = 0U;
 static unsigned char mmwl_bRfInitComp = 0U;
+static rlRfInitComplete_t mmwl_rfInitStatus[TDA_NUM_CONNECTED_DEVICES_MAX];
 static unsigned char mmwl_bSensorStarted = 0U;
 static unsigned char mmwl_bGpadcDataRcv = 0U;
 static unsigned char mmwl_bMssCpuFault = 0U;
@@ -31,6 +32,7 @@ static unsigned char mmwl_bTDA_DataPackagingACK = 0U;
 static unsigned char mmwl_bTDA_CaptureDirectoryACK = 0U;
 static unsigned char mmwl_bTDA_NumFramesToCaptureACK = 0U;
 static unsigned char mmwl_bTDA_ARMDone = 0U;
+static unsigned char mmwl_bTDA_SopACK = 0U;
 
 unsigned char gAwr2243CrcType = RL_CRC_TYPE_32BIT;
 
@@ -56,8 +58,132 @@ rlRfDevCfg_t rfDevCfg = { 0x0 };
 /* Structure to store GPADC measurement data sent by device */
 rlRecvdGpAdcData_t rcvGpAdcData = {0};
 
-/* Thread return values */
-rlReturnVal_t threadRetVal[TDA_NUM_CONNECTED_DEVICES_MAX];
+/* Pre-built firmware download chunks */
+static rlFileData_t* mmwl_fwChunkTable = NULL;
+static unsigned int mmwl_fwNumChunks = 0U;
+
+
+/******************************************************************************
+* EVENT COMPLETION
+*******************************************************************************
+*/
+
+/* The async event handlers signal each update of the status flags: the
+  flow waits on the flags without polling them. */
+static pthread_mutex_t mmwl_eventLock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t mmwl_eventCond = PTHREAD_COND_INITIALIZER;
+
+static mmwlEventStat_t mmwl_eventStats[MMWL_EVT_COUNT] = {
+  { "power up" }, { "rf start" }, { "rf init" }, { "frame start" }, { "frame end" },
+  { "gpadc" }, { "tda connect" }, { "tda sop" }, { "tda frame periodicity" },
+  { "tda capture directory" }, { "tda file allocation" }, { "tda data packaging" },
+  { "tda num frames" }, { "tda create app" }, { "tda start record" },
+  { "tda stop record" },
+};
+
+
+static uint64_t eventNow(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+
+/**
+ * @brief Wake up the waits after an update of the status flags
+ */
+static void eventNotify(void) {
+  pthread_mutex_lock(&mmwl_eventLock);
+  pthread_cond_broadcast(&mmwl_eventCond);
+  pthread_mutex_unlock(&mmwl_eventLock);
+}
+
+
+/**
+ * @brief Wait for the bits of a status flag to be set or cleared
+ *
+ * The time spent waiting is recorded in the statistics of the event, and
+ * as a span of the profile when profiling is enabled.
+ *
+ * @param evt Event (MMWL_EVT_*)
+ * @param flag Status flag updated by an async event handler
+ * @param mask Bits to wait for (device map, 1 for the TDA ACKs)
+ * @param set TRUE: wait for all the bits set, FALSE: for all the bits cleared
+ * @param timeout Timeout in ms
+ * @return int Success - 0, Failure - RL_RET_CODE_RESP_TIMEOUT
+ */
+static int eventWait(unsigned int evt, const unsigned char *flag, unsigned char mask,
+                     unsigned char set, unsigned int timeout) {
+  unsigned char expected = set ? mask : 0U;
+  mmwlEventStat_t *stat = &mmwl_eventStats[evt];
+  uint64_t profStart = TDA_PROF_START();
+  uint64_t start = eventNow(), elapsed;
+  struct timespec deadline;
+  int retVal = RL_RET_CODE_OK;
+
+  clock_gettime(CLOCK_REALTIME, &deadline);
+  deadline.tv_sec += timeout / 1000U;
+  deadline.tv_nsec += (timeout % 1000U) * 1000000L;
+  if (deadline.tv_nsec >= 1000000000L) {
+    deadline.tv_sec++;
+    deadline.tv_nsec -= 1000000000L;
+  }
+
+  pthread_mutex_lock(&mmwl_eventLock);
+  while ((*(volatile const unsigned char *)flag & mask) != expected) {
+    if (pthread_cond_timedwait(&mmwl_eventCond, &mmwl_eventLock, &deadline) == ETIMEDOUT) {
+      if ((*(volatile const unsigned char *)flag & mask) != expected) {
+        retVal = RL_RET_CODE_RESP_TIMEOUT;
+      }
+      break;
+    }
+  }
+  elapsed = eventNow() - start;
+  stat->count++;
+  if (retVal != RL_RET_CODE_OK) stat->timeouts++;
+  stat->totalNs += elapsed;
+  if (elapsed > stat->maxNs) stat->maxNs = elapsed;
+  pthread_mutex_unlock(&mmwl_eventLock);
+
+  if (profStart != 0U) {
+    TDAProfSpan(TDA_PROF_EVENT, TDA_PROF_HOST, evt, stat->name, profStart, TDAProfNow());
+  }
+  return retVal;
+}
+
+
+/** @fn int MMWL_eventStats(unsigned int evt, mmwlEventStat_t *stat)
+*
+*   @brief Read the time spent waiting for an event.
+*
+*   @param[in] evt - Event (MMWL_EVT_*)
+*   @param[out] stat - Statistics of the waits
+*
+*   @return int Success - 0, Failure - Error Code
+*/
+int MMWL_eventStats(unsigned int evt, mmwlEventStat_t *stat) {
+  if ((evt >= MMWL_EVT_COUNT) || (stat == NULL)) return RL_RET_CODE_INVALID_INPUT;
+  pthread_mutex_lock(&mmwl_eventLock);
+  *stat = mmwl_eventStats[evt];
+  pthread_mutex_unlock(&mmwl_eventLock);
+  return RL_RET_CODE_OK;
+}
+
+
+/** @fn void MMWL_eventStatsReset(void)
+*
+*   @brief Clear the statistics of the waits.
+*/
+void MMWL_eventStatsReset(void) {
+  pthread_mutex_lock(&mmwl_eventLock);
+  for (unsigned int evt = 0; evt < MMWL_EVT_COUNT; evt++) {
+    mmwl_eventStats[evt].count = 0U;
+    mmwl_eventStats[evt].timeouts = 0U;
+    mmwl_eventStats[evt].totalNs = 0U;
+    mmwl_eventStats[evt].maxNs = 0U;
+  }
+  pthread_mutex_unlock(&mmwl_eventLock);
+}
 
 
 rlReturnVal_t rlDeviceFileDownloadWrap(rlUInt8_t deviceMap, \
@@ -247,112 +373,1128 @@ rlReturnVal_t (*funcTableTypeA[])(unsigned char, void *) = {
 };
 
 
-rlReturnVal_t(*funcTableTypeB[])(unsigned char) = {
-  rlDeviceAddDevices,
-  rlDeviceRemoveDevices,
-  rlDeviceRfStart,
-  rlRfInit,
-  rlSensorStart,
-  rlSensorStop
+rlReturnVal_t(*funcTableTypeB[])(unsigned char) = {
+  rlDeviceAddDevices,
+  rlDeviceRemoveDevices,
+  rlDeviceRfStart,
+  rlRfInit,
+  rlSensorStart,
+  rlSensorStop
+
+#define ADD_DEVICE_IND        0
+#define REMOVE_DEVICE_IND     1
+#define RF_START_IND          2
+#define RF_INIT_IND           3
+#define SENSOR_START_IND      4
+#define SENSOR_STOP_IND       5
+};
+
+
+rlReturnVal_t(*funcTableTypeC[])(unsigned char, unsigned short, void *) = {
+  rlSetProfileConfig,
+  rlSetChirpConfig,
+  rlRfSetPhaseShiftConfig,
+  rlDeviceFileDownloadWrap,
+  rlSetDynChirpCfg,
+  rlSetDynPerChirpPhShifterCfg,
+  rlGetProfileConfig
+
+#define SET_PROFILE_CONFIG_IND                    0
+#define SET_CHIRP_CONFIG_IND                      1
+#define RF_SET_PHASE_SHIFT_CONFIG_IND             2
+#define FILE_DOWNLOAD_IND                         3
+#define SET_DYN_CHIRP_CFG_IND                     4
+#define SET_DYN_PER_PERCHIRP_PH_SHIFTER_CFG_IND   5
+#define GET_PROFILE_CONFIG_IND                    6
+};
+
+
+static rlReturnVal_t txnExecute(unsigned char devIndex, mmwlTxn_t *txn);
+static rlReturnVal_t frameGateExecute(unsigned char devIndex, void *gate);
+
+
+/**
+ * @brief Execute an API call on the device of the task
+ *
+ * @param data Task to execute
+ * @return rlReturnVal_t Return value of the API
+ */
+static rlReturnVal_t executeTask(taskData *data) {
+  unsigned int apiId = data->apiInfo & 0xFFFF;
+  unsigned int apiType = data->apiInfo & 0xF0000000;
+
+  switch (apiType) {
+    case API_TYPE_A:
+      return funcTableTypeA[apiId]((1 << data->deviceIndex), data->payLoad);
+
+    case API_TYPE_B:
+      return funcTableTypeB[apiId](1 << data->deviceIndex);
+
+    case API_TYPE_C:
+      return funcTableTypeC[apiId](
+        (1 << data->deviceIndex), data->flag, data->payLoad
+      );
+
+    case API_TYPE_D:
+      return txnExecute(data->deviceIndex, (mmwlTxn_t*)data->payLoad);
+
+    case API_TYPE_E:
+      return frameGateExecute(data->deviceIndex, data->payLoad);
+    default:
+      return -1;
+  }
+}
+
+
+/******************************************************************************
+* DEVICE WORKER POOL
+*******************************************************************************
+*/
+
+/* One long-lived worker per device. Each worker owns a single-producer,
+  single-consumer ring of tasks. The producer side is serialized with a
+  mutex so that API calls from any thread keep the SPSC invariant. */
+typedef struct mmwlWorker {
+  pthread_t thread;
+  unsigned char deviceIndex;
+  taskData queue[MMWL_WORKER_QUEUE_SIZE];
+  mmwlFuture_t* futures[MMWL_WORKER_QUEUE_SIZE];
+  atomic_uint head;
+  atomic_uint tail;
+  sem_t pending;
+  pthread_mutex_t producerLock;
+  volatile int running;
+} mmwlWorker_t;
+
+static mmwlWorker_t mmwl_workers[TDA_NUM_CONNECTED_DEVICES_MAX];
+/* Start and stop of the pool, which can be restarted after a stop */
+static pthread_mutex_t mmwl_workerPoolLock = PTHREAD_MUTEX_INITIALIZER;
+static atomic_int mmwl_workerPoolStarted = 0;
+
+
+/**
+ * @brief Worker thread: execute the tasks of one device in order
+ *
+ * @param lpParam Worker context
+ * @return NULL
+ */
+static void* workerThread(void* lpParam) {
+  mmwlWorker_t* worker = (mmwlWorker_t*)lpParam;
+
+  while (1) {
+    unsigned int tail;
+    sem_wait(&worker->pending);
+
+    tail = atomic_load_explicit(&worker->tail, memory_order_relaxed);
+    if (tail == atomic_load_explicit(&worker->head, memory_order_acquire)) {
+      /* Woken up without task: stop request */
+      if (!worker->running) break;
+      continue;
+    }
+
+    taskData* task = &worker->queue[tail & (MMWL_WORKER_QUEUE_SIZE - 1)];
+    mmwlFuture_t* future = worker->futures[tail & (MMWL_WORKER_QUEUE_SIZE - 1)];
+    uint64_t profStart = TDA_PROF_START();
+    rlReturnVal_t retVal = executeTask(task);
+    if (profStart != 0U) {
+      TDAProfSpan(TDA_PROF_TASK, task->deviceIndex, task->apiInfo, NULL, profStart, TDAProfNow());
+    }
+
+    atomic_store_explicit(&worker->tail, tail + 1, memory_order_release);
+    future->retVal = retVal;
+    sem_post(&future->done);
+  }
+  return NULL;
+}
+
+
+/**
+ * @brief Stop the first numWorkers workers, after their pending tasks
+ */
+static void stopWorkers(unsigned char numWorkers) {
+  for (unsigned char devIndex = 0; devIndex < numWorkers; devIndex++) {
+    mmwl_workers[devIndex].running = 0;
+    sem_post(&mmwl_workers[devIndex].pending);
+  }
+  for (unsigned char devIndex = 0; devIndex < numWorkers; devIndex++) {
+    pthread_join(mmwl_workers[devIndex].thread, NULL);
+    sem_destroy(&mmwl_workers[devIndex].pending);
+    pthread_mutex_destroy(&mmwl_workers[devIndex].producerLock);
+  }
+}
+
+
+static int startWorkerPool(void) {
+  for (unsigned char devIndex = 0; devIndex < TDA_NUM_CONNECTED_DEVICES_MAX; devIndex++) {
+    mmwlWorker_t* worker = &mmwl_workers[devIndex];
+
+    worker->deviceIndex = devIndex;
+    atomic_init(&worker->head, 0U);
+    atomic_init(&worker->tail, 0U);
+    sem_init(&worker->pending, 0, 0);
+    pthread_mutex_init(&worker->producerLock, NULL);
+    worker->running = 1;
+    if (pthread_create(&worker->thread, NULL, workerThread, worker) != 0) {
+      sem_destroy(&worker->pending);
+      pthread_mutex_destroy(&worker->producerLock);
+      stopWorkers(devIndex);
+      return RL_RET_CODE_RADAR_OSIF_ERROR;
+    }
+    osiThreadTune(worker->thread);
+  }
+  return RL_RET_CODE_OK;
+}
+
+
+/** @fn int MMWL_workerPoolInit(void)
+*
+*   @brief Start the device worker pool.
+*
+*   @return int Success - 0, Failure - Error Code
+*
+*   The pool is started on the first API call if not done explicitly, and
+*   again on the first one after MMWL_workerPoolDeInit.
+*/
+int MMWL_workerPoolInit(void) {
+  int retVal = RL_RET_CODE_OK;
+
+  if (atomic_load_explicit(&mmwl_workerPoolStarted, memory_order_acquire)) return retVal;
+
+  pthread_mutex_lock(&mmwl_workerPoolLock);
+  if (!atomic_load_explicit(&mmwl_workerPoolStarted, memory_order_relaxed)) {
+    retVal = startWorkerPool();
+    if (retVal == RL_RET_CODE_OK) {
+      atomic_store_explicit(&mmwl_workerPoolStarted, 1, memory_order_release);
+    }
+  }
+  pthread_mutex_unlock(&mmwl_workerPoolLock);
+  return retVal;
+}
+
+
+/** @fn void MMWL_workerPoolDeInit(void)
+*
+*   @brief Stop the device worker pool.
+*
+*   Pending tasks are completed before the workers exit.
+*/
+void MMWL_workerPoolDeInit(void) {
+  pthread_mutex_lock(&mmwl_workerPoolLock);
+  if (atomic_load_explicit(&mmwl_workerPoolStarted, memory_order_relaxed)) {
+    atomic_store_explicit(&mmwl_workerPoolStarted, 0, memory_order_relaxed);
+    stopWorkers(TDA_NUM_CONNECTED_DEVICES_MAX);
+  }
+  pthread_mutex_unlock(&mmwl_workerPoolLock);
+}
+
+
+/** @fn int MMWL_submitTask(taskData *task, mmwlFuture_t *future)
+*
+*   @brief Enqueue a task on the worker of its device.
+*
+*   @param[in] task - Task to execute (copied into the queue)
+*   @param[in] future - Completion object, signaled once the task is done
+*
+*   @return int Success - 0, Failure - Error Code
+*/
+int MMWL_submitTask(taskData *task, mmwlFuture_t *future) {
+  mmwlWorker_t* worker;
+  unsigned int head;
+
+  if ((task == NULL) || (future == NULL) ||
+      (task->deviceIndex >= TDA_NUM_CONNECTED_DEVICES_MAX)) {
+    return RL_RET_CODE_INVALID_INPUT;
+  }
+  if (MMWL_workerPoolInit() != RL_RET_CODE_OK) return RL_RET_CODE_RADAR_OSIF_ERROR;
+  worker = &mmwl_workers[task->deviceIndex];
+
+  sem_init(&future->done, 0, 0);
+  future->retVal = -1;
+
+  pthread_mutex_lock(&worker->producerLock);
+  head = atomic_load_explicit(&worker->head, memory_order_relaxed);
+  /* Queue full: wait for the worker to free a slot */
+  while ((head - atomic_load_explicit(&worker->tail, memory_order_acquire)) >=
+          MMWL_WORKER_QUEUE_SIZE) {
+    sched_yield();
+  }
+  worker->queue[head & (MMWL_WORKER_QUEUE_SIZE - 1)] = *task;
+  worker->futures[head & (MMWL_WORKER_QUEUE_SIZE - 1)] = future;
+  atomic_store_explicit(&worker->head, head + 1, memory_order_release);
+  pthread_mutex_unlock(&worker->producerLock);
+
+  sem_post(&worker->pending);
+  return RL_RET_CODE_OK;
+}
+
+
+/** @fn rlReturnVal_t MMWL_waitTask(mmwlFuture_t *future)
+*
+*   @brief Wait for the completion of a task.
+*
+*   @param[in] future - Completion object given at submission
+*
+*   @return rlReturnVal_t Return value of the API executed by the task
+*/
+rlReturnVal_t MMWL_waitTask(mmwlFuture_t *future) {
+  while (sem_wait(&future->done) != 0) {
+    if (errno != EINTR) return -1;
+  }
+  sem_destroy(&future->done);
+  return future->retVal;
+}
+
+
+/**
+ * @brief Dispatch an API call to every device of the device map in parallel
+ *
+ * Each device gets its own payload and flag, which allows the caller to send
+ * a different configuration (e.g. a chirp table) to each device in one go.
+ *
+ * @param apiInfo API type and index in the function table
+ * @param deviceMap Devices to call the API on
+ * @param apiParams Payload per device index (NULL entries are not allowed for
+ *                  the devices present in deviceMap)
+ * @param flags Flag per device index (count of elements for TYPE C API)
+ * @return int Bitwise OR of the individual return values
+ */
+int callThreadApiPerDevice(unsigned int apiInfo, unsigned int deviceMap,
+      void **apiParams, unsigned int *flags) {
+  int  retVal = RL_RET_CODE_OK;
+  mmwlFuture_t futures[TDA_NUM_CONNECTED_DEVICES_MAX];
+  unsigned char submitted = 0U;
+  uint64_t profStart = TDA_PROF_START();
+
+  for (unsigned char devIndex = 0; devIndex < TDA_NUM_CONNECTED_DEVICES_MAX; devIndex++) {
+    if ((deviceMap & (1U << devIndex)) != 0U) {
+      taskData task = {
+        .deviceIndex = devIndex,
+        .apiInfo = apiInfo,
+        .payLoad = apiParams[devIndex],
+        .flag = flags[devIndex],
+      };
+      if (MMWL_submitTask(&task, &futures[devIndex]) == RL_RET_CODE_OK) {
+        submitted |= (1U << devIndex);
+      } else {
+        retVal |= -1;
+      }
+    }
+  }
+
+  for (unsigned char devIndex = 0; devIndex < TDA_NUM_CONNECTED_DEVICES_MAX; devIndex++) {
+    if ((submitted & (1U << devIndex)) != 0U) {
+      retVal |= MMWL_waitTask(&futures[devIndex]);
+    }
+  }
+  if (profStart != 0U) {
+    TDAProfSpan(TDA_PROF_API, TDA_PROF_HOST, apiInfo, NULL, profStart, TDAProfNow());
+  }
+  return retVal;
+}
+
+
+int callThreadApi(unsigned int apiInfo, unsigned int deviceMap, void *apiParams, unsigned int flags) {
+  void *payloads[TDA_NUM_CONNECTED_DEVICES_MAX];
+  unsigned int devFlags[TDA_NUM_CONNECTED_DEVICES_MAX];
+
+  for (int devIndex = 0; devIndex < TDA_NUM_CONNECTED_DEVICES_MAX; devIndex++) {
+    payloads[devIndex] = apiParams;
+    devFlags[devIndex] = flags;
+  }
+  return callThreadApiPerDevice(apiInfo, deviceMap, payloads, devFlags);
+}
+
+#define CALL_API(m,n,o,p)  callThreadApi(m, n, o, p)
+
+
+/******************************************************************************
+* SET-CONFIG TRANSACTIONS
+*******************************************************************************
+*/
+
+/* Largest payload of a message, leaving room for the CRC alignment bytes */
+#define MMWL_TXN_MSG_PAYLOAD_MAX  (RL_CMD_PL_LEN_MAX - RL_PROTOCOL_ALIGN_SIZE)
+
+
+/** @fn void MMWL_txnInit(mmwlTxn_t *txn, unsigned char deviceMap)
+*
+*   @brief Start an empty set-config transaction.
+*
+*   @param[in] txn - Transaction
+*   @param[in] deviceMap - Devices the sub-blocks are sent to
+*/
+void MMWL_txnInit(mmwlTxn_t *txn, unsigned char deviceMap) {
+  txn->deviceMap = deviceMap;
+  txn->numEntries = 0U;
+  txn->numMessages = 0U;
+  txn->used = 0U;
+}
+
+
+/** @fn int MMWL_txnAdd(mmwlTxn_t *txn, rlUInt16_t msgId, rlUInt16_t sbcId,
+*                       const void *data, rlUInt16_t len)
+*
+*   @brief Queue the sub-block of a set API.
+*
+*   @param[in] txn - Transaction
+*   @param[in] msgId - Message ID of the set API (RL_*_SET_MSG)
+*   @param[in] sbcId - Sub-block ID of the set API (RL_*_SB)
+*   @param[in] data - Payload, copied into the transaction
+*   @param[in] len - Payload length
+*
+*   @return int Index of the sub-block in the transaction, Failure - Error Code
+*/
+int MMWL_txnAdd(mmwlTxn_t *txn, rlUInt16_t msgId, rlUInt16_t sbcId,
+                const void *data, rlUInt16_t len) {
+  mmwlTxnEntry_t *entry;
+
+  if ((txn->numEntries >= MMWL_TXN_MAX_ENTRIES) ||
+      ((unsigned int)txn->used + len > MMWL_TXN_BUFFER_SIZE) ||
+      (len + RL_MIN_SBC_LEN > MMWL_TXN_MSG_PAYLOAD_MAX)) {
+    return RL_RET_CODE_INVALID_INPUT;
+  }
+  entry = &txn->entries[txn->numEntries];
+  entry->msgId = msgId;
+  entry->sbcId = sbcId;
+  entry->offset = txn->used;
+  entry->len = len;
+  for (unsigned char devIndex = 0; devIndex < TDA_NUM_CONNECTED_DEVICES_MAX; devIndex++) {
+    entry->status[devIndex] = RL_RET_CODE_OK;
+  }
+  memcpy(&txn->buffer[txn->used], data, len);
+  /* Keep the payloads 4 bytes aligned */
+  txn->used += (len + 3U) & ~3U;
+  return (int)(txn->numEntries++);
+}
+
+
+/* Sub-blocks of the set APIs used by the configuration sequence */
+int MMWL_txnLdoBypass(mmwlTxn_t *txn, rlRfLdoBypassCfg_t rfLdoBypassCfgArgs) {
+  return MMWL_txnAdd(txn, RL_RF_MISC_CONF_SET_MSG, RL_RF_LDOBYPASS_SET_SB,
+                     &rfLdoBypassCfgArgs, sizeof(rlRfLdoBypassCfg_t));
+}
+
+int MMWL_txnDataFmt(mmwlTxn_t *txn, rlDevDataFmtCfg_t dataFmtCfgArgs) {
+  return MMWL_txnAdd(txn, RL_DEV_CONFIG_SET_MSG, RL_DEV_RX_DATA_FORMAT_CONF_SET_SB,
+                     &dataFmtCfgArgs, sizeof(rlDevDataFmtCfg_t));
+}
+
+int MMWL_txnLowPower(mmwlTxn_t *txn, rlLowPowerModeCfg_t rfLpModeCfgArgs) {
+  return MMWL_txnAdd(txn, RL_RF_STATIC_CONF_SET_MSG, RL_RF_LOWPOWERMODE_CONF_SB,
+                     &rfLpModeCfgArgs, sizeof(rlLowPowerModeCfg_t));
+}
+
+int MMWL_txnApllSynthBw(mmwlTxn_t *txn) {
+  /* Same settings as MMWL_ApllSynthBwConfig */
+  rlRfApllSynthBwControl_t rfApllSynthBwCfgArgs = { 0 };
+  rfApllSynthBwCfgArgs.synthIcpTrim = 3;
+  rfApllSynthBwCfgArgs.synthRzTrim = 8;
+  rfApllSynthBwCfgArgs.apllIcpTrim = 38;
+  rfApllSynthBwCfgArgs.apllRzTrimLpf = 9;
+  rfApllSynthBwCfgArgs.apllRzTrimVco = 0;
+  return MMWL_txnAdd(txn, RL_RF_STATIC_CONF_SET_MSG, RL_RF_APLL_SYNTH_BW_CTL_SB,
+                     &rfApllSynthBwCfgArgs, sizeof(rlRfApllSynthBwControl_t));
+}
+
+int MMWL_txnMisc(mmwlTxn_t *txn, rlRfMiscConf_t miscCfg) {
+  return MMWL_txnAdd(txn, RL_RF_STATIC_CONF_SET_MSG, RL_RF_RADAR_MISC_CTL_SB,
+                     &miscCfg, sizeof(rlRfMiscConf_t));
+}
+
+int MMWL_txnDataPath(mmwlTxn_t *txn, rlDevDataPathCfg_t dataPathCfgArgs) {
+  return MMWL_txnAdd(txn, RL_DEV_CONFIG_SET_MSG, RL_DEV_RX_DATA_PATH_CONF_SET_SB,
+                     &dataPathCfgArgs, sizeof(rlDevDataPathCfg_t));
+}
+
+/* Data rate then high speed clock, as MMWL_hsiClockConfig (first sub-block returned) */
+int MMWL_txnHsiClock(mmwlTxn_t *txn, rlDevDataPathClkCfg_t dataPathClkCfgArgs,
+                     rlDevHsiClk_t hsiClkgs) {
+  rlUInt16_t used = txn->used;
+  int entry = MMWL_txnAdd(txn, RL_DEV_CONFIG_SET_MSG, RL_DEV_DATA_PATH_CLOCK_SET_SB,
+                          &dataPathClkCfgArgs, sizeof(rlDevDataPathClkCfg_t));
+  if (entry < 0) return entry;
+  if (MMWL_txnAdd(txn, RL_RF_STATIC_CONF_SET_MSG, RL_RF_HIGHSPEEDINTFCLK_CONF_SET_SB,
+                  &hsiClkgs, sizeof(rlDevHsiClk_t)) < 0) {
+    /* Both or none */
+    txn->numEntries--;
+    txn->used = used;
+    return RL_RET_CODE_INVALID_INPUT;
+  }
+  return entry;
+}
+
+int MMWL_txnCSI2Lane(mmwlTxn_t *txn, rlDevCsi2Cfg_t CSI2LaneCfgArgs) {
+  return MMWL_txnAdd(txn, RL_DEV_CONFIG_SET_MSG, RL_DEV_CSI2_CFG_SET_SB,
+                     &CSI2LaneCfgArgs, sizeof(rlDevCsi2Cfg_t));
+}
+
+
+/**
+ * @brief Number of sub-blocks of the message starting at a sub-block
+ *
+ * @param txn Transaction
+ * @param first First sub-block of the message
+ * @return unsigned int Number of sub-blocks packed into the message
+ */
+static unsigned int txnMessageSize(const mmwlTxn_t *txn, unsigned int first) {
+  unsigned int count = 0U, payloadLen = 0U;
+
+  while ((first + count < txn->numEntries) && (count < RL_MAX_SB_IN_MSG)) {
+    const mmwlTxnEntry_t *entry = &txn->entries[first + count];
+
+    if ((entry->msgId != txn->entries[first].msgId) ||
+        (payloadLen + entry->len + RL_MIN_SBC_LEN > MMWL_TXN_MSG_PAYLOAD_MAX)) {
+      break;
+    }
+    payloadLen += entry->len + RL_MIN_SBC_LEN;
+    count++;
+  }
+  return count;
+}
+
+
+/**
+ * @brief Send the sub-blocks of a message to one device
+ *
+ * @param devIndex Device index
+ * @param txn Transaction
+ * @param first First sub-block
+ * @param count Number of sub-blocks
+ * @return rlReturnVal_t Status of the message
+ */
+static rlReturnVal_t txnSendMessage(unsigned char devIndex, mmwlTxn_t *txn,
+                                    unsigned int first, unsigned int count) {
+  rlDriverMsg_t inMsg = {0};
+  rlDriverMsg_t outMsg = {0};
+  rlPayloadSb_t inPayloadSb[RL_MAX_SB_IN_MSG];
+  rlUInt16_t msgId = txn->entries[first].msgId;
+
+  rlDriverConstructInMsg(msgId, &inMsg, inPayloadSb);
+  for (unsigned int index = 0; index < count; index++) {
+    mmwlTxnEntry_t *entry = &txn->entries[first + index];
+    rlDriverFillPayload(msgId, entry->sbcId, &inPayloadSb[index],
+                        &txn->buffer[entry->offset], entry->len);
+  }
+  inMsg.opcode.nsbc = (rlUInt16_t)count;
+  return rlDriverCmdInvoke((rlUInt8_t)(1U << devIndex), inMsg, &outMsg);
+}
+
+
+/**
+ * @brief Send a transaction to one device (run by the worker of the device)
+ *
+ * A device rejects a whole message when one of its sub-blocks is invalid.
+ * The sub-blocks of a rejected message are then sent one by one to report
+ * the status of each of them. As in the unpacked sequence, the following
+ * messages are sent anyway.
+ *
+ * @param devIndex Device index
+ * @param txn Transaction
+ * @return rlReturnVal_t Bitwise OR of the status of the sub-blocks
+ */
+static rlReturnVal_t txnExecute(unsigned char devIndex, mmwlTxn_t *txn) {
+  rlReturnVal_t retVal = RL_RET_CODE_OK;
+  unsigned int first = 0U;
+
+  while (first < txn->numEntries) {
+    unsigned int count = txnMessageSize(txn, first);
+    rlReturnVal_t msgVal = txnSendMessage(devIndex, txn, first, count);
+
+    if ((msgVal != RL_RET_CODE_OK) && (count > 1U)) {
+      DEBUG_PRINT(
+        "Device map %u : Message 0x%X of %u sub-blocks failed with error code %d, sending them one by one\n\n",
+        (1U << devIndex), txn->entries[first].msgId, count, msgVal
+      );
+      for (unsigned int index = first; index < first + count; index++) {
+        txn->entries[index].status[devIndex] = txnSendMessage(devIndex, txn, index, 1U);
+        retVal |= txn->entries[index].status[devIndex];
+      }
+    }
+    else {
+      for (unsigned int index = first; index < first + count; index++) {
+        txn->entries[index].status[devIndex] = msgVal;
+      }
+      retVal |= msgVal;
+    }
+    first += count;
+  }
+  return retVal;
+}
+
+
+/** @fn int MMWL_txnCommit(mmwlTxn_t *txn)
+*
+*   @brief Send the queued sub-blocks to the devices of the transaction.
+*
+*   @param[in] txn - Transaction
+*
+*   @return int Bitwise OR of the status of the sub-blocks on every device
+*
+*   The devices are configured in parallel by their workers. The status of
+*   each sub-block is read back with MMWL_txnStatus.
+*/
+int MMWL_txnCommit(mmwlTxn_t *txn) {
+  int retVal;
+
+  if (rlDriverIsDeviceMapValid(txn->deviceMap) != RL_RET_CODE_OK) {
+    return RL_RET_CODE_INVALID_INPUT;
+  }
+  txn->numMessages = 0U;
+  for (unsigned int first = 0U; first < txn->numEntries;
+       first += txnMessageSize(txn, first)) {
+    txn->numMessages++;
+  }
+  if (txn->numEntries == 0U) return RL_RET_CODE_OK;
+
+  retVal = callThreadApi(API_TYPE_D, txn->deviceMap, txn, 0);
+  DEBUG_PRINT(
+    "Device map %u : %u sub-blocks sent in %u messages per device \n\n",
+    txn->deviceMap, txn->numEntries, txn->numMessages
+  );
+  return retVal;
+}
+
+
+/** @fn int MMWL_txnStatus(const mmwlTxn_t *txn, int entry)
+*
+*   @brief Status of a sub-block after the commit.
+*
+*   @param[in] txn - Transaction
+*   @param[in] entry - Index returned when the sub-block was queued
+*
+*   @return int Bitwise OR of the status of the sub-block on every device
+*/
+int MMWL_txnStatus(const mmwlTxn_t *txn, int entry) {
+  int retVal = RL_RET_CODE_OK;
+
+  if ((entry < 0) || ((unsigned int)entry >= txn->numEntries)) {
+    return RL_RET_CODE_INVALID_INPUT;
+  }
+  for (unsigned char devIndex = 0; devIndex < TDA_NUM_CONNECTED_DEVICES_MAX; devIndex++) {
+    if ((txn->deviceMap & (1U << devIndex)) != 0U) {
+      retVal |= txn->entries[entry].status[devIndex];
+    }
+  }
+  return retVal;
+}
+
+
+/******************************************************************************
+* BATCHES
+*******************************************************************************
+*/
+
+/** @fn void MMWL_batchInit(mmwlBatch_t *batch)
+*
+*   @brief Start an empty batch.
+*
+*   @param[in] batch - Batch
+*/
+void MMWL_batchInit(mmwlBatch_t *batch) {
+  batch->numCalls = 0U;
+  batch->used = 0U;
+}
+
+
+/**
+ * @brief Queue an API call on the worker of each device, without waiting
+ *
+ * @param batch Batch
+ * @param apiInfo API type and index in the function table
+ * @param deviceMap Devices to call the API on
+ * @param payload Payload, copied into the batch when len is not 0
+ * @param len Payload length
+ * @param flag Flag of the TYPE C API
+ * @return int Index of the call in the batch, Failure - Error Code
+ */
+static int batchCall(mmwlBatch_t *batch, unsigned int apiInfo, unsigned char deviceMap,
+                     void *payload, unsigned int len, unsigned int flag) {
+  unsigned int call = batch->numCalls;
+  unsigned char *buffer = (unsigned char*)batch->buffer;
+
+  if ((call >= MMWL_BATCH_MAX_CALLS) || (batch->used + len > MMWL_BATCH_BUFFER_SIZE)) {
+    return RL_RET_CODE_INVALID_INPUT;
+  }
+  if (len > 0U) {
+    memcpy(&buffer[batch->used], payload, len);
+    payload = &buffer[batch->used];
+    batch->used += (len + 7U) & ~7U;
+  }
+
+  batch->callMap[call] = 0U;
+  for (unsigned char devIndex = 0; devIndex < TDA_NUM_CONNECTED_DEVICES_MAX; devIndex++) {
+    mmwlFuture_t *future = &batch->futures[call][devIndex];
+
+    future->retVal = RL_RET_CODE_OK;
+    if ((deviceMap & (1U << devIndex)) != 0U) {
+      taskData task = {
+        .deviceIndex = devIndex,
+        .apiInfo = apiInfo,
+        .payLoad = payload,
+        .flag = flag,
+      };
+      if (MMWL_submitTask(&task, future) == RL_RET_CODE_OK) {
+        batch->callMap[call] |= (1U << devIndex);
+      } else {
+        future->retVal = -1;
+      }
+    }
+  }
+  batch->numCalls++;
+  return (int)call;
+}
+
+
+/** @fn int MMWL_batchTxn(mmwlBatch_t *batch, mmwlTxn_t *txn)
+*
+*   @brief Queue the commit of a transaction.
+*
+*   @param[in] batch - Batch
+*   @param[in] txn - Transaction, must stay valid until MMWL_batchWait returns
+*
+*   @return int Index of the call in the batch, Failure - Error Code
+*/
+int MMWL_batchTxn(mmwlBatch_t *batch, mmwlTxn_t *txn) {
+  if (rlDriverIsDeviceMapValid(txn->deviceMap) != RL_RET_CODE_OK) {
+    return RL_RET_CODE_INVALID_INPUT;
+  }
+  txn->numMessages = 0U;
+  for (unsigned int first = 0U; first < txn->numEntries;
+       first += txnMessageSize(txn, first)) {
+    txn->numMessages++;
+  }
+  /* Nothing to send, the call completes right away */
+  if (txn->numEntries == 0U) {
+    return batchCall(batch, API_TYPE_D, 0U, txn, 0U, 0U);
+  }
+  return batchCall(batch, API_TYPE_D, txn->deviceMap, txn, 0U, 0U);
+}
+
+
+/** @fn int MMWL_batchRFDeviceConfig(mmwlBatch_t *batch, unsigned char deviceMap)
+*
+*   @brief Queue the RF device configuration (see MMWL_RFDeviceConfig).
+*
+*   @return int Index of the call in the batch, Failure - Error Code
+*/
+int MMWL_batchRFDeviceConfig(mmwlBatch_t *batch, unsigned char deviceMap) {
+  rlRfDevCfg_t rfDevCfgArgs      = { 0 };
+  rfDevCfgArgs.aeDirection       = 0x5;
+  rfDevCfgArgs.aeControl         = 0x0;
+  rfDevCfgArgs.bssAnaControl     = 0x0; /* Clear Inter burst power save */
+  rfDevCfgArgs.reserved1         = 0x0;
+  rfDevCfgArgs.bssDigCtrl        = 0x0; /* Disable BSS WDT */
+  rfDevCfgArgs.aeCrcConfig       = gAwr2243CrcType;
+  rfDevCfgArgs.reserved2         = 0x0;
+  rfDevCfgArgs.reserved3         = 0x0;
 
-#define ADD_DEVICE_IND        0
-#define REMOVE_DEVICE_IND     1
-#define RF_START_IND          2
-#define RF_INIT_IND           3
-#define SENSOR_START_IND      4
-#define SENSOR_STOP_IND       5
-};
+  return batchCall(batch, RF_SET_DEVICE_CONFIG_IND, deviceMap,
+                   &rfDevCfgArgs, sizeof(rfDevCfgArgs), 0U);
+}
 
 
-rlReturnVal_t(*funcTableTypeC[])(unsigned char, unsigned short, void *) = {
-  rlSetProfileConfig,
-  rlSetChirpConfig,
-  rlRfSetPhaseShiftConfig,
-  rlDeviceFileDownloadWrap,
-  rlSetDynChirpCfg,
-  rlSetDynPerChirpPhShifterCfg,
-  rlGetProfileConfig
+/** @fn int MMWL_batchProfileConfig(mmwlBatch_t *batch, unsigned char deviceMap,
+*                                   rlProfileCfg_t profileCfgArgs)
+*
+*   @brief Queue the profile configuration (see MMWL_profileConfig).
+*
+*   @return int Index of the call in the batch, Failure - Error Code
+*/
+int MMWL_batchProfileConfig(mmwlBatch_t *batch, unsigned char deviceMap,
+                            rlProfileCfg_t profileCfgArgs) {
+  return batchCall(batch, API_TYPE_C | SET_PROFILE_CONFIG_IND, deviceMap,
+                   &profileCfgArgs, sizeof(profileCfgArgs), 1U);
+}
 
-#define SET_PROFILE_CONFIG_IND                    0
-#define SET_CHIRP_CONFIG_IND                      1
-#define RF_SET_PHASE_SHIFT_CONFIG_IND             2
-#define FILE_DOWNLOAD_IND                         3
-#define SET_DYN_CHIRP_CFG_IND                     4
-#define SET_DYN_PER_PERCHIRP_PH_SHIFTER_CFG_IND   5
-#define GET_PROFILE_CONFIG_IND                    6
+
+/** @fn int MMWL_batchProfileTable(mmwlBatch_t *batch, unsigned char deviceMap,
+*                                  rlProfileCfg_t *profileCfgArgs, unsigned short count)
+*
+*   @brief Queue the configuration of several profiles (see MMWL_profileTableConfig).
+*
+*   @return int Index of the call in the batch, Failure - Error Code
+*/
+int MMWL_batchProfileTable(mmwlBatch_t *batch, unsigned char deviceMap,
+                           rlProfileCfg_t *profileCfgArgs, unsigned short count) {
+  if ((count == 0U) || (count > RL_MAX_PROFILES_CNT)) return RL_RET_CODE_INVALID_INPUT;
+  return batchCall(batch, API_TYPE_C | SET_PROFILE_CONFIG_IND, deviceMap,
+                   profileCfgArgs, count * sizeof(rlProfileCfg_t), count);
+}
+
+
+/** @fn int MMWL_batchWait(mmwlBatch_t *batch)
+*
+*   @brief Wait for every call of the batch.
+*
+*   @param[in] batch - Batch
+*
+*   @return int Bitwise OR of the return values of the calls on every device
+*/
+int MMWL_batchWait(mmwlBatch_t *batch) {
+  int retVal = RL_RET_CODE_OK;
+
+  for (unsigned int call = 0U; call < batch->numCalls; call++) {
+    for (unsigned char devIndex = 0; devIndex < TDA_NUM_CONNECTED_DEVICES_MAX; devIndex++) {
+      if ((batch->callMap[call] & (1U << devIndex)) != 0U) {
+        MMWL_waitTask(&batch->futures[call][devIndex]);
+      }
+      retVal |= batch->futures[call][devIndex].retVal;
+    }
+  }
+  return retVal;
+}
+
+
+/** @fn int MMWL_batchStatus(const mmwlBatch_t *batch, int call)
+*
+*   @brief Return value of a call once the batch has been waited for.
+*
+*   @param[in] batch - Batch
+*   @param[in] call - Index returned when the call was queued
+*
+*   @return int Bitwise OR of the return values of the call on every device
+*/
+int MMWL_batchStatus(const mmwlBatch_t *batch, int call) {
+  int retVal = RL_RET_CODE_OK;
+
+  if ((call < 0) || ((unsigned int)call >= batch->numCalls)) {
+    return RL_RET_CODE_INVALID_INPUT;
+  }
+  for (unsigned char devIndex = 0; devIndex < TDA_NUM_CONNECTED_DEVICES_MAX; devIndex++) {
+    retVal |= batch->futures[call][devIndex].retVal;
+  }
+  return retVal;
+}
+
+
+/******************************************************************************
+* RF HEALTH MONITORING
+*******************************************************************************
+*/
+
+/* Monitoring report queued by the async event handler of a device */
+typedef struct mmwlHealthRec {
+  uint8_t monitor;
+  uint8_t numValues;
+  uint16_t statusFlags;
+  uint16_t errorCode;
+  uint32_t timeStamp;
+  int32_t value[MMWL_HEALTH_MAX_VALUES];
+} mmwlHealthRec_t;
+
+/* Single producer (async event handler of the device), single consumer
+  (MMWL_healthCollect) ring. A report is dropped when the ring is full. */
+typedef struct mmwlHealthRing {
+  uint32_t head;
+  uint32_t tail;
+  uint32_t dropped;
+  mmwlHealthRec_t rec[MMWL_HEALTH_RING_DEPTH];
+} mmwlHealthRing_t;
+
+static mmwlHealthRing_t mmwl_healthRing[MMWL_HEALTH_MAX_DEVICES];
+
+static const char *mmwl_healthNames[MMWL_HEALTH_COUNT] = {
+  "temperature", "rx gain", "tx0 power", "tx1 power", "tx2 power", "synth freq"
+};
+
+/* Names of the monitors of mmwlMonCfg_t.enable */
+static const struct {
+  const char *name;
+  unsigned char mask;
+} mmwl_monitorNames[] = {
+  { "temp", MMWL_MON_TEMPERATURE },
+  { "rx-gain", MMWL_MON_RX_GAIN_PHASE },
+  { "tx-power", MMWL_MON_TX_POWER },
+  { "synth", MMWL_MON_SYNTH_FREQ },
+  { "all", MMWL_MON_ALL },
 };
 
 
 /**
- * @brief Executed by threads to interact with the radar devices
- * 
- * @param lpParam Parameter passed onto the thread
- * @return Pointer to the thread's return status
+ * @brief Queue a monitoring report (async event handler of the device)
+ *
+ * @param devIndex Device index
+ * @param monitor MMWL_HEALTH_*
+ * @param payload Report sub-block
  */
-void* threadHandler(void* lpParam) {
-  taskData *data = (taskData*)lpParam;
-  unsigned int apiId = data->apiInfo & 0xFFFF;
-  unsigned int apiType = data->apiInfo & 0xF0000000;
+static void healthReport(unsigned char devIndex, unsigned int monitor, const rlUInt8_t *payload) {
+  mmwlHealthRing_t *ring = &mmwl_healthRing[devIndex];
+  uint32_t head = __atomic_load_n(&ring->head, __ATOMIC_RELAXED);
+  mmwlHealthRec_t *rec;
+
+  if (head - __atomic_load_n(&ring->tail, __ATOMIC_ACQUIRE) >= MMWL_HEALTH_RING_DEPTH) {
+    __atomic_fetch_add(&ring->dropped, 1U, __ATOMIC_RELAXED);
+    return;
+  }
+  rec = &ring->rec[head & (MMWL_HEALTH_RING_DEPTH - 1U)];
+  rec->monitor = (uint8_t)monitor;
+
+  switch (monitor) {
+    case MMWL_HEALTH_TEMPERATURE: {
+      const rlMonTempReportData_t *data = (const rlMonTempReportData_t*)payload;
+      rec->statusFlags = data->statusFlags;
+      rec->errorCode = data->errorCode;
+      rec->timeStamp = data->timeStamp;
+      /* 1 LSB = 1 C */
+      rec->numValues = 10U;
+      for (unsigned int i = 0; i < 10U; i++) rec->value[i] = data->tempValues[i];
+      break;
+    }
 
-  switch (apiType) {
-    case API_TYPE_A:
-      threadRetVal[data->deviceIndex] = funcTableTypeA[apiId](
-        (1 << data->deviceIndex), data->payLoad
-      );
+    case MMWL_HEALTH_RX_GAIN: {
+      const rlMonRxGainPhRep_t *data = (const rlMonRxGainPhRep_t*)payload;
+      rec->statusFlags = data->statusFlags;
+      rec->errorCode = data->errorCode;
+      rec->timeStamp = data->timeStamp;
+      /* RX0..RX3 at RF1..RF3, 1 LSB = 0.1 dB */
+      rec->numValues = 12U;
+      for (unsigned int i = 0; i < 12U; i++) rec->value[i] = data->rxGainVal[i];
       break;
+    }
 
-    case API_TYPE_B:
-      threadRetVal[data->deviceIndex] = funcTableTypeB[apiId](1 << data->deviceIndex);
+    case MMWL_HEALTH_TX0_POWER:
+    case MMWL_HEALTH_TX1_POWER:
+    case MMWL_HEALTH_TX2_POWER: {
+      const rlMonTxPowRep_t *data = (const rlMonTxPowRep_t*)payload;
+      rec->statusFlags = data->statusFlags;
+      rec->errorCode = data->errorCode;
+      rec->timeStamp = data->timeStamp;
+      /* RF1..RF3, 1 LSB = 0.1 dBm */
+      rec->numValues = 3U;
+      for (unsigned int i = 0; i < 3U; i++) rec->value[i] = data->txPowVal[i];
       break;
+    }
 
-    case API_TYPE_C:
-      threadRetVal[data->deviceIndex] = funcTableTypeC[apiId](
-        (1 << data->deviceIndex), data->flag, data->payLoad
-      );
+    case MMWL_HEALTH_SYNTH_FREQ: {
+      const rlMonSynthFreqRep_t *data = (const rlMonSynthFreqRep_t*)payload;
+      rec->statusFlags = data->statusFlags;
+      rec->errorCode = data->errorCode;
+      rec->timeStamp = data->timeStamp;
+      /* Maximum frequency error (kHz) and number of failed chirps */
+      rec->numValues = 2U;
+      rec->value[0] = data->maxFreqErVal;
+      rec->value[1] = (int32_t)data->freqFailCnt;
       break;
+    }
+
     default:
-      threadRetVal[data->deviceIndex] = -1;
+      return;
   }
+  __atomic_store_n(&ring->head, head + 1U, __ATOMIC_RELEASE);
+}
 
-  return NULL; // &threadRetVal[data->deviceIndex];
+
+/**
+ * @brief Add a report to the aggregate of its monitor
+ *
+ * @param stat Aggregate
+ * @param rec Report
+ */
+static void healthAggregate(mmwlHealthStat_t *stat, const mmwlHealthRec_t *rec) {
+  if (stat->reports == 0U) {
+    stat->status = 0xFFFFU;
+    stat->firstTimeStamp = rec->timeStamp;
+    stat->numValues = rec->numValues;
+    for (unsigned int i = 0; i < rec->numValues; i++) {
+      stat->min[i] = rec->value[i];
+      stat->max[i] = rec->value[i];
+    }
+  }
+  stat->reports++;
+  stat->status &= rec->statusFlags;
+  if (rec->errorCode != 0U) {
+    stat->errors++;
+    stat->lastError = rec->errorCode;
+  }
+  stat->lastTimeStamp = rec->timeStamp;
+  for (unsigned int i = 0; i < stat->numValues; i++) {
+    stat->last[i] = rec->value[i];
+    if (rec->value[i] < stat->min[i]) stat->min[i] = rec->value[i];
+    if (rec->value[i] > stat->max[i]) stat->max[i] = rec->value[i];
+  }
 }
 
 
-int callThreadApi(unsigned int apiInfo, unsigned int deviceMap, void *apiParams, unsigned int flags) {
-  int  retVal = RL_RET_CODE_OK;
-  HANDLE  hThreadArray[TDA_NUM_CONNECTED_DEVICES_MAX];
-  bzero(hThreadArray, TDA_NUM_CONNECTED_DEVICES_MAX * sizeof(HANDLE));
+/** @fn unsigned int MMWL_healthCollect(mmwlHealthSnapshot_t *snap)
+*
+*   @brief Aggregate the monitoring reports received since the last call.
+*
+*   No message is sent to the devices. Call often enough for the rings not
+*   to fill up (MMWL_HEALTH_RING_DEPTH reports per device), from a single
+*   thread.
+*
+*   @param[in,out] snap - Snapshot the reports are added to
+*
+*   @return unsigned int Number of reports aggregated
+*/
+unsigned int MMWL_healthCollect(mmwlHealthSnapshot_t *snap) {
+  unsigned int count = 0U;
 
-  taskData myTaskData[TDA_NUM_CONNECTED_DEVICES_MAX];
-  volatile int devIndex = 0;
-  unsigned int dmap = deviceMap;
+  for (unsigned char devIndex = 0; devIndex < MMWL_HEALTH_MAX_DEVICES; devIndex++) {
+    mmwlHealthRing_t *ring = &mmwl_healthRing[devIndex];
+    uint32_t tail = __atomic_load_n(&ring->tail, __ATOMIC_RELAXED);
+    uint32_t head = __atomic_load_n(&ring->head, __ATOMIC_ACQUIRE);
 
-  while (deviceMap != 0U) {
-    if ((deviceMap & (1U << devIndex)) != 0U) {
-      myTaskData[devIndex].deviceIndex = devIndex;
-      myTaskData[devIndex].payLoad = apiParams;
-      myTaskData[devIndex].apiInfo = apiInfo;
-      myTaskData[devIndex].flag = flags;
-      threadRetVal[devIndex] = -1;
-      /* create a thread */
-      pthread_create(&hThreadArray[devIndex], NULL, threadHandler, &myTaskData[devIndex]);
+    for (; tail != head; tail++, count++) {
+      const mmwlHealthRec_t *rec = &ring->rec[tail & (MMWL_HEALTH_RING_DEPTH - 1U)];
+      healthAggregate(&snap->stat[devIndex][rec->monitor], rec);
     }
-    deviceMap &= ~(1U << devIndex);
-    devIndex++;
+    __atomic_store_n(&ring->tail, tail, __ATOMIC_RELEASE);
+    snap->dropped[devIndex] += __atomic_exchange_n(&ring->dropped, 0U, __ATOMIC_RELAXED);
   }
+  return count;
+}
 
-  for (devIndex = 0; devIndex < 4; devIndex++) {
-    if (hThreadArray[devIndex] != 0U) {
-      // rlReturnVal_t* pRet = &threadRetVal[devIndex];
-      // rlReturnVal_t** pRetVal = NULL;
-      pthread_join(hThreadArray[devIndex], NULL);
-      retVal |= threadRetVal[devIndex];
-    }
+
+/** @fn void MMWL_healthReset(mmwlHealthSnapshot_t *snap)
+*
+*   @brief Start a new snapshot, discarding the reports not collected yet.
+*
+*   @param[out] snap - Snapshot
+*/
+void MMWL_healthReset(mmwlHealthSnapshot_t *snap) {
+  memset(snap, 0, sizeof(mmwlHealthSnapshot_t));
+  for (unsigned char devIndex = 0; devIndex < MMWL_HEALTH_MAX_DEVICES; devIndex++) {
+    mmwlHealthRing_t *ring = &mmwl_healthRing[devIndex];
+
+    __atomic_store_n(&ring->tail, __atomic_load_n(&ring->head, __ATOMIC_ACQUIRE),
+                     __ATOMIC_RELEASE);
+    __atomic_store_n(&ring->dropped, 0U, __ATOMIC_RELAXED);
   }
-  return retVal;
 }
 
-#define CALL_API(m,n,o,p)  callThreadApi(m, n, o, p)
+
+/** @fn const char* MMWL_healthName(unsigned int monitor)
+*
+*   @brief Name of an aggregate of a snapshot (MMWL_HEALTH_*).
+*/
+const char* MMWL_healthName(unsigned int monitor) {
+  return (monitor < MMWL_HEALTH_COUNT) ? mmwl_healthNames[monitor] : NULL;
+}
+
+
+/** @fn unsigned char MMWL_monitorByName(const char *name)
+*
+*   @brief Monitors of a name: "temp", "rx-gain", "tx-power", "synth" or "all".
+*
+*   @return unsigned char MMWL_MON_* mask, 0 for an unknown name
+*/
+unsigned char MMWL_monitorByName(const char *name) {
+  for (unsigned int i = 0; i < sizeof(mmwl_monitorNames) / sizeof(mmwl_monitorNames[0]); i++) {
+    if (strcmp(name, mmwl_monitorNames[i].name) == 0) return mmwl_monitorNames[i].mask;
+  }
+  return 0U;
+}
+
+
+/** @fn int MMWL_monitorConfig(unsigned char deviceMap, mmwlMonCfg_t monCfgArgs,
+*                              rlChanCfg_t rfChanCfgArgs, rlProfileCfg_t profileCfgArgs)
+*
+*   @brief Enable the RF health monitors.
+*
+*   The monitoring period and the monitors of each device are packed into
+*   one transaction per device, sent without barrier between the devices.
+*   The devices run the monitors in round robin (autonomous mode), the
+*   monitors of the TX enabled in the channel configuration are enabled.
+*   The live synthesizer monitor is only supported by the master.
+*
+*   @param[in] deviceMap - Devices to configure
+*   @param[in] monCfgArgs - Monitors to enable
+*   @param[in] rfChanCfgArgs - Channel configuration
+*   @param[in] profileCfgArgs - Profile the monitors apply to
+*
+*   @return int Success - 0, Failure - Error Code
+*/
+int MMWL_monitorConfig(unsigned char deviceMap, mmwlMonCfg_t monCfgArgs,
+                       rlChanCfg_t rfChanCfgArgs, rlProfileCfg_t profileCfgArgs) {
+  mmwlTxn_t txn[TDA_NUM_CONNECTED_DEVICES_MAX];
+  mmwlBatch_t batch;
+  rlRfCalMonTimeUntConf_t timeUnitCfg = { 0 };
+  rlTempMonConf_t tempMonCfg = { 0 };
+  rlRxGainPhaseMonConf_t rxGainPhaseMonCfg = { 0 };
+  rlTxPowMonConf_t txPowMonCfg = { 0 };
+  rlSynthFreqMonConf_t synthFreqMonCfg = { 0 };
+  unsigned char numDevices = 0U;
+
+  if (monCfgArgs.enable == 0U) return RL_RET_CODE_OK;
+  for (unsigned char devIndex = 0; devIndex < TDA_NUM_CONNECTED_DEVICES_MAX; devIndex++) {
+    if (deviceMap & (1U << devIndex)) numDevices++;
+  }
+
+  timeUnitCfg.calibMonTimeUnit = monCfgArgs.period;
+  timeUnitCfg.numOfCascadeDev = numDevices;
+  timeUnitCfg.monitoringMode = 0U;
+
+  tempMonCfg.reportMode = monCfgArgs.reportMode;
+  tempMonCfg.anaTempThreshMin = monCfgArgs.tempMin;
+  tempMonCfg.anaTempThreshMax = monCfgArgs.tempMax;
+  tempMonCfg.digTempThreshMin = monCfgArgs.tempMin;
+  tempMonCfg.digTempThreshMax = monCfgArgs.tempMax;
+  tempMonCfg.tempDiffThresh = monCfgArgs.tempDiff;
+
+  /* Gain mismatch and flatness checked against the same limit */
+  rxGainPhaseMonCfg.profileIndx = (rlUInt8_t)profileCfgArgs.profileId;
+  rxGainPhaseMonCfg.rfFreqBitMask = 0x7U;
+  rxGainPhaseMonCfg.reportMode = monCfgArgs.reportMode;
+  rxGainPhaseMonCfg.txSel = 0U;
+  rxGainPhaseMonCfg.rxGainAbsThresh = monCfgArgs.rxGainErr;
+  rxGainPhaseMonCfg.rxGainMismatchErrThresh = monCfgArgs.rxGainErr;
+  rxGainPhaseMonCfg.rxGainFlatnessErrThresh = monCfgArgs.rxGainErr;
+  rxGainPhaseMonCfg.rxGainPhaseMismatchErrThresh = 5461U; /* 30 degrees */
+
+  txPowMonCfg.profileIndx = (rlUInt8_t)profileCfgArgs.profileId;
+  txPowMonCfg.rfFreqBitMask = 0x7U;
+  txPowMonCfg.reportMode = monCfgArgs.reportMode;
+  txPowMonCfg.txPowAbsErrThresh = monCfgArgs.txPowerErr;
+  txPowMonCfg.txPowFlatnessErrThresh = monCfgArgs.txPowerErr;
+
+  synthFreqMonCfg.profileIndx = (rlUInt8_t)profileCfgArgs.profileId;
+  synthFreqMonCfg.reportMode = monCfgArgs.reportMode;
+  synthFreqMonCfg.freqErrThresh = monCfgArgs.synthFreqErr;
+  synthFreqMonCfg.monStartTime = 30; /* 6 us */
+  synthFreqMonCfg.monitorMode = 0U;  /* Live */
+
+  MMWL_batchInit(&batch);
+  for (unsigned char devIndex = 0; devIndex < TDA_NUM_CONNECTED_DEVICES_MAX; devIndex++) {
+    rlMonAnaEnables_t anaMonCfg = { 0 };
+    mmwlTxn_t *devTxn = &txn[devIndex];
+
+    if ((deviceMap & (1U << devIndex)) == 0U) continue;
+    MMWL_txnInit(devTxn, (unsigned char)(1U << devIndex));
+    timeUnitCfg.devId = devIndex;
+    MMWL_txnAdd(devTxn, RL_RF_DYNAMIC_CONF_SET_MSG, RL_RF_CALIB_MON_TIME_UNIT_SB,
+                &timeUnitCfg, sizeof(rlRfCalMonTimeUntConf_t));
+
+    if (monCfgArgs.enable & MMWL_MON_TEMPERATURE) {
+      MMWL_txnAdd(devTxn, RL_RF_MONITORING_CONF_SET_MSG, RL_RF_TEMP_MON_CONF_SB,
+                  &tempMonCfg, sizeof(rlTempMonConf_t));
+      anaMonCfg.enMask |= (1U << 0);
+    }
+    if (monCfgArgs.enable & MMWL_MON_RX_GAIN_PHASE) {
+      MMWL_txnAdd(devTxn, RL_RF_MONITORING_CONF_SET_MSG, RL_RF_RX_GAIN_PHASE_MON_CONF_SB,
+                  &rxGainPhaseMonCfg, sizeof(rlRxGainPhaseMonConf_t));
+      anaMonCfg.enMask |= (1U << 1);
+    }
+    if (monCfgArgs.enable & MMWL_MON_TX_POWER) {
+      for (unsigned int tx = 0; tx < 3U; tx++) {
+        if ((rfChanCfgArgs.txChannelEn & (1U << tx)) == 0U) continue;
+        MMWL_txnAdd(devTxn, RL_RF_MONITORING_CONF_SET_MSG, RL_RF_TX0_POW_MON_CONF_SB + tx,
+                    &txPowMonCfg, sizeof(rlTxPowMonConf_t));
+        anaMonCfg.enMask |= (1U << (4U + tx));
+      }
+    }
+    if ((monCfgArgs.enable & MMWL_MON_SYNTH_FREQ) && (devIndex == DEFAULT_MASTER_DEVICE)) {
+      MMWL_txnAdd(devTxn, RL_RF_MONITORING_CONF_SET_MSG, RL_RF_SYNTH_FREQ_MON_CONF_SB,
+                  &synthFreqMonCfg, sizeof(rlSynthFreqMonConf_t));
+      anaMonCfg.enMask |= (1U << 14);
+    }
+    /* Enabled once the monitors are configured */
+    MMWL_txnAdd(devTxn, RL_RF_MONITORING_CONF_SET_MSG, RL_RF_ANA_MON_EN_SB,
+                &anaMonCfg, sizeof(rlMonAnaEnables_t));
+    MMWL_batchTxn(&batch, devTxn);
+  }
+  return MMWL_batchWait(&batch);
+}
 
 
 /**
@@ -375,6 +1517,11 @@ void TDA_asyncEventHandler(rlUInt16_t deviceMap, rlUInt16_t cmdCode, rlUInt16_t
       if (ackCode == CAPTURE_CONFIG_CONNECT) {
         mmwl_bTDA_CaptureCardConnect = 1U;
       }
+      if (ackCode == SENSOR_CONFIG_SET_SOP) {
+        pthread_mutex_lock(&mmwl_eventLock);
+        mmwl_bTDA_SopACK |= (unsigned char)deviceMap;
+        pthread_mutex_unlock(&mmwl_eventLock);
+      }
       if (deviceMap == 32) {
         if (ackCode == CAPTURE_CONFIG_CREATE_APPLICATION) {
           mmwl_bTDA_CreateAppACK = 1;
@@ -473,6 +1620,7 @@ void TDA_asyncEventHandler(rlUInt16_t deviceMap, rlUInt16_t cmdCode, rlUInt16_t
       break;
     }
   }
+  eventNotify();
 }
 
 
@@ -535,6 +1683,7 @@ void MMWL_asyncEventHandler(rlUInt8_t deviceIndex, rlUInt16_t sbId,
         case RL_RF_AE_INITCALIBSTATUS_SB: {
           pthread_mutex_lock(&rlAsyncEvent);
           unsigned int deviceMap = createDevMapFromDevId(deviceIndex);
+          memcpy(&mmwl_rfInitStatus[deviceIndex], payload, sizeof(rlRfInitComplete_t));
           mmwl_bRfInitComp |= (1 << deviceIndex);
           DEBUG_PRINT("Device map %u : RF-Init Async event\n\n", deviceMap);
           pthread_mutex_unlock(&rlAsyncEvent);
@@ -582,6 +1731,24 @@ void MMWL_asyncEventHandler(rlUInt8_t deviceIndex, rlUInt16_t sbId,
           break;
         }
 
+        case RL_RF_AE_MON_TEMPERATURE_REPORT_SB: {
+          healthReport(deviceIndex, MMWL_HEALTH_TEMPERATURE, payload);
+          break;
+        }
+
+        case RL_RF_AE_MON_RX_GAIN_PHASE_REPORT: {
+          healthReport(deviceIndex, MMWL_HEALTH_RX_GAIN, payload);
+          break;
+        }
+
+        case RL_RF_AE_MON_TX0_POWER_REPORT:
+        case RL_RF_AE_MON_TX1_POWER_REPORT:
+        case RL_RF_AE_MON_TX2_POWER_REPORT: {
+          healthReport(deviceIndex,
+            MMWL_HEALTH_TX0_POWER + (asyncSB - RL_RF_AE_MON_TX0_POWER_REPORT), payload);
+          break;
+        }
+
         case RL_RF_AE_GPADC_MEAS_DATA_SB: {
           pthread_mutex_lock(&rlAsyncEvent);
           mmwl_bGpadcDataRcv |= (1 << deviceIndex);
@@ -600,6 +1767,22 @@ void MMWL_asyncEventHandler(rlUInt8_t deviceIndex, rlUInt16_t sbId,
       break;
     }
 
+    /* Async Event from RADARSS (second message of sub-blocks) */
+    case RL_RF_ASYNC_EVENT_1_MSG: {
+      switch (asyncSB) {
+        case RL_RF_AE_MON_SYNTHESIZER_FREQ_REPORT: {
+          healthReport(deviceIndex, MMWL_HEALTH_SYNTH_FREQ, payload);
+          break;
+        }
+
+        default: {
+          DEBUG_PRINT("Unhandled Async Event msgId: 0x%x, asyncSB:0x%x  \n\n", msgId, asyncSB);
+          break;
+        }
+      }
+      break;
+    }
+
     /* Async Event from MSS */
     case RL_DEV_ASYNC_EVENT_MSG: {
       switch (asyncSB) {
@@ -737,6 +1920,7 @@ void MMWL_asyncEventHandler(rlUInt8_t deviceIndex, rlUInt16_t sbId,
       break;
     }
   }
+  eventNotify();
 }
 
 
@@ -752,15 +1936,19 @@ void MMWL_asyncEventHandler(rlUInt8_t deviceIndex, rlUInt16_t sbId,
 *
 *   @return int Success - 0, Failure - Error Code
 *
-*   Compute the CRC of given data
+*   Compute the CRC of given data with the slice-by-8/hardware CRC engine
 */
 int MMWL_computeCRC(unsigned char* data, unsigned int dataLen, unsigned char crcLen, unsigned char* outCrc) {
-    uint64_t crcResult = computeCRC(data, dataLen, (16 << crcLen));
+    uint64_t crcResult = MMWL_crcCompute(crcLen, data, dataLen);
     memcpy(outCrc, &crcResult, (2 << crcLen));
     return 0;
 }
 
 
+static int MMWL_initMasterLink(unsigned char deviceMap, uint32_t rlClientCbsTimeout,
+                               unsigned char waitPowerUp);
+
+
 /** @fn int MMWL_powerOnMaster(deviceMap)
 *
 *   @brief Power on Master API.
@@ -773,7 +1961,24 @@ int MMWL_computeCRC(unsigned char* data, unsigned int dataLen, unsigned char crc
 *   Power on Master API.
 */
 int MMWL_powerOnMaster(unsigned char deviceMap, uint32_t rlClientCbsTimeout) {
-  int retVal = RL_RET_CODE_OK, timeOutCnt = 0;
+  return MMWL_initMasterLink(deviceMap, rlClientCbsTimeout, TRUE);
+}
+
+
+/** @fn int MMWL_initMasterLink(deviceMap, rlClientCbsTimeout, waitPowerUp)
+*
+*   @brief Initialize mmWaveLink for the master device.
+*
+*   @param[in] deviceMap - Devic Index
+*   @param[in] rlClientCbsTimeout - Timeout to use for mmwavelink client in ms
+*   @param[in] waitPowerUp - Wait for the power up done event of the device.
+*                            FALSE when the device is already running.
+*
+*   @return int Success - 0, Failure - Error Code
+*/
+static int MMWL_initMasterLink(unsigned char deviceMap, uint32_t rlClientCbsTimeout,
+                               unsigned char waitPowerUp) {
+  int retVal = RL_RET_CODE_OK;
   /*
     \subsection     porting_step1   Step 1 - Define mmWaveLink client callback structure
   The mmWaveLink framework is ported to different platforms using mmWaveLink client callbacks. These
@@ -882,6 +2087,7 @@ int MMWL_powerOnMaster(unsigned char deviceMap, uint32_t rlClientCbsTimeout) {
   initializes buffers, register interrupts, bring mmWave front end out of reset.
   */
   retVal = rlDevicePowerOn(deviceMap, clientCtx);
+  if (!waitPowerUp) return retVal;
 
   /*  \subsection     porting_step9     step 9 - Test if porting is successful
   Once configuration is complete and mmWave device is powered On, mmWaveLink driver receives
@@ -890,13 +2096,9 @@ int MMWL_powerOnMaster(unsigned char deviceMap, uint32_t rlClientCbsTimeout) {
   Refer to \ref MMWL_asyncEventHandler for event details
 @Note: In case of ES1.0 sample application needs to wait for MSS CPU fault as well with some timeout.
   */
-  while ((mmwl_bInitComp & deviceMap) != deviceMap) {
-    msleep(1); /*Sleep 1 msec*/
-    timeOutCnt++;
-    if (timeOutCnt > MMWL_API_INIT_TIMEOUT) {
-      retVal = RL_RET_CODE_RESP_TIMEOUT;
-      break;
-    }
+  if (eventWait(MMWL_EVT_POWER_UP, &mmwl_bInitComp, deviceMap, TRUE,
+                MMWL_API_INIT_TIMEOUT) != RL_RET_CODE_OK) {
+    retVal = RL_RET_CODE_RESP_TIMEOUT;
   }
   mmwl_bInitComp = 0U;
   return retVal;
@@ -916,111 +2118,223 @@ int MMWL_fileWrite(unsigned char deviceMap, unsigned short remChunks,
 }
 
 
-/** @fn int MMWL_fileDownload((unsigned char deviceMap,
-                  mmwlFileType_t fileType,
-                  unsigned int fileLen)
+/** @fn int MMWL_buildFwChunkTable(unsigned int fileLen)
+*
+*   @brief Build the firmware download chunk table.
+*
+*   @param[in] fileLen - firmware/file length
+*
+*   @return int Success - 0, Failure - Error Code
+*
+*   The meta image is split once into ready to send file chunks (the 8 bytes
+*   header with file type and length followed by the image), so that each
+*   download only has to hand the pre-built chunks over to mmWaveLink.
+*/
+int MMWL_buildFwChunkTable(unsigned int fileLen) {
+  unsigned char* pImgBuffer = (unsigned char*)&metaImage[0];
+  unsigned int totalLen = fileLen + 8;
+  unsigned int offset = 0;
+  unsigned char header[8];
+
+  if (mmwl_fwChunkTable != NULL) return RL_RET_CODE_OK;
+
+  mmwl_fwNumChunks = (totalLen + MMWL_FW_CHUNK_SIZE - 1) / MMWL_FW_CHUNK_SIZE;
+  mmwl_fwChunkTable = (rlFileData_t*)calloc(mmwl_fwNumChunks, sizeof(rlFileData_t));
+  if (mmwl_fwChunkTable == NULL) {
+    mmwl_fwNumChunks = 0;
+    return RL_RET_CODE_MALLOC_ERROR;
+  }
+
+  *((unsigned int*)&header[0]) = (unsigned int)MMWL_FILETYPE_META_IMG;
+  *((unsigned int*)&header[4]) = (unsigned int)fileLen;
+
+  for (unsigned int i = 0; i < mmwl_fwNumChunks; i++) {
+    unsigned char* pData = (unsigned char*)mmwl_fwChunkTable[i].fData;
+    unsigned int chunkLen = totalLen - offset;
+    unsigned int pos = 0;
+
+    if (chunkLen > MMWL_FW_CHUNK_SIZE) chunkLen = MMWL_FW_CHUNK_SIZE;
+    mmwl_fwChunkTable[i].chunkLen = chunkLen;
+
+    /* The first chunk starts with the file header */
+    for (; (offset < 8) && (pos < chunkLen); pos++, offset++) {
+      pData[pos] = header[offset];
+    }
+    memcpy(&pData[pos], &pImgBuffer[offset - 8], chunkLen - pos);
+    offset += chunkLen - pos;
+  }
+  return RL_RET_CODE_OK;
+}
+
+
+/** @fn int MMWL_fileDownload((unsigned char deviceMap,
+                  mmwlFileType_t fileType,
+                  unsigned int fileLen)
+*
+*   @brief Firmware Download API.
+*
+*   @param[in] deviceMap - Devic Index
+*    @param[in] fileType - firmware/file type
+*    @param[in] fileLen - firmware/file length
+*
+*   @return int Success - 0, Failure - Error Code
+*
+*   Firmware Download API. All the devices of the device map receive each
+*   chunk concurrently.
+*/
+int MMWL_fileDownload(unsigned char deviceMap, unsigned int fileLen) {
+  int ret_val = -1;
+  unsigned short usProgress = 0;
+
+  ret_val = MMWL_buildFwChunkTable(fileLen);
+  if (ret_val != RL_RET_CODE_OK) {
+    DEBUG_PRINT(
+      "Device map %u : MMWL_fileDwld Fail. Unable to build chunk table \n\n\r",
+      deviceMap
+    );
+    return ret_val;
+  }
+
+  DEBUG_PRINT("Device map %u : Download in Progress: ", deviceMap);
+  for (unsigned int i = 0; i < mmwl_fwNumChunks; i++) {
+    unsigned short remChunks = (unsigned short)(mmwl_fwNumChunks - 1 - i);
+
+    usProgress = ((i * 100) / mmwl_fwNumChunks);
+    DEBUG_PRINT("%d%%..", usProgress);
+
+    ret_val = CALL_API(API_TYPE_C | FILE_DOWNLOAD_IND, deviceMap,
+                       &mmwl_fwChunkTable[i], remChunks);
+    if (ret_val < 0) {
+      DEBUG_PRINT(
+        "\n\n\r Device map %u : MMWL_fileDwld chunk %u Fail : Ftype: %d\n\n\r",
+        deviceMap, i, MMWL_FILETYPE_META_IMG
+      );
+      return ret_val;
+    }
+  }
+  DEBUG_PRINT("Done!\n\n");
+  return ret_val;
+}
+
+
+/** @fn int MMWL_writeFileAtomic(const char *path, const void *data, size_t size)
+*
+*   @brief Replace a file with a record.
+*
+*   @param[in] path - File to replace
+*   @param[in] data - Record
+*   @param[in] size - Size of the record
+*
+*   @return int Success - 0, Failure - -1
+*
+*   The record is written to a temporary file renamed over the file, so a
+*   failed or interrupted write never leaves a truncated record behind.
+*/
+static int MMWL_writeFileAtomic(const char *path, const void *data, size_t size) {
+  char tmpPath[256];
+  FILE *fp;
+  size_t count;
+
+  if (snprintf(tmpPath, sizeof(tmpPath), "%s.tmp", path) >= (int)sizeof(tmpPath)) return -1;
+  fp = fopen(tmpPath, "wb");
+  if (fp == NULL) return -1;
+  count = fwrite(data, size, 1, fp);
+  if ((fclose(fp) != 0) || (count != 1) || (rename(tmpPath, path) != 0)) {
+    remove(tmpPath);
+    return -1;
+  }
+  return RL_RET_CODE_OK;
+}
+
+
+/** @fn uint32_t MMWL_fwImageHash(void)
+*
+*   @brief Compute the identity of the embedded meta image.
+*
+*   @return uint32_t FNV-1a hash of the meta image
+*/
+static uint32_t MMWL_fwImageHash(void) {
+  static uint32_t hash = 0;
+  const unsigned char* pImg = (const unsigned char*)&metaImage[0];
+
+  if (hash != 0) return hash;
+  hash = 2166136261U;
+  for (unsigned int i = 0; i < MMWL_META_IMG_FILE_SIZE; i++) {
+    hash = (hash ^ pImg[i]) * 16777619U;
+  }
+  return hash;
+}
+
+
+/** @fn int MMWL_isFwResident(unsigned char deviceMap)
 *
-*   @brief Firmware Download API.
+*   @brief Check which devices already run the expected firmware.
 *
 *   @param[in] deviceMap - Devic Index
-*    @param[in] fileType - firmware/file type
-*    @param[in] fileLen - firmware/file length
 *
-*   @return int Success - 0, Failure - Error Code
+*   @return unsigned char Map of the devices where the image is resident
 *
-*   Firmware Download API.
+*   The MSS patch version reported by each device is compared with the one
+*   recorded in MMWL_FW_CACHE_FILE after the last successful download of the
+*   same image. A device without patch reports a null patch version.
 */
-int MMWL_fileDownload(unsigned char deviceMap, unsigned int fileLen) {
-  unsigned int imgLen = fileLen;
-  int ret_val = -1;
-  int mmwl_iRemChunks = 0;
-  unsigned short usChunkLen = 0U;
-  unsigned int iNumChunks = 0U;
-  unsigned short usLastChunkLen = 0;
-  unsigned short usFirstChunkLen = 0;
-  unsigned short usProgress = 0;
-
-  /*First Chunk*/
-  unsigned char firstChunk[MMWL_FW_CHUNK_SIZE];
-  unsigned char* pmmwl_imgBuffer = NULL;
-
-  pmmwl_imgBuffer = (unsigned char*)&metaImage[0];
-
-  if(pmmwl_imgBuffer == NULL) {
-    DEBUG_PRINT(
-      "Device map %u : MMWL_fileDwld Fail. File Buffer is NULL \n\n\r",
-      deviceMap
-    );
-    return -1;
+unsigned char MMWL_isFwResident(unsigned char deviceMap) {
+  mmwlFwCache_t cache = { 0 };
+  unsigned char residentMap = 0U;
+  FILE* fp = fopen(MMWL_FW_CACHE_FILE, "rb");
+
+  if (fp == NULL) return 0U;
+  if (fread(&cache, sizeof(cache), 1, fp) != 1) cache.imageLen = 0;
+  fclose(fp);
+
+  if ((cache.imageLen != MMWL_META_IMG_FILE_SIZE) ||
+      (cache.imageHash != MMWL_fwImageHash())) {
+    return 0U;
   }
 
-  /*Download to Device*/
-  usChunkLen = MMWL_FW_CHUNK_SIZE;
-  iNumChunks = (imgLen + 8) / usChunkLen;
-  mmwl_iRemChunks = iNumChunks;
+  for (unsigned char devId = 0; devId < TDA_NUM_CONNECTED_DEVICES_MAX; devId++) {
+    rlFwVersionParam_t mssVer = { 0 };
+    unsigned char devMap = createDevMapFromDevId(devId);
 
-  if (mmwl_iRemChunks > 0) {
-    usLastChunkLen = (imgLen + 8) % usChunkLen;
-    usFirstChunkLen = MMWL_FW_CHUNK_SIZE;
-    mmwl_iRemChunks += 1;
-  } else {
-    usFirstChunkLen = imgLen + 8;
-  }
+    if ((deviceMap & devMap) == 0U) continue;
+    if (CALL_API(GET_MSS_VERSION_IND, devMap, &mssVer, 0) != RL_RET_CODE_OK) continue;
+    if ((mssVer.patchMajor == 0U) && (mssVer.patchMinor == 0U)) continue;
 
-  *((unsigned int*)&firstChunk[0]) = (unsigned int)MMWL_FILETYPE_META_IMG;
-  *((unsigned int*)&firstChunk[4]) = (unsigned int)imgLen;
-  memcpy((char*)&firstChunk[8], (char*)pmmwl_imgBuffer, usFirstChunkLen - 8);
+    if ((mssVer.patchMajor == cache.mssPatchMajor) &&
+        (mssVer.patchMinor == cache.mssPatchMinor) &&
+        (mssVer.patchBuildDebug == cache.mssPatchBuildDebug)) {
+      residentMap |= devMap;
+    }
+  }
+  return residentMap;
+}
 
-  ret_val = MMWL_fileWrite(deviceMap, (mmwl_iRemChunks-1), usFirstChunkLen,
-                            firstChunk);
-  if (ret_val < 0) {
-    DEBUG_PRINT("Failed first chunk\n!");
-      DEBUG_PRINT(
-        "Device map %u : MMWL_fileDwld Fail. Ftype: %d\n\n\r",
-        deviceMap, MMWL_FILETYPE_META_IMG
-      );
-      return ret_val;
-  } else DEBUG_PRINT("Firt chunk sent!\n");
-  pmmwl_imgBuffer += MMWL_FW_FIRST_CHUNK_SIZE;
-  mmwl_iRemChunks--;
 
-  if(mmwl_iRemChunks > 0) {
-      DEBUG_PRINT("Device map %u : Download in Progress: ", deviceMap);
-  }
-  /*Remaining Chunk*/
-  while (mmwl_iRemChunks > 0) {
-    usProgress = (((iNumChunks - mmwl_iRemChunks) * 100) / iNumChunks);
-    DEBUG_PRINT("%d%%..", usProgress);
+/** @fn int MMWL_saveFwResident(unsigned char deviceMap)
+*
+*   @brief Record the firmware version running on a device.
+*
+*   @param[in] deviceMap - Devic Index (the first device of the map is used)
+*
+*   @return int Success - 0, Failure - Error Code
+*/
+int MMWL_saveFwResident(unsigned char deviceMap) {
+  mmwlFwCache_t cache = { 0 };
+  rlFwVersionParam_t mssVer = { 0 };
+  int retVal = RL_RET_CODE_OK;
 
-    /* Last chunk */
-    if ((mmwl_iRemChunks == 1) && (usLastChunkLen > 0)) {
-      ret_val = MMWL_fileWrite(deviceMap, 0, usLastChunkLen, pmmwl_imgBuffer);
-      if (ret_val < 0) {
-        DEBUG_PRINT(
-          "Device map %u : MMWL_fileDwld last chunk Fail : Ftype: %d\n\n\r",
-          deviceMap, MMWL_FILETYPE_META_IMG
-        );
-        return ret_val;
-      }
-    }
-    else {
-      ret_val = MMWL_fileWrite(deviceMap, (mmwl_iRemChunks - 1),
-        MMWL_FW_CHUNK_SIZE, pmmwl_imgBuffer);
+  if (deviceMap == 0U) return RL_RET_CODE_INVALID_INPUT;
+  retVal = CALL_API(GET_MSS_VERSION_IND,
+    createDevMapFromDevId(getDevIdFromDevMap(deviceMap)), &mssVer, 0);
+  if (retVal != RL_RET_CODE_OK) return retVal;
 
-      if (ret_val < 0) {
-        DEBUG_PRINT(
-          "\n\n\r Device map %u : MMWL_fileDwld rem chunk Fail : Ftype: %d\n\n\r",
-          deviceMap, MMWL_FILETYPE_META_IMG
-        );
-        return ret_val;
-      }
-      pmmwl_imgBuffer += MMWL_FW_CHUNK_SIZE;
-    }
+  cache.imageLen = MMWL_META_IMG_FILE_SIZE;
+  cache.imageHash = MMWL_fwImageHash();
+  cache.mssPatchMajor = mssVer.patchMajor;
+  cache.mssPatchMinor = mssVer.patchMinor;
+  cache.mssPatchBuildDebug = mssVer.patchBuildDebug;
 
-    mmwl_iRemChunks--;
-  }
-  DEBUG_PRINT("Done!\n\n");
-  return ret_val;
+  return MMWL_writeFileAtomic(MMWL_FW_CACHE_FILE, &cache, sizeof(cache));
 }
 
 
@@ -1032,20 +2346,30 @@ int MMWL_fileDownload(unsigned char deviceMap, unsigned int fileLen) {
 *
 *   @return int Success - 0, Failure - Error Code
 *
-*   Firmware Download API.
+*   Firmware Download API. The download is skipped for the devices already
+*   running the expected image.
 */
 int MMWL_firmwareDownload(unsigned char deviceMap) {
   int retVal = RL_RET_CODE_OK, timeOutCnt = 0;
+  unsigned char residentMap = MMWL_isFwResident(deviceMap);
+  unsigned char downloadMap = deviceMap & (~residentMap);
+
+  if (residentMap != 0U) {
+    DEBUG_PRINT("Device map %u : Meta Image already resident, download skipped\n\n",
+      residentMap);
+  }
+  if (downloadMap == 0U) return RL_RET_CODE_OK;
 
   /* Meta Image download */
   DEBUG_PRINT("Device map %u : Meta Image (size %d bytes) download started\n\n",
-    deviceMap, MMWL_META_IMG_FILE_SIZE);
-  retVal = MMWL_fileDownload(deviceMap, MMWL_META_IMG_FILE_SIZE);
+    downloadMap, MMWL_META_IMG_FILE_SIZE);
+  retVal = MMWL_fileDownload(downloadMap, MMWL_META_IMG_FILE_SIZE);
   DEBUG_PRINT(
     "Device map %u : Meta Image download complete ret = %d\n\n",
-    deviceMap, retVal
+    downloadMap, retVal
   );
 
+  if (retVal == RL_RET_CODE_OK) MMWL_saveFwResident(downloadMap);
   return retVal;
 }
 
@@ -1061,19 +2385,15 @@ int MMWL_firmwareDownload(unsigned char deviceMap) {
 *   RFenable API.
 */
 int MMWL_rfEnable(unsigned char deviceMap) {
-  int retVal = RL_RET_CODE_OK, timeOutCnt = 0;
+  int retVal = RL_RET_CODE_OK;
   retVal = CALL_API(API_TYPE_B | RF_START_IND, deviceMap, NULL, 0);
-  while ((mmwl_bStartComp & deviceMap) != deviceMap) {
-    msleep(1); /*Sleep 1 msec*/
-    timeOutCnt++;
-    if (timeOutCnt > MMWL_API_START_TIMEOUT) {
-      DEBUG_PRINT(
-        "Device map %u : Timeout! RF Enable Status = %u\n\n",
-        (unsigned int)deviceMap, mmwl_bStartComp
-      );
-      retVal = RL_RET_CODE_RESP_TIMEOUT;
-      break;
-    }
+  if (eventWait(MMWL_EVT_RF_START, &mmwl_bStartComp, deviceMap, TRUE,
+                MMWL_API_START_TIMEOUT) != RL_RET_CODE_OK) {
+    DEBUG_PRINT(
+      "Device map %u : Timeout! RF Enable Status = %u\n\n",
+      (unsigned int)deviceMap, mmwl_bStartComp
+    );
+    retVal = RL_RET_CODE_RESP_TIMEOUT;
   }
 
   mmwl_bStartComp = mmwl_bStartComp & (~deviceMap);
@@ -1373,46 +2693,52 @@ int MMWL_basicConfiguration(unsigned char deviceMap,
 }
 
 
-/** @fn int MMWL_rfInit(unsigned char deviceMap)
+/** @fn int MMWL_rfInitCalibConfig(unsigned char deviceMap, unsigned int calibEnMask)
 *
-*   @brief RFinit API.
+*   @brief Select the boot-time calibrations run by the next RF init.
 *
 *   @param[in] deviceMap - Devic Index
+*   @param[in] calibEnMask - Calibrations to run
 *
 *   @return int Success - 0, Failure - Error Code
-*
-*   RFinit API.
 */
-int MMWL_rfInit(unsigned char deviceMap) {
-  int retVal = RL_RET_CODE_OK, timeOutCnt = 0;
-  mmwl_bRfInitComp = mmwl_bRfInitComp & (~deviceMap);
-
-  // if (rlDevGlobalCfgArgs.CalibEnable == TRUE) {
+static int MMWL_rfInitCalibConfig(unsigned char deviceMap, unsigned int calibEnMask) {
   rlRfInitCalConf_t rfCalibCfgArgs = { 0 };
+  int retVal = RL_RET_CODE_OK;
 
-  /* Enable only required boot-time calibrations, by default all are enabled in the device */
-  rfCalibCfgArgs.calibEnMask = 0x1FF0;
+  rfCalibCfgArgs.calibEnMask = calibEnMask;
 
   /* RF Init Calibration Configuration */
   retVal = CALL_API(RF_INIT_CALIB_CONFIG_IND, deviceMap, &rfCalibCfgArgs, 0);
   if (retVal != RL_RET_CODE_OK) {
     DEBUG_PRINT("Device map %u : RF Init Calibration Configuration failed with error %d \n\n",
       deviceMap, retVal);
-    return -1;
   }
   else {
     DEBUG_PRINT("Device map %u : RF Init Calibration Configuration success \n\n", deviceMap);
   }
+  return retVal;
+}
+
+
+/** @fn int MMWL_rfInitRun(unsigned char deviceMap)
+*
+*   @brief Run the RF init and wait for the calibration status of each device.
+*
+*   @param[in] deviceMap - Devic Index
+*
+*   @return int Success - 0, Failure - Error Code
+*/
+static int MMWL_rfInitRun(unsigned char deviceMap) {
+  int retVal = RL_RET_CODE_OK;
+
+  mmwl_bRfInitComp = mmwl_bRfInitComp & (~deviceMap);
 
   /* Run boot time calibrations */
   retVal = CALL_API(API_TYPE_B | RF_INIT_IND, deviceMap, NULL, 0);
-  while ((mmwl_bRfInitComp & deviceMap) != deviceMap) {
-    msleep(1); /*Sleep 1 msec*/
-    timeOutCnt++;
-    if (timeOutCnt > MMWL_API_RF_INIT_TIMEOUT) {
-      retVal = RL_RET_CODE_RESP_TIMEOUT;
-      break;
-    }
+  if (eventWait(MMWL_EVT_RF_INIT, &mmwl_bRfInitComp, deviceMap, TRUE,
+                MMWL_API_RF_INIT_TIMEOUT) != RL_RET_CODE_OK) {
+    retVal = RL_RET_CODE_RESP_TIMEOUT;
   }
 
   mmwl_bRfInitComp = mmwl_bRfInitComp & (~deviceMap);
@@ -1420,6 +2746,253 @@ int MMWL_rfInit(unsigned char deviceMap) {
 }
 
 
+/** @fn int MMWL_rfInit(unsigned char deviceMap)
+*
+*   @brief RFinit API.
+*
+*   @param[in] deviceMap - Devic Index
+*
+*   @return int Success - 0, Failure - Error Code
+*
+*   RFinit API.
+*/
+int MMWL_rfInit(unsigned char deviceMap) {
+  /* Enable only required boot-time calibrations, by default all are enabled in the device */
+  if (MMWL_rfInitCalibConfig(deviceMap, MMWL_CALIB_BOOT_MASK) != RL_RET_CODE_OK) {
+    return -1;
+  }
+  return MMWL_rfInitRun(deviceMap);
+}
+
+
+/** @fn uint32_t MMWL_calibValidStatus(const rlCalibrationData_t *data)
+*
+*   @brief Read the validity status of calibration data.
+*
+*   @param[in] data - Calibration data
+*
+*   @return uint32_t calValidStatus, 0 when its redundant copy differs
+*/
+static uint32_t MMWL_calibValidStatus(const rlCalibrationData_t *data) {
+  uint32_t status, statusCpy;
+
+  memcpy(&status, &data->calibChunk[0].calData[0], sizeof(status));
+  memcpy(&statusCpy, &data->calibChunk[0].calData[4], sizeof(statusCpy));
+  return (status == statusCpy) ? status : 0U;
+}
+
+
+static void MMWL_calibCachePath(const char *ipAddr, unsigned char devId, int temperature,
+                                char *path, size_t size) {
+  /* Rounded down, -5 and 5 degree Celsius are in different bands */
+  int band = (temperature >= 0) ? (temperature / MMWL_CALIB_TEMP_BAND) :
+    -((MMWL_CALIB_TEMP_BAND - 1 - temperature) / MMWL_CALIB_TEMP_BAND);
+
+  snprintf(path, size, MMWL_CALIB_FILE_FMT, ipAddr, (unsigned int)devId, band);
+}
+
+
+/** @fn int MMWL_calibTemperature(unsigned char deviceMap, int *temperature)
+*
+*   @brief Read the temperature of a device.
+*
+*   @param[in] deviceMap - Devic Index (a single device)
+*   @param[out] temperature - Average of the RX and TX sensors in degree Celsius
+*
+*   @return int Success - 0, Failure - Error Code
+*/
+static int MMWL_calibTemperature(unsigned char deviceMap, int *temperature) {
+  rlRfTempData_t temp = { 0 };
+  int retVal = CALL_API(GET_TEMP_DEVICE_IND, deviceMap, &temp, 0);
+
+  if (retVal != RL_RET_CODE_OK) return retVal;
+  *temperature = (temp.tmpRx0Sens + temp.tmpRx1Sens + temp.tmpRx2Sens + temp.tmpRx3Sens +
+    temp.tmpTx0Sens + temp.tmpTx1Sens + temp.tmpTx2Sens) / 7;
+  return RL_RET_CODE_OK;
+}
+
+
+/** @fn int MMWL_calibCacheLoad(const char *ipAddr, unsigned char devId,
+*                               const rlRfDieIdCfg_t *dieId, int temperature,
+*                               mmwlCalibCache_t *cache)
+*
+*   @brief Read the calibration data of a device valid at a temperature.
+*
+*   @param[in] ipAddr - IP address of the board
+*   @param[in] devId - Device index
+*   @param[in] dieId - Die ID of the device
+*   @param[in] temperature - Current temperature of the device
+*   @param[out] cache - Calibration cache record
+*
+*   @return int Success - 0, Failure (no valid data) - Error Code
+*
+*   The data is only valid for the same die and firmware image, within
+*   MMWL_CALIB_VALIDITY_S of the calibration and in the same temperature band.
+*/
+static int MMWL_calibCacheLoad(const char *ipAddr, unsigned char devId,
+                               const rlRfDieIdCfg_t *dieId, int temperature,
+                               mmwlCalibCache_t *cache) {
+  char path[128];
+  FILE *fp;
+  size_t count;
+  int64_t age;
+
+  MMWL_calibCachePath(ipAddr, devId, temperature, path, sizeof(path));
+  fp = fopen(path, "rb");
+  if (fp == NULL) return -1;
+  count = fread(cache, sizeof(mmwlCalibCache_t), 1, fp);
+  fclose(fp);
+
+  age = (int64_t)time(NULL) - cache->timestamp;
+  if ((count != 1) || (cache->magic != MMWL_CALIB_MAGIC) ||
+      (cache->version != MMWL_CALIB_VERSION) ||
+      (cache->imageHash != MMWL_fwImageHash()) ||
+      (cache->dieId[0] != dieId->dieIDHexVal0) || (cache->dieId[1] != dieId->dieIDHexVal1) ||
+      (cache->dieId[2] != dieId->dieIDHexVal2) || (cache->dieId[3] != dieId->dieIDHexVal3) ||
+      (age < 0) || (age > MMWL_CALIB_VALIDITY_S) ||
+      ((MMWL_calibValidStatus(&cache->data) & MMWL_CALIB_RESTORE_MASK) != MMWL_CALIB_RESTORE_MASK)) {
+    return -1;
+  }
+  return RL_RET_CODE_OK;
+}
+
+
+/** @fn int MMWL_calibCacheSave(const char *ipAddr, unsigned char devId,
+*                               const rlRfDieIdCfg_t *dieId, mmwlCalibCache_t *cache)
+*
+*   @brief Record the calibration data of a device.
+*
+*   @param[in] ipAddr - IP address of the board
+*   @param[in] devId - Device index
+*   @param[in] dieId - Die ID of the device
+*   @param[in,out] cache - Record with the data and temperature (the header fields are filled in)
+*
+*   @return int Success - 0, Failure - Error Code
+*/
+static int MMWL_calibCacheSave(const char *ipAddr, unsigned char devId,
+                               const rlRfDieIdCfg_t *dieId, mmwlCalibCache_t *cache) {
+  char path[128];
+
+  cache->magic = MMWL_CALIB_MAGIC;
+  cache->version = MMWL_CALIB_VERSION;
+  cache->imageHash = MMWL_fwImageHash();
+  cache->dieId[0] = dieId->dieIDHexVal0;
+  cache->dieId[1] = dieId->dieIDHexVal1;
+  cache->dieId[2] = dieId->dieIDHexVal2;
+  cache->dieId[3] = dieId->dieIDHexVal3;
+  cache->timestamp = (int64_t)time(NULL);
+
+  MMWL_calibCachePath(ipAddr, devId, cache->temperature, path, sizeof(path));
+  return MMWL_writeFileAtomic(path, cache, sizeof(mmwlCalibCache_t));
+}
+
+
+/** @fn int MMWL_rfInitCached(unsigned char deviceMap, const char *ipAddr,
+*                             unsigned char restore)
+*
+*   @brief RFinit API using the calibration cache of the board.
+*
+*   @param[in] deviceMap - Devic Index
+*   @param[in] ipAddr - IP address of the board
+*   @param[in] restore - FALSE to run the full calibration and refresh the cache
+*
+*   @return int Success - 0, Failure - Error Code
+*
+*   The calibration data cached for a device at its current temperature is
+*   restored, and only the calibrations that cannot be restored are run by
+*   the RF init. The other devices, and the ones rejecting the restored data,
+*   run the full boot-time calibration, whose result is then read back and
+*   cached. The cache is looked up and saved under the same temperature
+*   reading (MMWL_calibTemperature), taken before the RF init.
+*/
+int MMWL_rfInitCached(unsigned char deviceMap, const char *ipAddr, unsigned char restore) {
+  static mmwlCalibCache_t cache[TDA_NUM_CONNECTED_DEVICES_MAX];
+  rlRfDieIdCfg_t dieId[TDA_NUM_CONNECTED_DEVICES_MAX] = { 0 };
+  int temperature[TDA_NUM_CONNECTED_DEVICES_MAX] = { 0 };
+  unsigned char keyMap = 0U, restoreMap = 0U, calibMap;
+  int retVal = RL_RET_CODE_OK;
+
+  for (unsigned char devId = 0; devId < TDA_NUM_CONNECTED_DEVICES_MAX; devId++) {
+    unsigned char devMap = createDevMapFromDevId(devId);
+
+    if ((deviceMap & devMap) == 0U) continue;
+    if ((CALL_API(RF_GET_DIE_ID_IND, devMap, &dieId[devId], 0) != RL_RET_CODE_OK) ||
+        (MMWL_calibTemperature(devMap, &temperature[devId]) != RL_RET_CODE_OK)) {
+      continue;
+    }
+    keyMap |= devMap;
+
+    if (!restore ||
+        (MMWL_calibCacheLoad(ipAddr, devId, &dieId[devId], temperature[devId], &cache[devId]) != 0)) {
+      continue;
+    }
+
+    /* Only the calibrations that can be restored are marked valid */
+    uint32_t validStatus = MMWL_calibValidStatus(&cache[devId].data) & MMWL_CALIB_RESTORE_MASK;
+    memcpy(&cache[devId].data.calibChunk[0].calData[0], &validStatus, sizeof(validStatus));
+    memcpy(&cache[devId].data.calibChunk[0].calData[4], &validStatus, sizeof(validStatus));
+    if (CALL_API(RF_CALIB_DATA_RESTORE_IND, devMap, &cache[devId].data, 0) == RL_RET_CODE_OK) {
+      restoreMap |= devMap;
+    }
+  }
+
+  if (restoreMap != 0U) {
+    /* The restored data is checked by the device as after a calibration */
+    mmwl_bRfInitComp = mmwl_bRfInitComp & (~restoreMap);
+    eventWait(MMWL_EVT_RF_INIT, &mmwl_bRfInitComp, restoreMap, TRUE, MMWL_API_RF_INIT_TIMEOUT);
+    for (unsigned char devId = 0; devId < TDA_NUM_CONNECTED_DEVICES_MAX; devId++) {
+      unsigned char devMap = createDevMapFromDevId(devId);
+
+      if ((restoreMap & devMap) == 0U) continue;
+      if (((mmwl_bRfInitComp & devMap) == 0U) ||
+          ((mmwl_rfInitStatus[devId].calibStatus & MMWL_CALIB_RESTORE_MASK) !=
+           MMWL_CALIB_RESTORE_MASK)) {
+        DEBUG_PRINT("Device map %u : Calibration data rejected, running the full calibration\n\n",
+          (unsigned int)devMap);
+        restoreMap &= ~devMap;
+      }
+    }
+    mmwl_bRfInitComp = mmwl_bRfInitComp & (~deviceMap);
+  }
+
+  calibMap = deviceMap & (~restoreMap);
+  if ((calibMap != 0U) &&
+      (MMWL_rfInitCalibConfig(calibMap, MMWL_CALIB_BOOT_MASK) != RL_RET_CODE_OK)) {
+    return -1;
+  }
+  if ((restoreMap != 0U) &&
+      (MMWL_rfInitCalibConfig(restoreMap,
+        MMWL_CALIB_BOOT_MASK & (~MMWL_CALIB_RESTORE_MASK)) != RL_RET_CODE_OK)) {
+    return -1;
+  }
+
+  retVal = MMWL_rfInitRun(deviceMap);
+  if (retVal != RL_RET_CODE_OK) return retVal;
+  if (restoreMap != 0U) {
+    DEBUG_PRINT("Device map %u : RF calibration restored from the cache\n\n",
+      (unsigned int)restoreMap);
+  }
+
+  /* Cache the result of the full calibrations */
+  for (unsigned char devId = 0; devId < TDA_NUM_CONNECTED_DEVICES_MAX; devId++) {
+    unsigned char devMap = createDevMapFromDevId(devId);
+
+    if (((calibMap & keyMap) & devMap) == 0U) continue;
+    memset(&cache[devId], 0, sizeof(mmwlCalibCache_t));
+    if (CALL_API(RF_CALIB_DATA_STORE_IND, devMap, &cache[devId].data, 0) != RL_RET_CODE_OK) {
+      continue;
+    }
+    if ((MMWL_calibValidStatus(&cache[devId].data) & MMWL_CALIB_RESTORE_MASK) !=
+        MMWL_CALIB_RESTORE_MASK) {
+      continue;
+    }
+    cache[devId].temperature = (int16_t)temperature[devId];
+    MMWL_calibCacheSave(ipAddr, devId, &dieId[devId], &cache[devId]);
+  }
+  return retVal;
+}
+
+
 /** @fn int MMWL_profileConfig(unsigned char deviceMap)
 *
 *   @brief Profile configuration API.
@@ -1446,6 +3019,27 @@ int MMWL_profileConfig(unsigned char deviceMap, rlProfileCfg_t profileCfgArgs) {
 }
 
 
+/** @fn int MMWL_profileTableConfig(unsigned char deviceMap, rlProfileCfg_t *profileCfgArgs,
+*                                     unsigned short count)
+*
+*   @brief Configuration of several profiles at once.
+*
+*   @param[in] deviceMap - Devic Index
+*   @param[in] profileCfgArgs - Profiles (profileId 0 to 3)
+*   @param[in] count - Number of profiles
+*
+*   @return int Success - 0, Failure - Error Code
+*
+*   The profiles are packed into a single message.
+*/
+int MMWL_profileTableConfig(unsigned char deviceMap, rlProfileCfg_t *profileCfgArgs,
+      unsigned short count) {
+  if ((count == 0U) || (count > RL_MAX_PROFILES_CNT)) return RL_RET_CODE_INVALID_INPUT;
+  DEBUG_PRINT("Device map %u : Calling rlSetProfileConfig with %u profiles\n\n", deviceMap, count);
+  return CALL_API(API_TYPE_C | SET_PROFILE_CONFIG_IND, deviceMap, profileCfgArgs, count);
+}
+
+
 /** @fn int MMWL_chirpConfig(unsigned char deviceMap)
 *
 *   @brief Chirp configuration API.
@@ -1473,6 +3067,151 @@ int MMWL_chirpConfig(unsigned char deviceMap, rlChirpCfg_t chirpCfgArgs) {
 }
 
 
+/** @fn int MMWL_chirpTableConfig(unsigned char deviceMap, rlChirpCfg_t **chirpTables,
+*                                   unsigned short *chirpCounts)
+*
+*   @brief Per device chirp table configuration API.
+*
+*   @param[in] deviceMap - Devic Index
+*   @param[in] chirpTables - Chirp configuration table, indexed by device ID
+*   @param[in] chirpCounts - Number of entries in each chirp table
+*
+*   @return int Success - 0, Failure - Error Code
+*
+*   Send a whole chirp table to each device of the device map. mmWaveLink
+*   packs as many chirp sub-blocks as possible in each message, and all the
+*   devices are programmed concurrently.
+*/
+int MMWL_chirpTableConfig(unsigned char deviceMap, rlChirpCfg_t **chirpTables,
+      unsigned short *chirpCounts) {
+  int retVal = RL_RET_CODE_OK;
+  void *payloads[TDA_NUM_CONNECTED_DEVICES_MAX] = { NULL };
+  unsigned int counts[TDA_NUM_CONNECTED_DEVICES_MAX] = { 0 };
+
+  for (unsigned char devId = 0; devId < TDA_NUM_CONNECTED_DEVICES_MAX; devId++) {
+    if ((deviceMap & (1U << devId)) == 0U) continue;
+    if ((chirpTables[devId] == NULL) || (chirpCounts[devId] == 0U) ||
+        (chirpCounts[devId] > (MAX_UNIQUE_CHIRP_INDEX + 1))) {
+      return RL_RET_CODE_INVALID_INPUT;
+    }
+    payloads[devId] = chirpTables[devId];
+    counts[devId] = chirpCounts[devId];
+    DEBUG_PRINT("Device map %u : Calling rlSetChirpConfig with %u chirp entries\n",
+                (1U << devId), counts[devId]);
+  }
+
+  retVal = callThreadApiPerDevice(API_TYPE_C | SET_CHIRP_CONFIG_IND, deviceMap, payloads, counts);
+  return retVal;
+}
+
+
+/** @fn int MMWL_frameGeometry(unsigned int numChirps, rlChanCfg_t rfChanCfgArgs,
+*                              rlAdcOutCfg_t adcOutCfgArgs, rlDevDataPathCfg_t dataPathCfgArgs,
+*                              rlProfileCfg_t profileCfgArgs, unsigned int *width, unsigned int *height)
+*
+*   @brief Geometry of a frame of raw ADC data recorded by the TDA, as sent by setWidthAndHeight
+*
+*   @param[in] numChirps - Number of chirps of a frame
+*   @param[in] rfChanCfgArgs - Channel config
+*   @param[in] adcOutCfgArgs - ADC output config
+*   @param[in] dataPathCfgArgs - Datapath config
+*   @param[in] profileCfgArgs - Profile config (ADC samples of every chirp)
+*   @param[out] width - Number of 16-bit values per chirp
+*   @param[out] height - Number of chirps per frame
+*
+*   @return int Success - 0
+*
+*   Computed from the configuration only, without any device: the frames of
+*   a capture can be checked offline.
+*/
+int MMWL_frameGeometry(unsigned int numChirps, rlChanCfg_t rfChanCfgArgs, rlAdcOutCfg_t adcOutCfgArgs,
+      rlDevDataPathCfg_t dataPathCfgArgs, rlProfileCfg_t profileCfgArgs,
+      unsigned int *width, unsigned int *height) {
+  /* Height calculation */
+  *height = numChirps;
+
+  uint8_t rxChannelEn = rfChanCfgArgs.rxChannelEn;
+  /* Width calculation */
+  /* Count the number of Rx antenna */
+  unsigned char numRxAntenna = 0;
+  while (rxChannelEn != 0) {
+    if ((rxChannelEn & 0x1) == 1) {
+      numRxAntenna++;
+    }
+    rxChannelEn = (rxChannelEn >> 1);
+  }
+
+  /* ADC format (in bytes) */
+  unsigned char numValPerAdcSample = 0, numAdcBits = 0;
+  if (adcOutCfgArgs.fmt.b2AdcOutFmt == 1 || adcOutCfgArgs.fmt.b2AdcOutFmt == 2) {
+    numValPerAdcSample = 2;
+  }
+  else {
+    numValPerAdcSample = 1;
+  }
+
+  if (adcOutCfgArgs.fmt.b2AdcBits == 0) {
+    numAdcBits = 12;
+  }
+  else if (adcOutCfgArgs.fmt.b2AdcBits == 1) {
+    numAdcBits = 14;
+  }
+  else if (adcOutCfgArgs.fmt.b2AdcBits == 2) {
+    numAdcBits = 16;
+  }
+
+  /* Number of ADC samples */
+  unsigned int numAdcSamples = 0;
+  // if (rlDevGlobalCfgArgs.LinkAdvChirpTest == FALSE) {
+  numAdcSamples = profileCfgArgs.numAdcSamples;
+  // }
+
+  /* Datapath */
+  /* Get CP and CQ value */
+  unsigned short cp_data = 0, cq_val = 0;
+  unsigned int cq_data = 0;
+  cq_val = dataPathCfgArgs.cq0TransSize + dataPathCfgArgs.cq1TransSize + dataPathCfgArgs.cq2TransSize;
+
+  if (dataPathCfgArgs.transferFmtPkt0 == 6 || dataPathCfgArgs.transferFmtPkt0 == 9) {
+    cp_data = 2;
+    cq_data = 0;
+  }
+  else if (dataPathCfgArgs.transferFmtPkt0 == 54) {
+    cp_data = 2;
+    cq_data = (cq_val * 16) / numAdcBits;
+  }
+
+  DEBUG_PRINT("params: Num val per samples: %d, Num ADC samples: %u, num RX: %d\n", numValPerAdcSample, numAdcSamples, numRxAntenna);
+  *width = (((numValPerAdcSample * numAdcSamples) + cp_data) * numRxAntenna) + cq_data;
+  return RL_RET_CODE_OK;
+}
+
+
+/**
+ * @brief Geometry of the raw ADC data recorded by the TDA for each device
+ *
+ * @param deviceMap Devices of the frame
+ * @param numChirps Number of chirps of a frame
+ * @param rfChanCfgArgs Channel config
+ * @param adcOutCfgArgs ADC output config
+ * @param dataPathCfgArgs Datapath config
+ * @param profileCfgArgs Profile config (ADC samples of every chirp)
+ */
+static void frameGeometry(unsigned char deviceMap, unsigned int numChirps, rlChanCfg_t rfChanCfgArgs,
+      rlAdcOutCfg_t adcOutCfgArgs, rlDevDataPathCfg_t dataPathCfgArgs, rlProfileCfg_t profileCfgArgs) {
+  unsigned char devId;
+
+  for (devId = 0; devId < 4; devId++) {
+    if ((deviceMap & (1 << devId)) != 0) {
+      MMWL_frameGeometry(numChirps, rfChanCfgArgs, adcOutCfgArgs, dataPathCfgArgs, profileCfgArgs,
+        &mmwl_TDA_width[devId], &mmwl_TDA_height[devId]);
+      DEBUG_PRINT("Device map %u : Calculated TDA Height is %d\n\n", deviceMap, mmwl_TDA_height[devId]);
+      DEBUG_PRINT("Device map %u : Calculated TDA Width is %d\n\n", deviceMap, mmwl_TDA_width[devId]);
+    }
+  }
+}
+
+
 /** @fn int MMWL_frameConfig(unsigned char deviceMap)
 *
 *   @brief Frame configuration API.
@@ -1492,7 +3231,6 @@ int MMWL_frameConfig(unsigned char deviceMap, rlFrameCfg_t frameCfgArgs, rlChanC
       rlAdcOutCfg_t adcOutCfgArgs, rlDevDataPathCfg_t dataPathCfgArgs, rlProfileCfg_t profileCfgArgs) {
 
   int retVal = RL_RET_CODE_OK;
-  unsigned char devId;
   if (deviceMap == 1) {
     frameCfgArgs.triggerSelect = 1; // Software trigger
   }
@@ -1518,71 +3256,104 @@ int MMWL_frameConfig(unsigned char deviceMap, rlFrameCfg_t frameCfgArgs, rlChanC
     frameCfgArgs.numLoops, (frameCfgArgs.framePeriodicity * 5)/(1000*1000)
   );
 
-  retVal = CALL_API(SET_FRAME_CONFIG_IND, deviceMap, &frameCfgArgs, 0);
+  retVal = CALL_API(SET_FRAME_CONFIG_IND, deviceMap, &frameCfgArgs, 0);
+
+  frameGeometry(deviceMap,
+    frameCfgArgs.numLoops * (frameCfgArgs.chirpEndIdx - frameCfgArgs.chirpStartIdx + 1),
+    rfChanCfgArgs, adcOutCfgArgs, dataPathCfgArgs, profileCfgArgs);
+  return retVal;
+}
+
+
+/** @fn int MMWL_advFrameConfig(unsigned char deviceMap, rlAdvFrameCfg_t advFrameCfgArgs,
+*                               rlChanCfg_t rfChanCfgArgs, rlAdcOutCfg_t adcOutCfgArgs,
+*                               rlDevDataPathCfg_t dataPathCfgArgs, rlProfileCfg_t profileCfgArgs)
+*
+*   @brief Advanced frame configuration API.
+*
+*   @param[in] deviceMap - Devic Index
+*   @param[in] advFrameCfgArgs - Sub-frames and their data config
+*   @param[in] rfChanCfgArgs - Channel config
+*   @param[in] adcOutCfgArgs - ADC output config
+*   @param[in] dataPathCfgArgs - Datapath config
+*   @param[in] profileCfgArgs - Profile config (ADC samples of every sub-frame)
+*
+*   @return int Success - 0, Failure - Error Code
+*
+*   The devices cycle through the sub-frames (each with its own profile and
+*   chirps) in every frame, without any message from the host. A frame of
+*   raw ADC data holds the chirps of all the sub-frames, back to back: the
+*   sub-frames must have the same number of ADC samples per chirp.
+*/
+int MMWL_advFrameConfig(unsigned char deviceMap, rlAdvFrameCfg_t advFrameCfgArgs,
+      rlChanCfg_t rfChanCfgArgs, rlAdcOutCfg_t adcOutCfgArgs,
+      rlDevDataPathCfg_t dataPathCfgArgs, rlProfileCfg_t profileCfgArgs) {
+  int retVal = RL_RET_CODE_OK;
+  rlAdvFrameSeqCfg_t *seq = &advFrameCfgArgs.frameSeq;
+  unsigned int numChirps = 0, period = 0;
+
+  if ((seq->numOfSubFrames == 0) || (seq->numOfSubFrames > RL_MAX_SUBFRAMES)) {
+    return RL_RET_CODE_INVALID_INPUT;
+  }
+  seq->triggerSelect = (deviceMap == 1) ? 1 : 2; // Software trigger for the master, hardware for the slaves
 
-  for (devId = 0; devId < 4; devId++) {
-    if ((deviceMap & (1 << devId)) != 0) {
-      /* Height calculation */
-      mmwl_TDA_height[devId] = frameCfgArgs.numLoops * (frameCfgArgs.chirpEndIdx - frameCfgArgs.chirpStartIdx + 1);
-      DEBUG_PRINT("Device map %u : Calculated TDA Height is %d\n\n", deviceMap, mmwl_TDA_height[devId]);
+  for (unsigned char i = 0; i < seq->numOfSubFrames; i++) {
+    numChirps += advFrameCfgArgs.frameData.subframeDataCfg[i].totalChirps;
+    period += seq->subFrameCfg[i].subFramePeriodicity;
+    DEBUG_PRINT(
+      "Device map %u : Sub-frame %u: profile %u, chirps %u..%u x %u loops every %u ms\n",
+      deviceMap, i, seq->subFrameCfg[i].forceProfileIdx, seq->subFrameCfg[i].chirpStartIdx,
+      seq->subFrameCfg[i].chirpStartIdx + seq->subFrameCfg[i].numOfChirps - 1,
+      seq->subFrameCfg[i].numLoops, (seq->subFrameCfg[i].subFramePeriodicity * 5)/(1000*1000)
+    );
+  }
+  framePeriodicity = (period * 5)/(1000*1000);
+  frameCount = seq->numFrames;
 
-      uint8_t rxChannelEn = rfChanCfgArgs.rxChannelEn;
-      /* Width calculation */
-      /* Count the number of Rx antenna */
-      unsigned char numRxAntenna = 0;
-      while (rxChannelEn != 0) {
-        if ((rxChannelEn & 0x1) == 1) {
-          numRxAntenna++;
-        }
-        rxChannelEn = (rxChannelEn >> 1);
-      }
+  DEBUG_PRINT("Device map %u : Calling rlSetAdvFrameConfig with %u sub-frames\n\n",
+    deviceMap, seq->numOfSubFrames);
+  retVal = CALL_API(SET_ADV_FRAME_CONFIG_IND, deviceMap, &advFrameCfgArgs, 0);
 
-      /* ADC format (in bytes) */
-      unsigned char numValPerAdcSample = 0, numAdcBits = 0;
-      if (adcOutCfgArgs.fmt.b2AdcOutFmt == 1 || adcOutCfgArgs.fmt.b2AdcOutFmt == 2) {
-        numValPerAdcSample = 2;
-      }
-      else {
-        numValPerAdcSample = 1;
-      }
+  frameGeometry(deviceMap, numChirps, rfChanCfgArgs, adcOutCfgArgs, dataPathCfgArgs, profileCfgArgs);
+  return retVal;
+}
 
-      if (adcOutCfgArgs.fmt.b2AdcBits == 0) {
-        numAdcBits = 12;
-      }
-      else if (adcOutCfgArgs.fmt.b2AdcBits == 1) {
-        numAdcBits = 14;
-      }
-      else if (adcOutCfgArgs.fmt.b2AdcBits == 2) {
-        numAdcBits = 16;
-      }
 
-      /* Number of ADC samples */
-      unsigned int numAdcSamples = 0;
-      // if (rlDevGlobalCfgArgs.LinkAdvChirpTest == FALSE) {
-      numAdcSamples = profileCfgArgs.numAdcSamples;
-      // }
-
-      /* Datapath */
-      /* Get CP and CQ value */
-      unsigned short cp_data = 0, cq_val = 0;
-      unsigned int cq_data = 0;
-      cq_val = dataPathCfgArgs.cq0TransSize + dataPathCfgArgs.cq1TransSize + dataPathCfgArgs.cq2TransSize;
-
-      if (dataPathCfgArgs.transferFmtPkt0 == 6 || dataPathCfgArgs.transferFmtPkt0 == 9) {
-        cp_data = 2;
-        cq_data = 0;
-      }
-      else if (dataPathCfgArgs.transferFmtPkt0 == 54) {
-        cp_data = 2;
-        cq_data = (cq_val * 16) / numAdcBits;
-      }
+/** @fn unsigned int MMWL_getFrameSize(unsigned char deviceMap)
+*
+*   @brief Size of a frame of raw ADC data, computed by MMWL_frameConfig
+*
+*   @param[in] deviceMap - Devices in the frame
+*
+*   @return unsigned int Number of bytes (width x height 16-bit values per device)
+*/
+unsigned int MMWL_getFrameSize(unsigned char deviceMap) {
+  unsigned int frameSize = 0;
 
-      DEBUG_PRINT("params: Num val per samples: %d, Num ADC samples: %u, num RX: %d\n", numValPerAdcSample, numAdcSamples, numRxAntenna);
-      mmwl_TDA_width[devId] = (((numValPerAdcSample * numAdcSamples) + cp_data) * numRxAntenna) + cq_data;
-      DEBUG_PRINT("Device map %u : Calculated TDA Width is %d\n\n", deviceMap, mmwl_TDA_width[devId]);
+  for (int i = 0; i < 4; i++) {
+    if ((deviceMap & (1U << i)) != 0U) {
+      frameSize += mmwl_TDA_width[i] * mmwl_TDA_height[i] * 2U;
     }
   }
-  return retVal;
+  return frameSize;
+}
+
+
+/** @fn int MMWL_getFrameDims(unsigned char devId, unsigned int *width, unsigned int *height)
+*
+*   @brief Geometry of a frame of raw ADC data of a device, computed by MMWL_frameConfig
+*
+*   @param[in] devId - Device Index (0 to 3)
+*   @param[out] width - Number of 16-bit values per chirp
+*   @param[out] height - Number of chirps per frame
+*
+*   @return int Success - 0, Failure - Error Code
+*/
+int MMWL_getFrameDims(unsigned char devId, unsigned int *width, unsigned int *height) {
+  if (devId >= 4) return RL_RET_CODE_INVALID_INPUT;
+  *width = mmwl_TDA_width[devId];
+  *height = mmwl_TDA_height[devId];
+  return RL_RET_CODE_OK;
 }
 
 
@@ -1791,7 +3562,6 @@ int MMWL_hsiClockConfig(unsigned char deviceMap, rlDevDataPathClkCfg_t dataPathC
 */
 int MMWL_gpadcMeasConfig(unsigned char deviceMap) {
   int retVal = RL_RET_CODE_OK;
-  int timeOutCnt = 0;
   rlGpAdcCfg_t gpadcCfg = {0};
 
   /* enable all the sensors [0-5] to read gpADC measurement data */
@@ -1806,14 +3576,8 @@ int MMWL_gpadcMeasConfig(unsigned char deviceMap) {
 
   retVal = CALL_API(SET_GPADC_CONFIG, deviceMap, &gpadcCfg, 0);
   if(retVal == RL_RET_CODE_OK) {
-    while ((mmwl_bGpadcDataRcv & deviceMap) != deviceMap) {
-      msleep(1); /*Sleep 1 msec*/
-      timeOutCnt++;
-      if (timeOutCnt > MMWL_API_RF_INIT_TIMEOUT) {
-        retVal = RL_RET_CODE_RESP_TIMEOUT;
-        break;
-      }
-    }
+    retVal = eventWait(MMWL_EVT_GPADC, &mmwl_bGpadcDataRcv, deviceMap, TRUE,
+                       MMWL_API_RF_INIT_TIMEOUT);
   }
 
   return retVal;
@@ -1832,20 +3596,15 @@ int MMWL_gpadcMeasConfig(unsigned char deviceMap) {
 */
 int MMWL_sensorStart(unsigned char deviceMap) {
   int retVal = RL_RET_CODE_OK;
-  int timeOutCnt = 0;
 
   rlFrameTrigger_t data = { 0 };
   /* Start the frame */
   data.startStop = 0x1;
   mmwl_bSensorStarted = mmwl_bSensorStarted & (~deviceMap);
   retVal = CALL_API(SENSOR_START_STOP_IND, deviceMap, &data, 0);
-  while ((mmwl_bSensorStarted & deviceMap) != deviceMap) {
-    msleep(1); /*Sleep 1 msec*/
-    timeOutCnt++;
-    if (timeOutCnt > MMWL_API_RF_INIT_TIMEOUT) {
-      retVal = RL_RET_CODE_RESP_TIMEOUT;
-      break;
-    }
+  if (eventWait(MMWL_EVT_FRAME_START, &mmwl_bSensorStarted, deviceMap, TRUE,
+                MMWL_API_RF_INIT_TIMEOUT) != RL_RET_CODE_OK) {
+    retVal = RL_RET_CODE_RESP_TIMEOUT;
   }
   return retVal;
 }
@@ -1890,20 +3649,14 @@ int MMWL_StartFrame(unsigned char deviceMap) {
 *   API to Stop Sensor.
 */
 int MMWL_sensorStop(unsigned char deviceMap) {
-  int retVal = RL_RET_CODE_OK, timeOutCnt = 0;
+  int retVal = RL_RET_CODE_OK;
   rlFrameTrigger_t data = { 0 };
   /* Stop the frame after the current frame is over */
   data.startStop = 0;
   retVal = CALL_API(SENSOR_START_STOP_IND, deviceMap, &data, 0);
   if (retVal == RL_RET_CODE_OK) {
-    while ((mmwl_bSensorStarted & deviceMap) == deviceMap) {
-      msleep(1); /*Sleep 1 msec*/
-      timeOutCnt++;
-      if (timeOutCnt > MMWL_API_RF_INIT_TIMEOUT) {
-        retVal = RL_RET_CODE_RESP_TIMEOUT;
-        break;
-      }
-    }
+    retVal = eventWait(MMWL_EVT_FRAME_END, &mmwl_bSensorStarted, deviceMap, FALSE,
+                       MMWL_API_RF_INIT_TIMEOUT);
   }
   return retVal;
 }
@@ -1943,6 +3696,255 @@ int MMWL_StopFrame(unsigned char deviceMap) {
 }
 
 
+/******************************************************************************
+* SYNCHRONIZED FRAME START/STOP
+*******************************************************************************
+*/
+
+#define MMWL_GATE_STAGED          (0U)
+#define MMWL_GATE_RELEASED        (1U)
+#define MMWL_GATE_ABORTED         (2U)
+
+/* Frame trigger staged on the workers of the slaves */
+typedef struct mmwlFrameGate {
+  pthread_mutex_t lock;
+  pthread_cond_t cond;
+
+  /* Slaves waiting at the gate */
+  unsigned char stagedMap;
+  unsigned char state;
+
+  rlFrameTrigger_t data;
+  mmwlFrameSync_t *sync;
+} mmwlFrameGate_t;
+
+
+static uint64_t frameSyncNow(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_REALTIME, &ts);
+  return (uint64_t)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+
+static uint64_t frameSyncMono(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+
+/**
+ * @brief Send the frame trigger to a device and wait for it to take effect
+ *
+ * Called from the worker of a slave or from the caller for the master. The
+ * API is called directly: the device worker is not re-entered.
+ *
+ * @param devIndex Device index
+ * @param data Frame trigger (startStop 1: start, 0: stop)
+ * @param sync Dispatch time record
+ * @return rlReturnVal_t Return value of the API, or timeout
+ */
+static rlReturnVal_t frameTrigger(unsigned char devIndex, rlFrameTrigger_t *data,
+                                  mmwlFrameSync_t *sync) {
+  unsigned char deviceMap = (unsigned char)(1U << devIndex);
+  rlReturnVal_t retVal;
+
+  sync->dispatchMono[devIndex] = frameSyncMono();
+  sync->dispatchTime[devIndex] = frameSyncNow();
+  retVal = funcTableTypeA[SENSOR_START_STOP_IND](deviceMap, data);
+  if (retVal != RL_RET_CODE_OK) return retVal;
+
+  /* Frame trigger ready (start) / frame end (stop) async event */
+  retVal = eventWait((data->startStop != 0U) ? MMWL_EVT_FRAME_START : MMWL_EVT_FRAME_END,
+                     &mmwl_bSensorStarted, deviceMap, (data->startStop != 0U),
+                     MMWL_API_RF_INIT_TIMEOUT);
+  if (retVal == RL_RET_CODE_OK) sync->eventTime[devIndex] = frameSyncNow();
+  return retVal;
+}
+
+
+/**
+ * @brief Worker side of the gate: wait for the release and trigger
+ *
+ * @param devIndex Device index of the worker
+ * @param gate Frame gate
+ * @return rlReturnVal_t Return value of the trigger
+ */
+static rlReturnVal_t frameGateExecute(unsigned char devIndex, void *gate) {
+  mmwlFrameGate_t *frameGate = (mmwlFrameGate_t *)gate;
+  unsigned char state;
+
+  pthread_mutex_lock(&frameGate->lock);
+  frameGate->stagedMap |= (1U << devIndex);
+  pthread_cond_broadcast(&frameGate->cond);
+  while (frameGate->state == MMWL_GATE_STAGED) {
+    pthread_cond_wait(&frameGate->cond, &frameGate->lock);
+  }
+  state = frameGate->state;
+  pthread_mutex_unlock(&frameGate->lock);
+
+  if (state == MMWL_GATE_ABORTED) return RL_RET_CODE_INVALID_STATE_ERROR;
+  return frameTrigger(devIndex, &frameGate->data, frameGate->sync);
+}
+
+
+/**
+ * @brief Start or stop framing on all the devices with the least skew
+ *
+ * The frame trigger of each slave is queued on its worker, which waits at
+ * a gate. Once all the slaves are staged, the rendezvous of the caller is
+ * run (if any) and the gate is opened: the slaves are triggered at the
+ * same time. The master, which generates the frame sync of the cascade,
+ * is triggered from the calling thread as soon as all the slaves are
+ * ready.
+ *
+ * @param deviceMap Devices to trigger
+ * @param startStop 1: start framing, 0: stop framing
+ * @param sync Rendezvous and dispatch times (NULL when not needed)
+ * @return int Success - 0, Failure - -1
+ */
+static int frameTriggerSync(unsigned char deviceMap, rlUInt16_t startStop,
+                            mmwlFrameSync_t *sync) {
+  mmwlFrameSync_t localSync = { 0 };
+  mmwlFrameGate_t gate;
+  mmwlFuture_t futures[TDA_NUM_CONNECTED_DEVICES_MAX];
+  unsigned char slavesMap = deviceMap & ~(1U << DEFAULT_MASTER_DEVICE);
+  unsigned char submitted = 0U;
+  uint64_t first = 0U, last = 0U;
+  int32_t rendezvous = 0;
+  int retVal = RL_RET_CODE_OK;
+  rlReturnVal_t devRetVal;
+
+  if (sync == NULL) sync = &localSync;
+  sync->aborted = 0U;
+  memset(sync->dispatchTime, 0, sizeof(sync->dispatchTime));
+  memset(sync->dispatchMono, 0, sizeof(sync->dispatchMono));
+  memset(sync->eventTime, 0, sizeof(sync->eventTime));
+
+  memset(&gate, 0, sizeof(gate));
+  pthread_mutex_init(&gate.lock, NULL);
+  pthread_cond_init(&gate.cond, NULL);
+  gate.state = MMWL_GATE_STAGED;
+  gate.data.startStop = startStop;
+  gate.sync = sync;
+
+  if (startStop != 0U) {
+    pthread_mutex_lock(&rlAsyncEvent);
+    mmwl_bSensorStarted = mmwl_bSensorStarted & (~deviceMap);
+    pthread_mutex_unlock(&rlAsyncEvent);
+  }
+
+  /* Stage the slaves */
+  for (unsigned char devIndex = 0; devIndex < TDA_NUM_CONNECTED_DEVICES_MAX; devIndex++) {
+    if ((slavesMap & (1U << devIndex)) != 0U) {
+      taskData task = {
+        .deviceIndex = devIndex,
+        .apiInfo = API_TYPE_E,
+        .payLoad = &gate,
+        .flag = 0,
+      };
+      if (MMWL_submitTask(&task, &futures[devIndex]) == RL_RET_CODE_OK) {
+        submitted |= (1U << devIndex);
+      } else {
+        retVal = -1;
+      }
+    }
+  }
+  pthread_mutex_lock(&gate.lock);
+  while (gate.stagedMap != submitted) {
+    pthread_cond_wait(&gate.cond, &gate.lock);
+  }
+  pthread_mutex_unlock(&gate.lock);
+
+  /* Run even when a slave failed to stage: the other boards must not wait
+     for this one at their barrier. Both results cancel the trigger. */
+  if (sync->rendezvous != NULL) {
+    rendezvous = sync->rendezvous(sync->arg);
+  }
+
+  /* Release the slaves */
+  pthread_mutex_lock(&gate.lock);
+  gate.state = ((retVal == RL_RET_CODE_OK) && (rendezvous == 0)) ?
+    MMWL_GATE_RELEASED : MMWL_GATE_ABORTED;
+  sync->releaseTime = frameSyncNow();
+  pthread_cond_broadcast(&gate.cond);
+  pthread_mutex_unlock(&gate.lock);
+
+  for (unsigned char devIndex = 0; devIndex < TDA_NUM_CONNECTED_DEVICES_MAX; devIndex++) {
+    if ((submitted & (1U << devIndex)) != 0U) {
+      devRetVal = MMWL_waitTask(&futures[devIndex]);
+      if ((devRetVal != RL_RET_CODE_OK) &&
+          !((startStop == 0U) && (devRetVal == RL_RET_CODE_FRAME_ALREADY_ENDED))) {
+        DEBUG_PRINT("Device map %u : Frame trigger failed with error code %d \n\n",
+          (1U << devIndex), devRetVal);
+        retVal = -1;
+      }
+    }
+  }
+  pthread_cond_destroy(&gate.cond);
+  pthread_mutex_destroy(&gate.lock);
+
+  if (rendezvous != 0) {
+    sync->aborted = 1U;
+    return -1;
+  }
+
+  /* The master last: it starts the frames of the whole cascade */
+  if ((retVal == RL_RET_CODE_OK) && ((deviceMap & (1U << DEFAULT_MASTER_DEVICE)) != 0U)) {
+    devRetVal = frameTrigger(DEFAULT_MASTER_DEVICE, &gate.data, sync);
+    if ((devRetVal != RL_RET_CODE_OK) &&
+        !((startStop == 0U) && (devRetVal == RL_RET_CODE_FRAME_ALREADY_ENDED))) {
+      DEBUG_PRINT("Device map %u : Frame trigger failed with error code %d \n\n",
+        (1U << DEFAULT_MASTER_DEVICE), devRetVal);
+      retVal = -1;
+    }
+  }
+
+  /* Dispatch skew */
+  for (unsigned char devIndex = 0; devIndex < TDA_NUM_CONNECTED_DEVICES_MAX; devIndex++) {
+    uint64_t t = sync->dispatchTime[devIndex];
+    if ((devIndex == DEFAULT_MASTER_DEVICE) || (t == 0U)) continue;
+    if ((first == 0U) || (t < first)) first = t;
+    if (t > last) last = t;
+  }
+  sync->slaveSkew = last - first;
+  sync->masterDelay = ((last != 0U) && (sync->dispatchTime[DEFAULT_MASTER_DEVICE] > last)) ?
+    (sync->dispatchTime[DEFAULT_MASTER_DEVICE] - last) : 0U;
+
+  return retVal;
+}
+
+
+/** @fn int MMWL_StartFrameSync(unsigned char deviceMap, mmwlFrameSync_t *sync)
+*
+*   @brief Start framing: slaves released at once, then the master.
+*
+*   @param[in] deviceMap - Devices to start
+*   @param[in,out] sync - Rendezvous and dispatch times (can be NULL)
+*
+*   @return int Success - 0, Failure - -1
+*/
+int MMWL_StartFrameSync(unsigned char deviceMap, mmwlFrameSync_t *sync) {
+  return frameTriggerSync(deviceMap, 1U, sync);
+}
+
+
+/** @fn int MMWL_StopFrameSync(unsigned char deviceMap, mmwlFrameSync_t *sync)
+*
+*   @brief Stop framing: slaves released at once, then the master.
+*
+*   A frame already ended is not an error.
+*
+*   @param[in] deviceMap - Devices to stop
+*   @param[in,out] sync - Rendezvous and dispatch times (can be NULL)
+*
+*   @return int Success - 0, Failure - -1
+*/
+int MMWL_StopFrameSync(unsigned char deviceMap, mmwlFrameSync_t *sync) {
+  return frameTriggerSync(deviceMap, 0U, sync);
+}
+
+
 /** @fn int MMWL_powerOff(unsigned char deviceMap)
 *
 *   @brief API to poweroff device.
@@ -2041,7 +4043,7 @@ int MMWL_ApllSynthBwConfig(unsigned char deviceMap) {
  * 
  * @param deviceMap - Device Index
  * @param rlClientCbsTimeout - Timeout to use for mmwavelink client
- * @param sopTimeout - Timeout after setting SOP mode in ms
+ * @param sopTimeout - Maximum wait for the TDA to acknowledge the SOP mode in ms
  * @return int 
  */
 int MMWL_DevicePowerUp(unsigned char deviceMap, uint32_t rlClientCbsTimeout, uint32_t sopTimeout) {
@@ -2054,9 +4056,15 @@ int MMWL_DevicePowerUp(unsigned char deviceMap, uint32_t rlClientCbsTimeout, uin
 
   /* Set SOP Mode for the devices */
   if (TDAImpl_devHdl != NULL) {
+    pthread_mutex_lock(&mmwl_eventLock);
+    mmwl_bTDA_SopACK &= ~deviceMap;
+    pthread_mutex_unlock(&mmwl_eventLock);
     retVal = setSOPMode(TDAImpl_devHdl, SOPmode);
-    msleep(1); // Additional 1 msec delay
-    msleep(sopTimeout); // Additional delay
+    /* The TDA acknowledges once the SOP lines are driven. Without the ACK
+      (older TDA firmware), this is the former fixed delay of sopTimeout. */
+    if (retVal == RL_RET_CODE_OK) {
+      eventWait(MMWL_EVT_TDA_SOP, &mmwl_bTDA_SopACK, deviceMap, TRUE, sopTimeout);
+    }
   }
   else {
     DEBUG_PRINT("Device map %u : Cannot get device context\n\n", deviceMap);
@@ -2115,21 +4123,16 @@ int MMWL_DevicePowerUp(unsigned char deviceMap, uint32_t rlClientCbsTimeout, uin
 
   else {
     retVal = CALL_API(API_TYPE_B | ADD_DEVICE_IND, deviceMap, NULL, 0);
-    int timeoutCnt = 0;
     /* TBD - Wait for Power ON complete
       @Note: In case of ES1.0 sample application needs to wait for MSS CPU fault as well with some timeout.
 
       TODO: Wait for MSS CPU fault
     */
     if (RL_RET_CODE_OK == retVal) {
-      while ((mmwl_bInitComp & deviceMap) != deviceMap) {
-        msleep(1); //Sleep 1 msec
-        timeoutCnt++;
-        if (timeoutCnt > MMWL_API_INIT_TIMEOUT) {
-          CALL_API(API_TYPE_B | REMOVE_DEVICE_IND, deviceMap, NULL, 0);
-          retVal = RL_RET_CODE_RESP_TIMEOUT;
-          break;
-        }
+      if (eventWait(MMWL_EVT_POWER_UP, &mmwl_bInitComp, deviceMap, TRUE,
+                    MMWL_API_INIT_TIMEOUT) != RL_RET_CODE_OK) {
+        CALL_API(API_TYPE_B | REMOVE_DEVICE_IND, deviceMap, NULL, 0);
+        retVal = RL_RET_CODE_RESP_TIMEOUT;
       }
     }
     mmwl_bInitComp = mmwl_bInitComp & (~deviceMap);
@@ -2153,6 +4156,158 @@ int MMWL_DevicePowerUp(unsigned char deviceMap, uint32_t rlClientCbsTimeout, uin
 }
 
 
+/** @fn int MMWL_DeviceAttach(deviceMap, rlClientCbsTimeout)
+*
+*   @brief Attach to devices left powered up by a previous session.
+*
+*   @param[in] deviceMap - Devic Index
+*   @param[in] rlClientCbsTimeout - Timeout to use for mmwavelink client in ms
+*
+*   @return int Success - 0, Failure - Error Code
+*
+*   mmWaveLink is initialized without resetting the devices, and each
+*   device must still answer with the firmware recorded at the last
+*   download. Otherwise the devices have been reset or power cycled and
+*   must go through the full power up sequence.
+*/
+int MMWL_DeviceAttach(unsigned char deviceMap, uint32_t rlClientCbsTimeout) {
+  unsigned char masterMap = deviceMap & 1U;
+  unsigned char slavesMap = deviceMap & (~1U);
+  int retVal = RL_RET_CODE_OK;
+
+  if (masterMap != 0U) {
+    retVal = MMWL_initMasterLink(masterMap, rlClientCbsTimeout, FALSE);
+    if (retVal != RL_RET_CODE_OK) return retVal;
+  }
+  for (unsigned char devId = 1; devId < TDA_NUM_CONNECTED_DEVICES_MAX; devId++) {
+    unsigned char devMap = createDevMapFromDevId(devId);
+
+    if ((slavesMap & devMap) == 0U) continue;
+    retVal = CALL_API(API_TYPE_B | ADD_DEVICE_IND, devMap, NULL, 0);
+    if (retVal != RL_RET_CODE_OK) return retVal;
+  }
+
+  if (MMWL_isFwResident(deviceMap) != deviceMap) {
+    DEBUG_PRINT("Device map %u : Devices not running the expected firmware\n\n", deviceMap);
+    return RL_RET_CODE_RESP_TIMEOUT;
+  }
+  return RL_RET_CODE_OK;
+}
+
+
+/** @fn uint64_t MMWL_cfgHash(uint64_t hash, const void *data, size_t len)
+*
+*   @brief Accumulate a configuration block into a FNV-1a hash.
+*
+*   @param[in] hash - Current hash, 0 to start a new one
+*   @param[in] data - Configuration structure
+*   @param[in] len - Size of the structure in bytes
+*
+*   @return uint64_t Updated hash
+*/
+uint64_t MMWL_cfgHash(uint64_t hash, const void *data, size_t len) {
+  const unsigned char *p = (const unsigned char*)data;
+
+  if (hash == 0) hash = 14695981039346656037ULL;
+  for (size_t i = 0; i < len; i++) {
+    hash = (hash ^ p[i]) * 1099511628211ULL;
+  }
+  return hash;
+}
+
+
+static void MMWL_cfgStatePath(const char *ipAddr, char *path, size_t size) {
+  snprintf(path, size, MMWL_CFG_STATE_FILE_FMT, ipAddr);
+}
+
+
+/** @fn int MMWL_cfgStateLoad(const char *ipAddr, mmwlCfgState_t *state)
+*
+*   @brief Read the configuration last applied to a board.
+*
+*   @param[in] ipAddr - IP address of the board
+*   @param[out] state - Configuration state
+*
+*   @return int Success - 0, Failure (no valid state) - Error Code
+*/
+int MMWL_cfgStateLoad(const char *ipAddr, mmwlCfgState_t *state) {
+  char path[128];
+  FILE *fp;
+  size_t count;
+
+  MMWL_cfgStatePath(ipAddr, path, sizeof(path));
+  fp = fopen(path, "rb");
+  if (fp == NULL) return -1;
+  count = fread(state, sizeof(mmwlCfgState_t), 1, fp);
+  fclose(fp);
+
+  if ((count != 1) || (state->magic != MMWL_CFG_STATE_MAGIC) ||
+      (state->version != MMWL_CFG_STATE_VERSION) ||
+      (state->imageHash != MMWL_fwImageHash())) {
+    return -1;
+  }
+  return RL_RET_CODE_OK;
+}
+
+
+/** @fn int MMWL_cfgStateSave(const char *ipAddr, const mmwlCfgState_t *state)
+*
+*   @brief Record the configuration applied to a board.
+*
+*   @param[in] ipAddr - IP address of the board
+*   @param[in] state - Configuration state (the header fields are filled in)
+*
+*   @return int Success - 0, Failure - Error Code
+*/
+int MMWL_cfgStateSave(const char *ipAddr, const mmwlCfgState_t *state) {
+  mmwlCfgState_t record = *state;
+  char path[128];
+
+  record.magic = MMWL_CFG_STATE_MAGIC;
+  record.version = MMWL_CFG_STATE_VERSION;
+  record.imageHash = MMWL_fwImageHash();
+
+  MMWL_cfgStatePath(ipAddr, path, sizeof(path));
+  return MMWL_writeFileAtomic(path, &record, sizeof(record));
+}
+
+
+/** @fn int MMWL_cfgStateClear(const char *ipAddr)
+*
+*   @brief Forget the configuration of a board, e.g. before reconfiguring it.
+*
+*   @param[in] ipAddr - IP address of the board
+*
+*   @return int Success - 0, Failure - Error Code
+*/
+int MMWL_cfgStateClear(const char *ipAddr) {
+  char path[128];
+
+  MMWL_cfgStatePath(ipAddr, path, sizeof(path));
+  if ((remove(path) != 0) && (errno != ENOENT)) return -1;
+  return RL_RET_CODE_OK;
+}
+
+
+/** @fn unsigned int MMWL_cfgStateDiff(const mmwlCfgState_t *previous,
+*                                      const mmwlCfgState_t *current)
+*
+*   @brief Compare two configuration states.
+*
+*   @return unsigned int Bit map of the blocks that differ (1 << MMWL_CFG_BLOCK_*).
+*           All the blocks are reported when the device maps differ.
+*/
+unsigned int MMWL_cfgStateDiff(const mmwlCfgState_t *previous, const mmwlCfgState_t *current) {
+  unsigned int changed = 0U;
+
+  if (previous->deviceMap != current->deviceMap) return (1U << MMWL_CFG_NUM_BLOCKS) - 1U;
+  for (unsigned int i = 0; i < MMWL_CFG_NUM_BLOCKS; i++) {
+    if (previous->blockHash[i] != current->blockHash[i]) changed |= (1U << i);
+  }
+  return changed;
+}
+
+
 /**
  * @brief Prepare the TDA board and notify TDA about the start of recording
  * 
@@ -2161,7 +4316,6 @@ int MMWL_DevicePowerUp(unsigned char deviceMap, uint32_t rlClientCbsTimeout, uin
  */
 int MMWL_ArmingTDA(rlTdaArmCfg_t tdaArmCfgArgs) {
   int retVal = RL_RET_CODE_OK;
-  int timeOutCnt = 0U;
 
   /* Set width and height for all devices*/
 	/* Master */
@@ -2214,22 +4368,11 @@ int MMWL_ArmingTDA(rlTdaArmCfg_t tdaArmCfgArgs) {
     DEBUG_PRINT("INFO: Sending framePeriodicity = %u successful \n\n", tdaArmCfgArgs.framePeriodicity);
   }
 
-  while (1) {
-    if (mmwl_bTDA_FramePeriodicityACK == 0U) {
-      msleep(1); /*Sleep 1 msec*/
-      timeOutCnt++;
-      if (timeOutCnt > MMWL_API_TDA_TIMEOUT) {
-        DEBUG_PRINT("ERROR: Frame Periodicity Response from Capture Card timed out!\n\n");
-        retVal = RL_RET_CODE_RESP_TIMEOUT;
-        return retVal;
-      }
-    }
-    else {
-      break;
-    }
+  if (eventWait(MMWL_EVT_TDA_FRAME_PERIODICITY, &mmwl_bTDA_FramePeriodicityACK, 1U, TRUE, MMWL_API_TDA_TIMEOUT) != RL_RET_CODE_OK) {
+    DEBUG_PRINT("ERROR: Frame Periodicity Response from Capture Card timed out!\n\n");
+    return RL_RET_CODE_RESP_TIMEOUT;
   }
 
-  timeOutCnt = 0U;
   mmwl_bTDA_CaptureDirectoryACK = 0U;
   /* Send session's capture directory to TDA */
   retVal = setSessionDirectory(tdaArmCfgArgs.captureDirectory);
@@ -2244,22 +4387,11 @@ int MMWL_ArmingTDA(rlTdaArmCfg_t tdaArmCfgArgs) {
     DEBUG_PRINT("INFO: Sending capture directory = %s successful \n\n", tdaArmCfgArgs.captureDirectory);
   }
 
-  while (1) {
-    if (mmwl_bTDA_CaptureDirectoryACK == 0U) {
-      msleep(1); /*Sleep 1 msec*/
-      timeOutCnt++;
-      if (timeOutCnt > MMWL_API_TDA_TIMEOUT) {
-        DEBUG_PRINT("ERROR: Capture Directory Response from Capture Card timed out!\n\n");
-        retVal = RL_RET_CODE_RESP_TIMEOUT;
-        return retVal;
-      }
-    }
-    else {
-      break;
-    }
+  if (eventWait(MMWL_EVT_TDA_CAPTURE_DIRECTORY, &mmwl_bTDA_CaptureDirectoryACK, 1U, TRUE, MMWL_API_TDA_TIMEOUT) != RL_RET_CODE_OK) {
+    DEBUG_PRINT("ERROR: Capture Directory Response from Capture Card timed out!\n\n");
+    return RL_RET_CODE_RESP_TIMEOUT;
   }
 
-  timeOutCnt = 0U;
   mmwl_bTDA_FileAllocationACK = 0U;
   /* Send number of files to be pre-allocated to TDA */
   retVal = sendNumAllocatedFiles(tdaArmCfgArgs.numberOfFilesToAllocate);
@@ -2277,22 +4409,11 @@ int MMWL_ArmingTDA(rlTdaArmCfg_t tdaArmCfgArgs) {
     );
   }
 
-  while (1) {
-    if (mmwl_bTDA_FileAllocationACK == 0U) {
-      msleep(1); /*Sleep 1 msec*/
-      timeOutCnt++;
-      if (timeOutCnt > MMWL_API_TDA_TIMEOUT) {
-        DEBUG_PRINT("ERROR: File Allocation Response from Capture Card timed out!\n\n");
-        retVal = RL_RET_CODE_RESP_TIMEOUT;
-        return retVal;
-      }
-    }
-    else {
-      break;
-    }
+  if (eventWait(MMWL_EVT_TDA_FILE_ALLOCATION, &mmwl_bTDA_FileAllocationACK, 1U, TRUE, MMWL_API_TDA_TIMEOUT) != RL_RET_CODE_OK) {
+    DEBUG_PRINT("ERROR: File Allocation Response from Capture Card timed out!\n\n");
+    return RL_RET_CODE_RESP_TIMEOUT;
   }
 
-  timeOutCnt = 0U;
   mmwl_bTDA_DataPackagingACK = 0U;
   /* Send enable Data packing (0 : 16-bit, 1 : 12-bit) to TDA */
   retVal = enableDataPackaging(tdaArmCfgArgs.dataPacking);
@@ -2310,22 +4431,11 @@ int MMWL_ArmingTDA(rlTdaArmCfg_t tdaArmCfgArgs) {
     );
   }
 
-  while (1) {
-    if (mmwl_bTDA_DataPackagingACK == 0U) {
-      msleep(1); /*Sleep 1 msec*/
-      timeOutCnt++;
-      if (timeOutCnt > MMWL_API_TDA_TIMEOUT) {
-        DEBUG_PRINT("ERROR: Enable Data Packaging Response from Capture Card timed out!\n\n");
-        retVal = RL_RET_CODE_RESP_TIMEOUT;
-        return retVal;
-      }
-    }
-    else {
-      break;
-    }
+  if (eventWait(MMWL_EVT_TDA_DATA_PACKAGING, &mmwl_bTDA_DataPackagingACK, 1U, TRUE, MMWL_API_TDA_TIMEOUT) != RL_RET_CODE_OK) {
+    DEBUG_PRINT("ERROR: Enable Data Packaging Response from Capture Card timed out!\n\n");
+    return RL_RET_CODE_RESP_TIMEOUT;
   }
 
-  timeOutCnt = 0U;
   mmwl_bTDA_NumFramesToCaptureACK = 0U;
   /* Send number of frames to be captured by TDA */
   retVal = NumFramesToCapture(tdaArmCfgArgs.numberOfFramesToCapture);
@@ -2343,22 +4453,11 @@ int MMWL_ArmingTDA(rlTdaArmCfg_t tdaArmCfgArgs) {
     );
   }
 
-  while (1) {
-    if (mmwl_bTDA_NumFramesToCaptureACK == 0U) {
-      msleep(1); /*Sleep 1 msec*/
-      timeOutCnt++;
-      if (timeOutCnt > MMWL_API_TDA_TIMEOUT) {
-        DEBUG_PRINT("ERROR: Number of frames to be captured Response from Capture Card timed out!\n\n");
-        retVal = RL_RET_CODE_RESP_TIMEOUT;
-        return retVal;
-      }
-    }
-    else {
-      break;
-    }
+  if (eventWait(MMWL_EVT_TDA_NUM_FRAMES, &mmwl_bTDA_NumFramesToCaptureACK, 1U, TRUE, MMWL_API_TDA_TIMEOUT) != RL_RET_CODE_OK) {
+    DEBUG_PRINT("ERROR: Number of frames to be captured Response from Capture Card timed out!\n\n");
+    return RL_RET_CODE_RESP_TIMEOUT;
   }
 
-  timeOutCnt = 0U;
   mmwl_bTDA_CreateAppACK = 0U;
   /* Notify TDA about creating the application */
   retVal = TDACreateApplication();
@@ -2370,22 +4469,11 @@ int MMWL_ArmingTDA(rlTdaArmCfg_t tdaArmCfgArgs) {
     DEBUG_PRINT("INFO: Notifying TDA about creating application successful \n\n");
   }
 
-  while (1) {
-    if (mmwl_bTDA_CreateAppACK == 0U) {
-      msleep(1); /*Sleep 1 msec*/
-      timeOutCnt++;
-      if (timeOutCnt > MMWL_API_TDA_TIMEOUT*3) {
-        DEBUG_PRINT("ERROR: Create Application Response from Capture Card timed out!\n\n");
-        retVal = RL_RET_CODE_RESP_TIMEOUT;
-        return retVal;
-      }
-    }
-    else {
-      break;
-    }
+  if (eventWait(MMWL_EVT_TDA_CREATE_APP, &mmwl_bTDA_CreateAppACK, 1U, TRUE, MMWL_API_TDA_TIMEOUT*3) != RL_RET_CODE_OK) {
+    DEBUG_PRINT("ERROR: Create Application Response from Capture Card timed out!\n\n");
+    return RL_RET_CODE_RESP_TIMEOUT;
   }
 
-  timeOutCnt = 0U;
   mmwl_bTDA_StartRecordACK = 0U;
   /* Notify TDA about starting the frame */
   retVal = startRecord();
@@ -2398,19 +4486,9 @@ int MMWL_ArmingTDA(rlTdaArmCfg_t tdaArmCfgArgs) {
     mmwl_bTDA_ARMDone = 1U;
   }
 
-  while (1) {
-    if (mmwl_bTDA_StartRecordACK == 0U) {
-      msleep(1); /*Sleep 1 msec*/
-      timeOutCnt++;
-      if (timeOutCnt > MMWL_API_TDA_TIMEOUT) {
-        DEBUG_PRINT("ERROR: Start Record Response from Capture Card timed out!\n\n");
-        retVal = RL_RET_CODE_RESP_TIMEOUT;
-        return retVal;
-      }
-    }
-    else {
-      break;
-    }
+  if (eventWait(MMWL_EVT_TDA_START_RECORD, &mmwl_bTDA_StartRecordACK, 1U, TRUE, MMWL_API_TDA_TIMEOUT) != RL_RET_CODE_OK) {
+    DEBUG_PRINT("ERROR: Start Record Response from Capture Card timed out!\n\n");
+    return RL_RET_CODE_RESP_TIMEOUT;
   }
 
   return retVal;
@@ -2424,7 +4502,6 @@ int MMWL_ArmingTDA(rlTdaArmCfg_t tdaArmCfgArgs) {
  */
 int MMWL_DeArmingTDA() {
   int retVal = RL_RET_CODE_OK;
-  int timeOutCnt = 0;
   mmwl_bTDA_StopRecordACK = 0U;
 
   /* Notify TDA about stopping the frame */
@@ -2438,19 +4515,9 @@ int MMWL_DeArmingTDA() {
     mmwl_bTDA_ARMDone = 0U;
   }
 
-  while (1) {
-    if (mmwl_bTDA_StopRecordACK == 0U) {
-      msleep(1); /*Sleep 1 msec*/
-      timeOutCnt++;
-      if (timeOutCnt > MMWL_API_TDA_TIMEOUT*2) {
-        DEBUG_PRINT("ERROR: TDA Stop Record ACK not received!");
-        retVal = RL_RET_CODE_RESP_TIMEOUT;
-        return retVal;
-      }
-    }
-    else {
-      break;
-    }
+  if (eventWait(MMWL_EVT_TDA_STOP_RECORD, &mmwl_bTDA_StopRecordACK, 1U, TRUE, MMWL_API_TDA_TIMEOUT*2) != RL_RET_CODE_OK) {
+    DEBUG_PRINT("ERROR: TDA Stop Record ACK not received!");
+    return RL_RET_CODE_RESP_TIMEOUT;
   }
 
   return retVal;
@@ -2489,11 +4556,14 @@ int MMWL_DeviceDeInit(unsigned int deviceMap) {
  * @param ipAddr IP Address of the TDA board (default: 192.168.33.30)
  * @param port Port number to communication with the TDA (default: 5001)
  * @param deviceMap All cascaded device map
+ * @param irqMode Host IRQ dispatch mode (TDA_IRQ_MODE_POLLING or TDA_IRQ_MODE_EVENT)
  * @return int Initialization status
  */
-int MMWL_TDAInit(unsigned char *ipAddr, unsigned int port, uint8_t deviceMap) {
+int MMWL_TDAInit(unsigned char *ipAddr, unsigned int port, uint8_t deviceMap, uint8_t irqMode) {
   int retVal = RL_RET_CODE_OK;
-  int timeOutCnt = 0;
+
+  /* Must be set before the devices are enabled at power up */
+  TDASetIrqMode(irqMode);
 
   /* Register Async event handler with TDA */
   retVal = registerTDAStatusCallback((TDA_EVENT_HANDLER)TDA_asyncEventHandler);
@@ -2518,19 +4588,9 @@ int MMWL_TDAInit(unsigned char *ipAddr, unsigned int port, uint8_t deviceMap) {
     );
     return -1;
   }
-  while (1) {
-    if (mmwl_bTDA_CaptureCardConnect == 0U) {
-      msleep(1); /*Sleep 1 msec*/
-      timeOutCnt++;
-      if (timeOutCnt > MMWL_API_TDA_TIMEOUT) {
-        DEBUG_PRINT("ERROR: No Acknowlegment received from the capture card! \n\n");
-        retVal = RL_RET_CODE_RESP_TIMEOUT;
-        return retVal;
-      }
-    }
-    else {
-      break;
-    }
+  if (eventWait(MMWL_EVT_TDA_CONNECT, &mmwl_bTDA_CaptureCardConnect, 1U, TRUE, MMWL_API_TDA_TIMEOUT) != RL_RET_CODE_OK) {
+    DEBUG_PRINT("ERROR: No Acknowlegment received from the capture card! \n\n");
+    return RL_RET_CODE_RESP_TIMEOUT;
   }
 
   if (retVal == RL_RET_CODE_OK) {
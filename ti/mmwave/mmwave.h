@@ -17,6 +17,9 @@
 #include <pthread.h>
 #include <time.h>
 #include <errno.h>
+#include <sched.h>
+#include <semaphore.h>
+#include <stdatomic.h>
 
 /* AWR2243 meta image file */
 #include "../firmware/xwr22xx_metaImage.h"
@@ -24,8 +27,10 @@
 // #include "../firmware/xwr12xx_metaImage.h"
 
 #include "../mmwavelink/mmwavelink.h"
+#include "../mmwavelink/include/rl_driver.h"
 #include "../ethernet/src/mmwl_port_ethernet.h"
 #include "rls_osi.h"
+#include "mmwl_health.h"
 
 
 /******************************************************************************
@@ -58,6 +63,9 @@
 #define MMWL_FW_CHUNK_SIZE (232U)
 #define MMWL_META_IMG_FILE_SIZE (sizeof(metaImage))
 
+/* Record of the firmware version loaded by the last download */
+#define MMWL_FW_CACHE_FILE       "/tmp/mmwave_fw.cache"
+
 #define GET_BIT_VALUE(data, noOfBits, location)    \
             ((((rlUInt32_t)(data)) >> (location)) &\
             (((rlUInt32_t)((rlUInt32_t)1U << (noOfBits))) - (rlUInt32_t)1U))
@@ -68,6 +76,36 @@
 #define MMWL_API_START_TIMEOUT                (1000) /* 1 Sec*/
 #define MMWL_API_RF_INIT_TIMEOUT              (1000) /* 1 Sec*/
 
+/* Events awaited by the flow (async events of the devices, ACKs of the TDA) */
+#define MMWL_EVT_POWER_UP                     (0U)
+#define MMWL_EVT_RF_START                     (1U)
+#define MMWL_EVT_RF_INIT                      (2U)
+#define MMWL_EVT_FRAME_START                  (3U)
+#define MMWL_EVT_FRAME_END                    (4U)
+#define MMWL_EVT_GPADC                        (5U)
+#define MMWL_EVT_TDA_CONNECT                  (6U)
+#define MMWL_EVT_TDA_SOP                      (7U)
+#define MMWL_EVT_TDA_FRAME_PERIODICITY        (8U)
+#define MMWL_EVT_TDA_CAPTURE_DIRECTORY        (9U)
+#define MMWL_EVT_TDA_FILE_ALLOCATION          (10U)
+#define MMWL_EVT_TDA_DATA_PACKAGING           (11U)
+#define MMWL_EVT_TDA_NUM_FRAMES               (12U)
+#define MMWL_EVT_TDA_CREATE_APP               (13U)
+#define MMWL_EVT_TDA_START_RECORD             (14U)
+#define MMWL_EVT_TDA_STOP_RECORD              (15U)
+#define MMWL_EVT_COUNT                        (16U)
+
+/* Depth of the task queue of each device worker (power of 2) */
+#define MMWL_WORKER_QUEUE_SIZE                (8U)
+
+/* Set-config transactions: queued sub-blocks and bytes of payload */
+#define MMWL_TXN_MAX_ENTRIES                  (RL_MAX_SB_IN_MSG)
+#define MMWL_TXN_BUFFER_SIZE                  (1024U)
+
+/* Batches: API calls in flight without barrier between devices */
+#define MMWL_BATCH_MAX_CALLS                  (16U)
+#define MMWL_BATCH_BUFFER_SIZE                (1024U)
+
 /* MAX unique chirp AWR2243 supports */
 #define MAX_UNIQUE_CHIRP_INDEX                (512 -1)
 
@@ -99,6 +137,8 @@ typedef struct {
 #define API_TYPE_A		0x00000000
 #define API_TYPE_B		0x10000000
 #define API_TYPE_C		0x20000000
+#define API_TYPE_D		0x30000000	/* Set-config transaction */
+#define API_TYPE_E		0x40000000	/* Frame trigger released at a gate */
 
 typedef struct {
   unsigned int deviceIndex;
@@ -108,6 +148,118 @@ typedef struct {
 } taskData;
 
 
+/*! \brief
+* Completion of a task submitted to a device worker
+*/
+typedef struct mmwlFuture {
+  sem_t done;
+  rlReturnVal_t retVal;
+} mmwlFuture_t;
+
+
+/*! \brief
+* Sub-block queued in a set-config transaction
+*/
+typedef struct mmwlTxnEntry {
+  /* Message and sub-block of the set API (RL_*_SET_MSG, RL_*_SB) */
+  rlUInt16_t msgId;
+  rlUInt16_t sbcId;
+
+  /* Payload, copied into the buffer of the transaction */
+  rlUInt16_t offset;
+  rlUInt16_t len;
+
+  /* Status of the sub-block on each device of the transaction */
+  rlReturnVal_t status[TDA_NUM_CONNECTED_DEVICES_MAX];
+} mmwlTxnEntry_t;
+
+
+/*! \brief
+* Set-config transaction
+*
+* The sub-blocks queued for the same devices are sent in as few messages as
+* the protocol allows: consecutive sub-blocks of the same message ID share a
+* message, up to RL_MAX_SB_IN_MSG sub-blocks and RL_CMD_PL_LEN_MAX bytes.
+*/
+typedef struct mmwlTxn {
+  unsigned char deviceMap;
+  unsigned int numEntries;
+
+  /* Number of messages sent per device by the last commit */
+  unsigned int numMessages;
+
+  mmwlTxnEntry_t entries[MMWL_TXN_MAX_ENTRIES];
+  rlUInt16_t used;
+  rlUInt8_t buffer[MMWL_TXN_BUFFER_SIZE];
+} mmwlTxn_t;
+
+
+/*! \brief
+* Batch of API calls
+*
+* The calls are queued on the worker of each device without waiting for the
+* other devices: a device goes on with its next command while the others
+* are still waiting for their response. Up to MMWL_WORKER_QUEUE_SIZE calls
+* are outstanding per device, submitting more waits for a free slot.
+*/
+typedef struct mmwlBatch {
+  unsigned int numCalls;
+
+  /* Devices each call has been submitted to */
+  unsigned char callMap[MMWL_BATCH_MAX_CALLS];
+  mmwlFuture_t futures[MMWL_BATCH_MAX_CALLS][TDA_NUM_CONNECTED_DEVICES_MAX];
+
+  /* Payloads copied at submission */
+  unsigned int used;
+  uint64_t buffer[MMWL_BATCH_BUFFER_SIZE / sizeof(uint64_t)];
+} mmwlBatch_t;
+
+
+/*! \brief
+* Time spent waiting for an event
+*/
+typedef struct mmwlEventStat {
+  const char *name;
+  unsigned int count;
+  unsigned int timeouts;
+  uint64_t totalNs;
+  uint64_t maxNs;
+} mmwlEventStat_t;
+
+
+/*! \brief
+* Synchronized frame start/stop
+*
+* The frame trigger of the slaves is staged on their worker and released
+* at once, the master is triggered right after the slaves are ready. The
+* times are CLOCK_REALTIME (ns), comparable between the processes driving
+* several boards. The dispatches are also given in CLOCK_MONOTONIC time, and
+* the frame start/end event of each device in CLOCK_REALTIME time.
+*/
+typedef struct mmwlFrameSync {
+  /* Called once the slaves are staged, right before their release (e.g.
+     barrier between boards). A non-zero return cancels the trigger. */
+  int32_t (*rendezvous)(void *arg);
+  void *arg;
+
+  /* Set when the rendezvous cancelled the trigger */
+  unsigned char aborted;
+
+  /* Release of the slaves and dispatch of the trigger to each device */
+  uint64_t releaseTime;
+  uint64_t dispatchTime[TDA_NUM_CONNECTED_DEVICES_MAX];
+  uint64_t dispatchMono[TDA_NUM_CONNECTED_DEVICES_MAX];
+
+  /* Frame start (start) / frame end (stop) event of each device */
+  uint64_t eventTime[TDA_NUM_CONNECTED_DEVICES_MAX];
+
+  /* Spread of the slave dispatches, and master dispatch after the last
+     slave dispatch */
+  uint64_t slaveSkew;
+  uint64_t masterDelay;
+} mmwlFrameSync_t;
+
+
 /*! \brief
 * Global Configuration Structure
 */
@@ -214,32 +366,179 @@ typedef struct rlTdaArmCfg {
 } rlTdaArmCfg_t;
 
 
+/*! \brief
+* Firmware resident check record
+*/
+typedef struct mmwlFwCache {
+  /* Size of the meta image in bytes */
+  uint32_t imageLen;
+
+  /* FNV-1a hash of the meta image */
+  uint32_t imageHash;
+
+  /* MSS patch version reported once the image is loaded */
+  uint8_t mssPatchMajor;
+  uint8_t mssPatchMinor;
+  uint8_t mssPatchBuildDebug;
+  uint8_t reserved;
+} mmwlFwCache_t;
+
+
+/*! \brief
+* Configuration blocks tracked between sessions
+*/
+#define MMWL_CFG_BLOCK_DEVICE     (0U)  /* Channels, data format, datapath, ... */
+#define MMWL_CFG_BLOCK_PROFILE    (1U)
+#define MMWL_CFG_BLOCK_CHIRP      (2U)
+#define MMWL_CFG_BLOCK_FRAME      (3U)
+#define MMWL_CFG_NUM_BLOCKS       (4U)
+
+/* Last applied configuration of a board, "%s" is the board IP address */
+#define MMWL_CFG_STATE_FILE_FMT   "/tmp/mmwave_cfg_%s.state"
+#define MMWL_CFG_STATE_MAGIC      (0x434D4D57U)
+#define MMWL_CFG_STATE_VERSION    (1U)
+
+/*! \brief
+* Configuration state record
+*/
+typedef struct mmwlCfgState {
+  /* MMWL_CFG_STATE_MAGIC */
+  uint32_t magic;
+
+  /* MMWL_CFG_STATE_VERSION */
+  uint32_t version;
+
+  /* Devices the configuration has been applied to */
+  uint32_t deviceMap;
+
+  /* Identity of the firmware image running on the devices */
+  uint32_t imageHash;
+
+  /* FNV-1a hash of each configuration block */
+  uint64_t blockHash[MMWL_CFG_NUM_BLOCKS];
+} mmwlCfgState_t;
+
+/* Boot-time calibrations run by rlRfInit */
+#define MMWL_CALIB_BOOT_MASK      (0x1FF0U)
+
+/* Calibrations restored from the cache: RX ADC DC offset, HPF, LPF, RX gain, IQMM */
+#define MMWL_CALIB_RESTORE_MASK   (0x14E0U)
+
+/* Calibration data of a device, "%s" is the board IP address, "%u" the
+   device index and "%d" the temperature band */
+#define MMWL_CALIB_FILE_FMT       "/tmp/mmwave_calib_%s_%u_%d.cal"
+#define MMWL_CALIB_MAGIC          (0x434D4D43U)
+#define MMWL_CALIB_VERSION        (1U)
+
+/* Width of a temperature band in degree Celsius */
+#define MMWL_CALIB_TEMP_BAND      (10)
+
+/* Validity of the calibration data in seconds */
+#define MMWL_CALIB_VALIDITY_S     (24 * 3600)
+
+/*! \brief
+* Calibration cache record of a device
+*/
+typedef struct mmwlCalibCache {
+  /* MMWL_CALIB_MAGIC */
+  uint32_t magic;
+
+  /* MMWL_CALIB_VERSION */
+  uint32_t version;
+
+  /* Identity of the firmware image that produced the data */
+  uint32_t imageHash;
+
+  /* Die ID of the device (rlGetRfDieId) */
+  uint32_t dieId[4];
+
+  /* Temperature of the calibration in degree Celsius */
+  int32_t temperature;
+
+  /* Time of the calibration (seconds since the Epoch) */
+  int64_t timestamp;
+
+  /* Calibration data read back with rlRfCalibDataStore */
+  rlCalibrationData_t data;
+} mmwlCalibCache_t;
+
+
 /******************************************************************************
 * FUNCTION DECLARATION
 *******************************************************************************
 */
 
+/* Event completion */
+int MMWL_eventStats(unsigned int evt, mmwlEventStat_t *stat);
+void MMWL_eventStatsReset(void);
+
+/* RF health monitoring */
+int MMWL_monitorConfig(unsigned char deviceMap, mmwlMonCfg_t monCfgArgs,
+                       rlChanCfg_t rfChanCfgArgs, rlProfileCfg_t profileCfgArgs);
+
+/* Device worker pool */
+int MMWL_workerPoolInit(void);
+void MMWL_workerPoolDeInit(void);
+int MMWL_submitTask(taskData *task, mmwlFuture_t *future);
+rlReturnVal_t MMWL_waitTask(mmwlFuture_t *future);
+
+/* Set-config transactions */
+void MMWL_txnInit(mmwlTxn_t *txn, unsigned char deviceMap);
+int MMWL_txnAdd(mmwlTxn_t *txn, rlUInt16_t msgId, rlUInt16_t sbcId,
+                const void *data, rlUInt16_t len);
+int MMWL_txnLdoBypass(mmwlTxn_t *txn, rlRfLdoBypassCfg_t rfLdoBypassCfgArgs);
+int MMWL_txnDataFmt(mmwlTxn_t *txn, rlDevDataFmtCfg_t dataFmtCfgArgs);
+int MMWL_txnLowPower(mmwlTxn_t *txn, rlLowPowerModeCfg_t rfLpModeCfgArgs);
+int MMWL_txnApllSynthBw(mmwlTxn_t *txn);
+int MMWL_txnMisc(mmwlTxn_t *txn, rlRfMiscConf_t miscCfg);
+int MMWL_txnDataPath(mmwlTxn_t *txn, rlDevDataPathCfg_t dataPathCfgArgs);
+int MMWL_txnHsiClock(mmwlTxn_t *txn, rlDevDataPathClkCfg_t dataPathClkCfgArgs,
+                     rlDevHsiClk_t hsiClkgs);
+int MMWL_txnCSI2Lane(mmwlTxn_t *txn, rlDevCsi2Cfg_t CSI2LaneCfgArgs);
+int MMWL_txnCommit(mmwlTxn_t *txn);
+int MMWL_txnStatus(const mmwlTxn_t *txn, int entry);
+
+/* Batches of API calls */
+void MMWL_batchInit(mmwlBatch_t *batch);
+int MMWL_batchTxn(mmwlBatch_t *batch, mmwlTxn_t *txn);
+int MMWL_batchRFDeviceConfig(mmwlBatch_t *batch, unsigned char deviceMap);
+int MMWL_batchProfileConfig(mmwlBatch_t *batch, unsigned char deviceMap,
+                            rlProfileCfg_t profileCfgArgs);
+int MMWL_batchProfileTable(mmwlBatch_t *batch, unsigned char deviceMap,
+                           rlProfileCfg_t *profileCfgArgs, unsigned short count);
+int MMWL_batchWait(mmwlBatch_t *batch);
+int MMWL_batchStatus(const mmwlBatch_t *batch, int call);
+
 /*Device poweroff*/
 int MMWL_powerOff(unsigned char deviceMap);
 
 /*sensor stop*/
 int MMWL_sensorStop(unsigned char deviceMap);
 int MMWL_StopFrame(unsigned char deviceMap);
+int MMWL_StopFrameSync(unsigned char deviceMap, mmwlFrameSync_t *sync);
 
 /*Sensor start*/
 int MMWL_sensorStart(unsigned char deviceMap);
 int MMWL_StartFrame(unsigned char deviceMap);
+int MMWL_StartFrameSync(unsigned char deviceMap, mmwlFrameSync_t *sync);
 
 /*Frame configuration*/
 int MMWL_frameConfig(
   unsigned char deviceMap, rlFrameCfg_t frameCfgArgs, rlChanCfg_t rfChanCfgArgs,
   rlAdcOutCfg_t adcOutCfgArgs, rlDevDataPathCfg_t dataPathCfgArgs, rlProfileCfg_t profileCfgArgs);
+int MMWL_advFrameConfig(
+  unsigned char deviceMap, rlAdvFrameCfg_t advFrameCfgArgs, rlChanCfg_t rfChanCfgArgs,
+  rlAdcOutCfg_t adcOutCfgArgs, rlDevDataPathCfg_t dataPathCfgArgs, rlProfileCfg_t profileCfgArgs);
 
 /*Chirp configuration*/
 int MMWL_chirpConfig(unsigned char deviceMap, rlChirpCfg_t chirpCfgArgs);
+int MMWL_chirpTableConfig(unsigned char deviceMap, rlChirpCfg_t **chirpTables,
+                          unsigned short *chirpCounts);
 
 /*Profile configuration*/
 int MMWL_profileConfig(unsigned char deviceMap, rlProfileCfg_t profileCfgArgs);
+int MMWL_profileTableConfig(unsigned char deviceMap, rlProfileCfg_t *profileCfgArgs,
+                            unsigned short count);
 
 /*HSI lane configuration*/
 int MMWL_hsiLaneConfig(unsigned char deviceMap);
@@ -260,6 +559,7 @@ int MMWL_dataPathConfig(unsigned char deviceMap, rlDevDataPathCfg_t dataPathCfgA
 
 /*RFinit*/
 int MMWL_rfInit(unsigned char deviceMap);
+int MMWL_rfInitCached(unsigned char deviceMap, const char *ipAddr, unsigned char restore);
 
 /* RF Device configuration */
 int MMWL_RFDeviceConfig(unsigned char deviceMap);
@@ -286,10 +586,23 @@ int MMWL_rfEnable(unsigned char deviceMap);
 /*Download firmware API*/
 int MMWL_firmwareDownload(unsigned char deviceMap);
 int MMWL_fileDownload(unsigned char deviceMap, unsigned int fileLen);
+int MMWL_buildFwChunkTable(unsigned int fileLen);
+unsigned char MMWL_isFwResident(unsigned char deviceMap);
+int MMWL_saveFwResident(unsigned char deviceMap);
 int MMWL_fileWrite(unsigned char deviceMap, unsigned short remChunks,
                    unsigned short chunkLen,
                    unsigned char *chunk);
 
+/*Configuration state between sessions*/
+uint64_t MMWL_cfgHash(uint64_t hash, const void *data, size_t len);
+int MMWL_cfgStateLoad(const char *ipAddr, mmwlCfgState_t *state);
+int MMWL_cfgStateSave(const char *ipAddr, const mmwlCfgState_t *state);
+int MMWL_cfgStateClear(const char *ipAddr);
+unsigned int MMWL_cfgStateDiff(const mmwlCfgState_t *previous, const mmwlCfgState_t *current);
+
+/** Attach to devices already powered up and configured */
+int MMWL_DeviceAttach(unsigned char deviceMap, uint32_t rlClientCbsTimeout);
+
 /** Power up device */
 int MMWL_DevicePowerUp(unsigned char deviceMap, uint32_t rlClientCbsTimeout, uint32_t sopTimeout);
 
@@ -297,7 +610,7 @@ int MMWL_DevicePowerUp(unsigned char deviceMap, uint32_t rlClientCbsTimeout, uin
 int MMWL_powerOnMaster(unsigned char deviceMap, uint32_t rlClientCbsTimeout);
 
 /** Connect to ethernet and init TDA */
-int MMWL_TDAInit(unsigned char *ipAddr, unsigned int port, uint8_t deviceMap);
+int MMWL_TDAInit(unsigned char *ipAddr, unsigned int port, uint8_t deviceMap, uint8_t irqMode);
 
 /** Setup the TDA for recording */
 int MMWL_ArmingTDA(rlTdaArmCfg_t tdaArmCfgArgs);
@@ -305,6 +618,15 @@ int MMWL_ArmingTDA(rlTdaArmCfg_t tdaArmCfgArgs);
 /** Notify signal to stop recording */
 int MMWL_DeArmingTDA();
 
+/** Size of a frame of raw ADC data */
+unsigned int MMWL_getFrameSize(unsigned char deviceMap);
+int MMWL_getFrameDims(unsigned char devId, unsigned int *width, unsigned int *height);
+
+/** Geometry of a frame of raw ADC data, computed from the configuration */
+int MMWL_frameGeometry(unsigned int numChirps, rlChanCfg_t rfChanCfgArgs, rlAdcOutCfg_t adcOutCfgArgs,
+  rlDevDataPathCfg_t dataPathCfgArgs, rlProfileCfg_t profileCfgArgs,
+  unsigned int *width, unsigned int *height);
+
 /** Assign device map */
 int MMWL_AssignDeviceMap(unsigned char deviceMap, uint8_t* masterMap, uint8_t* slavesMap);
 
@@ -0,0 +1,113 @@
+/**
+ * @file mmwl_health.h
+ * @brief RF health monitoring of the devices
+ * @version 0.1
+ * @date 2026-10-14
+ *
+ * @copyright Copyright (c) 2026
+ *
+ * The monitors enabled by MMWL_monitorConfig run autonomously on the
+ * devices, once every monitoring period. Their reports are received as
+ * async events: the async event handler of each device queues them into a
+ * fixed-size ring (single producer, single consumer, no lock), and
+ * MMWL_healthCollect aggregates them into a snapshot without any message
+ * to the devices.
+ */
+#ifndef MMWL_HEALTH_H
+#define MMWL_HEALTH_H
+
+#include <stdint.h>
+
+/* RF health monitors enabled at configure time (mmwlMonCfg_t.enable) */
+#define MMWL_MON_TEMPERATURE                  (1U << 0)
+#define MMWL_MON_RX_GAIN_PHASE                (1U << 1)
+#define MMWL_MON_TX_POWER                     (1U << 2)
+#define MMWL_MON_SYNTH_FREQ                   (1U << 3)
+#define MMWL_MON_ALL                          (0x0FU)
+
+/* Aggregates of a snapshot, one per report type */
+#define MMWL_HEALTH_TEMPERATURE               (0U)
+#define MMWL_HEALTH_RX_GAIN                   (1U)
+#define MMWL_HEALTH_TX0_POWER                 (2U)
+#define MMWL_HEALTH_TX1_POWER                 (3U)
+#define MMWL_HEALTH_TX2_POWER                 (4U)
+#define MMWL_HEALTH_SYNTH_FREQ                (5U)
+#define MMWL_HEALTH_COUNT                     (6U)
+
+/* Devices, values kept per report and reports queued per device (power of 2) */
+#define MMWL_HEALTH_MAX_DEVICES               (4U)
+#define MMWL_HEALTH_MAX_VALUES                (12U)
+#define MMWL_HEALTH_RING_DEPTH                (256U)
+
+
+/** RF health monitoring configuration */
+typedef struct mmwlMonCfg {
+  /* MMWL_MON_*, 0 to leave the monitors disabled */
+  uint8_t enable;
+
+  /* 0: report every period, 1: report failures only, 2: report every
+     period with the threshold check */
+  uint8_t reportMode;
+
+  /* Monitoring period (CALIB_MON_TIME_UNIT), 1 LSB = 1 frame */
+  uint16_t period;
+
+  /* Temperature range and spread between the sensors, 1 LSB = 1 C */
+  int16_t tempMin;
+  int16_t tempMax;
+  uint16_t tempDiff;
+
+  /* Maximum error of the RX gain and TX power, 1 LSB = 0.1 dB */
+  uint16_t rxGainErr;
+  uint16_t txPowerErr;
+
+  /* Maximum synthesizer frequency error, 1 LSB = 10 kHz */
+  uint16_t synthFreqErr;
+} mmwlMonCfg_t;
+
+
+/** Aggregate of the reports of one monitor of a device */
+typedef struct mmwlHealthStat {
+  unsigned int reports;
+
+  /* Reports with a non-zero error code, and the last one received */
+  unsigned int errors;
+  uint16_t lastError;
+
+  /* Status flags of the reports ANDed: a cleared bit failed at least once
+     (only meaningful with the threshold check) */
+  uint16_t status;
+
+  /* Device time stamps of the first and last reports (ms) */
+  uint32_t firstTimeStamp;
+  uint32_t lastTimeStamp;
+
+  /* Values of the reports, in the unit of the report */
+  uint8_t numValues;
+  int32_t last[MMWL_HEALTH_MAX_VALUES];
+  int32_t min[MMWL_HEALTH_MAX_VALUES];
+  int32_t max[MMWL_HEALTH_MAX_VALUES];
+} mmwlHealthStat_t;
+
+
+/** RF health of the devices over a capture */
+typedef struct mmwlHealthSnapshot {
+  /* Reports lost because the ring of the device was full */
+  unsigned int dropped[MMWL_HEALTH_MAX_DEVICES];
+  mmwlHealthStat_t stat[MMWL_HEALTH_MAX_DEVICES][MMWL_HEALTH_COUNT];
+} mmwlHealthSnapshot_t;
+
+
+/* Monitors of a name ("temp", "rx-gain", "tx-power", "synth", "all") */
+unsigned char MMWL_monitorByName(const char *name);
+
+/* Name of an aggregate (MMWL_HEALTH_*) */
+const char* MMWL_healthName(unsigned int monitor);
+
+/* Start a new snapshot, discarding the reports not collected yet */
+void MMWL_healthReset(mmwlHealthSnapshot_t *snap);
+
+/* Aggregate the reports received since the last call */
+unsigned int MMWL_healthCollect(mmwlHealthSnapshot_t *snap);
+
+#endif
@@ -0,0 +1,404 @@
+/**
+ * @file mmwl_stream.c
+ * @brief Live ADC stream receiver
+ * @version 0.1
+ * @date 2026-10-14
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <time.h>
+#include <unistd.h>
+#include <limits.h>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/syscall.h>
+#include <linux/futex.h>
+#include "../mmwavelink/mmwavelink.h"
+#include "mmwl_stream.h"
+
+/* Huge page size used to round the ring size */
+#define MMWL_STREAM_HUGE_PAGE_SIZE                  (2U * 1024U * 1024U)
+
+/* Alignment of each slot */
+#define MMWL_STREAM_SLOT_ALIGN                      (4096U)
+
+
+/** @fn static uint64_t MMWL_streamRealtime()
+*
+*   @brief CLOCK_REALTIME time
+*
+*   @return uint64_t Time (ns)
+*/
+static uint64_t MMWL_streamRealtime() {
+  struct timespec ts;
+  clock_gettime(CLOCK_REALTIME, &ts);
+  return (uint64_t)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+/** @fn static int MMWL_streamRecvAll(int fd, void *buffer, size_t length)
+*
+*   @brief Receive exactly length bytes
+*
+*   @param[in] fd - Socket
+*   @param[out] buffer - Destination
+*   @param[in] length - Number of bytes
+*
+*   @return int Success - 0, Failure - -1
+*/
+static int MMWL_streamRecvAll(int fd, void *buffer, size_t length) {
+  uint8_t *p = (uint8_t *)buffer;
+  ssize_t n;
+
+  while (length > 0) {
+    n = recv(fd, p, length, MSG_WAITALL);
+    if ((n < 0) && (errno == EINTR)) continue;
+    if (n <= 0) return -1;
+    p += n;
+    length -= n;
+  }
+  return 0;
+}
+
+/** @fn static int MMWL_streamConnect(mmwlStream_t *stream)
+*
+*   @brief Connect to the data socket of the DSP board
+*
+*   @param[in] stream - Stream
+*
+*   @return int Socket descriptor, -1 on failure
+*/
+static int MMWL_streamConnect(mmwlStream_t *stream) {
+  struct sockaddr_in addr;
+  struct pollfd pfd;
+  int bufferSize = MMWL_STREAM_SOCKET_BUFFER_SIZE;
+  int error = 0;
+  socklen_t len = sizeof(error);
+  int fd, flags;
+
+  memset(&addr, 0, sizeof(addr));
+  addr.sin_family = AF_INET;
+  addr.sin_port = htons(stream->port);
+  if (inet_pton(AF_INET, stream->ipAddr, &addr.sin_addr) != 1) return -1;
+
+  fd = socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, 0);
+  if (fd < 0) return -1;
+  setsockopt(fd, SOL_SOCKET, SO_RCVBUF, &bufferSize, sizeof(bufferSize));
+
+  /* Connect with a timeout so that closing the stream is never held up */
+  flags = fcntl(fd, F_GETFL, 0);
+  fcntl(fd, F_SETFL, flags | O_NONBLOCK);
+  if (connect(fd, (struct sockaddr *)&addr, sizeof(addr)) != 0) {
+    if (errno != EINPROGRESS) {
+      close(fd);
+      return -1;
+    }
+    pfd.fd = fd;
+    pfd.events = POLLOUT;
+    if ((poll(&pfd, 1, MMWL_STREAM_RECONNECT_DELAY) != 1) ||
+        (getsockopt(fd, SOL_SOCKET, SO_ERROR, &error, &len) != 0) || (error != 0)) {
+      close(fd);
+      return -1;
+    }
+  }
+  fcntl(fd, F_SETFL, flags);
+  return fd;
+}
+
+/** @fn static int MMWL_streamDiscard(int fd, uint32_t length)
+*
+*   @brief Skip the data of a frame that does not fit in a slot
+*
+*   @param[in] fd - Socket
+*   @param[in] length - Number of bytes to skip
+*
+*   @return int Success - 0, Failure - -1
+*/
+static int MMWL_streamDiscard(int fd, uint32_t length) {
+  uint8_t scratch[4096];
+
+  while (length > 0) {
+    uint32_t chunk = (length < sizeof(scratch)) ? length : sizeof(scratch);
+    if (MMWL_streamRecvAll(fd, scratch, chunk) != 0) return -1;
+    length -= chunk;
+  }
+  return 0;
+}
+
+/** @fn static void* MMWL_streamReceiver(void *arg)
+*
+*   @brief Receiver thread: land the frames into the ring
+*
+*   The thread (re)connects to the data socket until the stream is closed.
+*   Each frame is received directly into the slot it is published from.
+*
+*   @param[in] arg - Stream
+*
+*   @return void* NULL
+*/
+static void* MMWL_streamReceiver(void *arg) {
+  mmwlStream_t *stream = (mmwlStream_t *)arg;
+  mmwlStreamHeader_t header;
+  mmwlStreamSlot_t *slot;
+  uint32_t expectedSeq = 0;
+  uint8_t firstFrame;
+  uint64_t seq;
+  int fd;
+
+  while (atomic_load(&stream->running)) {
+    fd = MMWL_streamConnect(stream);
+    if (fd < 0) {
+      struct timespec ts = { .tv_sec = 0, .tv_nsec = 100000000L };
+      for (uint32_t i = 0; (i < MMWL_STREAM_RECONNECT_DELAY / 100) && atomic_load(&stream->running); i++) {
+        nanosleep(&ts, NULL);
+      }
+      continue;
+    }
+    stream->sockFd = fd;
+    stream->stats.connections++;
+    atomic_store(&stream->connected, 1U);
+    firstFrame = 1U;
+
+    while (atomic_load(&stream->running)) {
+      if (MMWL_streamRecvAll(fd, &header, sizeof(header)) != 0) break;
+      /* Lost the frame boundaries: start over with a new connection */
+      if (header.magic != MMWL_STREAM_MAGIC) break;
+
+      if (header.length > stream->slotSize) {
+        stream->stats.oversized++;
+        if (MMWL_streamDiscard(fd, header.length) != 0) break;
+        continue;
+      }
+
+      seq = atomic_load_explicit(&stream->head, memory_order_relaxed);
+      slot = &stream->slots[seq & (stream->numSlots - 1)];
+
+      /* Readers still holding the previous frame of this slot will notice */
+      atomic_store_explicit(&slot->state, ((seq + 1) << 1) | 1U, memory_order_relaxed);
+      atomic_thread_fence(memory_order_release);
+
+      if (MMWL_streamRecvAll(fd, slot->data, header.length) != 0) break;
+
+      slot->sequence = header.sequence;
+      slot->length = header.length;
+      slot->deviceMap = header.deviceMap;
+      slot->timestamp = MMWL_streamRealtime();
+      if (!firstFrame && ((int32_t)(header.sequence - expectedSeq) > 0)) {
+        stream->stats.lost += header.sequence - expectedSeq;
+      }
+      expectedSeq = header.sequence + 1;
+      firstFrame = 0U;
+      stream->stats.frames++;
+      stream->stats.bytes += header.length;
+
+      atomic_store_explicit(&slot->state, (seq + 1) << 1, memory_order_release);
+      atomic_store_explicit(&stream->head, seq + 1, memory_order_release);
+      atomic_fetch_add_explicit(&stream->published, 1U, memory_order_release);
+      if (atomic_load(&stream->waiters) > 0) {
+        syscall(SYS_futex, &stream->published, FUTEX_WAKE_PRIVATE, INT_MAX, NULL, NULL, 0);
+      }
+    }
+
+    atomic_store(&stream->connected, 0U);
+    stream->sockFd = -1;
+    close(fd);
+  }
+  return NULL;
+}
+
+/** @fn int MMWL_streamOpen(mmwlStream_t *stream, const char *ipAddr, uint16_t port,
+*                           uint32_t frameSize, uint32_t numSlots)
+*
+*   @brief Allocate the ring and start receiving frames
+*
+*   @param[out] stream - Stream
+*   @param[in] ipAddr - IP address of the DSP board
+*   @param[in] port - Data socket port of the DSP board
+*   @param[in] frameSize - Size of a frame (see MMWL_getFrameSize)
+*   @param[in] numSlots - Number of frames in the ring (rounded up to a power of 2)
+*
+*   @return int Success - 0, Failure - Error Code
+*/
+int MMWL_streamOpen(mmwlStream_t *stream, const char *ipAddr, uint16_t port,
+                    uint32_t frameSize, uint32_t numSlots) {
+  uint32_t slots = 1;
+
+  if ((stream == NULL) || (ipAddr == NULL) || (frameSize == 0)) return RL_RET_CODE_INVALID_INPUT;
+  memset(stream, 0, sizeof(mmwlStream_t));
+  strncpy(stream->ipAddr, ipAddr, sizeof(stream->ipAddr) - 1);
+  stream->port = port;
+  stream->sockFd = -1;
+
+  if (numSlots == 0) numSlots = MMWL_STREAM_DEFAULT_SLOTS;
+  while (slots < numSlots) slots <<= 1;
+  stream->numSlots = slots;
+  stream->slotSize = (frameSize + MMWL_STREAM_SLOT_ALIGN - 1) & ~(MMWL_STREAM_SLOT_ALIGN - 1);
+
+  stream->memorySize = (size_t)stream->slotSize * stream->numSlots;
+  stream->memorySize = (stream->memorySize + MMWL_STREAM_HUGE_PAGE_SIZE - 1) &
+    ~((size_t)MMWL_STREAM_HUGE_PAGE_SIZE - 1);
+
+  /* Reserved huge pages first, transparent huge pages otherwise */
+  stream->memory = mmap(NULL, stream->memorySize, PROT_READ | PROT_WRITE,
+    MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB | MAP_POPULATE, -1, 0);
+  stream->hugePages = (stream->memory != MAP_FAILED);
+  if (stream->memory == MAP_FAILED) {
+    stream->memory = mmap(NULL, stream->memorySize, PROT_READ | PROT_WRITE,
+      MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (stream->memory == MAP_FAILED) return RL_RET_CODE_MALLOC_ERROR;
+    madvise(stream->memory, stream->memorySize, MADV_HUGEPAGE);
+    memset(stream->memory, 0, stream->memorySize);   /* Fault the pages in now */
+  }
+
+  stream->slots = calloc(stream->numSlots, sizeof(mmwlStreamSlot_t));
+  if (stream->slots == NULL) {
+    munmap(stream->memory, stream->memorySize);
+    return RL_RET_CODE_MALLOC_ERROR;
+  }
+  for (uint32_t i = 0; i < stream->numSlots; i++) {
+    stream->slots[i].data = stream->memory + (size_t)i * stream->slotSize;
+  }
+
+  atomic_store(&stream->running, 1U);
+  if (pthread_create(&stream->thread, NULL, MMWL_streamReceiver, stream) != 0) {
+    free(stream->slots);
+    munmap(stream->memory, stream->memorySize);
+    return RL_RET_CODE_MALLOC_ERROR;
+  }
+  return RL_RET_CODE_OK;
+}
+
+/** @fn void MMWL_streamClose(mmwlStream_t *stream)
+*
+*   @brief Stop receiving and release the ring
+*
+*   The consumers must be done with the stream.
+*
+*   @param[in] stream - Stream
+*/
+void MMWL_streamClose(mmwlStream_t *stream) {
+  int fd;
+
+  if ((stream == NULL) || (stream->slots == NULL)) return;
+  atomic_store(&stream->running, 0U);
+  fd = stream->sockFd;
+  if (fd >= 0) shutdown(fd, SHUT_RDWR);
+  pthread_join(stream->thread, NULL);
+
+  free(stream->slots);
+  stream->slots = NULL;
+  munmap(stream->memory, stream->memorySize);
+  stream->memory = NULL;
+}
+
+/** @fn void MMWL_streamReaderInit(mmwlStream_t *stream, mmwlStreamReader_t *reader)
+*
+*   @brief Attach a consumer, starting from the next frame received
+*
+*   @param[in] stream - Stream
+*   @param[out] reader - Consumer
+*/
+void MMWL_streamReaderInit(mmwlStream_t *stream, mmwlStreamReader_t *reader) {
+  reader->stream = stream;
+  reader->next = atomic_load_explicit(&stream->head, memory_order_acquire);
+  reader->current = 0;
+  reader->missed = 0;
+}
+
+/** @fn const mmwlStreamSlot_t* MMWL_streamNext(mmwlStreamReader_t *reader, uint32_t timeoutMs)
+*
+*   @brief Next frame of a consumer
+*
+*   The frame is not copied: its data must be used, then released with
+*   MMWL_streamRelease, before the receiver wraps around the ring. A reader
+*   that fell behind skips to the oldest frame still in the ring.
+*
+*   @param[in] reader - Consumer
+*   @param[in] timeoutMs - Maximum wait for a new frame (0: do not wait)
+*
+*   @return const mmwlStreamSlot_t* Frame, NULL on timeout
+*/
+const mmwlStreamSlot_t* MMWL_streamNext(mmwlStreamReader_t *reader, uint32_t timeoutMs) {
+  mmwlStream_t *stream = reader->stream;
+  const uint32_t numSlots = stream->numSlots;
+  struct timespec now, deadline, wait;
+  mmwlStreamSlot_t *slot;
+  uint32_t published;
+  uint64_t head, state;
+
+  clock_gettime(CLOCK_MONOTONIC, &deadline);
+  deadline.tv_sec += timeoutMs / 1000;
+  deadline.tv_nsec += (timeoutMs % 1000) * 1000000L;
+  if (deadline.tv_nsec >= 1000000000L) {
+    deadline.tv_sec++;
+    deadline.tv_nsec -= 1000000000L;
+  }
+
+  for (;;) {
+    published = atomic_load_explicit(&stream->published, memory_order_acquire);
+    head = atomic_load_explicit(&stream->head, memory_order_acquire);
+
+    /* Skip the frames overwritten (or being overwritten) by the receiver */
+    if ((head >= numSlots) && (reader->next < head - numSlots + 1)) {
+      reader->missed += (head - numSlots + 1) - reader->next;
+      reader->next = head - numSlots + 1;
+    }
+
+    if (reader->next < head) {
+      slot = &stream->slots[reader->next & (numSlots - 1)];
+      state = atomic_load_explicit(&slot->state, memory_order_acquire);
+      if (state == ((reader->next + 1) << 1)) {
+        reader->current = reader->next++;
+        return slot;
+      }
+      continue;   /* Overwritten in the meantime */
+    }
+
+    if (timeoutMs == 0) return NULL;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    if ((now.tv_sec > deadline.tv_sec) ||
+        ((now.tv_sec == deadline.tv_sec) && (now.tv_nsec >= deadline.tv_nsec))) {
+      return NULL;
+    }
+    wait.tv_sec = deadline.tv_sec - now.tv_sec;
+    wait.tv_nsec = deadline.tv_nsec - now.tv_nsec;
+    if (wait.tv_nsec < 0) {
+      wait.tv_sec--;
+      wait.tv_nsec += 1000000000L;
+    }
+
+    atomic_fetch_add(&stream->waiters, 1U);
+    syscall(SYS_futex, &stream->published, FUTEX_WAIT_PRIVATE, published, &wait, NULL, 0);
+    atomic_fetch_sub(&stream->waiters, 1U);
+  }
+}
+
+/** @fn int MMWL_streamRelease(mmwlStreamReader_t *reader)
+*
+*   @brief Release the frame returned by MMWL_streamNext
+*
+*   @param[in] reader - Consumer
+*
+*   @return int 0 if the frame data stayed intact while in use, -1 if the
+*     receiver overwrote it (the data read must be discarded)
+*/
+int MMWL_streamRelease(mmwlStreamReader_t *reader) {
+  mmwlStreamSlot_t *slot = &reader->stream->slots[reader->current & (reader->stream->numSlots - 1)];
+
+  atomic_thread_fence(memory_order_acquire);
+  if (atomic_load_explicit(&slot->state, memory_order_relaxed) == ((reader->current + 1) << 1)) {
+    return 0;
+  }
+  reader->missed++;
+  return -1;
+}
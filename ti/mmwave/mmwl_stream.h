@@ -0,0 +1,166 @@
+/**
+ * @file mmwl_stream.h
+ * @brief Live ADC stream receiver
+ * @version 0.1
+ * @date 2026-10-14
+ *
+ * @copyright Copyright (c) 2026
+ *
+ * Raw ADC frames pushed by the DSP board over a dedicated TCP data socket
+ * are received straight into the slots of a preallocated ring (hugepage
+ * backed when available), without any intermediate copy. The ring is
+ * written by a single receiver thread and read by any number of consumers
+ * without locks: a consumer that falls behind by more than the ring size
+ * skips the frames overwritten in the meantime.
+ *
+ * Wire format, repeated for each frame (little endian):
+ *
+ *    | magic (u32) | sequence (u32) | length (u32) | deviceMap (u32) | data |
+ *
+ * where data holds the ADC samples of the devices in `deviceMap`, device
+ * after device, as laid out by the TDA (see MMWL_getFrameSize).
+ */
+#ifndef MMWL_STREAM_H
+#define MMWL_STREAM_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <pthread.h>
+#include <stdatomic.h>
+
+/* Frame header identification ("MMWF") */
+#define MMWL_STREAM_MAGIC                           (0x46574D4DU)
+
+/* Default data socket port of the DSP board */
+#define MMWL_STREAM_DEFAULT_PORT                    (5002U)
+
+/* Default number of frames in the ring (power of 2) */
+#define MMWL_STREAM_DEFAULT_SLOTS                   (64U)
+
+/* Delay between two connection attempts (ms) */
+#define MMWL_STREAM_RECONNECT_DELAY                 (1000U)
+
+/* Socket receive buffer size */
+#define MMWL_STREAM_SOCKET_BUFFER_SIZE              (8U * 1024U * 1024U)
+
+
+/*! \brief
+ * Frame header on the wire
+ */
+typedef struct mmwlStreamHeader {
+  uint32_t magic;
+  uint32_t sequence;
+  uint32_t length;
+  uint32_t deviceMap;
+} mmwlStreamHeader_t;
+
+/*! \brief
+ * Ring slot
+ */
+typedef struct mmwlStreamSlot {
+  /* (ring sequence << 1) once published, odd while being written */
+  _Atomic uint64_t state;
+
+  /* Frame sequence number set by the DSP board */
+  uint32_t sequence;
+
+  /* Number of data bytes */
+  uint32_t length;
+
+  /* Devices the frame holds */
+  uint32_t deviceMap;
+
+  /* CLOCK_REALTIME time the frame was received (ns) */
+  uint64_t timestamp;
+
+  /* Frame data */
+  uint8_t *data;
+} mmwlStreamSlot_t;
+
+/*! \brief
+ * Stream statistics
+ */
+typedef struct mmwlStreamStats {
+  /* Frames received */
+  uint64_t frames;
+
+  /* Bytes received */
+  uint64_t bytes;
+
+  /* Frames larger than a slot, discarded */
+  uint64_t oversized;
+
+  /* Gaps in the sequence numbers set by the DSP board */
+  uint64_t lost;
+
+  /* Number of (re)connections */
+  uint32_t connections;
+} mmwlStreamStats_t;
+
+/*! \brief
+ * Live ADC stream
+ */
+typedef struct mmwlStream {
+  char ipAddr[32];
+  uint16_t port;
+
+  /* Ring memory */
+  uint8_t *memory;
+  size_t memorySize;
+  uint8_t hugePages;
+
+  /* Ring slots */
+  mmwlStreamSlot_t *slots;
+  uint32_t numSlots;
+  uint32_t slotSize;
+
+  /* Ring sequence of the next frame to write */
+  _Atomic uint64_t head;
+
+  /* Futex word incremented for each published frame */
+  _Atomic uint32_t published;
+  _Atomic uint32_t waiters;
+
+  /* Receiver thread */
+  pthread_t thread;
+  _Atomic uint8_t running;
+  _Atomic uint8_t connected;
+  int sockFd;
+
+  mmwlStreamStats_t stats;
+} mmwlStream_t;
+
+/*! \brief
+ * Stream consumer
+ */
+typedef struct mmwlStreamReader {
+  mmwlStream_t *stream;
+
+  /* Ring sequence of the next frame to read */
+  uint64_t next;
+
+  /* Ring sequence of the frame being read */
+  uint64_t current;
+
+  /* Frames overwritten before this reader got to them */
+  uint64_t missed;
+} mmwlStreamReader_t;
+
+
+/* Allocate the ring and start receiving frames */
+int MMWL_streamOpen(mmwlStream_t *stream, const char *ipAddr, uint16_t port,
+                    uint32_t frameSize, uint32_t numSlots);
+
+/* Stop receiving and release the ring */
+void MMWL_streamClose(mmwlStream_t *stream);
+
+/* Attach a consumer, starting from the next frame received */
+void MMWL_streamReaderInit(mmwlStream_t *stream, mmwlStreamReader_t *reader);
+
+/* Next frame of a consumer (zero-copy) */
+const mmwlStreamSlot_t* MMWL_streamNext(mmwlStreamReader_t *reader, uint32_t timeoutMs);
+
+/* Release the frame returned by MMWL_streamNext */
+int MMWL_streamRelease(mmwlStreamReader_t *reader);
+
+#endif
@@ -37,6 +37,9 @@
  * @date: 07-19-2022
 */
 
+/* Replaced by rls_osi_linux.c when built with MMWL_OSI_LINUX (make OSI=linux) */
+#ifndef MMWL_OSI_LINUX
+
 #include "rls_osi.h"
 #include <stdio.h>
 #include <stdlib.h>
@@ -109,6 +112,19 @@ int osiSyncObjDelete(osiSyncObj_t* pSyncObj) {
 }
 
 
+/* Absolute CLOCK_REALTIME deadline in Timeout ms. tv_nsec must stay below 1 s:
+   the timed waits fail with EINVAL instead of blocking otherwise. */
+static void osiDeadline(struct timespec* ts, osiTime_t Timeout) {
+  clock_gettime(CLOCK_REALTIME, ts);
+  ts->tv_sec += (Timeout / 1000);
+  ts->tv_nsec += (Timeout % 1000) * 1000000;
+  if (ts->tv_nsec >= 1000000000L) {
+    ts->tv_sec++;
+    ts->tv_nsec -= 1000000000L;
+  }
+}
+
+
 int osiSyncObjSignal(osiSyncObj_t* pSyncObj) {
   if ((pSyncObj == NULL) || (*pSyncObj == NULL)) {
     return OSI_INVALID_PARAMS;
@@ -127,9 +143,7 @@ int osiSyncObjWait(osiSyncObj_t* pSyncObj , osiTime_t Timeout) {
   }
 
   struct timespec ts;
-  clock_gettime(CLOCK_REALTIME, &ts);
-  ts.tv_sec += (Timeout / 1000);
-  ts.tv_nsec += (Timeout % 1000) * 1000000;
+  osiDeadline(&ts, Timeout);
 
   RetVal = sem_timedwait(*pSyncObj, &ts);
   if (RetVal == 0) return OSI_OK;
@@ -208,9 +222,7 @@ int osiLockObjLock(osiLockObj_t* pLockObj , osiTime_t Timeout) {
   }
 
   struct timespec ts;
-  clock_gettime(CLOCK_REALTIME, &ts);
-  ts.tv_sec += (Timeout / 1000);
-  ts.tv_nsec += (Timeout % 1000) * 1000000;
+  osiDeadline(&ts, Timeout);
 
   RetVal = pthread_mutex_timedlock(*pLockObj, &ts);
 
@@ -293,3 +305,5 @@ unsigned long osiGetTime(void) {
   clocktick += ts.tv_sec * 1000;
   return clocktick;
 }
+
+#endif
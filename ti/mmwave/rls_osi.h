@@ -106,7 +106,11 @@ typedef unsigned int osiTime_t;
 
     \note On each porting or platform the type could be whatever is needed - integer, structure etc.
 */
+#ifdef MMWL_OSI_LINUX
+typedef struct osiSem* osiSyncObj_t;
+#else
 typedef sem_t* osiSyncObj_t;
+#endif
 
 /*!
     \brief type definition for a locking object container
@@ -117,7 +121,11 @@ typedef sem_t* osiSyncObj_t;
 
     \note On each porting or platform the type could be whatever is needed - integer, structure etc.
 */
+#ifdef MMWL_OSI_LINUX
+typedef struct osiMutex* osiLockObj_t;
+#else
 typedef pthread_mutex_t* osiLockObj_t;
+#endif
 
 /*!
     \brief type definition for a spawn entry callback
@@ -346,6 +354,21 @@ EXPORT  int osiExecute(rlsSpawnEntryFunc_t pEntry , const void* pValue , unsigne
 EXPORT unsigned long osiGetTime(void);
 
 
+/** @fn int osiThreadTune(pthread_t thread)
+*
+*   @brief This function pins a driver thread (MMWL_OSI_CPUS) and schedules it
+                    with SCHED_FIFO (MMWL_OSI_PRIORITY). No-op with rls_osi.c.
+*   @param[in] thread - thread to tune
+*
+*   @return int Success - 0, Failure - Error Code
+*/
+#ifdef MMWL_OSI_LINUX
+EXPORT int osiThreadTune(pthread_t thread);
+#else
+#define osiThreadTune(thread) (OSI_OK)
+#endif
+
+
 #ifdef  __cplusplus
 }
 #endif
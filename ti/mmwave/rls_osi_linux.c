@@ -0,0 +1,443 @@
+/**
+ * @file rls_osi_linux.c
+ * @brief mmWaveLink OS interface native to Linux (make OSI=linux)
+ * @version 0.1
+ * @date 2026-10-14
+ *
+ * @copyright Copyright (c) 2026
+ *
+ * Same interface as rls_osi.c, without any allocation or system call on the
+ * uncontended paths:
+ *  - the sync and lock objects are futexes taken from static pools,
+ *  - the timeouts are CLOCK_MONOTONIC deadlines, immune to time steps,
+ *  - the spawned contexts run on a pool of threads fed by a lock-free queue
+ *    instead of a new thread (and a 1 ms sleep) per call,
+ *  - the driver threads can be pinned (MMWL_OSI_CPUS) and scheduled with
+ *    SCHED_FIFO (MMWL_OSI_PRIORITY) so the scheduling jitter stays out of
+ *    the response latency of the devices.
+ */
+
+#ifdef MMWL_OSI_LINUX
+
+#define _GNU_SOURCE
+#include "rls_osi.h"
+#include <stdio.h>
+#include <string.h>
+#include <errno.h>
+#include <sched.h>
+#include <unistd.h>
+#include <stdatomic.h>
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include "../ethernet/src/mtime.h"
+
+/* One command semaphore and one device mutex per device, plus the global
+   lock of the driver */
+#define OSI_MAX_SYNC_OBJ      (16U)
+#define OSI_MAX_LOCK_OBJ      (16U)
+
+/* Spawn contexts (power of two) and the threads running them */
+#define OSI_EXEC_QUEUE_SIZE   (64U)
+#define OSI_EXEC_THREADS      (4U)
+
+/* CPU mask of the driver threads (0: no pinning) */
+#ifndef MMWL_OSI_CPUS
+#define MMWL_OSI_CPUS         (0)
+#endif
+
+/* SCHED_FIFO priority of the driver threads (0: default policy) */
+#ifndef MMWL_OSI_PRIORITY
+#define MMWL_OSI_PRIORITY     (0)
+#endif
+
+/* Counting semaphore: waiters sleep on the count while it is 0 */
+struct osiSem {
+  atomic_int count;
+  atomic_int waiters;
+  atomic_int used;
+};
+
+/* Mutex: 0 unlocked, 1 locked, 2 locked with sleeping waiters */
+struct osiMutex {
+  atomic_int state;
+  atomic_int lockers;
+  atomic_int used;
+};
+
+typedef struct osiTask {
+  atomic_uint seq;
+  rlsSpawnEntryFunc_t entry;
+  const void* param;
+} osiTask_t;
+
+static struct osiSem osi_sems[OSI_MAX_SYNC_OBJ];
+static struct osiMutex osi_mutexes[OSI_MAX_LOCK_OBJ];
+static struct osiMutex* rls_pGlobalLock = NULL;
+
+static struct {
+  osiTask_t tasks[OSI_EXEC_QUEUE_SIZE];
+  atomic_uint head;
+  atomic_uint tail;
+  struct osiSem pending;
+  pthread_t threads[OSI_EXEC_THREADS];
+} osi_exec;
+static pthread_once_t osi_execOnce = PTHREAD_ONCE_INIT;
+static int osi_execStatus = OSI_OK;
+
+
+static long osiFutex(atomic_int* addr, int op, int val, const struct timespec* deadline) {
+  return syscall(SYS_futex, addr, op | FUTEX_PRIVATE_FLAG, val, deadline, NULL,
+                 FUTEX_BITSET_MATCH_ANY);
+}
+
+
+/* Absolute CLOCK_MONOTONIC deadline in Timeout ms, as expected by
+   FUTEX_WAIT_BITSET */
+static void osiDeadline(struct timespec* ts, osiTime_t Timeout) {
+  clock_gettime(CLOCK_MONOTONIC, ts);
+  ts->tv_sec += (Timeout / 1000);
+  ts->tv_nsec += (Timeout % 1000) * 1000000;
+  if (ts->tv_nsec >= 1000000000L) {
+    ts->tv_sec++;
+    ts->tv_nsec -= 1000000000L;
+  }
+}
+
+
+/* Sleep on addr while it holds val, until the deadline (NULL: forever) */
+static int osiFutexWait(atomic_int* addr, int val, const struct timespec* deadline) {
+  if (osiFutex(addr, FUTEX_WAIT_BITSET, val, deadline) == 0) return OSI_OK;
+  if (errno == ETIMEDOUT) return OSI_TIMEOUT;
+  if ((errno == EAGAIN) || (errno == EINTR)) return OSI_OK;
+  return OSI_OPERATION_FAILED;
+}
+
+
+/**
+ * @brief Delay function
+ *
+ * @param duration Duration of the delay in millisecond
+ * @return int Return 0 to notify successful completion
+ */
+int osiSleep(uint32_t duration) {
+  msleep(duration);
+  return OSI_OK;
+}
+
+/*******************************************************************************
+
+  SYNC OBJECT
+
+********************************************************************************/
+
+static void semInit(struct osiSem* sem) {
+  atomic_store(&sem->count, 0);
+  atomic_store(&sem->waiters, 0);
+}
+
+
+static int semSignal(struct osiSem* sem) {
+  atomic_fetch_add_explicit(&sem->count, 1, memory_order_release);
+  if (atomic_load(&sem->waiters) > 0) osiFutex(&sem->count, FUTEX_WAKE, 1, NULL);
+  return OSI_OK;
+}
+
+
+static int semWait(struct osiSem* sem, osiTime_t Timeout) {
+  struct timespec ts;
+  int status = OSI_OK;
+
+  if ((Timeout != OSI_WAIT_FOREVER) && (Timeout != OSI_NO_WAIT)) osiDeadline(&ts, Timeout);
+  for (;;) {
+    int count = atomic_load_explicit(&sem->count, memory_order_acquire);
+    while (count > 0) {
+      if (atomic_compare_exchange_weak_explicit(&sem->count, &count, count - 1,
+                                                memory_order_acquire, memory_order_relaxed)) {
+        return OSI_OK;
+      }
+    }
+    if (Timeout == OSI_NO_WAIT) return OSI_TIMEOUT;
+    if (status != OSI_OK) return status;
+
+    atomic_fetch_add(&sem->waiters, 1);
+    status = osiFutexWait(&sem->count, 0, (Timeout == OSI_WAIT_FOREVER) ? NULL : &ts);
+    atomic_fetch_sub(&sem->waiters, 1);
+  }
+}
+
+
+int osiSyncObjCreate(osiSyncObj_t* pSyncObj, char* pName) {
+  if (pSyncObj == NULL) {
+    return OSI_INVALID_PARAMS;
+  }
+
+  for (unsigned int i = 0; i < OSI_MAX_SYNC_OBJ; i++) {
+    if (atomic_exchange(&osi_sems[i].used, 1) == 0) {
+      semInit(&osi_sems[i]);
+      *pSyncObj = &osi_sems[i];
+      return OSI_OK;
+    }
+  }
+  return OSI_MEMORY_ALLOCATION_FAILURE;
+}
+
+
+int osiSyncObjDelete(osiSyncObj_t* pSyncObj) {
+  if ((pSyncObj == NULL) || (*pSyncObj == NULL)) {
+    return OSI_INVALID_PARAMS;
+  }
+  atomic_store(&(*pSyncObj)->used, 0);
+  return OSI_OK;
+}
+
+
+int osiSyncObjSignal(osiSyncObj_t* pSyncObj) {
+  if ((pSyncObj == NULL) || (*pSyncObj == NULL)) {
+    return OSI_INVALID_PARAMS;
+  }
+  return semSignal(*pSyncObj);
+}
+
+
+int osiSyncObjWait(osiSyncObj_t* pSyncObj , osiTime_t Timeout) {
+  if ((pSyncObj == NULL) || (*pSyncObj == NULL)) {
+    return OSI_INVALID_PARAMS;
+  }
+  return semWait(*pSyncObj, Timeout);
+}
+
+
+/*******************************************************************************
+
+    LOCKING OBJECT
+
+********************************************************************************/
+
+int osiLockObjCreate(osiLockObj_t* pLockObj, char* pName) {
+  if (NULL == pLockObj) {
+    return OSI_INVALID_PARAMS;
+  }
+
+  for (unsigned int i = 0; i < OSI_MAX_LOCK_OBJ; i++) {
+    struct osiMutex* mutex = &osi_mutexes[i];
+
+    if (atomic_exchange(&mutex->used, 1) == 0) {
+      atomic_store(&mutex->state, 0);
+      atomic_store(&mutex->lockers, 0);
+      /* save reference to the global lock */
+      if ((pName != NULL) && (strcmp(pName, "GlobalLockObj") == 0)) rls_pGlobalLock = mutex;
+      *pLockObj = mutex;
+      return OSI_OK;
+    }
+  }
+  return OSI_MEMORY_ALLOCATION_FAILURE;
+}
+
+
+int osiLockObjDelete(osiLockObj_t* pLockObj) {
+  if ((pLockObj == NULL) || (*pLockObj == NULL)) {
+    return OSI_INVALID_PARAMS;
+  }
+
+  /* if we are going to delete the "GlobalLock" then wait till all threads
+  waiting on this mutex are released */
+  if (rls_pGlobalLock == *pLockObj) {
+    while (atomic_load(&(*pLockObj)->lockers) > 0) msleep(1);
+    rls_pGlobalLock = NULL;
+  }
+  atomic_store(&(*pLockObj)->used, 0);
+  return OSI_OK;
+}
+
+
+int osiLockObjLock(osiLockObj_t* pLockObj , osiTime_t Timeout) {
+  struct osiMutex* mutex;
+  struct timespec ts;
+  int state = 0;
+  int status = OSI_OK;
+
+  if ((pLockObj == NULL) || (*pLockObj == NULL)) {
+    return OSI_INVALID_PARAMS;
+  }
+  mutex = *pLockObj;
+
+  if (atomic_compare_exchange_strong_explicit(&mutex->state, &state, 1,
+                                              memory_order_acquire, memory_order_relaxed)) {
+    return OSI_OK;
+  }
+  if (Timeout == OSI_NO_WAIT) return OSI_TIMEOUT;
+
+  atomic_fetch_add(&mutex->lockers, 1);
+  if (Timeout != OSI_WAIT_FOREVER) osiDeadline(&ts, Timeout);
+  if (state != 2) state = atomic_exchange_explicit(&mutex->state, 2, memory_order_acquire);
+  while ((state != 0) && (status == OSI_OK)) {
+    status = osiFutexWait(&mutex->state, 2, (Timeout == OSI_WAIT_FOREVER) ? NULL : &ts);
+    state = atomic_exchange_explicit(&mutex->state, 2, memory_order_acquire);
+  }
+  atomic_fetch_sub(&mutex->lockers, 1);
+
+  /* Acquired by the last exchange even if the deadline has just passed */
+  return (state == 0) ? OSI_OK : status;
+}
+
+
+int osiLockObjUnlock(osiLockObj_t* pLockObj) {
+  struct osiMutex* mutex;
+
+  if ((pLockObj == NULL) || (*pLockObj == NULL)) {
+    return OSI_INVALID_PARAMS;
+  }
+  mutex = *pLockObj;
+
+  if (atomic_fetch_sub_explicit(&mutex->state, 1, memory_order_release) != 1) {
+    atomic_store_explicit(&mutex->state, 0, memory_order_release);
+    osiFutex(&mutex->state, FUTEX_WAKE, 1, NULL);
+  }
+  return OSI_OK;
+}
+
+
+/*******************************************************************************
+
+    SPWAN and CONTEXTS
+
+********************************************************************************/
+
+/**
+ * @brief Pin a driver thread and raise its priority
+ *
+ * Both are best effort: without CAP_SYS_NICE the thread keeps the default
+ * policy, and a warning is printed once.
+ *
+ * @param thread Thread to tune
+ * @return int OSI_OK, OSI_OPERATION_FAILED if any setting was refused
+ */
+int osiThreadTune(pthread_t thread) {
+  static atomic_int warned = 0;
+  int status = 0;
+
+  if (MMWL_OSI_CPUS != 0) {
+    cpu_set_t cpus;
+
+    CPU_ZERO(&cpus);
+    for (int cpu = 0; cpu < 64; cpu++) {
+      if (((unsigned long long)(MMWL_OSI_CPUS) >> cpu) & 1ULL) CPU_SET(cpu, &cpus);
+    }
+    status |= pthread_setaffinity_np(thread, sizeof(cpus), &cpus);
+  }
+  if (MMWL_OSI_PRIORITY > 0) {
+    struct sched_param param = { .sched_priority = MMWL_OSI_PRIORITY };
+
+    status |= pthread_setschedparam(thread, SCHED_FIFO, &param);
+  }
+  if (status == 0) return OSI_OK;
+  if (atomic_exchange(&warned, 1) == 0) {
+    fprintf(stderr, "[OSI] Driver threads not pinned or not real time (%s)\n", strerror(status));
+  }
+  return OSI_OPERATION_FAILED;
+}
+
+
+/* Runs the spawned contexts in the order they were queued */
+static void* osiExecThread(void* arg) {
+  const unsigned int mask = OSI_EXEC_QUEUE_SIZE - 1;
+
+  for (;;) {
+    unsigned int pos;
+    osiTask_t* task;
+
+    semWait(&osi_exec.pending, OSI_WAIT_FOREVER);
+    pos = atomic_load_explicit(&osi_exec.tail, memory_order_relaxed);
+    for (;;) {
+      task = &osi_exec.tasks[pos & mask];
+      int diff = (int)(atomic_load_explicit(&task->seq, memory_order_acquire) - (pos + 1));
+
+      if (diff == 0) {
+        if (atomic_compare_exchange_weak_explicit(&osi_exec.tail, &pos, pos + 1,
+                                                  memory_order_relaxed, memory_order_relaxed)) {
+          break;
+        }
+      } else {
+        /* Slot still being written by its producer */
+        if (diff < 0) sched_yield();
+        pos = atomic_load_explicit(&osi_exec.tail, memory_order_relaxed);
+      }
+    }
+
+    rlsSpawnEntryFunc_t entry = task->entry;
+    const void* param = task->param;
+    atomic_store_explicit(&task->seq, pos + OSI_EXEC_QUEUE_SIZE, memory_order_release);
+    entry(param);
+  }
+  return NULL;
+}
+
+
+static void osiExecStart(void) {
+  for (unsigned int i = 0; i < OSI_EXEC_QUEUE_SIZE; i++) {
+    atomic_init(&osi_exec.tasks[i].seq, i);
+  }
+  atomic_init(&osi_exec.head, 0U);
+  atomic_init(&osi_exec.tail, 0U);
+  semInit(&osi_exec.pending);
+
+  for (unsigned int i = 0; i < OSI_EXEC_THREADS; i++) {
+    if (pthread_create(&osi_exec.threads[i], NULL, osiExecThread, NULL) != 0) {
+      osi_execStatus = OSI_OPERATION_FAILED;
+      return;
+    }
+    pthread_detach(osi_exec.threads[i]);
+    osiThreadTune(osi_exec.threads[i]);
+  }
+}
+
+
+int osiSpawn(rlsSpawnEntryFunc_t pEntry , const void* pValue , unsigned int flags) {
+  pEntry(pValue);
+  return 0;
+}
+
+
+int osiExecute(rlsSpawnEntryFunc_t pEntry , const void* pValue , unsigned int flags) {
+  const unsigned int mask = OSI_EXEC_QUEUE_SIZE - 1;
+  unsigned int pos;
+  osiTask_t* task;
+
+  pthread_once(&osi_execOnce, osiExecStart);
+  if (osi_execStatus != OSI_OK) return osi_execStatus;
+
+  pos = atomic_load_explicit(&osi_exec.head, memory_order_relaxed);
+  for (;;) {
+    task = &osi_exec.tasks[pos & mask];
+    int diff = (int)(atomic_load_explicit(&task->seq, memory_order_acquire) - pos);
+
+    if (diff == 0) {
+      if (atomic_compare_exchange_weak_explicit(&osi_exec.head, &pos, pos + 1,
+                                                memory_order_relaxed, memory_order_relaxed)) {
+        break;
+      }
+    } else if (diff < 0) {
+      /* Queue full */
+      return OSI_OPERATION_FAILED;
+    } else {
+      pos = atomic_load_explicit(&osi_exec.head, memory_order_relaxed);
+    }
+  }
+
+  task->entry = pEntry;
+  task->param = pValue;
+  atomic_store_explicit(&task->seq, pos + 1, memory_order_release);
+  return semSignal(&osi_exec.pending);
+}
+
+
+unsigned long osiGetTime(void) {
+  struct timespec ts;
+  unsigned long clocktick = 0U;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  clocktick  = ts.tv_nsec / 1000000;
+  clocktick += ts.tv_sec * 1000;
+  return clocktick;
+}
+
+#endif
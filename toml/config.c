@@ -8,135 +8,314 @@
  * @copyright Copyright (c) 2022
  *
  */
+#include <stdint.h>
+#include <string.h>
+#include <pthread.h>
 #include "config.h"
 
 #define CONFIG_FIELD_ERROR_MSG "Error with config parameter "
+#define CONFIG_INVALID_MSG " Infeasible configuration: "
 
 
 /**
- * @brief Read MIMO related sections of the config file
+ * TOML parser arena
  *
- * @param configfile TOML Table parsed from the config file
- * @param config Device config
- * @return int
+ * The parser allocates from a static buffer, then from chunks when a file
+ * needs more. Nothing is released during the parsing: the whole arena is
+ * reset in one shot once the configuration has been read.
  */
-void read_mimo_config(toml_table_t* configfile, devConfig_t *config) {
-    if (configfile == NULL) return;
-    toml_table_t *mimo = toml_table_in(configfile, "mimo");
-    if (mimo != NULL) {
-        toml_datum_t data;
+typedef struct configArenaChunk {
+    struct configArenaChunk *next;
+    size_t size;
+    size_t used;
+    unsigned char data[];
+} configArenaChunk_t;
 
-        // [PROFILE CONFIGURATION]
-        toml_table_t *profile = toml_table_in(mimo, "profile");
-        if (profile != NULL) {
-            data = toml_int_in(profile, "id");
-            if (data.ok) {
-                config->profileCfg.profileId = (uint16_t)data.u.i;
-            } else {
-                DEBUG_PRINT(CONFIG_FIELD_ERROR_MSG "'id'\n");
-            }
+static unsigned char g_arena[CONFIG_ARENA_SIZE] __attribute__((aligned(16)));
+static size_t g_arena_used = 0;
+static configArenaChunk_t *g_arena_chunks = NULL;
+static pthread_mutex_t g_arena_lock = PTHREAD_MUTEX_INITIALIZER;
 
-            // Chirp start frequency in GHz
-            data = toml_double_in(profile, "startFrequency");
-            if (data.ok) {
-                config->profileCfg.startFreqConst = (uint32_t)ceil(
-                    // 1LSB = 53.644 Hz
-                    (data.u.d * 1e9) / 53.644);
-            } else {
-                DEBUG_PRINT(CONFIG_FIELD_ERROR_MSG "'startFrequency'\n");
-            }
 
-            // Frequency slope in MHz/us
-            data = toml_double_in(profile, "frequencySlope");
-            if (data.ok) {
-                config->profileCfg.freqSlopeConst = (uint16_t)ceil(
-                    // 1LSB = 48.279 kHz/us
-                    (data.u.d * 1e3) / 48.279);
-            } else {
-                DEBUG_PRINT(CONFIG_FIELD_ERROR_MSG "'frequencySlope'\n");
-            }
+/**
+ * @brief Allocate from the parser arena
+ *
+ * @param size Number of bytes
+ * @return void* 16-byte aligned block, NULL when out of memory
+ */
+static void *config_arena_alloc(size_t size) {
+    size = (size + 15) & ~(size_t)15;
+    if (g_arena_used + size <= sizeof(g_arena)) {
+        void *p = g_arena + g_arena_used;
+        g_arena_used += size;
+        return p;
+    }
+    if ((g_arena_chunks == NULL) || (g_arena_chunks->used + size > g_arena_chunks->size)) {
+        size_t chunk_size = (size > CONFIG_ARENA_SIZE) ? size : CONFIG_ARENA_SIZE;
+        configArenaChunk_t *chunk = malloc(sizeof(configArenaChunk_t) + chunk_size);
+        if (chunk == NULL) return NULL;
+        chunk->next = g_arena_chunks;
+        chunk->size = chunk_size;
+        chunk->used = 0;
+        g_arena_chunks = chunk;
+    }
+    void *p = g_arena_chunks->data + g_arena_chunks->used;
+    g_arena_chunks->used += size;
+    return p;
+}
 
-            // Chrip Idle time in us
-            data = toml_double_in(profile, "idleTime");
-            if (data.ok) {
-                config->profileCfg.idleTimeConst = (uint32_t)ceil(
-                    // 1LSB = 10ns
-                    (data.u.d * 1e2));
-            } else {
-                DEBUG_PRINT(CONFIG_FIELD_ERROR_MSG "'idleTime'\n");
-            }
+/**
+ * @brief Release a block of the parser arena: nothing to do, see config_arena_reset
+ *
+ * @param p Block
+ */
+static void config_arena_free(void *p) {
+    (void)p;
+}
 
-            // ADC start time in us
-            data = toml_double_in(profile, "adcStartTime");
-            if (data.ok) {
-                config->profileCfg.adcStartTimeConst = (uint32_t)ceil(
-                    // 1LSB = 10ns
-                    (data.u.d * 1e2));
-            } else {
-                DEBUG_PRINT(CONFIG_FIELD_ERROR_MSG "'adcStartTime'\n");
-            }
+/**
+ * @brief Release the whole parser arena
+ */
+static void config_arena_reset() {
+    while (g_arena_chunks != NULL) {
+        configArenaChunk_t *next = g_arena_chunks->next;
+        free(g_arena_chunks);
+        g_arena_chunks = next;
+    }
+    g_arena_used = 0;
+}
 
-            // Chirp ramp end time in us
-            data = toml_double_in(profile, "rampEndTime");
-            if (data.ok) {
-                config->profileCfg.rampEndTime = (uint32_t)ceil(
-                    // 1LSB = 10ns
-                    (data.u.d * 1e2));
-            } else {
-                DEBUG_PRINT(CONFIG_FIELD_ERROR_MSG "'rampEndTime'\n");
-            }
 
-            // TX starttime in us
-            data = toml_double_in(profile, "txStartTime");
-            if (data.ok) {
-                config->profileCfg.txStartTime = (uint16_t)ceil(
-                    // 1LSB = 10ns
-                    (data.u.d * 1e2));
-            } else {
-                DEBUG_PRINT(CONFIG_FIELD_ERROR_MSG "'txStartTime'\n");
-            }
+/**
+ * @brief FNV-1a hash
+ *
+ * @param data Bytes to hash
+ * @param size Number of bytes
+ * @return uint32_t Hash
+ */
+static uint32_t config_hash(const void *data, size_t size) {
+    const unsigned char *bytes = (const unsigned char *)data;
+    uint32_t hash = 2166136261U;
+    for (size_t i = 0; i < size; i++) {
+        hash = (hash ^ bytes[i]) * 16777619U;
+    }
+    return hash;
+}
 
-            // Number of ADC samples per chirp
-            data = toml_int_in(profile, "numAdcSamples");
-            if (data.ok) {
-                config->profileCfg.numAdcSamples = (uint16_t)data.u.i;
-            } else {
-                DEBUG_PRINT(CONFIG_FIELD_ERROR_MSG "'numAdcSamples'\n");
-            }
 
-            // ADC sampling frequency in ksps
-            data = toml_int_in(profile, "adcSamplingFrequency");
-            if (data.ok) {
-                config->profileCfg.digOutSampleRate = (uint16_t)data.u.i;
-            } else {
-                DEBUG_PRINT(CONFIG_FIELD_ERROR_MSG "'adcSamplingFrequency'\n");
-            }
+/**
+ * @brief Read a profile configuration
+ *
+ * @param table [mimo.profile] table, or the profile table of a sub-frame
+ * @param profileCfg Profile to update, the missing keys are left unchanged
+ * @param required Report the missing keys
+ */
+static void read_profile_config(toml_table_t *table, rlProfileCfg_t *profileCfg, uint8_t required) {
+    toml_datum_t data;
 
-            // rxGain in dB
-            data = toml_int_in(profile, "rxGain");
-            if (data.ok) {
-                config->profileCfg.rxGain = (uint16_t)data.u.i;
-            } else {
-                DEBUG_PRINT(CONFIG_FIELD_ERROR_MSG "'rxGain'\n");
-            }
+    data = toml_int_in(table, "id");
+    if (data.ok) {
+        profileCfg->profileId = (uint16_t)data.u.i;
+    } else if (required) {
+        DEBUG_PRINT(CONFIG_FIELD_ERROR_MSG "'id'\n");
+    }
 
-            // hpfCornerFreq1
-            data = toml_int_in(profile, "hpfCornerFreq1");
-            if (data.ok) {
-                config->profileCfg.hpfCornerFreq1 = (uint8_t)data.u.i;
-            } else {
-                DEBUG_PRINT(CONFIG_FIELD_ERROR_MSG "'hpfCornerFreq1'\n");
-            }
+    // Chirp start frequency in GHz
+    data = toml_double_in(table, "startFrequency");
+    if (data.ok) {
+        profileCfg->startFreqConst = (uint32_t)ceil(
+            // 1LSB = 53.644 Hz
+            (data.u.d * 1e9) / 53.644);
+    } else if (required) {
+        DEBUG_PRINT(CONFIG_FIELD_ERROR_MSG "'startFrequency'\n");
+    }
 
-            // hpfCornerFreq2
-            data = toml_int_in(profile, "hpfCornerFreq2");
-            if (data.ok) {
-                config->profileCfg.hpfCornerFreq2 = (uint8_t)data.u.i;
-            } else {
-                DEBUG_PRINT(CONFIG_FIELD_ERROR_MSG "'hpfCornerFreq2'\n");
-            }
+    // Frequency slope in MHz/us
+    data = toml_double_in(table, "frequencySlope");
+    if (data.ok) {
+        profileCfg->freqSlopeConst = (uint16_t)ceil(
+            // 1LSB = 48.279 kHz/us
+            (data.u.d * 1e3) / 48.279);
+    } else if (required) {
+        DEBUG_PRINT(CONFIG_FIELD_ERROR_MSG "'frequencySlope'\n");
+    }
+
+    // Chrip Idle time in us
+    data = toml_double_in(table, "idleTime");
+    if (data.ok) {
+        profileCfg->idleTimeConst = (uint32_t)ceil(
+            // 1LSB = 10ns
+            (data.u.d * 1e2));
+    } else if (required) {
+        DEBUG_PRINT(CONFIG_FIELD_ERROR_MSG "'idleTime'\n");
+    }
+
+    // ADC start time in us
+    data = toml_double_in(table, "adcStartTime");
+    if (data.ok) {
+        profileCfg->adcStartTimeConst = (uint32_t)ceil(
+            // 1LSB = 10ns
+            (data.u.d * 1e2));
+    } else if (required) {
+        DEBUG_PRINT(CONFIG_FIELD_ERROR_MSG "'adcStartTime'\n");
+    }
+
+    // Chirp ramp end time in us
+    data = toml_double_in(table, "rampEndTime");
+    if (data.ok) {
+        profileCfg->rampEndTime = (uint32_t)ceil(
+            // 1LSB = 10ns
+            (data.u.d * 1e2));
+    } else if (required) {
+        DEBUG_PRINT(CONFIG_FIELD_ERROR_MSG "'rampEndTime'\n");
+    }
+
+    // TX starttime in us
+    data = toml_double_in(table, "txStartTime");
+    if (data.ok) {
+        profileCfg->txStartTime = (uint16_t)ceil(
+            // 1LSB = 10ns
+            (data.u.d * 1e2));
+    } else if (required) {
+        DEBUG_PRINT(CONFIG_FIELD_ERROR_MSG "'txStartTime'\n");
+    }
+
+    // Number of ADC samples per chirp
+    data = toml_int_in(table, "numAdcSamples");
+    if (data.ok) {
+        profileCfg->numAdcSamples = (uint16_t)data.u.i;
+    } else if (required) {
+        DEBUG_PRINT(CONFIG_FIELD_ERROR_MSG "'numAdcSamples'\n");
+    }
+
+    // ADC sampling frequency in ksps
+    data = toml_int_in(table, "adcSamplingFrequency");
+    if (data.ok) {
+        profileCfg->digOutSampleRate = (uint16_t)data.u.i;
+    } else if (required) {
+        DEBUG_PRINT(CONFIG_FIELD_ERROR_MSG "'adcSamplingFrequency'\n");
+    }
+
+    // rxGain in dB
+    data = toml_int_in(table, "rxGain");
+    if (data.ok) {
+        profileCfg->rxGain = (uint16_t)data.u.i;
+    } else if (required) {
+        DEBUG_PRINT(CONFIG_FIELD_ERROR_MSG "'rxGain'\n");
+    }
+
+    // hpfCornerFreq1
+    data = toml_int_in(table, "hpfCornerFreq1");
+    if (data.ok) {
+        profileCfg->hpfCornerFreq1 = (uint8_t)data.u.i;
+    } else if (required) {
+        DEBUG_PRINT(CONFIG_FIELD_ERROR_MSG "'hpfCornerFreq1'\n");
+    }
+
+    // hpfCornerFreq2
+    data = toml_int_in(table, "hpfCornerFreq2");
+    if (data.ok) {
+        profileCfg->hpfCornerFreq2 = (uint8_t)data.u.i;
+    } else if (required) {
+        DEBUG_PRINT(CONFIG_FIELD_ERROR_MSG "'hpfCornerFreq2'\n");
+    }
+}
+
+/**
+ * @brief Read the sub-frames of an advanced frame ([[mimo.subframe]])
+ *
+ * Sub-frame `n` is a single burst of the MIMO chirps from index
+ * n * NUM_CHIRPS, with profile `n`: [mimo.profile] updated with the keys of
+ * its own profile table. A frame is made of all the sub-frames.
+ *
+ * @param subframes Array of the sub-frame tables
+ * @param config Device config
+ */
+static void read_subframe_config(toml_array_t *subframes, devConfig_t *config) {
+    rlAdvFrameSeqCfg_t *seq = &config->advFrameCfg.frameSeq;
+    rlAdvFrameDataCfg_t *frameData = &config->advFrameCfg.frameData;
+    // Blank time left at the end of each sub-frame (1LSB = 5ns)
+    const uint32_t gap = (uint32_t)(CONFIG_MIN_SUBFRAME_GAP * 200);
+    uint32_t period = 0;
+    int count = toml_array_nelem(subframes);
+
+    memset(&config->advFrameCfg, 0, sizeof(config->advFrameCfg));
+    memset(config->subProfileCfg, 0, sizeof(config->subProfileCfg));
+    if (count > (int)RL_MAX_SUBFRAMES) {
+        DEBUG_PRINT(CONFIG_FIELD_ERROR_MSG "'subframe' (%d sub-frames, only the first %u are used)\n",
+            count, RL_MAX_SUBFRAMES);
+        count = RL_MAX_SUBFRAMES;
+    }
+
+    for (int i = 0; i < count; i++) {
+        toml_table_t *subframe = toml_table_at(subframes, i);
+        rlSubFrameCfg_t *sf = &seq->subFrameCfg[i];
+        rlProfileCfg_t *profileCfg = &config->subProfileCfg[i];
+        toml_datum_t data;
+
+        if (subframe == NULL) {
+            count = i;
+            break;
         }
 
+        *profileCfg = config->profileCfg;
+        toml_table_t *profile = toml_table_in(subframe, "profile");
+        if (profile != NULL) read_profile_config(profile, profileCfg, 0);
+        profileCfg->profileId = (uint16_t)i;
+
+        // Number of chirp loops, [mimo.frame] by default
+        sf->numLoops = config->frameCfg.numLoops;
+        data = toml_int_in(subframe, "numLoops");
+        if (data.ok) sf->numLoops = (uint16_t)data.u.i;
+
+        // Sub-frame periodicity in ms
+        data = toml_double_in(subframe, "periodicity");
+        if (data.ok) {
+            sf->subFramePeriodicity = (uint32_t)ceil(
+                // 1LSB = 5ns
+                (data.u.d * 1e-3) / 5e-9);
+        } else {
+            DEBUG_PRINT(CONFIG_FIELD_ERROR_MSG "'periodicity'\n");
+        }
+
+        sf->forceProfileIdx = (uint16_t)i;
+        sf->chirpStartIdx = (uint16_t)(i * NUM_CHIRPS);
+        sf->numOfChirps = NUM_CHIRPS;
+        sf->numOfBurst = 1;
+        sf->numOfBurstLoops = 1;
+        sf->burstPeriodicity = (sf->subFramePeriodicity > gap) ? sf->subFramePeriodicity - gap : 0;
+        period += sf->subFramePeriodicity;
+
+        frameData->subframeDataCfg[i].totalChirps = NUM_CHIRPS * sf->numLoops;
+        frameData->subframeDataCfg[i].numAdcSamples = 2 * profileCfg->numAdcSamples;
+        frameData->subframeDataCfg[i].numChirpsInDataPacket = 1;
+    }
+
+    seq->numOfSubFrames = (uint8_t)count;
+    seq->forceProfile = 1;
+    seq->numFrames = config->frameCfg.numFrames;
+    frameData->numSubFrames = (uint8_t)count;
+    // The TDA and the monitors see a frame of all the sub-frames
+    if (count > 0) config->frameCfg.framePeriodicity = period;
+}
+
+/**
+ * @brief Read MIMO related sections of the config file
+ *
+ * @param configfile TOML Table parsed from the config file
+ * @param config Device config
+ * @return int
+ */
+void read_mimo_config(toml_table_t* configfile, devConfig_t *config) {
+    if (configfile == NULL) return;
+    toml_table_t *mimo = toml_table_in(configfile, "mimo");
+    if (mimo != NULL) {
+        toml_datum_t data;
+
+        // [PROFILE CONFIGURATION]
+        toml_table_t *profile = toml_table_in(mimo, "profile");
+        if (profile != NULL) read_profile_config(profile, &config->profileCfg, 1);
+
         // [FRAME CONFIGURATION]
         toml_table_t *frame = toml_table_in(mimo, "frame");
         if (frame != NULL) {
@@ -186,28 +365,311 @@ void read_mimo_config(toml_table_t* configfile, devConfig_t *config) {
                 DEBUG_PRINT(CONFIG_FIELD_ERROR_MSG "'txChannelEn'\n");
             }
         }
+
+        // [ADVANCED FRAME] (optional) sub-frames cycled by the devices in each frame
+        toml_array_t *subframes = toml_array_in(mimo, "subframe");
+        if (subframes != NULL) read_subframe_config(subframes, config);
+
+        // [RF HEALTH MONITORING] (optional, the defaults are kept for the missing keys)
+        toml_table_t *monitor = toml_table_in(mimo, "monitor");
+        if (monitor != NULL) {
+            // Monitors to enable: "temp", "rx-gain", "tx-power", "synth" or "all"
+            toml_array_t *monitors = toml_array_in(monitor, "enable");
+            if (monitors != NULL) {
+                config->monCfg.enable = 0;
+                for (int i = 0; i < toml_array_nelem(monitors); i++) {
+                    data = toml_string_at(monitors, i);
+                    if (!data.ok) continue;
+                    if (MMWL_monitorByName(data.u.s) == 0) {
+                        DEBUG_PRINT(CONFIG_FIELD_ERROR_MSG "'enable' (%s)\n", data.u.s);
+                    }
+                    // The string is released with the parser arena
+                    config->monCfg.enable |= MMWL_monitorByName(data.u.s);
+                }
+            }
+
+            data = toml_int_in(monitor, "reportMode");
+            if (data.ok) config->monCfg.reportMode = (uint8_t)data.u.i;
+
+            // Monitoring period in ms, rounded up to a number of frames
+            data = toml_double_in(monitor, "period");
+            if (data.ok && (config->frameCfg.framePeriodicity != 0)) {
+                config->monCfg.period = (uint16_t)ceil(
+                    // Frame periodicity: 1LSB = 5ns
+                    (data.u.d * 1e-3) / (config->frameCfg.framePeriodicity * 5e-9));
+            }
+
+            // Temperature range and spread between the sensors in C
+            data = toml_int_in(monitor, "tempMin");
+            if (data.ok) config->monCfg.tempMin = (int16_t)data.u.i;
+            data = toml_int_in(monitor, "tempMax");
+            if (data.ok) config->monCfg.tempMax = (int16_t)data.u.i;
+            data = toml_int_in(monitor, "tempDiff");
+            if (data.ok) config->monCfg.tempDiff = (uint16_t)data.u.i;
+
+            // Maximum RX gain and TX power errors in dB
+            data = toml_double_in(monitor, "rxGainErr");
+            if (data.ok) config->monCfg.rxGainErr = (uint16_t)ceil(data.u.d * 10);  // 1LSB = 0.1dB
+            data = toml_double_in(monitor, "txPowerErr");
+            if (data.ok) config->monCfg.txPowerErr = (uint16_t)ceil(data.u.d * 10); // 1LSB = 0.1dB
+
+            // Maximum synthesizer frequency error in MHz
+            data = toml_double_in(monitor, "synthFreqErr");
+            if (data.ok) config->monCfg.synthFreqErr = (uint16_t)ceil(data.u.d * 100); // 1LSB = 10kHz
+        }
         config->frameCfg.numAdcSamples = 2 * config->profileCfg.numAdcSamples;
         config->dataFmtCfg.rxChannelEn = config->channelCfg.rxChannelEn;
     }
 }
 
+/**
+ * @brief Load a compiled configuration
+ *
+ * @param fp Blob file, positioned after its header
+ * @param header Header of the blob
+ * @param config Device configuration structure
+ * @return int Status
+ */
+static int read_config_blob(FILE *fp, const configBlobHeader_t *header, devConfig_t *config) {
+    devConfig_t blob;
+
+    if ((header->version != CONFIG_BLOB_VERSION) ||
+        (header->headerSize != sizeof(configBlobHeader_t)) ||
+        (header->configSize != sizeof(devConfig_t))) {
+        printf(" Configuration blob compiled by another version of " PROG_NAME ", compile it again\n\n");
+        return -1;
+    }
+    if ((fread(&blob, sizeof(blob), 1, fp) != 1) ||
+        (config_hash(&blob, sizeof(blob)) != header->checksum)) {
+        printf(" Corrupted configuration blob\n\n");
+        return -1;
+    }
+    *config = blob;
+    return 0;
+}
+
 /**
  * @brief Read a configuration file and set the device
  *        configuration
  *
+ * The file is either a TOML file, parsed from the arena, or a blob written
+ * by write_config_blob, loaded as is.
+ *
  * @param filename Path to the config file
  * @param config Device configuration structure
  * @return int Status
  */
 int read_config(unsigned char *filename, devConfig_t *config) {
-    FILE *fp = fopen(filename, "r");
-    unsigned char err[200]; // Error buffer
+    FILE *fp = fopen((const char *)filename, "r");
+    char err[200]; // Error buffer
+    configBlobHeader_t header;
+    char *content;
+    long size;
+    int status = 0;
+
     if (fp == NULL) {
         DEBUG_PRINT(" Unable to read the configuration file '%s'\n\n", filename);
         exit(1);
     }
-    toml_table_t * configfile = toml_parse_file(fp, err, sizeof(err));
-    read_mimo_config(configfile, config);
-    toml_free(configfile);
+    if ((fread(&header, sizeof(header), 1, fp) == 1) && (header.magic == CONFIG_BLOB_MAGIC)) {
+        status = read_config_blob(fp, &header, config);
+        fclose(fp);
+        return status;
+    }
+
+    pthread_mutex_lock(&g_arena_lock);
+    toml_set_memutil(config_arena_alloc, config_arena_free);
+    fseek(fp, 0, SEEK_END);
+    size = ftell(fp);
+    fseek(fp, 0, SEEK_SET);
+    content = (size >= 0) ? config_arena_alloc(size + 1) : NULL;
+    if ((content == NULL) || (fread(content, 1, size, fp) != (size_t)size)) {
+        DEBUG_PRINT(" Unable to read the configuration file '%s'\n\n", filename);
+        status = -1;
+    } else {
+        content[size] = '\0';
+        toml_table_t * configfile = toml_parse(content, err, sizeof(err));
+        if (configfile == NULL) {
+            DEBUG_PRINT(" Invalid configuration file '%s': %s\n\n", filename, err);
+            status = -1;
+        }
+        read_mimo_config(configfile, config);
+    }
+    fclose(fp);
+    // The whole tree is released with the arena (no toml_free)
+    config_arena_reset();
+    toml_set_memutil(malloc, free);
+    pthread_mutex_unlock(&g_arena_lock);
+    return status;
+}
+
+/**
+ * @brief Compile a configuration into a blob
+ *
+ * The blob is only valid for the build of the program that wrote it: it is
+ * rejected by any other build where devConfig_t differs.
+ *
+ * @param filename Path of the blob
+ * @param config Device configuration structure
+ * @return int Status
+ */
+int write_config_blob(const unsigned char *filename, const devConfig_t *config) {
+    configBlobHeader_t header = {
+        .magic = CONFIG_BLOB_MAGIC,
+        .version = CONFIG_BLOB_VERSION,
+        .headerSize = sizeof(configBlobHeader_t),
+        .configSize = sizeof(devConfig_t),
+        .checksum = config_hash(config, sizeof(devConfig_t)),
+    };
+    FILE *fp = fopen((const char *)filename, "wb");
+    int status = 0;
+
+    if (fp == NULL) {
+        printf(" Unable to write the configuration blob '%s'\n\n", filename);
+        return -1;
+    }
+    if ((fwrite(&header, sizeof(header), 1, fp) != 1) ||
+        (fwrite(config, sizeof(devConfig_t), 1, fp) != 1)) {
+        status = -1;
+    }
+    if ((fclose(fp) != 0) || (status != 0)) {
+        printf(" Unable to write the configuration blob '%s'\n\n", filename);
+        return -1;
+    }
     return 0;
 }
+
+/**
+ * @brief Check the timing and bandwidth of a configuration
+ *
+ * These are checked on the host, before any traffic with the devices:
+ *  - the ADC sampling window must end before the end of the ramp;
+ *  - the chirps of a frame must leave CONFIG_MIN_FRAME_GAP before the next
+ *    frame (CONFIG_MIN_BURST_GAP and CONFIG_MIN_SUBFRAME_GAP before the
+ *    next sub-frame of an advanced frame);
+ *  - the ADC data of a chirp must be sent over the CSI2 lanes within the
+ *    chirp period;
+ *  - the data of all the devices must be written on the SSD of the DSP
+ *    board within the frame period;
+ *  - the sub-frames of an advanced frame must have the same number of ADC
+ *    samples per chirp, the TDA recording chirps of a single size.
+ *
+ * @param config Device configuration structure
+ * @param budget Computed budget (optional)
+ * @return int 0 if the configuration is feasible, -1 otherwise
+ */
+int validate_config(const devConfig_t *config, configBudget_t *budget) {
+    const double lane_rates[] = { 0, 600, 450, 400, 300, 225, 150 };  // Mbps
+    const rlAdvFrameSeqCfg_t *seq = &config->advFrameCfg.frameSeq;
+    configBudget_t b;
+    uint32_t num_rx = __builtin_popcount(config->channelCfg.rxChannelEn & 0xF);
+    uint32_t num_devices = __builtin_popcount(config->deviceMap & 0xF);
+    uint32_t vals = (config->adcOutCfg.fmt.b2AdcOutFmt == 0) ? 1 : 2;
+    uint8_t num_sub = (seq->numOfSubFrames <= RL_MAX_SUBFRAMES) ? seq->numOfSubFrames : 0;
+    uint32_t num_lanes = 0;
+    int status = 0;
+
+    memset(&b, 0, sizeof(b));
+    b.numSubFrames = num_sub;
+    for (uint8_t lane = 0; lane < 4; lane++) {
+        if ((config->csi2LaneCfg.lanePosPolSel >> (4 * lane)) & 0x7) num_lanes++;
+    }
+    if (config->datapathClkCfg.dataRate < sizeof(lane_rates) / sizeof(lane_rates[0])) {
+        b.laneRate = num_lanes * lane_rates[config->datapathClkCfg.dataRate] * CONFIG_CSI2_EFFICIENCY;
+    }
+
+    // The legacy frame, or each sub-frame of an advanced frame
+    for (uint8_t sub = 0; sub < ((num_sub > 0) ? num_sub : 1); sub++) {
+        const rlProfileCfg_t *profile = (num_sub > 0) ? &config->subProfileCfg[sub] : &config->profileCfg;
+        uint32_t num_loops = (num_sub > 0) ? seq->subFrameCfg[sub].numLoops : config->frameCfg.numLoops;
+        uint32_t num_chirps = (num_sub > 0) ? seq->subFrameCfg[sub].numOfChirps :
+            config->frameCfg.chirpEndIdx - config->frameCfg.chirpStartIdx + 1;
+        double period = ((num_sub > 0) ? seq->subFrameCfg[sub].subFramePeriodicity :
+            config->frameCfg.framePeriodicity) * 5e-3;               // 1LSB = 5ns
+        double gap = (num_sub > 0) ? CONFIG_MIN_BURST_GAP + CONFIG_MIN_SUBFRAME_GAP : CONFIG_MIN_FRAME_GAP;
+        char where[24] = "";
+        double adcStart, samplingTime, rampTime, chirpTime, activeTime, dataRate;
+
+        if (num_sub > 0) snprintf(where, sizeof(where), "sub-frame %u: ", sub);
+        if ((profile->numAdcSamples == 0) || (profile->digOutSampleRate == 0) ||
+            (num_loops == 0) || (num_rx == 0) ||
+            ((num_sub == 0) && (config->frameCfg.chirpEndIdx < config->frameCfg.chirpStartIdx))) {
+            printf(CONFIG_INVALID_MSG "%sno samples, loops, chirps or RX channels\n", where);
+            if (budget != NULL) *budget = b;
+            return -1;
+        }
+
+        adcStart = profile->adcStartTimeConst / 100.0;               // 1LSB = 10ns
+        samplingTime = profile->numAdcSamples * 1e3 / profile->digOutSampleRate;
+        rampTime = profile->rampEndTime / 100.0;
+        chirpTime = profile->idleTimeConst / 100.0 + rampTime;
+        activeTime = chirpTime * num_chirps * num_loops;
+
+        // 16-bit values on the CSI2 lanes, whatever the ADC resolution
+        uint32_t chirp_bytes = profile->numAdcSamples * num_rx * vals * 2;
+        dataRate = chirp_bytes * 8.0 / chirpTime;                    // bits/us = Mbps
+
+        if (sub == 0) {
+            b.adcStart = adcStart;
+            b.samplingTime = samplingTime;
+            b.rampTime = rampTime;
+            b.chirpTime = chirpTime;
+        }
+        b.frameTime += activeTime;
+        b.framePeriod += period;
+        b.frameBytes += chirp_bytes * num_chirps * num_loops;
+        if (dataRate > b.dataRate) b.dataRate = dataRate;
+
+        if (adcStart + samplingTime > rampTime) {
+            printf(CONFIG_INVALID_MSG "%sthe ADC sampling (%.2f us from %.2f us) ends after the ramp (%.2f us)\n",
+                where, samplingTime, adcStart, rampTime);
+            status = -1;
+        }
+        if (activeTime + gap > period) {
+            const char *unit = (num_sub > 0) ? "sub-frame" : "frame";
+            printf(CONFIG_INVALID_MSG "%sthe chirps of a %s last %.3f ms, for a %s period of %.3f ms\n",
+                where, unit, activeTime * 1e-3, unit, period * 1e-3);
+            status = -1;
+        }
+        if ((sub > 0) && (profile->numAdcSamples != config->subProfileCfg[0].numAdcSamples)) {
+            printf(CONFIG_INVALID_MSG "%s%u ADC samples per chirp, %u in sub-frame 0\n",
+                where, profile->numAdcSamples, config->subProfileCfg[0].numAdcSamples);
+            status = -1;
+        }
+    }
+    b.dutyCycle = (b.framePeriod > 0) ? 100.0 * b.frameTime / b.framePeriod : 0;
+    b.ssdRate = (b.framePeriod > 0) ? num_devices * b.frameBytes / b.framePeriod : 0;  // B/us = MB/s
+
+    if ((config->datapathCfg.intfSel == 0) && (b.dataRate > b.laneRate)) {
+        printf(CONFIG_INVALID_MSG "ADC data rate of %.1f Mbps per device, %.1f Mbps available on %u CSI2 lanes\n",
+            b.dataRate, b.laneRate, num_lanes);
+        status = -1;
+    }
+    if (b.ssdRate > CONFIG_SSD_WRITE_RATE) {
+        printf(CONFIG_INVALID_MSG "recording rate of %.1f MB/s, above the %.0f MB/s of the SSD\n",
+            b.ssdRate, CONFIG_SSD_WRITE_RATE);
+        status = -1;
+    }
+    if (budget != NULL) *budget = b;
+    return status;
+}
+
+/**
+ * @brief Print the budget of a configuration
+ *
+ * @param budget Budget computed by validate_config
+ */
+void print_config_budget(const configBudget_t *budget) {
+    printf(" ADC sampling     : %.2f us from %.2f us, ramp of %.2f us\n",
+        budget->samplingTime, budget->adcStart, budget->rampTime);
+    printf(" Frame timing     : %.3f ms of chirps every %.3f ms (%.1f %% duty cycle)\n",
+        budget->frameTime * 1e-3, budget->framePeriod * 1e-3, budget->dutyCycle);
+    if (budget->numSubFrames > 0) {
+        printf(" Advanced frame   : %u sub-frames, ADC sampling of sub-frame 0 above\n",
+            budget->numSubFrames);
+    }
+    printf(" CSI2 bandwidth   : %.1f Mbps per device, %.1f Mbps available\n",
+        budget->dataRate, budget->laneRate);
+    printf(" SSD write rate   : %.1f MB/s (%u bytes per frame and device)\n",
+        budget->ssdRate, budget->frameBytes);
+}
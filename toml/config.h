@@ -18,10 +18,94 @@
 #include "toml.h"
 #include "../mimo.h"
 
-/* Read the configuration from the TOML file  */
+/* Static arena of the TOML parser. Larger files use additional chunks */
+#define CONFIG_ARENA_SIZE           (64 * 1024)
+
+/* Compiled configuration blobs ("MMWB") */
+#define CONFIG_BLOB_MAGIC           (0x42574D4DU)
+#define CONFIG_BLOB_VERSION         (3U)
+
+/* Share of the CSI2 lane bandwidth available for the ADC data */
+#define CONFIG_CSI2_EFFICIENCY      (0.9)
+
+/* Minimum idle time between two frames (us) */
+#define CONFIG_MIN_FRAME_GAP        (500.0)
+
+/* Minimum idle time after a burst, and between two sub-frames of different
+   profiles (us) */
+#define CONFIG_MIN_BURST_GAP        (110.0)
+#define CONFIG_MIN_SUBFRAME_GAP     (450.0)
+
+/* Sustained write rate of the SSD of the DSP board (MB/s) */
+#define CONFIG_SSD_WRITE_RATE       (350.0)
+
+
+/** Header of a compiled configuration, followed by the devConfig_t */
+typedef struct configBlobHeader {
+
+  // CONFIG_BLOB_MAGIC, CONFIG_BLOB_VERSION
+  uint32_t magic;
+  uint16_t version;
+
+  // Size of this structure
+  uint16_t headerSize;
+
+  // sizeof(devConfig_t) of the program that compiled the blob
+  uint32_t configSize;
+
+  // FNV-1a hash of the devConfig_t
+  uint32_t checksum;
+
+} configBlobHeader_t;
+
+
+/** Timing and bandwidth budget of a configuration */
+typedef struct configBudget {
+
+  // ADC sampling window (us)
+  double adcStart;
+  double samplingTime;
+
+  // Chirp ramp and chirp period (us)
+  double rampTime;
+  double chirpTime;
+
+  // Active time of a frame and frame period (us)
+  double frameTime;
+  double framePeriod;
+
+  // Active part of the frame period (%)
+  double dutyCycle;
+
+  // ADC data rate of a device and CSI2 bandwidth available (Mbps)
+  double dataRate;
+  double laneRate;
+
+  // Recording rate of all the devices on the SSD (MB/s)
+  double ssdRate;
+
+  // ADC data of a frame of a device (bytes)
+  uint32_t frameBytes;
+
+  // Number of sub-frames of an advanced frame (0: legacy frame)
+  uint8_t numSubFrames;
+
+} configBudget_t;
+
+
+/* Read the configuration from a TOML file or a compiled blob */
 int read_config(unsigned char *filename, devConfig_t *config);
 
 /* Read all the config related to MIMO configuration */
 void read_mimo_config(toml_table_t* configfile, devConfig_t *config);
 
+/* Compile a configuration into a blob */
+int write_config_blob(const unsigned char *filename, const devConfig_t *config);
+
+/* Check the timing and bandwidth of a configuration */
+int validate_config(const devConfig_t *config, configBudget_t *budget);
+
+/* Print the budget of a configuration */
+void print_config_budget(const configBudget_t *budget);
+
 #endif
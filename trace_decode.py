@@ -0,0 +1,49 @@
+#!/usr/bin/env python3
+"""
+Decode a binary TDA packet trace dumped by the mmwave CLI
+
+The trace is dumped into /tmp/mmwave_trace_<pid>.bin when the process
+receives SIGUSR1, on an SPI read timeout or on a network error.
+
+Usage: trace_decode.py <trace-file>
+"""
+
+import struct
+import sys
+
+HEADER = struct.Struct("<8sIIII")
+RECORD = struct.Struct("<QIHHHBBBB42s")
+MAGIC = b"MMWTRACE"
+
+
+def decode(path: str):
+    with open(path, "rb") as f:
+        data = f.read()
+
+    magic, version, record_size, count, _ = HEADER.unpack_from(data, 0)
+    if magic != MAGIC or record_size != RECORD.size:
+        raise ValueError(f"{path}: not a version {version} TDA trace file")
+
+    offset = HEADER.size
+    for _ in range(count):
+        (timestamp, sequence, opcode, length, ack_code, device, direction,
+         captured, _, payload) = RECORD.unpack_from(data, offset)
+        offset += record_size
+        if sequence == 0:
+            # Record being written at the time of the dump
+            continue
+        text = " ".join(f"{b:02X}" for b in payload[:captured])
+        if captured < length:
+            text += " ..."
+        print(
+            f"[{timestamp // 10**9}.{timestamp % 10**9:09d}] #{sequence - 1} "
+            f"{'TX' if direction == 0 else 'RX'} dev 0x{device:02X} "
+            f"op 0x{opcode:04X} ack 0x{ack_code:04X} len {length}: {text}"
+        )
+
+
+if __name__ == "__main__":
+    if len(sys.argv) != 2:
+        print(__doc__)
+        sys.exit(1)
+    decode(sys.argv[1])
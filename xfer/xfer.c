@@ -0,0 +1,557 @@
+/**
+ * @file xfer.c
+ * @brief Parallel, resumable copy of the captures from the DSP board
+ * @version 0.1
+ * @date 2026-10-14
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <time.h>
+#include <unistd.h>
+#include <spawn.h>
+#include <pthread.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
+#include "xfer.h"
+
+extern char **environ;
+
+/* Number of attempts per file (each one resumes the previous one) */
+#define XFER_ATTEMPTS           (3U)
+
+
+/** Transfer of one capture directory, shared by the streams */
+typedef struct xferCtx {
+
+  const xferCfg_t *cfg;
+  const char *remoteDir;
+  const char *localDir;
+
+  xferFile_t *files;
+  uint32_t nFiles;
+
+  pthread_mutex_t lock;
+
+  // Next file to copy
+  uint32_t next;
+
+  // Number of files resumed or already complete
+  uint32_t resumed;
+
+  // Number of bytes received
+  uint64_t bytes;
+
+  // Rate limiter: time of the first byte and bytes paced so far
+  uint64_t rateStart;
+  uint64_t rateBytes;
+
+} xferCtx_t;
+
+
+/**
+ * @brief Monotonic time
+ *
+ * @return uint64_t CLOCK_MONOTONIC time (ns)
+ */
+static uint64_t xfer_now() {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+
+/**
+ * @brief Check that a path can be single quoted in a remote shell command
+ *
+ * @param path Path
+ * @return int 1 if safe
+ */
+static int xfer_is_safe(const char *path) {
+  return (strchr(path, '\'') == NULL) && (strchr(path, '\n') == NULL);
+}
+
+
+/**
+ * @brief Run a command on the DSP board
+ *
+ * @param cfg Transfer configuration
+ * @param command Shell command
+ * @param fd Read end of the command standard output
+ * @return pid_t Process ID of the ssh client, -1 on failure
+ */
+static pid_t xfer_ssh(const xferCfg_t *cfg, const char *command, int *fd) {
+  posix_spawn_file_actions_t actions;
+  char target[64];
+  int pipefd[2];
+  pid_t pid;
+  char *argv[] = {
+    "ssh", "-q", "-oHostKeyAlgorithms=+ssh-rsa", "-oPubkeyAcceptedAlgorithms=+ssh-rsa",
+    "-oServerAliveInterval=10", cfg->compress ? "-oCompression=yes" : "-oCompression=no",
+    target, (char *)command, NULL
+  };
+
+  snprintf(target, sizeof(target), "root@%s", cfg->host);
+  if (pipe2(pipefd, O_CLOEXEC) != 0) return -1;
+
+  posix_spawn_file_actions_init(&actions);
+  posix_spawn_file_actions_adddup2(&actions, pipefd[1], STDOUT_FILENO);
+  posix_spawn_file_actions_addopen(&actions, STDIN_FILENO, "/dev/null", O_RDONLY, 0);
+  if (posix_spawnp(&pid, argv[0], &actions, NULL, argv, environ) != 0) pid = -1;
+  posix_spawn_file_actions_destroy(&actions);
+
+  close(pipefd[1]);
+  if (pid < 0) {
+    close(pipefd[0]);
+    return -1;
+  }
+  *fd = pipefd[0];
+  return pid;
+}
+
+
+/**
+ * @brief Wait for the ssh client
+ *
+ * @param pid Process ID of the ssh client
+ * @return int32_t 0 if the remote command succeeded, -1 otherwise
+ */
+static int32_t xfer_wait(pid_t pid) {
+  int wstatus = 0;
+
+  while (waitpid(pid, &wstatus, 0) < 0) {
+    if (errno != EINTR) return -1;
+  }
+  return (WIFEXITED(wstatus) && (WEXITSTATUS(wstatus) == 0)) ? 0 : -1;
+}
+
+
+/**
+ * @brief Pace the streams to the configured rate
+ *
+ * @param ctx Transfer context
+ * @param n Number of bytes just received
+ */
+static void xfer_throttle(xferCtx_t *ctx, size_t n) {
+  uint64_t due, now;
+  struct timespec ts;
+
+  pthread_mutex_lock(&ctx->lock);
+  ctx->bytes += n;
+  if (ctx->cfg->rateLimit == 0) {
+    pthread_mutex_unlock(&ctx->lock);
+    return;
+  }
+  ctx->rateBytes += n;
+  due = ctx->rateStart + (uint64_t)((double)ctx->rateBytes * 1e9 / ctx->cfg->rateLimit);
+  pthread_mutex_unlock(&ctx->lock);
+
+  now = xfer_now();
+  if (due > now) {
+    ts.tv_sec = (due - now) / 1000000000ULL;
+    ts.tv_nsec = (due - now) % 1000000000ULL;
+    nanosleep(&ts, NULL);
+  }
+}
+
+
+/**
+ * @brief Create the parent directories of a path
+ *
+ * @param path File path
+ * @return int32_t 0 on success, -1 on failure
+ */
+static int32_t xfer_mkdir_parents(const char *path) {
+  char dir[512];
+  char *p;
+
+  if (snprintf(dir, sizeof(dir), "%s", path) >= (int)sizeof(dir)) return -1;
+  for (p = dir + 1; *p != '\0'; p++) {
+    if (*p != '/') continue;
+    *p = '\0';
+    if ((mkdir(dir, 0755) != 0) && (errno != EEXIST)) return -1;
+    *p = '/';
+  }
+  return 0;
+}
+
+
+/**
+ * @brief Copy one file, resuming from its ".part" file if any
+ *
+ * @param ctx Transfer context
+ * @param file File to copy
+ * @return int32_t 0 on success, -1 on failure
+ */
+static int32_t xfer_file(xferCtx_t *ctx, xferFile_t *file) {
+  char path[512], part[512], command[1024];
+  struct stat st;
+  uint64_t offset = 0;
+  int32_t status = 0;
+  ssize_t n;
+  char *buffer;
+  pid_t pid;
+  int in, out;
+
+  // A truncated path would resume or overwrite another file
+  if ((snprintf(path, sizeof(path), "%s/%s", ctx->localDir, file->name) >= (int)sizeof(path)) ||
+      (snprintf(part, sizeof(part), "%s%s", path, XFER_PART_SUFFIX) >= (int)sizeof(part))) {
+    return -1;
+  }
+
+  // Already copied by a previous transfer
+  if ((stat(path, &st) == 0) && ((uint64_t)st.st_size == file->size)) {
+    file->resumedFrom = file->size;
+    return 0;
+  }
+  if ((stat(part, &st) == 0) && ((uint64_t)st.st_size <= file->size)) {
+    offset = st.st_size;
+  }
+  file->resumedFrom = offset;
+  if (xfer_mkdir_parents(path) != 0) return -1;
+
+  out = open(part, O_WRONLY | O_CREAT | O_CLOEXEC | ((offset > 0) ? O_APPEND : O_TRUNC), 0644);
+  if (out < 0) return -1;
+  buffer = malloc(XFER_CHUNK_SIZE);
+  if (buffer == NULL) {
+    close(out);
+    return -1;
+  }
+
+  if (offset < file->size) {
+    int length;
+
+    if (offset == 0) {
+      length = snprintf(command, sizeof(command), "cat '%s/%s'", ctx->remoteDir, file->name);
+    } else {
+      length = snprintf(command, sizeof(command), "tail -c +%llu '%s/%s'",
+        (unsigned long long)offset + 1, ctx->remoteDir, file->name);
+    }
+    pid = (length < (int)sizeof(command)) ? xfer_ssh(ctx->cfg, command, &in) : -1;
+    if (pid < 0) status = -1;
+
+    while (status == 0) {
+      n = read(in, buffer, XFER_CHUNK_SIZE);
+      if ((n < 0) && (errno == EINTR)) continue;
+      if (n <= 0) break;
+      for (ssize_t w = 0, k; w < n; w += k) {
+        k = write(out, buffer + w, n - w);
+        if (k < 0) {
+          if (errno == EINTR) {
+            k = 0;
+            continue;
+          }
+          status = -1;
+          break;
+        }
+      }
+      offset += n;
+      xfer_throttle(ctx, n);
+    }
+    if (pid >= 0) {
+      close(in);
+      if (xfer_wait(pid) != 0) status = -1;
+    }
+  }
+  free(buffer);
+  if (close(out) != 0) status = -1;
+
+  if ((status == 0) && (offset == file->size)) {
+    return (rename(part, path) == 0) ? 0 : -1;
+  }
+  if (offset > file->size) unlink(part);   // Changed on the board, start over
+  return -1;
+}
+
+
+/**
+ * @brief Stream: copy the files of the capture until none is left
+ *
+ * @param arg Transfer context
+ * @return void* NULL
+ */
+static void* xfer_stream(void *arg) {
+  xferCtx_t *ctx = (xferCtx_t *)arg;
+  xferFile_t *file;
+
+  for (;;) {
+    pthread_mutex_lock(&ctx->lock);
+    if (ctx->next >= ctx->nFiles) {
+      pthread_mutex_unlock(&ctx->lock);
+      return NULL;
+    }
+    file = &ctx->files[ctx->next++];
+    pthread_mutex_unlock(&ctx->lock);
+
+    file->status = -1;
+    for (uint8_t attempt = 0; (attempt < XFER_ATTEMPTS) && (file->status != 0); attempt++) {
+      file->status = xfer_file(ctx, file);
+    }
+    if (file->resumedFrom > 0) {
+      pthread_mutex_lock(&ctx->lock);
+      ctx->resumed++;
+      pthread_mutex_unlock(&ctx->lock);
+    }
+  }
+}
+
+
+/**
+ * @brief Order the files by decreasing size
+ */
+static int xfer_compare_size(const void *a, const void *b) {
+  uint64_t sa = ((const xferFile_t *)a)->size;
+  uint64_t sb = ((const xferFile_t *)b)->size;
+  return (sa < sb) - (sa > sb);
+}
+
+
+/**
+ * @brief Run a command on the DSP board and read its whole output
+ *
+ * @param cfg Transfer configuration
+ * @param command Shell command
+ * @param length Length of the output
+ * @return char* NUL terminated output to free, NULL on failure
+ */
+static char* xfer_ssh_output(const xferCfg_t *cfg, const char *command, size_t *length) {
+  size_t capacity = 1 << 16;
+  char *output = malloc(capacity);
+  ssize_t n;
+  pid_t pid;
+  int fd;
+
+  *length = 0;
+  if (output == NULL) return NULL;
+  pid = xfer_ssh(cfg, command, &fd);
+  if (pid < 0) {
+    free(output);
+    return NULL;
+  }
+  for (;;) {
+    if (*length + 1 >= capacity) {
+      char *grown = realloc(output, capacity * 2);
+      if (grown == NULL) break;
+      output = grown;
+      capacity *= 2;
+    }
+    n = read(fd, output + *length, capacity - *length - 1);
+    if ((n < 0) && (errno == EINTR)) continue;
+    if (n <= 0) break;
+    *length += n;
+  }
+  close(fd);
+  output[*length] = '\0';
+  if (xfer_wait(pid) != 0) {
+    free(output);
+    return NULL;
+  }
+  return output;
+}
+
+
+/**
+ * @brief Copy a capture directory from the DSP board
+ *
+ * @param cfg Transfer configuration
+ * @param remoteDir Capture directory on the DSP board
+ * @param localDir Local copy of the capture directory
+ * @param stats Statistics of the transfer
+ * @return int32_t 0 if all the files have been copied, -1 otherwise
+ */
+int32_t xfer_directory(const xferCfg_t *cfg, const char *remoteDir,
+                       const char *localDir, xferStats_t *stats) {
+  pthread_t streams[XFER_MAX_STREAMS];
+  char command[512];
+  char *listing, *line, *save;
+  size_t length;
+  uint8_t nStreams = 0;
+  uint64_t start = xfer_now();
+  xferCtx_t ctx;
+
+  memset(stats, 0, sizeof(xferStats_t));
+  if (!xfer_is_safe(remoteDir)) return -1;
+
+  if (snprintf(command, sizeof(command),
+      "cd '%s' && find . -type f -exec stat -c '%%s %%n' {} +", remoteDir) >= (int)sizeof(command)) {
+    return -1;
+  }
+  listing = xfer_ssh_output(cfg, command, &length);
+  if (listing == NULL) return -1;
+
+  memset(&ctx, 0, sizeof(ctx));
+  ctx.cfg = cfg;
+  ctx.remoteDir = remoteDir;
+  ctx.localDir = localDir;
+  ctx.files = calloc(XFER_MAX_FILES, sizeof(xferFile_t));
+  if (ctx.files == NULL) {
+    free(listing);
+    return -1;
+  }
+
+  for (line = strtok_r(listing, "\n", &save); line != NULL; line = strtok_r(NULL, "\n", &save)) {
+    unsigned long long size;
+    int offset = 0;
+    xferFile_t *file = &ctx.files[ctx.nFiles];
+
+    if (sscanf(line, "%llu ./%n", &size, &offset) != 1 || (offset == 0)) continue;
+    if ((strlen(line + offset) >= sizeof(file->name)) || !xfer_is_safe(line + offset)) {
+      stats->failed++;
+      continue;
+    }
+    if (ctx.nFiles == XFER_MAX_FILES) {
+      stats->failed++;
+      break;
+    }
+    strcpy(file->name, line + offset);
+    file->size = size;
+    stats->totalBytes += size;
+    ctx.nFiles++;
+  }
+  free(listing);
+  qsort(ctx.files, ctx.nFiles, sizeof(xferFile_t), xfer_compare_size);
+
+  pthread_mutex_init(&ctx.lock, NULL);
+  ctx.rateStart = xfer_now();
+  if ((snprintf(command, sizeof(command), "%s/", localDir) < (int)sizeof(command)) &&
+      (xfer_mkdir_parents(command) == 0)) {
+    uint8_t wanted = cfg->streams ? cfg->streams : 1;
+    if (wanted > XFER_MAX_STREAMS) wanted = XFER_MAX_STREAMS;
+    for (; nStreams < wanted; nStreams++) {
+      if (pthread_create(&streams[nStreams], NULL, xfer_stream, &ctx) != 0) break;
+    }
+    if (nStreams == 0) xfer_stream(&ctx);
+    for (uint8_t i = 0; i < nStreams; i++) {
+      pthread_join(streams[i], NULL);
+    }
+  } else {
+    ctx.next = ctx.nFiles;
+    stats->failed += ctx.nFiles;
+  }
+  pthread_mutex_destroy(&ctx.lock);
+
+  stats->files = ctx.nFiles;
+  stats->resumed = ctx.resumed;
+  stats->bytes = ctx.bytes;
+  for (uint32_t i = 0; i < ctx.next; i++) {
+    if (ctx.files[i].status != 0) stats->failed++;
+  }
+  stats->elapsed = xfer_now() - start;
+  free(ctx.files);
+  return ((stats->failed == 0) && (ctx.nFiles > 0)) ? 0 : -1;
+}
+
+
+/* POSIX cksum(1) CRC table (polynomial 0x04C11DB7, MSB first) */
+static uint32_t xfer_crc_table[256];
+static pthread_once_t xfer_crc_once = PTHREAD_ONCE_INIT;
+
+static void xfer_crc_init() {
+  for (uint32_t i = 0; i < 256; i++) {
+    uint32_t crc = i << 24;
+    for (uint8_t bit = 0; bit < 8; bit++) {
+      crc = (crc & 0x80000000U) ? (crc << 1) ^ 0x04C11DB7U : (crc << 1);
+    }
+    xfer_crc_table[i] = crc;
+  }
+}
+
+
+/**
+ * @brief POSIX cksum(1) CRC of a file
+ *
+ * @param path File path
+ * @param crc CRC of the file
+ * @param size Size of the file
+ * @return int32_t 0 on success, -1 on failure
+ */
+int32_t xfer_cksum(const char *path, uint32_t *crc, uint64_t *size) {
+  uint32_t value = 0;
+  uint64_t length = 0;
+  uint8_t *buffer;
+  ssize_t n;
+  int fd;
+
+  pthread_once(&xfer_crc_once, xfer_crc_init);
+  fd = open(path, O_RDONLY | O_CLOEXEC);
+  if (fd < 0) return -1;
+  buffer = malloc(XFER_CHUNK_SIZE);
+  if (buffer == NULL) {
+    close(fd);
+    return -1;
+  }
+
+  for (;;) {
+    n = read(fd, buffer, XFER_CHUNK_SIZE);
+    if ((n < 0) && (errno == EINTR)) continue;
+    if (n <= 0) break;
+    for (ssize_t i = 0; i < n; i++) {
+      value = (value << 8) ^ xfer_crc_table[(value >> 24) ^ buffer[i]];
+    }
+    length += n;
+  }
+  free(buffer);
+  close(fd);
+  if (n < 0) return -1;
+
+  *size = length;
+  // The length is appended, least significant byte first
+  for (; length > 0; length >>= 8) {
+    value = (value << 8) ^ xfer_crc_table[(value >> 24) ^ (length & 0xFF)];
+  }
+  *crc = ~value;
+  return 0;
+}
+
+
+/**
+ * @brief Compare the CRC of the local files with the ones of the DSP board
+ *
+ * @param cfg Transfer configuration
+ * @param remoteDir Capture directory on the DSP board
+ * @param localDir Local copy of the capture directory
+ * @param stats Statistics of the transfer (failed is updated)
+ * @return int32_t 0 if all the files match, -1 otherwise
+ */
+int32_t xfer_verify(const xferCfg_t *cfg, const char *remoteDir,
+                    const char *localDir, xferStats_t *stats) {
+  char command[512], path[512];
+  char *listing, *line, *save;
+  uint32_t checked = 0, failed = 0;
+  size_t length;
+
+  if (!xfer_is_safe(remoteDir)) return -1;
+  if (snprintf(command, sizeof(command), "cd '%s' && find . -type f -exec cksum {} +",
+      remoteDir) >= (int)sizeof(command)) {
+    return -1;
+  }
+  listing = xfer_ssh_output(cfg, command, &length);
+  if (listing == NULL) return -1;
+
+  for (line = strtok_r(listing, "\n", &save); line != NULL; line = strtok_r(NULL, "\n", &save)) {
+    unsigned long remoteCrc;
+    unsigned long long remoteSize;
+    uint64_t localSize;
+    uint32_t localCrc;
+    int offset = 0;
+
+    if ((sscanf(line, "%lu %llu ./%n", &remoteCrc, &remoteSize, &offset) != 2) || (offset == 0)) continue;
+    checked++;
+    if ((snprintf(path, sizeof(path), "%s/%s", localDir, line + offset) >= (int)sizeof(path)) ||
+        (xfer_cksum(path, &localCrc, &localSize) != 0) ||
+        (localCrc != (uint32_t)remoteCrc) || (localSize != remoteSize)) {
+      fprintf(stderr, "[TRANSFER] CRC mismatch: %s\n", path);
+      failed++;
+    }
+  }
+  free(listing);
+
+  stats->failed += failed;
+  return ((failed == 0) && (checked > 0)) ? 0 : -1;
+}
@@ -0,0 +1,113 @@
+/**
+ * @file xfer.h
+ * @brief Parallel, resumable copy of the captures from the DSP board
+ * @version 0.1
+ * @date 2026-10-14
+ *
+ * @copyright Copyright (c) 2026
+ *
+ * A capture directory is copied file by file over several parallel ssh
+ * streams (one file per stream at a time, largest files first). Each file
+ * is written to "<name>.part" and renamed once its size matches the size
+ * on the DSP board, so an interrupted copy resumes from the bytes already
+ * received. The total read rate can be capped so the copy does not starve
+ * the SSD of the DSP board while the next capture is recorded.
+ *
+ * With compression, the stream is compressed by ssh (zlib) on the DSP board.
+ * The ADC codec of the containers (cap/codec.h) cannot run there, the
+ * board only providing its stock tools.
+ *
+ * Integrity: the size of each file is always checked. The POSIX cksum(1)
+ * CRC of each file can also be compared with the one computed on the DSP
+ * board (xfer_verify).
+ */
+#ifndef MMWAVE_XFER_H
+#define MMWAVE_XFER_H
+
+#include <stdint.h>
+
+/* Maximum number of parallel streams */
+#define XFER_MAX_STREAMS        (8U)
+
+/* Maximum number of files in a capture directory */
+#define XFER_MAX_FILES          (512U)
+
+/* Size of the stream read buffer */
+#define XFER_CHUNK_SIZE         (1U << 20)
+
+/* Suffix of the files being received */
+#define XFER_PART_SUFFIX        ".part"
+
+
+/** Transfer configuration */
+typedef struct xferCfg {
+
+  // IP address of the DSP board
+  const char *host;
+
+  // Number of parallel streams
+  uint8_t streams;
+
+  // Maximum total read rate (bytes/s, 0: unlimited)
+  uint64_t rateLimit;
+
+  // 1: compress the streams
+  uint8_t compress;
+
+} xferCfg_t;
+
+
+/** File of a capture directory */
+typedef struct xferFile {
+
+  // Path relative to the capture directory
+  char name[192];
+
+  // Size on the DSP board
+  uint64_t size;
+
+  // Number of bytes already present locally before the transfer
+  uint64_t resumedFrom;
+
+  // 0 once copied (or verified)
+  int32_t status;
+
+} xferFile_t;
+
+
+/** Transfer statistics */
+typedef struct xferStats {
+
+  // Number of files in the capture
+  uint32_t files;
+
+  // Number of files resumed or already complete
+  uint32_t resumed;
+
+  // Number of files that failed
+  uint32_t failed;
+
+  // Size of the capture
+  uint64_t totalBytes;
+
+  // Number of bytes received by this transfer
+  uint64_t bytes;
+
+  // Duration of the transfer (ns)
+  uint64_t elapsed;
+
+} xferStats_t;
+
+
+/* Copy a capture directory from the DSP board */
+int32_t xfer_directory(const xferCfg_t *cfg, const char *remoteDir,
+                       const char *localDir, xferStats_t *stats);
+
+/* Compare the CRC of the local files with the ones of the DSP board */
+int32_t xfer_verify(const xferCfg_t *cfg, const char *remoteDir,
+                    const char *localDir, xferStats_t *stats);
+
+/* POSIX cksum(1) CRC of a file */
+int32_t xfer_cksum(const char *path, uint32_t *crc, uint64_t *size);
+
+#endif